@@ -0,0 +1,324 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Implementation on top of std::thread. A pool of threads is created the
+// first time a parallel loop is executed and is kept alive until the number
+// of threads changes. The iterations of a loop are split into chunks of
+// grain iterations, which are distributed evenly among the threads of the
+// pool and the calling thread. A thread that has processed its own chunks
+// steals chunks from the end of the other threads' ranges, which balances
+// loops whose iterations have very different costs.
+
+using vtk::detail::smp::ExecuteFunctorPtrType;
+
+namespace
+{
+
+// True on the threads of the pool, and on the calling thread while it takes
+// part in a parallel loop. Loops started in a parallel scope are executed
+// on the calling thread.
+thread_local bool vtkSMPInParallelScope = false;
+
+// Set by vtkSMPTools::Initialize() and read by any thread, e.g. when it
+// creates a vtkSMPThreadLocal.
+std::atomic<int> vtkSMPNumberOfSpecifiedThreads(0);
+
+//--------------------------------------------------------------------------------
+// Chunks [Begin, End) owned by one thread. The owner takes chunks from the
+// front, thieves take them from the back.
+struct vtkSMPChunkRange
+{
+  std::mutex Lock;
+  vtkIdType Begin;
+  vtkIdType End;
+
+  bool PopFront(vtkIdType& chunk)
+  {
+    std::lock_guard<std::mutex> guard(this->Lock);
+    if (this->Begin >= this->End)
+    {
+      return false;
+    }
+    chunk = this->Begin++;
+    return true;
+  }
+
+  bool PopBack(vtkIdType& chunk)
+  {
+    std::lock_guard<std::mutex> guard(this->Lock);
+    if (this->Begin >= this->End)
+    {
+      return false;
+    }
+    chunk = --this->End;
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------
+struct vtkSMPJob
+{
+  ExecuteFunctorPtrType Executer;
+  void* Functor;
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+  int NumberOfRanges;
+  std::unique_ptr<vtkSMPChunkRange[]> Ranges;
+
+  // Process the chunks of range index, then steal from the other ranges.
+  void Run(int index)
+  {
+    vtkIdType chunk;
+    for (;;)
+    {
+      bool found = this->Ranges[index].PopFront(chunk);
+      for (int i = 1; !found && i < this->NumberOfRanges; ++i)
+      {
+        found =
+          this->Ranges[(index + i) % this->NumberOfRanges].PopBack(chunk);
+      }
+      if (!found)
+      {
+        return;
+      }
+      this->Executer(this->Functor, this->First + chunk * this->Grain,
+                     this->Grain, this->Last);
+    }
+  }
+};
+
+//--------------------------------------------------------------------------------
+class vtkSMPThreadPool
+{
+public:
+  // numThreads includes the calling thread.
+  explicit vtkSMPThreadPool(int numThreads)
+    : NumberOfThreads(numThreads), Job(nullptr), Generation(0), Busy(0),
+      Stop(false)
+  {
+    for (int i = 1; i < numThreads; ++i)
+    {
+      this->Threads.push_back(
+        std::thread(&vtkSMPThreadPool::WorkerLoop, this, i));
+    }
+  }
+
+  ~vtkSMPThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> guard(this->Mutex);
+      this->Stop = true;
+    }
+    this->WakeUp.notify_all();
+    for (size_t i = 0; i < this->Threads.size(); ++i)
+    {
+      this->Threads[i].join();
+    }
+  }
+
+  int GetNumberOfThreads() const
+  {
+    return this->NumberOfThreads;
+  }
+
+  // Returns false if the pool is already running a loop started by another
+  // thread, in which case the caller should run the loop itself.
+  bool For(vtkIdType first, vtkIdType last, vtkIdType grain,
+           ExecuteFunctorPtrType executer, void* functor)
+  {
+    std::unique_lock<std::mutex> runGuard(this->RunLock, std::try_to_lock);
+    if (!runGuard.owns_lock())
+    {
+      return false;
+    }
+
+    vtkSMPJob job;
+    job.Executer = executer;
+    job.Functor = functor;
+    job.First = first;
+    job.Last = last;
+    job.Grain = grain;
+    job.NumberOfRanges = this->NumberOfThreads;
+    job.Ranges.reset(new vtkSMPChunkRange[this->NumberOfThreads]);
+    const vtkIdType numChunks = (last - first + grain - 1) / grain;
+    for (int i = 0; i < this->NumberOfThreads; ++i)
+    {
+      job.Ranges[i].Begin = numChunks * i / this->NumberOfThreads;
+      job.Ranges[i].End = numChunks * (i + 1) / this->NumberOfThreads;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(this->Mutex);
+      this->Job = &job;
+      this->Busy = static_cast<int>(this->Threads.size());
+      ++this->Generation;
+    }
+    this->WakeUp.notify_all();
+
+    vtkSMPInParallelScope = true;
+    job.Run(0);
+    vtkSMPInParallelScope = false;
+
+    // The job lives on this stack frame, wait until no worker uses it.
+    std::unique_lock<std::mutex> guard(this->Mutex);
+    this->Done.wait(guard, [this] { return this->Busy == 0; });
+    this->Job = nullptr;
+    return true;
+  }
+
+private:
+  void WorkerLoop(int index)
+  {
+    vtkSMPInParallelScope = true;
+    unsigned long generation = 0;
+    for (;;)
+    {
+      vtkSMPJob* job;
+      {
+        std::unique_lock<std::mutex> guard(this->Mutex);
+        this->WakeUp.wait(guard, [this, generation] {
+          return this->Stop || this->Generation != generation; });
+        if (this->Stop)
+        {
+          return;
+        }
+        generation = this->Generation;
+        job = this->Job;
+      }
+
+      job->Run(index);
+
+      bool last;
+      {
+        std::lock_guard<std::mutex> guard(this->Mutex);
+        last = (--this->Busy == 0);
+      }
+      if (last)
+      {
+        this->Done.notify_one();
+      }
+    }
+  }
+
+  int NumberOfThreads;
+  std::vector<std::thread> Threads;
+
+  std::mutex RunLock; // held while a loop is running
+  std::mutex Mutex; // protects the members below
+  std::condition_variable WakeUp;
+  std::condition_variable Done;
+  vtkSMPJob* Job;
+  unsigned long Generation;
+  int Busy;
+  bool Stop;
+};
+
+// The pool is replaced by vtkSMPTools::Initialize() when the number of
+// threads changes. A loop keeps the pool it runs on alive until it ends, so
+// that Initialize() may be called while another thread runs a loop.
+std::mutex vtkSMPPoolLock;
+std::shared_ptr<vtkSMPThreadPool> vtkSMPPool;
+
+//--------------------------------------------------------------------------------
+int GetDefaultNumberOfThreads()
+{
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+//--------------------------------------------------------------------------------
+std::shared_ptr<vtkSMPThreadPool> GetThreadPool()
+{
+  std::lock_guard<std::mutex> guard(vtkSMPPoolLock);
+  if (!vtkSMPPool)
+  {
+    vtkSMPPool = std::make_shared<vtkSMPThreadPool>(
+      vtk::detail::smp::GetNumberOfThreads());
+  }
+  return vtkSMPPool;
+}
+
+} // end anon namespace
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  if (vtkSMPInParallelScope)
+  {
+    return;
+  }
+
+  // A non-positive number of threads restores the default.
+  std::lock_guard<std::mutex> guard(vtkSMPPoolLock);
+  vtkSMPNumberOfSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+  if (vtkSMPPool && vtkSMPPool->GetNumberOfThreads() !=
+      vtk::detail::smp::GetNumberOfThreads())
+  {
+    // The new pool is created lazily by the next parallel loop.
+    vtkSMPPool.reset();
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  int numThreads = vtkSMPNumberOfSpecifiedThreads;
+  return numThreads ? numThreads : GetDefaultNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::IsParallelScope()
+{
+  return vtkSMPInParallelScope;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_STDThread(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  std::shared_ptr<vtkSMPThreadPool> pool = GetThreadPool();
+  const int numThreads = pool->GetNumberOfThreads();
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first)/(numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  if (numThreads == 1 || !pool->For(first, last, grain, functorExecuter,
+                                    functor))
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+  }
+}
@@ -18,7 +18,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
+#include <atomic>
 #include <functional>
+#include <thread>
 #include <vector>
 
 static const int Target = 10000;
@@ -94,6 +96,55 @@ public:
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
+// Runs a parallel loop from within a parallel loop.
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 100, inner);
+      int innerTotal = 0;
+      for (vtkSMPThreadLocal<int>::iterator itr = inner.Counter.begin();
+           itr != inner.Counter.end(); ++itr)
+      {
+        innerTotal += *itr;
+      }
+      this->Counter.Local() += innerTotal;
+    }
+  }
+};
+
+int MaxOp(int a, int b) { return a > b ? a : b; }
+
+// Runs parallel loops, counting those with a wrong total.
+void RunLoops(std::atomic<int>* errors)
+{
+  for (int i=0; i<100; ++i)
+  {
+    ARangeFunctor functor;
+    vtkSMPTools::For(0, Target, functor);
+    int total = 0;
+    for (vtkSMPThreadLocal<int>::iterator itr = functor.Counter.begin();
+         itr != functor.Counter.end(); ++itr)
+    {
+      total += *itr;
+    }
+    if (total != Target)
+    {
+      ++(*errors);
+    }
+  }
+}
+
 int TestSMP(int, char*[])
 {
   //vtkSMPTools::Initialize(8);
@@ -167,5 +218,117 @@ int TestSMP(int, char*[])
     }
   }
 
+  // Test nested parallel loops
+  NestedFunctor functor3;
+  vtkSMPTools::For(0, 100, functor3);
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr = functor3.Counter.begin();
+       itr != functor3.Counter.end(); ++itr)
+  {
+    total += *itr;
+  }
+  if (total != 100 * 100)
+  {
+    cerr << "Error: Nested loops did not generate " << 100 * 100 << endl;
+    return 1;
+  }
+
+  // Test fill and transform
+  std::vector<int> values(Target);
+  vtkSMPTools::Fill(values.begin(), values.end(), 3);
+  std::vector<int> squares(Target);
+  vtkSMPTools::Transform(values.begin(), values.end(), squares.begin(),
+                         [](int v) { return v * v; });
+  vtkSMPTools::Transform(values.begin(), values.end(), squares.begin(),
+                         squares.begin(), [](int a, int b) { return a + b; });
+  for (int i=0; i<Target; ++i)
+  {
+    if (values[i] != 3 || squares[i] != 12)
+    {
+      cerr << "Error: Bad fill or transform!" << endl;
+      return 1;
+    }
+  }
+
+  // Test reduce. The blocks do not depend on the number of threads, so
+  // floating point results are reproducible.
+  for (int i=0; i<Target; ++i)
+  {
+    values[i] = (i * 7919) % Target;
+  }
+  if (vtkSMPTools::Reduce(values.begin(), values.end(), 0) !=
+      Target * (Target - 1) / 2 ||
+      vtkSMPTools::Reduce(values.begin(), values.end(), -1, MaxOp) !=
+      Target - 1 ||
+      vtkSMPTools::Reduce(values.begin(), values.begin(), 42) != 42)
+  {
+    cerr << "Error: Bad reduce!" << endl;
+    return 1;
+  }
+  std::vector<double> reals(Target);
+  for (int i=0; i<Target; ++i)
+  {
+    reals[i] = 1.0 / (i + 1);
+  }
+  double sum1 = vtkSMPTools::Reduce(reals.begin(), reals.end(), 0.0);
+  vtkSMPTools::Initialize(2);
+  double sum2 = vtkSMPTools::Reduce(reals.begin(), reals.end(), 0.0);
+  vtkSMPTools::Initialize();
+  if (sum1 != sum2)
+  {
+    cerr << "Error: Reduce depends on the number of threads!" << endl;
+    return 1;
+  }
+
+  // Test changing the number of threads while another thread runs loops
+  std::atomic<int> errors(0);
+  std::thread looper(RunLoops, &errors);
+  for (int i=0; i<100; ++i)
+  {
+    vtkSMPTools::Initialize(1 + i % 3);
+  }
+  looper.join();
+  vtkSMPTools::Initialize();
+  if (errors != 0)
+  {
+    cerr << "Error: Loops failed while the number of threads changed!" << endl;
+    return 1;
+  }
+
+  // Test scans, including in place
+  for (vtkIdType size=0; size<Target; size=size*3+1)
+  {
+    std::vector<vtkIdType> counts(size + 1);
+    for (vtkIdType i=0; i<size; ++i)
+    {
+      counts[i] = i % 4;
+    }
+    std::vector<vtkIdType> inclusive(size + 1);
+    vtkSMPTools::InclusiveScan(counts.begin(), counts.begin() + size,
+                               inclusive.begin());
+    vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(), counts.begin(),
+                               static_cast<vtkIdType>(0));
+    vtkIdType expected = 0;
+    for (vtkIdType i=0; i<size; ++i)
+    {
+      if (counts[i] != expected)
+      {
+        cerr << "Error: Bad exclusive scan!" << endl;
+        return 1;
+      }
+      expected += i % 4;
+      if (inclusive[i] != expected)
+      {
+        cerr << "Error: Bad inclusive scan!" << endl;
+        return 1;
+      }
+    }
+    if (counts[size] != expected)
+    {
+      cerr << "Error: Bad exclusive scan total!" << endl;
+      return 1;
+    }
+  }
+
   return 0;
 }
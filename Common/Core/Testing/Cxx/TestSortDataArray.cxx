@@ -31,12 +31,86 @@
 #include "vtkMath.h"
 #include "vtkTimerLog.h"
 
+#include <algorithm>
 #include <sstream>
 #include <locale> // C++ locale
+#include <vector>
 
 //#define ARRAY_SIZE (2*1024*1024)
 #define ARRAY_SIZE 2048
 
+namespace
+{
+
+// Checks vtkSortDataArray::RadixSort against a stable sort of the same keys.
+// The kind of keys is 0 for random keys, 1 for sorted keys with a few
+// swapped pairs and 2 for keys in the reverse order, with many ties.
+template <class T>
+bool TestRadixSort(vtkIdType num, int kind, int dir)
+{
+  std::vector<T> keys(num);
+  std::vector<vtkIdType> ids(num);
+  for (vtkIdType i = 0; i < num; ++i)
+  {
+    switch (kind)
+    {
+      case 0:
+        keys[i] = static_cast<T>(vtkMath::Random(-1.0e3, 1.0e3));
+        break;
+      case 1:
+        keys[i] = static_cast<T>(dir ? num - i : i);
+        break;
+      default:
+        keys[i] = static_cast<T>((dir ? i : num - i) / 7) - static_cast<T>(0.5);
+        break;
+    }
+    ids[i] = i;
+  }
+  if (kind == 1)
+  {
+    for (vtkIdType i = 0; i + 1 < num; i += 97)
+    {
+      std::swap(keys[i], keys[i + 1]);
+    }
+  }
+  if (num > 3)
+  {
+    keys[1] = static_cast<T>(-0.0);
+    keys[2] = static_cast<T>(0.0);
+  }
+
+  std::vector<vtkIdType> order(ids);
+  const std::vector<T> &k = keys;
+  std::stable_sort(order.begin(), order.end(),
+    [&k, dir](vtkIdType a, vtkIdType b)
+    {
+      return dir ? k[b] < k[a] : k[a] < k[b];
+    });
+
+  std::vector<T> sorted(keys);
+  vtkSortDataArray::RadixSort(num ? &sorted[0] : nullptr,
+    num ? &ids[0] : nullptr, num, dir);
+  for (vtkIdType i = 0; i < num; ++i)
+  {
+    if (sorted[i] != keys[order[i]] ||
+        (ids[i] != order[i] && keys[ids[i]] != keys[order[i]]))
+    {
+      cout << "Keys not properly radix sorted at " << i << " of " << num
+           << " (kind " << kind << ", dir " << dir << ")!" << endl;
+      return false;
+    }
+    if (ids[i] != order[i] && !(sorted[i] == 0 && keys[order[i]] == 0))
+    {
+      cout << "Radix sort not stable at " << i << " of " << num
+           << " (kind " << kind << ", dir " << dir << ")!" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
 int TestSortDataArray(int, char *[])
 {
   vtkIdType i;
@@ -302,6 +376,26 @@ int TestSortDataArray(int, char *[])
   }
   cout << "String array consistency check finished\n" << endl;
 
+  //---------------------------------------------------------------------------
+  // Radix sort float and double keys with their ids
+  cout << "Radix sorting keys----------" << endl;
+  vtkIdType radixSizes[4] = { 0, 1, ARRAY_SIZE, 100 * ARRAY_SIZE };
+  for (int n = 0; n < 4; ++n)
+  {
+    for (int kind = 0; kind < 3; ++kind)
+    {
+      for (int dir = 0; dir < 2; ++dir)
+      {
+        if (!TestRadixSort<float>(radixSizes[n], kind, dir) ||
+            !TestRadixSort<double>(radixSizes[n], kind, dir))
+        {
+          retVal = 1;
+        }
+      }
+    }
+  }
+
+  cout << "Radix sort consistency check finished\n" << endl;
 
   timer->Delete();
   keys->Delete();
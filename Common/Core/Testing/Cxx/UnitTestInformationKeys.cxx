@@ -1,6 +1,8 @@
 #include "vtkInformation.h"
 #include "vtkInformationDoubleKey.h"
 #include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationIterator.h"
 #include "vtkInformationStringKey.h"
 #include "vtkInformationStringVectorKey.h"
 #include "vtkInformationVariantKey.h"
@@ -9,6 +11,10 @@
 #include "vtkStdString.h"
 #include "vtkVariant.h"
 
+#include <set>
+#include <sstream>
+#include <vector>
+
 template<typename T, typename V>
 int UnitTestScalarValueKey(vtkInformation* info, T* key, const V& val)
 {
@@ -129,6 +135,127 @@ int UnitTestVectorValueKey(
   return ok_setgetcomp && ok_copyget && ok_length && ok_appendedlength;
 }
 
+// Checks that the values of the keys of an information are found, whether
+// it holds a few keys or many, as keys are set, removed and copied.
+int UnitTestManyKeys()
+{
+  const int numKeys = 100;
+  std::vector<vtkInformationIntegerKey*> keys;
+  for (int i = 0; i < numKeys; ++i)
+  {
+    std::ostringstream name;
+    name << "Test" << i;
+    keys.push_back(new vtkInformationIntegerKey(name.str().c_str(), "vtkTest"));
+  }
+
+  vtkNew<vtkInformation> info;
+  for (int i = 0; i < numKeys; ++i)
+  {
+    keys[i]->Set(info, i);
+  }
+  vtkNew<vtkInformation> few;
+  for (int i = 0; i < 5; ++i)
+  {
+    keys[i]->Set(few, -i);
+  }
+
+  for (int pass = 0; pass < 3; ++pass)
+  {
+    // the keys that are set after the pass
+    std::set<int> set;
+    if (pass == 0)
+    {
+      // remove every third key
+      for (int i = 0; i < numKeys; ++i)
+      {
+        if (i % 3 == 0)
+        {
+          info->Remove(keys[i]);
+        }
+        else
+        {
+          set.insert(i);
+        }
+      }
+    }
+    else if (pass == 1)
+    {
+      // copy the keys left to another information and back
+      vtkNew<vtkInformation> copy;
+      copy->Copy(info);
+      keys[1]->Set(info, -1);
+      info->Copy(copy);
+      for (int i = 0; i < numKeys; ++i)
+      {
+        if (i % 3)
+        {
+          set.insert(i);
+        }
+      }
+    }
+    else
+    {
+      // copy a few keys over many, then set many again
+      info->Copy(few);
+      for (int i = 0; i < 5; ++i)
+      {
+        if (keys[i]->Get(info) != -i)
+        {
+          cerr << "Bad value of copied key " << i << ".\n";
+          return 0;
+        }
+      }
+      for (int i = 0; i < numKeys; i += 2)
+      {
+        keys[i]->Set(info, i);
+        set.insert(i);
+      }
+      for (int i = 1; i < 5; i += 2)
+      {
+        set.insert(i);
+      }
+    }
+
+    if (info->GetNumberOfKeys() != static_cast<int>(set.size()))
+    {
+      cerr << "Bad number of keys " << info->GetNumberOfKeys() << " after pass "
+           << pass << ".\n";
+      return 0;
+    }
+    for (int i = 0; i < numKeys; ++i)
+    {
+      bool has = set.count(i) != 0;
+      int value = (pass == 2 && i < 5 && i % 2) ? -i : i;
+      if (info->Has(keys[i]) != (has ? 1 : 0) ||
+          (has && keys[i]->Get(info) != value))
+      {
+        cerr << "Bad key " << i << " after pass " << pass << ".\n";
+        return 0;
+      }
+    }
+    vtkNew<vtkInformationIterator> it;
+    it->SetInformation(info);
+    std::set<int> visited;
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+      for (int i = 0; i < numKeys; ++i)
+      {
+        if (it->GetCurrentKey() == keys[i] && !visited.insert(i).second)
+        {
+          cerr << "Key " << i << " visited twice.\n";
+          return 0;
+        }
+      }
+    }
+    if (visited != set)
+    {
+      cerr << "Bad keys visited after pass " << pass << ".\n";
+      return 0;
+    }
+  }
+  return 1;
+}
+
 int UnitTestInformationKeys(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
   int ok = 1;
@@ -161,5 +288,7 @@ int UnitTestInformationKeys(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     new vtkInformationStringVectorKey("Test", "vtkTest");
   ok &= UnitTestVectorValueKey(info, tsvkey, tsval);
 
+  ok &= UnitTestManyKeys();
+
   return ! ok;
 }
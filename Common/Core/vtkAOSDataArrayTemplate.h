@@ -185,6 +185,16 @@ public:
                     int deleteMethod) override;
   //@}
 
+#ifndef __VTK_WRAP__
+  /**
+   * Specify the function used to free the memory currently held by the
+   * array, for memory that was not allocated with malloc() or new[]. The
+   * array takes ownership of this memory and calls callback on it when it
+   * cleans up or reallocates memory.
+   */
+  void SetArrayFreeFunction(void (*callback)(void*));
+#endif
+
   // Overridden for optimized implementations:
   void SetTuple(vtkIdType tupleIdx, const float *tuple) override;
   void SetTuple(vtkIdType tupleIdx, const double *tuple) override;
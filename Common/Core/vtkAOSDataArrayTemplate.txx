@@ -92,6 +92,15 @@ void vtkAOSDataArrayTemplate<ValueTypeT>
   this->SetArray(static_cast<ValueType*>(array), size, save, deleteMethod);
 }
 
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkAOSDataArrayTemplate<ValueTypeT>
+::SetArrayFreeFunction(void (*callback)(void*))
+{
+  this->Buffer->SetBuffer(this->Buffer->GetBuffer(), this->Buffer->GetSize(),
+                          false, callback);
+}
+
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
 void vtkAOSDataArrayTemplate<ValueTypeT>::SetTuple(vtkIdType tupleIdx,
@@ -25,7 +25,6 @@
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerPointerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
-#include "vtkInformationIterator.h"
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationObjectBaseKey.h"
 #include "vtkInformationObjectBaseVectorKey.h"
@@ -36,7 +35,6 @@
 #include "vtkInformationVariantKey.h"
 #include "vtkInformationVariantVectorKey.h"
 #include "vtkObjectFactory.h"
-#include "vtkSmartPointer.h"
 #include "vtkVariant.h"
 
 #include <algorithm>
@@ -115,17 +113,7 @@ void vtkInformation::Modified(vtkInformationKey* key)
 // Return the number of keys as a result of iteration.
 int vtkInformation::GetNumberOfKeys()
 {
-  vtkSmartPointer<vtkInformationIterator> infoIterator =
-    vtkSmartPointer<vtkInformationIterator>::New();
-  infoIterator->SetInformation( this );
-
-  int numberOfKeys = 0;
-  for (infoIterator->InitTraversal(); !infoIterator->IsDoneWithTraversal();
-    infoIterator->GoToNextItem())
-  {
-    numberOfKeys++;
-  }
-  return numberOfKeys;
+  return static_cast<int>(this->Internal->Map.size());
 }
 
 //----------------------------------------------------------------------------
@@ -137,7 +125,7 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
     return;
   }
   typedef vtkInformationInternals::MapType MapType;
-  MapType::iterator i = this->Internal->Map.find(key);
+  MapType::iterator i = this->Internal->Find(key);
   if(i != this->Internal->Map.end())
   {
     vtkObjectBase* oldvalue = i->second;
@@ -148,14 +136,13 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
     }
     else
     {
-      this->Internal->Map.erase(i);
+      this->Internal->Erase(i);
     }
     oldvalue->UnRegister(nullptr);
   }
   else if(newvalue)
   {
-    MapType::value_type entry(key, newvalue);
-    this->Internal->Map.insert(entry);
+    this->Internal->Insert(key, newvalue);
     newvalue->Register(nullptr);
   }
   this->Modified(key);
@@ -168,7 +155,8 @@ const vtkObjectBase* vtkInformation::GetAsObjectBase(
   if(key)
   {
     typedef vtkInformationInternals::MapType MapType;
-    MapType::const_iterator i = this->Internal->Map.find(const_cast<vtkInformationKey*>(key));
+    MapType::const_iterator i =
+      this->Internal->Find(const_cast<vtkInformationKey*>(key));
     if(i != this->Internal->Map.end())
     {
       return i->second;
@@ -183,7 +171,7 @@ vtkObjectBase* vtkInformation::GetAsObjectBase(vtkInformationKey* key)
   if(key)
   {
     typedef vtkInformationInternals::MapType MapType;
-    MapType::const_iterator i = this->Internal->Map.find(key);
+    MapType::const_iterator i = this->Internal->Find(key);
     if(i != this->Internal->Map.end())
     {
       return i->second;
@@ -201,10 +189,15 @@ void vtkInformation::Clear()
 //----------------------------------------------------------------------------
 void vtkInformation::Copy(vtkInformation* from, int deep)
 {
-  vtkInformationInternals* oldInternal = this->Internal;
-  this->Internal = new vtkInformationInternals;
+  // The old entries are only released once the new ones are copied, since
+  // they may hold the only references to the values being copied. Their
+  // storage is then kept for the next copy.
+  vtkInformationInternals* internal = this->Internal;
+  internal->Map.swap(internal->Spare);
+  internal->Index.clear();
   if(from)
   {
+    internal->Map.reserve(from->Internal->Map.size());
     typedef vtkInformationInternals::MapType MapType;
     for(MapType::const_iterator i = from->Internal->Map.begin();
         i != from->Internal->Map.end(); ++i)
@@ -212,7 +205,7 @@ void vtkInformation::Copy(vtkInformation* from, int deep)
       this->CopyEntry(from, i->first, deep);
     }
   }
-  delete oldInternal;
+  vtkInformationInternals::Release(internal->Spare);
 }
 
 //----------------------------------------------------------------------------
@@ -1022,7 +1015,7 @@ void vtkInformation::ReportAsObjectBase(vtkInformationKey* key,
   if(key)
   {
     typedef vtkInformationInternals::MapType MapType;
-    MapType::iterator i = this->Internal->Map.find(key);
+    MapType::iterator i = this->Internal->Find(key);
     if(i != this->Internal->Map.end())
     {
       vtkGarbageCollectorReport(collector, i->second, key->GetName());
@@ -27,12 +27,9 @@
 #include "vtkInformationKey.h"
 #include "vtkObjectBase.h"
 
-#define VTK_INFORMATION_USE_HASH_MAP
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-# include <unordered_map>
-#else
-# include <map>
-#endif
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 //----------------------------------------------------------------------------
 class vtkInformationInternals
@@ -40,7 +37,20 @@ class vtkInformationInternals
 public:
   typedef vtkInformationKey* KeyType;
   typedef vtkObjectBase* DataType;
-#ifdef VTK_INFORMATION_USE_HASH_MAP
+
+  // The entries are stored in a vector, in the order they were inserted, and
+  // found by a linear search while they are few, which is the common case
+  // and cheaper than hashing. An index from the keys to the positions of the
+  // entries is only built once an information holds more entries. It is
+  // built by the insertions, never by the lookups, so that informations may
+  // be read from several threads at once.
+  typedef std::vector<std::pair<KeyType, DataType> > MapType;
+  MapType Map;
+
+  // The entries replaced by vtkInformation::Copy, until the new ones are
+  // copied, whose storage is then reused by the next copy.
+  MapType Spare;
+
   struct HashFun
   {
     size_t operator()(KeyType key) const
@@ -48,29 +58,86 @@ public:
       return static_cast<size_t>(key - KeyType(nullptr));
     }
   };
-  typedef std::unordered_map<KeyType, DataType, HashFun> MapType;
-#else
-  typedef std::map<KeyType, DataType> MapType;
-#endif
-  MapType Map;
+  typedef std::unordered_map<KeyType, size_t, HashFun> IndexType;
+  IndexType Index;
 
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  vtkInformationInternals(): Map(33) {}
-#endif
+  // The number of entries above which they are found through the index.
+  enum { IndexThreshold = 32 };
 
   ~vtkInformationInternals()
   {
-    for(MapType::iterator i = this->Map.begin(); i != this->Map.end(); ++i)
+    this->Release(this->Map);
+  }
+
+  MapType::iterator Find(KeyType key)
+  {
+    if(!this->Index.empty())
+    {
+      IndexType::const_iterator j = this->Index.find(key);
+      return j != this->Index.end() ? this->Map.begin() + j->second :
+        this->Map.end();
+    }
+    MapType::iterator i = this->Map.begin();
+    for(; i != this->Map.end() && i->first != key; ++i)
+    {
+    }
+    return i;
+  }
+
+  // The key must not be in the map already.
+  void Insert(KeyType key, DataType value)
+  {
+    this->Map.push_back(std::make_pair(key, value));
+    if(!this->Index.empty())
+    {
+      this->Index[key] = this->Map.size() - 1;
+    }
+    else if(this->Map.size() > IndexThreshold)
+    {
+      this->BuildIndex();
+    }
+  }
+
+  // Moves the last entry in place of the erased one.
+  void Erase(MapType::iterator i)
+  {
+    if(!this->Index.empty())
+    {
+      this->Index.erase(i->first);
+      if(i + 1 != this->Map.end())
+      {
+        this->Index[this->Map.back().first] = i - this->Map.begin();
+      }
+    }
+    *i = this->Map.back();
+    this->Map.pop_back();
+    if(this->Map.size() <= IndexThreshold)
+    {
+      this->Index.clear();
+    }
+  }
+
+  void BuildIndex()
+  {
+    this->Index.reserve(2*this->Map.size());
+    for(size_t i = 0; i < this->Map.size(); ++i)
+    {
+      this->Index[this->Map[i].first] = i;
+    }
+  }
+
+  static void Release(MapType& map)
+  {
+    for(MapType::iterator i = map.begin(); i != map.end(); ++i)
     {
       if(vtkObjectBase* value = i->second)
       {
         value->UnRegister(nullptr);
       }
     }
+    map.clear();
   }
 };
 
-#undef VTK_INFORMATION_USE_HASH_MAP
-
 #endif
 // VTK-HeaderTest-Exclude: vtkInformationInternals.h
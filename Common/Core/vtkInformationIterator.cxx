@@ -24,13 +24,16 @@ vtkStandardNewMacro(vtkInformationIterator);
 class vtkInformationIteratorInternals
 {
 public:
-  vtkInformationInternals::MapType::iterator Iterator;
+  // The position in the entries of the information, which stays valid when
+  // entries are added during the traversal.
+  size_t Index;
 };
 
 //----------------------------------------------------------------------------
 vtkInformationIterator::vtkInformationIterator()
 {
   this->Internal = new vtkInformationIteratorInternals;
+  this->Internal->Index = 0;
   this->Information = nullptr;
   this->ReferenceIsWeak = false;
 }
@@ -86,7 +89,7 @@ void vtkInformationIterator::GoToFirstItem()
     vtkErrorMacro("No information has been set.");
     return;
   }
-  this->Internal->Iterator = this->Information->Internal->Map.begin();
+  this->Internal->Index = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -98,7 +101,7 @@ void vtkInformationIterator::GoToNextItem()
     return;
   }
 
-  ++this->Internal->Iterator;
+  ++this->Internal->Index;
 }
 
 //----------------------------------------------------------------------------
@@ -110,7 +113,7 @@ int vtkInformationIterator::IsDoneWithTraversal()
     return 1;
   }
 
-  if(this->Internal->Iterator == this->Information->Internal->Map.end())
+  if(this->Internal->Index >= this->Information->Internal->Map.size())
   {
     return 1;
   }
@@ -125,7 +128,7 @@ vtkInformationKey* vtkInformationIterator::GetCurrentKey()
     return nullptr;
   }
 
-  return this->Internal->Iterator->first;
+  return this->Information->Internal->Map[this->Internal->Index].first;
 }
 
 //----------------------------------------------------------------------------
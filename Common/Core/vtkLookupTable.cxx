@@ -19,6 +19,7 @@
 #include "vtkMath.h"
 #include "vtkMathConfigure.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
 #include "vtkVariantArray.h"
 
@@ -1030,6 +1031,38 @@ void vtkLookupTableMapData(vtkLookupTable *self,
   }//alpha blending
 }
 
+//----------------------------------------------------------------------------
+// The number of values below which they are mapped by the calling thread
+// alone, since the threads would cost more than they save.
+const vtkIdType VTK_LOOKUP_TABLE_SMP_THRESHOLD = 10000;
+
+//----------------------------------------------------------------------------
+// Map the values with vtkLookupTableMapData, which only reads the lookup
+// table, by chunks mapped in parallel.
+template<class T>
+void vtkLookupTableMapDataInParallel(vtkLookupTable *self,
+                                     T *input, unsigned char *output,
+                                     int length, int inIncr, int outFormat,
+                                     const TableParameters & p)
+{
+  auto mapChunk = [&](vtkIdType begin, vtkIdType end)
+  {
+    TableParameters chunkParameters = p;
+    vtkLookupTableMapData(self, input + begin*inIncr,
+                          output + begin*outFormat,
+                          static_cast<int>(end - begin), inIncr, outFormat,
+                          chunkParameters);
+  };
+  if (length < VTK_LOOKUP_TABLE_SMP_THRESHOLD)
+  {
+    mapChunk(0, length);
+  }
+  else
+  {
+    vtkSMPTools::For(0, length, mapChunk);
+  }
+}
+
 //----------------------------------------------------------------------------
 template<class T>
 void vtkLookupTableIndexedMapData(
@@ -1223,17 +1256,18 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
         {
           newInput->SetValue(i, bitArray->GetValue(id));
         }
-        vtkLookupTableMapData(this, newInput->GetPointer(0),
-                              output, numberOfValues,
-                              inputIncrement, outputFormat, p);
+        vtkLookupTableMapDataInParallel(this, newInput->GetPointer(0),
+                                        output, numberOfValues,
+                                        inputIncrement, outputFormat, p);
         newInput->Delete();
         bitArray->Delete();
       }
         break;
 
       vtkTemplateMacro(
-        vtkLookupTableMapData(this, static_cast<VTK_TT*>(input),output,
-                              numberOfValues, inputIncrement, outputFormat, p)
+        vtkLookupTableMapDataInParallel(this, static_cast<VTK_TT*>(input),
+                                        output, numberOfValues,
+                                        inputIncrement, outputFormat, p)
         );
       default:
         vtkErrorMacro(<< "MapScalarsThroughTable2: Unknown input ScalarType");
@@ -1,11 +1,12 @@
 set(VTK_SMP_IMPLEMENTATION_TYPE "Sequential"
-  CACHE STRING "Which multi-threaded parallelism implementation to use. Options are Sequential, OpenMP or TBB")
+  CACHE STRING "Which multi-threaded parallelism implementation to use. Options are Sequential, STDThread, OpenMP or TBB")
 set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
   PROPERTY
-    STRINGS Sequential OpenMP TBB)
+    STRINGS Sequential STDThread OpenMP TBB)
 
 if (NOT (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP" OR
-         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB"))
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB" OR
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread"))
   set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
     PROPERTY
       VALUE "Sequential")
@@ -62,6 +63,19 @@ elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
       "atomics implementation.")
   endif()
 
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread")
+  list(APPEND vtk_smp_libraries
+    ${CMAKE_THREAD_LIBS_INIT})
+
+  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread")
+  list(APPEND vtk_smp_sources
+    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx"
+    "${vtk_smp_implementation_dir}/vtkSMPThreadLocalImpl.cxx")
+  list(APPEND vtk_smp_headers_to_configure
+    vtkSMPThreadLocal.h
+    vtkSMPThreadLocalImpl.h
+    vtkSMPToolsInternal.h)
+
 elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "Sequential")
   set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential")
   list(APPEND vtk_smp_sources
@@ -19,8 +19,15 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution
+ * is delegated to.
+ *
+ * Besides For() and Sort(), parallel versions of common algorithms are
+ * provided: Transform(), Fill(), Reduce(), InclusiveScan() and
+ * ExclusiveScan(). Reduce() and the scans split the range into blocks whose
+ * layout only depends on the size of the range, so that their results do
+ * not depend on the number of threads, even for non-associative operations
+ * such as floating point additions.
 */
 
 #ifndef vtkSMPTools_h
@@ -32,6 +39,10 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <vector> // For std::vector
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -129,6 +140,186 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+//--------------------------------------------------------------------------------
+// Functors implementing the parallel algorithms on top of For().
+template <typename InputIt, typename OutputIt, typename Functor>
+struct vtkSMPTools_UnaryTransformCall
+{
+  InputIt In;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_UnaryTransformCall(InputIt in, OutputIt out, Functor& transform)
+    : In(in), Out(out), Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt itIn = this->In + begin;
+    OutputIt itOut = this->Out + begin;
+    for (vtkIdType i = begin; i < end; ++i, ++itIn, ++itOut)
+    {
+      *itOut = this->Transform(*itIn);
+    }
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename Functor>
+struct vtkSMPTools_BinaryTransformCall
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_BinaryTransformCall(InputIt1 in1, InputIt2 in2, OutputIt out,
+                                  Functor& transform)
+    : In1(in1), In2(in2), Out(out), Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt1 itIn1 = this->In1 + begin;
+    InputIt2 itIn2 = this->In2 + begin;
+    OutputIt itOut = this->Out + begin;
+    for (vtkIdType i = begin; i < end; ++i, ++itIn1, ++itIn2, ++itOut)
+    {
+      *itOut = this->Transform(*itIn1, *itIn2);
+    }
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_FillFunctor
+{
+  Iterator Begin;
+  const T& Value;
+
+  vtkSMPTools_FillFunctor(Iterator begin, const T& value)
+    : Begin(begin), Value(value)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::fill(this->Begin + begin, this->Begin + end, this->Value);
+  }
+};
+
+// Reduce() and the scans work on blocks of at least MinimumBlockSize
+// values. The layout of the blocks only depends on the size of the range.
+struct vtkSMPTools_Blocks
+{
+  enum
+  {
+    MinimumBlockSize = 1024,
+    MaximumNumberOfBlocks = 1024
+  };
+
+  vtkIdType Size;
+  vtkIdType NumberOfBlocks;
+
+  explicit vtkSMPTools_Blocks(vtkIdType size) : Size(size)
+  {
+    this->NumberOfBlocks = (size + MinimumBlockSize - 1) / MinimumBlockSize;
+    if (this->NumberOfBlocks > MaximumNumberOfBlocks)
+    {
+      this->NumberOfBlocks = MaximumNumberOfBlocks;
+    }
+  }
+
+  vtkIdType GetBlockBegin(vtkIdType block) const
+  {
+    return this->Size * block / this->NumberOfBlocks;
+  }
+};
+
+// Reduce each block into Partial[block].
+template <typename Iterator, typename T, typename BinaryOp>
+struct vtkSMPTools_ReduceBlocks
+{
+  Iterator Begin;
+  const vtkSMPTools_Blocks& Blocks;
+  BinaryOp& Op;
+  std::vector<T>& Partial;
+
+  vtkSMPTools_ReduceBlocks(Iterator begin, const vtkSMPTools_Blocks& blocks,
+                           BinaryOp& op, std::vector<T>& partial)
+    : Begin(begin), Blocks(blocks), Op(op), Partial(partial)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      Iterator it = this->Begin + this->Blocks.GetBlockBegin(block);
+      Iterator end = this->Begin + this->Blocks.GetBlockBegin(block + 1);
+      T sum = *it;
+      for (++it; it != end; ++it)
+      {
+        sum = this->Op(sum, *it);
+      }
+      this->Partial[block] = sum;
+    }
+  }
+};
+
+// Scan each block, starting from Carry[block]. The first block of an
+// inclusive scan has no carry.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp,
+          bool Inclusive>
+struct vtkSMPTools_ScanBlocks
+{
+  InputIt Begin;
+  OutputIt Out;
+  const vtkSMPTools_Blocks& Blocks;
+  BinaryOp& Op;
+  const std::vector<T>& Carry;
+
+  vtkSMPTools_ScanBlocks(InputIt begin, OutputIt out,
+                         const vtkSMPTools_Blocks& blocks, BinaryOp& op,
+                         const std::vector<T>& carry)
+    : Begin(begin), Out(out), Blocks(blocks), Op(op), Carry(carry)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType first = this->Blocks.GetBlockBegin(block);
+      vtkIdType last = this->Blocks.GetBlockBegin(block + 1);
+      InputIt it = this->Begin + first;
+      OutputIt out = this->Out + first;
+      if (Inclusive)
+      {
+        T sum = (block == 0) ? T(*it) : this->Op(this->Carry[block], *it);
+        *out = sum;
+        for (++it, ++out, ++first; first < last; ++it, ++out, ++first)
+        {
+          sum = this->Op(sum, *it);
+          *out = sum;
+        }
+      }
+      else
+      {
+        // Read the input before writing so that in-place scans work.
+        T sum = this->Carry[block];
+        for (; first < last; ++it, ++out, ++first)
+        {
+          T value = *it;
+          *out = sum;
+          sum = this->Op(sum, value);
+        }
+      }
+    }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -147,7 +338,10 @@ public:
    * operator() of the functor object. The grain gives the parallel
    * engine a hint about the coarseness over which to parallelize
    * the function (as defined by last-first of each execution of
-   * operator() ).
+   * operator() ). For() may be called from within the operator() of
+   * another For(); with backends that do not support nested
+   * parallelism (Sequential, STDThread, OpenMP without nesting
+   * enabled) the inner loop runs on the calling thread.
    */
   template <typename Functor>
   static void For(vtkIdType first, vtkIdType last, vtkIdType grain, Functor& f)
@@ -210,7 +404,7 @@ public:
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
    * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
+   * supports it (currently STDThread, OpenMP and TBB). Make sure to call
    * it before any other parallel operation.
    * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
    * the number of threads used in the thread pool.
@@ -249,6 +443,167 @@ public:
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
   }
 
+  /**
+   * A convenience method for transforming data. It is a drop in replacement
+   * for std::transform(), it applies transform to every value of
+   * [inBegin, inEnd) and stores the result in the range starting at
+   * outBegin. The iterators must be random access iterators and transform
+   * must be safe to call concurrently.
+   */
+  template <typename InputIt, typename OutputIt, typename Functor>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+                        Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransformCall<InputIt, OutputIt,
+      Functor> worker(inBegin, outBegin, transform);
+    vtkSMPTools::For(0, inEnd - inBegin, worker);
+  }
+
+  /**
+   * A convenience method for transforming data. It is a drop in replacement
+   * for the binary std::transform(), it applies transform to the values of
+   * [inBegin1, inEnd) and the range starting at inBegin2, and stores the
+   * result in the range starting at outBegin.
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename Functor>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd, InputIt2 inBegin2,
+                        OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransformCall<InputIt1, InputIt2,
+      OutputIt, Functor> worker(inBegin1, inBegin2, outBegin, transform);
+    vtkSMPTools::For(0, inEnd - inBegin1, worker);
+  }
+
+  /**
+   * A convenience method for filling data. It is a drop in replacement for
+   * std::fill(), it assigns value to every element of [begin, end).
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_FillFunctor<Iterator, T> fill(begin, value);
+    vtkSMPTools::For(0, end - begin, fill);
+  }
+
+  /**
+   * Reduce the values of [begin, end) with op, starting from init. op must
+   * be associative; the order in which the values are combined only depends
+   * on the size of the range, so the result does not change with the number
+   * of threads. Uses addition by default.
+   */
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    const vtk::detail::smp::vtkSMPTools_Blocks blocks(end - begin);
+    if (blocks.NumberOfBlocks == 0)
+    {
+      return init;
+    }
+    std::vector<T> partial(blocks.NumberOfBlocks, init);
+    vtk::detail::smp::vtkSMPTools_ReduceBlocks<Iterator, T, BinaryOp>
+      reduce(begin, blocks, op, partial);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reduce);
+    for (vtkIdType block = 0; block < blocks.NumberOfBlocks; ++block)
+    {
+      init = op(init, partial[block]);
+    }
+    return init;
+  }
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+
+  /**
+   * Compute the inclusive prefix "sum" of [begin, end) with op and store it
+   * in the range starting at out, i.e. out[i] = in[0] op ... op in[i]. out
+   * may be equal to begin. Like Reduce(), the result does not depend on the
+   * number of threads. Returns the end of the output range. Uses addition
+   * by default.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static OutputIt InclusiveScan(InputIt begin, InputIt end, OutputIt out,
+                                BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    const vtk::detail::smp::vtkSMPTools_Blocks blocks(end - begin);
+    if (blocks.NumberOfBlocks == 0)
+    {
+      return out;
+    }
+    std::vector<T> carry(blocks.NumberOfBlocks, *begin);
+    if (blocks.NumberOfBlocks > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_ReduceBlocks<InputIt, T, BinaryOp>
+        reduce(begin, blocks, op, carry);
+      vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reduce);
+      // carry[block] becomes the reduction of all the previous blocks.
+      T sum = carry[0];
+      for (vtkIdType block = 1; block < blocks.NumberOfBlocks; ++block)
+      {
+        T blockSum = carry[block];
+        carry[block] = sum;
+        sum = op(sum, blockSum);
+      }
+    }
+    vtk::detail::smp::vtkSMPTools_ScanBlocks<InputIt, OutputIt, T, BinaryOp,
+      true> scan(begin, out, blocks, op, carry);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, scan);
+    return out + (end - begin);
+  }
+  template <typename InputIt, typename OutputIt>
+  static OutputIt InclusiveScan(InputIt begin, InputIt end, OutputIt out)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::InclusiveScan(begin, end, out, std::plus<T>());
+  }
+
+  /**
+   * Compute the exclusive prefix "sum" of [begin, end) with op, starting
+   * from init, and store it in the range starting at out, i.e. out[0] = init
+   * and out[i] = init op in[0] op ... op in[i-1]. out may be equal to begin.
+   * A typical use is to turn an array of counts (with one extra value at the
+   * end) into offsets, the last offset being the total count. Like Reduce(),
+   * the result does not depend on the number of threads. Returns the end of
+   * the output range. Uses addition by default.
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt ExclusiveScan(InputIt begin, InputIt end, OutputIt out,
+                                T init, BinaryOp op)
+  {
+    const vtk::detail::smp::vtkSMPTools_Blocks blocks(end - begin);
+    if (blocks.NumberOfBlocks == 0)
+    {
+      return out;
+    }
+    std::vector<T> carry(blocks.NumberOfBlocks, init);
+    if (blocks.NumberOfBlocks > 1)
+    {
+      vtk::detail::smp::vtkSMPTools_ReduceBlocks<InputIt, T, BinaryOp>
+        reduce(begin, blocks, op, carry);
+      vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reduce);
+      T sum = init;
+      for (vtkIdType block = 0; block < blocks.NumberOfBlocks; ++block)
+      {
+        T blockSum = carry[block];
+        carry[block] = sum;
+        sum = op(sum, blockSum);
+      }
+    }
+    vtk::detail::smp::vtkSMPTools_ScanBlocks<InputIt, OutputIt, T, BinaryOp,
+      false> scan(begin, out, blocks, op, carry);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, scan);
+    return out + (end - begin);
+  }
+  template <typename InputIt, typename OutputIt, typename T>
+  static OutputIt ExclusiveScan(InputIt begin, InputIt end, OutputIt out,
+                                T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, out, init, std::plus<T>());
+  }
+
 };
 
 #endif
@@ -32,8 +32,12 @@
 #include "vtkStringArray.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
+#include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
+#include <algorithm>
+#include <cstring>
 #include <functional>  //std::greater
+#include <vector>
 
 //-------------------------------------------------------------------------
 
@@ -477,6 +481,306 @@ SortArrayByComponent( vtkAbstractArray* arr, int k, int dir)
 }
 
 
+//---------------------------------------------------------------------------
+// The radix sort of float and double keys
+namespace {
+
+// The number of keys below which they are sorted by the calling thread
+// alone, since the threads would cost more than they save.
+const vtkIdType VTK_RADIX_SORT_SMP_THRESHOLD = 65536;
+
+// The keys are sorted by digits of 8 bits, from the least significant one.
+const int VTK_RADIX_SORT_DIGIT_BITS = 8;
+const int VTK_RADIX_SORT_BUCKETS = 1 << VTK_RADIX_SORT_DIGIT_BITS;
+
+template <typename TReal> struct RadixSortTraits;
+template <> struct RadixSortTraits<float> { typedef vtkTypeUInt32 UIntType; };
+template <> struct RadixSortTraits<double> { typedef vtkTypeUInt64 UIntType; };
+
+//---------------------------------------------------------------------------
+// Maps the bits of the keys to unsigned integers in the same order (in the
+// reverse order when Flip is all ones), or back when Decode is set.
+template <typename TReal, typename TUInt>
+struct RadixSortEncode
+{
+  TReal *Keys;
+  TUInt *Bits;
+  TUInt Flip;
+  bool Decode;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const TUInt sign = static_cast<TUInt>(1) << (8*sizeof(TUInt) - 1);
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      TUInt bits;
+      if (this->Decode)
+      {
+        bits = this->Bits[i] ^ this->Flip;
+        bits = (bits & sign) ? (bits & ~sign) : ~bits;
+        memcpy(this->Keys + i, &bits, sizeof(TUInt));
+      }
+      else
+      {
+        memcpy(&bits, this->Keys + i, sizeof(TUInt));
+        bits = (bits & sign) ? ~bits : (bits | sign);
+        this->Bits[i] = bits ^ this->Flip;
+      }
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Counts the keys smaller than the previous one.
+template <typename TUInt>
+struct RadixSortCountDescents
+{
+  const TUInt *Bits;
+  vtkSMPThreadLocal<vtkIdType> Descents;
+
+  void Initialize()
+  {
+    this->Descents.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType &descents = this->Descents.Local();
+    for (vtkIdType i = (begin > 0 ? begin : 1); i < end; ++i)
+    {
+      if (this->Bits[i] < this->Bits[i-1])
+      {
+        ++descents;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//---------------------------------------------------------------------------
+// Counts the digits of the keys of blocks of keys, or scatters them to their
+// sorted position, once the counts are turned into offsets.
+template <typename TUInt>
+struct RadixSortPass
+{
+  TUInt *Bits;
+  vtkIdType *Ids;
+  TUInt *SortedBits;
+  vtkIdType *SortedIds;
+  vtkIdType NumberOfKeys;
+  vtkIdType BlockSize;
+  vtkIdType *Counts;
+  int Shift;
+  bool Scatter;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const TUInt mask = VTK_RADIX_SORT_BUCKETS - 1;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType begin = block*this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfKeys);
+      vtkIdType *counts = this->Counts + block*VTK_RADIX_SORT_BUCKETS;
+      if (this->Scatter)
+      {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          vtkIdType pos = counts[(this->Bits[i] >> this->Shift) & mask]++;
+          this->SortedBits[pos] = this->Bits[i];
+          this->SortedIds[pos] = this->Ids[i];
+        }
+      }
+      else
+      {
+        std::fill_n(counts, VTK_RADIX_SORT_BUCKETS, 0);
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          counts[(this->Bits[i] >> this->Shift) & mask]++;
+        }
+      }
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Sorts the keys out of order at a few places by insertion, unless more
+// than maxMoves moves are needed, in which case the keys are left partly
+// sorted and false is returned.
+template <typename TUInt>
+bool RadixSortInsertion(TUInt *bits, vtkIdType *ids, vtkIdType numKeys,
+                        vtkIdType maxMoves)
+{
+  vtkIdType moves = 0;
+  for (vtkIdType i = 1; i < numKeys; ++i)
+  {
+    if (!(bits[i] < bits[i-1]))
+    {
+      continue;
+    }
+    TUInt b = bits[i];
+    vtkIdType id = ids[i];
+    vtkIdType j = i;
+    for (; j > 0 && b < bits[j-1]; --j)
+    {
+      bits[j] = bits[j-1];
+      ids[j] = ids[j-1];
+    }
+    bits[j] = b;
+    ids[j] = id;
+    moves += i - j;
+    if (moves > maxMoves)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// Runs the functor over the n keys or blocks of keys, with the given grain.
+template <typename TFunctor>
+void RadixSortFor(vtkIdType numKeys, vtkIdType n, vtkIdType grain,
+                  TFunctor &functor)
+{
+  if (numKeys < VTK_RADIX_SORT_SMP_THRESHOLD)
+  {
+    functor(0, n);
+  }
+  else
+  {
+    vtkSMPTools::For(0, n, grain, functor);
+  }
+}
+
+//---------------------------------------------------------------------------
+template <typename TReal>
+void RadixSortKeys(TReal *keys, vtkIdType *ids, vtkIdType numKeys, int dir)
+{
+  typedef typename RadixSortTraits<TReal>::UIntType TUInt;
+  if (numKeys < 2)
+  {
+    return;
+  }
+
+  std::vector<TUInt> bits(numKeys);
+  RadixSortEncode<TReal, TUInt> encode;
+  encode.Keys = keys;
+  encode.Bits = &bits[0];
+  encode.Flip = dir ? ~static_cast<TUInt>(0) : 0;
+  encode.Decode = false;
+  RadixSortFor(numKeys, numKeys, 0, encode);
+
+  // Keys sorted by a previous sort, for a close order, are left as they are
+  // or put in order by insertion.
+  RadixSortCountDescents<TUInt> countDescents;
+  countDescents.Bits = &bits[0];
+  if (numKeys < VTK_RADIX_SORT_SMP_THRESHOLD)
+  {
+    countDescents.Initialize();
+    countDescents(0, numKeys);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numKeys, countDescents);
+  }
+  vtkIdType descents = 0;
+  vtkSMPThreadLocal<vtkIdType>::iterator iter;
+  for (iter = countDescents.Descents.begin();
+       iter != countDescents.Descents.end(); ++iter)
+  {
+    descents += *iter;
+  }
+  if (descents == 0)
+  {
+    return;
+  }
+  bool sorted = (descents <= numKeys/64 &&
+                 RadixSortInsertion(&bits[0], ids, numKeys, numKeys));
+
+  if (!sorted)
+  {
+    std::vector<TUInt> sortedBits(numKeys);
+    std::vector<vtkIdType> sortedIds(numKeys);
+
+    vtkIdType numBlocks = 1;
+    if (numKeys >= VTK_RADIX_SORT_SMP_THRESHOLD)
+    {
+      numBlocks = std::min<vtkIdType>(
+        numKeys/(VTK_RADIX_SORT_SMP_THRESHOLD/4),
+        4*vtkSMPTools::GetEstimatedNumberOfThreads());
+    }
+    std::vector<vtkIdType> counts(numBlocks*VTK_RADIX_SORT_BUCKETS);
+
+    RadixSortPass<TUInt> pass;
+    pass.Bits = &bits[0];
+    pass.Ids = ids;
+    pass.SortedBits = &sortedBits[0];
+    pass.SortedIds = &sortedIds[0];
+    pass.NumberOfKeys = numKeys;
+    pass.BlockSize = (numKeys + numBlocks - 1)/numBlocks;
+    pass.Counts = &counts[0];
+    for (pass.Shift = 0; pass.Shift < static_cast<int>(8*sizeof(TUInt));
+         pass.Shift += VTK_RADIX_SORT_DIGIT_BITS)
+    {
+      pass.Scatter = false;
+      RadixSortFor(numKeys, numBlocks, 1, pass);
+
+      // Turn the counts into the offsets of the keys of the blocks, unless
+      // all the keys share the same digit
+      vtkIdType offset = 0;
+      bool sameDigit = false;
+      for (int digit = 0; digit < VTK_RADIX_SORT_BUCKETS && !sameDigit; ++digit)
+      {
+        vtkIdType digitOffset = offset;
+        for (vtkIdType block = 0; block < numBlocks; ++block)
+        {
+          vtkIdType count = counts[block*VTK_RADIX_SORT_BUCKETS + digit];
+          counts[block*VTK_RADIX_SORT_BUCKETS + digit] = offset;
+          offset += count;
+        }
+        sameDigit = (offset - digitOffset == numKeys);
+      }
+      if (sameDigit)
+      {
+        continue;
+      }
+
+      pass.Scatter = true;
+      RadixSortFor(numKeys, numBlocks, 1, pass);
+      std::swap(pass.Bits, pass.SortedBits);
+      std::swap(pass.Ids, pass.SortedIds);
+    }
+
+    if (pass.Bits != &bits[0])
+    {
+      std::copy(pass.Bits, pass.Bits + numKeys, bits.begin());
+      std::copy(pass.Ids, pass.Ids + numKeys, ids);
+    }
+  }
+
+  encode.Decode = true;
+  RadixSortFor(numKeys, numKeys, 0, encode);
+}
+
+}//anonymous namespace
+
+//---------------------------------------------------------------------------
+void vtkSortDataArray::
+RadixSort(float *keys, vtkIdType *ids, vtkIdType numKeys, int dir)
+{
+  RadixSortKeys(keys, ids, numKeys, dir);
+}
+
+//---------------------------------------------------------------------------
+void vtkSortDataArray::
+RadixSort(double *keys, vtkIdType *ids, vtkIdType numKeys, int dir)
+{
+  RadixSortKeys(keys, ids, numKeys, dir);
+}
+
 //-------------------------------------------------------------------------
 void vtkSortDataArray::PrintSelf(ostream &os, vtkIndent indent)
 {
@@ -145,6 +145,23 @@ public:
    */
   static void SortArrayByComponent( vtkAbstractArray* arr, int k, int dir);
 
+  //@{
+  /**
+   * Sorts the given keys and their ids in either ascending (dir=0) or
+   * descending (dir=1) order of the keys, where keys and ids hold numKeys
+   * values each. This is a stable least significant digit radix sort,
+   * threaded with vtkSMPTools, which takes a time linear in the number of
+   * keys. Keys already sorted, or out of order at only a few places as the
+   * depths of cells along a view direction which changed a little since
+   * they were last sorted, are detected and put in order without the radix
+   * passes.
+   */
+  static void RadixSort(float *keys, vtkIdType *ids, vtkIdType numKeys,
+                        int dir);
+  static void RadixSort(double *keys, vtkIdType *ids, vtkIdType numKeys,
+                        int dir);
+  //@}
+
   //@{
   /**
    * The following are general functions which can be used to produce an
@@ -0,0 +1,283 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This tests the storage modes of vtkCellArray: legacy interleaved list and
+// offsets/connectivity with 32-bit and 64-bit ids.
+
+#include "vtkAtomic.h"
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkTypeInt64Array.h"
+
+#include <iostream>
+
+#define TEST_ASSERT(cond)                                             \
+  if (!(cond))                                                        \
+  {                                                                   \
+    std::cerr << "Failed (line " << __LINE__ << "): " #cond << endl;  \
+    return false;                                                     \
+  }
+
+namespace
+{
+
+// Cell i has (i % 5) + 1 points with ids (i + j).
+const vtkIdType NumberOfCells = 1000;
+
+void FillCells(vtkCellArray* ca)
+{
+  vtkIdType pts[5];
+  for (vtkIdType i = 0; i < NumberOfCells; ++i)
+  {
+    vtkIdType npts = (i % 5) + 1;
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      pts[j] = i + j;
+    }
+    ca->InsertNextCell(npts, pts);
+  }
+}
+
+bool CheckCells(vtkCellArray* ca)
+{
+  TEST_ASSERT(ca->GetNumberOfCells() == NumberOfCells);
+
+  // Traversal
+  vtkIdType npts, *pts;
+  vtkIdType cellId = 0;
+  vtkIdType numEntries = 0;
+  for (ca->InitTraversal(); ca->GetNextCell(npts, pts); ++cellId)
+  {
+    TEST_ASSERT(npts == (cellId % 5) + 1);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      TEST_ASSERT(pts[j] == cellId + j);
+    }
+    // Locations keep their legacy meaning
+    TEST_ASSERT(ca->GetTraversalLocation(npts) == numEntries);
+    vtkIdType npts2, *pts2;
+    ca->GetCell(numEntries, npts2, pts2);
+    TEST_ASSERT(npts2 == npts && pts2[npts - 1] == cellId + npts - 1);
+    numEntries += npts + 1;
+  }
+  TEST_ASSERT(cellId == NumberOfCells);
+  TEST_ASSERT(ca->GetNumberOfConnectivityEntries() == numEntries);
+  TEST_ASSERT(ca->GetMaxCellSize() == 5);
+
+  // Random access
+  vtkNew<vtkIdList> ids;
+  for (cellId = NumberOfCells - 1; cellId >= 0; cellId -= 7)
+  {
+    ca->GetCellAtId(cellId, ids);
+    TEST_ASSERT(ids->GetNumberOfIds() == (cellId % 5) + 1);
+    TEST_ASSERT(ca->GetCellSize(cellId) == ids->GetNumberOfIds());
+    TEST_ASSERT(ids->GetId(0) == cellId);
+  }
+  return true;
+}
+
+// Concurrent random access through the const API.
+struct CheckCellsFunctor
+{
+  const vtkCellArray* Cells;
+  vtkAtomic<int> Errors;
+  vtkSMPThreadLocalObject<vtkIdList> TLIds;
+
+  void Initialize() {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList* ids = this->TLIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Cells->GetCellAtId(cellId, npts, pts, ids);
+      if (npts != (cellId % 5) + 1 || pts[npts - 1] != cellId + npts - 1)
+      {
+        ++this->Errors;
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+bool TestStorage(int type)
+{
+  vtkNew<vtkCellArray> ca;
+  TEST_ASSERT(ca->SetStorageType(type));
+  TEST_ASSERT(ca->GetStorageType() == type);
+  FillCells(ca);
+  if (!CheckCells(ca))
+  {
+    return false;
+  }
+
+  CheckCellsFunctor functor;
+  functor.Cells = ca;
+  functor.Errors = 0;
+  vtkSMPTools::For(0, NumberOfCells, functor);
+  TEST_ASSERT(functor.Errors == 0);
+
+  // Convert to all the other storages and back.
+  for (int other = vtkCellArray::LEGACY_STORAGE;
+       other <= vtkCellArray::OFFSETS_64BIT_STORAGE; ++other)
+  {
+    vtkNew<vtkCellArray> copy;
+    copy->DeepCopy(ca);
+    TEST_ASSERT(copy->GetStorageType() == type);
+    TEST_ASSERT(copy->SetStorageType(other));
+    if (!CheckCells(copy))
+    {
+      return false;
+    }
+    TEST_ASSERT(copy->SetStorageType(type));
+    if (!CheckCells(copy))
+    {
+      return false;
+    }
+  }
+
+  // Reverse/replace a cell given its location.
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < 4; ++i)
+  {
+    loc += (i % 5) + 2;
+  }
+  ca->ReverseCell(loc);
+  vtkNew<vtkIdList> ids;
+  ca->GetCellAtId(4, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 5 && ids->GetId(0) == 8);
+  vtkIdType newPts[5] = { 10, 11, 12, 13, 14 };
+  ca->ReplaceCell(loc, 5, newPts);
+  ca->GetCellAtId(4, ids);
+  TEST_ASSERT(ids->GetId(0) == 10 && ids->GetId(4) == 14);
+
+  // Incremental insertion.
+  ca->Reset();
+  ca->InsertNextCell(3);
+  ca->InsertCellPoint(7);
+  ca->InsertCellPoint(8);
+  ca->UpdateCellCount(2);
+  ca->InsertNextCell(2, newPts);
+  TEST_ASSERT(ca->GetNumberOfCells() == 2);
+  TEST_ASSERT(ca->GetNumberOfConnectivityEntries() == 6);
+  TEST_ASSERT(ca->GetInsertLocation(2) == 3);
+  ca->GetCellAtId(0, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 2 && ids->GetId(1) == 8);
+  ca->GetCellAtId(1, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 2 && ids->GetId(1) == 11);
+  return true;
+}
+
+bool TestImportExport()
+{
+  // Zero-copy import of 32-bit arrays.
+  vtkNew<vtkTypeInt32Array> offsets;
+  vtkNew<vtkTypeInt32Array> conn;
+  offsets->InsertNextValue(0);
+  for (vtkIdType i = 0; i < NumberOfCells; ++i)
+  {
+    vtkIdType npts = (i % 5) + 1;
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      conn->InsertNextValue(static_cast<vtkTypeInt32>(i + j));
+    }
+    offsets->InsertNextValue(conn->GetNumberOfValues());
+  }
+
+  vtkNew<vtkCellArray> ca;
+  TEST_ASSERT(ca->SetData(offsets, conn));
+  TEST_ASSERT(ca->GetStorageType() == vtkCellArray::OFFSETS_32BIT_STORAGE);
+  TEST_ASSERT(ca->GetOffsetsArray() == offsets.GetPointer());
+  TEST_ASSERT(ca->GetConnectivityArray() == conn.GetPointer());
+  TEST_ASSERT(!ca->IsStorage64Bit());
+  if (!CheckCells(ca))
+  {
+    return false;
+  }
+
+  // Exporting as a legacy list converts the storage.
+  vtkIdType numEntries = ca->GetNumberOfConnectivityEntries();
+  TEST_ASSERT(ca->GetData()->GetNumberOfValues() == numEntries);
+  TEST_ASSERT(ca->GetStorageType() == vtkCellArray::LEGACY_STORAGE);
+  TEST_ASSERT(ca->GetOffsetsArray() == nullptr);
+  if (!CheckCells(ca))
+  {
+    return false;
+  }
+
+  // Arrays of other types are copied into a 64-bit storage.
+  vtkNew<vtkIntArray> intOffsets;
+  intOffsets->DeepCopy(offsets);
+  vtkNew<vtkTypeInt64Array> longConn;
+  longConn->DeepCopy(conn);
+  TEST_ASSERT(ca->SetData(intOffsets, longConn));
+  TEST_ASSERT(ca->GetStorageType() == vtkCellArray::OFFSETS_64BIT_STORAGE);
+  TEST_ASSERT(ca->GetConnectivityArray() != longConn.GetPointer());
+  if (!CheckCells(ca))
+  {
+    return false;
+  }
+
+  // Inconsistent arrays are rejected.
+  offsets->SetValue(0, 1);
+  vtkObject::GlobalWarningDisplayOff();
+  bool rejected = !ca->SetData(offsets, conn);
+  vtkObject::GlobalWarningDisplayOn();
+  TEST_ASSERT(rejected);
+  return true;
+}
+
+} // end anon namespace
+
+int TestCellArray(int, char*[])
+{
+  for (int type = vtkCellArray::LEGACY_STORAGE;
+       type <= vtkCellArray::OFFSETS_64BIT_STORAGE; ++type)
+  {
+    if (!TestStorage(type))
+    {
+      std::cerr << "Storage type " << type << " failed." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!TestImportExport())
+  {
+    std::cerr << "Import/export failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Cells that do not fit in 32 bits cannot be stored in 32-bit storage.
+  vtkNew<vtkCellArray> ca;
+  vtkIdType pts[2] = { 0, VTK_ID_MAX };
+  ca->InsertNextCell(2, pts);
+  vtkObject::GlobalWarningDisplayOff();
+  bool converted = ca->Use32BitStorage();
+  vtkObject::GlobalWarningDisplayOn();
+  if (sizeof(vtkIdType) == 8 && converted)
+  {
+    std::cerr << "Converting 64-bit ids to 32-bit storage succeeded." << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
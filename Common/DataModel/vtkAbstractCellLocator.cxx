@@ -19,9 +19,16 @@
 #include "vtkCellArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkPoints.h"
 #include "vtkDataSet.h"
 #include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
@@ -49,10 +56,19 @@ bool vtkAbstractCellLocator::StoreCellBounds()
   // Allocate space for cell bounds storage, then fill
   vtkIdType numCells = this->DataSet->GetNumberOfCells();
   this->CellBounds = new double [numCells][6];
-  for (vtkIdType j=0; j<numCells; j++)
+  if (numCells < 1)
   {
-    this->DataSet->GetCellBounds(j, CellBounds[j]);
+    return true;
   }
+  // The first call makes sure the dataset is ready for concurrent calls.
+  this->DataSet->GetCellBounds(0, this->CellBounds[0]);
+  vtkSMPTools::For(1, numCells, [this](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType j=begin; j<end; j++)
+    {
+      this->DataSet->GetCellBounds(j, this->CellBounds[j]);
+    }
+  });
   return true;
 }
 //----------------------------------------------------------------------------
@@ -202,6 +218,118 @@ vtkIdType vtkAbstractCellLocator::FindCell(
   return returnVal;
 }
 //----------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(vtkPoints *points,
+                                       vtkIdTypeArray *cellIds)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numPts);
+  if (numPts == 0)
+  {
+    return;
+  }
+  vtkIdType *ids = cellIds->GetPointer(0);
+  const int maxCellSize =
+    this->DataSet ? std::max(this->DataSet->GetMaxCellSize(), 1) : 1;
+
+  // The first point is located alone: this builds the locator if its
+  // evaluation is lazy, and lets the dataset initialize what it needs
+  // before the concurrent queries.
+  double x[3], pcoords[3];
+  std::vector<double> weights(maxCellSize);
+  points->GetPoint(0, x);
+  ids[0] = this->FindCell(x, 0.0, this->GenericCell, pcoords, weights.data());
+
+  if (!this->IsQueryThreadSafe())
+  {
+    for (vtkIdType ptId = 1; ptId < numPts; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      ids[ptId] =
+        this->FindCell(x, 0.0, this->GenericCell, pcoords, weights.data());
+    }
+    return;
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> cells;
+  vtkSMPThreadLocal<std::vector<double> > threadWeights;
+  vtkSMPTools::For(1, numPts, [&](vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkGenericCell *cell = cells.Local();
+    std::vector<double> &w = threadWeights.Local();
+    w.resize(maxCellSize);
+    double y[3], pc[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, y);
+      ids[ptId] = this->FindCell(y, 0.0, cell, pc, w.data());
+    }
+  });
+}
+//----------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(vtkPoints *p1, vtkPoints *p2,
+                                                double tol,
+                                                vtkIdTypeArray *cellIds,
+                                                vtkPoints *intersections)
+{
+  vtkIdType numLines = p1->GetNumberOfPoints();
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numLines);
+  if (intersections)
+  {
+    intersections->SetNumberOfPoints(numLines);
+  }
+  if (numLines == 0)
+  {
+    return;
+  }
+  vtkIdType *ids = cellIds->GetPointer(0);
+
+  auto intersect = [&](vtkIdType lineId, vtkGenericCell *cell)
+  {
+    double a0[3], a1[3], t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId = -1;
+    p1->GetPoint(lineId, a0);
+    p2->GetPoint(lineId, a1);
+    if (!this->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId, cellId,
+                                 cell))
+    {
+      cellId = -1;
+      x[0] = a1[0];
+      x[1] = a1[1];
+      x[2] = a1[2];
+    }
+    ids[lineId] = cellId;
+    if (intersections)
+    {
+      intersections->SetPoint(lineId, x);
+    }
+  };
+
+  // As in FindCells(), the first line is intersected alone.
+  intersect(0, this->GenericCell);
+
+  if (!this->IsQueryThreadSafe())
+  {
+    for (vtkIdType lineId = 1; lineId < numLines; ++lineId)
+    {
+      intersect(lineId, this->GenericCell);
+    }
+    return;
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> cells;
+  vtkSMPTools::For(1, numLines, [&](vtkIdType lineId, vtkIdType endLineId)
+  {
+    vtkGenericCell *cell = cells.Local();
+    for ( ; lineId < endLineId; ++lineId)
+    {
+      intersect(lineId, cell);
+    }
+  });
+}
+//----------------------------------------------------------------------------
 bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
 {
   double cellBounds[6], delta[3] = {0.0, 0.0, 0.0};
@@ -43,6 +43,7 @@
 class vtkCellArray;
 class vtkGenericCell;
 class vtkIdList;
+class vtkIdTypeArray;
 class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractCellLocator : public vtkLocator
@@ -264,6 +265,29 @@ public:
     double x[3], double tol2, vtkGenericCell *GenCell,
     double pcoords[3], double *weights);
 
+  /**
+   * Find the cells containing a batch of points. cellIds is resized to the
+   * number of points, and its value i is set to the id of the cell
+   * containing the point i, or to -1 if no cell contains it, as FindCell()
+   * would do. The locators whose queries are thread safe process the points
+   * in parallel with vtkSMPTools, using a vtkGenericCell per thread.
+   */
+  virtual void FindCells(vtkPoints *points, vtkIdTypeArray *cellIds);
+
+  /**
+   * Intersect a batch of finite lines with the cells, the line i going from
+   * the point i of p1 to the point i of p2. cellIds is resized to the number
+   * of lines, and its value i is set to the id of the cell intersected by
+   * the line i, or to -1 if the line does not intersect any cell, as
+   * IntersectWithLine() would do. If intersections is not nullptr, its point
+   * i is set to the intersection point of the line i, or to the point i of
+   * p2 if there is none. The locators whose queries are thread safe process
+   * the lines in parallel with vtkSMPTools.
+   */
+  virtual void IntersectWithLines(vtkPoints *p1, vtkPoints *p2, double tol,
+                                  vtkIdTypeArray *cellIds,
+                                  vtkPoints *intersections = nullptr);
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * Some locators cache cell bounds and this function can make use
@@ -287,6 +311,14 @@ protected:
   virtual void FreeCellBounds();
   //@}
 
+  /**
+   * Return true if FindCell() and IntersectWithLine() may be called
+   * concurrently, with a vtkGenericCell per thread, once the locator is
+   * built. FindCells() and IntersectWithLines() then run in parallel. The
+   * default implementation returns false.
+   */
+  virtual bool IsQueryThreadSafe() { return false; }
+
   int NumberOfCellsPerNode;
   vtkTypeBool RetainCellLists;
   vtkTypeBool CacheCellBounds;
@@ -42,6 +42,7 @@
 
 #include "vtkDataArray.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkMath.h"
 #include "vtkSmartPointer.h"
 #include "vtkStdString.h"
 
@@ -69,10 +70,59 @@ struct BaseArrayPair
                            const double *weights, vtkIdType outId) = 0;
   virtual void InterpolateEdge(vtkIdType v0, vtkIdType v1,
                                double t, vtkIdType outId) = 0;
+  virtual void Average(int numIds, const vtkIdType *ids, vtkIdType outId) = 0;
+  virtual void Majority(int numIds, const vtkIdType *ids, vtkIdType outId) = 0;
   virtual void AssignNullValue(vtkIdType outId) = 0;
   virtual void Realloc(vtkIdType sze) = 0;
 };
 
+// Average the input tuples in double precision, rounding the results to
+// the nearest integer for integral output types (as
+// vtkDataArray::InterpolateTuple() does).
+template <typename TInput, typename TOutput>
+void vtkArrayPairAverage(const TInput *input, TOutput *output, int numComp,
+                         int numIds, const vtkIdType *ids, vtkIdType outId)
+{
+  for (int j=0; j < numComp; ++j)
+  {
+    double v = 0.0;
+    for (int i=0; i < numIds; ++i)
+    {
+      v += static_cast<double>(input[ids[i]*numComp+j]);
+    }
+    vtkMath::RoundDoubleToIntegralIfNecessary(v / numIds,
+                                              output + outId*numComp + j);
+  }
+}
+
+// Assign the most frequent input value to each component (a majority vote),
+// the ties going to the smaller value.
+template <typename TInput, typename TOutput>
+void vtkArrayPairMajority(const TInput *input, TOutput *output, int numComp,
+                          int numIds, const vtkIdType *ids, vtkIdType outId)
+{
+  for (int j=0; j < numComp; ++j)
+  {
+    TInput best = input[ids[0]*numComp+j];
+    int bestCount = 0;
+    for (int i=0; i < numIds; ++i)
+    {
+      TInput value = input[ids[i]*numComp+j];
+      int count = 0;
+      for (int k=0; k < numIds; ++k)
+      {
+        count += (input[ids[k]*numComp+j] == value);
+      }
+      if (count > bestCount || (count == bestCount && value < best))
+      {
+        best = value;
+        bestCount = count;
+      }
+    }
+    output[outId*numComp+j] = static_cast<TOutput>(best);
+  }
+}
+
 // Type specific interpolation on a matched pair of data arrays
 template <typename T>
 struct ArrayPair : public BaseArrayPair
@@ -123,6 +173,18 @@ struct ArrayPair : public BaseArrayPair
     }
   }
 
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId) override
+  {
+    vtkArrayPairAverage(this->Input, this->Output, this->NumComp,
+                        numIds, ids, outId);
+  }
+
+  void Majority(int numIds, const vtkIdType *ids, vtkIdType outId) override
+  {
+    vtkArrayPairMajority(this->Input, this->Output, this->NumComp,
+                         numIds, ids, outId);
+  }
+
   void AssignNullValue(vtkIdType outId) override
   {
     for (int j=0; j < this->NumComp; ++j)
@@ -190,6 +252,18 @@ struct RealArrayPair : public BaseArrayPair
     }
   }
 
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId) override
+  {
+    vtkArrayPairAverage(this->Input, this->Output, this->NumComp,
+                        numIds, ids, outId);
+  }
+
+  void Majority(int numIds, const vtkIdType *ids, vtkIdType outId) override
+  {
+    vtkArrayPairMajority(this->Input, this->Output, this->NumComp,
+                         numIds, ids, outId);
+  }
+
   void AssignNullValue(vtkIdType outId) override
   {
     for (int j=0; j < this->NumComp; ++j)
@@ -226,6 +300,11 @@ struct ArrayList
                  vtkDataSetAttributes *outPD, double nullValue=0.0,
                  bool promote=true);
 
+  // Add the arrays of a field list (after the output attributes have been
+  // allocated with vtkDataSetAttributes::InterpolateAllocate(list, ...))
+  void AddArrays(vtkIdType numOutTuples, vtkDataSetAttributes::FieldList &list,
+                 vtkDataSetAttributes *inAttr, vtkDataSetAttributes *outAttr);
+
   // Add an array that interpolates from its own attribute values
   void AddSelfInterpolatingArrays(vtkIdType numOutPts, vtkDataSetAttributes *attr,
                                   double nullValue=0.0);
@@ -271,6 +350,26 @@ struct ArrayList
       }
   }
 
+  // Loop over the arrays and average the tuples of the ids
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId)
+  {
+      for (std::vector<BaseArrayPair*>::iterator it = Arrays.begin();
+           it != Arrays.end(); ++it)
+      {
+        (*it)->Average(numIds, ids, outId);
+      }
+  }
+
+  // Loop over the arrays and assign the most frequent values of the ids
+  void Majority(int numIds, const vtkIdType *ids, vtkIdType outId)
+  {
+      for (std::vector<BaseArrayPair*>::iterator it = Arrays.begin();
+           it != Arrays.end(); ++it)
+      {
+        (*it)->Majority(numIds, ids, outId);
+      }
+  }
+
   // Loop over the arrays and assign the null value
   void AssignNullValue(vtkIdType outId)
   {
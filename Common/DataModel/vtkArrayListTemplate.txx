@@ -181,6 +181,47 @@ AddArrays(vtkIdType numOutPts, vtkDataSetAttributes *inPD, vtkDataSetAttributes
   }//for each candidate array
 }
 
+//----------------------------------------------------------------------------
+// Add the arrays of a field list of a single input. This presumes that
+// vtkDataSetAttributes::InterpolateAllocate() has been called with the field
+// list, so the input and output arrays of each field have the same type and
+// number of components. The arrays are accessed through their pointers, so
+// the arrays without the standard memory layout are skipped.
+inline void ArrayList::
+AddArrays(vtkIdType numOutTuples, vtkDataSetAttributes::FieldList &list,
+          vtkDataSetAttributes *inAttr, vtkDataSetAttributes *outAttr)
+{
+  for (int i=0, numFields=list.GetNumberOfFields(); i < numFields; ++i)
+  {
+    int inIdx = list.GetDSAIndex(0,i);
+    int outIdx = list.GetFieldIndex(i);
+    if ( inIdx < 0 || outIdx < 0 )
+    {
+      continue;
+    }
+    vtkDataArray *iArray = inAttr->GetArray(inIdx);
+    vtkDataArray *oArray = outAttr->GetArray(outIdx);
+    if ( !iArray || !oArray || this->IsExcluded(iArray) ||
+         !iArray->HasStandardMemoryLayout() ||
+         !oArray->HasStandardMemoryLayout() ||
+         iArray->GetDataType() != oArray->GetDataType() ||
+         iArray->GetNumberOfComponents() != oArray->GetNumberOfComponents() )
+    {
+      continue;
+    }
+    int numComp = oArray->GetNumberOfComponents();
+    oArray->SetNumberOfTuples(numOutTuples);
+    void *iD = iArray->GetVoidPointer(0);
+    void *oD = oArray->GetVoidPointer(0);
+    switch (iArray->GetDataType())
+    {
+      vtkTemplateMacro(CreateArrayPair(this, static_cast<VTK_TT *>(iD),
+                       static_cast<VTK_TT *>(oD),numOutTuples,numComp,
+                       oArray,static_cast<VTK_TT>(0)));
+    }//over all VTK types
+  }//for each field
+}
+
 //----------------------------------------------------------------------------
 // Add the arrays to interpolate here. This presumes that vtkDataSetAttributes::CopyData() or
 // vtkDataSetAttributes::InterpolateData() has been called. This special version creates an
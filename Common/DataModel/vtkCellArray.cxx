@@ -14,9 +14,234 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkTypeInt64Array.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 
 vtkStandardNewMacro(vtkCellArray);
 
+//----------------------------------------------------------------------------
+// Helpers operating on the typed arrays of the offsets storage. The arrays
+// are always AOS arrays of vtkTypeInt32 or vtkTypeInt64 values.
+namespace
+{
+
+typedef vtkAOSDataArrayTemplate<vtkTypeInt32> vtkCellArray32;
+typedef vtkAOSDataArrayTemplate<vtkTypeInt64> vtkCellArray64;
+
+//----------------------------------------------------------------------------
+// Return a pointer to the point ids of a cell. If the storage does not hold
+// vtkIdType values, the ids are copied into scratch.
+template <typename T>
+void GetCellPointer(vtkAOSDataArrayTemplate<T>* offsets,
+                    vtkAOSDataArrayTemplate<T>* conn, vtkIdType cellId,
+                    vtkIdType& npts, vtkIdType*& pts, vtkIdList* scratch)
+{
+  const T* offs = offsets->GetPointer(0);
+  const vtkIdType beg = static_cast<vtkIdType>(offs[cellId]);
+  npts = static_cast<vtkIdType>(offs[cellId+1]) - beg;
+  if (std::is_same<T, vtkIdType>::value)
+  {
+    pts = reinterpret_cast<vtkIdType*>(conn->GetPointer(beg));
+  }
+  else
+  {
+    const T* cellPts = conn->GetPointer(beg);
+    scratch->SetNumberOfIds(npts);
+    pts = scratch->GetPointer(0);
+    std::copy(cellPts, cellPts + npts, pts);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+vtkIdType InsertNextCellImpl(vtkAOSDataArrayTemplate<T>* offsets,
+                             vtkAOSDataArrayTemplate<T>* conn,
+                             vtkIdType npts, const vtkIdType* pts)
+{
+  const vtkIdType beg = conn->GetNumberOfValues();
+  T* ptr = conn->WritePointer(beg, npts);
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    ptr[i] = static_cast<T>(pts[i]);
+  }
+  offsets->InsertNextValue(static_cast<T>(beg + npts));
+  return offsets->GetNumberOfValues() - 2;
+}
+
+//----------------------------------------------------------------------------
+// Legacy location of a cell: offsets[cellId] + cellId is the index of the
+// cell's size in the equivalent interleaved list. Since this is strictly
+// increasing, the cell can be found by a binary search.
+template <typename T>
+vtkIdType FindCellId(vtkAOSDataArrayTemplate<T>* offsets, vtkIdType loc)
+{
+  const T* offs = offsets->GetPointer(0);
+  vtkIdType lo = 0;
+  vtkIdType hi = offsets->GetNumberOfValues() - 1; // number of cells
+  while (lo < hi)
+  {
+    vtkIdType mid = lo + (hi - lo) / 2;
+    if (static_cast<vtkIdType>(offs[mid]) + mid < loc)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void ReverseCellImpl(vtkAOSDataArrayTemplate<T>* offsets,
+                     vtkAOSDataArrayTemplate<T>* conn, vtkIdType cellId)
+{
+  const T* offs = offsets->GetPointer(0);
+  T* pts = conn->GetPointer(0);
+  std::reverse(pts + offs[cellId], pts + offs[cellId+1]);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void ReplaceCellImpl(vtkAOSDataArrayTemplate<T>* offsets,
+                     vtkAOSDataArrayTemplate<T>* conn, vtkIdType cellId,
+                     int npts, const vtkIdType* pts)
+{
+  T* oldPts = conn->GetPointer(offsets->GetValue(cellId));
+  for (int i = 0; i < npts; ++i)
+  {
+    oldPts[i] = static_cast<T>(pts[i]);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Fill typed offsets/connectivity arrays from the legacy list. Returns false
+// if a value cannot be represented by T.
+template <typename T>
+bool LegacyToOffsets(vtkIdTypeArray* ia, vtkIdType numCells,
+                     vtkAOSDataArrayTemplate<T>* offsets,
+                     vtkAOSDataArrayTemplate<T>* conn)
+{
+  const vtkIdType numEntries = ia->GetMaxId() + 1;
+  const vtkIdType connSize = numEntries - numCells;
+  if (static_cast<vtkTypeInt64>(connSize) >
+      static_cast<vtkTypeInt64>(std::numeric_limits<T>::max()))
+  {
+    return false;
+  }
+
+  offsets->SetNumberOfValues(numCells + 1);
+  conn->SetNumberOfValues(connSize);
+  T* offs = offsets->GetPointer(0);
+  T* pts = conn->GetPointer(0);
+  const vtkIdType* legacy = ia->GetPointer(0);
+  const vtkIdType maxValue =
+    static_cast<vtkIdType>(std::min<vtkTypeInt64>(
+      std::numeric_limits<T>::max(), VTK_ID_MAX));
+
+  vtkIdType loc = 0;
+  vtkIdType off = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    offs[cellId] = static_cast<T>(off);
+    const vtkIdType npts = legacy[loc++];
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const vtkIdType ptId = legacy[loc++];
+      if (ptId > maxValue)
+      {
+        return false;
+      }
+      pts[off++] = static_cast<T>(ptId);
+    }
+  }
+  offs[numCells] = static_cast<T>(off);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void OffsetsToLegacy(vtkAOSDataArrayTemplate<T>* offsets,
+                     vtkAOSDataArrayTemplate<T>* conn, vtkIdType numCells,
+                     vtkIdTypeArray* ia)
+{
+  const T* offs = offsets->GetPointer(0);
+  const T* pts = conn->GetPointer(0);
+  vtkIdType* legacy =
+    ia->WritePointer(0, conn->GetNumberOfValues() + numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    *legacy++ = static_cast<vtkIdType>(offs[cellId+1] - offs[cellId]);
+    for (T i = offs[cellId]; i < offs[cellId+1]; ++i)
+    {
+      *legacy++ = static_cast<vtkIdType>(pts[i]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Copy values between the 32-bit and 64-bit storages. Returns false if a
+// value cannot be represented by TOut.
+template <typename TIn, typename TOut>
+bool ConvertValues(vtkDataArray* in, vtkAOSDataArrayTemplate<TOut>* out)
+{
+  vtkAOSDataArrayTemplate<TIn>* typedIn =
+    static_cast<vtkAOSDataArrayTemplate<TIn>*>(in);
+  const vtkIdType num = typedIn->GetNumberOfValues();
+  const TIn* src = typedIn->GetPointer(0);
+  out->SetNumberOfValues(num);
+  TOut* dst = out->GetPointer(0);
+  for (vtkIdType i = 0; i < num; ++i)
+  {
+    if (static_cast<vtkTypeInt64>(src[i]) >
+        static_cast<vtkTypeInt64>(std::numeric_limits<TOut>::max()))
+    {
+      return false;
+    }
+    dst[i] = static_cast<TOut>(src[i]);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* NewStorageArray(int storageType)
+{
+  if (storageType == vtkCellArray::OFFSETS_32BIT_STORAGE)
+  {
+    return vtkTypeInt32Array::New();
+  }
+  return vtkTypeInt64Array::New();
+}
+
+} // end anon namespace
+
+// Dispatch a call onto the typed arrays of the offsets storage.
+#define vtkCellArrayOffsetsDispatch(call)                          \
+  if (this->StorageType == OFFSETS_32BIT_STORAGE)                  \
+  {                                                                \
+    vtkCellArray32* offsets =                                      \
+      static_cast<vtkCellArray32*>(this->Offsets);                 \
+    vtkCellArray32* conn =                                         \
+      static_cast<vtkCellArray32*>(this->Connectivity);            \
+    (void)conn;                                                    \
+    call;                                                          \
+  }                                                                \
+  else                                                             \
+  {                                                                \
+    vtkCellArray64* offsets =                                      \
+      static_cast<vtkCellArray64*>(this->Offsets);                 \
+    vtkCellArray64* conn =                                         \
+      static_cast<vtkCellArray64*>(this->Connectivity);            \
+    (void)conn;                                                    \
+    call;                                                          \
+  }
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
@@ -24,6 +249,12 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+
+  this->StorageType = LEGACY_STORAGE;
+  this->Offsets = nullptr;
+  this->Connectivity = nullptr;
+  this->TraversalCellId = 0;
+  this->TempCell = vtkIdList::New();
 }
 
 //----------------------------------------------------------------------------
@@ -35,16 +266,46 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
   }
 
-  this->Ia->DeepCopy(ca->Ia);
+  if (ca->StorageType == LEGACY_STORAGE)
+  {
+    if (this->StorageType != LEGACY_STORAGE)
+    {
+      this->ReleaseOffsetsStorage();
+    }
+    this->Ia->DeepCopy(ca->Ia);
+  }
+  else
+  {
+    if (this->StorageType != ca->StorageType)
+    {
+      this->ReleaseOffsetsStorage();
+      this->Ia->Initialize();
+      this->StorageType = ca->StorageType;
+      this->Offsets = NewStorageArray(this->StorageType);
+      this->Connectivity = NewStorageArray(this->StorageType);
+    }
+    this->Offsets->DeepCopy(ca->Offsets);
+    this->Connectivity->DeepCopy(ca->Connectivity);
+  }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  if (this->Offsets)
+  {
+    this->Offsets->Delete();
+  }
+  if (this->Connectivity)
+  {
+    this->Connectivity->Delete();
+  }
+  this->TempCell->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -54,6 +315,385 @@ void vtkCellArray::Initialize()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->Offsets->Initialize();
+    this->Connectivity->Initialize();
+    this->ResetOffsets();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    return this->Ia->Allocate(sz,ext);
+  }
+
+  // Without knowing the cell sizes, assume triangles to size the offsets.
+  int ok = this->Connectivity->Allocate(sz, ext);
+  ok &= this->Offsets->Allocate(sz / 4 + 1, ext / 4 + 1);
+  this->ResetOffsets();
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::AllocateExact(vtkIdType numCells,
+                                 vtkIdType connectivitySize)
+{
+  this->NumberOfCells = 0;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    return this->Ia->Allocate(numCells + connectivitySize) != 0;
+  }
+
+  bool ok = this->Connectivity->Allocate(connectivitySize) != 0;
+  ok &= this->Offsets->Allocate(numCells + 1) != 0;
+  this->ResetOffsets();
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::IsStorage64Bit() const
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    return sizeof(vtkIdType) == 8;
+  }
+  return this->StorageType == OFFSETS_64BIT_STORAGE;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::IsStorageShareable() const
+{
+  switch (this->StorageType)
+  {
+    case OFFSETS_32BIT_STORAGE:
+      return std::is_same<vtkTypeInt32, vtkIdType>::value;
+    case OFFSETS_64BIT_STORAGE:
+      return std::is_same<vtkTypeInt64, vtkIdType>::value;
+    default:
+      return true;
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::SetStorageType(int type)
+{
+  if (type < LEGACY_STORAGE || type > OFFSETS_64BIT_STORAGE)
+  {
+    vtkErrorMacro("Unknown storage type " << type);
+    return false;
+  }
+  if (type == this->StorageType)
+  {
+    return true;
+  }
+
+  if (type == LEGACY_STORAGE)
+  {
+    vtkIdTypeArray* ia = vtkIdTypeArray::New();
+    vtkCellArrayOffsetsDispatch(
+      OffsetsToLegacy(offsets, conn, this->NumberOfCells, ia));
+    this->ReleaseOffsetsStorage();
+    this->Ia->Delete();
+    this->Ia = ia;
+  }
+  else
+  {
+    vtkDataArray* newOffsets = NewStorageArray(type);
+    vtkDataArray* newConn = NewStorageArray(type);
+    bool ok;
+    if (this->StorageType == LEGACY_STORAGE)
+    {
+      ok = (type == OFFSETS_32BIT_STORAGE) ?
+        LegacyToOffsets(this->Ia, this->NumberOfCells,
+                        static_cast<vtkCellArray32*>(newOffsets),
+                        static_cast<vtkCellArray32*>(newConn)) :
+        LegacyToOffsets(this->Ia, this->NumberOfCells,
+                        static_cast<vtkCellArray64*>(newOffsets),
+                        static_cast<vtkCellArray64*>(newConn));
+    }
+    else if (type == OFFSETS_32BIT_STORAGE)
+    {
+      ok = ConvertValues<vtkTypeInt64>(
+             this->Offsets, static_cast<vtkCellArray32*>(newOffsets)) &&
+           ConvertValues<vtkTypeInt64>(
+             this->Connectivity, static_cast<vtkCellArray32*>(newConn));
+    }
+    else
+    {
+      ok = ConvertValues<vtkTypeInt32>(
+             this->Offsets, static_cast<vtkCellArray64*>(newOffsets)) &&
+           ConvertValues<vtkTypeInt32>(
+             this->Connectivity, static_cast<vtkCellArray64*>(newConn));
+    }
+    if (!ok)
+    {
+      newOffsets->Delete();
+      newConn->Delete();
+      vtkErrorMacro("Cells cannot be represented with 32-bit storage.");
+      return false;
+    }
+
+    this->ReleaseOffsetsStorage();
+    this->Ia->Initialize();
+    this->StorageType = type;
+    this->Offsets = newOffsets;
+    this->Connectivity = newConn;
+  }
+
+  // Locations have the same meaning in all storages, only the cell id of
+  // the traversal must be recomputed.
+  this->SetTraversalLocation(this->TraversalLocation);
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::SetData(vtkDataArray* offsets, vtkDataArray* connectivity)
+{
+  if (!offsets || !connectivity || offsets->GetNumberOfComponents() != 1 ||
+      connectivity->GetNumberOfComponents() != 1 ||
+      offsets->GetNumberOfTuples() < 1)
+  {
+    vtkErrorMacro("Invalid offsets or connectivity array.");
+    return false;
+  }
+  const vtkIdType numCells = offsets->GetNumberOfTuples() - 1;
+  if (static_cast<vtkIdType>(offsets->GetComponent(0, 0)) != 0 ||
+      static_cast<vtkIdType>(offsets->GetComponent(numCells, 0)) !=
+        connectivity->GetNumberOfTuples())
+  {
+    vtkErrorMacro("Offsets do not match the connectivity array.");
+    return false;
+  }
+
+  int type;
+  if (vtkArrayDownCast<vtkCellArray32>(offsets) &&
+      vtkArrayDownCast<vtkCellArray32>(connectivity))
+  {
+    type = OFFSETS_32BIT_STORAGE;
+    offsets->Register(this);
+    connectivity->Register(this);
+  }
+  else if (vtkArrayDownCast<vtkCellArray64>(offsets) &&
+           vtkArrayDownCast<vtkCellArray64>(connectivity))
+  {
+    type = OFFSETS_64BIT_STORAGE;
+    offsets->Register(this);
+    connectivity->Register(this);
+  }
+  else
+  {
+    // Not a type we can share, copy the values.
+    type = OFFSETS_64BIT_STORAGE;
+    vtkDataArray* newOffsets = NewStorageArray(type);
+    vtkDataArray* newConn = NewStorageArray(type);
+    newOffsets->DeepCopy(offsets);
+    newConn->DeepCopy(connectivity);
+    offsets = newOffsets;
+    connectivity = newConn;
+  }
+
+  this->ReleaseOffsetsStorage();
+  this->Ia->Initialize();
+  this->StorageType = type;
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->NumberOfCells = numCells;
+  this->InsertLocation = connectivity->GetNumberOfTuples() + numCells;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsetsStorage()
+{
+  if (this->Offsets)
+  {
+    this->Offsets->UnRegister(this);
+    this->Offsets = nullptr;
+  }
+  if (this->Connectivity)
+  {
+    this->Connectivity->UnRegister(this);
+    this->Connectivity = nullptr;
+  }
+  this->StorageType = LEGACY_STORAGE;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ResetOffsets()
+{
+  this->Connectivity->Reset();
+  this->Offsets->Reset();
+  this->Offsets->InsertNextTuple1(0.0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    return this->Ia->GetSize();
+  }
+  return this->Offsets->GetSize() + this->Connectivity->GetSize();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    this->Ia->Squeeze();
+  }
+  else
+  {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdFromLocation(vtkIdType loc) const
+{
+  vtkIdType cellId;
+  vtkCellArrayOffsetsDispatch(cellId = FindCellId(offsets, loc));
+  return cellId;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::GetNextCellOffsets(vtkIdType& npts, vtkIdType* &pts)
+{
+  if (this->TraversalCellId >= this->NumberOfCells)
+  {
+    npts = 0;
+    pts = nullptr;
+    return 0;
+  }
+  vtkCellArrayOffsetsDispatch(GetCellPointer(
+    offsets, conn, this->TraversalCellId, npts, pts, this->TempCell));
+  this->TraversalCellId++;
+  this->TraversalLocation += npts + 1;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellOffsets(vtkIdType loc, vtkIdType &npts,
+                                  vtkIdType* &pts)
+{
+  const vtkIdType cellId = this->GetCellIdFromLocation(loc);
+  vtkCellArrayOffsetsDispatch(
+    GetCellPointer(offsets, conn, cellId, npts, pts, this->TempCell));
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellOffsets(vtkIdType npts,
+                                              const vtkIdType* pts)
+{
+  vtkCellArrayOffsetsDispatch(InsertNextCellImpl(offsets, conn, npts, pts));
+  this->InsertLocation += npts + 1;
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellOffsets(int npts)
+{
+  // The new cell is empty and grows as points are added with
+  // InsertCellPoint(), so npts is not needed here.
+  (void)npts;
+  vtkCellArrayOffsetsDispatch(InsertNextCellImpl(offsets, conn, 0, nullptr));
+  this->InsertLocation++;
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::InsertCellPointOffsets(vtkIdType id)
+{
+  vtkCellArrayOffsetsDispatch(
+    conn->InsertNextValue(static_cast<decltype(conn->GetValue(0))>(id));
+    const vtkIdType last = offsets->GetNumberOfValues() - 1;
+    offsets->SetValue(last, offsets->GetValue(last) + 1));
+  this->InsertLocation++;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReverseCellOffsets(vtkIdType loc)
+{
+  const vtkIdType cellId = this->GetCellIdFromLocation(loc);
+  vtkCellArrayOffsetsDispatch(ReverseCellImpl(offsets, conn, cellId));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCellOffsets(vtkIdType loc, int npts,
+                                      const vtkIdType *pts)
+{
+  const vtkIdType cellId = this->GetCellIdFromLocation(loc);
+  vtkCellArrayOffsetsDispatch(
+    ReplaceCellImpl(offsets, conn, cellId, npts, pts));
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId) const
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    const vtkIdType* legacy = this->Ia->GetPointer(0);
+    vtkIdType loc = 0;
+    for (vtkIdType i = 0; i < cellId; ++i)
+    {
+      loc += legacy[loc] + 1;
+    }
+    return legacy[loc];
+  }
+  vtkIdType npts;
+  vtkCellArrayOffsetsDispatch(
+    npts = static_cast<vtkIdType>(offsets->GetValue(cellId+1) -
+                                  offsets->GetValue(cellId)));
+  return npts;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType& npts,
+                               const vtkIdType*& pts, vtkIdList* ptIds) const
+{
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    const vtkIdType* legacy = this->Ia->GetPointer(0);
+    vtkIdType loc = 0;
+    for (vtkIdType i = 0; i < cellId; ++i)
+    {
+      loc += legacy[loc] + 1;
+    }
+    npts = legacy[loc];
+    pts = legacy + loc + 1;
+    return;
+  }
+  vtkIdType* cellPts;
+  vtkCellArrayOffsetsDispatch(
+    GetCellPointer(offsets, conn, cellId, npts, cellPts, ptIds));
+  pts = cellPts;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList* pts) const
+{
+  vtkIdType npts;
+  const vtkIdType* ppts;
+  this->GetCellAtId(cellId, npts, ppts, pts);
+  if (ppts != pts->GetPointer(0))
+  {
+    pts->SetNumberOfIds(npts);
+    std::copy(ppts, ppts + npts, pts->GetPointer(0));
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -64,6 +704,15 @@ int vtkCellArray::GetMaxCellSize()
   int npts=0, maxSize=0;
   vtkIdType i;
 
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    for (i=0; i<this->NumberOfCells; ++i)
+    {
+      maxSize = std::max(maxSize, static_cast<int>(this->GetCellSize(i)));
+    }
+    return maxSize;
+  }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
   {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -81,6 +730,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
   if ( cells && cells != this->Ia )
   {
     this->Modified();
+    this->ReleaseOffsetsStorage();
     this->Ia->Delete();
     this->Ia = cells;
     this->Ia->Register(this);
@@ -88,13 +738,19 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
     this->NumberOfCells = ncells;
     this->InsertLocation = cells->GetMaxId() + 1;
     this->TraversalLocation = 0;
+    this->TraversalCellId = 0;
   }
 }
 
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    return this->Ia->GetActualMemorySize();
+  }
+  return this->Offsets->GetActualMemorySize() +
+    this->Connectivity->GetActualMemorySize();
 }
 
 //----------------------------------------------------------------------------
@@ -116,6 +772,11 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->GetCellAtId(this->GetCellIdFromLocation(loc), pts);
+    return;
+  }
   vtkIdType npts = this->Ia->GetValue(loc++);
   vtkIdType *ppts = this->Ia->GetPointer(loc);
   pts->SetNumberOfIds(npts);
@@ -133,4 +794,17 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage Type: ";
+  switch (this->StorageType)
+  {
+    case OFFSETS_32BIT_STORAGE:
+      os << "Offsets (32-bit)" << endl;
+      break;
+    case OFFSETS_64BIT_STORAGE:
+      os << "Offsets (64-bit)" << endl;
+      break;
+    default:
+      os << "Legacy" << endl;
+      break;
+  }
 }
@@ -28,6 +28,21 @@
  * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
  * the data structure.
  *
+ * Alternatively, the cells may be kept in an offsets/connectivity storage
+ * (see SetStorageType()). In this mode the point ids of all cells are kept
+ * back to back in a connectivity array, and an offsets array of
+ * (NumberOfCells+1) values gives the start of each cell in the
+ * connectivity array. Both arrays may hold either 32-bit or 64-bit integers.
+ * This storage provides O(1) random access to cells by id (see
+ * GetCellAtId()), which is safe to use from multiple threads, and the two
+ * arrays may be imported and exported without copying (see SetData(),
+ * GetOffsetsArray() and GetConnectivityArray()). The traversal and
+ * insertion API works in all storage modes; the "location" used by methods
+ * such as GetCell(loc,...) keeps its legacy meaning (offset of the cell in
+ * the equivalent interleaved list). Methods exposing the interleaved list
+ * directly (GetPointer(), GetData(), WritePointer(), SetCells()) switch the
+ * cell array back to the legacy storage.
+ *
  * @sa
  * vtkCellTypes vtkCellLinks
 */
@@ -41,6 +56,8 @@
 #include "vtkIdTypeArray.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
 
+class vtkDataArray;
+
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -53,10 +70,61 @@ public:
   static vtkCellArray *New();
 
   /**
-   * Allocate memory and set the size to extend by.
+   * The layouts used to store the cells. LEGACY_STORAGE is the interleaved
+   * (n,id1,id2,...,idn, ...) list. The OFFSETS storages keep separate
+   * offsets and connectivity arrays of 32-bit or 64-bit integers.
+   */
+  enum StorageTypes
+  {
+    LEGACY_STORAGE = 0,
+    OFFSETS_32BIT_STORAGE = 1,
+    OFFSETS_64BIT_STORAGE = 2
+  };
+
+  //@{
+  /**
+   * Set/Get the storage layout of the cell array. Changing the storage
+   * converts the cells already present. Returns false (and leaves the cell
+   * array unchanged) if the cells cannot be represented with the requested
+   * storage, e.g. if a point id or an offset does not fit in 32 bits.
+   * Use32BitStorage()/Use64BitStorage()/UseLegacyStorage() are
+   * conveniences for SetStorageType().
+   */
+  bool SetStorageType(int type);
+  int GetStorageType() const
+    {return this->StorageType;}
+  bool UseLegacyStorage()
+    {return this->SetStorageType(LEGACY_STORAGE);}
+  bool Use32BitStorage()
+    {return this->SetStorageType(OFFSETS_32BIT_STORAGE);}
+  bool Use64BitStorage()
+    {return this->SetStorageType(OFFSETS_64BIT_STORAGE);}
+  //@}
+
+  /**
+   * Return true if the cells are stored with 64-bit integers (this is also
+   * the case of the legacy storage when vtkIdType is 64 bits).
+   */
+  bool IsStorage64Bit() const;
+
+  /**
+   * Return true if the internal arrays hold vtkIdType values, in which case
+   * the point id pointers returned by the traversal methods point directly
+   * into the cell array instead of into a temporary copy.
+   */
+  bool IsStorageShareable() const;
+
+  /**
+   * Allocate memory and set the size to extend by. With the offsets
+   * storage, sz is the size of the equivalent legacy list.
+   */
+  int Allocate(vtkIdType sz, vtkIdType ext=1000);
+
+  /**
+   * Allocate exactly enough memory for numCells cells using connectivitySize
+   * point ids in total. Any existing cells are discarded.
    */
-  int Allocate(vtkIdType sz, vtkIdType ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  bool AllocateExact(vtkIdType numCells, vtkIdType connectivitySize);
 
   /**
    * Free any memory and reset to an empty state.
@@ -93,7 +161,7 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  InitTraversal() initializes the traversal of the list of cells.
    */
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() {this->TraversalLocation=0; this->TraversalCellId=0;};
 
   /**
    * A cell traversal methods that is more efficient than vtkDataSet traversal
@@ -112,18 +180,73 @@ public:
   int GetNextCell(vtkIdList *pts);
 
   /**
-   * Get the size of the allocated connectivity array.
+   * Get the size of the allocated connectivity array. With the offsets
+   * storage, this is the allocated size of both internal arrays.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
    * Get the total number of entries (i.e., data values) in the connectivity
    * array. This may be much less than the allocated size (i.e., return value
-   * from GetSize().)
+   * from GetSize().) With the offsets storage, this is the number of entries
+   * of the equivalent legacy list, i.e. the number of point ids plus the
+   * number of cells.
    */
   vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  {
+    return this->StorageType == LEGACY_STORAGE ? this->Ia->GetMaxId()+1 :
+      this->InsertLocation;
+  }
+
+  /**
+   * Return the number of points defining the cell cellId. This is O(1) with
+   * the offsets storage and O(cellId) with the legacy storage.
+   */
+  vtkIdType GetCellSize(vtkIdType cellId) const
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells());
+
+  /**
+   * Random access to the cell cellId. On return, pts points either into the
+   * cell array (when IsStorageShareable() is true) or into ptIds, which is
+   * used as scratch space. This method does not modify the cell array and
+   * can be called concurrently from multiple threads as long as each thread
+   * provides its own ptIds. This is O(1) with the offsets storage and
+   * O(cellId) with the legacy storage.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType& npts, const vtkIdType*& pts,
+                   vtkIdList* ptIds) const
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells())
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Random access to the cell cellId, copying its point ids into pts. This is
+   * thread safe as long as each thread provides its own pts.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList* pts) const
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells());
+
+  /**
+   * Set the offsets and connectivity arrays of the offsets storage. offsets
+   * must hold NumberOfCells+1 values, starting at 0 and ending with the
+   * number of values of connectivity. If both arrays are vtkTypeInt32Array
+   * or both are vtkTypeInt64Array (or vtkIdTypeArray), they are used
+   * directly without copying and the storage type is set accordingly;
+   * otherwise the values are copied into a 64-bit storage. Returns false if
+   * the arrays are inconsistent.
+   */
+  bool SetData(vtkDataArray* offsets, vtkDataArray* connectivity);
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays of the offsets storage, or
+   * nullptr with the legacy storage. The arrays are returned without copying
+   * and must not be resized by the caller.
+   */
+  vtkDataArray* GetOffsetsArray()
+    {return this->Offsets;}
+  vtkDataArray* GetConnectivityArray()
+    {return this->Connectivity;}
+  //@}
 
   /**
    * Internal method used to retrieve a cell given an offset into
@@ -190,8 +313,7 @@ public:
    */
   vtkIdType GetTraversalLocation()
     {return this->TraversalLocation;}
-  void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  void SetTraversalLocation(vtkIdType loc);
 
   /**
    * Computes the current traversal location within the internal array. Used
@@ -224,15 +346,23 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to array of cell data. With the offsets storage, the cell
+   * array is first converted to the legacy storage.
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+  {
+    if (this->StorageType != LEGACY_STORAGE)
+    {
+      this->UseLegacyStorage();
+    }
+    return this->Ia->GetPointer(0);
+  }
 
   /**
    * Get pointer to data array for purpose of direct writes of data. Size is the
    * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * represented in the array. This switches the cell array to the legacy
+   * storage.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -243,20 +373,28 @@ public:
    * referring these cells becomes invalid (for example, if BuildCells() has
    * been called see vtkPolyData).  The traversal location is reset to the
    * beginning of the list; the insertion location is set to the end of the
-   * list.
+   * list. This switches the cell array to the legacy storage.
    */
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
   /**
    * Perform a deep copy (no reference counting) of the given cell array.
+   * The storage type is copied as well.
    */
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the underlying data as a data array. With the offsets storage,
+   * the cell array is first converted to the legacy storage.
    */
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+  {
+    if (this->StorageType != LEGACY_STORAGE)
+    {
+      this->UseLegacyStorage();
+    }
+    return this->Ia;
+  }
 
   /**
    * Reuse list. Reset to initial condition.
@@ -266,8 +404,7 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -288,6 +425,32 @@ protected:
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Offsets storage. Offsets and Connectivity are nullptr with the legacy
+  // storage. InsertLocation and TraversalLocation are kept in terms of the
+  // equivalent legacy list.
+  int StorageType;
+  vtkDataArray *Offsets;
+  vtkDataArray *Connectivity;
+  vtkIdType TraversalCellId;
+  vtkIdList *TempCell; // scratch space when ids must be converted
+
+  // Implementation of the inline methods for the offsets storage.
+  int GetNextCellOffsets(vtkIdType& npts, vtkIdType* &pts);
+  void GetCellOffsets(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
+  vtkIdType InsertNextCellOffsets(vtkIdType npts, const vtkIdType* pts);
+  vtkIdType InsertNextCellOffsets(int npts);
+  void InsertCellPointOffsets(vtkIdType id);
+  void ReverseCellOffsets(vtkIdType loc);
+  void ReplaceCellOffsets(vtkIdType loc, int npts, const vtkIdType *pts);
+  void ResetOffsets();
+
+  // Map a legacy location onto a cell id (offsets storage only).
+  vtkIdType GetCellIdFromLocation(vtkIdType loc) const;
+
+  // Drop the offsets storage without converting it (the cells are
+  // discarded) and switch back to the legacy storage.
+  void ReleaseOffsetsStorage();
+
 private:
   vtkCellArray(const vtkCellArray&) = delete;
   void operator=(const vtkCellArray&) = delete;
@@ -298,6 +461,11 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellOffsets(npts, pts);
+  }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -315,6 +483,11 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellOffsets(npts);
+  }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -324,13 +497,23 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->InsertCellPointOffsets(id);
+    return;
+  }
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
-  this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  // With the offsets storage the size of the cell is given by the points
+  // actually inserted, so there is nothing to update.
+  if (this->StorageType == LEGACY_STORAGE)
+  {
+    this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -352,12 +535,33 @@ inline void vtkCellArray::Reset()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->ResetOffsets();
+    return;
+  }
   this->Ia->Reset();
 }
 
+//----------------------------------------------------------------------------
+inline void vtkCellArray::SetTraversalLocation(vtkIdType loc)
+{
+  this->TraversalLocation = loc;
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->TraversalCellId = this->GetCellIdFromLocation(loc);
+  }
+}
+
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    return this->GetNextCellOffsets(npts, pts);
+  }
+
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
   {
@@ -375,6 +579,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->GetCellOffsets(loc, npts, pts);
+    return;
+  }
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -382,6 +591,12 @@ inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
 //----------------------------------------------------------------------------
 inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->ReverseCellOffsets(loc);
+    return;
+  }
+
   int i;
   vtkIdType tmp;
   vtkIdType npts=this->Ia->GetValue(loc);
@@ -398,6 +613,12 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->ReplaceCellOffsets(loc, npts, pts);
+    return;
+  }
+
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
   {
@@ -409,9 +630,14 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  if (this->StorageType != LEGACY_STORAGE)
+  {
+    this->ReleaseOffsetsStorage();
+  }
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
   return this->Ia->WritePointer(0,size);
 }
 
@@ -20,8 +20,11 @@
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkBox.h"
+#include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCellLocator);
 
@@ -56,6 +59,41 @@ inline int vtkNeighborCells::InsertNextPoint(int *x)
   return id/3;
 }
 
+//----------------------------------------------------------------------------
+// A cell overlapping a leaf octant, sorted by octant and then by cell.
+struct vtkCellLocatorFragment
+{
+  vtkIdType OctantId;
+  vtkIdType CellId;
+
+  bool operator<(const vtkCellLocatorFragment& other) const
+  {
+    return this->OctantId < other.OctantId ||
+      (this->OctantId == other.OctantId && this->CellId < other.CellId);
+  }
+};
+
+//----------------------------------------------------------------------------
+static void vtkCellLocatorComputeOctantBounds(const double bounds[6],
+  const double h[3], int i, int j, int k, double octantBounds[6])
+{
+  octantBounds[0] = bounds[0] + i*h[0];
+  octantBounds[1] = octantBounds[0] + h[0];
+  octantBounds[2] = bounds[2] + j*h[1];
+  octantBounds[3] = octantBounds[2] + h[1];
+  octantBounds[4] = bounds[4] + k*h[2];
+  octantBounds[5] = octantBounds[4] + h[2];
+}
+
+//----------------------------------------------------------------------------
+static bool vtkCellLocatorIsInBounds(const double bounds[6],
+                                     const double x[3], double tol)
+{
+  return bounds[0]-tol <= x[0] && x[0] <= bounds[1]+tol &&
+    bounds[2]-tol <= x[1] && x[1] <= bounds[3]+tol &&
+    bounds[4]-tol <= x[2] && x[2] <= bounds[5]+tol;
+}
+
 //----------------------------------------------------------------------------
 // Construct with automatic computation of divisions, averaging
 // 25 cells per bucket.
@@ -152,13 +190,9 @@ void vtkCellLocator::ComputeOctantBounds(int i, int j, int k)
 // Return intersection point (if any) AND the cell which was intersected by
 // finite line.
 //
-// NOTE: This method is not thread safe (i.e., when invoking this method on
-// the same instance of vtkCellLocator). This is the due to the use of the
-// data members QueryNumber and CellHasBeenVisited. These should be pulled
-// out of the class and made local to the appropriate methods that use
-// them. Since there may be a performance cost and possible effects on
-// output, this will be done TODO when more time is available. To see an
-// alternative implementation, see vtkStaticCellLocator which is thread safe.
+// The cells already visited by the query are marked in an array local to
+// the call, as in vtkStaticCellLocator, so that the method is thread safe
+// once the locator is built.
 //
 int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
                                       double& t, double x[3], double pcoords[3],
@@ -183,6 +217,7 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
   double stopDist, currDist;
   double deltaT, pDistance, minPDistance=1.0e38;
   double length, maxLength=0.0;
+  double octantBounds[6];
 
   this->BuildLocatorIfNeeded();
 
@@ -222,15 +257,10 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
     leafStart = this->NumberOfOctants - this->NumberOfDivisions*prod;
     bestCellId = -1;
 
-    // Clear the array that indicates whether we have visited this cell.
-    // The array is only cleared when the query number rolls over.  This
-    // saves a number of calls to memset.
-    this->QueryNumber++;
-    if (this->QueryNumber == 0)
-    {
-      this->ClearCellHasBeenVisited();
-      this->QueryNumber++;    // can't use 0 as a marker
-    }
+    // The array that indicates whether we have visited this cell is local
+    // to the query, so that concurrent queries do not share it.
+    std::vector<unsigned char> cellHasBeenVisited(
+      this->DataSet->GetNumberOfCells(), 0);
 
     // set up curr and stop dist
     currDist = 0;
@@ -264,14 +294,15 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
     {
       if (this->Tree[idx])
       {
-        this->ComputeOctantBounds(pos[0]-1,pos[1]-1,pos[2]-1);
+        vtkCellLocatorComputeOctantBounds(this->Bounds, this->H,
+          pos[0]-1, pos[1]-1, pos[2]-1, octantBounds);
         for (tMax = VTK_DOUBLE_MAX, cellId=0;
         cellId < this->Tree[idx]->GetNumberOfIds(); cellId++)
         {
           cId = this->Tree[idx]->GetId(cellId);
-          if (this->CellHasBeenVisited[cId] != this->QueryNumber)
+          if (!cellHasBeenVisited[cId])
           {
-            this->CellHasBeenVisited[cId] = this->QueryNumber;
+            cellHasBeenVisited[cId] = 1;
             int hitCellBounds = 0;
 
             // check whether we intersect the cell bounds
@@ -296,9 +327,9 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
               this->DataSet->GetCell(cId, cell);
               if (cell->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId) )
               {
-                if ( ! this->IsInOctantBounds(x, tol) )
+                if ( ! vtkCellLocatorIsInBounds(octantBounds, x, tol) )
                 {
-                  this->CellHasBeenVisited[cId] = 0; //mark the cell non-visited
+                  cellHasBeenVisited[cId] = 0; //mark the cell non-visited
                 }
                 else
                 {
@@ -316,7 +347,7 @@ int vtkCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol,
                 } //if within current parametric range
               } // if intersection
             } // if (hitCellBounds)
-          } // if (!this->CellHasBeenVisited[cId])
+          } // if (!cellHasBeenVisited[cId])
         }
       }
 
@@ -424,7 +455,15 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
 
   // Clear the array that indicates whether we have visited this cell.
   // The array is only cleared when the query number rolls over.  This
-  // saves a number of calls to memset.
+  // saves a number of calls to memset. It is only used by the closest
+  // point queries, and allocated by the first one.
+  if (!this->CellHasBeenVisited)
+  {
+    this->CellHasBeenVisited =
+      new unsigned char [ this->DataSet->GetNumberOfCells() ];
+    this->ClearCellHasBeenVisited();
+    this->QueryNumber = 0;
+  }
   this->QueryNumber++;
   if (this->QueryNumber == 0)
   {
@@ -699,7 +738,15 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
 
   // Clear the array that indicates whether we have visited this cell.
   // The array is only cleared when the query number rolls over.  This
-  // saves a number of calls to memset.
+  // saves a number of calls to memset. It is only used by the closest
+  // point queries, and allocated by the first one.
+  if (!this->CellHasBeenVisited)
+  {
+    this->CellHasBeenVisited =
+      new unsigned char [ this->DataSet->GetNumberOfCells() ];
+    this->ClearCellHasBeenVisited();
+    this->QueryNumber = 0;
+  }
   this->QueryNumber++;
   if (this->QueryNumber == 0)
   {
@@ -1202,11 +1249,11 @@ void vtkCellLocator::ForceBuildLocator()
 //
 void vtkCellLocator::BuildLocatorInternal()
 {
-  double length, cellBounds[6], *boundsPtr;
+  double length, cellBounds[6];
   vtkIdType numCells;
   int ndivs, product;
-  int i, j, k, ijkMin[3], ijkMax[3];
-  vtkIdType cellId, idx;
+  int i, j, k;
+  vtkIdType idx;
   int parentOffset;
   vtkIdList *octant;
   int numCellsPerBucket = this->NumberOfCellsPerNode;
@@ -1269,9 +1316,6 @@ void vtkCellLocator::BuildLocatorInternal()
   this->Tree = new vtkIdListPtr[numOctants];
   memset (this->Tree, 0, numOctants*sizeof(vtkIdListPtr));
 
-  this->CellHasBeenVisited = new unsigned char [ numCells ];
-  this->ClearCellHasBeenVisited();
-  this->QueryNumber = 0;
 
   if (this->CacheCellBounds)
   {
@@ -1287,63 +1331,108 @@ void vtkCellLocator::BuildLocatorInternal()
   }
 
   //  Insert each cell into the appropriate octant.  Make sure cell
-  //  falls within octant.
+  //  falls within octant. The octants overlapped by each cell are found in
+  //  parallel, then the (octant, cell) fragments are sorted so that each
+  //  octant lists its cells in increasing order, whatever the number of
+  //  threads.
   //
   parentOffset = numOctants - (ndivs * ndivs * ndivs);
   product = ndivs * ndivs;
-  boundsPtr = cellBounds;
-  for (cellId=0; cellId<numCells; cellId++)
+  if ( !this->CellBounds )
   {
-    if (this->CellBounds)
-    {
-      boundsPtr = this->CellBounds[cellId];
-    }
-    else
-    {
-      this->DataSet->GetCellBounds(cellId, cellBounds);
-    }
-
-    // find min/max locations of bounding box
-    for (i=0; i<3; i++)
+    // Make sure the dataset is ready for concurrent GetCellBounds() calls.
+    this->DataSet->GetCellBounds(0, cellBounds);
+  }
+  std::vector<int> cellRanges(6 * numCells);
+  std::vector<vtkIdType> offsets(numCells + 1, 0);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    double bds[6];
+    const double *bp = bds;
+    for (vtkIdType id = begin; id < end; id++)
     {
-      ijkMin[i] = static_cast<int>(
-        (boundsPtr[2*i] - this->Bounds[2*i] - hTol[i])/ this->H[i]);
-      ijkMax[i] = static_cast<int>(
-        (boundsPtr[2*i+1] - this->Bounds[2*i] + hTol[i]) / this->H[i]);
-
-      if (ijkMin[i] < 0)
+      if (this->CellBounds)
+      {
+        bp = this->CellBounds[id];
+      }
+      else
       {
-        ijkMin[i] = 0;
+        this->DataSet->GetCellBounds(id, bds);
       }
-      if (ijkMax[i] >= ndivs)
+
+      // find min/max locations of bounding box
+      int *range = cellRanges.data() + 6 * id;
+      vtkIdType numOverlapped = 1;
+      for (int ii = 0; ii < 3; ii++)
       {
-        ijkMax[i] = ndivs-1;
+        range[2*ii] = static_cast<int>(
+          (bp[2*ii] - this->Bounds[2*ii] - hTol[ii])/ this->H[ii]);
+        range[2*ii+1] = static_cast<int>(
+          (bp[2*ii+1] - this->Bounds[2*ii] + hTol[ii]) / this->H[ii]);
+
+        if (range[2*ii] < 0)
+        {
+          range[2*ii] = 0;
+        }
+        if (range[2*ii+1] >= ndivs)
+        {
+          range[2*ii+1] = ndivs-1;
+        }
+        numOverlapped *= std::max(range[2*ii+1] - range[2*ii] + 1, 0);
       }
+      offsets[id] = numOverlapped;
     }
+  });
+  vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(), offsets.begin(),
+                             static_cast<vtkIdType>(0));
 
-    // each octant between min/max point may have cell in it
-    for ( k = ijkMin[2]; k <= ijkMax[2]; k++ )
+  // each octant between min/max point may have cell in it
+  std::vector<vtkCellLocatorFragment> fragments(offsets[numCells]);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; id++)
     {
-      for ( j = ijkMin[1]; j <= ijkMax[1]; j++ )
+      const int *range = cellRanges.data() + 6 * id;
+      vtkCellLocatorFragment *fragment = fragments.data() + offsets[id];
+      for (int kk = range[4]; kk <= range[5]; kk++)
       {
-        for ( i = ijkMin[0]; i <= ijkMax[0]; i++ )
+        for (int jj = range[2]; jj <= range[3]; jj++)
         {
-          idx = parentOffset + i + j*ndivs + k*product;
-          this->MarkParents(reinterpret_cast<void*>(VTK_CELL_INSIDE),i,j,k,
-                            ndivs,this->Level);
-          octant = this->Tree[idx];
-          if ( ! octant )
+          for (int ii = range[0]; ii <= range[1]; ii++, fragment++)
           {
-            octant = vtkIdList::New();
-            octant->Allocate(numCellsPerBucket,numCellsPerBucket/2);
-            this->Tree[idx] = octant;
+            fragment->OctantId = ii + jj*ndivs + kk*product;
+            fragment->CellId = id;
           }
-          octant->InsertNextId(cellId);
         }
       }
     }
+  });
+  std::vector<int>().swap(cellRanges);
+  std::vector<vtkIdType>().swap(offsets);
+  vtkSMPTools::Sort(fragments.begin(), fragments.end());
 
-  } //for all cells
+  vtkIdType numFragments = static_cast<vtkIdType>(fragments.size());
+  for (vtkIdType first = 0, last; first < numFragments; first = last)
+  {
+    vtkIdType leaf = fragments[first].OctantId;
+    last = first + 1;
+    while (last < numFragments && fragments[last].OctantId == leaf)
+    {
+      last++;
+    }
+    k = static_cast<int>(leaf / product);
+    j = static_cast<int>((leaf - k * product) / ndivs);
+    i = static_cast<int>(leaf - k * product - j * ndivs);
+    this->MarkParents(reinterpret_cast<void*>(VTK_CELL_INSIDE),i,j,k,
+                      ndivs,this->Level);
+    octant = vtkIdList::New();
+    octant->SetNumberOfIds(last - first);
+    for (idx = first; idx < last; idx++)
+    {
+      octant->SetId(idx - first, fragments[idx].CellId);
+    }
+    this->Tree[parentOffset + leaf] = octant;
+  }
 
   this->BuildTime.Modified();
 }
@@ -1863,15 +1952,10 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
     prod = this->NumberOfDivisions*this->NumberOfDivisions;
     leafStart = this->NumberOfOctants - this->NumberOfDivisions*prod;
 
-    // Clear the array that indicates whether we have visited this cell.
-    // The array is only cleared when the query number rolls over.  This
-    // saves a number of calls to memset.
-    this->QueryNumber++;
-    if (this->QueryNumber == 0)
-    {
-      this->ClearCellHasBeenVisited();
-      this->QueryNumber++;    // can't use 0 as a marker
-    }
+    // The array that indicates whether we have visited this cell is local
+    // to the query, so that concurrent queries do not share it.
+    std::vector<unsigned char> cellHasBeenVisited(
+      this->DataSet->GetNumberOfCells(), 0);
 
     // set up curr and stop dist
     currDist = 0;
@@ -1905,13 +1989,12 @@ void vtkCellLocator::FindCellsAlongLine(double p1[3], double p2[3], double vtkNo
     {
       if (this->Tree[idx])
       {
-        this->ComputeOctantBounds(pos[0]-1,pos[1]-1,pos[2]-1);
         for (cellId=0; cellId < this->Tree[idx]->GetNumberOfIds(); cellId++)
         {
           cId = this->Tree[idx]->GetId(cellId);
-          if (this->CellHasBeenVisited[cId] != this->QueryNumber)
+          if (!cellHasBeenVisited[cId])
           {
-            this->CellHasBeenVisited[cId] = this->QueryNumber;
+            cellHasBeenVisited[cId] = 1;
 
             // check whether we intersect the cell bounds
             if (this->CacheCellBounds)
@@ -73,7 +73,8 @@ public:
    * Return intersection point (if any) AND the cell which was intersected by
    * the finite line. The cell is returned as a cell id and as a generic
    * cell.  For other IntersectWithLine signatures, see
-   * vtkAbstractCellLocator.  Note this is currently not thread-safe.
+   * vtkAbstractCellLocator.  Once the locator is built, this may be called
+   * concurrently from several threads, each with its own cell.
    */
   int IntersectWithLine(double a0[3], double a1[3], double tol,
                         double& t, double x[3], double pcoords[3],
@@ -150,7 +151,7 @@ public:
    * of unique cell ids in the buckets containing the line. It is possible
    * that an empty cell list is returned. The user must provide the vtkIdList
    * to populate. This method returns data only after the locator has been
-   * built.
+   * built, and may then be called concurrently from several threads.
    */
   void FindCellsAlongLine(double p1[3], double p2[3],
                           double tolerance, vtkIdList *cells) override;
@@ -178,6 +179,8 @@ protected:
   void ClearCellHasBeenVisited();
   void ClearCellHasBeenVisited(int id);
 
+  bool IsQueryThreadSafe() override { return true; }
+
   double Distance2ToBucket(double x[3], int nei[3]);
   double Distance2ToBounds(double x[3], double bounds[6]);
 
@@ -196,7 +199,7 @@ protected:
                     vtkPoints *pts, vtkCellArray *polys);
 
   vtkNeighborCells *Buckets;
-  unsigned char *CellHasBeenVisited;
+  unsigned char *CellHasBeenVisited; // for the closest point queries
   unsigned char QueryNumber;
 
   void ComputeOctantBounds(int i, int j, int k);
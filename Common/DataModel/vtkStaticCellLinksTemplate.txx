@@ -20,13 +20,14 @@
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Note: this class is a faster version of vtkCellLinks. The prefix sum is
+// performed in parallel with vtkSMPTools::InclusiveScan(). Future work to
+// parallelize this class is possible, e.g. using atomics to update counts
+// (i.e., number of cells using a point).
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -91,12 +92,8 @@ BuildLinks(vtkDataSet *ds)
   // Allocate space for links. Perform prefix sum.
   this->Links = new TIds[this->LinksSize+1];
   this->Links[this->LinksSize] = this->NumPts;
-
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  vtkSMPTools::InclusiveScan(this->Offsets, this->Offsets + this->NumPts,
+                             this->Offsets);
 
   // Now build the links. The summation from the prefix sum indicates where
   // the cells are to be inserted. Each time a cell is inserted, the offset
@@ -143,7 +140,7 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   std::fill_n(this->Offsets, this->NumPts, 0);
 
   // Now create the links.
-  vtkIdType npts, cellId, ptId;
+  vtkIdType npts, cellId;
   const vtkIdType *cell=cells;
   int i;
 
@@ -158,11 +155,8 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   }
 
   // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  vtkSMPTools::InclusiveScan(this->Offsets, this->Offsets + this->NumPts,
+                             this->Offsets);
 
   // Now build the links. The summation from the prefix sum indicates where
   // the cells are to be inserted. Each time a cell is inserted, the offset
@@ -223,7 +217,7 @@ BuildLinks(vtkPolyData *pd)
   std::fill_n(this->Offsets, this->NumPts, 0);
 
   // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
+  vtkIdType npts, cellId, CellId;
   const vtkIdType *cell;
 
   // Visit the four arrays
@@ -236,18 +230,15 @@ BuildLinks(vtkPolyData *pd)
       npts = *cell++;
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[CellId+(*cell++)]++;
+        this->Offsets[*cell++]++;
       }
     }
     CellId += numCells[j];
   } //for each of the four polydata cell arrays
 
   // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  vtkSMPTools::InclusiveScan(this->Offsets, this->Offsets + this->NumPts,
+                             this->Offsets);
 
   // Now build the links. The summation from the prefix sum indicates where
   // the cells are to be inserted. Each time a cell is inserted, the offset
@@ -172,6 +172,8 @@ protected:
   vtkStaticCellLocator();
   ~vtkStaticCellLocator() override;
 
+  bool IsQueryThreadSafe() override { return true; }
+
   double Bounds[6]; // Bounding box of the whole dataset
   int Divisions[3]; // Number of sub-divisions in x-y-z directions
   double H[3]; // Width of each bin in x-y-z directions
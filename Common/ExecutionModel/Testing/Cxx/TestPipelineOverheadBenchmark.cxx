@@ -0,0 +1,280 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineOverheadBenchmark.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This test checks the pipeline where the filters do almost nothing: the
+// Update() along a deep pipeline, the per-block requests of
+// vtkCompositeDataPipeline over a wide multiblock, and the vtkInformation
+// operations they rely on. With -B, it uses larger pipelines and prints the
+// times of these operations, to benchmark the overhead of the pipeline.
+
+#include "vtkCompositeDataPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPassInputTypeAlgorithm.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
+#include "vtkTrivialProducer.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+// A filter passing its input through, whatever its type.
+class vtkTestPassFilter : public vtkPassInputTypeAlgorithm
+{
+public:
+  static vtkTestPassFilter* New();
+  vtkTypeMacro(vtkTestPassFilter, vtkPassInputTypeAlgorithm);
+
+protected:
+  vtkTestPassFilter() = default;
+
+  int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+    vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+    output->ShallowCopy(input);
+    return 1;
+  }
+
+private:
+  vtkTestPassFilter(const vtkTestPassFilter&) = delete;
+  void operator=(const vtkTestPassFilter&) = delete;
+};
+
+vtkStandardNewMacro(vtkTestPassFilter);
+
+// A filter of poly data, which vtkCompositeDataPipeline runs on each block
+// of a multiblock.
+class vtkTestPolyDataFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestPolyDataFilter* New();
+  vtkTypeMacro(vtkTestPolyDataFilter, vtkPolyDataAlgorithm);
+
+protected:
+  vtkTestPolyDataFilter() = default;
+
+  int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+    vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+    output->ShallowCopy(input);
+    return 1;
+  }
+
+private:
+  vtkTestPolyDataFilter(const vtkTestPolyDataFilter&) = delete;
+  void operator=(const vtkTestPolyDataFilter&) = delete;
+};
+
+vtkStandardNewMacro(vtkTestPolyDataFilter);
+
+vtkSmartPointer<vtkPolyData> MakePolyData()
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.0, 0.0);
+  points->InsertNextPoint(0.0, 1.0, 0.0);
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  return polyData;
+}
+
+// Update() along a chain of filters, when nothing changed and when the
+// source changed.
+bool BenchmarkDeepPipeline(int numFilters, int numUpdates, bool print)
+{
+  vtkSmartPointer<vtkPolyData> polyData = MakePolyData();
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(polyData);
+
+  std::vector<vtkSmartPointer<vtkTestPassFilter> > filters;
+  vtkAlgorithm* last = producer;
+  for (int i = 0; i < numFilters; ++i)
+  {
+    vtkSmartPointer<vtkTestPassFilter> filter =
+      vtkSmartPointer<vtkTestPassFilter>::New();
+    filter->SetInputConnection(last->GetOutputPort());
+    filters.push_back(filter);
+    last = filter;
+  }
+  last->Update();
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numUpdates; ++i)
+  {
+    last->Update();
+  }
+  timer->StopTimer();
+  double upToDate = timer->GetElapsedTime() / numUpdates;
+
+  timer->StartTimer();
+  for (int i = 0; i < numUpdates; ++i)
+  {
+    polyData->Modified();
+    last->Update();
+  }
+  timer->StopTimer();
+  double modified = timer->GetElapsedTime() / numUpdates;
+
+  if (print)
+  {
+    cout << "Deep pipeline of " << numFilters << " filters: Update() "
+         << upToDate << " s when up to date, " << modified
+         << " s when the source is modified" << endl;
+  }
+
+  vtkPolyData* output = vtkPolyData::SafeDownCast(last->GetOutputDataObject(0));
+  if (!output || output->GetNumberOfPoints() != 3)
+  {
+    cerr << "Bad output of the deep pipeline." << endl;
+    return false;
+  }
+  return true;
+}
+
+// Update() of filters of poly data over a multiblock, which
+// vtkCompositeDataPipeline runs on each of its blocks.
+bool BenchmarkWideMultiBlock(int numBlocks, int numFilters, int numUpdates,
+                             bool print)
+{
+  vtkNew<vtkMultiBlockDataSet> multiBlock;
+  multiBlock->SetNumberOfBlocks(numBlocks);
+  for (int i = 0; i < numBlocks; ++i)
+  {
+    multiBlock->SetBlock(i, MakePolyData());
+  }
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(multiBlock);
+
+  std::vector<vtkSmartPointer<vtkTestPolyDataFilter> > filters;
+  vtkAlgorithm* last = producer;
+  for (int i = 0; i < numFilters; ++i)
+  {
+    vtkSmartPointer<vtkTestPolyDataFilter> filter =
+      vtkSmartPointer<vtkTestPolyDataFilter>::New();
+    filter->SetInputConnection(last->GetOutputPort());
+    filters.push_back(filter);
+    last = filter;
+  }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numUpdates; ++i)
+  {
+    multiBlock->Modified();
+    last->Update();
+  }
+  timer->StopTimer();
+
+  if (print)
+  {
+    cout << "Multiblock of " << numBlocks << " blocks through " << numFilters
+         << " filters: Update() " << timer->GetElapsedTime() / numUpdates
+         << " s" << endl;
+  }
+
+  vtkMultiBlockDataSet* output =
+    vtkMultiBlockDataSet::SafeDownCast(last->GetOutputDataObject(0));
+  if (!output || static_cast<int>(output->GetNumberOfBlocks()) != numBlocks ||
+      !vtkPolyData::SafeDownCast(output->GetBlock(numBlocks - 1)))
+  {
+    cerr << "Bad output of the multiblock pipeline." << endl;
+    return false;
+  }
+  return true;
+}
+
+// The operations of the pipeline on informations holding a typical number
+// of keys.
+bool BenchmarkInformation(int numCopies, bool print)
+{
+  int extent[6] = { 0, 10, 0, 10, 0, 10 };
+  vtkNew<vtkInformation> info;
+  info->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+  info->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), extent, 6);
+  info->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), 0);
+  info->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 1);
+  info->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), 0);
+  info->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT_INITIALIZED(), 1);
+  info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkPolyData");
+  info->Set(vtkDataObject::DATA_EXTENT_TYPE(), VTK_PIECES_EXTENT);
+  info->Set(vtkAlgorithm::CAN_PRODUCE_SUB_EXTENT(), 1);
+
+  vtkNew<vtkInformation> copy;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkIdType sum = 0;
+  for (int i = 0; i < numCopies; ++i)
+  {
+    copy->Copy(info);
+    copy->CopyEntry(info, vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+    copy->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), i);
+    sum += copy->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) +
+      copy->Has(vtkDataObject::DATA_EXTENT_TYPE());
+  }
+  timer->StopTimer();
+
+  if (print)
+  {
+    cout << "Information of " << info->GetNumberOfKeys() << " keys: Copy(), "
+         << "CopyEntry(), Set(), Get() and Has() "
+         << timer->GetElapsedTime() / numCopies << " s" << endl;
+  }
+
+  if (copy->GetNumberOfKeys() != info->GetNumberOfKeys() ||
+      sum != numCopies + static_cast<vtkIdType>(numCopies - 1) * numCopies / 2)
+  {
+    cerr << "Bad copy of the information." << endl;
+    return false;
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestPipelineOverheadBenchmark(int argc, char* argv[])
+{
+  bool benchmark = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "-B"))
+    {
+      benchmark = true;
+    }
+  }
+
+  // the sizes of the benchmark, or small ones to only check the results
+  int scale = benchmark ? 10 : 1;
+  if (!BenchmarkDeepPipeline(50 * scale, 5 * scale, benchmark) ||
+      !BenchmarkWideMultiBlock(500 * scale, 3, scale, benchmark) ||
+      !BenchmarkInformation(100 * scale * scale * scale, benchmark))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
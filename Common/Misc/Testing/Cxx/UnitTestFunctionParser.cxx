@@ -21,6 +21,8 @@
 #include "vtkMathUtilities.h"
 #include "vtkTestErrorObserver.h"
 
+#include <cmath>
+
 #include <sstream>
 #include <vector>
 #include <string>
@@ -87,6 +89,7 @@ static int TestScalarLogic();
 static int TestVectorLogic();
 static int TestMiscFunctions();
 static int TestErrors();
+static int TestBlocks();
 
 int UnitTestFunctionParser(int,char *[])
 {
@@ -121,6 +124,7 @@ int UnitTestFunctionParser(int,char *[])
 
   status += TestMiscFunctions();
   status += TestErrors();
+  status += TestBlocks();
   if (status != 0)
   {
     return EXIT_FAILURE;
@@ -1116,3 +1120,113 @@ int TestErrors()
   }
   return status;
 }
+
+int TestBlocks()
+{
+  std::cout << "Testing EvaluateBlock" << "...";
+  int status = 0;
+
+  const char *functions[] = {
+    "s + t*2 - 3", "t/s", "-s^t", "abs(s) + ceil(t) + floor(s)",
+    "exp(s) + cos(t) + sin(s) + tan(t)", "cosh(s) + sinh(t) + tanh(s)",
+    "atan(s) + asin(t) + acos(s)", "ln(s) + log(t) + log10(s)",
+    "sqrt(s)*sign(t)", "min(s,t) + max(t,s)", "s < t", "s > t | s == t",
+    "if(s > 0 & t < 1, s, t)", "v + w", "v - w*s", "s*v", "v/s",
+    "v . w", "mag(v)*t", "norm(w)", "cross(v,w)", "-v", "iHat*s + jHat - kHat",
+    "if(s >= t, v, w)", "(v + cross(w,v)) . (iHat + kHat)", "s", "v", "3.5" };
+  const double values[] = { 0.0, -0.0, 1.0, -1.0, 0.5, -0.25, 2.0, -3.0,
+    1e-3, 7.5, std::numeric_limits<double>::quiet_NaN() };
+  const int numValues = sizeof(values) / sizeof(double);
+  const vtkIdType n = 101;
+
+  // the values of s and t, and of the components of v and w
+  std::vector<double> variables[8];
+  for (int var = 0; var < 8; ++var)
+  {
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      variables[var].push_back(values[(i*(var + 3) + i/numValues) % numValues]);
+    }
+  }
+
+  vtkSmartPointer<vtkTest::ErrorObserver> errorObserver =
+    vtkSmartPointer<vtkTest::ErrorObserver>::New();
+  vtkSmartPointer<vtkFunctionParser> parser =
+    vtkSmartPointer<vtkFunctionParser>::New();
+  parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  parser->SetReplacementValue(-5.0);
+
+  for (size_t f = 0; f < sizeof(functions) / sizeof(char *); ++f)
+  {
+    for (int replace = 0; replace < 2; ++replace)
+    {
+      parser->SetReplaceInvalidValues(replace);
+      parser->SetFunction(functions[f]);
+      parser->SetScalarVariableValue("s", 2.0);
+      parser->SetScalarVariableValue("t", 4.0);
+      parser->SetVectorVariableValue("v", 1.0, 2.0, 3.0);
+      parser->SetVectorVariableValue("w", -1.0, 0.5, 2.0);
+      int numComponents = (parser->IsVectorResult() ? 3 : 1);
+
+      // s is given by blocks, t is left to its current value
+      const double *scalarValues[2] = { variables[0].data(), nullptr };
+      const double *vectorValues[6] = { variables[2].data(),
+        variables[3].data(), variables[4].data(), variables[5].data(),
+        variables[6].data(), variables[7].data() };
+      std::vector<double> result(numComponents*n);
+      std::vector<double> work(parser->GetBlockWorkSize(n));
+      vtkIdType numInvalid = parser->EvaluateBlock(n, scalarValues,
+        vectorValues, result.data(), work.data());
+
+      vtkIdType expectedInvalid = 0;
+      for (vtkIdType i = 0; i < n; ++i)
+      {
+        parser->SetScalarVariableValue("s", variables[0][i]);
+        parser->SetVectorVariableValue("v", variables[2][i],
+          variables[3][i], variables[4][i]);
+        parser->SetVectorVariableValue("w", variables[5][i],
+          variables[6][i], variables[7][i]);
+        double expected[3];
+        if (numComponents == 1)
+        {
+          expected[0] = parser->GetScalarResult();
+        }
+        else
+        {
+          std::copy(parser->GetVectorResult(),
+                    parser->GetVectorResult() + 3, expected);
+        }
+        expectedInvalid += (expected[0] == VTK_PARSER_ERROR_RESULT);
+        for (int j = 0; j < numComponents; ++j)
+        {
+          double value = result[numComponents*i + j];
+          if (!(value == expected[j] &&
+                std::signbit(value) == std::signbit(expected[j])) &&
+              !(std::isnan(value) && std::isnan(expected[j])))
+          {
+            std::cout << "\n" << functions[f] << " expected "
+                      << expected[j] << " but got " << value << " ";
+            ++status;
+            break;
+          }
+        }
+      }
+      if (numInvalid != expectedInvalid)
+      {
+        std::cout << "\n" << functions[f] << " expected " << expectedInvalid
+                  << " invalid values but got " << numInvalid << " ";
+        ++status;
+      }
+    }
+  }
+
+  if (status == 0)
+  {
+    std::cout << "PASSED\n";
+  }
+  else
+  {
+    std::cout << "FAILED\n";
+  }
+  return status;
+}
@@ -908,6 +908,471 @@ double *vtkFunctionParser::GetVectorResult()
   return this->Stack;
 }
 
+//-----------------------------------------------------------------------------
+// Evaluate the byte code like Evaluate(), but for a block of n values: the
+// stack holds n values for each position, each operation is applied to all
+// of them, and the values for which the function is invalid are flagged
+// instead of stopping the evaluation.
+vtkIdType vtkFunctionParser::EvaluateBlock(vtkIdType n,
+                                           const double *const *scalarValues,
+                                           const double *const *vectorValues,
+                                           double *result, double *work)
+{
+  if (n <= 0)
+  {
+    return 0;
+  }
+
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
+  {
+    if (this->Parse() == 0)
+    {
+      std::fill(result, result + n, VTK_PARSER_ERROR_RESULT);
+      return n;
+    }
+  }
+
+  const bool replace = (this->ReplaceInvalidValues != 0);
+  const double replacement = this->ReplacementValue;
+  const int numScalars = this->GetNumberOfScalarVariables();
+  int numImmediatesProcessed = 0;
+  int stackPosition = -1;
+
+  // the values at each stack position, and the flags of invalid values
+  double *invalid = work + this->StackSize*n;
+  std::fill(invalid, invalid + n, 0.0);
+  auto block = [work, n](int position) { return work + position*n; };
+
+  for (int numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize;
+       numBytesProcessed++)
+  {
+    const int code = this->ByteCode[numBytesProcessed];
+    double *x = (stackPosition >= 0 ? block(stackPosition) : nullptr);
+    double *y = (stackPosition >= 1 ? block(stackPosition - 1) : nullptr);
+    vtkIdType i;
+    switch (code)
+    {
+      case VTK_PARSER_IMMEDIATE:
+        x = block(++stackPosition);
+        std::fill(x, x + n, this->Immediates[numImmediatesProcessed++]);
+        break;
+      case VTK_PARSER_UNARY_MINUS:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = -x[i];
+        }
+        break;
+      case VTK_PARSER_UNARY_PLUS:
+        break;
+      case VTK_PARSER_ADD:
+        for (i = 0; i < n; i++)
+        {
+          y[i] += x[i];
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_SUBTRACT:
+        for (i = 0; i < n; i++)
+        {
+          y[i] -= x[i];
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MULTIPLY:
+        for (i = 0; i < n; i++)
+        {
+          y[i] *= x[i];
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_DIVIDE:
+        for (i = 0; i < n; i++)
+        {
+          invalid[i] = (x[i] == 0 && !replace ? 1.0 : invalid[i]);
+          y[i] = (x[i] == 0 ? replacement : y[i]/x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_POWER:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = pow(y[i], x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_ABSOLUTE_VALUE:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = fabs(x[i]);
+        }
+        break;
+      case VTK_PARSER_EXPONENT:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = exp(x[i]);
+        }
+        break;
+      case VTK_PARSER_CEILING:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = ceil(x[i]);
+        }
+        break;
+      case VTK_PARSER_FLOOR:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = floor(x[i]);
+        }
+        break;
+      case VTK_PARSER_LOGARITHM:
+      case VTK_PARSER_LOGARITHME:
+      case VTK_PARSER_LOGARITHM10:
+        for (i = 0; i < n; i++)
+        {
+          if (x[i] <= 0)
+          {
+            x[i] = replacement;
+            invalid[i] = (replace ? invalid[i] : 1.0);
+          }
+          else
+          {
+            x[i] = (code == VTK_PARSER_LOGARITHM10 ? log10(x[i]) : log(x[i]));
+          }
+        }
+        break;
+      case VTK_PARSER_SQUARE_ROOT:
+        for (i = 0; i < n; i++)
+        {
+          invalid[i] = (x[i] < 0 && !replace ? 1.0 : invalid[i]);
+          x[i] = (x[i] < 0 ? replacement : sqrt(x[i]));
+        }
+        break;
+      case VTK_PARSER_SINE:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = sin(x[i]);
+        }
+        break;
+      case VTK_PARSER_COSINE:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = cos(x[i]);
+        }
+        break;
+      case VTK_PARSER_TANGENT:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = tan(x[i]);
+        }
+        break;
+      case VTK_PARSER_ARCSINE:
+      case VTK_PARSER_ARCCOSINE:
+        for (i = 0; i < n; i++)
+        {
+          if (x[i] < -1 || x[i] > 1)
+          {
+            x[i] = replacement;
+            invalid[i] = (replace ? invalid[i] : 1.0);
+          }
+          else
+          {
+            x[i] = (code == VTK_PARSER_ARCSINE ? asin(x[i]) : acos(x[i]));
+          }
+        }
+        break;
+      case VTK_PARSER_ARCTANGENT:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = atan(x[i]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_SINE:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = sinh(x[i]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_COSINE:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = cosh(x[i]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_TANGENT:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = tanh(x[i]);
+        }
+        break;
+      case VTK_PARSER_MIN:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (x[i] < y[i] ? x[i] : y[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MAX:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (x[i] > y[i] ? x[i] : y[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_CROSS:
+      {
+        double *ux = block(stackPosition - 5);
+        double *uy = block(stackPosition - 4);
+        double *uz = block(stackPosition - 3);
+        double *vx = block(stackPosition - 2);
+        double *vy = block(stackPosition - 1);
+        double *vz = block(stackPosition);
+        for (i = 0; i < n; i++)
+        {
+          double tx = uy[i]*vz[i] - uz[i]*vy[i];
+          double ty = uz[i]*vx[i] - ux[i]*vz[i];
+          double tz = ux[i]*vy[i] - uy[i]*vx[i];
+          ux[i] = tx;
+          uy[i] = ty;
+          uz[i] = tz;
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_SIGN:
+        for (i = 0; i < n; i++)
+        {
+          x[i] = (x[i] < 0 ? -1.0 : (x[i] == 0 ? 0.0 : 1.0));
+        }
+        break;
+      case VTK_PARSER_VECTOR_UNARY_MINUS:
+        for (i = 0; i < 3*n; i++)
+        {
+          block(stackPosition - 2)[i] =
+            -block(stackPosition - 2)[i];
+        }
+        break;
+      case VTK_PARSER_VECTOR_UNARY_PLUS:
+        break;
+      case VTK_PARSER_DOT_PRODUCT:
+      {
+        double *ux = block(stackPosition - 5);
+        double *uy = block(stackPosition - 4);
+        double *uz = block(stackPosition - 3);
+        double *vx = block(stackPosition - 2);
+        for (i = 0; i < n; i++)
+        {
+          ux[i] = ux[i]*vx[i] + uy[i]*y[i] + uz[i]*x[i];
+        }
+        stackPosition -= 5;
+        break;
+      }
+      case VTK_PARSER_VECTOR_ADD:
+      {
+        double *u = block(stackPosition - 5);
+        double *v = block(stackPosition - 2);
+        for (i = 0; i < 3*n; i++)
+        {
+          u[i] += v[i];
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_VECTOR_SUBTRACT:
+      {
+        double *u = block(stackPosition - 5);
+        double *v = block(stackPosition - 2);
+        for (i = 0; i < 3*n; i++)
+        {
+          u[i] -= v[i];
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_SCALAR_TIMES_VECTOR:
+      {
+        // the vector is moved down to the position of the scalar
+        double *s = block(stackPosition - 3);
+        for (int j = 0; j < 3; j++)
+        {
+          double *v = block(stackPosition - 2 + j);
+          for (i = 0; i < n; i++)
+          {
+            v[i] *= s[i];
+          }
+        }
+        std::copy(block(stackPosition - 2), block(stackPosition + 1), s);
+        stackPosition--;
+        break;
+      }
+      case VTK_PARSER_VECTOR_TIMES_SCALAR:
+      case VTK_PARSER_VECTOR_OVER_SCALAR:
+        for (int j = 0; j < 3; j++)
+        {
+          double *v = block(stackPosition - 3 + j);
+          if (code == VTK_PARSER_VECTOR_TIMES_SCALAR)
+          {
+            for (i = 0; i < n; i++)
+            {
+              v[i] *= x[i];
+            }
+          }
+          else
+          {
+            for (i = 0; i < n; i++)
+            {
+              v[i] /= x[i];
+            }
+          }
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_MAGNITUDE:
+      {
+        double *z = block(stackPosition - 2);
+        for (i = 0; i < n; i++)
+        {
+          z[i] = sqrt(pow(x[i], 2) + pow(y[i], 2) + pow(z[i], 2));
+        }
+        stackPosition -= 2;
+        break;
+      }
+      case VTK_PARSER_NORMALIZE:
+      {
+        double *z = block(stackPosition - 2);
+        for (i = 0; i < n; i++)
+        {
+          double magnitude = sqrt(pow(x[i], 2) + pow(y[i], 2) +
+                                  pow(z[i], 2));
+          if (magnitude != 0)
+          {
+            x[i] /= magnitude;
+            y[i] /= magnitude;
+            z[i] /= magnitude;
+          }
+        }
+        break;
+      }
+      case VTK_PARSER_IHAT:
+      case VTK_PARSER_JHAT:
+      case VTK_PARSER_KHAT:
+        for (int j = 0; j < 3; j++)
+        {
+          x = block(++stackPosition);
+          std::fill(x, x + n, (code - VTK_PARSER_IHAT == j ? 1.0 : 0.0));
+        }
+        break;
+      case VTK_PARSER_LESS_THAN:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (y[i] < x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_GREATER_THAN:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (y[i] > x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_EQUAL_TO:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (y[i] == x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_AND:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (y[i] && x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_OR:
+        for (i = 0; i < n; i++)
+        {
+          y[i] = (y[i] || x[i]);
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_IF:
+      {
+        double *valFalse = block(stackPosition - 2);
+        for (i = 0; i < n; i++)
+        {
+          valFalse[i] = (x[i] != 0.0 ? y[i] : valFalse[i]);
+        }
+        stackPosition -= 2;
+        break;
+      }
+      case VTK_PARSER_VECTOR_IF:
+        for (int j = 0; j < 3; j++)
+        {
+          double *valFalse = block(stackPosition - 6 + j);
+          double *valTrue = block(stackPosition - 3 + j);
+          for (i = 0; i < n; i++)
+          {
+            valFalse[i] = (x[i] != 0.0 ? valTrue[i] : valFalse[i]);
+          }
+        }
+        stackPosition -= 4;
+        break;
+      default:
+        if (code - VTK_PARSER_BEGIN_VARIABLES < numScalars)
+        {
+          int scalarNum = code - VTK_PARSER_BEGIN_VARIABLES;
+          x = block(++stackPosition);
+          if (scalarValues && scalarValues[scalarNum])
+          {
+            std::copy(scalarValues[scalarNum], scalarValues[scalarNum] + n, x);
+          }
+          else
+          {
+            std::fill(x, x + n, this->ScalarVariableValues[scalarNum]);
+          }
+        }
+        else
+        {
+          int vectorNum = code - VTK_PARSER_BEGIN_VARIABLES - numScalars;
+          for (int j = 0; j < 3; j++)
+          {
+            x = block(++stackPosition);
+            const double *values =
+              (vectorValues ? vectorValues[3*vectorNum + j] : nullptr);
+            if (values)
+            {
+              std::copy(values, values + n, x);
+            }
+            else
+            {
+              std::fill(x, x + n, this->VectorVariableValues[vectorNum][j]);
+            }
+          }
+        }
+    }
+  }
+
+  // the scalar or vector results, except for the invalid values
+  vtkIdType numInvalid = 0;
+  const int numComponents = stackPosition + 1;
+  for (int j = 0; j < numComponents; j++)
+  {
+    const double *values = block(j);
+    for (vtkIdType i = 0; i < n; i++)
+    {
+      result[numComponents*i + j] =
+        (invalid[i] != 0.0 ? VTK_PARSER_ERROR_RESULT : values[i]);
+    }
+  }
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    numInvalid += (invalid[i] != 0.0);
+  }
+
+  return numInvalid;
+}
+
 //-----------------------------------------------------------------------------
 const char* vtkFunctionParser::GetScalarVariableName(int i)
 {
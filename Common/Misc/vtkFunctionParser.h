@@ -309,6 +309,34 @@ public:
   vtkGetMacro(ReplacementValue,double);
   //@}
 
+  /**
+   * Evaluate the function for n values of the variables at once: each
+   * operation of the function is applied to all the values before the
+   * next one, which is much faster than setting the variables and getting
+   * the result for each value.  scalarValues[i] points to the n values of
+   * scalar variable i, and vectorValues[3*i + j] to the n values of
+   * component j of vector variable i.  A null pointer, or a null array,
+   * stands for the current value of the variables.  The n scalar results,
+   * or the n interleaved vector results, are written to result, with the
+   * same values as GetScalarResult() or GetVectorResult() for each set
+   * of values.  The results for which the function cannot be evaluated
+   * (when ReplaceInvalidValues is off) are VTK_PARSER_ERROR_RESULT, and
+   * their number is returned.  The work space must have room for
+   * GetBlockWorkSize(n) values.  This method does not modify the parser
+   * once the function has been parsed, e.g. by IsScalarResult(), and can
+   * then be called by several threads at once.
+   */
+  vtkIdType EvaluateBlock(vtkIdType n, const double *const *scalarValues,
+                          const double *const *vectorValues,
+                          double *result, double *work);
+
+  /**
+   * Get the size of the work space of EvaluateBlock() for n values.  The
+   * function must have been parsed.
+   */
+  vtkIdType GetBlockWorkSize(vtkIdType n)
+    { return (this->StackSize + 1)*n; }
+
   /**
    * Check the validity of the function expression.
    */
@@ -0,0 +1,255 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTransformPointsParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the linear and homogeneous transformations of float and
+// double arrays, which are done in parallel directly in the memory of the
+// arrays, give the results of the transformation of each tuple in turn,
+// for any number of threads.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPerspectiveTransform.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+// Random tuples in [-5, 5), after the given number of leading tuples.
+void FillArray(vtkDataArray *array, vtkIdType numLeading, vtkIdType numTuples,
+               int seed)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  array->SetNumberOfComponents(3);
+  array->SetNumberOfTuples(numLeading + numTuples);
+  for (vtkIdType i = 0; i < numLeading + numTuples; ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      random->Next();
+      array->SetComponent(i, c, 10.0 * random->GetValue() - 5.0);
+    }
+  }
+}
+
+vtkSmartPointer<vtkDataArray> MakeArray(int type, vtkIdType numLeading,
+                                        vtkIdType numTuples, int seed)
+{
+  vtkSmartPointer<vtkDataArray> array = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(type));
+  FillArray(array, numLeading, numTuples, seed);
+  return array;
+}
+
+bool CompareTuple(vtkDataArray *array, vtkIdType i, const double *expected,
+                  const char *what, double tolerance = 0.0)
+{
+  for (int c = 0; c < 3; ++c)
+  {
+    if (std::abs(array->GetComponent(i, c) - expected[c]) > tolerance)
+    {
+      std::cerr << "Bad " << what << " " << i << ": "
+                << array->GetComponent(i, c) << " instead of " << expected[c]
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The transformation of a tuple, rounded to the type of the output by
+// storing it in the single tuple of the rounding array, so that the
+// rounding is not left to the optimizations of the compiler. The normals of
+// float arrays are normalized in float, hence a tolerance for them.
+void TransformTuple(vtkLinearTransform *transform, int kind,
+                    vtkDataArray *rounding, const double in[3], double out[3])
+{
+  if (kind == 0)
+  {
+    transform->TransformPoint(in, out);
+  }
+  else if (kind == 1)
+  {
+    transform->TransformNormal(in, out);
+  }
+  else
+  {
+    transform->TransformVector(in, out);
+  }
+  rounding->SetTuple(0, out);
+  rounding->GetTuple(0, out);
+}
+
+bool TestLinear(vtkIdType numTuples, int inType, int outType)
+{
+  vtkNew<vtkTransform> transform;
+  transform->Translate(1.0, -2.0, 0.5);
+  transform->RotateWXYZ(33.0, 1.0, 2.0, -1.0);
+  transform->Scale(1.5, 0.5, 2.0);
+
+  vtkNew<vtkPoints> inPts;
+  inPts->SetData(MakeArray(inType, 0, numTuples, 1));
+  vtkSmartPointer<vtkDataArray> inNms = MakeArray(inType, 0, numTuples, 2);
+  vtkSmartPointer<vtkDataArray> inVrs = MakeArray(inType, 0, numTuples, 3);
+  vtkSmartPointer<vtkDataArray> inExtra = MakeArray(inType, 0, numTuples, 4);
+
+  // the results are appended to the tuples already in the outputs
+  const vtkIdType numLeading = 5;
+  vtkNew<vtkPoints> outPts;
+  outPts->SetData(MakeArray(outType, numLeading, 0, 5));
+  vtkSmartPointer<vtkDataArray> outNms = MakeArray(outType, numLeading, 0, 6);
+  vtkSmartPointer<vtkDataArray> outVrs = MakeArray(outType, numLeading, 0, 7);
+  vtkSmartPointer<vtkDataArray> outExtra =
+    MakeArray(outType, numLeading, 0, 8);
+  vtkDataArray *inVrsArr[1] = { inExtra };
+  vtkDataArray *outVrsArr[1] = { outExtra };
+  transform->TransformPointsNormalsVectors(inPts, outPts, inNms, outNms,
+    inVrs, outVrs, 1, inVrsArr, outVrsArr);
+
+  vtkDataArray *inArrays[4] = { inPts->GetData(), inNms, inVrs, inExtra };
+  vtkDataArray *outArrays[4] = { outPts->GetData(), outNms, outVrs, outExtra };
+  vtkSmartPointer<vtkDataArray> rounding = MakeArray(outType, 1, 0, 9);
+  const char *names[4] = { "point", "normal", "vector", "extra vector" };
+  for (int a = 0; a < 4; ++a)
+  {
+    if (outArrays[a]->GetNumberOfTuples() != numLeading + numTuples)
+    {
+      std::cerr << "Bad number of " << names[a] << "s" << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+      double in[3], expected[3];
+      inArrays[a]->GetTuple(i, in);
+      TransformTuple(transform, (a < 2 ? a : 2), rounding, in, expected);
+      double tolerance = (a == 1 && outType == VTK_FLOAT ? 1e-6 : 0.0);
+      if (!CompareTuple(outArrays[a], numLeading + i, expected, names[a],
+                        tolerance))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool TestHomogeneous(vtkIdType numTuples, int inType, int outType)
+{
+  vtkNew<vtkPerspectiveTransform> transform;
+  transform->Perspective(40.0, 1.2, 1.0, 100.0);
+  transform->Translate(0.5, 1.0, -20.0);
+  transform->RotateY(20.0);
+
+  vtkNew<vtkPoints> inPts;
+  inPts->SetData(MakeArray(inType, 0, numTuples, 1));
+  vtkSmartPointer<vtkDataArray> inNms = MakeArray(inType, 0, numTuples, 2);
+  vtkSmartPointer<vtkDataArray> inVrs = MakeArray(inType, 0, numTuples, 3);
+  vtkSmartPointer<vtkDataArray> inExtra = MakeArray(inType, 0, numTuples, 4);
+  vtkSmartPointer<vtkDataArray> inShort = MakeArray(VTK_SHORT, 0, numTuples, 5);
+
+  // The direct transformation, and the transformation of each tuple in
+  // turn, which a short array requires.
+  vtkSmartPointer<vtkDataArray> outArrays[2][5];
+  vtkNew<vtkPoints> outPts[2];
+  const vtkIdType numLeading = 3;
+  for (int r = 0; r < 2; ++r)
+  {
+    outPts[r]->SetData(MakeArray(outType, numLeading, 0, 6));
+    for (int a = 1; a < 4; ++a)
+    {
+      outArrays[r][a] = MakeArray(outType, numLeading, 0, 6 + a);
+    }
+    outArrays[r][0] = outPts[r]->GetData();
+    outArrays[r][4] = MakeArray(VTK_DOUBLE, 0, 0, 10);
+    vtkDataArray *inVrsArr[2] = { inExtra, inShort };
+    vtkDataArray *outVrsArr[2] = { outArrays[r][3], outArrays[r][4] };
+    transform->TransformPointsNormalsVectors(inPts, outPts[r], inNms,
+      outArrays[r][1], inVrs, outArrays[r][2], r + 1, inVrsArr, outVrsArr);
+  }
+
+  const char *names[4] = { "point", "normal", "vector", "extra vector" };
+  for (int a = 0; a < 4; ++a)
+  {
+    if (outArrays[0][a]->GetNumberOfTuples() != numLeading + numTuples ||
+        outArrays[1][a]->GetNumberOfTuples() != numLeading + numTuples)
+    {
+      std::cerr << "Bad number of " << names[a] << "s" << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+      double expected[3];
+      outArrays[1][a]->GetTuple(numLeading + i, expected);
+      if (!CompareTuple(outArrays[0][a], numLeading + i, expected, names[a]))
+      {
+        return false;
+      }
+    }
+  }
+
+  // The points alone.
+  vtkNew<vtkPoints> outPoints;
+  outPoints->SetDataType(outType);
+  transform->TransformPoints(inPts, outPoints);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    double expected[3];
+    outArrays[1][0]->GetTuple(numLeading + i, expected);
+    if (!CompareTuple(outPoints->GetData(), i, expected, "point"))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestTransformPointsParallel(int, char *[])
+{
+  const int types[2] = { VTK_FLOAT, VTK_DOUBLE };
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  const vtkIdType sizes[2] = { 100, 100003 };
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(numThreads[t]);
+    for (int config = 0; config < 2 * 2 * 2; ++config)
+    {
+      vtkIdType numTuples = sizes[config % 2];
+      int inType = types[(config / 2) % 2];
+      int outType = types[config / 4];
+      if (!TestLinear(numTuples, inType, outType) ||
+          !TestHomogeneous(numTuples, inType, outType))
+      {
+        std::cerr << "Bad transformation of " << numTuples << " tuples ("
+                  << inType << " to " << outType << ") with "
+                  << numThreads[t] << " thread(s)." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
@@ -17,9 +17,114 @@
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <cstring>
+#include <vector>
 
 namespace
 {
+  // The number of points below which they are transformed by the calling
+  // thread alone, since the threads would cost more than they save.
+  const vtkIdType VTK_HOMOGENEOUS_TRANSFORM_SMP_THRESHOLD = 10000;
+
+  // Run transform(begin, end) over the n tuples, in parallel if they are
+  // numerous enough.
+  template <class Functor>
+  void TransformTuples(vtkIdType n, Functor &transform)
+  {
+    if (n < VTK_HOMOGENEOUS_TRANSFORM_SMP_THRESHOLD)
+    {
+      transform(0, n);
+    }
+    else
+    {
+      vtkSMPTools::For(0, n, transform);
+    }
+  }
+
+  // Whether the tuples of the array can be read and written directly in
+  // its memory.
+  bool IsFloatOrDoubleTuples(vtkDataArray *array)
+  {
+    return (array->GetNumberOfComponents() == 3 &&
+            (array->GetDataType() == VTK_FLOAT ||
+             array->GetDataType() == VTK_DOUBLE));
+  }
+
+  // The memory of a float or double array with 3 components, read and
+  // written as double tuples by the threads.
+  class TupleArray
+  {
+  public:
+    TupleArray() : Float(nullptr), Double(nullptr) {}
+
+    // The tuples of the input array.
+    void SetInput(vtkDataArray *array)
+    {
+      this->SetPointer(array, array->GetVoidPointer(0));
+    }
+
+    // The n tuples to append to the output array.
+    void SetOutput(vtkDataArray *array, vtkIdType n)
+    {
+      vtkIdType m = array->GetNumberOfTuples();
+      this->SetPointer(array, array->WriteVoidPointer(3*m, 3*n));
+    }
+
+    void GetTuple(vtkIdType i, double tuple[3]) const
+    {
+      if (this->Float)
+      {
+        const float *value = this->Float + 3*i;
+        tuple[0] = value[0];
+        tuple[1] = value[1];
+        tuple[2] = value[2];
+      }
+      else
+      {
+        const double *value = this->Double + 3*i;
+        tuple[0] = value[0];
+        tuple[1] = value[1];
+        tuple[2] = value[2];
+      }
+    }
+
+    void SetTuple(vtkIdType i, const double tuple[3]) const
+    {
+      if (this->Float)
+      {
+        float *value = this->Float + 3*i;
+        value[0] = static_cast<float>(tuple[0]);
+        value[1] = static_cast<float>(tuple[1]);
+        value[2] = static_cast<float>(tuple[2]);
+      }
+      else
+      {
+        double *value = this->Double + 3*i;
+        value[0] = tuple[0];
+        value[1] = tuple[1];
+        value[2] = tuple[2];
+      }
+    }
+
+  private:
+    void SetPointer(vtkDataArray *array, void *ptr)
+    {
+      if (array->GetDataType() == VTK_FLOAT)
+      {
+        this->Float = static_cast<float *>(ptr);
+      }
+      else
+      {
+        this->Double = static_cast<double *>(ptr);
+      }
+    }
+
+    float *Float;
+    double *Double;
+  };
+
   void TransformVector(double M [4][4], double* outPnt, double f, double* inVec, double* outVec)
   {
     // do the linear homogeneous transformation
@@ -126,17 +231,70 @@ void vtkHomogeneousTransform::InternalTransformDerivative(const double in[3],
   vtkHomogeneousTransformDerivative(this->Matrix->Element,in,out,derivative);
 }
 
+//------------------------------------------------------------------------
+// Transform the n points, in parallel if they are numerous enough. Each
+// thread works on its own copy of the matrix, which the compiler can then
+// keep in registers.
+template <class T2, class T3>
+void vtkHomogeneousTransformPoints(double M[4][4], T2 *in, T3 *out,
+                                   vtkIdType n)
+{
+  auto transform = [&](vtkIdType begin, vtkIdType end)
+  {
+    double matrix[4][4];
+    memcpy(*matrix, *M, 16*sizeof(double));
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      vtkHomogeneousTransformPoint(matrix, in + 3*i, out + 3*i);
+    }
+  };
+  TransformTuples(n, transform);
+}
+
 //----------------------------------------------------------------------------
 void vtkHomogeneousTransform::TransformPoints(vtkPoints *inPts,
                                               vtkPoints *outPts)
 {
   vtkIdType n = inPts->GetNumberOfPoints();
+  vtkIdType m = outPts->GetNumberOfPoints();
   double (*M)[4] = this->Matrix->Element;
-  double point[3];
 
   this->Update();
 
-  for (int i = 0; i < n; i++)
+  // operate directly on the memory to avoid GetPoint()/InsertNextPoint()
+  // calls.
+  int inType = inPts->GetDataType();
+  int outType = outPts->GetDataType();
+  if ((inType == VTK_FLOAT || inType == VTK_DOUBLE) &&
+      (outType == VTK_FLOAT || outType == VTK_DOUBLE))
+  {
+    void *outPtr = outPts->GetData()->WriteVoidPointer(3*m, 3*n);
+    void *inPtr = inPts->GetData()->GetVoidPointer(0);
+    if (inType == VTK_FLOAT && outType == VTK_FLOAT)
+    {
+      vtkHomogeneousTransformPoints(M,
+        static_cast<float *>(inPtr), static_cast<float *>(outPtr), n);
+    }
+    else if (inType == VTK_FLOAT && outType == VTK_DOUBLE)
+    {
+      vtkHomogeneousTransformPoints(M,
+        static_cast<float *>(inPtr), static_cast<double *>(outPtr), n);
+    }
+    else if (inType == VTK_DOUBLE && outType == VTK_FLOAT)
+    {
+      vtkHomogeneousTransformPoints(M,
+        static_cast<double *>(inPtr), static_cast<float *>(outPtr), n);
+    }
+    else
+    {
+      vtkHomogeneousTransformPoints(M,
+        static_cast<double *>(inPtr), static_cast<double *>(outPtr), n);
+    }
+    return;
+  }
+
+  double point[3];
+  for (vtkIdType i = 0; i < n; i++)
   {
     inPts->GetPoint(i,point);
 
@@ -178,7 +336,110 @@ void vtkHomogeneousTransform::TransformPointsNormalsVectors(vtkPoints *inPts,
     vtkMatrix4x4::Transpose(*L,*L);
   }
 
-  for (int i = 0; i < n; i++)
+  // When all the arrays are float or double arrays, operate directly on
+  // their memory, in parallel.
+  bool direct = (IsFloatOrDoubleTuples(inPts->GetData()) &&
+                 IsFloatOrDoubleTuples(outPts->GetData()) &&
+                 (!inNms || (IsFloatOrDoubleTuples(inNms) &&
+                             IsFloatOrDoubleTuples(outNms))) &&
+                 (!inVrs || (IsFloatOrDoubleTuples(inVrs) &&
+                             IsFloatOrDoubleTuples(outVrs))));
+  for (int iArr = 0; inVrsArr && iArr < nOptionalVectors; iArr++)
+  {
+    direct = (direct && IsFloatOrDoubleTuples(inVrsArr[iArr]) &&
+              IsFloatOrDoubleTuples(outVrsArr[iArr]));
+  }
+  if (direct)
+  {
+    // the outputs are resized before the inputs are accessed, in case
+    // they are the same arrays
+    TupleArray outPoints, outNormals, outVectors;
+    TupleArray inPoints, inNormals, inVectors;
+    std::vector<TupleArray> outVectorsArr, inVectorsArr;
+    outPoints.SetOutput(outPts->GetData(), n);
+    if (inNms)
+    {
+      outNormals.SetOutput(outNms, n);
+    }
+    if (inVrs)
+    {
+      outVectors.SetOutput(outVrs, n);
+    }
+    if (inVrsArr)
+    {
+      outVectorsArr.resize(nOptionalVectors);
+      inVectorsArr.resize(nOptionalVectors);
+      for (int iArr = 0; iArr < nOptionalVectors; iArr++)
+      {
+        outVectorsArr[iArr].SetOutput(outVrsArr[iArr], n);
+      }
+      for (int iArr = 0; iArr < nOptionalVectors; iArr++)
+      {
+        inVectorsArr[iArr].SetInput(inVrsArr[iArr]);
+      }
+    }
+    inPoints.SetInput(inPts->GetData());
+    if (inNms)
+    {
+      inNormals.SetInput(inNms);
+    }
+    if (inVrs)
+    {
+      inVectors.SetInput(inVrs);
+    }
+
+    auto transform = [&](vtkIdType begin, vtkIdType end)
+    {
+      double matrix[4][4];
+      memcpy(*matrix, *M, 16*sizeof(double));
+      double inPoint[3], outPoint[3], inTuple[3], outTuple[3];
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        inPoints.GetTuple(i, inPoint);
+        double f = vtkHomogeneousTransformPoint(matrix, inPoint, outPoint);
+        outPoints.SetTuple(i, outPoint);
+
+        if (inVrs)
+        {
+          inVectors.GetTuple(i, inTuple);
+          TransformVector(matrix, outPoint, f, inTuple, outTuple);
+          outVectors.SetTuple(i, outTuple);
+        }
+
+        for (size_t iArr = 0; iArr < inVectorsArr.size(); iArr++)
+        {
+          inVectorsArr[iArr].GetTuple(i, inTuple);
+          TransformVector(matrix, outPoint, f, inTuple, outTuple);
+          outVectorsArr[iArr].SetTuple(i, outTuple);
+        }
+
+        if (inNms)
+        {
+          inNormals.GetTuple(i, inTuple);
+
+          // calculate the w component of the normal
+          double wn = -(inTuple[0]*inPoint[0] + inTuple[1]*inPoint[1] +
+                        inTuple[2]*inPoint[2]);
+
+          // perform the transformation in homogeneous coordinates
+          outTuple[0] = L[0][0]*inTuple[0] + L[0][1]*inTuple[1] +
+            L[0][2]*inTuple[2] + L[0][3]*wn;
+          outTuple[1] = L[1][0]*inTuple[0] + L[1][1]*inTuple[1] +
+            L[1][2]*inTuple[2] + L[1][3]*wn;
+          outTuple[2] = L[2][0]*inTuple[0] + L[2][1]*inTuple[1] +
+            L[2][2]*inTuple[2] + L[2][3]*wn;
+
+          // re-normalize
+          vtkMath::Normalize(outTuple);
+          outNormals.SetTuple(i, outTuple);
+        }
+      }
+    };
+    TransformTuples(n, transform);
+    return;
+  }
+
+  for (vtkIdType i = 0; i < n; i++)
   {
     inPts->GetPoint(i,inPnt);
 
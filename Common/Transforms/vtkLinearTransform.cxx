@@ -18,7 +18,16 @@
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 
+#include <cstring>
+
+namespace
+{
+// The number of tuples below which the arrays are transformed by the
+// calling thread alone, since the threads would cost more than they save.
+const vtkIdType VTK_LINEAR_TRANSFORM_SMP_THRESHOLD = 10000;
+}
 
 //------------------------------------------------------------------------
 void vtkLinearTransform::PrintSelf(ostream& os, vtkIndent indent)
@@ -92,17 +101,49 @@ inline void vtkLinearTransformNormal(T1 mat[4][4],
   vtkMath::Normalize(out);
 }
 
+//------------------------------------------------------------------------
+// Apply the operation op(matrix, in, out) to the n tuples of 3 components,
+// in parallel for large arrays. Each thread works on its own copy of the
+// matrix: the compiler then knows that the output cannot overwrite it, so
+// it keeps the matrix in registers and can vectorize the loop.
+template <class T1, class T2, class T3, class Op>
+inline void vtkLinearTransformTuples(
+  T1 matrix[4][4], T2 *in, T3 *out, vtkIdType n, Op op)
+{
+  auto transform = [&](vtkIdType begin, vtkIdType end)
+  {
+    T1 localMatrix[4][4];
+    memcpy(*localMatrix, *matrix, 16*sizeof(T1));
+    T2 *inTuple = in + 3*begin;
+    T3 *outTuple = out + 3*begin;
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      op(localMatrix, inTuple, outTuple);
+      inTuple += 3;
+      outTuple += 3;
+    }
+  };
+
+  if (n < VTK_LINEAR_TRANSFORM_SMP_THRESHOLD)
+  {
+    transform(0, n);
+  }
+  else
+  {
+    vtkSMPTools::For(0, n, transform);
+  }
+}
+
 //------------------------------------------------------------------------
 template <class T1, class T2, class T3>
 inline void vtkLinearTransformPoints(
   T1 matrix[4][4], T2 *in, T3 *out, vtkIdType n)
 {
-  for (vtkIdType i = 0; i < n; i++)
-  {
-    vtkLinearTransformPoint(matrix, in, out);
-    in += 3;
-    out += 3;
-  }
+  vtkLinearTransformTuples(matrix, in, out, n,
+    [](T1 m[4][4], T2 *inPoint, T3 *outPoint)
+    {
+      vtkLinearTransformPoint(m, inPoint, outPoint);
+    });
 }
 
 //------------------------------------------------------------------------
@@ -110,12 +151,11 @@ template <class T1, class T2, class T3>
 inline void vtkLinearTransformVectors(
   T1 matrix[4][4], T2 *in, T3 *out, vtkIdType n)
 {
-  for (vtkIdType i = 0; i < n; i++)
-  {
-    vtkLinearTransformVector(matrix, in, out);
-    in += 3;
-    out += 3;
-  }
+  vtkLinearTransformTuples(matrix, in, out, n,
+    [](T1 m[4][4], T2 *inVector, T3 *outVector)
+    {
+      vtkLinearTransformVector(m, inVector, outVector);
+    });
 }
 
 //------------------------------------------------------------------------
@@ -123,14 +163,13 @@ template <class T1, class T2, class T3>
 inline void vtkLinearTransformNormals(
   T1 matrix[4][4], T2 *in, T3 *out, vtkIdType n)
 {
-  for (vtkIdType i = 0; i < n; i++)
-  {
-    // matrix has been transposed & inverted, so use TransformVector
-    vtkLinearTransformVector(matrix, in, out);
-    vtkMath::Normalize(out);
-    in += 3;
-    out += 3;
-  }
+  vtkLinearTransformTuples(matrix, in, out, n,
+    [](T1 m[4][4], T2 *inNormal, T3 *outNormal)
+    {
+      // matrix has been transposed & inverted, so use TransformVector
+      vtkLinearTransformVector(m, inNormal, outNormal);
+      vtkMath::Normalize(outNormal);
+    });
 }
 
 //------------------------------------------------------------------------
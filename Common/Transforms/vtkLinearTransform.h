@@ -18,6 +18,10 @@
  *
  * vtkLinearTransform provides a generic interface for linear
  * (affine or 12 degree-of-freedom) geometric transformations.
+ *
+ * The points, normals and vectors stored in float or double arrays are
+ * transformed directly in the memory of the arrays, in parallel with
+ * vtkSMPTools for large arrays. The other types go through double tuples.
  * @sa
  * vtkTransform vtkIdentityTransform
 */
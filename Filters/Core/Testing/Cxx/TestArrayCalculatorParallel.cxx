@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestArrayCalculatorParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkArrayCalculator, which evaluates its function by blocks
+// of tuples in parallel, gives the values of the evaluation of the function
+// for each tuple in turn, for scalar and vector results of several types,
+// array and coordinate variables, and any number of threads.
+
+#include "vtkArrayCalculator.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkFunctionParser.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestErrorObserver.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Random values in [-range/2, range/2), with a few zeros.
+void FillArray(vtkDataArray *array, vtkIdType numTuples, int numComps,
+               double range, int seed)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  array->SetNumberOfComponents(numComps);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    for (int c = 0; c < numComps; ++c)
+    {
+      random->Next();
+      double value = (random->GetValue() - 0.5) * range;
+      array->SetComponent(i, c, (i % 17 == 5 ? 0.0 : value));
+    }
+  }
+}
+
+vtkSmartPointer<vtkPolyData> MakePolyData(vtkIdType numPoints)
+{
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  FillArray(points->GetData(), numPoints, 3, 10.0, 1);
+  polyData->SetPoints(points);
+
+  vtkNew<vtkFloatArray> a;
+  a->SetName("a");
+  FillArray(a, numPoints, 1, 4.0, 2);
+  a->SetComponent(0, 0, 1.5); // the first tuple must be valid
+  vtkNew<vtkIntArray> b;
+  b->SetName("b");
+  FillArray(b, numPoints, 2, 20.0, 3);
+  b->SetComponent(0, 1, 3.0);
+  vtkNew<vtkDoubleArray> v;
+  v->SetName("v");
+  FillArray(v, numPoints, 3, 2.0, 4);
+  vtkNew<vtkShortArray> u;
+  u->SetName("u");
+  FillArray(u, numPoints, 4, 100.0, 5);
+  polyData->GetPointData()->AddArray(a);
+  polyData->GetPointData()->AddArray(b);
+  polyData->GetPointData()->AddArray(v);
+  polyData->GetPointData()->AddArray(u);
+  return polyData;
+}
+
+// The calculator, and the parser for the evaluation of each tuple.
+void SetVariables(vtkArrayCalculator *calculator, const char *function)
+{
+  calculator->SetFunction(function);
+  calculator->AddScalarVariable("s", "a");
+  calculator->AddScalarVariable("t", "b", 1);
+  calculator->AddVectorArrayName("v");
+  calculator->AddVectorVariable("w", "u", 3, 0, 2);
+  calculator->AddCoordinateScalarVariable("y", 1);
+  calculator->AddCoordinateVectorVariable("p", 2, 0, 1);
+}
+
+void SetVariables(vtkFunctionParser *parser, vtkDataSet *input, vtkIdType i)
+{
+  vtkPointData *pd = input->GetPointData();
+  double x[3];
+  input->GetPoint(i, x);
+  parser->SetScalarVariableValue("s", pd->GetArray("a")->GetComponent(i, 0));
+  parser->SetScalarVariableValue("t", pd->GetArray("b")->GetComponent(i, 1));
+  vtkDataArray *v = pd->GetArray("v");
+  parser->SetVectorVariableValue("v", v->GetComponent(i, 0),
+    v->GetComponent(i, 1), v->GetComponent(i, 2));
+  vtkDataArray *u = pd->GetArray("u");
+  parser->SetVectorVariableValue("w", u->GetComponent(i, 3),
+    u->GetComponent(i, 0), u->GetComponent(i, 2));
+  parser->SetScalarVariableValue("y", x[1]);
+  parser->SetVectorVariableValue("p", x[2], x[0], x[1]);
+}
+
+bool CheckResult(vtkDataSet *input, const char *function, bool replace,
+                 int resultType, vtkDataArray *result)
+{
+  vtkNew<vtkFunctionParser> parser;
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  parser->SetFunction(function);
+  parser->SetReplaceInvalidValues(replace);
+  parser->SetReplacementValue(-2.0);
+  vtkSmartPointer<vtkDataArray> expected = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(resultType));
+  expected->SetNumberOfComponents(result->GetNumberOfComponents());
+  expected->SetNumberOfTuples(1);
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    SetVariables(parser, input, i);
+    if (result->GetNumberOfComponents() == 1)
+    {
+      double value = parser->GetScalarResult();
+      expected->SetTuple(0, &value);
+    }
+    else
+    {
+      expected->SetTuple(0, parser->GetVectorResult());
+    }
+    for (int c = 0; c < result->GetNumberOfComponents(); ++c)
+    {
+      double a = expected->GetComponent(0, c);
+      double b = result->GetComponent(i, c);
+      if (a != b && !(std::isnan(a) && std::isnan(b)))
+      {
+        cerr << "Bad result of " << function << " at tuple " << i
+             << ": " << b << " instead of " << a << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestArrayCalculatorParallel(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> polyData = MakePolyData(10007);
+
+  const char *functions[] = {
+    "s*t + y - sin(p . iHat)", "t/s", "sqrt(s) + ln(t)", "max(s, t)^2",
+    "v*s + p", "cross(w, v) + iHat*y", "if(s > t, v, w)", "norm(w - p)" };
+  const int resultTypes[3] = { VTK_DOUBLE, VTK_FLOAT, VTK_INT };
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (size_t f = 0; f < sizeof(functions) / sizeof(char *); ++f)
+  {
+    for (int config = 0; config < 3 * 2; ++config)
+    {
+      int resultType = resultTypes[config % 3];
+      bool replace = (config / 3 == 1);
+      for (int t = 0; t < 4; ++t)
+      {
+        vtkSMPTools::Initialize(numThreads[t]);
+        vtkNew<vtkArrayCalculator> calculator;
+        vtkNew<vtkTest::ErrorObserver> errorObserver;
+        calculator->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+        calculator->SetInputData(polyData);
+        SetVariables(calculator, functions[f]);
+        calculator->SetResultArrayType(resultType);
+        calculator->SetReplaceInvalidValues(replace);
+        calculator->SetReplacementValue(-2.0);
+        calculator->Update();
+        vtkDataArray *result = calculator->GetPolyDataOutput()->
+          GetPointData()->GetArray("resultArray");
+        if (!result || result->GetDataType() != resultType ||
+            !CheckResult(polyData, functions[f], replace, resultType, result))
+        {
+          cerr << "Bad result with " << numThreads[t] << " thread(s)." << endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // The coordinates of an image, and the results as new points.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(31, 17, 11);
+  image->SetOrigin(-1.0, 2.0, 0.5);
+  image->SetSpacing(0.25, 0.5, 0.125);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+  vtkSmartPointer<vtkPolyData> imagePoints = MakePolyData(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    imagePoints->GetPoints()->SetPoint(i, image->GetPoint(i));
+  }
+  image->GetPointData()->ShallowCopy(imagePoints->GetPointData());
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(numThreads[t]);
+    vtkNew<vtkArrayCalculator> calculator;
+    calculator->SetInputData(image);
+    SetVariables(calculator, "v*y + p");
+    calculator->Update();
+    vtkDataArray *result = calculator->GetImageDataOutput()->
+      GetPointData()->GetArray("resultArray");
+    if (!result ||
+        !CheckResult(imagePoints, "v*y + p", false, VTK_DOUBLE, result))
+    {
+      cerr << "Bad result for an image with " << numThreads[t]
+           << " thread(s)." << endl;
+      return EXIT_FAILURE;
+    }
+
+    vtkNew<vtkArrayCalculator> coordinates;
+    coordinates->SetInputData(polyData);
+    SetVariables(coordinates, "w*s - p");
+    coordinates->SetCoordinateResults(true);
+    coordinates->Update();
+    vtkPointSet *output = vtkPointSet::SafeDownCast(coordinates->GetOutput());
+    if (!CheckResult(polyData, "w*s - p", false, VTK_FLOAT,
+                     output->GetPoints()->GetData()))
+    {
+      cerr << "Bad coordinate results with " << numThreads[t]
+           << " thread(s)." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The invalid values are reported once.
+  vtkNew<vtkArrayCalculator> calculator;
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  calculator->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  calculator->SetInputData(polyData);
+  SetVariables(calculator, "t/s");
+  calculator->Update();
+  if (errorObserver->CheckErrorMessage("The function cannot be evaluated"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkCellDataToPointData and vtkPointDataToCellData, which
+// process all the arrays in parallel, give the averages (or the most
+// frequent values for categorical data) of a direct computation, for
+// images, unstructured grids and polydata with cells of all dimensions,
+// for all the contributing cell options, and any number of threads. The
+// arrays that are not data arrays with the standard memory layout take the
+// serial path, which must give the same values.
+
+#include "vtkCell.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+
+// Random arrays of several types, with labels from 0 to 4 in "labels".
+void AddArrays(vtkDataSetAttributes *attr, vtkIdType n, int seed)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  vtkNew<vtkDoubleArray> d;
+  d->SetName("d");
+  d->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> f;
+  f->SetName("f");
+  vtkNew<vtkShortArray> s;
+  s->SetName("s");
+  s->SetNumberOfComponents(2);
+  vtkNew<vtkUnsignedCharArray> u;
+  u->SetName("u");
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  vtkDataArray *arrays[5] = { d, f, s, u, labels };
+  const double ranges[5] = { 10.0, 2.0, 2000.0, 255.0, 4.999 };
+  for (int a = 0; a < 5; ++a)
+  {
+    arrays[a]->SetNumberOfTuples(n);
+    for (vtkIdType i = 0; i < n; ++i)
+    {
+      for (int c = 0; c < arrays[a]->GetNumberOfComponents(); ++c)
+      {
+        random->Next();
+        double value = random->GetValue() * ranges[a];
+        if (a == 0 || a == 2)
+        {
+          value -= 0.5 * ranges[a];
+        }
+        arrays[a]->SetComponent(i, c, std::floor(value * 16.0) / 16.0);
+      }
+    }
+    attr->AddArray(arrays[a]);
+  }
+  attr->SetScalars(labels);
+}
+
+vtkSmartPointer<vtkImageData> MakeImage()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(13, 11, 9);
+  AddArrays(image->GetCellData(), image->GetNumberOfCells(), 1);
+  AddArrays(image->GetPointData(), image->GetNumberOfPoints(), 2);
+  return image;
+}
+
+// Hexahedra, quads, lines and vertices sharing points, and unused points.
+vtkSmartPointer<vtkUnstructuredGrid> MakeUnstructuredGrid()
+{
+  const int n = 8;
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->Allocate(n * n * n);
+  for (int k = 0; k < n - 1; ++k)
+  {
+    for (int j = 0; j < n - 1; ++j)
+    {
+      for (int i = 0; i < n - 1; ++i)
+      {
+        vtkIdType p = i + n * (j + n * k);
+        vtkIdType corners[8] = { p, p + 1, p + n + 1, p + n,
+          p + n * n, p + n * n + 1, p + n * n + n + 1, p + n * n + n };
+        if (i < 4 && j < 5)
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, corners);
+        }
+        else if (k == 2)
+        {
+          grid->InsertNextCell(VTK_QUAD, 4, corners);
+        }
+        else if (k == 4 && i % 2 == 0)
+        {
+          grid->InsertNextCell(VTK_LINE, 2, corners);
+        }
+        else if (k == 5 && j % 3 == 0)
+        {
+          grid->InsertNextCell(VTK_VERTEX, 1, corners);
+        }
+      }
+    }
+  }
+  AddArrays(grid->GetCellData(), grid->GetNumberOfCells(), 3);
+  AddArrays(grid->GetPointData(), grid->GetNumberOfPoints(), 4);
+  return grid;
+}
+
+// Triangles, lines and vertices.
+vtkSmartPointer<vtkPolyData> MakePolyData()
+{
+  const int n = 20;
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.1 * i * j);
+    }
+  }
+  polyData->SetPoints(points);
+  polyData->Allocate(4 * n * n);
+  for (int j = 0; j < n - 1; ++j)
+  {
+    for (int i = 0; i < n - 1; ++i)
+    {
+      vtkIdType p = i + n * j;
+      vtkIdType tri1[3] = { p, p + 1, p + n + 1 };
+      vtkIdType tri2[3] = { p, p + n + 1, p + n };
+      if (j < 12)
+      {
+        polyData->InsertNextCell(VTK_TRIANGLE, 3, tri1);
+        polyData->InsertNextCell(VTK_TRIANGLE, 3, tri2);
+      }
+      if (i % 3 == 0)
+      {
+        polyData->InsertNextCell(VTK_LINE, 2, tri1);
+      }
+      if (j % 4 == 1)
+      {
+        polyData->InsertNextCell(VTK_VERTEX, 1, tri1 + 2);
+      }
+    }
+  }
+  AddArrays(polyData->GetCellData(), polyData->GetNumberOfCells(), 5);
+  AddArrays(polyData->GetPointData(), polyData->GetNumberOfPoints(), 6);
+  return polyData;
+}
+
+bool IsIntegral(vtkDataArray *array)
+{
+  return (array->GetDataType() != VTK_FLOAT &&
+          array->GetDataType() != VTK_DOUBLE);
+}
+
+// The average of the values, or their most frequent value with ties going
+// to the smaller value.
+double Reduce(const std::vector<double> &values, bool vote)
+{
+  if (!vote)
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      sum += values[i];
+    }
+    return sum / values.size();
+  }
+  std::map<double, int> counts;
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    counts[values[i]]++;
+  }
+  std::map<double, int>::iterator best = counts.begin();
+  for (std::map<double, int>::iterator it = counts.begin();
+       it != counts.end(); ++it)
+  {
+    if (it->second > best->second)
+    {
+      best = it;
+    }
+  }
+  return best->first;
+}
+
+bool CheckValue(vtkDataArray *array, vtkIdType i, int c, double expected)
+{
+  double value = array->GetComponent(i, c);
+  double tolerance = (IsIntegral(array) ? 0.5 : 1e-5 * (1.0 + fabs(expected)));
+  if (fabs(value - expected) > tolerance)
+  {
+    cerr << "Bad value of " << array->GetName() << " at " << i << ": "
+         << value << " instead of " << expected << endl;
+    return false;
+  }
+  return true;
+}
+
+// Compare the point data with the values of the contributing cells.
+bool CheckPointData(vtkDataSet *input, vtkDataSet *output, int option,
+                    bool categorical)
+{
+  vtkCellData *inCD = input->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+  int highestDimension = 0;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    highestDimension = std::max(highestDimension,
+                                input->GetCell(cellId)->GetCellDimension());
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  std::vector<vtkIdType> contributing;
+  std::vector<double> values;
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    input->GetPointCells(ptId, cellIds);
+    int minDimension = 0;
+    if (option == vtkCellDataToPointData::DataSetMax)
+    {
+      minDimension = highestDimension;
+    }
+    else if (option == vtkCellDataToPointData::Patch)
+    {
+      for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+      {
+        minDimension = std::max(minDimension,
+          input->GetCell(cellIds->GetId(i))->GetCellDimension());
+      }
+    }
+    contributing.clear();
+    for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+    {
+      if (input->GetCell(cellIds->GetId(i))->GetCellDimension() >=
+          minDimension)
+      {
+        contributing.push_back(cellIds->GetId(i));
+      }
+    }
+
+    for (int a = 0; a < inCD->GetNumberOfArrays(); ++a)
+    {
+      vtkDataArray *inArray = inCD->GetArray(a);
+      if (!inArray)
+      {
+        continue;
+      }
+      vtkDataArray *outArray = outPD->GetArray(inArray->GetName());
+      if (!outArray || outArray->GetNumberOfTuples() != input->GetNumberOfPoints())
+      {
+        cerr << "No point data for " << inArray->GetName() << endl;
+        return false;
+      }
+      bool vote = (categorical && IsIntegral(inArray));
+      for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+      {
+        values.clear();
+        for (size_t i = 0; i < contributing.size(); ++i)
+        {
+          values.push_back(inArray->GetComponent(contributing[i], c));
+        }
+        double expected = (values.empty() ? 0.0 : Reduce(values, vote));
+        if (!CheckValue(outArray, ptId, c, expected))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Compare the cell data with the averages of the point data, or with the
+// values of a point of a most frequent scalar value.
+bool CheckCellData(vtkDataSet *input, vtkDataSet *output, bool categorical)
+{
+  vtkPointData *inPD = input->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+  vtkNew<vtkIdList> ptIds;
+  std::vector<double> values;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, ptIds);
+    vtkDataArray *scalars = inPD->GetScalars();
+    std::map<double, int> counts;
+    int maxCount = 0;
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds() && categorical; ++i)
+    {
+      int count = ++counts[scalars->GetComponent(ptIds->GetId(i), 0)];
+      maxCount = std::max(maxCount, count);
+    }
+    for (int a = 0; a < inPD->GetNumberOfArrays(); ++a)
+    {
+      vtkDataArray *inArray = inPD->GetArray(a);
+      vtkDataArray *outArray = outCD->GetArray(inArray->GetName());
+      if (!outArray || outArray->GetNumberOfTuples() != input->GetNumberOfCells())
+      {
+        cerr << "No cell data for " << inArray->GetName() << endl;
+        return false;
+      }
+      if (categorical)
+      {
+        // the tuple of one of the points with a most frequent label
+        bool found = false;
+        for (vtkIdType i = 0; i < ptIds->GetNumberOfIds() && !found; ++i)
+        {
+          vtkIdType ptId = ptIds->GetId(i);
+          found = (counts[scalars->GetComponent(ptId, 0)] == maxCount);
+          for (int c = 0; c < inArray->GetNumberOfComponents() && found; ++c)
+          {
+            found = (inArray->GetComponent(ptId, c) ==
+                     outArray->GetComponent(cellId, c));
+          }
+        }
+        if (!found)
+        {
+          cerr << "Bad categorical value of " << inArray->GetName()
+               << " at " << cellId << endl;
+          return false;
+        }
+        continue;
+      }
+      for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+      {
+        values.clear();
+        for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+        {
+          values.push_back(inArray->GetComponent(ptIds->GetId(i), c));
+        }
+        if (!CheckValue(outArray, cellId, c, Reduce(values, false)))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestCellDataToPointDataParallel(int, char *[])
+{
+  vtkSmartPointer<vtkDataSet> inputs[3] = {
+    MakeImage(), MakeUnstructuredGrid(), MakePolyData() };
+
+  // An array that is not a data array takes the serial path for images.
+  vtkSmartPointer<vtkImageData> stringImage = vtkSmartPointer<vtkImageData>::New();
+  stringImage->DeepCopy(inputs[0]);
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("strings");
+  strings->SetNumberOfValues(stringImage->GetNumberOfCells());
+  stringImage->GetCellData()->AddArray(strings);
+
+  // Arrays without the standard memory layout take the serial path for
+  // unstructured grids.
+  vtkSmartPointer<vtkUnstructuredGrid> soaGrid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  soaGrid->DeepCopy(inputs[1]);
+  vtkDataSetAttributes *soaAttrs[2] = { soaGrid->GetCellData(),
+                                        soaGrid->GetPointData() };
+  for (int a = 0; a < 2; ++a)
+  {
+    vtkDataArray *labels = soaAttrs[a]->GetArray("labels");
+    vtkDataArray *d = soaAttrs[a]->GetArray("d");
+    vtkNew<vtkSOADataArrayTemplate<int> > soaLabels;
+    soaLabels->SetName("soaLabels");
+    soaLabels->DeepCopy(labels);
+    vtkNew<vtkSOADataArrayTemplate<double> > soaD;
+    soaD->SetName("soaD");
+    soaD->DeepCopy(d);
+    soaAttrs[a]->AddArray(soaLabels);
+    soaAttrs[a]->AddArray(soaD);
+  }
+
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(numThreads[t]);
+    for (int i = 0; i < 5; ++i)
+    {
+      vtkDataSet *input = (i < 3 ? inputs[i].GetPointer() :
+                           i == 3 ? static_cast<vtkDataSet*>(stringImage) :
+                           static_cast<vtkDataSet*>(soaGrid));
+      for (int config = 0; config < 3 * 2; ++config)
+      {
+        int option = config % 3;
+        bool categorical = (config / 3 == 1);
+        vtkNew<vtkCellDataToPointData> toPoints;
+        toPoints->SetInputData(input);
+        toPoints->SetContributingCellOption(option);
+        toPoints->SetCategoricalData(categorical);
+        toPoints->Update();
+        if (!CheckPointData(input, toPoints->GetOutput(), option, categorical))
+        {
+          cerr << "Bad point data for input " << i << " with option " << option
+               << (categorical ? " (categorical)" : "") << " and "
+               << numThreads[t] << " thread(s)." << endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      for (int categorical = 0; categorical < 2; ++categorical)
+      {
+        vtkNew<vtkPointDataToCellData> toCells;
+        toCells->SetInputData(input);
+        toCells->SetCategoricalData(categorical);
+        toCells->Update();
+        if (!CheckCellData(input, toCells->GetOutput(), categorical != 0))
+        {
+          cerr << "Bad cell data for input " << i
+               << (categorical ? " (categorical)" : "") << " with "
+               << numThreads[t] << " thread(s)." << endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
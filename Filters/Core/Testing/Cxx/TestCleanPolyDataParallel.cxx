@@ -0,0 +1,269 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the parallel mode of vtkCleanPolyData gives the same output
+// as the serial mode, whatever the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <string>
+
+namespace
+{
+
+// A triangle soup covering a grid, where each triangle has its own points,
+// jittered in the plane by at most jitter. Some triangles are collapsed to lines or
+// points, and verts, lines and strips sharing points with the triangles are
+// added. The last points are not used by any cell.
+void MakeSoup(int resolution, double jitter, vtkPolyData *soup)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(VTK_DOUBLE);
+  auto insert = [&](double x, double y)
+  {
+    double p[3] = { x, y, 0.0 };
+    for (int i = 0; i < 2; ++i)
+    {
+      random->Next();
+      p[i] += jitter * (2.0 * random->GetValue() - 1.0);
+    }
+    return points->InsertNextPoint(p);
+  };
+
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  vtkIdType pts[4];
+  for (int j = 0; j < resolution; ++j)
+  {
+    for (int i = 0; i < resolution; ++i)
+    {
+      pts[0] = insert(i, j);
+      pts[1] = insert(i + 1, j);
+      pts[2] = insert(i + 1, j + 1);
+      polys->InsertNextCell(3, pts);
+      pts[0] = insert(i, j);
+      pts[1] = insert(i + 1, j + 1);
+      // Collapse some triangles to a line or a point, keeping the first
+      // column so that every grid point is used.
+      pts[2] = (i > 0 && (i + j) % 7 == 0) ? insert(i + 1, j + 1) :
+        (i > 0 && (i + j) % 7 == 3) ? pts[0] : insert(i, j + 1);
+      polys->InsertNextCell(3, pts);
+      if ((i * j) % 5 == 1)
+      {
+        pts[2] = insert(i + 1, j + 1);
+        pts[3] = insert(i, j);
+        lines->InsertNextCell(2, pts + 2);
+        pts[3] = insert(i + 1, j);
+        lines->InsertNextCell(2, pts + 2);
+        verts->InsertNextCell(4, pts);
+        pts[1] = insert(i + 1, j);
+        strips->InsertNextCell(4, pts);
+      }
+    }
+  }
+  insert(-1.0, -1.0);
+  insert(-1.0, -1.0);
+
+  soup->SetPoints(points);
+  soup->SetVerts(verts);
+  soup->SetLines(lines);
+  soup->SetPolys(polys);
+  soup->SetStrips(strips);
+
+  vtkNew<vtkDoubleArray> pointIds;
+  pointIds->SetName("PointIds");
+  pointIds->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->SetValue(ptId, ptId);
+  }
+  soup->GetPointData()->SetScalars(pointIds);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(soup->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < soup->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, cellId);
+  }
+  soup->GetCellData()->AddArray(cellIds);
+}
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  vtkIdType size = a->GetNumberOfConnectivityEntries();
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      size != b->GetNumberOfConnectivityEntries())
+  {
+    return false;
+  }
+  const vtkIdType *pa = a->GetPointer();
+  const vtkIdType *pb = b->GetPointer();
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (pa[i] != pb[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArray(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  return a->GetPoints()->GetDataType() == b->GetPoints()->GetDataType() &&
+    SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+    SameCells(a->GetVerts(), b->GetVerts()) &&
+    SameCells(a->GetLines(), b->GetLines()) &&
+    SameCells(a->GetPolys(), b->GetPolys()) &&
+    SameCells(a->GetStrips(), b->GetStrips()) &&
+    SameArray(a->GetPointData()->GetArray("PointIds"),
+              b->GetPointData()->GetArray("PointIds")) &&
+    SameArray(a->GetCellData()->GetArray("CellIds"),
+              b->GetCellData()->GetArray("CellIds"));
+}
+
+// Run the serial and the parallel modes with various numbers of threads.
+bool Compare(vtkPolyData *input, vtkCleanPolyData *clean, const char *name)
+{
+  clean->SetInputData(input);
+  clean->ParallelMergingOff();
+  clean->Update();
+  vtkNew<vtkPolyData> reference;
+  reference->DeepCopy(clean->GetOutput());
+
+  clean->ParallelMergingOn();
+  const int numThreads[] = { 1, 2, 4, 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkSMPTools::Initialize(numThreads[i]);
+    clean->Modified();
+    clean->Update();
+    if (!SameOutput(reference, clean->GetOutput()))
+    {
+      cerr << name << ": the parallel output differs from the serial one"
+           << " with " << vtkSMPTools::GetEstimatedNumberOfThreads()
+           << " thread(s)." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestCleanPolyDataParallel(int argc, char *argv[])
+{
+  int resolution = 60;
+  for (int argi = 1; argi < argc; argi++)
+  {
+    if (std::string(argv[argi]) == "--resolution" && argi + 1 < argc)
+    {
+      resolution = atoi(argv[++argi]);
+    }
+  }
+
+  vtkNew<vtkPolyData> soup;
+  MakeSoup(resolution, 0.0, soup);
+  vtkNew<vtkCleanPolyData> clean;
+  if (!Compare(soup, clean, "exact"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkIdType numPts = clean->GetOutput()->GetNumberOfPoints();
+  if (numPts != (resolution + 1) * (resolution + 1))
+  {
+    cerr << "Expected " << (resolution + 1) * (resolution + 1)
+         << " points, got " << numPts << endl;
+    return EXIT_FAILURE;
+  }
+
+  clean->ConvertLinesToPointsOff();
+  clean->ConvertStripsToPolysOff();
+  clean->SetOutputPointsPrecision(vtkAlgorithm::SINGLE_PRECISION);
+  if (!Compare(soup, clean, "no conversion, single precision"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  clean->PointMergingOff();
+  if (!Compare(soup, clean, "no merging"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Cells stored as offsets and connectivity.
+  soup->GetPolys()->Use64BitStorage();
+  soup->GetVerts()->Use32BitStorage();
+  clean->PointMergingOn();
+  clean->ConvertLinesToPointsOn();
+  clean->ConvertStripsToPolysOn();
+  clean->SetOutputPointsPrecision(vtkAlgorithm::DEFAULT_PRECISION);
+  if (!Compare(soup, clean, "offsets storage"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Points close to each other but far from the others are merged the same
+  // way by both modes.
+  vtkNew<vtkPolyData> jittered;
+  MakeSoup(resolution, 1.0e-4, jittered);
+  clean->ToleranceIsAbsoluteOn();
+  clean->SetAbsoluteTolerance(1.0e-3);
+  if (!Compare(jittered, clean, "tolerance"))
+  {
+    return EXIT_FAILURE;
+  }
+  if (clean->GetOutput()->GetNumberOfPoints() != numPts)
+  {
+    cerr << "Expected " << numPts << " points, got "
+         << clean->GetOutput()->GetNumberOfPoints() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
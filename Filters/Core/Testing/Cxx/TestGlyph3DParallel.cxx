@@ -0,0 +1,310 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkGlyph3D, which copies the glyphs in parallel when it can,
+// gives exactly the output of its serial insertion of the glyphs, for all
+// the scaling, coloring, orientation and indexing modes, and any number of
+// threads. The serial insertion is forced by a string array in the point
+// data, or by a table of glyphs with cells of different kinds.
+
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStringArray.h"
+#include "vtkTransform.h"
+#include "vtkUnsignedCharArray.h"
+
+namespace
+{
+
+// Random points with scalars, vectors (some of them null or along x),
+// normals, colors, labels and a few duplicate ghost points.
+vtkSmartPointer<vtkPolyData> MakeInput(vtkIdType numPts)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(3);
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("s");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("v");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("n");
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("c");
+  colors->SetNumberOfComponents(3);
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double p[3], v[3], n[3], c[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      random->Next();
+      p[j] = 10.0 * random->GetValue();
+      random->Next();
+      v[j] = 1.2 * random->GetValue() - 0.6;
+      random->Next();
+      n[j] = random->GetValue() - 0.5;
+      random->Next();
+      c[j] = 255.0 * random->GetValue();
+    }
+    if (i % 7 == 2)
+    {
+      v[1] = v[2] = 0.0;
+    }
+    if (i % 11 == 4)
+    {
+      v[0] = v[1] = v[2] = 0.0;
+    }
+    random->Next();
+    points->InsertNextPoint(p);
+    scalars->InsertNextValue(2.7 * random->GetValue() - 0.5);
+    vectors->InsertNextTuple(v);
+    normals->InsertNextTuple(n);
+    colors->InsertNextTuple(c);
+    labels->InsertNextValue(static_cast<int>(i % 13));
+    ghosts->InsertNextValue(i % 17 == 5 ?
+      static_cast<unsigned char>(vtkDataSetAttributes::DUPLICATEPOINT) : 0);
+  }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->SetNormals(normals);
+  input->GetPointData()->AddArray(colors);
+  input->GetPointData()->AddArray(labels);
+  input->GetPointData()->AddArray(ghosts);
+  return input;
+}
+
+bool CompareArrays(vtkDataArray *a, vtkDataArray *b, const char *what)
+{
+  if (!a || !b || a->GetDataType() != b->GetDataType() ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    cerr << "Bad " << what << " array " << (a ? a->GetName() : "") << endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        cerr << "Bad value in " << what << " array " << a->GetName()
+             << " at " << i << ": " << b->GetComponent(i, c) << " instead of "
+             << a->GetComponent(i, c) << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool CompareAttributes(vtkDataSetAttributes *a, vtkDataSetAttributes *b,
+                       const char *what)
+{
+  int numArrays = 0;
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = a->GetArray(i);
+    if (array)
+    {
+      numArrays++;
+      if (!CompareArrays(array, b->GetArray(array->GetName()), what))
+      {
+        return false;
+      }
+    }
+  }
+  for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
+  {
+    vtkDataArray *attribute = a->GetAttribute(i);
+    if ((attribute == nullptr) != (b->GetAttribute(i) == nullptr) ||
+        (attribute && !CompareArrays(attribute, b->GetAttribute(i), what)))
+    {
+      cerr << "Bad " << what << " attribute " << i << endl;
+      return false;
+    }
+  }
+  if (b->GetNumberOfArrays() != numArrays)
+  {
+    cerr << "Bad number of " << what << " arrays" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool CompareOutputs(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys() ||
+      a->GetNumberOfLines() != b->GetNumberOfLines())
+  {
+    cerr << "Bad number of points or cells" << endl;
+    return false;
+  }
+  if (!CompareArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData(),
+                     "point"))
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, ptsA);
+    b->GetCellPoints(cellId, ptsB);
+    bool same = (a->GetCellType(cellId) == b->GetCellType(cellId) &&
+                 ptsA->GetNumberOfIds() == ptsB->GetNumberOfIds());
+    for (vtkIdType i = 0; same && i < ptsA->GetNumberOfIds(); ++i)
+    {
+      same = (ptsA->GetId(i) == ptsB->GetId(i));
+    }
+    if (!same)
+    {
+      cerr << "Bad cell " << cellId << endl;
+      return false;
+    }
+  }
+  return CompareAttributes(a->GetPointData(), b->GetPointData(), "point data") &&
+    CompareAttributes(a->GetCellData(), b->GetCellData(), "cell data");
+}
+
+void Configure(vtkGlyph3D *glyph, int config, vtkTransform *transform)
+{
+  glyph->SetScaleMode(config % 4);
+  config /= 4;
+  glyph->SetColorMode(config % 3);
+  config /= 3;
+  glyph->SetVectorMode(config % 3);
+  config /= 3;
+  glyph->SetOrient(config % 2);
+  glyph->SetClamping(config % 3 == 1);
+  glyph->SetScaling(config % 5 != 3);
+  glyph->SetGeneratePointIds(config % 2 == 0);
+  glyph->SetFillCellData(config % 3 != 2);
+  glyph->SetOutputPointsPrecision(config % 4 == 1 ?
+    vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+  glyph->SetSourceTransform(config % 3 == 0 ? transform : nullptr);
+  glyph->SetScaleFactor(0.3);
+  glyph->SetRange(0.0, 3.0);
+  glyph->SetInputArrayToProcess(3, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "c");
+}
+
+} // end anon namespace
+
+int TestGlyph3DParallel(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> input = MakeInput(300);
+  vtkSmartPointer<vtkPolyData> serialInput = vtkSmartPointer<vtkPolyData>::New();
+  serialInput->ShallowCopy(input);
+  serialInput->GetPointData()->ShallowCopy(input->GetPointData());
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("strings");
+  strings->SetNumberOfValues(input->GetNumberOfPoints());
+  serialInput->GetPointData()->AddArray(strings);
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(7);
+  sphere->SetPhiResolution(5);
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(5);
+  vtkNew<vtkSphereSource> unused;
+  vtkNew<vtkPointSource> unusedPoints;
+  unusedPoints->SetNumberOfPoints(3);
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.0);
+  transform->Scale(1.0, 2.0, 0.5);
+  transform->Translate(0.1, 0.0, -0.2);
+
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int config = 0; config < 4 * 3 * 3 * 12; ++config)
+  {
+    // A single glyph
+    vtkNew<vtkGlyph3D> serial;
+    vtkNew<vtkGlyph3D> parallel;
+    vtkGlyph3D *filters[2] = { serial, parallel };
+    for (int f = 0; f < 2; ++f)
+    {
+      Configure(filters[f], config, transform);
+      filters[f]->SetInputData(f == 0 ? serialInput : input);
+      if (config % 5 != 4) // the default glyph otherwise
+      {
+        filters[f]->SetSourceConnection(
+          (config % 2 == 0 ? sphere->GetOutputPort() : cone->GetOutputPort()));
+      }
+    }
+    serial->Update();
+    serial->GetOutput()->GetPointData()->RemoveArray("strings");
+
+    // A table of glyphs (the last one is not used)
+    vtkNew<vtkGlyph3D> serialTable;
+    vtkNew<vtkGlyph3D> parallelTable;
+    vtkGlyph3D *tables[2] = { serialTable, parallelTable };
+    for (int f = 0; f < 2; ++f)
+    {
+      Configure(tables[f], config, transform);
+      tables[f]->SetInputData(input);
+      tables[f]->SetIndexMode(config % 2 == 0 ? VTK_INDEXING_BY_SCALAR :
+                              VTK_INDEXING_BY_VECTOR);
+      tables[f]->SetSourceConnection(0, sphere->GetOutputPort());
+      tables[f]->SetSourceConnection(1, cone->GetOutputPort());
+      tables[f]->SetSourceConnection(2, sphere->GetOutputPort());
+      tables[f]->SetSourceConnection(3, (f == 0 ?
+        unusedPoints->GetOutputPort() : unused->GetOutputPort()));
+    }
+    serialTable->Update();
+
+    for (int t = 0; t < 4; ++t)
+    {
+      vtkSMPTools::Initialize(numThreads[t]);
+      parallel->Modified();
+      parallel->Update();
+      parallelTable->Modified();
+      parallelTable->Update();
+      if (!CompareOutputs(serial->GetOutput(), parallel->GetOutput()) ||
+          !CompareOutputs(serialTable->GetOutput(), parallelTable->GetOutput()))
+      {
+        cerr << "Parallel output differs for configuration " << config
+             << " with " << numThreads[t] << " thread(s)." << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the orientation, splitting and point normals computed by
+// vtkPolyDataNormals, and that the parallel execution gives the output of
+// the serial one whatever the number of threads. With -B, it also prints
+// the time of the serial path and of the parallel one.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
+#include "vtkStripper.h"
+#include "vtkTimerLog.h"
+
+#include <cmath>
+#include <string>
+
+namespace
+{
+
+// A sphere made of triangles, with one triangle out of three reversed, and
+// a triangulated cube with all its triangles reversed.
+void MakeMesh(int resolution, vtkPolyData *mesh)
+{
+  const int numTheta = 2 * resolution;
+  const int numPhi = resolution;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+
+  points->InsertNextPoint(0.0, 0.0, 1.0);
+  points->InsertNextPoint(0.0, 0.0, -1.0);
+  for (int j = 1; j < numPhi; ++j)
+  {
+    double phi = vtkMath::Pi() * j / numPhi;
+    for (int i = 0; i < numTheta; ++i)
+    {
+      double theta = 2.0 * vtkMath::Pi() * i / numTheta;
+      points->InsertNextPoint(sin(phi) * cos(theta), sin(phi) * sin(theta),
+                              cos(phi));
+    }
+  }
+
+  vtkIdType numTris = 0;
+  vtkIdType tri[3];
+  // Insert the triangle with an outward ordering, reversed one out of three.
+  auto insert = [&](vtkIdType a, vtkIdType b, vtkIdType c)
+  {
+    tri[0] = a;
+    tri[1] = (numTris % 3 == 0 ? c : b);
+    tri[2] = (numTris % 3 == 0 ? b : c);
+    polys->InsertNextCell(3, tri);
+    ++numTris;
+  };
+  auto ring = [&](int j, int i)
+  {
+    return static_cast<vtkIdType>(2 + (j - 1) * numTheta + i % numTheta);
+  };
+  for (int i = 0; i < numTheta; ++i)
+  {
+    insert(0, ring(1, i), ring(1, i + 1));
+    insert(1, ring(numPhi - 1, i + 1), ring(numPhi - 1, i));
+  }
+  for (int j = 1; j < numPhi - 1; ++j)
+  {
+    for (int i = 0; i < numTheta; ++i)
+    {
+      insert(ring(j, i), ring(j + 1, i), ring(j + 1, i + 1));
+      insert(ring(j, i), ring(j + 1, i + 1), ring(j, i + 1));
+    }
+  }
+
+  // The cube, centered at (4,0,0), with inward ordered triangles.
+  vtkIdType offset = points->GetNumberOfPoints();
+  for (int k = 0; k < 2; ++k)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        points->InsertNextPoint(3.5 + i, -0.5 + j, -0.5 + k);
+      }
+    }
+  }
+  const vtkIdType quads[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 },
+    { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+  for (int f = 0; f < 6; ++f)
+  {
+    tri[0] = offset + quads[f][0];
+    tri[1] = offset + quads[f][1];
+    tri[2] = offset + quads[f][2];
+    polys->InsertNextCell(3, tri);
+    tri[1] = offset + quads[f][2];
+    tri[2] = offset + quads[f][3];
+    polys->InsertNextCell(3, tri);
+  }
+
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+}
+
+bool SameOutput(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetPolys()->GetNumberOfConnectivityEntries() !=
+      b->GetPolys()->GetNumberOfConnectivityEntries())
+  {
+    return false;
+  }
+  const vtkIdType *ca = a->GetPolys()->GetPointer();
+  const vtkIdType *cb = b->GetPolys()->GetPointer();
+  for (vtkIdType i = 0;
+       i < a->GetPolys()->GetNumberOfConnectivityEntries(); ++i)
+  {
+    if (ca[i] != cb[i])
+    {
+      return false;
+    }
+  }
+  vtkDataArray *na = a->GetPointData()->GetNormals();
+  vtkDataArray *nb = b->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      if (na->GetComponent(i, c) != nb->GetComponent(i, c) ||
+          a->GetPoint(i)[c] != b->GetPoint(i)[c])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestPolyDataNormals(int argc, char *argv[])
+{
+  int resolution = 100;
+  bool benchmark = false;
+  for (int argi = 1; argi < argc; argi++)
+  {
+    if (std::string(argv[argi]) == "--resolution" && argi + 1 < argc)
+    {
+      resolution = atoi(argv[++argi]);
+    }
+    else if (std::string(argv[argi]) == "-B")
+    {
+      benchmark = true;
+    }
+  }
+
+  vtkNew<vtkPolyData> mesh;
+  MakeMesh(resolution, mesh);
+  const vtkIdType numSpherePts = mesh->GetNumberOfPoints() - 8;
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(mesh);
+  normals->AutoOrientNormalsOn();
+
+  // The serial execution is the reference.
+  normals->Update();
+  vtkNew<vtkPolyData> reference;
+  reference->DeepCopy(normals->GetOutput());
+  int referenceFlips = normals->GetNumFlips();
+
+  // Also exercise the parallel paths on machines with few cores.
+  normals->ParallelExecutionOn();
+  const int numThreads[] = { 1, 2, 4, 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkSMPTools::Initialize(numThreads[i]);
+    normals->Modified();
+    normals->Update();
+    if (!SameOutput(reference, normals->GetOutput()) ||
+        normals->GetNumFlips() != referenceFlips)
+    {
+      cerr << "Parallel output with " << numThreads[i]
+           << " threads differs from the serial one." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  vtkPolyData *output = normals->GetOutput();
+
+  // One triangle out of three of the sphere, and the 12 cube triangles, are
+  // reversed.
+  vtkIdType numSphereTris = mesh->GetNumberOfPolys() - 12;
+  vtkIdType expectedFlips = (numSphereTris + 2) / 3 + 12;
+  if (normals->GetNumFlips() != expectedFlips)
+  {
+    cerr << "Expected " << expectedFlips << " flips, got "
+         << normals->GetNumFlips() << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The sphere is smooth, each corner of the cube is split in three.
+  if (output->GetNumberOfPoints() != numSpherePts + 24)
+  {
+    cerr << "Expected " << numSpherePts + 24 << " points, got "
+         << output->GetNumberOfPoints() << endl;
+    return EXIT_FAILURE;
+  }
+
+  // All the normals point outward.
+  vtkDataArray *pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double p[3], n[3];
+    output->GetPoint(i, p);
+    pointNormals->GetTuple(i, n);
+    if (p[0] > 2.0)
+    {
+      p[0] -= 4.0;
+      if (fabs(vtkMath::Dot(p, n) - 0.5) > 1e-6)
+      {
+        cerr << "Bad cube normal at point " << i << endl;
+        return EXIT_FAILURE;
+      }
+    }
+    else if (vtkMath::Dot(p, n) < 0.99)
+    {
+      cerr << "Bad sphere normal at point " << i << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Consistency without orientation keeps the ordering of the first
+  // triangle of each component.
+  normals->AutoOrientNormalsOff();
+  normals->Update();
+  if (normals->GetNumFlips() != numSphereTris - (numSphereTris + 2) / 3)
+  {
+    cerr << "Expected " << numSphereTris - (numSphereTris + 2) / 3
+         << " flips, got " << normals->GetNumFlips() << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Triangle strips are decomposed the same way by both paths, and without
+  // splitting the points are passed through.
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputData(mesh);
+  stripper->Update();
+  vtkNew<vtkPolyDataNormals> stripNormals;
+  stripNormals->SetInputConnection(stripper->GetOutputPort());
+  stripNormals->SplittingOff();
+  stripNormals->ComputeCellNormalsOn();
+  stripNormals->Update();
+  vtkNew<vtkPolyData> stripReference;
+  stripReference->DeepCopy(stripNormals->GetOutput());
+  stripNormals->ParallelExecutionOn();
+  stripNormals->Update();
+  vtkPolyData *stripOutput = stripNormals->GetOutput();
+  vtkDataArray *cellNormals = stripOutput->GetCellData()->GetNormals();
+  if (stripOutput->GetNumberOfPoints() != mesh->GetNumberOfPoints() ||
+      !cellNormals ||
+      cellNormals->GetNumberOfTuples() != stripOutput->GetNumberOfPolys() ||
+      !SameOutput(stripReference, stripOutput))
+  {
+    cerr << "Bad output for triangle strips." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // With -B, time the serial path against the parallel one.
+  if (benchmark)
+  {
+    vtkNew<vtkTimerLog> timer;
+    normals->AutoOrientNormalsOn();
+    normals->ParallelExecutionOff();
+    normals->Modified();
+    timer->StartTimer();
+    normals->Update();
+    timer->StopTimer();
+    double serialTime = timer->GetElapsedTime();
+    cout << "Serial: " << serialTime << " s for "
+         << mesh->GetNumberOfPolys() << " polygons" << endl;
+
+    normals->ParallelExecutionOn();
+    for (int i = 0; i < 4; ++i)
+    {
+      vtkSMPTools::Initialize(numThreads[i]);
+      normals->Modified();
+      timer->StartTimer();
+      normals->Update();
+      timer->StopTimer();
+      cout << "Parallel, " << numThreads[i] << " threads: "
+           << timer->GetElapsedTime() << " s (speedup "
+           << serialTime / timer->GetElapsedTime() << ")" << endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
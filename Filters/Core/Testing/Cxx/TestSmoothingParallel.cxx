@@ -0,0 +1,378 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothingParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkWindowedSincPolyDataFilter and vtkSmoothPolyDataFilter,
+// which analyze the mesh and smooth the points in parallel, give the same
+// points for any number of threads, with the requested precision, also when
+// the Laplacian smoothing stops at convergence, and that the Laplacian
+// smoothing of a closed surface moves each point towards the mean of its
+// neighbors at the previous iteration.
+
+#include "vtkCellArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSmoothPolyDataFilter.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+#include "vtkWindowedSincPolyDataFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+// A noisy sphere, with holes, vertices, lines and non-manifold edges, or
+// made of triangle strips.
+vtkSmartPointer<vtkPolyData> MakeMesh(int kind, int precision)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->SetOutputPointsPrecision(precision);
+  sphere->Update();
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->DeepCopy(sphere->GetOutput());
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(kind + 1);
+  vtkPoints *pts = mesh->GetPoints();
+  for (vtkIdType i = 0; i < pts->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    pts->GetPoint(i, x);
+    for (int k = 0; k < 3; ++k)
+    {
+      random->Next();
+      x[k] += 0.03 * (random->GetValue() - 0.5);
+    }
+    pts->SetPoint(i, x);
+  }
+
+  vtkIdType npts;
+  vtkIdType *cell;
+  if (kind == 1)
+  {
+    vtkNew<vtkStripper> stripper;
+    stripper->SetInputData(mesh);
+    stripper->Update();
+    mesh->DeepCopy(stripper->GetOutput());
+  }
+  else if (kind == 2)
+  {
+    vtkCellArray *polys = mesh->GetPolys();
+    vtkNew<vtkCellArray> newPolys;
+    vtkIdType cellId = 0;
+    for (polys->InitTraversal(); polys->GetNextCell(npts, cell); ++cellId)
+    {
+      if (cellId % 17 != 3 && (cellId < 200 || cellId > 260))
+      {
+        newPolys->InsertNextCell(npts, cell);
+      }
+    }
+    // fins making non-manifold edges
+    for (cellId = 0; cellId < 40; cellId += 4)
+    {
+      double x[3];
+      pts->GetPoint(cellId + 100, x);
+      vtkIdType fin[3] = { cellId + 100, cellId + 101,
+        pts->InsertNextPoint(1.3 * x[0], 1.3 * x[1], 1.3 * x[2]) };
+      newPolys->InsertNextCell(3, fin);
+    }
+    mesh->SetPolys(newPolys);
+
+    vtkNew<vtkCellArray> lines;
+    vtkIdType line1[6] = { 0, 5, 50, 51, 52, 90 };
+    lines->InsertNextCell(6, line1);
+    vtkIdType line2[4] = { 300, 301, 302, 303 };
+    lines->InsertNextCell(4, line2);
+    mesh->SetLines(lines);
+    vtkNew<vtkCellArray> verts;
+    vtkIdType vert[2] = { 700, 701 };
+    verts->InsertNextCell(2, vert);
+    mesh->SetVerts(verts);
+  }
+  return mesh;
+}
+
+bool SamePoints(vtkPolyData *a, vtkPolyData *b)
+{
+  vtkDataArray *x = a->GetPoints()->GetData();
+  vtkDataArray *y = b->GetPoints()->GetData();
+  if (x->GetDataType() != y->GetDataType() ||
+      x->GetNumberOfTuples() != y->GetNumberOfTuples())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < x->GetNumberOfTuples(); ++i)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      if (x->GetComponent(i, k) != y->GetComponent(i, k))
+      {
+        std::cerr << "Different point " << i << ": " << x->GetComponent(i, k)
+                  << " instead of " << y->GetComponent(i, k) << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> WindowedSinc(vtkPolyData *mesh, int config)
+{
+  vtkNew<vtkWindowedSincPolyDataFilter> smoother;
+  smoother->SetInputData(mesh);
+  smoother->SetNumberOfIterations(15 + config % 5);
+  smoother->SetFeatureEdgeSmoothing(config & 1);
+  smoother->SetBoundarySmoothing(config & 2);
+  smoother->SetNonManifoldSmoothing(config & 4);
+  smoother->SetNormalizeCoordinates(config & 8);
+  smoother->SetFeatureAngle(30.0);
+  smoother->SetEdgeAngle(40.0);
+  smoother->SetOutputPointsPrecision(config % 3);
+  smoother->Update();
+  vtkSmartPointer<vtkPolyData> output = smoother->GetOutput();
+  return output;
+}
+
+vtkSmartPointer<vtkPolyData> Laplacian(vtkPolyData *mesh, int config)
+{
+  vtkNew<vtkSmoothPolyDataFilter> smoother;
+  smoother->SetInputData(mesh);
+  smoother->SetNumberOfIterations(20);
+  smoother->SetRelaxationFactor(0.1);
+  smoother->SetFeatureEdgeSmoothing(config & 1);
+  smoother->SetBoundarySmoothing(config & 2);
+  smoother->SetFeatureAngle(30.0);
+  smoother->SetEdgeAngle(40.0);
+  smoother->SetOutputPointsPrecision(config % 3);
+  if (config & 4)
+  {
+    smoother->SetSourceData(mesh);
+  }
+  smoother->Update();
+  vtkSmartPointer<vtkPolyData> output = smoother->GetOutput();
+  return output;
+}
+
+// The Laplacian smoothing of a coarse sphere until convergence, which
+// takes about a hundred iterations as the sphere shrinks.
+vtkSmartPointer<vtkPolyData> LaplacianToConvergence()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(12);
+  sphere->SetPhiResolution(12);
+  vtkNew<vtkSmoothPolyDataFilter> smoother;
+  smoother->SetInputConnection(sphere->GetOutputPort());
+  smoother->SetNumberOfIterations(1000);
+  smoother->SetRelaxationFactor(0.5);
+  smoother->SetConvergence(0.6);
+  smoother->FeatureEdgeSmoothingOff();
+  smoother->Update();
+  vtkSmartPointer<vtkPolyData> output = smoother->GetOutput();
+  return output;
+}
+
+// The expected type of the output points: the windowed sinc filter gives
+// float points by default.
+int OutputType(vtkPolyData *mesh, int precision, bool sinc)
+{
+  if (precision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    return sinc ? VTK_FLOAT : mesh->GetPoints()->GetDataType();
+  }
+  return (precision == vtkAlgorithm::SINGLE_PRECISION ? VTK_FLOAT : VTK_DOUBLE);
+}
+
+// The Laplacian smoothing of a closed surface, where all the points move
+// towards the mean of the points they share an edge with.
+bool TestLaplacianReference()
+{
+  vtkSmartPointer<vtkPolyData> mesh =
+    MakeMesh(0, vtkAlgorithm::DOUBLE_PRECISION);
+  vtkIdType numPts = mesh->GetNumberOfPoints();
+  std::vector<std::set<vtkIdType> > neighbors(numPts);
+  vtkCellArray *polys = mesh->GetPolys();
+  vtkIdType npts;
+  vtkIdType *cell;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, cell); )
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      neighbors[cell[i]].insert(cell[(i + 1) % npts]);
+      neighbors[cell[(i + 1) % npts]].insert(cell[i]);
+    }
+  }
+
+  const double factor = 0.1;
+  std::vector<double> x(3 * numPts), y(3 * numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    mesh->GetPoint(i, &x[3 * i]);
+  }
+  for (int iteration = 0; iteration < 20; ++iteration)
+  {
+    for (vtkIdType i = 0; i < numPts; ++i)
+    {
+      double mean[3] = { 0.0, 0.0, 0.0 };
+      for (vtkIdType j : neighbors[i])
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          mean[k] += x[3 * j + k] / neighbors[i].size();
+        }
+      }
+      for (int k = 0; k < 3; ++k)
+      {
+        y[3 * i + k] = x[3 * i + k] + factor * (mean[k] - x[3 * i + k]);
+      }
+    }
+    std::swap(x, y);
+  }
+
+  // no feature edges, in double precision
+  vtkSmartPointer<vtkPolyData> smoothed = Laplacian(mesh, 16);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double p[3];
+    smoothed->GetPoint(i, p);
+    for (int k = 0; k < 3; ++k)
+    {
+      if (std::abs(p[k] - x[3 * i + k]) > 1e-10)
+      {
+        std::cerr << "Bad Laplacian smoothing of point " << i << ": " << p[k]
+                  << " instead of " << x[3 * i + k] << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+// The smoothing of a mesh whose polygons are in the 32-bit offsets storage
+// must give the reference points and leave the storage of the input as is.
+bool TestOffsetsStorage(vtkPolyData *mesh, int config, vtkPolyData *sinc,
+                        vtkPolyData *laplacian)
+{
+  vtkNew<vtkPolyData> offsetsMesh;
+  offsetsMesh->DeepCopy(mesh);
+  vtkCellArray *cellArrays[2] = { offsetsMesh->GetPolys(),
+                                  offsetsMesh->GetStrips() };
+  for (int i = 0; i < 2; ++i)
+  {
+    if (!cellArrays[i]->Use32BitStorage())
+    {
+      std::cerr << "Cannot convert the cells to the offsets storage."
+                << std::endl;
+      return false;
+    }
+  }
+  if (!SamePoints(WindowedSinc(offsetsMesh, config), sinc) ||
+      !SamePoints(Laplacian(offsetsMesh, config), laplacian))
+  {
+    std::cerr << "Bad smoothing with the offsets storage (config " << config
+              << ")." << std::endl;
+    return false;
+  }
+  for (int i = 0; i < 2; ++i)
+  {
+    if (cellArrays[i]->GetStorageType() != vtkCellArray::OFFSETS_32BIT_STORAGE)
+    {
+      std::cerr << "The storage of the input cells was changed." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int TestSmoothingParallel(int, char *[])
+{
+  const int numThreads[2] = { 2, 0 };
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    for (int inPrecision = 0; inPrecision < 2; ++inPrecision)
+    {
+      vtkSmartPointer<vtkPolyData> mesh = MakeMesh(kind, inPrecision);
+      for (int config = 0; config < 16; ++config)
+      {
+        // the reference, with a single thread
+        vtkSMPTools::Initialize(1);
+        vtkSmartPointer<vtkPolyData> sinc = WindowedSinc(mesh, config);
+        vtkSmartPointer<vtkPolyData> laplacian = Laplacian(mesh, config);
+        if (sinc->GetPoints()->GetDataType() !=
+              OutputType(mesh, config % 3, true) ||
+            laplacian->GetPoints()->GetDataType() !=
+              OutputType(mesh, config % 3, false))
+        {
+          std::cerr << "Bad type of the smoothed points." << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        for (int t = 0; t < 2; ++t)
+        {
+          vtkSMPTools::Initialize(numThreads[t]);
+          if (!SamePoints(WindowedSinc(mesh, config), sinc) ||
+              !SamePoints(Laplacian(mesh, config), laplacian))
+          {
+            std::cerr << "Bad smoothing of mesh " << kind << " (config "
+                      << config << ") with " << numThreads[t]
+                      << " thread(s)." << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+        if (config % 4 == 0 &&
+            !TestOffsetsStorage(mesh, config, sinc, laplacian))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // the iterations stopping at convergence, which depends on the largest
+  // displacement over all the threads
+  vtkSMPTools::Initialize(1);
+  vtkSmartPointer<vtkPolyData> converged = LaplacianToConvergence();
+  const int moreThreads[4] = { 2, 3, 4, 8 };
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(moreThreads[t]);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (!SamePoints(LaplacianToConvergence(), converged))
+      {
+        std::cerr << "Bad smoothing to convergence with " << moreThreads[t]
+                  << " threads." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  if (!TestLaplacianReference())
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,521 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the cells, points and attributes extracted by vtkThreshold from
+// unstructured grids (with polyhedra) and polydata in parallel, against the
+// serial execution, and that they do not depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkStringArray.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const double UpperThreshold = 8.0;
+
+// A grid of resolution^3 cells, made of hexahedra, polyhedra and tetrahedra,
+// followed by an empty cell and by unused points. The point scalars are
+// integers between 0 and 16.
+void MakeGrid(int resolution, vtkUnstructuredGrid *grid)
+{
+  const int n = resolution + 1;
+  vtkNew<vtkPoints> points;
+  points->SetDataType(VTK_DOUBLE);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+        scalars->InsertNextValue((i + 2 * j + k) % 17);
+      }
+    }
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    points->InsertNextPoint(-1.0, -1.0, -i);
+    scalars->InsertNextValue(16.0);
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+
+  grid->Allocate(resolution * resolution * resolution);
+  auto id = [n](int i, int j, int k)
+  {
+    return static_cast<vtkIdType>(i + n * (j + n * k));
+  };
+  const int quads[6][4] = { { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 },
+    { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+  vtkIdType pts[8];
+  vtkIdType faces[30];
+  vtkIdType cellId = 0;
+  for (int k = 0; k < resolution; ++k)
+  {
+    for (int j = 0; j < resolution; ++j)
+    {
+      for (int i = 0; i < resolution; ++i, ++cellId)
+      {
+        pts[0] = id(i, j, k);
+        pts[1] = id(i + 1, j, k);
+        pts[2] = id(i + 1, j + 1, k);
+        pts[3] = id(i, j + 1, k);
+        pts[4] = id(i, j, k + 1);
+        pts[5] = id(i + 1, j, k + 1);
+        pts[6] = id(i + 1, j + 1, k + 1);
+        pts[7] = id(i, j + 1, k + 1);
+        if (cellId % 5 == 2)
+        {
+          for (int f = 0; f < 6; ++f)
+          {
+            faces[5 * f] = 4;
+            for (int v = 0; v < 4; ++v)
+            {
+              faces[5 * f + 1 + v] = pts[quads[f][v]];
+            }
+          }
+          grid->InsertNextCell(VTK_POLYHEDRON, 8, pts, 6, faces);
+        }
+        else if (cellId % 11 == 4)
+        {
+          pts[2] = pts[3];
+          pts[3] = pts[4];
+          grid->InsertNextCell(VTK_TETRA, 4, pts);
+        }
+        else
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, pts);
+        }
+      }
+    }
+  }
+  grid->InsertNextCell(VTK_EMPTY_CELL, 0, pts);
+}
+
+// Add the arrays used to check the output, i.e. the input ids of the points
+// and cells, and the cell scalars.
+void AddIds(vtkDataSet *input)
+{
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("InputPointIds");
+  pointIds->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->SetValue(ptId, ptId);
+  }
+  input->GetPointData()->AddArray(pointIds);
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("InputCellIds");
+  cellIds->SetNumberOfTuples(input->GetNumberOfCells());
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  cellScalars->SetNumberOfTuples(input->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, cellId);
+    cellScalars->SetValue(cellId, cellId % 13);
+  }
+  input->GetCellData()->AddArray(cellIds);
+  input->GetCellData()->AddArray(cellScalars);
+}
+
+// Check the output against the cells of the input satisfying the
+// criterion.
+template <typename Criterion>
+bool CheckOutput(vtkDataSet *input, vtkUnstructuredGrid *output,
+                 const Criterion &criterion, bool withNames)
+{
+  vtkIdTypeArray *inputPointIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetPointData()->GetArray("InputPointIds"));
+  vtkIdTypeArray *inputCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("InputCellIds"));
+  vtkStringArray *names = vtkArrayDownCast<vtkStringArray>(
+    output->GetCellData()->GetAbstractArray("Names"));
+  if (!inputPointIds || !inputCellIds || (withNames && !names))
+  {
+    cerr << "Missing output arrays." << endl;
+    return false;
+  }
+
+  // The output points are the used points, in the input order.
+  std::vector<char> used(input->GetNumberOfPoints(), 0);
+  vtkNew<vtkIdList> cellPts;
+  vtkNew<vtkIdList> outCellPts;
+  vtkIdType outCellId = 0;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, cellPts);
+    if (!criterion(cellId, cellPts))
+    {
+      continue;
+    }
+    if (outCellId >= output->GetNumberOfCells() ||
+        inputCellIds->GetValue(outCellId) != cellId ||
+        output->GetCellType(outCellId) != input->GetCellType(cellId) ||
+        (names && names->GetValue(outCellId) != std::to_string(cellId)))
+    {
+      cerr << "Bad output cell " << outCellId << endl;
+      return false;
+    }
+    output->GetCellPoints(outCellId, outCellPts);
+    if (outCellPts->GetNumberOfIds() != cellPts->GetNumberOfIds())
+    {
+      cerr << "Bad size for output cell " << outCellId << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      used[cellPts->GetId(i)] = 1;
+      if (inputPointIds->GetValue(outCellPts->GetId(i)) != cellPts->GetId(i))
+      {
+        cerr << "Bad points for output cell " << outCellId << endl;
+        return false;
+      }
+    }
+    if (output->GetCellType(outCellId) == VTK_POLYHEDRON)
+    {
+      vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+      grid->GetFaceStream(cellId, cellPts);
+      output->GetFaceStream(outCellId, outCellPts);
+      if (outCellPts->GetNumberOfIds() != cellPts->GetNumberOfIds() ||
+          outCellPts->GetId(0) != cellPts->GetId(0))
+      {
+        cerr << "Bad faces for output cell " << outCellId << endl;
+        return false;
+      }
+      for (vtkIdType i = 1; i < cellPts->GetNumberOfIds(); i += 5)
+      {
+        for (vtkIdType v = 1; v <= 4; ++v)
+        {
+          if (inputPointIds->GetValue(outCellPts->GetId(i + v)) !=
+              cellPts->GetId(i + v))
+          {
+            cerr << "Bad faces for output cell " << outCellId << endl;
+            return false;
+          }
+        }
+      }
+    }
+    ++outCellId;
+  }
+  if (outCellId != output->GetNumberOfCells())
+  {
+    cerr << "Expected " << outCellId << " cells, got "
+         << output->GetNumberOfCells() << endl;
+    return false;
+  }
+
+  vtkIdType outPtId = 0;
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    if (!used[ptId])
+    {
+      continue;
+    }
+    double x[3], y[3];
+    input->GetPoint(ptId, x);
+    output->GetPoint(outPtId, y);
+    if (inputPointIds->GetValue(outPtId) != ptId ||
+        x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << "Bad output point " << outPtId << endl;
+      return false;
+    }
+    ++outPtId;
+  }
+  if (outPtId != output->GetNumberOfPoints())
+  {
+    cerr << "Expected " << outPtId << " points, got "
+         << output->GetNumberOfPoints() << endl;
+    return false;
+  }
+  return true;
+}
+
+bool SameArray(vtkDataArray *a, vtkDataArray *b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameOutput(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  return a->GetNumberOfCells() == b->GetNumberOfCells() &&
+    SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+    SameArray(a->GetCells()->GetData(), b->GetCells()->GetData()) &&
+    SameArray(a->GetCellTypesArray(), b->GetCellTypesArray()) &&
+    SameArray(a->GetPointData()->GetArray("InputPointIds"),
+              b->GetPointData()->GetArray("InputPointIds")) &&
+    SameArray(a->GetCellData()->GetArray("InputCellIds"),
+              b->GetCellData()->GetArray("InputCellIds"));
+}
+
+// Check that the outputs have the same cells, made of the same input
+// points, whatever the order of their points.
+bool SameCells(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      !SameArray(a->GetCellTypesArray(), b->GetCellTypesArray()) ||
+      !SameArray(a->GetCellData()->GetArray("InputCellIds"),
+                 b->GetCellData()->GetArray("InputCellIds")))
+  {
+    return false;
+  }
+  vtkDataArray *aPointIds = a->GetPointData()->GetArray("InputPointIds");
+  vtkDataArray *bPointIds = b->GetPointData()->GetArray("InputPointIds");
+  vtkNew<vtkIdList> aPts;
+  vtkNew<vtkIdList> bPts;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    // the points of the polyhedra are in the order of their faces
+    bool polyhedron = a->GetCellType(cellId) == VTK_POLYHEDRON;
+    if (polyhedron)
+    {
+      a->GetFaceStream(cellId, aPts);
+      b->GetFaceStream(cellId, bPts);
+    }
+    else
+    {
+      a->GetCellPoints(cellId, aPts);
+      b->GetCellPoints(cellId, bPts);
+    }
+    if (aPts->GetNumberOfIds() != bPts->GetNumberOfIds())
+    {
+      return false;
+    }
+    vtkIdType nextCount = polyhedron ? 1 : -1;
+    for (vtkIdType i = 0; i < aPts->GetNumberOfIds(); ++i)
+    {
+      if (i == 0 && polyhedron)
+      {
+        continue;
+      }
+      if (i == nextCount)
+      {
+        // the number of points of the next face
+        if (aPts->GetId(i) != bPts->GetId(i))
+        {
+          return false;
+        }
+        nextCount += aPts->GetId(i) + 1;
+        continue;
+      }
+      double x[3], y[3];
+      a->GetPoint(aPts->GetId(i), x);
+      b->GetPoint(bPts->GetId(i), y);
+      if (aPointIds->GetComponent(aPts->GetId(i), 0) !=
+          bPointIds->GetComponent(bPts->GetId(i), 0) ||
+          x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Run the filter serially, then in parallel with various numbers of
+// threads.
+bool Compare(vtkThreshold *threshold, const char *name)
+{
+  threshold->ParallelExecutionOff();
+  threshold->Update();
+  vtkNew<vtkUnstructuredGrid> serial;
+  serial->DeepCopy(threshold->GetOutput());
+
+  threshold->ParallelExecutionOn();
+  vtkNew<vtkUnstructuredGrid> reference;
+  const int numThreads[] = { 1, 2, 4, 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkSMPTools::Initialize(numThreads[i]);
+    threshold->Modified();
+    threshold->Update();
+    if (!SameCells(serial, threshold->GetOutput()))
+    {
+      cerr << name << ": the parallel output with " << numThreads[i]
+           << " threads differs from the serial one." << endl;
+      return false;
+    }
+    if (i == 0)
+    {
+      reference->DeepCopy(threshold->GetOutput());
+    }
+    else if (!SameOutput(reference, threshold->GetOutput()))
+    {
+      cerr << name << ": the output depends on the number of threads." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestThresholdParallel(int argc, char *argv[])
+{
+  int resolution = 20;
+  for (int argi = 1; argi < argc; argi++)
+  {
+    if (std::string(argv[argi]) == "--resolution" && argi + 1 < argc)
+    {
+      resolution = atoi(argv[++argi]);
+    }
+  }
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(resolution, grid);
+  AddIds(grid);
+  vtkDataArray *scalars = grid->GetPointData()->GetScalars();
+
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(grid);
+  threshold->ThresholdByUpper(UpperThreshold);
+  if (!Compare(threshold, "point scalars") ||
+      !CheckOutput(grid, threshold->GetOutput(),
+        [scalars](vtkIdType, vtkIdList *cellPts)
+        {
+          for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+          {
+            if (scalars->GetComponent(cellPts->GetId(i), 0) < UpperThreshold)
+            {
+              return false;
+            }
+          }
+          return cellPts->GetNumberOfIds() > 0;
+        }, false))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Cell scalars, with a string array copied serially.
+  vtkNew<vtkStringArray> cellNames;
+  cellNames->SetName("Names");
+  cellNames->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    cellNames->SetValue(cellId, std::to_string(cellId));
+  }
+  grid->GetCellData()->AddArray(cellNames);
+  threshold->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellScalars");
+  if (!Compare(threshold, "cell scalars") ||
+      !CheckOutput(grid, threshold->GetOutput(),
+        [](vtkIdType cellId, vtkIdList *cellPts)
+        {
+          return cellId % 13 >= UpperThreshold &&
+            cellPts->GetNumberOfIds() > 0;
+        }, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Continuous cell range, with the cells of the grid stored as offsets.
+  grid->GetCellData()->RemoveArray("Names");
+  threshold->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "Scalars");
+  threshold->ThresholdBetween(4.5, 4.6);
+  threshold->AllScalarsOff();
+  threshold->UseContinuousCellRangeOn();
+  grid->GetCells()->Use64BitStorage();
+  if (!Compare(threshold, "continuous cell range"))
+  {
+    return EXIT_FAILURE;
+  }
+  if (threshold->GetOutput()->GetNumberOfCells() == 0)
+  {
+    cerr << "Expected cells with a continuous cell range." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Polydata made of the faces of the polyhedra, and lines, stored as
+  // offsets.
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(grid->GetPoints());
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIdList> faces;
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    if (grid->GetCellType(cellId) == VTK_POLYHEDRON)
+    {
+      grid->GetFaceStream(cellId, faces);
+      for (vtkIdType i = 1; i < faces->GetNumberOfIds(); i += 5)
+      {
+        polys->InsertNextCell(4, faces->GetPointer(i + 1));
+      }
+      lines->InsertNextCell(2, faces->GetPointer(2));
+    }
+  }
+  polys->Use32BitStorage();
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+  polyData->GetPointData()->SetScalars(scalars);
+  AddIds(polyData);
+  threshold->SetInputData(polyData);
+  threshold->ThresholdByUpper(UpperThreshold);
+  threshold->AllScalarsOn();
+  threshold->UseContinuousCellRangeOff();
+  if (!Compare(threshold, "polydata") ||
+      !CheckOutput(polyData, threshold->GetOutput(),
+        [scalars](vtkIdType, vtkIdList *cellPts)
+        {
+          for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+          {
+            if (scalars->GetComponent(cellPts->GetId(i), 0) < UpperThreshold)
+            {
+              return false;
+            }
+          }
+          return true;
+        }, false))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -14,23 +14,210 @@
 =========================================================================*/
 #include "vtkArrayCalculator.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
 #include "vtkFunctionParser.h"
 #include "vtkGraph.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+
+// The number of tuples for which the function is evaluated at once.
+const vtkIdType vtkArrayCalculatorBlockSize = 1024;
+
+// The values of a variable of the function parser: a component of an
+// array, a coordinate of the points when the array is null, or the current
+// value of the variable when the component is negative.
+struct vtkArrayCalculatorSource
+{
+  vtkDataArray *Array;
+  int Component;
+};
+
+// Copy a component of the tuples [Begin, End) of an array.
+struct vtkArrayCalculatorGetComponent
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  int Component;
+  double *Values;
+
+  template <class ArrayT>
+  void operator()(ArrayT *array)
+  {
+    vtkDataArrayAccessor<ArrayT> accessor(array);
+    for (vtkIdType i = this->Begin; i < this->End; i++)
+    {
+      this->Values[i - this->Begin] =
+        static_cast<double>(accessor.Get(i, this->Component));
+    }
+  }
+};
+
+// Set the tuples [Begin, End) of an array, like SetTuple() does.
+struct vtkArrayCalculatorSetTuples
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  int NumberOfComponents;
+  const double *Values;
+
+  template <class ArrayT>
+  void operator()(ArrayT *array)
+  {
+    typedef typename vtkDataArrayAccessor<ArrayT>::APIType ValueType;
+    vtkDataArrayAccessor<ArrayT> accessor(array);
+    const double *values = this->Values;
+    for (vtkIdType i = this->Begin; i < this->End; i++)
+    {
+      for (int j = 0; j < this->NumberOfComponents; j++)
+      {
+        accessor.Set(i, j, static_cast<ValueType>(*values++));
+      }
+    }
+  }
+};
+
+// Evaluate the function by blocks of tuples: the values of the variables
+// are gathered from their arrays, the parser evaluates the block, and the
+// results are scattered to the result array.
+class vtkArrayCalculatorFunctor
+{
+public:
+  vtkFunctionParser *Parser;
+  const std::vector<vtkArrayCalculatorSource> *Sources;
+  int NumberOfScalarVariables;
+  vtkDataSet *DataSet;
+  vtkGraph *Graph;
+  vtkDataArray *Result;
+  int NumberOfComponents;
+  vtkIdType NumberOfInvalidValues;
+
+  struct Buffers
+  {
+    std::vector<double> Values;
+    std::vector<const double *> Pointers;
+    vtkIdType NumberOfInvalidValues;
+  };
+  vtkSMPThreadLocal<Buffers> LocalBuffers;
+
+  void Initialize()
+  {
+    // the variables, the point coordinates, the results and the work space
+    Buffers &buffers = this->LocalBuffers.Local();
+    const vtkIdType n = vtkArrayCalculatorBlockSize;
+    const size_t numValues = this->Sources->size() + 3 +
+      this->NumberOfComponents;
+    buffers.Values.resize(numValues*n + this->Parser->GetBlockWorkSize(n));
+    buffers.Pointers.assign(this->Sources->size(), nullptr);
+    buffers.NumberOfInvalidValues = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    Buffers &buffers = this->LocalBuffers.Local();
+    const vtkIdType blockSize = vtkArrayCalculatorBlockSize;
+    const size_t numSources = this->Sources->size();
+    double *points = buffers.Values.data() + numSources*blockSize;
+    double *result = points + 3*blockSize;
+    double *work = result + this->NumberOfComponents*blockSize;
+
+    for (vtkIdType blockBegin = begin; blockBegin < end;
+         blockBegin += blockSize)
+    {
+      const vtkIdType blockEnd = std::min(blockBegin + blockSize, end);
+      const vtkIdType n = blockEnd - blockBegin;
+
+      bool pointsDone = false;
+      for (size_t k = 0; k < numSources; k++)
+      {
+        const vtkArrayCalculatorSource &source = (*this->Sources)[k];
+        double *values = buffers.Values.data() + k*blockSize;
+        if (source.Component < 0)
+        {
+          buffers.Pointers[k] = nullptr;
+          continue;
+        }
+        buffers.Pointers[k] = values;
+        if (source.Array)
+        {
+          vtkArrayCalculatorGetComponent worker =
+            { blockBegin, blockEnd, source.Component, values };
+          if (!vtkArrayDispatch::Dispatch::Execute(source.Array, worker))
+          {
+            worker(source.Array);
+          }
+          continue;
+        }
+        if (!pointsDone)
+        {
+          for (vtkIdType i = 0; i < n; i++)
+          {
+            if (this->DataSet)
+            {
+              this->DataSet->GetPoint(blockBegin + i, points + 3*i);
+            }
+            else
+            {
+              this->Graph->GetPoint(blockBegin + i, points + 3*i);
+            }
+          }
+          pointsDone = true;
+        }
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          values[i] = points[3*i + source.Component];
+        }
+      }
+
+      const double *const *pointers = buffers.Pointers.data();
+      buffers.NumberOfInvalidValues += this->Parser->EvaluateBlock(n,
+        pointers, pointers + this->NumberOfScalarVariables, result, work);
+
+      vtkArrayCalculatorSetTuples worker =
+        { blockBegin, blockEnd, this->NumberOfComponents, result };
+      if (!vtkArrayDispatch::Dispatch::Execute(this->Result, worker))
+      {
+        worker(this->Result);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->NumberOfInvalidValues = 0;
+    for (auto iter = this->LocalBuffers.begin();
+         iter != this->LocalBuffers.end(); ++iter)
+    {
+      this->NumberOfInvalidValues += iter->NumberOfInvalidValues;
+    }
+  }
+};
+
+} // end anonymous namespace
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -458,64 +645,96 @@ int vtkArrayCalculator::RequestData(
     }
   }
 
-  for (i = 1; i < numTuples; i++)
+  // The source of the values of each variable of the parser for the other
+  // tuples, the later assignments taking precedence as with
+  // SetScalarVariableValue() and SetVectorVariableValue().
+  const int numScalarVariables =
+    this->FunctionParser->GetNumberOfScalarVariables();
+  const int numVectorVariables =
+    this->FunctionParser->GetNumberOfVectorVariables();
+  const vtkArrayCalculatorSource currentValue = { nullptr, -1 };
+  std::vector<vtkArrayCalculatorSource> sources(
+    numScalarVariables + 3*numVectorVariables, currentValue);
+  for (j = 0; j < this->NumberOfScalarArrays; j++)
   {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+    if ((currentArray = scalarArrays[j]))
     {
-      if ((currentArray = scalarArrays[j]))
-      {
-        this->FunctionParser->
-          SetScalarVariableValue(scalarArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
-      }
+      sources[scalarArrayIndicies[j]].Array = currentArray;
+      sources[scalarArrayIndicies[j]].Component =
+        this->SelectedScalarComponents[j];
     }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+  }
+  for (j = 0; j < this->NumberOfVectorArrays; j++)
+  {
+    if ((currentArray = vectorArrays[j]))
     {
-      if ((currentArray = vectorArrays[j]))
+      for (int k = 0; k < 3; k++)
       {
-        this->FunctionParser->SetVectorVariableValue(vectorArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-            currentArray->GetComponent(
-              i, this->SelectedVectorComponents[j][1]),
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+        vtkArrayCalculatorSource &source =
+          sources[numScalarVariables + 3*vectorArrayIndicies[j] + k];
+        source.Array = currentArray;
+        source.Component = this->SelectedVectorComponents[j][k];
       }
     }
-    if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
+  }
+
+  // The coordinates come from the points of the point sets, or from the
+  // thread-safe GetPoint() of the other data sets and graphs.
+  bool serial = false;
+  if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
+  {
+    vtkPointSet *psInput = vtkPointSet::SafeDownCast(input);
+    vtkDataArray *points = (psInput && psInput->GetPoints() ?
+                            psInput->GetPoints()->GetData() : nullptr);
+    bool coordinates = false;
+    for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
     {
-      double* pt = nullptr;
-      if (dsInput)
-      {
-        pt = dsInput->GetPoint(i);
-      }
-      else
-      {
-        pt = graphInput->GetPoint(i);
-      }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
+      if (j + this->NumberOfScalarArrays < numScalarVariables)
       {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-      }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
-      {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
+        vtkArrayCalculatorSource &source =
+          sources[j + this->NumberOfScalarArrays];
+        source.Array = points;
+        source.Component = this->SelectedCoordinateScalarComponents[j];
+        coordinates = true;
       }
     }
-    if (resultType == SCALAR_RESULT)
-    {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
-    }
-    else
+    for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
     {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      if (j + this->NumberOfVectorArrays < numVectorVariables)
+      {
+        for (int k = 0; k < 3; k++)
+        {
+          vtkArrayCalculatorSource &source = sources[numScalarVariables +
+            3*(j + this->NumberOfVectorArrays) + k];
+          source.Array = points;
+          source.Component = this->SelectedCoordinateVectorComponents[j][k];
+        }
+        coordinates = true;
+      }
     }
+    serial = (coordinates && !points && !graphInput &&
+              !vtkImageData::SafeDownCast(input) &&
+              !vtkRectilinearGrid::SafeDownCast(input));
+  }
+  // Bit arrays and other arrays without typed values are set by one thread.
+  serial |= (resultArray->GetArrayType() == vtkAbstractArray::DataArray);
+
+  vtkArrayCalculatorFunctor functor;
+  functor.Parser = this->FunctionParser;
+  functor.Sources = &sources;
+  functor.NumberOfScalarVariables = numScalarVariables;
+  functor.DataSet = dsInput;
+  functor.Graph = graphInput;
+  functor.Result = resultArray;
+  functor.NumberOfComponents = resultArray->GetNumberOfComponents();
+  functor.NumberOfInvalidValues = 0;
+  vtkSMPTools::For(1, numTuples,
+    (serial ? numTuples : vtkArrayCalculatorBlockSize), functor);
+  if (functor.NumberOfInvalidValues > 0)
+  {
+    vtkErrorMacro("The function cannot be evaluated for "
+                  << functor.NumberOfInvalidValues << " of the "
+                  << numTuples << " tuples.");
   }
 
   output->ShallowCopy(input);
@@ -54,6 +54,12 @@
  * tuple-wise (i.e., tuple-by-tuple). The user must specify which arrays to use as
  * vectors and/or scalars, and the name of the output data array.
  *
+ * The function is evaluated for blocks of tuples at once with
+ * vtkFunctionParser::EvaluateBlock(), and the blocks are shared among the
+ * threads of vtkSMPTools.  The results are the same as the evaluation of
+ * each tuple in turn, but the tuples for which the function cannot be
+ * evaluated are reported by a single error.
+ *
  * @sa
  * vtkFunctionParser
 */
@@ -14,112 +14,362 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
-#include "vtkUnsignedIntArray.h"
 
 #include <algorithm>
-#include <functional>
-
-#define VTK_MAX_CELLS_PER_POINT 4096
+#include <vector>
 
 vtkStandardNewMacro(vtkCellDataToPointData);
 
 namespace
 {
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
-  template <typename T>
-  void __spread (vtkDataSet* const src, vtkUnsignedIntArray* const num,
-                 vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-                 vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps,
-                 int highestCellDimension, int contributingCellOption)
+// The dimension of each cell, for the ContributingCellOption.
+void ComputeCellDimensions(vtkDataSet *src, std::vector<unsigned char> &dims)
+{
+  int typeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  std::fill_n(typeDimensions, VTK_NUMBER_OF_CELL_TYPES, -1);
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType const ncells = src->GetNumberOfCells();
+  dims.resize(ncells);
+  for (vtkIdType cid = 0; cid < ncells; ++cid)
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+    int const type = src->GetCellType(cid);
+    if (typeDimensions[type] < 0)
+    {
+      cell->SetCellType(type);
+      typeDimensions[type] = cell->GetCellDimension();
+    }
+    dims[cid] = static_cast<unsigned char>(typeDimensions[type]);
+  }
+}
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+//----------------------------------------------------------------------------
+// Select the cells of a point which contribute to its value. With cell
+// dimensions, only the cells of dimension HighestCellDimension or more
+// contribute, or only the cells of the highest dimension around the point
+// for patches.
+struct ContributingCells
+{
+  unsigned char const *Dimensions;
+  int HighestCellDimension;
+  bool Patch;
 
-    // accumulate
-    if (contributingCellOption != vtkCellDataToPointData::Patch)
+  vtkIdType Select(vtkIdType ncells, vtkIdType const *&cells,
+                   std::vector<vtkIdType> &selected) const
+  {
+    if (!this->Dimensions)
     {
-      T const* srcbeg = srcptr;
-      for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+      return ncells;
+    }
+    int minDimension = this->HighestCellDimension;
+    if (this->Patch)
+    {
+      for (vtkIdType i = 0; i < ncells; ++i)
       {
-        vtkCell* cell = src->GetCell(cid);
-        if (cell->GetCellDimension() >= highestCellDimension)
-        {
-          vtkIdList* pids = cell->GetPointIds();
-          for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-          {
-            T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-            // accumulate cell data to point data <==> point_data += cell_data
-            std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
-          }
-        }
+        minDimension = std::max(minDimension,
+                                int(this->Dimensions[cells[i]]));
       }
-      // average
-      T* dstbeg = dstptr;
-      for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
+    }
+    selected.clear();
+    for (vtkIdType i = 0; i < ncells; ++i)
+    {
+      if (this->Dimensions[cells[i]] >= minDimension)
       {
-        // guard against divide by zero
-        if (unsigned int const denom = num->GetValue(pid))
-        {
-          // divide point data by the number of cells using it <==>
-          // point_data /= denum
-          std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-                         std::bind2nd(std::divides<T>(), denom));
-        }
+        selected.push_back(cells[i]);
       }
     }
-    else
-    { // compute over cell patches
-      vtkNew<vtkIdList> cellsOnPoint;
-      std::vector<T> data(4*ncomps);
-      for (vtkIdType pid = 0; pid < npoints; ++pid)
+    cells = selected.data();
+    return static_cast<vtkIdType>(selected.size());
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the cell data of the contributing cells of each point, except for
+// the categorical arrays, which take the most frequent value of the cells.
+// The cells come from static links, or from GetPointCells() (which is
+// thread safe once it has been called from a single thread).
+struct SpreadCellData
+{
+  vtkDataSet *Input;
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+  ContributingCells Contributing;
+  ArrayList *Averaged;
+  ArrayList *Categorical;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Selected;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    std::vector<vtkIdType> &selected = this->Selected.Local();
+    for (vtkIdType pid = begin; pid < end; ++pid)
+    {
+      vtkIdType const *cells;
+      vtkIdType ncells;
+      if (this->Links)
+      {
+        cells = this->Links->GetCells(pid);
+        ncells = this->Links->GetNumberOfCells(pid);
+      }
+      else
+      {
+        this->Input->GetPointCells(pid, cellIds);
+        cells = cellIds->GetPointer(0);
+        ncells = cellIds->GetNumberOfIds();
+      }
+      ncells = this->Contributing.Select(ncells, cells, selected);
+
+      if (ncells > 0)
+      {
+        this->Averaged->Average(static_cast<int>(ncells), cells, pid);
+        this->Categorical->Majority(static_cast<int>(ncells), cells, pid);
+      }
+      else
+      {
+        this->Averaged->AssignNullValue(pid);
+        this->Categorical->AssignNullValue(pid);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Whether the array is averaged rather than voted for.
+bool IsAveraged(vtkDataArray *array, bool categorical)
+{
+  int const type = array->GetDataType();
+  return !categorical || type == VTK_FLOAT || type == VTK_DOUBLE;
+}
+
+//----------------------------------------------------------------------------
+// Pair the cell data arrays with the point data arrays allocated for them,
+// the arrays of integral types being categorical if requested.
+void AddArrays(vtkDataSetAttributes::FieldList &list, vtkCellData *inCD,
+               vtkPointData *outPD, vtkIdType npoints, bool categorical,
+               ArrayList &averaged, ArrayList &categoricalArrays)
+{
+  for (int i = 0; i < inCD->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = inCD->GetArray(i);
+    if (array)
+    {
+      if (IsAveraged(array, categorical))
+      {
+        categoricalArrays.ExcludeArray(array);
+      }
+      else
+      {
+        averaged.ExcludeArray(array);
+      }
+    }
+  }
+  averaged.AddArrays(npoints, list, inCD, outPD);
+  categoricalArrays.AddArrays(npoints, list, inCD, outPD);
+}
+
+//----------------------------------------------------------------------------
+// Whether the threaded kernels can process the attributes, that is, when all
+// the arrays are data arrays with the standard memory layout, which the
+// kernels access through their pointers, and no attribute is interpolated by
+// taking the value of the nearest neighbor.
+bool CanSpread(vtkDataSetAttributes::FieldList &list,
+               vtkDataSetAttributes *inAttr, vtkDataSetAttributes *outAttr)
+{
+  for (int i = 0; i < inAttr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array =
+      vtkArrayDownCast<vtkDataArray>(inAttr->GetAbstractArray(i));
+    if (!array || !array->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  for (int i = 0, numFields = list.GetNumberOfFields(); i < numFields; ++i)
+  {
+    int const outIdx = list.GetFieldIndex(i);
+    if (outIdx >= 0 &&
+        !outAttr->GetAbstractArray(outIdx)->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
+  {
+    if (outAttr->GetCopyAttribute(i, vtkDataSetAttributes::INTERPOLATE) == 2)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Assign to the point the most frequent value of the cells for each
+// component of the categorical arrays, through the vtkDataArray API.
+void VoteCellData(vtkDataSetAttributes::FieldList &list, vtkCellData *inCD,
+                  vtkPointData *outPD, vtkIdType pid, vtkIdType ncells,
+                  vtkIdType const *cells)
+{
+  for (int i = 0, numFields = list.GetNumberOfFields(); i < numFields; ++i)
+  {
+    int const inIdx = list.GetDSAIndex(0, i);
+    int const outIdx = list.GetFieldIndex(i);
+    vtkDataArray *inArray = (inIdx < 0 ? nullptr : inCD->GetArray(inIdx));
+    vtkDataArray *outArray = (outIdx < 0 ? nullptr : outPD->GetArray(outIdx));
+    if (!inArray || !outArray || IsAveraged(inArray, true))
+    {
+      continue;
+    }
+    for (int j = 0; j < inArray->GetNumberOfComponents(); ++j)
+    {
+      double best = inArray->GetComponent(cells[0], j);
+      vtkIdType bestCount = 0;
+      for (vtkIdType c = 0; c < ncells; ++c)
       {
-        std::fill(data.begin(), data.end(), 0);
-        T numPointCells[4] = {0, 0, 0, 0};
-        // Get all cells touching this point.
-        src->GetPointCells(pid, cellsOnPoint);
-        vtkIdType numPatchCells = cellsOnPoint->GetNumberOfIds();
-        for (vtkIdType pc = 0; pc  < numPatchCells; pc++)
+        double const value = inArray->GetComponent(cells[c], j);
+        vtkIdType count = 0;
+        for (vtkIdType k = 0; k < ncells; ++k)
         {
-          vtkIdType cellId = cellsOnPoint->GetId(pc);
-          int cellDimension = src->GetCell(cellId)->GetCellDimension();
-          numPointCells[cellDimension] += 1;
-          for (int comp=0;comp<ncomps;comp++)
-          {
-            data[comp+ncomps*cellDimension] += srcptr[comp+cellId*ncomps];
-          }
+          count += (inArray->GetComponent(cells[k], j) == value);
         }
-        for (int dimension=3;dimension>=0;dimension--)
+        if (count > bestCount || (count == bestCount && value < best))
         {
-          if (numPointCells[dimension])
-          {
-            for (int comp=0;comp<ncomps;comp++)
-            {
-              dstptr[comp+pid*ncomps] = data[comp+dimension*ncomps] / numPointCells[dimension];
-            }
-            break;
-          }
+          best = value;
+          bestCount = count;
         }
       }
+      outArray->SetComponent(pid, j, best);
     }
   }
+}
+
+//----------------------------------------------------------------------------
+// Allocate the point data for the arrays of the cell data, and compute them.
+// The data arrays with the standard memory layout are computed in parallel,
+// the cells using each point coming from the links if any, or from
+// GetPointCells() otherwise. The other arrays are interpolated one point at
+// a time. The progress is reported and the abort flag checked from the
+// calling thread.
+void SpreadCellDataToPoints(vtkCellDataToPointData *filter, vtkDataSet *src,
+                            vtkCellData *inCD, vtkPointData *outPD,
+                            vtkStaticCellLinksTemplate<vtkIdType> *links,
+                            int contributingCellOption, bool categorical)
+{
+  vtkIdType const npoints = src->GetNumberOfPoints();
+  vtkDataSetAttributes::FieldList cfl(1);
+  cfl.InitializeFieldList(inCD);
+  outPD->InterpolateAllocate(cfl, npoints, npoints);
+
+  ContributingCells contributing;
+  contributing.Dimensions = nullptr;
+  contributing.HighestCellDimension = 0;
+  contributing.Patch = false;
+  std::vector<unsigned char> dims;
+  if (contributingCellOption != vtkCellDataToPointData::All &&
+      src->GetNumberOfCells() > 0)
+  {
+    ComputeCellDimensions(src, dims);
+    contributing.Dimensions = dims.data();
+    contributing.Patch =
+      (contributingCellOption == vtkCellDataToPointData::Patch);
+    if (contributingCellOption == vtkCellDataToPointData::DataSetMax)
+    {
+      contributing.HighestCellDimension =
+        *std::max_element(dims.begin(), dims.end());
+    }
+  }
+
+  if (!links && npoints > 0)
+  {
+    // build the point to cell connectivity, if any, from a single thread
+    vtkNew<vtkIdList> cellIds;
+    src->GetPointCells(0, cellIds);
+  }
+
+  vtkIdType const progressInterval = npoints / 20 + 1;
+  if (CanSpread(cfl, inCD, outPD))
+  {
+    ArrayList averaged;
+    ArrayList categoricalArrays;
+    AddArrays(cfl, inCD, outPD, npoints, categorical, averaged,
+              categoricalArrays);
+
+    SpreadCellData spread;
+    spread.Input = src;
+    spread.Links = links;
+    spread.Contributing = contributing;
+    spread.Averaged = &averaged;
+    spread.Categorical = &categoricalArrays;
+
+    for (vtkIdType begin = 0; begin < npoints; begin += progressInterval)
+    {
+      filter->UpdateProgress(static_cast<double>(begin)/npoints);
+      if (filter->GetAbortExecute())
+      {
+        break;
+      }
+      vtkSMPTools::For(begin, std::min(begin + progressInterval, npoints),
+                       spread);
+    }
+    return;
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkIdList> contributingIds;
+  std::vector<vtkIdType> selected;
+  std::vector<double> weights;
+  int abort = 0;
+  for (vtkIdType pid = 0; pid < npoints && !abort; ++pid)
+  {
+    if ( !(pid % progressInterval) )
+    {
+      filter->UpdateProgress(static_cast<double>(pid)/npoints);
+      abort = filter->GetAbortExecute();
+    }
+
+    src->GetPointCells(pid, cellIds);
+    vtkIdType const *cells = cellIds->GetPointer(0);
+    vtkIdType const ncells =
+      contributing.Select(cellIds->GetNumberOfIds(), cells, selected);
+    if (ncells > 0)
+    {
+      contributingIds->SetNumberOfIds(ncells);
+      std::copy(cells, cells + ncells, contributingIds->GetPointer(0));
+      weights.assign(ncells, 1.0 / ncells);
+      outPD->InterpolatePoint(cfl, inCD, 0, pid, contributingIds,
+                              weights.data());
+      if (categorical)
+      {
+        VoteCellData(cfl, inCD, outPD, pid, ncells,
+                     contributingIds->GetPointer(0));
+      }
+    }
+    else
+    {
+      outPD->NullPoint(pid);
+    }
+  }
+}
 
   // Special traversal algorithm for vtkUniformGrid and vtkRectilinearGrid to support blanking
   // points will not have more than 8 cells for either of these data sets
@@ -185,6 +435,7 @@ vtkCellDataToPointData::vtkCellDataToPointData()
 {
   this->PassCellData = 0;
   this->ContributingCellOption = vtkCellDataToPointData::All;
+  this->CategoricalData = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -260,6 +511,7 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "PassCellData: " << (this->PassCellData ? "On\n" : "Off\n");
   os << indent << "ContributingCellOption: " << this->ContributingCellOption << endl;
+  os << indent << "CategoricalData: " << (this->CategoricalData ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -281,47 +533,6 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
-  // count the number of cells associated with each point. if we are doing patches
-  // though we will do that later on.
-  vtkSmartPointer<vtkUnsignedIntArray> num;
-  int highestCellDimension = 0;
-  if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
-  {
-    num = vtkSmartPointer<vtkUnsignedIntArray>::New();
-    num->SetNumberOfComponents(1);
-    num->SetNumberOfTuples(npoints);
-    std::fill_n(num->GetPointer(0), npoints, 0u);
-    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
-    {
-      int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
-      for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
-      {
-        int dim = src->GetCell(i)->GetCellDimension();
-        if (dim > highestCellDimension)
-        {
-          highestCellDimension = dim;
-          if (highestCellDimension == maxDimension)
-          {
-            break;
-          }
-        }
-      }
-    }
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid)
-    {
-      if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
-      {
-        src->GetCellPoints(cid, pids);
-        for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-        {
-          vtkIdType const pid = pids->GetId(i);
-          num->SetValue(pid, num->GetValue(pid)+1);
-        }
-      }
-    }
-  }
-
   // First, copy the input to the output as a starting point
   dst->CopyStructure(src);
   vtkPointData* const opd = dst->GetPointData();
@@ -346,49 +557,22 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     }
   }
 
-  // Cell field list constructed from the filtered cell data array
-  vtkDataSetAttributes::FieldList cfl(1);
-  cfl.InitializeFieldList(clean);
-  opd->InterpolateAllocate(cfl, npoints, npoints);
-
-  for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
+  // The cells using each point come from static links for unstructured
+  // grids. The cell ids of polydata follow the order in which the cells of
+  // the different types were inserted, which the static links ignore, so
+  // polydata use GetPointCells().
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  bool useLinks = (src->IsA("vtkUnstructuredGrid") != 0);
+  if (useLinks)
   {
-    // update progress and check for an abort request.
-    this->UpdateProgress((fid+1.)/nfields);
-    if (this->GetAbortExecute())
-    {
-      break;
-    }
-
-    // indices into the field arrays associated with the cell and the point
-    // respectively
-    int const dstid = cfl.GetFieldIndex(fid);
-    int const srcid = cfl.GetDSAIndex(0,fid);
-    if  (srcid < 0 || dstid < 0)
-    {
-      continue;
-    }
-
-    vtkCellData * const srccelldata  = clean;
-    vtkPointData* const dstpointdata = dst->GetPointData();
-
-    if (!srccelldata || !dstpointdata)
-    {
-      continue;
-    }
-
-    vtkDataArray* const srcarray = srccelldata ->GetArray(srcid);
-    vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
-    dstarray->SetNumberOfTuples(npoints);
-
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
-    switch (srcarray->GetDataType())
-    {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps, highestCellDimension, this->ContributingCellOption));
-    }
+    links.BuildLinks(src);
   }
 
+  SpreadCellDataToPoints(this, src, clean, opd,
+                         (useLinks ? &links : nullptr),
+                         this->ContributingCellOption,
+                         this->CategoricalData != 0);
+
   if (!this->PassCellData)
   {
     dst->GetCellData()->CopyAllOff();
@@ -399,44 +583,22 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
   return 1;
 }
 
+//----------------------------------------------------------------------------
 void vtkCellDataToPointData::InterpolatePointData(vtkDataSet *input, vtkDataSet *output)
 {
-  vtkNew<vtkIdList> cellIds;
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
-  vtkIdType numPts = input->GetNumberOfPoints();
-
-  vtkCellData *inCD = input->GetCellData();
-  vtkPointData *outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inCD,numPts);
-
-  double weights[VTK_MAX_CELLS_PER_POINT];
-
-  int abort = 0;
-  vtkIdType progressInterval = numPts / 20 + 1;
-  for (vtkIdType ptId = 0; ptId < numPts && !abort; ptId++)
+  // The structured data sets compute the cells using each point, the other
+  // data sets get them from static links.
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  bool useLinks = (!vtkImageData::SafeDownCast(input) &&
+                   !vtkRectilinearGrid::SafeDownCast(input) &&
+                   !vtkStructuredGrid::SafeDownCast(input));
+  if (useLinks)
   {
-    if ( !(ptId % progressInterval) )
-    {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
-    }
-
-    input->GetPointCells(ptId, cellIds);
-    vtkIdType numCells = cellIds->GetNumberOfIds();
-
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
-    {
-      double weight = 1.0 / numCells;
-      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
-      {
-        weights[cellId] = weight;
-      }
-      outPD->InterpolatePoint(inCD, ptId, cellIds, weights);
-    }
-    else
-    {
-      outPD->NullPoint(ptId);
-    }
+    links.BuildLinks(input);
   }
+  SpreadCellDataToPoints(this, input, input->GetCellData(),
+                         output->GetPointData(),
+                         (useLinks ? &links : nullptr),
+                         this->ContributingCellOption,
+                         this->CategoricalData != 0);
 }
@@ -28,6 +28,13 @@
  * cells attached to a point. DataSetMax uses the highest cell dimension in
  * the entire data set.
  *
+ * The data arrays are averaged in one pass over the points, in parallel with
+ * vtkSMPTools. The averages are computed in double precision and rounded to
+ * the nearest value for the integral types. When CategoricalData is on, the
+ * arrays of integral types take instead the most frequent value of the
+ * contributing cells (ties going to the smaller value), as suits labels and
+ * other categorical data.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -80,6 +87,19 @@ public:
   vtkGetMacro(ContributingCellOption, int);
   //@}
 
+  //@{
+  /**
+   * Control whether the integral cell data arrays are treated as categorical.
+   * If so, each point takes the most frequent value of each component among
+   * the contributing cells, with ties going to the smaller value, rather than
+   * the average. The floating-point arrays are always averaged. The default
+   * is off.
+   */
+  vtkSetMacro(CategoricalData,vtkTypeBool);
+  vtkGetMacro(CategoricalData,vtkTypeBool);
+  vtkBooleanMacro(CategoricalData,vtkTypeBool);
+  //@}
+
 protected:
   vtkCellDataToPointData();
   ~vtkCellDataToPointData() override {}
@@ -114,6 +134,11 @@ protected:
   int ContributingCellOption;
   //@}
 
+  /**
+   * Option to vote for the values of the integral arrays. Default is 0/off.
+   */
+  vtkTypeBool CategoricalData;
+
 private:
   vtkCellDataToPointData(const vtkCellDataToPointData&) = delete;
   void operator=(const vtkCellDataToPointData&) = delete;
@@ -0,0 +1,531 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellSubsetHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellSubsetHelper.h"
+
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Find the new id of the kept cells.
+struct SubsetCompactCells
+{
+  const unsigned char *KeepCells;
+  const vtkIdType *NewCellIds;
+  vtkIdType *CellIds;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      if (this->KeepCells[cellId])
+      {
+        this->CellIds[this->NewCellIds[cellId]] = cellId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the points used by the kept cells. Several threads may flag the same
+// point, but they all write the same value.
+struct SubsetMarkPoints
+{
+  const vtkCellSubsetHelper *Helper;
+  const vtkIdType *CellIds;
+  unsigned char *UsedPoints;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  void operator()(vtkIdType newCellId, vtkIdType endNewCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; newCellId < endNewCellId; ++newCellId)
+    {
+      this->Helper->GetCellPoints(this->CellIds[newCellId], npts, pts, ptIds);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        this->UsedPoints[pts[i]] = 1;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build the map from output to input point ids.
+struct SubsetCompactPoints
+{
+  const unsigned char *KeepPoints;
+  const vtkIdType *PointMap;
+  vtkIdType *PointIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      if (this->KeepPoints[ptId])
+      {
+        this->PointIds[this->PointMap[ptId]] = ptId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Size of a face stream [nFaces, nFace0Pts, i, j, k, nFace1Pts, ...].
+vtkIdType SubsetFaceStreamSize(const vtkIdType *faces)
+{
+  vtkIdType size = 1;
+  vtkIdType numFaces = faces[0];
+  for (vtkIdType face = 0; face < numFaces; ++face)
+  {
+    size += faces[size] + 1;
+  }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+// First pass over the kept cells: the size of each output cell in the
+// connectivity list, and the size of its face stream for polyhedra.
+struct SubsetCountCells
+{
+  const vtkCellSubsetHelper *Helper;
+  vtkUnstructuredGrid *Grid; // with faces, or nullptr
+  const vtkIdType *CellIds;
+  vtkIdType *CellSizes;
+  vtkIdType *FaceSizes;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  void operator()(vtkIdType newCellId, vtkIdType endNewCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; newCellId < endNewCellId; ++newCellId)
+    {
+      vtkIdType cellId = this->CellIds[newCellId];
+      int type = this->Helper->GetCellPoints(cellId, npts, pts, ptIds);
+      this->CellSizes[newCellId] = npts + 1;
+      if (this->Grid)
+      {
+        const vtkIdType *faces = (type == VTK_POLYHEDRON ?
+          this->Grid->GetFaces(cellId) : nullptr);
+        this->FaceSizes[newCellId] = faces ? SubsetFaceStreamSize(faces) : 0;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Second pass over the kept cells: fill the output types, locations and
+// connectivity, renumbering the points.
+struct SubsetFillCells
+{
+  const vtkCellSubsetHelper *Helper;
+  vtkUnstructuredGrid *Grid; // with faces, or nullptr
+  const vtkIdType *CellIds;
+  const vtkIdType *PointMap;
+  const vtkIdType *CellLocations;
+  const vtkIdType *FaceOffsets;
+  vtkIdType *Connectivity;
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *FaceLocations;
+  vtkIdType *Faces;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  void operator()(vtkIdType newCellId, vtkIdType endNewCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; newCellId < endNewCellId; ++newCellId)
+    {
+      vtkIdType cellId = this->CellIds[newCellId];
+      int type = this->Helper->GetCellPoints(cellId, npts, pts, ptIds);
+      vtkIdType loc = this->CellLocations[newCellId];
+      this->Types[newCellId] = static_cast<unsigned char>(type);
+      this->Locations[newCellId] = loc;
+      vtkIdType *newPts = this->Connectivity + loc;
+      *newPts++ = npts;
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        newPts[i] = this->PointMap[pts[i]];
+      }
+
+      if (this->Grid)
+      {
+        vtkIdType faceLoc = this->FaceOffsets[newCellId];
+        vtkIdType size = this->FaceOffsets[newCellId + 1] - faceLoc;
+        if (size == 0)
+        {
+          this->FaceLocations[newCellId] = -1;
+          continue;
+        }
+        this->FaceLocations[newCellId] = faceLoc;
+        const vtkIdType *faces = this->Grid->GetFaces(cellId);
+        vtkIdType *newFaces = this->Faces + faceLoc;
+        std::copy(faces, faces + size, newFaces);
+        vtkUnstructuredGrid::ConvertFaceStreamPointIds(
+          newFaces[0], newFaces + 1, const_cast<vtkIdType*>(this->PointMap));
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct SubsetCopyPoints
+{
+  vtkDataSet *Input;
+  const vtkIdType *PointIds;
+  vtkPoints *NewPoints;
+
+  void operator()(vtkIdType newPtId, vtkIdType endNewPtId) const
+  {
+    double x[3];
+    for ( ; newPtId < endNewPtId; ++newPtId)
+    {
+      this->Input->GetPoint(this->PointIds[newPtId], x);
+      this->NewPoints->SetPoint(newPtId, x);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct SubsetCopyAttributes
+{
+  ArrayList &Arrays;
+  const vtkIdType *SourceIds;
+
+  void operator()(vtkIdType outId, vtkIdType endOutId) const
+  {
+    for ( ; outId < endOutId; ++outId)
+    {
+      this->Arrays.Copy(this->SourceIds[outId], outId);
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+class vtkCellSubsetHelper::vtkInternals
+{
+public:
+  vtkUnstructuredGrid *Grid;
+  vtkPolyData *PolyData;
+  const unsigned char *Types; // cell types of Grid
+  vtkCellSubsetHelper::CellSource Sources[4]; // one for Grid, four for PolyData
+};
+
+//----------------------------------------------------------------------------
+bool vtkCellSubsetHelper::IsSupported(vtkDataSet *input)
+{
+  return vtkUnstructuredGrid::SafeDownCast(input) ||
+    vtkPolyData::SafeDownCast(input) || vtkImageData::SafeDownCast(input);
+}
+
+//----------------------------------------------------------------------------
+vtkCellSubsetHelper::vtkCellSubsetHelper(vtkDataSet *input)
+{
+  this->Input = input;
+  this->NumberOfCells = input->GetNumberOfCells();
+  this->Internals = new vtkInternals;
+  vtkInternals *internals = this->Internals;
+  internals->Grid = vtkUnstructuredGrid::SafeDownCast(input);
+  internals->PolyData = vtkPolyData::SafeDownCast(input);
+  internals->Types = nullptr;
+
+  if (internals->Grid)
+  {
+    if (this->NumberOfCells > 0)
+    {
+      vtkCellArray *cells = internals->Grid->GetCells();
+      internals->Types = internals->Grid->GetCellTypesArray()->GetPointer(0);
+      internals->Sources[0].Initialize(cells, 0,
+        cells->GetStorageType() == vtkCellArray::LEGACY_STORAGE ?
+        internals->Grid->GetCellLocationsArray()->GetPointer(0) : nullptr);
+    }
+  }
+  else if (internals->PolyData)
+  {
+    // The cells of a polydata are numbered verts first, then lines, polys
+    // and strips.
+    if (internals->PolyData->NeedToBuildCells())
+    {
+      internals->PolyData->BuildCells();
+    }
+    vtkCellArray *cells[4] = { internals->PolyData->GetVerts(),
+      internals->PolyData->GetLines(), internals->PolyData->GetPolys(),
+      internals->PolyData->GetStrips() };
+    vtkIdType begin = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      internals->Sources[i].Initialize(cells[i], begin);
+      begin += internals->Sources[i].NumberOfCells;
+    }
+  }
+  else if (this->NumberOfCells > 0)
+  {
+    // vtkImageData: GetCellPoints() and GetPoint() are thread safe once
+    // called from a single thread.
+    input->GetCell(0);
+  }
+
+  if (input->GetNumberOfPoints() > 0)
+  {
+    double x[3];
+    input->GetPoint(0, x);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkCellSubsetHelper::~vtkCellSubsetHelper()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellSubsetHelper::GetCellPoints(vtkIdType cellId, vtkIdType &npts,
+                                       const vtkIdType *&pts,
+                                       vtkIdList *ptIds) const
+{
+  const vtkInternals *internals = this->Internals;
+  if (internals->Grid)
+  {
+    internals->Sources[0].GetCell(cellId, npts, pts, ptIds);
+    return internals->Types[cellId];
+  }
+  else if (internals->PolyData)
+  {
+    int i = 3;
+    while (i > 0 && cellId < internals->Sources[i].Begin)
+    {
+      --i;
+    }
+    const CellSource &source = internals->Sources[i];
+    source.GetCell(cellId - source.Begin, npts, pts, ptIds);
+    return internals->PolyData->GetCellType(cellId);
+  }
+
+  this->Input->GetCellPoints(cellId, ptIds);
+  npts = ptIds->GetNumberOfIds();
+  pts = ptIds->GetPointer(0);
+  return this->Input->GetCellType(cellId);
+}
+
+//----------------------------------------------------------------------------
+// The copy runs in parallel with an ArrayList when every copied array is a
+// data array found by name in the input, and falls back to the serial bulk
+// copy of vtkDataSetAttributes otherwise (e.g. for string arrays).
+void vtkCellSubsetHelper::CopyData(vtkDataSetAttributes *inAttr,
+                                   vtkDataSetAttributes *outAttr,
+                                   vtkIdType numIds,
+                                   const vtkIdType *sourceIds)
+{
+  outAttr->CopyAllocate(inAttr, numIds);
+  bool threaded = true;
+  for (int i = 0; threaded && i < outAttr->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *outArray = outAttr->GetAbstractArray(i);
+    const char *name = outArray->GetName();
+    vtkAbstractArray *inArray = name ? inAttr->GetAbstractArray(name) : nullptr;
+    threaded = inArray &&
+      vtkArrayDownCast<vtkDataArray>(inArray) &&
+      vtkArrayDownCast<vtkDataArray>(outArray) &&
+      inArray->GetDataType() == outArray->GetDataType() &&
+      inArray->GetNumberOfComponents() == outArray->GetNumberOfComponents() &&
+      inArray->HasStandardMemoryLayout() &&
+      outArray->HasStandardMemoryLayout();
+  }
+
+  if (threaded)
+  {
+    ArrayList arrays;
+    arrays.AddArrays(numIds, inAttr, outAttr, 0.0, false);
+    SubsetCopyAttributes copy = { arrays, sourceIds };
+    vtkSMPTools::For(0, numIds, copy);
+    return;
+  }
+
+  vtkNew<vtkIdList> fromIds;
+  vtkNew<vtkIdList> toIds;
+  fromIds->SetNumberOfIds(numIds);
+  toIds->SetNumberOfIds(numIds);
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    fromIds->SetId(i, sourceIds[i]);
+    toIds->SetId(i, i);
+  }
+  outAttr->CopyData(inAttr, fromIds, toIds);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellSubsetHelper::CopyPoints(vtkDataSet *input, vtkIdType numIds,
+                                     const vtkIdType *pointIds,
+                                     vtkPoints *newPoints)
+{
+  newPoints->SetNumberOfPoints(numIds);
+  if (numIds > 0)
+  {
+    // GetPoint() is thread safe once called from a single thread.
+    double x[3];
+    input->GetPoint(pointIds[0], x);
+  }
+  SubsetCopyPoints copyPoints = { input, pointIds, newPoints };
+  vtkSMPTools::For(0, numIds, copyPoints);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellSubsetHelper::Extract(const unsigned char *keepCells,
+                                  const unsigned char *keepPoints,
+                                  int pointsDataType,
+                                  vtkUnstructuredGrid *output,
+                                  vtkIdTypeArray *originalCellIds) const
+{
+  const vtkIdType numCells = this->NumberOfCells;
+  const vtkIdType numPts = this->Input->GetNumberOfPoints();
+
+  // Number the kept cells with a prefix sum over their flags.
+  std::vector<vtkIdType> newCellIds(numCells);
+  vtkSMPTools::ExclusiveScan(keepCells, keepCells + numCells,
+                             newCellIds.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewCells = (numCells > 0 ?
+    newCellIds[numCells - 1] + keepCells[numCells - 1] : 0);
+
+  vtkNew<vtkIdTypeArray> cellIdsBuffer;
+  vtkIdTypeArray *cellIdsArray = (originalCellIds ? originalCellIds :
+                                  cellIdsBuffer.GetPointer());
+  cellIdsArray->SetNumberOfComponents(1);
+  cellIdsArray->SetNumberOfTuples(numNewCells);
+  vtkIdType *cellIds = cellIdsArray->GetPointer(0);
+  SubsetCompactCells compactCells = { keepCells, newCellIds.data(), cellIds };
+  vtkSMPTools::For(0, numCells, compactCells);
+  std::vector<vtkIdType>().swap(newCellIds);
+
+  // Number the kept points the same way.
+  std::vector<unsigned char> usedPoints;
+  if (!keepPoints)
+  {
+    usedPoints.resize(numPts);
+    vtkSMPTools::Fill(usedPoints.begin(), usedPoints.end(), 0);
+    SubsetMarkPoints markPoints;
+    markPoints.Helper = this;
+    markPoints.CellIds = cellIds;
+    markPoints.UsedPoints = usedPoints.data();
+    vtkSMPTools::For(0, numNewCells, markPoints);
+    keepPoints = usedPoints.data();
+  }
+  std::vector<vtkIdType> pointMap(numPts);
+  vtkSMPTools::ExclusiveScan(keepPoints, keepPoints + numPts,
+                             pointMap.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewPts = (numPts > 0 ?
+    pointMap[numPts - 1] + keepPoints[numPts - 1] : 0);
+  std::vector<vtkIdType> pointIds(numNewPts);
+  SubsetCompactPoints compactPoints = { keepPoints, pointMap.data(),
+                                        pointIds.data() };
+  vtkSMPTools::For(0, numPts, compactPoints);
+
+  // Count the size of each output cell, then turn the sizes into locations.
+  vtkUnstructuredGrid *grid = this->Internals->Grid;
+  if (grid && !grid->GetFaces())
+  {
+    grid = nullptr;
+  }
+  std::vector<vtkIdType> cellLocations(numNewCells + 1, 0);
+  std::vector<vtkIdType> faceOffsets(grid ? numNewCells + 1 : 0, 0);
+  SubsetCountCells countCells;
+  countCells.Helper = this;
+  countCells.Grid = grid;
+  countCells.CellIds = cellIds;
+  countCells.CellSizes = cellLocations.data();
+  countCells.FaceSizes = faceOffsets.data();
+  vtkSMPTools::For(0, numNewCells, countCells);
+  vtkSMPTools::ExclusiveScan(cellLocations.begin(), cellLocations.end(),
+                             cellLocations.begin(), static_cast<vtkIdType>(0));
+  vtkIdType numFaceValues = 0;
+  if (grid)
+  {
+    vtkSMPTools::ExclusiveScan(faceOffsets.begin(), faceOffsets.end(),
+                               faceOffsets.begin(), static_cast<vtkIdType>(0));
+    numFaceValues = faceOffsets[numNewCells];
+  }
+
+  // Fill the cells.
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(cellLocations[numNewCells]);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numNewCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numNewCells);
+  vtkSmartPointer<vtkIdTypeArray> faceLocations;
+  vtkSmartPointer<vtkIdTypeArray> faces;
+  if (numFaceValues > 0)
+  {
+    faceLocations = vtkSmartPointer<vtkIdTypeArray>::New();
+    faceLocations->SetNumberOfValues(numNewCells);
+    faces = vtkSmartPointer<vtkIdTypeArray>::New();
+    faces->SetNumberOfValues(numFaceValues);
+  }
+  else
+  {
+    grid = nullptr;
+  }
+  SubsetFillCells fillCells;
+  fillCells.Helper = this;
+  fillCells.Grid = grid;
+  fillCells.CellIds = cellIds;
+  fillCells.PointMap = pointMap.data();
+  fillCells.CellLocations = cellLocations.data();
+  fillCells.FaceOffsets = faceOffsets.data();
+  fillCells.Connectivity = connectivity->GetPointer(0);
+  fillCells.Types = types->GetPointer(0);
+  fillCells.Locations = locations->GetPointer(0);
+  fillCells.FaceLocations = grid ? faceLocations->GetPointer(0) : nullptr;
+  fillCells.Faces = grid ? faces->GetPointer(0) : nullptr;
+  vtkSMPTools::For(0, numNewCells, fillCells);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(numNewCells, connectivity);
+  output->SetCells(types, locations, cells, faceLocations, faces);
+
+  // Copy the points and the attributes.
+  vtkNew<vtkPoints> newPoints;
+  newPoints->SetDataType(pointsDataType);
+  vtkCellSubsetHelper::CopyPoints(this->Input, numNewPts, pointIds.data(),
+                                  newPoints);
+  output->SetPoints(newPoints);
+
+  vtkCellSubsetHelper::CopyData(this->Input->GetPointData(),
+                                output->GetPointData(), numNewPts,
+                                pointIds.data());
+  vtkCellSubsetHelper::CopyData(this->Input->GetCellData(),
+                                output->GetCellData(), numNewCells, cellIds);
+}
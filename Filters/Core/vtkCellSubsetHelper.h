@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellSubsetHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCellSubsetHelper
+ * @brief   A utility class used to extract a subset of cells in parallel
+ *
+ * This is a simple utility class used by the filters extracting a subset of
+ * the cells of a dataset into a vtkUnstructuredGrid. The cells to keep are
+ * flagged first, MarkCells() evaluating a predicate over all the cells in
+ * parallel. Extract() then builds the output in two passes: the sizes of
+ * the kept cells are counted and turned into output locations with a prefix
+ * sum, and the connectivity, cell types, points and attributes are filled
+ * in parallel with vtkSMPTools. The used points keep the order of the input
+ * and the output does not depend on the number of threads. The static
+ * CopyPoints() and CopyData() methods can be used on their own by filters
+ * producing other types of output, and the CellSource class gives thread
+ * safe random access to the cells of a vtkCellArray.
+ *
+ * Only the inputs accepted by IsSupported() are read from several threads:
+ * the filters fall back to their serial path for the other datasets, whose
+ * cell accessors may build data lazily (e.g. vtkHyperTreeGrid). The input
+ * must not be modified while the helper is in use.
+ *
+ * @sa
+ * vtkThreshold vtkExtractCells vtkExtractGeometry vtkDataSetSurfaceFilter
+ * vtkCleanPolyData
+*/
+
+#ifndef vtkCellSubsetHelper_h
+#define vtkCellSubsetHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkCellArray.h" // For CellSource
+#include "vtkIdList.h" // For MarkCells()
+#include "vtkSMPThreadLocalObject.h" // For MarkCells()
+#include "vtkSMPTools.h" // For MarkCells()
+
+#include <vector> // For CellSource
+
+class vtkDataSet;
+class vtkDataSetAttributes;
+class vtkIdTypeArray;
+class vtkPoints;
+class vtkUnstructuredGrid;
+
+class VTKFILTERSCORE_EXPORT vtkCellSubsetHelper
+{
+public:
+  /**
+   * Thread safe random access to the cells of a cell array, whose first
+   * cell is the cell Begin of a dataset. With the legacy storage,
+   * GetCellAtId() has to walk the cells, so the location of each cell is
+   * computed once by Initialize() unless it is given.
+   */
+  struct CellSource
+  {
+    vtkCellArray *Cells;
+    vtkIdType Begin;
+    vtkIdType NumberOfCells;
+    const vtkIdType *Legacy; // the cells, with the legacy storage
+    const vtkIdType *Locations; // used with the legacy storage only
+    std::vector<vtkIdType> LocationsBuffer;
+
+    CellSource() : Cells(nullptr), Begin(0), NumberOfCells(0),
+      Legacy(nullptr), Locations(nullptr)
+    {
+    }
+
+    void Initialize(vtkCellArray *cells, vtkIdType begin,
+                    const vtkIdType *locations = nullptr)
+    {
+      this->Cells = cells;
+      this->Begin = begin;
+      this->NumberOfCells = cells ? cells->GetNumberOfCells() : 0;
+      this->Legacy = nullptr;
+      this->Locations = locations;
+      if (cells && cells->GetStorageType() == vtkCellArray::LEGACY_STORAGE)
+      {
+        this->Legacy = cells->GetPointer();
+        if (!this->Locations)
+        {
+          this->LocationsBuffer.resize(this->NumberOfCells);
+          vtkIdType loc = 0;
+          for (vtkIdType cellId = 0; cellId < this->NumberOfCells; ++cellId)
+          {
+            this->LocationsBuffer[cellId] = loc;
+            loc += this->Legacy[loc] + 1;
+          }
+          this->Locations = this->LocationsBuffer.data();
+        }
+      }
+    }
+
+    // The points of the cell cellId of the cell array. pts points either
+    // into the cell array or into ptIds, which each thread must provide.
+    void GetCell(vtkIdType cellId, vtkIdType &npts, const vtkIdType *&pts,
+                 vtkIdList *ptIds) const
+    {
+      if (this->Legacy)
+      {
+        pts = this->Legacy + this->Locations[cellId];
+        npts = *pts++;
+      }
+      else
+      {
+        this->Cells->GetCellAtId(cellId, npts, pts, ptIds);
+      }
+    }
+  };
+
+  /**
+   * Return true if the cells and points of input can be read from several
+   * threads at once, i.e. if input is a vtkUnstructuredGrid, a vtkPolyData
+   * or a vtkImageData. The helper must only be used with such inputs.
+   */
+  static bool IsSupported(vtkDataSet *input);
+
+  vtkCellSubsetHelper(vtkDataSet *input);
+  ~vtkCellSubsetHelper();
+
+  /**
+   * Return the type and the point ids of the cell cellId. pts points either
+   * into the input or into ptIds. This is thread safe as long as each
+   * thread provides its own ptIds.
+   */
+  int GetCellPoints(vtkIdType cellId, vtkIdType &npts, const vtkIdType *&pts,
+                    vtkIdList *ptIds) const;
+
+  /**
+   * Set keepCells[cellId] to 1 if predicate(cellId, npts, pts) is true and
+   * to 0 otherwise, for all the cells of the input. The cells are processed
+   * in parallel, so the predicate must be thread safe.
+   */
+  template <typename Predicate>
+  void MarkCells(const Predicate &predicate, unsigned char *keepCells) const;
+
+  /**
+   * Build output from the cells flagged in keepCells. If keepPoints is
+   * nullptr the output points are the points used by the kept cells,
+   * otherwise they are the points flagged in keepPoints, which must include
+   * all the points used by the kept cells. The points are stored with the
+   * given data type and the point and cell data are copied with the copy
+   * flags of the output attributes. If originalCellIds is given, it is
+   * filled with the input id of each output cell.
+   */
+  void Extract(const unsigned char *keepCells, const unsigned char *keepPoints,
+               int pointsDataType, vtkUnstructuredGrid *output,
+               vtkIdTypeArray *originalCellIds = nullptr) const;
+
+  /**
+   * Copy the points pointIds[i] of input to the points i of newPoints, in
+   * parallel. newPoints is resized to numIds points.
+   */
+  static void CopyPoints(vtkDataSet *input, vtkIdType numIds,
+                         const vtkIdType *pointIds, vtkPoints *newPoints);
+
+  /**
+   * Allocate outAttr from inAttr (using the copy flags of outAttr) and copy
+   * the tuples sourceIds[i] of inAttr to the tuples i of outAttr, in parallel
+   * when the arrays allow it.
+   */
+  static void CopyData(vtkDataSetAttributes *inAttr,
+                       vtkDataSetAttributes *outAttr, vtkIdType numIds,
+                       const vtkIdType *sourceIds);
+
+ private:
+  vtkCellSubsetHelper(const vtkCellSubsetHelper&) = delete;
+  vtkCellSubsetHelper& operator=(const vtkCellSubsetHelper&) = delete;
+
+  template <typename Predicate>
+  struct MarkCellsFunctor;
+
+  class vtkInternals;
+  vtkInternals *Internals;
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+};
+
+//----------------------------------------------------------------------------
+template <typename Predicate>
+struct vtkCellSubsetHelper::MarkCellsFunctor
+{
+  const vtkCellSubsetHelper *Helper;
+  const Predicate &Pred;
+  unsigned char *KeepCells;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  MarkCellsFunctor(const vtkCellSubsetHelper *helper, const Predicate &pred,
+                   unsigned char *keepCells)
+    : Helper(helper), Pred(pred), KeepCells(keepCells)
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Helper->GetCellPoints(cellId, npts, pts, ptIds);
+      this->KeepCells[cellId] = this->Pred(cellId, npts, pts) ? 1 : 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template <typename Predicate>
+void vtkCellSubsetHelper::MarkCells(const Predicate &predicate,
+                                    unsigned char *keepCells) const
+{
+  MarkCellsFunctor<Predicate> mark(this, predicate, keepCells);
+  vtkSMPTools::For(0, this->NumberOfCells, mark);
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkCellSubsetHelper.h
@@ -16,17 +16,373 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCellSubsetHelper.h"
 #include "vtkMergePoints.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
+//---------------------------------------------------------------------------
+// Helper classes for the parallel mode (ParallelMerging on). The points are
+// ranked in the order the cells use them for the first time, which is the
+// order in which the serial mode inserts them in the locator, so that both
+// modes number the output points the same way.
+namespace
+{
+
+// The kinds of cells of vtkPolyData, in the order they are traversed and
+// output.
+enum CleanCellTypes
+{
+  CLEAN_VERTS = 0,
+  CLEAN_LINES = 1,
+  CLEAN_POLYS = 2,
+  CLEAN_STRIPS = 3,
+  CLEAN_NUMBER_OF_TYPES = 4
+};
+
+//---------------------------------------------------------------------------
+// Replace the points of a cell of the given type by their output ids, and
+// remove the repeated points like the serial mode does. Returns the number
+// of points left in newPts.
+vtkIdType CleanMapCell(int type, vtkIdType npts, const vtkIdType *pts,
+                       const vtkIdType *pointMap, vtkIdType *newPts)
+{
+  vtkIdType numNewPts = 0;
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    vtkIdType ptId = pointMap[pts[i]];
+    if (type == CLEAN_VERTS || i == 0 || ptId != newPts[numNewPts-1])
+    {
+      newPts[numNewPts++] = ptId;
+    }
+  }
+  if (type == CLEAN_POLYS && numNewPts > 2 &&
+      newPts[0] == newPts[numNewPts-1])
+  {
+    numNewPts--;
+  }
+  return numNewPts;
+}
+
+//---------------------------------------------------------------------------
+// Type of the output cell made of numNewPts points from a cell of the given
+// type, or -1 if the cell is removed.
+struct CleanConversions
+{
+  bool LinesToPoints;
+  bool PolysToLines;
+  bool StripsToPolys;
+
+  signed char GetOutputType(int type, vtkIdType numNewPts) const
+  {
+    if (type == CLEAN_STRIPS)
+    {
+      if (numNewPts > 3 || !this->StripsToPolys)
+      {
+        return CLEAN_STRIPS;
+      }
+      type = CLEAN_POLYS;
+    }
+    if (type == CLEAN_POLYS)
+    {
+      if (numNewPts > 2 || !this->PolysToLines)
+      {
+        return CLEAN_POLYS;
+      }
+      type = CLEAN_LINES;
+    }
+    if (type == CLEAN_LINES)
+    {
+      if (numNewPts > 1 || !this->LinesToPoints)
+      {
+        return CLEAN_LINES;
+      }
+    }
+    return numNewPts > 0 ? CLEAN_VERTS : -1;
+  }
+};
+
+//---------------------------------------------------------------------------
+// Apply OperateOnPoint() to every input point.
+struct CleanTransformPoints
+{
+  vtkCleanPolyData *Filter;
+  vtkPoints *InPoints;
+  vtkPoints *Points;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3], newx[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->InPoints->GetPoint(ptId, x);
+      this->Filter->OperateOnPoint(x, newx);
+      this->Points->SetPoint(ptId, newx);
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Exact merging: each used point is merged into the first used point with
+// the same coordinates. Target receives the rank of that point.
+struct CleanMergeExact
+{
+  vtkStaticPointLocator *Locator;
+  vtkPoints *Points;
+  const vtkIdType *Order;
+  const vtkIdType *Rank;
+  vtkIdType *Target;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    vtkIdList *ids = this->Ids.Local();
+    double x[3], y[3];
+    for ( ; rank < endRank; ++rank)
+    {
+      this->Points->GetPoint(this->Order[rank], x);
+      this->Locator->FindPointsWithinRadius(0.0, x, ids);
+      vtkIdType target = rank;
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+      {
+        vtkIdType ptId = ids->GetId(i);
+        vtkIdType other = this->Rank[ptId];
+        if (other >= 0 && other < target)
+        {
+          this->Points->GetPoint(ptId, y);
+          if (x[0] == y[0] && x[1] == y[1] && x[2] == y[2])
+          {
+            target = other;
+          }
+        }
+      }
+      this->Target[rank] = target;
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Merging with a tolerance: find the ranks of the points used before each
+// point and lying within the tolerance. The first pass (Neighbors is null)
+// counts them, the second one stores them. Both passes sort them and remove
+// the duplicates, so that they agree on the number of neighbors. Like the
+// serial mode, the distance is measured between the transformed point and
+// the points converted to the output precision.
+struct CleanFindNeighbors
+{
+  vtkCleanPolyData *Filter;
+  vtkPoints *InPoints;
+  vtkStaticPointLocator *Locator;
+  double Tolerance;
+  const vtkIdType *Order;
+  const vtkIdType *Rank;
+  vtkIdType *Offsets;
+  vtkIdType *Neighbors;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Found;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    vtkIdList *ids = this->Ids.Local();
+    std::vector<vtkIdType> &found = this->Found.Local();
+    double x[3], newx[3];
+    for ( ; rank < endRank; ++rank)
+    {
+      this->InPoints->GetPoint(this->Order[rank], x);
+      this->Filter->OperateOnPoint(x, newx);
+      this->Locator->FindPointsWithinRadius(this->Tolerance, newx, ids);
+      found.clear();
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+      {
+        vtkIdType other = this->Rank[ids->GetId(i)];
+        if (other >= 0 && other < rank)
+        {
+          found.push_back(other);
+        }
+      }
+      std::sort(found.begin(), found.end());
+      found.erase(std::unique(found.begin(), found.end()), found.end());
+      if (this->Neighbors)
+      {
+        std::copy(found.begin(), found.end(),
+                  this->Neighbors + this->Offsets[rank]);
+      }
+      else
+      {
+        this->Offsets[rank] = static_cast<vtkIdType>(found.size());
+      }
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Flag the kept points, i.e. the points that are not merged into another
+// one, before numbering them with a prefix sum.
+struct CleanMarkKeptPoints
+{
+  const vtkIdType *Target;
+  vtkIdType *Kept;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    for ( ; rank < endRank; ++rank)
+    {
+      this->Kept[rank] = (this->Target[rank] == rank ? 1 : 0);
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Number the kept points, build the map from input to output point ids,
+// and copy the kept points to the output.
+struct CleanMapPoints
+{
+  vtkPoints *Points;
+  const vtkIdType *Order;
+  const vtkIdType *Target;
+  const vtkIdType *NewIds;
+  vtkIdType *PointMap;
+  vtkPoints *NewPoints;
+  vtkIdType *SourceIds;
+
+  void operator()(vtkIdType rank, vtkIdType endRank)
+  {
+    double x[3];
+    for ( ; rank < endRank; ++rank)
+    {
+      vtkIdType ptId = this->Order[rank];
+      vtkIdType newId = this->NewIds[this->Target[rank]];
+      this->PointMap[ptId] = newId;
+      if (this->Target[rank] == rank)
+      {
+        this->Points->GetPoint(ptId, x);
+        this->NewPoints->SetPoint(newId, x);
+        this->SourceIds[newId] = ptId;
+      }
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Compute the type and the number of points of the output cell of each
+// cell of an input cell array.
+struct CleanClassifyCells
+{
+  const vtkCellSubsetHelper::CellSource *Source;
+  int Type;
+  CleanConversions Conversions;
+  const vtkIdType *PointMap;
+  vtkIdType MaxCellSize;
+  signed char *OutputTypes;
+  vtkIdType *OutputSizes;
+  vtkSMPThreadLocalObject<vtkIdList> Scratch;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > NewPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *scratch = this->Scratch.Local();
+    std::vector<vtkIdType> &newPts = this->NewPts.Local();
+    newPts.resize(this->MaxCellSize + 1);
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      this->Source->GetCell(cellId, npts, pts, scratch);
+      vtkIdType numNewPts =
+        CleanMapCell(this->Type, npts, pts, this->PointMap, &newPts[0]);
+      vtkIdType inCellId = this->Source->Begin + cellId;
+      this->OutputTypes[inCellId] =
+        this->Conversions.GetOutputType(this->Type, numNewPts);
+      this->OutputSizes[inCellId] = numNewPts;
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Per cell location in the legacy output cell array and cell index of the
+// cells of the input that become cells of type OutputType, before the
+// prefix sums.
+struct CleanCountCells
+{
+  int OutputType;
+  const signed char *OutputTypes;
+  const vtkIdType *OutputSizes;
+  vtkIdType *Locations;
+  vtkIdType *Indices;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      bool keep = (this->OutputTypes[cellId] == this->OutputType);
+      this->Locations[cellId] = keep ? this->OutputSizes[cellId] + 1 : 0;
+      this->Indices[cellId] = keep ? 1 : 0;
+    }
+  }
+};
+
+//---------------------------------------------------------------------------
+// Write the output cells of type OutputType made from the cells of an input
+// cell array, and record the input cell of each of them.
+struct CleanFillCells
+{
+  const vtkCellSubsetHelper::CellSource *Source;
+  int Type;
+  int OutputType;
+  const vtkIdType *PointMap;
+  vtkIdType MaxCellSize;
+  const signed char *OutputTypes;
+  const vtkIdType *Locations;
+  const vtkIdType *Indices;
+  vtkIdType *NewCells;
+  vtkIdType *CellSourceIds; // offset to the first cell of OutputType
+  vtkSMPThreadLocalObject<vtkIdList> Scratch;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > NewPts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *scratch = this->Scratch.Local();
+    std::vector<vtkIdType> &newPts = this->NewPts.Local();
+    newPts.resize(this->MaxCellSize + 1);
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      vtkIdType inCellId = this->Source->Begin + cellId;
+      if (this->OutputTypes[inCellId] != this->OutputType)
+      {
+        continue;
+      }
+      this->Source->GetCell(cellId, npts, pts, scratch);
+      vtkIdType numNewPts =
+        CleanMapCell(this->Type, npts, pts, this->PointMap, &newPts[0]);
+      vtkIdType *cell = this->NewCells + this->Locations[inCellId];
+      *cell++ = numNewPts;
+      std::copy(newPts.begin(), newPts.begin() + numNewPts, cell);
+      this->CellSourceIds[this->Indices[inCellId]] = inCellId;
+    }
+  }
+};
+
+} // end anon namespace
+
 //---------------------------------------------------------------------------
 // Specify a spatial locator for speeding the search process. By
 // default an instance of vtkPointLocator is used.
@@ -46,6 +402,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = nullptr;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelMerging = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -138,6 +495,13 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
   }
+
+  if ( this->ParallelMerging )
+  {
+    this->ParallelClean(input, output);
+    return 1;
+  }
+
   vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -594,6 +958,266 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// Parallel version of RequestData(). The points are ranked in order of first
+// use, merged (with a vtkStaticPointLocator), and the cells are then mapped
+// to the output in two passes: one computing the type and size of each
+// output cell, and one writing them once their locations are known.
+void vtkCleanPolyData::ParallelClean(vtkPolyData *input, vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  // The transformed points, with the precision of the output.
+  vtkPoints *points = inPts->NewInstance();
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    points->SetDataType(inPts->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    points->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    points->SetDataType(VTK_DOUBLE);
+  }
+  points->SetNumberOfPoints(numPts);
+  CleanTransformPoints transformer = { this, inPts, points };
+  vtkSMPTools::For(0, numPts, transformer);
+
+  // Rank the points in the order the cells use them for the first time.
+  vtkCellArray *inCells[CLEAN_NUMBER_OF_TYPES] = { input->GetVerts(),
+    input->GetLines(), input->GetPolys(), input->GetStrips() };
+  vtkCellSubsetHelper::CellSource sources[CLEAN_NUMBER_OF_TYPES];
+  vtkIdType numCells = 0;
+  for (int type = 0; type < CLEAN_NUMBER_OF_TYPES; ++type)
+  {
+    sources[type].Initialize(inCells[type], numCells);
+    numCells += sources[type].NumberOfCells;
+  }
+
+  std::vector<vtkIdType> rank(numPts, -1);
+  std::vector<vtkIdType> order(numPts);
+  vtkIdType numUsedPts = 0;
+  vtkNew<vtkIdList> scratch;
+  vtkIdType npts;
+  const vtkIdType *pts;
+  for (int type = 0; type < CLEAN_NUMBER_OF_TYPES; ++type)
+  {
+    for (vtkIdType cellId = 0; cellId < sources[type].NumberOfCells; ++cellId)
+    {
+      sources[type].GetCell(cellId, npts, pts, scratch);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        if (rank[pts[i]] < 0)
+        {
+          rank[pts[i]] = numUsedPts;
+          order[numUsedPts++] = pts[i];
+        }
+      }
+    }
+  }
+  this->UpdateProgress(0.25);
+
+  // Rank of the point each used point is merged into, itself if the point
+  // is kept.
+  std::vector<vtkIdType> target(numUsedPts);
+  if ( !this->PointMerging )
+  {
+    std::iota(target.begin(), target.end(), 0);
+  }
+  else
+  {
+    double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+      this->Tolerance*input->GetLength();
+
+    vtkNew<vtkPolyData> pointSet;
+    pointSet->SetPoints(points);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(pointSet);
+    locator->BuildLocator();
+
+    if (tol == 0.0)
+    {
+      CleanMergeExact merger;
+      merger.Locator = locator;
+      merger.Points = points;
+      merger.Order = order.data();
+      merger.Rank = rank.data();
+      merger.Target = target.data();
+      vtkSMPTools::For(0, numUsedPts, merger);
+    }
+    else
+    {
+      std::vector<vtkIdType> offsets(numUsedPts + 1);
+      CleanFindNeighbors finder;
+      finder.Filter = this;
+      finder.InPoints = inPts;
+      finder.Locator = locator;
+      finder.Tolerance = tol;
+      finder.Order = order.data();
+      finder.Rank = rank.data();
+      finder.Offsets = offsets.data();
+      finder.Neighbors = nullptr;
+      vtkSMPTools::For(0, numUsedPts, finder);
+      offsets[numUsedPts] = 0;
+      vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(),
+                                 offsets.begin(), static_cast<vtkIdType>(0));
+      std::vector<vtkIdType> neighbors(offsets[numUsedPts] + 1);
+      finder.Neighbors = neighbors.data();
+      vtkSMPTools::For(0, numUsedPts, finder);
+
+      // A point is kept if no kept point used before it lies within the
+      // tolerance, otherwise it is merged into the first such point. Each
+      // decision depends on the previous ones, this loop is serial.
+      for (vtkIdType i = 0; i < numUsedPts; ++i)
+      {
+        target[i] = i;
+        for (vtkIdType j = offsets[i]; j < offsets[i+1]; ++j)
+        {
+          if (target[neighbors[j]] == neighbors[j])
+          {
+            target[i] = neighbors[j];
+            break;
+          }
+        }
+      }
+    }
+  }
+  this->UpdateProgress(0.5);
+
+  // Output ids of the kept points, in order of first use.
+  std::vector<vtkIdType> newIds(numUsedPts + 1);
+  CleanMarkKeptPoints marker = { target.data(), newIds.data() };
+  vtkSMPTools::For(0, numUsedPts, marker);
+  newIds[numUsedPts] = 0;
+  vtkSMPTools::ExclusiveScan(newIds.begin(), newIds.end(), newIds.begin(),
+                             static_cast<vtkIdType>(0));
+  vtkIdType numNewPts = newIds[numUsedPts];
+
+  vtkPoints *newPts = points->NewInstance();
+  newPts->SetDataType(points->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkNew<vtkIdList> sourceIds;
+  sourceIds->SetNumberOfIds(numNewPts);
+  CleanMapPoints mapper = { points, order.data(), target.data(), newIds.data(),
+    pointMap.data(), newPts, sourceIds->GetPointer(0) };
+  vtkSMPTools::For(0, numUsedPts, mapper);
+  points->Delete();
+
+  vtkNew<vtkIdList> destinationIds;
+  destinationIds->SetNumberOfIds(numNewPts);
+  std::iota(destinationIds->GetPointer(0),
+            destinationIds->GetPointer(0) + numNewPts, 0);
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  outputPD->CopyData(inputPD, sourceIds, destinationIds);
+  this->UpdateProgress(0.75);
+
+  // Type and size of the output cells.
+  CleanConversions conversions = { this->ConvertLinesToPoints != 0,
+    this->ConvertPolysToLines != 0, this->ConvertStripsToPolys != 0 };
+  vtkIdType maxCellSize = input->GetMaxCellSize();
+  std::vector<signed char> outputTypes(numCells);
+  std::vector<vtkIdType> outputSizes(numCells);
+  for (int type = 0; type < CLEAN_NUMBER_OF_TYPES; ++type)
+  {
+    CleanClassifyCells classifier;
+    classifier.Source = &sources[type];
+    classifier.Type = type;
+    classifier.Conversions = conversions;
+    classifier.PointMap = pointMap.data();
+    classifier.MaxCellSize = maxCellSize;
+    classifier.OutputTypes = outputTypes.data();
+    classifier.OutputSizes = outputSizes.data();
+    vtkSMPTools::For(0, sources[type].NumberOfCells, classifier);
+  }
+
+  // Build the output cell arrays, verts first. Cells of a given type come
+  // from cells of the same or of a higher type, in the input order.
+  vtkNew<vtkIdList> cellSourceIds;
+  cellSourceIds->SetNumberOfIds(numCells);
+  vtkIdType numNewCells = 0;
+  std::vector<vtkIdType> locations(numCells + 1);
+  std::vector<vtkIdType> indices(numCells + 1);
+  vtkCellArray *newCells[CLEAN_NUMBER_OF_TYPES] = { nullptr, nullptr,
+    nullptr, nullptr };
+  for (int outputType = 0; outputType < CLEAN_NUMBER_OF_TYPES; ++outputType)
+  {
+    CleanCountCells counter = { outputType, outputTypes.data(),
+      outputSizes.data(), locations.data(), indices.data() };
+    vtkSMPTools::For(0, numCells, counter);
+    locations[numCells] = 0;
+    indices[numCells] = 0;
+    vtkSMPTools::ExclusiveScan(locations.begin(), locations.end(),
+                               locations.begin(), static_cast<vtkIdType>(0));
+    vtkSMPTools::ExclusiveScan(indices.begin(), indices.end(),
+                               indices.begin(), static_cast<vtkIdType>(0));
+    if (indices[numCells] == 0 && inCells[outputType]->GetNumberOfCells() == 0)
+    {
+      continue;
+    }
+
+    newCells[outputType] = vtkCellArray::New();
+    vtkIdType *cells = newCells[outputType]->WritePointer(indices[numCells],
+                                                           locations[numCells]);
+    for (int type = outputType; type < CLEAN_NUMBER_OF_TYPES; ++type)
+    {
+      CleanFillCells filler;
+      filler.Source = &sources[type];
+      filler.Type = type;
+      filler.OutputType = outputType;
+      filler.PointMap = pointMap.data();
+      filler.MaxCellSize = maxCellSize;
+      filler.OutputTypes = outputTypes.data();
+      filler.Locations = locations.data();
+      filler.Indices = indices.data();
+      filler.NewCells = cells;
+      filler.CellSourceIds = cellSourceIds->GetPointer(numNewCells);
+      vtkSMPTools::For(0, sources[type].NumberOfCells, filler);
+    }
+    numNewCells += indices[numCells];
+  }
+
+  cellSourceIds->SetNumberOfIds(numNewCells);
+  destinationIds->SetNumberOfIds(numNewCells);
+  std::iota(destinationIds->GetPointer(0),
+            destinationIds->GetPointer(0) + numNewCells, 0);
+  outputCD->CopyAllocate(inputCD, numNewCells);
+  outputCD->CopyData(inputCD, cellSourceIds, destinationIds);
+
+  vtkDebugMacro(<<"Removed " << numPts - numNewPts << " points and "
+                << numCells - numNewCells << " cells");
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  if (newCells[CLEAN_VERTS])
+  {
+    output->SetVerts(newCells[CLEAN_VERTS]);
+    newCells[CLEAN_VERTS]->Delete();
+  }
+  if (newCells[CLEAN_LINES])
+  {
+    output->SetLines(newCells[CLEAN_LINES]);
+    newCells[CLEAN_LINES]->Delete();
+  }
+  if (newCells[CLEAN_POLYS])
+  {
+    output->SetPolys(newCells[CLEAN_POLYS]);
+    newCells[CLEAN_POLYS]->Delete();
+  }
+  if (newCells[CLEAN_STRIPS])
+  {
+    output->SetStrips(newCells[CLEAN_STRIPS]);
+    newCells[CLEAN_STRIPS]->Delete();
+  }
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -675,6 +1299,8 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "ParallelMerging: "
+     << (this->ParallelMerging ? "On\n" : "Off\n");
 }
 
 //--------------------------------------------------------------------------
@@ -144,6 +144,28 @@ public:
   vtkBooleanMacro(PointMerging,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the filter runs in
+   * parallel (using vtkSMPTools). In this mode the points are merged with a
+   * vtkStaticPointLocator instead of the incremental Locator (which is then
+   * ignored), and the cells are renumbered and degenerate cells removed in
+   * parallel. OperateOnPoint() may then be called concurrently from several
+   * threads. By default, parallel merging is off.
+   *
+   * With exact merging (zero tolerance), or when merging is off, the output
+   * is identical to the one of the serial mode. With a non-zero tolerance,
+   * each point is merged into the first point (in the order the cells use
+   * them) kept before it and lying within the tolerance, which is also the
+   * result of the serial mode unless several kept points lie within the
+   * tolerance of the same point. In all cases the output does not depend on
+   * the number of threads.
+   */
+  vtkSetMacro(ParallelMerging,vtkTypeBool);
+  vtkGetMacro(ParallelMerging,vtkTypeBool);
+  vtkBooleanMacro(ParallelMerging,vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
@@ -205,7 +227,11 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
+  // Implementation of RequestData() used when ParallelMerging is on.
+  void ParallelClean(vtkPolyData *input, vtkPolyData *output);
+
   vtkTypeBool   PointMerging;
+  vtkTypeBool ParallelMerging;
   double Tolerance;
   double AbsoluteTolerance;
   vtkTypeBool ConvertLinesToPoints;
@@ -14,6 +14,8 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkFloatArray.h"
@@ -22,10 +24,13 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,9 +38,479 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
+namespace
+{
+//----------------------------------------------------------------------------
+// The cell array of vtkPolyData (0 for verts, 1 for lines, 2 for polys, 3
+// for strips) that stores a cell, if vtkPolyData::BuildCells() gives back its
+// type from its number of points, or -1 otherwise.
+int GetCellArrayIndex(int cellType, vtkIdType npts)
+{
+  switch (cellType)
+  {
+    case VTK_VERTEX:
+      return (npts <= 1 ? 0 : -1);
+    case VTK_POLY_VERTEX:
+      return (npts > 1 ? 0 : -1);
+    case VTK_LINE:
+      return (npts <= 2 ? 1 : -1);
+    case VTK_POLY_LINE:
+      return (npts > 2 ? 1 : -1);
+    case VTK_TRIANGLE:
+      return (npts == 3 ? 2 : -1);
+    case VTK_QUAD:
+      return (npts == 4 ? 2 : -1);
+    case VTK_POLYGON:
+      return (npts != 3 && npts != 4 ? 2 : -1);
+    case VTK_TRIANGLE_STRIP:
+      return 3;
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+// Whether threads can copy the tuples of the arrays with an ArrayList.
+bool CanCopyInParallel(vtkDataSetAttributes *attr)
+{
+  for (int i = 0; attr && i < attr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = attr->GetArray(i);
+    if (!array || array->GetDataType() == VTK_BIT ||
+        !array->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// A glyph of the table, with its points (moved by the source transform) and
+// normals in double precision, and its cells in the format of vtkCellArray.
+struct GlyphSource
+{
+  GlyphSource() : Valid(false), NumberOfPoints(0), NumberOfCells(0) {}
+
+  bool Valid;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  std::vector<double> Points;
+  std::vector<double> Normals;
+  std::vector<vtkIdType> Cells;
+};
+
+//----------------------------------------------------------------------------
+// Copy the glyphs to the input points in parallel. The point, cell and
+// connectivity offsets of the glyph of each input point are computed first,
+// so every thread writes its glyphs straight into the preallocated output.
+// The transform of each glyph is built by a vtkTransform with the same
+// operations as the serial loop, then applied by a matrix-times-points
+// kernel, so the output is identical.
+struct GlyphPoints
+{
+  vtkGlyph3D *Filter;
+  vtkDataSet *Input;
+  vtkUniformGrid *InputUG;
+  unsigned char *GhostLevels;
+  vtkDataArray *SScalars;
+  vtkDataArray *CScalars;
+  vtkDataArray *Array3D;
+  vtkDataArray *SourceTCoords;
+  bool HaveVectors;
+  bool HaveNormals;
+  double Den;
+  int Scaling;
+  int ScaleMode;
+  int ColorMode;
+  double ScaleFactor;
+  double Range[2];
+  int Orient;
+  int Clamping;
+  int IndexMode;
+  std::vector<GlyphSource> Sources;
+
+  // The glyph of each input point (-1 for none) and its output offsets
+  std::vector<int> Glyphs;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<vtkIdType> ConnectivityOffsets;
+
+  // The output
+  ArrayList PointData;
+  ArrayList CellData;
+  vtkPoints *NewPts;
+  vtkDataArray *NewScalars;
+  vtkDataArray *NewVectors;
+  vtkDataArray *NewNormals;
+  vtkDataArray *NewTCoords;
+  vtkIdTypeArray *PointIds;
+  vtkIdType *NewCells;
+
+  vtkSMPThreadLocalObject<vtkTransform> Transforms;
+
+  GlyphPoints(vtkGlyph3D *filter) : Filter(filter)
+  {
+    this->Scaling = filter->GetScaling();
+    this->ScaleMode = filter->GetScaleMode();
+    this->ColorMode = filter->GetColorMode();
+    this->ScaleFactor = filter->GetScaleFactor();
+    filter->GetRange(this->Range);
+    this->Orient = filter->GetOrient();
+    this->Clamping = filter->GetClamping();
+    this->IndexMode = filter->GetIndexMode();
+  }
+
+  // Add a glyph of the table, or a null glyph.
+  void AddSource(vtkPolyData *source, vtkTransform *sourceTransform)
+  {
+    this->Sources.push_back(GlyphSource());
+    if (!source)
+    {
+      return;
+    }
+    GlyphSource &glyph = this->Sources.back();
+    glyph.Valid = true;
+    glyph.NumberOfPoints = source->GetNumberOfPoints();
+    glyph.NumberOfCells = source->GetNumberOfCells();
+    vtkPoints *points = source->GetPoints();
+    vtkNew<vtkPoints> transformedPoints;
+    if (sourceTransform && points)
+    {
+      transformedPoints->SetDataTypeToDouble();
+      sourceTransform->TransformPoints(points, transformedPoints);
+      points = transformedPoints;
+    }
+    glyph.Points.resize(3 * glyph.NumberOfPoints);
+    for (vtkIdType i = 0; i < glyph.NumberOfPoints; ++i)
+    {
+      points->GetPoint(i, &glyph.Points[3 * i]);
+    }
+    vtkDataArray *normals = source->GetPointData()->GetNormals();
+    if (normals)
+    {
+      glyph.Normals.resize(3 * glyph.NumberOfPoints);
+      for (vtkIdType i = 0; i < glyph.NumberOfPoints; ++i)
+      {
+        normals->GetTuple(i, &glyph.Normals[3 * i]);
+      }
+    }
+    vtkNew<vtkIdList> cellPts;
+    for (vtkIdType cellId = 0; cellId < glyph.NumberOfCells; ++cellId)
+    {
+      source->GetCellPoints(cellId, cellPts);
+      glyph.Cells.push_back(cellPts->GetNumberOfIds());
+      glyph.Cells.insert(glyph.Cells.end(), cellPts->GetPointer(0),
+        cellPts->GetPointer(0) + cellPts->GetNumberOfIds());
+    }
+  }
+
+  // The cell array of the cells of all the glyphs, or -1 if the glyphs
+  // have cells of several arrays, in which case the order of the output
+  // cells cannot be kept in parallel. No cells at all gives 2 (polys).
+  static int GetCellArray(const std::vector<vtkPolyData *> &sources)
+  {
+    int cellArray = -2;
+    vtkNew<vtkIdList> cellPts;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+      vtkPolyData *source = sources[i];
+      vtkIdType numCells = (source ? source->GetNumberOfCells() : 0);
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        source->GetCellPoints(cellId, cellPts);
+        int index = GetCellArrayIndex(source->GetCellType(cellId),
+                                      cellPts->GetNumberOfIds());
+        if (index < 0 || (cellArray != -2 && index != cellArray))
+        {
+          return -1;
+        }
+        cellArray = index;
+      }
+    }
+    return (cellArray == -2 ? 2 : cellArray);
+  }
+
+  // The scalar value, the vector and its magnitude, and the scale factors
+  // (after clamping) of an input point, as the serial loop computes them.
+  void GetPointParameters(vtkIdType inPtId, double &s, double v[3],
+                          double &vMag, double scale[3])
+  {
+    scale[0] = scale[1] = scale[2] = 1.0;
+    if (this->SScalars)
+    {
+      s = this->SScalars->GetComponent(inPtId, 0);
+      if (this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+          this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scale[0] = scale[1] = scale[2] = s;
+      }
+    }
+    if (this->HaveVectors)
+    {
+      v[0] = 0;
+      v[1] = 0;
+      v[2] = 0;
+      this->Array3D->GetTuple(inPtId, v);
+      vMag = vtkMath::Norm(v);
+      if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+      {
+        scale[0] = v[0];
+        scale[1] = v[1];
+        scale[2] = v[2];
+      }
+      else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+      {
+        scale[0] = scale[1] = scale[2] = vMag;
+      }
+    }
+    if (this->Clamping)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        scale[i] = (scale[i] < this->Range[0] ? this->Range[0] :
+                    (scale[i] > this->Range[1] ? this->Range[1] : scale[i]));
+        scale[i] = (scale[i] - this->Range[0]) / this->Den;
+      }
+    }
+  }
+
+  // Find the glyph of each input point, and the offsets of the glyphs in
+  // the output. This pass is serial, for IsPointVisible() and blanking.
+  void ComputeOffsets(vtkIdType numPts, vtkIdType &numNewPts,
+                      vtkIdType &numNewCells, vtkIdType &connectivitySize)
+  {
+    int numberOfSources = static_cast<int>(this->Sources.size());
+    this->Glyphs.resize(numPts);
+    this->PointOffsets.resize(numPts);
+    this->CellOffsets.resize(numPts);
+    this->ConnectivityOffsets.resize(numPts);
+    numNewPts = numNewCells = connectivitySize = 0;
+    double s = 0.0, v[3], vMag = 0.0, scale[3];
+    for (vtkIdType inPtId = 0; inPtId < numPts; ++inPtId)
+    {
+      int index = 0;
+      if (this->IndexMode != VTK_INDEXING_OFF)
+      {
+        this->GetPointParameters(inPtId, s, v, vMag, scale);
+        double value = (this->IndexMode == VTK_INDEXING_BY_SCALAR ? s : vMag);
+        index = static_cast<int>((value - this->Range[0])*numberOfSources /
+                                 this->Den);
+        index = (index < 0 ? 0 :
+                (index >= numberOfSources ? (numberOfSources-1) : index));
+      }
+      if (!this->Sources[index].Valid)
+      {
+        index = -1;
+      }
+      if (index >= 0 &&
+          ((this->GhostLevels && this->GhostLevels[inPtId] &
+            vtkDataSetAttributes::DUPLICATEPOINT) ||
+           (this->InputUG && !this->InputUG->IsPointVisible(inPtId)) ||
+           !this->Filter->IsPointVisible(this->Input, inPtId)))
+      {
+        index = -1;
+      }
+      this->Glyphs[inPtId] = index;
+      this->PointOffsets[inPtId] = numNewPts;
+      this->CellOffsets[inPtId] = numNewCells;
+      this->ConnectivityOffsets[inPtId] = connectivitySize;
+      if (index >= 0)
+      {
+        numNewPts += this->Sources[index].NumberOfPoints;
+        numNewCells += this->Sources[index].NumberOfCells;
+        connectivitySize +=
+          static_cast<vtkIdType>(this->Sources[index].Cells.size());
+      }
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkTransform *trans = this->Transforms.Local();
+    double s = 0.0, v[3], vNew[3], vMag = 0.0, scale[3], x[3];
+    double normalMatrix[4][4];
+    for (vtkIdType inPtId = begin; inPtId < end; ++inPtId)
+    {
+      int index = this->Glyphs[inPtId];
+      if (index < 0)
+      {
+        continue;
+      }
+      const GlyphSource &glyph = this->Sources[index];
+      vtkIdType ptIncr = this->PointOffsets[inPtId];
+      vtkIdType cellIncr = this->CellOffsets[inPtId];
+      vtkIdType numSourcePts = glyph.NumberOfPoints;
+      this->GetPointParameters(inPtId, s, v, vMag, scale);
+
+      // Copy all topology (transformation independent)
+      vtkIdType *cells = this->NewCells + this->ConnectivityOffsets[inPtId];
+      for (size_t i = 0; i < glyph.Cells.size();)
+      {
+        vtkIdType npts = glyph.Cells[i++];
+        *cells++ = npts;
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          *cells++ = glyph.Cells[i++] + ptIncr;
+        }
+      }
+
+      // translate Source to Input point
+      trans->Identity();
+      this->Input->GetPoint(inPtId, x);
+      trans->Translate(x[0], x[1], x[2]);
+
+      if (this->HaveVectors)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; i++)
+        {
+          this->NewVectors->SetTuple(i+ptIncr, v);
+        }
+        if (this->Orient && (vMag > 0.0))
+        {
+          // if there is no y or z component
+          if ( v[1] == 0.0 && v[2] == 0.0 )
+          {
+            if (v[0] < 0) //just flip x if we need to
+            {
+              trans->RotateWXYZ(180.0,0,1,0);
+            }
+          }
+          else
+          {
+            vNew[0] = (v[0]+vMag) / 2.0;
+            vNew[1] = v[1] / 2.0;
+            vNew[2] = v[2] / 2.0;
+            trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          }
+        }
+      }
+
+      if (this->SourceTCoords)
+      {
+        double tc[3];
+        for (vtkIdType i = 0; i < numSourcePts; i++)
+        {
+          this->SourceTCoords->GetTuple(i, tc);
+          this->NewTCoords->SetTuple(i+ptIncr, tc);
+        }
+      }
+
+      // Copy scalar value
+      if (this->SScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
+      {
+        for (vtkIdType i = 0; i < numSourcePts; i++)
+        {
+          this->NewScalars->SetTuple(i+ptIncr, scale);
+        }
+      }
+      else if (this->CScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
+      {
+        for (vtkIdType i = 0; i < numSourcePts; i++)
+        {
+          this->NewScalars->SetTuple(ptIncr+i, inPtId, this->CScalars);
+        }
+      }
+      if (this->HaveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
+      {
+        for (vtkIdType i = 0; i < numSourcePts; i++)
+        {
+          this->NewScalars->SetTuple(i+ptIncr, &vMag);
+        }
+      }
+
+      // scale data if appropriate
+      if (this->Scaling)
+      {
+        for (int i = 0; i < 3; ++i)
+        {
+          if (this->ScaleMode == VTK_DATA_SCALING_OFF)
+          {
+            scale[i] = this->ScaleFactor;
+          }
+          else
+          {
+            scale[i] *= this->ScaleFactor;
+          }
+          if (scale[i] == 0.0)
+          {
+            scale[i] = 1.0e-10;
+          }
+        }
+        trans->Scale(scale[0], scale[1], scale[2]);
+      }
+
+      // multiply points and normals by resulting matrix
+      double (*matrix)[4] = trans->GetMatrix()->Element;
+      switch (this->NewPts->GetDataType())
+      {
+        vtkTemplateMacro(TransformPoints(matrix, glyph.Points.data(),
+          static_cast<VTK_TT *>(this->NewPts->GetVoidPointer(3*ptIncr)),
+          numSourcePts));
+      }
+      if (this->HaveNormals)
+      {
+        // to transform the normal, multiply by the transposed inverse matrix
+        vtkMatrix4x4::DeepCopy(*normalMatrix, trans->GetMatrix());
+        vtkMatrix4x4::Invert(*normalMatrix, *normalMatrix);
+        vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+        float *n = static_cast<float *>(
+          this->NewNormals->GetVoidPointer(3*ptIncr));
+        const double *in = glyph.Normals.data();
+        for (vtkIdType i = 0; i < numSourcePts; ++i, in += 3, n += 3)
+        {
+          for (int j = 0; j < 3; ++j)
+          {
+            n[j] = static_cast<float>(normalMatrix[j][0]*in[0] +
+              normalMatrix[j][1]*in[1] + normalMatrix[j][2]*in[2]);
+          }
+          vtkMath::Normalize(n);
+        }
+      }
+
+      // Copy point data from source (if possible)
+      for (vtkIdType i = 0; i < numSourcePts; ++i)
+      {
+        this->PointData.Copy(inPtId, ptIncr + i);
+      }
+      for (vtkIdType i = 0; i < glyph.NumberOfCells; ++i)
+      {
+        this->CellData.Copy(inPtId, cellIncr + i);
+      }
+
+      // If point ids are to be generated, do it here
+      if (this->PointIds)
+      {
+        std::fill_n(this->PointIds->GetPointer(ptIncr), numSourcePts, inPtId);
+      }
+    }
+  }
+
+  template <typename T>
+  static void TransformPoints(double matrix[4][4], const double *in, T *out,
+                              vtkIdType n)
+  {
+    for (vtkIdType i = 0; i < n; ++i, in += 3, out += 3)
+    {
+      T x = static_cast<T>(
+        matrix[0][0]*in[0]+matrix[0][1]*in[1]+matrix[0][2]*in[2]+matrix[0][3]);
+      T y = static_cast<T>(
+        matrix[1][0]*in[0]+matrix[1][1]*in[1]+matrix[1][2]*in[2]+matrix[1][3]);
+      T z = static_cast<T>(
+        matrix[2][0]*in[0]+matrix[2][1]*in[1]+matrix[2][2]*in[2]+matrix[2][3]);
+      out[0] = x;
+      out[1] = y;
+      out[2] = z;
+    }
+  }
+};
+
+} // end anonymous namespace
+
 //----------------------------------------------------------------------------
 // Construct object with scaling on, scaling mode is by scalar value,
 // scale factor = 1.0, the range is (0,1), orient geometry is on, and
@@ -265,6 +740,32 @@ bool vtkGlyph3D::Execute(
     source = defaultSource;
   }
 
+  // Glyph the points in parallel, unless the glyphs have cells of several
+  // cell arrays (whose interleaved order only the serial insertion keeps),
+  // or arrays that threads cannot copy.
+  std::vector<vtkPolyData *> sources;
+  if ( this->IndexMode != VTK_INDEXING_OFF )
+  {
+    for (i=0; i < numberOfSources; i++)
+    {
+      sources.push_back(this->GetSource(i, sourceVector));
+    }
+  }
+  else
+  {
+    sources.push_back(source);
+  }
+  vtkDataArray *array3D =
+    (this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors);
+  int cellArray = GlyphPoints::GetCellArray(sources);
+  bool parallel = (cellArray >= 0 &&
+    (this->IndexMode != VTK_INDEXING_OFF || CanCopyInParallel(pd)) &&
+    !(this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars &&
+      inCScalars->GetDataType() == VTK_BIT) &&
+    !(haveVectors && array3D->GetNumberOfComponents() > 3));
+  vtkDataSetAttributes::FieldList pointList(1);
+  vtkDataSetAttributes::FieldList cellList(1);
+
   if ( this->IndexMode != VTK_INDEXING_OFF )
   {
     pd = nullptr;
@@ -317,10 +818,24 @@ bool vtkGlyph3D::Execute(
 
     // Prepare to copy output.
     pd = input->GetPointData();
-    outputPD->CopyAllocate(pd,numPts*numSourcePts);
-    if (this->FillCellData)
+    if (parallel)
     {
-      outputCD->CopyAllocate(pd,numPts*numSourceCells);
+      // the field lists pair the input and output arrays for the threads
+      pointList.InitializeFieldList(pd);
+      outputPD->CopyAllocate(pointList,numPts*numSourcePts);
+      if (this->FillCellData)
+      {
+        cellList.InitializeFieldList(pd);
+        outputCD->CopyAllocate(cellList,numPts*numSourceCells);
+      }
+    }
+    else
+    {
+      outputPD->CopyAllocate(pd,numPts*numSourcePts);
+      if (this->FillCellData)
+      {
+        outputCD->CopyAllocate(pd,numPts*numSourceCells);
+      }
     }
   }
 
@@ -400,308 +915,385 @@ bool vtkGlyph3D::Execute(
     newTCoords->SetName("TCoords");
   }
 
-  // Setting up for calls to PolyData::InsertNextCell()
-  if (this->IndexMode != VTK_INDEXING_OFF )
+  if (parallel)
   {
-    output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
-  }
-  else
-  {
-    output->Allocate(source,
-                     3*numPts*numSourceCells, numPts*numSourceCells);
-  }
-
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
-
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
-  //
-  ptIncr=0;
-  cellIncr=0;
-  for (inPtId=0; inPtId < numPts; inPtId++)
-  {
-    scalex = scaley = scalez = 1.0;
-    if ( ! (inPtId % 10000) )
+    GlyphPoints glyphPoints(this);
+    glyphPoints.Input = input;
+    glyphPoints.InputUG = inputUG;
+    glyphPoints.GhostLevels = inGhostLevels;
+    glyphPoints.SScalars = inSScalars;
+    glyphPoints.CScalars = inCScalars;
+    glyphPoints.Array3D = array3D;
+    glyphPoints.SourceTCoords = (haveTCoords ? sourceTCoords : nullptr);
+    glyphPoints.HaveVectors = (haveVectors != 0);
+    glyphPoints.HaveNormals = (haveNormals != 0);
+    glyphPoints.Den = den;
+    for (size_t j = 0; j < sources.size(); j++)
     {
-      this->UpdateProgress(static_cast<double>(inPtId)/numPts);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      glyphPoints.AddSource(sources[j], this->SourceTransform);
     }
+    vtkIdType numNewPts, numNewCells, connectivitySize;
+    glyphPoints.ComputeOffsets(numPts, numNewPts, numNewCells,
+                               connectivitySize);
+    this->UpdateProgress(0.1);
 
-    // Get the scalar and vector data
-    if ( inSScalars )
+    // Preallocate every output array
+    if ( pd )
     {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if ( this->ScaleMode == VTK_SCALE_BY_SCALAR ||
-           this->ScaleMode == VTK_DATA_SCALING_OFF )
+      glyphPoints.PointData.AddArrays(numNewPts, pointList, pd, outputPD);
+      if (this->FillCellData)
       {
-        scalex = scaley = scalez = s;
+        glyphPoints.CellData.AddArrays(numNewCells, cellList, pd, outputCD);
       }
     }
-
-    if ( haveVectors )
+    newPts->SetNumberOfPoints(numNewPts);
+    glyphPoints.NewPts = newPts;
+    vtkDataArray *newArrays[4] = {
+      newScalars, newVectors, newNormals, newTCoords };
+    for (i = 0; i < 4; i++)
     {
-      vtkDataArray *array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
-      if(array3D->GetNumberOfComponents()>3)
+      if (newArrays[i])
       {
-        vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
-        pts->Delete();
-        trans->Delete();
-        if(newPts)
-        {
-          newPts->Delete();
-        }
-        if(newVectors)
-        {
-          newVectors->Delete();
-        }
-        return false;
+        newArrays[i]->SetNumberOfTuples(numNewPts);
       }
-
-      v[0] = 0;
-      v[1] = 0;
-      v[2] = 0;
-      array3D->GetTuple(inPtId, v);
-      vMag = vtkMath::Norm(v);
-      if ( this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
-      {
-        scalex = v[0];
-        scaley = v[1];
-        scalez = v[2];
-      }
-      else if ( this->ScaleMode == VTK_SCALE_BY_VECTOR )
-      {
-        scalex = scaley = scalez = vMag;
-      }
-    }
-
-    // Clamp data scale if enabled
-    if ( this->Clamping )
-    {
-      scalex = (scalex < this->Range[0] ? this->Range[0] :
-                (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0] :
-                (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0] :
-                (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
     }
-
-    // Compute index into table of glyphs
-    if ( this->IndexMode != VTK_INDEXING_OFF )
+    glyphPoints.NewScalars = newScalars;
+    glyphPoints.NewVectors = newVectors;
+    glyphPoints.NewNormals = newNormals;
+    glyphPoints.NewTCoords = newTCoords;
+    if (pointIds)
     {
-      if ( this->IndexMode == VTK_INDEXING_BY_SCALAR )
-      {
-        value = s;
-      }
-      else
-      {
-        value = vMag;
-      }
-
-      int index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
-      index = (index < 0 ? 0 :
-              (index >= numberOfSources ? (numberOfSources-1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if ( source != nullptr )
-      {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-      }
+      pointIds->SetNumberOfValues(numNewPts);
     }
+    glyphPoints.PointIds = pointIds;
+    vtkNew<vtkCellArray> newCells;
+    glyphPoints.NewCells = newCells->WritePointer(numNewCells,
+                                                  connectivitySize);
 
-    // Make sure we're not indexing into empty glyph
-    if ( source == nullptr )
-    {
-      continue;
-    }
+    vtkSMPTools::For(0, numPts, glyphPoints);
 
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate
-    // glyphs on the borders.
-    if (inGhostLevels &&
-        inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT)
+    switch (cellArray)
     {
-      continue;
+      case 0:
+        output->SetVerts(newCells);
+        break;
+      case 1:
+        output->SetLines(newCells);
+        break;
+      case 2:
+        output->SetPolys(newCells);
+        break;
+      default:
+        output->SetStrips(newCells);
+        break;
     }
-
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
+  }
+  else
+  {
+    // Setting up for calls to PolyData::InsertNextCell()
+    if (this->IndexMode != VTK_INDEXING_OFF )
     {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
-      continue;
+      output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
     }
-
-    if (!this->IsPointVisible(input, inPtId))
+    else
     {
-      continue;
+      output->Allocate(source,
+                       3*numPts*numSourceCells, numPts*numSourceCells);
     }
 
-    // Now begin copying/transforming glyph
-    trans->Identity();
+    transformedSourcePts->SetDataTypeToDouble();
+    transformedSourcePts->Allocate(numSourcePts);
 
-    // Copy all topology (transformation independent)
-    for (cellId=0; cellId < numSourceCells; cellId++)
+    // Traverse all Input points, transforming Source points and copying
+    // point attributes.
+    //
+    ptIncr=0;
+    cellIncr=0;
+    for (inPtId=0; inPtId < numPts; inPtId++)
     {
-      source->GetCellPoints(cellId, pointIdList);
-      cellPts = pointIdList;
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i=0; i < npts; i++)
+      scalex = scaley = scalez = 1.0;
+      if ( ! (inPtId % 10000) )
       {
-        pts->InsertId(i, cellPts->GetId(i) + ptIncr);
+        this->UpdateProgress(static_cast<double>(inPtId)/numPts);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
       }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
-    }
 
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-
-    if ( haveVectors )
-    {
-      // Copy Input vector
-      for (i=0; i < numSourcePts; i++)
+      // Get the scalar and vector data
+      if ( inSScalars )
       {
-        newVectors->InsertTuple(i+ptIncr, v);
+        s = inSScalars->GetComponent(inPtId, 0);
+        if ( this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+             this->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = s;
+        }
       }
-      if (this->Orient && (vMag > 0.0))
+
+      if ( haveVectors )
       {
-        // if there is no y or z component
-        if ( v[1] == 0.0 && v[2] == 0.0 )
+        vtkDataArray *array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
+        if(array3D->GetNumberOfComponents()>3)
         {
-          if (v[0] < 0) //just flip x if we need to
+          vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
+          pts->Delete();
+          trans->Delete();
+          if(newPts)
           {
-            trans->RotateWXYZ(180.0,0,1,0);
+            newPts->Delete();
           }
+          if(newVectors)
+          {
+            newVectors->Delete();
+          }
+          return false;
+        }
+
+        v[0] = 0;
+        v[1] = 0;
+        v[2] = 0;
+        array3D->GetTuple(inPtId, v);
+        vMag = vtkMath::Norm(v);
+        if ( this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+        {
+          scalex = v[0];
+          scaley = v[1];
+          scalez = v[2];
+        }
+        else if ( this->ScaleMode == VTK_SCALE_BY_VECTOR )
+        {
+          scalex = scaley = scalez = vMag;
+        }
+      }
+
+      // Clamp data scale if enabled
+      if ( this->Clamping )
+      {
+        scalex = (scalex < this->Range[0] ? this->Range[0] :
+                  (scalex > this->Range[1] ? this->Range[1] : scalex));
+        scalex = (scalex - this->Range[0]) / den;
+        scaley = (scaley < this->Range[0] ? this->Range[0] :
+                  (scaley > this->Range[1] ? this->Range[1] : scaley));
+        scaley = (scaley - this->Range[0]) / den;
+        scalez = (scalez < this->Range[0] ? this->Range[0] :
+                  (scalez > this->Range[1] ? this->Range[1] : scalez));
+        scalez = (scalez - this->Range[0]) / den;
+      }
+
+      // Compute index into table of glyphs
+      if ( this->IndexMode != VTK_INDEXING_OFF )
+      {
+        if ( this->IndexMode == VTK_INDEXING_BY_SCALAR )
+        {
+          value = s;
         }
         else
         {
-          vNew[0] = (v[0]+vMag) / 2.0;
-          vNew[1] = v[1] / 2.0;
-          vNew[2] = v[2] / 2.0;
-          trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          value = vMag;
+        }
+
+        int index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
+        index = (index < 0 ? 0 :
+                (index >= numberOfSources ? (numberOfSources-1) : index));
+
+        source = this->GetSource(index, sourceVector);
+        if ( source != nullptr )
+        {
+          sourcePts = source->GetPoints();
+          sourceNormals = source->GetPointData()->GetNormals();
+          numSourcePts = sourcePts->GetNumberOfPoints();
+          numSourceCells = source->GetNumberOfCells();
         }
       }
-    }
 
-    if (haveTCoords)
-    {
-      for (i = 0; i < numSourcePts; i++)
+      // Make sure we're not indexing into empty glyph
+      if ( source == nullptr )
       {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i+ptIncr, tc);
+        continue;
       }
-    }
 
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-    {
-      for (i=0; i < numSourcePts; i++)
+      // Check ghost points.
+      // If we are processing a piece, we do not want to duplicate
+      // glyphs on the borders.
+      if (inGhostLevels &&
+          inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT)
       {
-        newScalars->InsertTuple(i+ptIncr, &scalex); // = scaley = scalez
+        continue;
       }
-    }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-    {
-      for (i=0; i < numSourcePts; i++)
+
+      if (inputUG && !inputUG->IsPointVisible(inPtId))
       {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
+        // input is a vtkUniformGrid and the current point is blanked. Don't glyph
+        // it.
+        continue;
       }
-    }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-    {
-      for (i=0; i < numSourcePts; i++)
+
+      if (!this->IsPointVisible(input, inPtId))
       {
-        newScalars->InsertTuple(i+ptIncr, &vMag);
+        continue;
       }
-    }
 
-    // scale data if appropriate
-    if ( this->Scaling )
-    {
-      if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
+      // Now begin copying/transforming glyph
+      trans->Identity();
+
+      // Copy all topology (transformation independent)
+      for (cellId=0; cellId < numSourceCells; cellId++)
       {
-        scalex = scaley = scalez = this->ScaleFactor;
+        source->GetCellPoints(cellId, pointIdList);
+        cellPts = pointIdList;
+        npts = cellPts->GetNumberOfIds();
+        for (pts->Reset(), i=0; i < npts; i++)
+        {
+          pts->InsertId(i, cellPts->GetId(i) + ptIncr);
+        }
+        output->InsertNextCell(source->GetCellType(cellId), pts);
       }
-      else
+
+      // translate Source to Input point
+      input->GetPoint(inPtId, x);
+      trans->Translate(x[0], x[1], x[2]);
+
+      if ( haveVectors )
       {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
+        // Copy Input vector
+        for (i=0; i < numSourcePts; i++)
+        {
+          newVectors->InsertTuple(i+ptIncr, v);
+        }
+        if (this->Orient && (vMag > 0.0))
+        {
+          // if there is no y or z component
+          if ( v[1] == 0.0 && v[2] == 0.0 )
+          {
+            if (v[0] < 0) //just flip x if we need to
+            {
+              trans->RotateWXYZ(180.0,0,1,0);
+            }
+          }
+          else
+          {
+            vNew[0] = (v[0]+vMag) / 2.0;
+            vNew[1] = v[1] / 2.0;
+            vNew[2] = v[2] / 2.0;
+            trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          }
+        }
       }
 
-      if ( scalex == 0.0 )
+      if (haveTCoords)
       {
-        scalex = 1.0e-10;
+        for (i = 0; i < numSourcePts; i++)
+        {
+          sourceTCoords->GetTuple(i, tc);
+          newTCoords->InsertTuple(i+ptIncr, tc);
+        }
       }
-      if ( scaley == 0.0 )
+
+      // determine scale factor from scalars if appropriate
+      // Copy scalar value
+      if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
       {
-        scaley = 1.0e-10;
+        for (i=0; i < numSourcePts; i++)
+        {
+          newScalars->InsertTuple(i+ptIncr, &scalex); // = scaley = scalez
+        }
       }
-      if ( scalez == 0.0 )
+      else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
       {
-        scalez = 1.0e-10;
+        for (i=0; i < numSourcePts; i++)
+        {
+          outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
+        }
+      }
+      if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
+      {
+        for (i=0; i < numSourcePts; i++)
+        {
+          newScalars->InsertTuple(i+ptIncr, &vMag);
+        }
       }
-      trans->Scale(scalex,scaley,scalez);
-    }
 
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-    {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-    }
-    else
-    {
-      trans->TransformPoints(sourcePts,newPts);
-    }
+      // scale data if appropriate
+      if ( this->Scaling )
+      {
+        if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
+        {
+          scalex = scaley = scalez = this->ScaleFactor;
+        }
+        else
+        {
+          scalex *= this->ScaleFactor;
+          scaley *= this->ScaleFactor;
+          scalez *= this->ScaleFactor;
+        }
 
-    if ( haveNormals )
-    {
-      trans->TransformNormals(sourceNormals,newNormals);
-    }
+        if ( scalex == 0.0 )
+        {
+          scalex = 1.0e-10;
+        }
+        if ( scaley == 0.0 )
+        {
+          scaley = 1.0e-10;
+        }
+        if ( scalez == 0.0 )
+        {
+          scalez = 1.0e-10;
+        }
+        trans->Scale(scalex,scaley,scalez);
+      }
 
-    // Copy point data from source (if possible)
-    if ( pd )
-    {
-      for (i = 0; i < numSourcePts; ++i)
+      // multiply points and normals by resulting matrix
+      if (this->SourceTransform)
       {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
+        transformedSourcePts->Reset();
+        this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
+        trans->TransformPoints(transformedSourcePts, newPts);
       }
-      outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
-      if (this->FillCellData)
+      else
       {
-        for (i = 0; i < numSourceCells; ++i)
+        trans->TransformPoints(sourcePts,newPts);
+      }
+
+      if ( haveNormals )
+      {
+        trans->TransformNormals(sourceNormals,newNormals);
+      }
+
+      // Copy point data from source (if possible)
+      if ( pd )
+      {
+        for (i = 0; i < numSourcePts; ++i)
+        {
+          srcPointIdList->SetId(i, inPtId);
+          dstPointIdList->SetId(i, ptIncr + i);
+        }
+        outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
+        if (this->FillCellData)
         {
-          srcCellIdList->SetId(i, inPtId);
-          dstCellIdList->SetId(i, cellIncr + i);
+          for (i = 0; i < numSourceCells; ++i)
+          {
+            srcCellIdList->SetId(i, inPtId);
+            dstCellIdList->SetId(i, cellIncr + i);
+          }
+          outputCD->CopyData(pd, srcCellIdList, dstCellIdList);
         }
-        outputCD->CopyData(pd, srcCellIdList, dstCellIdList);
       }
-    }
 
-    // If point ids are to be generated, do it here
-    if ( this->GeneratePointIds )
-    {
-      for (i=0; i < numSourcePts; i++)
+      // If point ids are to be generated, do it here
+      if ( this->GeneratePointIds )
       {
-        pointIds->InsertNextValue(inPtId);
+        for (i=0; i < numSourcePts; i++)
+        {
+          pointIds->InsertNextValue(inPtId);
+        }
       }
+
+      ptIncr += numSourcePts;
+      cellIncr += numSourceCells;
     }
 
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
   }
 
   // Update ourselves and release memory
@@ -73,6 +73,15 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * This class has been threaded with vtkSMPTools. The number of points and
+ * cells of each glyph are computed first, and the glyphs are then copied in
+ * parallel into the preallocated output. The output is the same as the one
+ * of the serial insertion of the glyphs, which is still used when the
+ * glyphs do not all have cells of the same kind (e.g. vertices and
+ * polygons), or when the point data cannot be copied in parallel (e.g. a
+ * vtkStringArray).
+ *
  * @sa
  * vtkTensorGlyph
 */
@@ -19,14 +19,19 @@
 #include <limits>
 #include <vector>
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #define VTK_EPSILON 1.e-6
 
@@ -148,6 +153,87 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+//----------------------------------------------------------------------------
+// Whether the threaded kernel can process the attributes, that is, when all
+// the arrays are data arrays with the standard memory layout, which the
+// kernel accesses through their pointers, and no attribute is interpolated
+// by taking the value of the nearest neighbor. The output arrays allocated
+// from a field list always have the standard memory layout.
+bool CanAverage(vtkDataSetAttributes *inAttr, vtkDataSetAttributes *outAttr)
+{
+  for (int i = 0; i < inAttr->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array =
+      vtkArrayDownCast<vtkDataArray>(inAttr->GetAbstractArray(i));
+    if (!array || !array->HasStandardMemoryLayout())
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
+  {
+    if (outAttr->GetCopyAttribute(i, vtkDataSetAttributes::INTERPOLATE) == 2)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Average the point data of the points of each cell or, for categorical
+// data, copy the point data of the point with the most frequent scalar
+// value, for ranges of cells in parallel. GetCellPoints() is thread safe
+// once it has been called from a single thread.
+struct AverageToCells
+{
+  vtkDataSet *Input;
+  vtkDataArray *CategoricalScalars;
+  ArrayList *Arrays;
+  int MaxCellSize;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+  vtkSMPThreadLocal<Histogram> Histograms;
+
+  AverageToCells(vtkDataSet *input, vtkDataArray *scalars, ArrayList *arrays,
+                 int maxCellSize) :
+    Input(input), CategoricalScalars(scalars), Arrays(arrays),
+    MaxCellSize(maxCellSize), Histograms(Histogram(maxCellSize))
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    Histogram &hist = this->Histograms.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType numPts = cellPts->GetNumberOfIds();
+      if (numPts == 0)
+      {
+        this->Arrays->AssignNullValue(cellId);
+      }
+      else if (!this->CategoricalScalars)
+      {
+        this->Arrays->Average(static_cast<int>(numPts),
+                              cellPts->GetPointer(0), cellId);
+      }
+      else
+      {
+        // Reset all the bins, so that the bins sorted for the previous
+        // cells do not take part in the vote.
+        hist.Reset(this->MaxCellSize);
+        for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+        {
+          vtkIdType pointId = cellPts->GetId(ptId);
+          hist.Fill(pointId, this->CategoricalScalars->GetComponent(pointId, 0));
+        }
+        this->Arrays->Copy(hist.IndexOfLargestBin(), cellId);
+      }
+    }
+  }
+};
+
 }
 
 
@@ -232,53 +318,82 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
-  // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
-  // It's weird, but it works.
-  outCD->InterpolateAllocate(inPD,numCells);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  if (CanAverage(inPD, outCD))
   {
-    if ( !(cellId % progressInterval) )
+    // Process all the arrays at once, in parallel, reporting the progress
+    // and checking the abort flag from this thread
+    vtkDataSetAttributes::FieldList pfl(1);
+    pfl.InitializeFieldList(inPD);
+    outCD->InterpolateAllocate(pfl, numCells, numCells);
+    ArrayList arrays;
+    arrays.AddArrays(numCells, pfl, inPD, outCD);
+
+    input->GetCellPoints(0, cellPts);
+    AverageToCells average(input, (this->CategoricalData ?
+                                   inPD->GetScalars() : nullptr),
+                           &arrays, maxCellSize);
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells; cellId += progressInterval)
     {
       this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-    }
-
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-
-    if (numPts == 0)
-    {
-      continue;
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+      vtkSMPTools::For(cellId, std::min(cellId + progressInterval, numCells),
+                       average);
     }
+  }
+  else
+  {
+    // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
+    // It's weird, but it works.
+    outCD->InterpolateAllocate(inPD,numCells);
 
-    // If we aren't dealing with categorical data...
-    if (!(this->CategoricalData))
+    int abort=0;
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells && !abort; cellId++)
     {
-      // ...then we simply provide each point with an equal weight value and
-      // interpolate.
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      if ( !(cellId % progressInterval) )
       {
-        weights[ptId] = weight;
+        this->UpdateProgress((double)cellId/numCells);
+        abort = GetAbortExecute();
       }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
-    }
-    else
-    {
-      // ...otherwise, we populate a histogram from the scalar values at each
-      // point, and then select the bin with the most elements.
-      hist.Reset(numPts);
-      for (ptId=0; ptId < numPts; ptId++)
+
+      input->GetCellPoints(cellId, cellPts);
+      numPts = cellPts->GetNumberOfIds();
+
+      if (numPts == 0)
       {
-        pointId = cellPts->GetId(ptId);
-        hist.Fill(pointId,
-                  input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        continue;
       }
 
-      outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
+      // If we aren't dealing with categorical data...
+      if (!(this->CategoricalData))
+      {
+        // ...then we simply provide each point with an equal weight value and
+        // interpolate.
+        weight = 1.0 / numPts;
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          weights[ptId] = weight;
+        }
+        outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
+      }
+      else
+      {
+        // ...otherwise, we populate a histogram from the scalar values at each
+        // point, and then select the bin with the most elements.
+        hist.Reset(maxCellSize);
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          pointId = cellPts->GetId(ptId);
+          hist.Fill(pointId,
+                    input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        }
+
+        outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
+      }
     }
   }
 
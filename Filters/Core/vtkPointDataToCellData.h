@@ -22,6 +22,11 @@
  * values of all points defining a particular cell. Optionally, the input point
  * data can be passed through to the output as well.
  *
+ * When the point data consists of data arrays only, the cells are processed
+ * in parallel with vtkSMPTools, all the arrays at once, and the averages are
+ * computed in double precision and rounded to the nearest value for the
+ * integral types.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -24,13 +24,475 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
-#include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkTriangleStrip.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+namespace
+{
+
+// Values of the edge neighbor table for the edges that are not shared by
+// exactly two polygons.
+const vtkIdType VTK_BOUNDARY_EDGE = -1;
+const vtkIdType VTK_NON_MANIFOLD_EDGE = -2;
+
+//----------------------------------------------------------------------------
+// Position of the first occurrence of cellId in the (sorted) list of cells
+// using a point.
+inline vtkIdType FindCell(const vtkIdType *cells, unsigned short ncells,
+                          vtkIdType cellId)
+{
+  return std::lower_bound(cells, cells + ncells, cellId) - cells;
+}
+
+//----------------------------------------------------------------------------
+// Compute the normal of each polygon.
+struct ComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *Normals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->Normals + 3 * cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the points of each polygon. Once scanned, the counts give the
+// position of the edges of each polygon in the edge neighbor table.
+struct CountPolyPoints
+{
+  vtkPolyData *Mesh;
+  vtkIdType *Counts;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType npts, *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      this->Counts[cellId] = npts;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build the edge neighbor table. Edge j of a polygon goes from its j-th
+// point to the next one. If the edge is shared by exactly one other polygon,
+// the table holds the id of that polygon; otherwise it holds
+// VTK_BOUNDARY_EDGE or VTK_NON_MANIFOLD_EDGE.
+struct FindEdgeNeighbors
+{
+  vtkPolyData *Mesh;
+  const vtkIdType *CellOffsets;
+  vtkIdType *EdgeNeighbors;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    vtkIdType npts, *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkIdType *neighbors = this->EdgeNeighbors + this->CellOffsets[cellId];
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        this->Mesh->GetCellEdgeNeighbors(cellId, pts[j], pts[(j + 1) % npts],
+                                         cellIds);
+        vtkIdType numNeighbors = cellIds->GetNumberOfIds();
+        neighbors[j] = (numNeighbors == 0 ? VTK_BOUNDARY_EDGE :
+          (numNeighbors == 1 ? cellIds->GetId(0) : VTK_NON_MANIFOLD_EDGE));
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Propagate a wave of consistently ordered polygons from the seed of each
+// connected component. The components are disjoint so they are processed
+// in parallel. A reversed polygon is flagged so that its edges can still be
+// looked up in the edge neighbor table, which refers to the input ordering.
+struct OrderComponents
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *EdgeNeighbors;
+  const vtkIdType *Components;
+  const vtkIdType *Seeds;
+  const unsigned char *ReverseSeeds;
+  unsigned char *Visited;
+  unsigned char *Flipped;
+  int *NumFlips;
+  bool NonManifoldTraversal;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Wave;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Wave2;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void ReverseCell(vtkIdType cellId)
+  {
+    vtkIdType npts, *pts;
+    this->NewMesh->GetCellPoints(cellId, npts, pts);
+    std::reverse(pts, pts + npts);
+    this->Flipped[cellId] ^= 1;
+  }
+
+  void operator()(vtkIdType component, vtkIdType endComponent)
+  {
+    std::vector<vtkIdType> &wave = this->Wave.Local();
+    std::vector<vtkIdType> &wave2 = this->Wave2.Local();
+    vtkIdList *cellIds = this->CellIds.Local();
+    vtkIdType npts, *pts, numNeiPts, *neiPts;
+
+    for ( ; component < endComponent; ++component )
+    {
+      vtkIdType seed = this->Seeds[component];
+      if ( seed < 0 )
+      {
+        continue;
+      }
+      int numFlips = 0;
+      if ( this->ReverseSeeds[component] )
+      {
+        this->ReverseCell(seed);
+        numFlips++;
+      }
+      this->Visited[seed] = 1;
+      wave.clear();
+      wave.push_back(seed);
+
+      // propagate wave until nothing left in wave
+      while ( !wave.empty() )
+      {
+        wave2.clear();
+        for (size_t i = 0; i < wave.size(); ++i)
+        {
+          vtkIdType cellId = wave[i];
+          this->NewMesh->GetCellPoints(cellId, npts, pts);
+          const vtkIdType *neighbors =
+            this->EdgeNeighbors + this->CellOffsets[cellId];
+          bool flipped = (this->Flipped[cellId] != 0);
+
+          for (vtkIdType j = 0, j1 = 1; j < npts;
+               ++j, j1 = (j1 + 1 < npts ? j1 + 1 : 0))
+          {
+            // Edge j of a reversed polygon is edge npts-2-j of the input
+            // polygon (the closing edge stays the closing edge).
+            vtkIdType edge = (!flipped ? j : (j < npts - 1 ? npts - 2 - j :
+                                                             npts - 1));
+            const vtkIdType *neiCells;
+            vtkIdType numNeiCells;
+            if ( neighbors[edge] >= 0 )
+            {
+              neiCells = neighbors + edge;
+              numNeiCells = 1;
+            }
+            else if ( neighbors[edge] == VTK_NON_MANIFOLD_EDGE &&
+                      this->NonManifoldTraversal )
+            {
+              this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1],
+                                                  cellIds);
+              neiCells = cellIds->GetPointer(0);
+              numNeiCells = cellIds->GetNumberOfIds();
+            }
+            else
+            {
+              continue;
+            }
+
+            //  Check the direction of the neighbor ordering.  Should be
+            //  consistent with us (i.e., if we are n1->n2,
+            // neighbor should be n2->n1).
+            for (vtkIdType k = 0; k < numNeiCells; k++)
+            {
+              vtkIdType neighbor = neiCells[k];
+              if ( this->Components[neighbor] != component ||
+                   this->Visited[neighbor] )
+              {
+                continue;
+              }
+              this->NewMesh->GetCellPoints(neighbor, numNeiPts, neiPts);
+              vtkIdType l;
+              for (l = 0; l < numNeiPts; l++)
+              {
+                if (neiPts[l] == pts[j1])
+                {
+                  break;
+                }
+              }
+
+              //  Have to reverse ordering if neighbor not consistent
+              //
+              if ( neiPts[(l + 1) % numNeiPts] != pts[j] )
+              {
+                numFlips++;
+                this->ReverseCell(neighbor);
+              }
+              this->Visited[neighbor] = 1;
+              wave2.push_back(neighbor);
+            } // for each edge neighbor
+          } // for all edges of this polygon
+        } // for all cells in wave
+
+        //swap wave and proceed with propagation
+        wave.swap(wave2);
+      } // while wave still propagating
+      this->NumFlips[component] = numFlips;
+    } // for all components
+  }
+};
+
+//----------------------------------------------------------------------------
+// Split the points lying on feature edges. The polygons using a point are
+// grouped in regions of polygons connected by edges that are not feature
+// edges. For N regions, N-1 duplicate (split) points are created and replace
+// the point in the polygons of all but the first region. The first pass
+// counts the new points of each point; once the counts are scanned into
+// offsets, the second pass assigns the new points.
+struct SplitPoints
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *EdgeNeighbors;
+  const float *PolyNormals;
+  const unsigned char *Flipped;
+  double CosAngle;
+  vtkIdType NumPts;
+  vtkIdType *SplitOffsets;
+  vtkIdType *Map;
+  bool AssignPoints;
+  vtkSMPThreadLocal<std::vector<int> > Regions;
+
+  // Mark the region of each polygon using ptId. regions is indexed by the
+  // position of the first occurrence of the polygon in the point's links.
+  // Returns the number of regions.
+  int MarkRegions(vtkIdType ptId, unsigned short ncells,
+                  const vtkIdType *cells, std::vector<int>& regions)
+  {
+    regions.assign(ncells, -1);
+
+    vtkIdType numPts;
+    vtkIdType *pts;
+    int numRegions = 0;
+    vtkIdType spot, neiPt[2], nei, cellId, neiCellId, neiLoc;
+    double thisNormal[3], neiNormal[3];
+    for (int j = 0; j < ncells; j++) //for all cells connected to point
+    {
+      if ( regions[FindCell(cells, ncells, cells[j])] >= 0 )
+      {
+        continue;
+      }
+      regions[FindCell(cells, ncells, cells[j])] = numRegions;
+      //okay, mark all the cells connected to this seed cell and using ptId
+      this->OldMesh->GetCellPoints(cells[j], numPts, pts);
+
+      //find the two edges
+      for (spot = 0; spot < numPts; spot++)
+      {
+        if ( pts[spot] == ptId )
+        {
+          break;
+        }
+      }
+      if ( spot == 0 )
+      {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[numPts-1];
+      }
+      else if ( spot == (numPts-1) )
+      {
+        neiPt[0] = pts[spot-1];
+        neiPt[1] = pts[0];
+      }
+      else
+      {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[spot-1];
+      }
+
+      for (int i = 0; i < 2; i++) //for each of the two edges of the seed cell
+      {
+        cellId = cells[j];
+        nei = neiPt[i];
+        this->OldMesh->GetCellPoints(cellId, numPts, pts);
+        for (spot = 0; spot < numPts && pts[spot] != ptId; spot++)
+        {
+        }
+        while ( cellId >= 0 ) //while we can grow this region
+        {
+          vtkIdType edge = (pts[(spot + 1) % numPts] == nei ? spot :
+                            (spot + numPts - 1) % numPts);
+          neiCellId = this->EdgeNeighbors[this->CellOffsets[cellId] + edge];
+          if ( neiCellId >= 0 &&
+               regions[(neiLoc = FindCell(cells, ncells, neiCellId))] < 0 )
+          {
+            const float *n0 = this->PolyNormals + 3 * cellId;
+            const float *n1 = this->PolyNormals + 3 * neiCellId;
+            thisNormal[0] = n0[0]; thisNormal[1] = n0[1]; thisNormal[2] = n0[2];
+            neiNormal[0] = n1[0]; neiNormal[1] = n1[1]; neiNormal[2] = n1[2];
+
+            if ( vtkMath::Dot(thisNormal, neiNormal) > this->CosAngle )
+            {
+              //visit and arrange to visit next edge neighbor
+              regions[neiLoc] = numRegions;
+              cellId = neiCellId;
+              this->OldMesh->GetCellPoints(cellId, numPts, pts);
+
+              for (spot = 0; spot < numPts; spot++)
+              {
+                if ( pts[spot] == ptId )
+                {
+                  break;
+                }
+              }
+
+              if (spot == 0)
+              {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+              }
+              else if (spot == (numPts-1))
+              {
+                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+              }
+              else
+              {
+                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+              }
+            }//if not separated by edge angle
+            else
+            {
+              cellId = -1; //separated by edge angle
+            }
+          }//if can move to edge neighbor
+          else
+          {
+            cellId = -1;//separated by previous visit, boundary, or non-manifold
+          }
+        }//while visit wave is propagating
+      }//for each of the two edges of the starting cell
+      numRegions++;
+    }//for all cells connected to point ptId
+
+    return numRegions;
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    std::vector<int> &regions = this->Regions.Local();
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts, *newPts;
+
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      if ( this->AssignPoints &&
+           this->SplitOffsets[ptId + 1] == this->SplitOffsets[ptId] )
+      {
+        continue; // nothing to split
+      }
+
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      int numRegions = (ncells <= 1 ? 1 :
+                        this->MarkRegions(ptId, ncells, cells, regions));
+      if ( !this->AssignPoints )
+      {
+        this->SplitOffsets[ptId] = numRegions - 1;
+        continue;
+      }
+
+      // The polygons not in the first region use a duplicate of ptId, which
+      // replaces all the occurrences of ptId in their connectivity.
+      vtkIdType firstNewId = this->NumPts + this->SplitOffsets[ptId] - 1;
+      for (int i = 1; i < numRegions; i++)
+      {
+        this->Map[firstNewId + i - this->NumPts] = ptId;
+      }
+      for (int j = 0; j < ncells; j++)
+      {
+        int region = regions[j];
+        if ( region <= 0 || (j > 0 && cells[j - 1] == cells[j]) )
+        {
+          continue;
+        }
+        this->OldMesh->GetCellPoints(cells[j], npts, pts);
+        this->NewMesh->GetCellPoints(cells[j], npts, newPts);
+        bool flipped = (this->Flipped && this->Flipped[cells[j]]);
+        for (vtkIdType i = 0; i < npts; i++)
+        {
+          if ( pts[i] == ptId )
+          {
+            newPts[flipped ? npts - 1 - i : i] = firstNewId + region;
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the normals of the polygons using each point.
+struct GatherPointNormals
+{
+  vtkStaticCellLinks *Links;
+  const float *PolyNormals;
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      // The links are sorted by decreasing cell id. They are traversed
+      // backwards so that the normals are summed in the order of the cells.
+      vtkIdType ncells = this->Links->GetNumberOfCells(ptId);
+      const vtkIdType *cells = this->Links->GetCells(ptId);
+      float *n = this->Normals + 3 * ptId;
+      n[0] = n[1] = n[2] = 0.0f;
+      for (vtkIdType i = ncells - 1; i >= 0; --i)
+      {
+        const float *polyNormal = this->PolyNormals + 3 * cells[i];
+        n[0] += polyNormal[0];
+        n[1] += polyNormal[1];
+        n[2] += polyNormal[2];
+      }
+
+      const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) *
+        this->FlipDirection;
+      if (length != 0.0)
+      {
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -55,52 +517,34 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->Visited = nullptr;
   this->PolyNormals = nullptr;
   this->CosAngle = 0.0;
+  this->ParallelExecution = 0;
 }
 
+
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
-// Generate normals for polygon meshes
-int vtkPolyDataNormals::RequestData(
-  vtkInformation *vtkNotUsed(request),
-  vtkInformationVector **inputVector,
-  vtkInformationVector *outputVector)
+// Load the polygons of the input, with the strips decomposed into triangles,
+// into OldMesh and NewMesh. Returns 0 when there is nothing to compute, in
+// which case the output is already set.
+int vtkPolyDataNormals::LoadMeshes(vtkPolyData *input, vtkPolyData *output,
+                                   bool legacyStorage)
 {
-  // get the info objects
-  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
-
-  // get the input and output
-  vtkPolyData *input = vtkPolyData::SafeDownCast(
-    inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkPolyData *output = vtkPolyData::SafeDownCast(
-    outInfo->Get(vtkDataObject::DATA_OBJECT()));
-
   vtkIdType npts = 0;
   vtkIdType *pts = nullptr;
-  vtkIdType numNewPts;
-  double flipDirection=1.0;
   vtkIdType numPolys, numStrips;
-  vtkIdType cellId;
-  vtkIdType numPts;
+  vtkCellArray *inPolys, *inStrips, *polys, *newPolys;
   vtkPoints *inPts;
-  vtkCellArray *inPolys, *inStrips, *polys;
-  vtkPoints *newPts = nullptr;
-  vtkFloatArray *newNormals;
-  vtkPointData *pd, *outPD;
   vtkDataSetAttributes* outCD = output->GetCellData();
-  double n[3];
-  vtkCellArray *newPolys;
-  vtkIdType ptId, oldId;
 
   vtkDebugMacro(<<"Generating surface normals");
 
   numPolys=input->GetNumberOfPolys();
   numStrips=input->GetNumberOfStrips();
-  if ( (numPts=input->GetNumberOfPoints()) < 1 )
+  if ( input->GetNumberOfPoints() < 1 )
   {
     vtkDebugMacro(<<"No data to generate normals for!");
-    return 1;
+    return 0;
   }
 
 
@@ -111,7 +555,7 @@ int vtkPolyDataNormals::RequestData(
     output->CopyStructure(input);
     output->GetPointData()->PassData(input->GetPointData());
     output->GetCellData()->PassData(input->GetCellData());
-    return 1;
+    return 0;
   }
 
   if (numStrips < 1)
@@ -167,7 +611,17 @@ int vtkPolyDataNormals::RequestData(
     }
     this->OldMesh->SetPolys(polys);
     polys->Delete();
-    numPolys = polys->GetNumberOfCells();//added some new triangles
+  }
+  else if ( legacyStorage &&
+            inPolys->GetStorageType() != vtkCellArray::LEGACY_STORAGE )
+  {
+    // The cells are accessed concurrently through pointers into the
+    // legacy storage.
+    polys = vtkCellArray::New();
+    polys->DeepCopy(inPolys);
+    polys->UseLegacyStorage();
+    this->OldMesh->SetPolys(polys);
+    polys->Delete();
   }
   else
   {
@@ -175,10 +629,6 @@ int vtkPolyDataNormals::RequestData(
     polys = inPolys;
   }
   this->OldMesh->BuildLinks();
-  this->UpdateProgress(0.10);
-
-  pd = input->GetPointData();
-  outPD = output->GetPointData();
 
   this->NewMesh = vtkPolyData::New();
   this->NewMesh->SetPoints(inPts);
@@ -186,8 +636,159 @@ int vtkPolyDataNormals::RequestData(
   newPolys = vtkCellArray::New();
   newPolys->DeepCopy(polys);
   this->NewMesh->SetPolys(newPolys);
+  newPolys->Delete();
   this->NewMesh->BuildCells(); //builds connectivity
 
+  return 1;
+}
+
+// Set the points and the point data of the output. The points past the input
+// ones duplicate the input points given by newPointMap.
+void vtkPolyDataNormals::CopyPoints(vtkPolyData *input, vtkPolyData *output,
+                                    vtkIdType numNewPts,
+                                    const vtkIdType *newPointMap)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *pd = input->GetPointData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkIdType ptId, oldId;
+
+  outPD->CopyNormalsOff();
+
+  //  If no new nodes have been created (i.e., no splitting), we can simply
+  //  pass data through.
+  //
+  if ( ! this->Splitting )
+  {
+    outPD->PassData(pd);
+    output->SetPoints(inPts);
+    return;
+  }
+
+  outPD->CopyAllocate(pd,numNewPts);
+
+  vtkPoints *newPts = vtkPoints::New();
+
+  // set precision for the points in the output
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
+    if(inputPointSet)
+    {
+      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
+    }
+    else
+    {
+      newPts->SetDataType(VTK_FLOAT);
+    }
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+
+  newPts->SetNumberOfPoints(numNewPts);
+  for (ptId=0; ptId < numNewPts; ptId++)
+  {
+    oldId = (ptId < numPts ? ptId : newPointMap[ptId - numPts]);
+    newPts->SetPoint(ptId,inPts->GetPoint(oldId));
+    outPD->CopyData(pd,oldId,ptId);
+  }
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+}
+
+// Set the normals and the cells of the output, then release the meshes.
+void vtkPolyDataNormals::AssembleOutput(vtkPolyData *input,
+                                        vtkPolyData *output,
+                                        vtkFloatArray *pointNormals)
+{
+  if (this->ComputeCellNormals)
+  {
+    output->GetCellData()->SetNormals(this->PolyNormals);
+  }
+
+  if (this->ComputePointNormals)
+  {
+    output->GetPointData()->SetNormals(pointNormals);
+  }
+
+  output->SetPolys(this->NewMesh->GetPolys());
+
+  // copy the original vertices and lines to the output
+  output->SetVerts(input->GetVerts());
+  output->SetLines(input->GetLines());
+
+  this->ReleaseMeshes();
+}
+
+// Release the meshes and the polygon normals.
+void vtkPolyDataNormals::ReleaseMeshes()
+{
+  if (this->OldMesh)
+  {
+    this->OldMesh->Delete();
+    this->OldMesh = nullptr;
+  }
+  if (this->NewMesh)
+  {
+    this->NewMesh->Delete();
+    this->NewMesh = nullptr;
+  }
+  if (this->PolyNormals)
+  {
+    this->PolyNormals->Delete();
+    this->PolyNormals = nullptr;
+  }
+}
+
+// Generate normals for polygon meshes
+int vtkPolyDataNormals::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkPolyData *input = vtkPolyData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  if (this->ParallelExecution)
+  {
+    return this->ParallelExecute(input, output);
+  }
+
+  vtkIdType npts = 0;
+  vtkIdType *pts = nullptr;
+  vtkIdType numNewPts;
+  double flipDirection=1.0;
+  vtkIdType cellId;
+  vtkFloatArray *newNormals;
+  double n[3];
+  vtkIdType ptId;
+
+  if (!this->LoadMeshes(input, output, false))
+  {
+    return 1;
+  }
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numPolys = this->OldMesh->GetNumberOfPolys();
+  vtkPoints *inPts = input->GetPoints();
+  vtkCellArray *newPolys = this->NewMesh->GetPolys();
+  this->UpdateProgress(0.10);
+
+
   // The visited array keeps track of which polygons have been visited.
   //
   if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
@@ -390,48 +991,14 @@ int vtkPolyDataNormals::RequestData(
 
     //  Now need to map attributes of old points into new points.
     //
-    outPD->CopyNormalsOff();
-    outPD->CopyAllocate(pd,numNewPts);
-
-    newPts = vtkPoints::New();
-
-    // set precision for the points in the output
-    if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-    {
-      vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
-      if(inputPointSet)
-      {
-        newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-      }
-      else
-      {
-        newPts->SetDataType(VTK_FLOAT);
-      }
-    }
-    else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-    {
-      newPts->SetDataType(VTK_FLOAT);
-    }
-    else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-    {
-      newPts->SetDataType(VTK_DOUBLE);
-    }
-
-    newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
-    {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
-    }
+    this->CopyPoints(input, output, numNewPts, this->Map->GetPointer(numPts));
     this->Map->Delete();
   } //splitting
 
   else //no splitting, so no new points
   {
     numNewPts = numPts;
-    outPD->CopyNormalsOff();
-    outPD->PassData(pd);
+    this->CopyPoints(input, output, numNewPts, nullptr);
   }
 
   if ( this->Consistency || this->Splitting )
@@ -487,44 +1054,9 @@ int vtkPolyDataNormals::RequestData(
     }
   }
 
-  //  Update ourselves.  If no new nodes have been created (i.e., no
-  //  splitting), we can simply pass data through.
-  //
-  if ( ! this->Splitting )
-  {
-    output->SetPoints(inPts);
-  }
-
-  //  If there is splitting, then have to send down the new data.
-  //
-  else
-  {
-    output->SetPoints(newPts);
-    newPts->Delete();
-  }
-
-  if (this->ComputeCellNormals)
-  {
-    outCD->SetNormals(this->PolyNormals);
-  }
-  this->PolyNormals->Delete();
-
-  if (this->ComputePointNormals)
-  {
-    outPD->SetNormals(newNormals);
-  }
+  this->AssembleOutput(input, output, newNormals);
   newNormals->Delete();
 
-  output->SetPolys(newPolys);
-  newPolys->Delete();
-
-  // copy the original vertices and lines to the output
-  output->SetVerts(input->GetVerts());
-  output->SetLines(input->GetLines());
-
-  this->OldMesh->Delete();
-  this->NewMesh->Delete();
-
   return 1;
 }
 
@@ -754,6 +1286,351 @@ void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
   }//for all cells connected to ptId
 }
 
+// Generate normals for polygon meshes with vtkSMPTools. The polygons are
+// ordered and the points split like the serial path does, so the output
+// is the same.
+int vtkPolyDataNormals::ParallelExecute(vtkPolyData *input,
+                                        vtkPolyData *output)
+{
+  vtkIdType npts = 0;
+  vtkIdType *pts = nullptr;
+  vtkIdType numNewPts;
+  double flipDirection=1.0;
+  vtkIdType cellId;
+  vtkFloatArray *newNormals;
+  double n[3];
+  vtkIdType ptId;
+
+  if (!this->LoadMeshes(input, output, true))
+  {
+    return 1;
+  }
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numPolys = this->OldMesh->GetNumberOfPolys();
+  vtkPoints *inPts = input->GetPoints();
+  vtkPolyData *oldMesh = this->OldMesh;
+  vtkPolyData *newMesh = this->NewMesh;
+  this->UpdateProgress(0.10);
+  if (this->GetAbortExecute())
+  {
+    this->ReleaseMeshes();
+    return 1;
+  }
+
+  // The edge neighbor table gives, for each edge of each polygon, the other
+  // polygon using the edge. It is shared by the ordering and the splitting.
+  //
+  std::vector<vtkIdType> cellOffsets;
+  std::vector<vtkIdType> edgeNeighbors;
+  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+  {
+    cellOffsets.resize(numPolys + 1);
+    CountPolyPoints counter = { oldMesh, &cellOffsets[0] };
+    vtkSMPTools::For(0, numPolys, counter);
+    cellOffsets[numPolys] = 0;
+    vtkSMPTools::ExclusiveScan(cellOffsets.begin(), cellOffsets.end(),
+                               cellOffsets.begin(), static_cast<vtkIdType>(0));
+
+    edgeNeighbors.resize(cellOffsets[numPolys] + 1);
+    FindEdgeNeighbors finder;
+    finder.Mesh = oldMesh;
+    finder.CellOffsets = &cellOffsets[0];
+    finder.EdgeNeighbors = &edgeNeighbors[0];
+    vtkSMPTools::For(0, numPolys, finder);
+  }
+  this->UpdateProgress(0.20);
+  if (this->GetAbortExecute())
+  {
+    this->ReleaseMeshes();
+    return 1;
+  }
+
+  //  Traverse all polygons insuring proper direction of ordering.  This
+  //  works by propagating a wave from a seed polygon to the polygon's
+  //  edge neighbors. Each neighbor may be reordered to maintain consistency
+  //  with its (already checked) neighbors. The polygons reached from a seed
+  //  form a connected component; the components are found first, then
+  //  ordered in parallel.
+  //
+  this->NumFlips = 0;
+  std::vector<unsigned char> flipped;
+  if ( this->Consistency || this->AutoOrientNormals )
+  {
+    // Label the components, seeding them by increasing polygon id.
+    std::vector<vtkIdType> components(numPolys, -1);
+    std::vector<vtkIdType> seeds;
+    std::vector<vtkIdType> stack;
+    vtkNew<vtkIdList> cellIds;
+    for (cellId=0; cellId < numPolys; cellId++)
+    {
+      if ( components[cellId] >= 0 )
+      {
+        continue;
+      }
+      vtkIdType component = static_cast<vtkIdType>(seeds.size());
+      seeds.push_back(cellId);
+      components[cellId] = component;
+      stack.push_back(cellId);
+      while ( !stack.empty() )
+      {
+        vtkIdType current = stack.back();
+        stack.pop_back();
+        oldMesh->GetCellPoints(current, npts, pts);
+        const vtkIdType *neighbors = &edgeNeighbors[cellOffsets[current]];
+        for (vtkIdType j = 0; j < npts; j++)
+        {
+          if ( neighbors[j] >= 0 )
+          {
+            if ( components[neighbors[j]] < 0 )
+            {
+              components[neighbors[j]] = component;
+              stack.push_back(neighbors[j]);
+            }
+          }
+          else if ( neighbors[j] == VTK_NON_MANIFOLD_EDGE &&
+                    this->NonManifoldTraversal )
+          {
+            oldMesh->GetCellEdgeNeighbors(current, pts[j],
+                                          pts[(j + 1) % npts], cellIds);
+            for (vtkIdType k = 0; k < cellIds->GetNumberOfIds(); k++)
+            {
+              if ( components[cellIds->GetId(k)] < 0 )
+              {
+                components[cellIds->GetId(k)] = component;
+                stack.push_back(cellIds->GetId(k));
+              }
+            }
+          }
+        }
+      }
+    }
+    vtkIdType numComponents = static_cast<vtkIdType>(seeds.size());
+    std::vector<unsigned char> reverseSeeds(numComponents, 0);
+
+    if (this->AutoOrientNormals)
+    {
+      // No need to check this->Consistency. It's implied.
+
+      // Ok, here's the basic idea: the "left-most" polygon should
+      // have its outward pointing normal facing left. If it doesn't,
+      // reverse the vertex order. Then use it as the seed for other
+      // connected polys. To find left-most polygon, first find left-most
+      // point, and examine neighboring polys and see which one
+      // has a normal that's "most aligned" with the X-axis. This process
+      // will need to be repeated to handle all connected components in
+      // the mesh. Report bugs/issues to cvolpe@ara.com.
+      int foundLeftmostCell;
+      vtkIdType leftmostCellID=-1, currentPointID, currentCellID;
+      vtkIdType *leftmostCells;
+      unsigned short nleftmostCells;
+      vtkIdType *cellPts;
+      vtkIdType nCellPts;
+      int cIdx;
+      double bestNormalAbsXComponent;
+      int bestReverseFlag;
+      vtkIdType numSeeded = 0;
+      vtkPriorityQueue *leftmostPoints = vtkPriorityQueue::New();
+      std::fill(seeds.begin(), seeds.end(), -1);
+
+      // Put all the points in the priority queue, based on x coord
+      // So that we can find leftmost point
+      leftmostPoints->Allocate(numPts);
+      for (ptId=0; ptId < numPts; ptId++)
+      {
+        leftmostPoints->Insert(inPts->GetPoint(ptId)[0],ptId);
+      }
+
+      // Repeat this while loop as long as the queue is not empty,
+      // because there may be multiple connected components, each of
+      // which needs to be seeded independently with a correctly
+      // oriented polygon.
+      while (leftmostPoints->GetNumberOfItems() && numSeeded < numComponents)
+      {
+        foundLeftmostCell = 0;
+        // Keep iterating through leftmost points and cells located at
+        // those points until I've got a leftmost point with
+        // cells of unseeded components attached and I've found the best
+        // cell at that point
+        do {
+          currentPointID = leftmostPoints->Pop();
+          oldMesh->GetPointCells(currentPointID, nleftmostCells, leftmostCells);
+          bestNormalAbsXComponent = 0.0;
+          bestReverseFlag = 0;
+          for (cIdx = 0; cIdx < nleftmostCells; cIdx++)
+          {
+            currentCellID = leftmostCells[cIdx];
+            if (seeds[components[currentCellID]] >= 0)
+            {
+              continue;
+            }
+            oldMesh->GetCellPoints(currentCellID, nCellPts, cellPts);
+            vtkPolygon::ComputeNormal(inPts, nCellPts, cellPts, n);
+            // Ok, see if this leftmost cell candidate is the best
+            // so far
+            if (fabs(n[0]) > bestNormalAbsXComponent)
+            {
+              bestNormalAbsXComponent = fabs(n[0]);
+              leftmostCellID = currentCellID;
+              // If the current leftmost cell's normal is pointing to the
+              // right, then the vertex ordering is wrong
+              bestReverseFlag = (n[0] > 0);
+              foundLeftmostCell = 1;
+            } // if this normal is most x-aligned so far
+          } // for each cell at current leftmost point
+        } while (leftmostPoints->GetNumberOfItems() && !foundLeftmostCell);
+        if (foundLeftmostCell)
+        {
+          // We've got the seed for a connected component! But do
+          // we need to flip it first? We do, if it was pointed the wrong
+          // way to begin with, or if the user requested flipping all
+          // normals, but if both are true, then we leave it as it is.
+          seeds[components[leftmostCellID]] = leftmostCellID;
+          reverseSeeds[components[leftmostCellID]] =
+            (bestReverseFlag ^ this->FlipNormals) ? 1 : 0;
+          numSeeded++;
+        } // if found leftmost cell
+      } // Still some points in the queue
+      leftmostPoints->Delete();
+    } // automatically orient normals
+    else if ( this->FlipNormals )
+    {
+      std::fill(reverseSeeds.begin(), reverseSeeds.end(), 1);
+    }
+
+    std::vector<unsigned char> visited(numPolys, 0);
+    std::vector<int> numFlips(numComponents, 0);
+    flipped.resize(numPolys, 0);
+    OrderComponents orderer;
+    orderer.OldMesh = oldMesh;
+    orderer.NewMesh = newMesh;
+    orderer.CellOffsets = &cellOffsets[0];
+    orderer.EdgeNeighbors = &edgeNeighbors[0];
+    orderer.Components = &components[0];
+    orderer.Seeds = &seeds[0];
+    orderer.ReverseSeeds = &reverseSeeds[0];
+    orderer.Visited = &visited[0];
+    orderer.Flipped = &flipped[0];
+    orderer.NumFlips = &numFlips[0];
+    orderer.NonManifoldTraversal = (this->NonManifoldTraversal != 0);
+    vtkSMPTools::For(0, numComponents, 1, orderer);
+    this->NumFlips = vtkSMPTools::Reduce(numFlips.begin(), numFlips.end(), 0);
+    vtkDebugMacro(<<"Reversed ordering of " << this->NumFlips << " polygons");
+  } //Consistent ordering
+
+  this->UpdateProgress(0.333);
+  if (this->GetAbortExecute())
+  {
+    this->ReleaseMeshes();
+    return 1;
+  }
+
+  //  Initial pass to compute polygon normals without effects of neighbors
+  //
+  this->PolyNormals = vtkFloatArray::New();
+  this->PolyNormals->SetNumberOfComponents(3);
+  this->PolyNormals->SetName("Normals");
+  this->PolyNormals->SetNumberOfTuples(numPolys);
+  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
+
+  ComputePolyNormals polyNormalsWorker = { newMesh, inPts, fPolyNormals };
+  vtkSMPTools::For(0, numPolys, polyNormalsWorker);
+  this->UpdateProgress(0.666);
+  if (this->GetAbortExecute())
+  {
+    this->ReleaseMeshes();
+    return 1;
+  }
+
+  // Split mesh if sharp features
+  if ( this->Splitting )
+  {
+    //  Traverse all nodes; evaluate loops and feature edges.  If feature
+    //  edges found, split mesh creating new nodes.  Update polygon
+    // connectivity.
+    //
+    std::vector<vtkIdType> splitOffsets(numPts + 1, 0);
+    std::vector<vtkIdType> map;
+    SplitPoints splitter;
+    splitter.OldMesh = oldMesh;
+    splitter.NewMesh = newMesh;
+    splitter.CellOffsets = &cellOffsets[0];
+    splitter.EdgeNeighbors = &edgeNeighbors[0];
+    splitter.PolyNormals = fPolyNormals;
+    splitter.Flipped = (flipped.empty() ? nullptr : &flipped[0]);
+    splitter.CosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
+    splitter.NumPts = numPts;
+    splitter.SplitOffsets = &splitOffsets[0];
+    splitter.Map = nullptr;
+    splitter.AssignPoints = false;
+    vtkSMPTools::For(0, numPts, splitter);
+
+    //  Splitting will create new points. The new points are numbered in the
+    //  order of the points they duplicate; the map gives the original point
+    //  of each new point.
+    //
+    vtkSMPTools::ExclusiveScan(splitOffsets.begin(), splitOffsets.end(),
+                               splitOffsets.begin(), static_cast<vtkIdType>(0));
+    numNewPts = numPts + splitOffsets[numPts];
+    if ( numNewPts > numPts )
+    {
+      map.resize(numNewPts - numPts);
+      splitter.Map = &map[0];
+      splitter.AssignPoints = true;
+      vtkSMPTools::For(0, numPts, splitter);
+    }
+
+    vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
+
+    //  Now need to map attributes of old points into new points.
+    //
+    this->CopyPoints(input, output, numNewPts, map.empty() ? nullptr : &map[0]);
+  } //splitting
+
+  else //no splitting, so no new points
+  {
+    numNewPts = numPts;
+    this->CopyPoints(input, output, numNewPts, nullptr);
+  }
+
+  this->UpdateProgress(0.80);
+  if (this->GetAbortExecute())
+  {
+    this->ReleaseMeshes();
+    return 1;
+  }
+
+  //  Finally, gather the polygon normals at the points.
+  //
+  if ( this->FlipNormals && ! this->Consistency )
+  {
+    flipDirection = -1.0;
+  }
+
+  newNormals = vtkFloatArray::New();
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(numNewPts);
+  newNormals->SetName("Normals");
+
+  if (this->ComputePointNormals)
+  {
+    vtkNew<vtkPolyData> mesh;
+    mesh->SetPoints(output->GetPoints());
+    mesh->SetPolys(newMesh->GetPolys());
+    vtkNew<vtkStaticCellLinks> links;
+    links->BuildLinks(mesh);
+
+    GatherPointNormals pointNormalsWorker = { links.GetPointer(),
+      fPolyNormals, newNormals->WritePointer(0, 3 * numNewPts),
+      flipDirection };
+    vtkSMPTools::For(0, numNewPts, pointNormalsWorker);
+  }
+
+  this->AssembleOutput(input, output, newNormals);
+  newNormals->Delete();
+
+  return 1;
+}
+
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -772,5 +1649,7 @@ void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
      << (this->NonManifoldTraversal ? "On\n" : "Off\n");
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Execution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
 
@@ -39,6 +39,11 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * When ParallelExecution is on, the polygon normals, the consistent
+ * ordering of the polygons (each connected component is processed
+ * independently), the splitting of sharp edges and the point normals are
+ * computed in parallel with vtkSMPTools.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
@@ -173,6 +178,24 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the computation of the normals in parallel with
+   * vtkSMPTools. The output is the same as the serial one, whatever the
+   * number of threads. Off by default.
+   */
+  vtkSetMacro(ParallelExecution,vtkTypeBool);
+  vtkGetMacro(ParallelExecution,vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution,vtkTypeBool);
+  //@}
+
+  /**
+   * Get the number of polygons whose ordering was reversed by the last
+   * execution to make the ordering consistent (and outward when
+   * AutoOrientNormals is on).
+   */
+  vtkGetMacro(NumFlips, int);
+
 protected:
   vtkPolyDataNormals();
   ~vtkPolyDataNormals() override {}
@@ -180,6 +203,9 @@ protected:
   // Usual data generation method
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
+  // The parallel data generation method, used when ParallelExecution is on.
+  int ParallelExecute(vtkPolyData *input, vtkPolyData *output);
+
   double FeatureAngle;
   vtkTypeBool Splitting;
   vtkTypeBool Consistency;
@@ -190,6 +216,7 @@ protected:
   vtkTypeBool ComputeCellNormals;
   int NumFlips;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelExecution;
 
 private:
   vtkIdList *Wave;
@@ -211,6 +238,25 @@ private:
   // separate the mesh.
   void MarkAndSplit(vtkIdType ptId);
 
+  // Load the polygons of the input, with the strips decomposed into
+  // triangles, into OldMesh and NewMesh. Returns 0 when there is nothing
+  // to compute, in which case the output is already set. Both execution
+  // paths share this setup and the output assembly below.
+  int LoadMeshes(vtkPolyData *input, vtkPolyData *output,
+                 bool legacyStorage);
+
+  // Set the points and the point data of the output. The points past the
+  // input ones duplicate the input points given by newPointMap.
+  void CopyPoints(vtkPolyData *input, vtkPolyData *output,
+                  vtkIdType numNewPts, const vtkIdType *newPointMap);
+
+  // Set the normals and the cells of the output, then release the meshes.
+  void AssembleOutput(vtkPolyData *input, vtkPolyData *output,
+                      vtkFloatArray *pointNormals);
+
+  // Release OldMesh, NewMesh and PolyNormals.
+  void ReleaseMeshes();
+
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) = delete;
   void operator=(const vtkPolyDataNormals&) = delete;
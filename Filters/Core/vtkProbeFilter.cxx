@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkProbeFilter.h"
 
+#include "vtkAbstractCellLocator.h"
 #include "vtkBoundingBox.h"
 #include "vtkCell.h"
 #include "vtkCellData.h"
@@ -24,10 +25,13 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocal.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <algorithm>
@@ -62,6 +66,7 @@ vtkProbeFilter::vtkProbeFilter()
   this->PassFieldArrays = 1;
   this->Tolerance = 1.0;
   this->ComputeTolerance = 1;
+  this->CellLocatorPrototype = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -79,8 +84,13 @@ vtkProbeFilter::~vtkProbeFilter()
 
   delete this->PointList;
   delete this->CellList;
+  this->SetCellLocatorPrototype(nullptr);
 }
 
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkProbeFilter, CellLocatorPrototype,
+                     vtkAbstractCellLocator);
+
 //----------------------------------------------------------------------------
 void vtkProbeFilter::SetSourceConnection(vtkAlgorithmOutput* algOutput)
 {
@@ -395,6 +405,31 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   tol2 = this->ComputeTolerance ? VTK_DOUBLE_MAX :
          (this->Tolerance * this->Tolerance);
 
+  // With a cell locator, find the cells of all the points to probe at once.
+  vtkSmartPointer<vtkIdTypeArray> locatedCellIds;
+  if (this->CellLocatorPrototype)
+  {
+    vtkSmartPointer<vtkAbstractCellLocator> locator;
+    locator.TakeReference(this->CellLocatorPrototype->NewInstance());
+    locator->SetDataSet(source);
+    locator->BuildLocator();
+
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    points->Allocate(numPts);
+    for (ptId=0; ptId < numPts; ptId++)
+    {
+      if (maskArray[ptId] != static_cast<char>(1))
+      {
+        input->GetPoint(ptId, x);
+        points->InsertNextPoint(x);
+      }
+    }
+    locatedCellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    locator->FindCells(points, locatedCellIds);
+  }
+  vtkIdType queryId = 0;
+
   // Loop over all input points, interpolating source data
   //
   int abort=0;
@@ -418,11 +453,25 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
     input->GetPoint(ptId, x);
 
     // Find the cell that contains xyz and get it
-    vtkIdType cellId = source->FindCell(x,nullptr,-1,tol2,subId,pcoords,weights);
+    vtkIdType cellId;
+    if (locatedCellIds)
+    {
+      cellId = locatedCellIds->GetValue(queryId++);
+    }
+    else
+    {
+      cellId = source->FindCell(x,nullptr,-1,tol2,subId,pcoords,weights);
+    }
     if (cellId >= 0)
     {
       cell = source->GetCell(cellId);
-      if (this->ComputeTolerance)
+      if (locatedCellIds && !this->ComputeTolerance)
+      {
+        // The weights are not computed by the locator.
+        double dist2;
+        cell->EvaluatePosition(x, nullptr, subId, pcoords, dist2, weights);
+      }
+      else if (this->ComputeTolerance)
       {
         // If ComputeTolerance is set, compute a tolerance proportional to the
         // cell length.
@@ -885,4 +934,6 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
     this->ValidPointMaskArrayName : "vtkValidPointMask") << "\n";
   os << indent << "PassFieldArrays: "
      << (this->PassFieldArrays? "On" : " Off") << "\n";
+  os << indent << "CellLocatorPrototype: " << this->CellLocatorPrototype
+     << "\n";
 }
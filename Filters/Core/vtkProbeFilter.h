@@ -42,6 +42,7 @@
 #include "vtkDataSetAlgorithm.h"
 #include "vtkDataSetAttributes.h" // needed for vtkDataSetAttributes::FieldList
 
+class vtkAbstractCellLocator;
 class vtkIdTypeArray;
 class vtkCell;
 class vtkCharArray;
@@ -170,6 +171,21 @@ public:
   vtkGetMacro(ComputeTolerance, bool);
   //@}
 
+  //@{
+  /**
+   * Set/Get the prototype of the cell locator used to find the source cells
+   * containing the input points. When set, a locator of the same type is
+   * built over each source and the cells of all the points to probe are
+   * found at once with vtkAbstractCellLocator::FindCells(), in parallel for
+   * the locators supporting it (e.g. vtkCellLocator, vtkStaticCellLocator
+   * or vtkCellTreeLocator). Only the points lying inside a cell are then
+   * probed and Tolerance is not used. By default it is nullptr and the cells
+   * are found with vtkDataSet::FindCell().
+   */
+  virtual void SetCellLocatorPrototype(vtkAbstractCellLocator*);
+  vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
+  //@}
+
 protected:
   vtkProbeFilter();
   ~vtkProbeFilter() override;
@@ -185,6 +201,8 @@ protected:
   double Tolerance;
   bool ComputeTolerance;
 
+  vtkAbstractCellLocator *CellLocatorPrototype;
+
   int RequestData(vtkInformation *, vtkInformationVector **,
     vtkInformationVector *) override;
   int RequestInformation(vtkInformation *, vtkInformationVector **,
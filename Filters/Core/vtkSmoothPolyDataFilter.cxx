@@ -24,11 +24,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
-#include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmoothingTopologyHelper.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkTriangleFilter.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -151,25 +154,8 @@ vtkPolyData *vtkSmoothPolyDataFilter::GetSource()
     this->GetExecutive()->GetInputData(1, 0));
 }
 
-#define VTK_SIMPLE_VERTEX 0
-#define VTK_FIXED_VERTEX 1
-#define VTK_FEATURE_EDGE_VERTEX 2
-#define VTK_BOUNDARY_EDGE_VERTEX 3
-
 namespace {
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
-{
-  char      type;
-  vtkIdList *edges; // connected edges (list of connected point ids)
-  _vtkMeshVertex()
-  {
-    type = VTK_SIMPLE_VERTEX; //can smooth
-    edges = nullptr;
-  }
-} vtkMeshVertex, *vtkMeshVertexPtr;
-
 template<typename T> struct vtkSPDF_InternalParams
 {
   vtkSmoothPolyDataFilter* spdf;
@@ -178,16 +164,104 @@ template<typename T> struct vtkSPDF_InternalParams
   T factor;
   T conv;
   vtkIdType numPts;
-  vtkMeshVertexPtr vertexPtr;
+  const vtkSmoothingTopologyHelper *topology;
   vtkPolyData *source;
   vtkSmoothPoints *SmoothPoints;
   double *w;
   vtkCellLocator *cellLocator;
 };
 
+// Whether a point is moved by the smoothing.
+inline bool vtkSPDF_CanMove(const vtkSmoothingTopologyHelper *topology,
+                            vtkIdType ptId)
+{
+  return topology->GetVertexType(ptId) != vtkSmoothingTopologyHelper::FIXED_VERTEX &&
+    topology->GetNumberOfEdges(ptId) > 0;
+}
+
+// One iteration of the unconstrained smoothing, in parallel: the points of
+// Current are moved into Next, and the largest (cumulated) displacement
+// direction is kept for the convergence test.
+template<typename T> struct vtkSPDF_SmoothPoints
+{
+  const vtkSmoothingTopologyHelper *Topology;
+  T *Current;
+  T *Next;
+  T Factor;
+  vtkSMPThreadLocal<T> MaxDist;
+
+  void Initialize()
+  {
+    this->MaxDist.Local() = 0.0;
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    T &maxDist = this->MaxDist.Local();
+    T dist, deltaX[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const T *x = this->Current + 3 * ptId;
+      T *xNew = this->Next + 3 * ptId;
+      if (!vtkSPDF_CanMove(this->Topology, ptId))
+      {
+        xNew[0] = x[0];
+        xNew[1] = x[1];
+        xNew[2] = x[2];
+        continue;
+      }
+
+      // Compute the mean (cumulated) direction vector
+      vtkIdType npts = this->Topology->GetNumberOfEdges(ptId);
+      const vtkIdType *edgeIdPtr = this->Topology->GetEdges(ptId);
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        const T *y = this->Current + 3 * edgeIdPtr[j];
+        deltaX[0] += y[0];
+        deltaX[1] += y[1];
+        deltaX[2] += y[2];
+      }
+
+      // Move the point
+      for (int k = 0; k < 3; ++k)
+      {
+        xNew[k] = x[k] + this->Factor * (deltaX[k] / npts - x[k]);
+      }
+
+      if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+      {
+        maxDist = dist;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// The unconstrained smoothing updates all the points from their positions
+// at the previous iteration (Jacobi iterations), so that the points are
+// processed in parallel and the result does not depend on the number of
+// threads. Constrained smoothing uses a cell locator, which is not thread
+// safe: the points are moved in place, one at a time.
 template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
 {
   int iterationNumber = 0;
+  const vtkSmoothingTopologyHelper *topology = params.topology;
+  T* newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
+  std::vector<T> buffer;
+  vtkSPDF_SmoothPoints<T> smooth;
+  smooth.Topology = topology;
+  smooth.Current = newPtsCoords;
+  smooth.Factor = params.factor;
+  if (!params.source)
+  {
+    buffer.resize(3 * params.numPts);
+    smooth.Next = buffer.data();
+  }
+
   for (T maxDist = std::numeric_limits<T>::max();
        maxDist > params.conv && iterationNumber < params.numberOfIterations;
        ++iterationNumber)
@@ -202,10 +276,25 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     }
 
     maxDist = 0.0;
-    T* newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
-    T* start = newPtsCoords;
-    vtkMeshVertexPtr vertsPtr = params.vertexPtr;
-    vtkIdType npts, *edgeIdPtr;
+    if (!params.source)
+    {
+      // The threads not given a chunk by this pass are not initialized, so
+      // the distances of the previous passes are cleared first.
+      for (typename vtkSMPThreadLocal<T>::iterator iter = smooth.MaxDist.begin();
+           iter != smooth.MaxDist.end(); ++iter)
+      {
+        *iter = 0.0;
+      }
+      vtkSMPTools::For(0, params.numPts, smooth);
+      for (typename vtkSMPThreadLocal<T>::iterator iter = smooth.MaxDist.begin();
+           iter != smooth.MaxDist.end(); ++iter)
+      {
+        maxDist = std::max(maxDist, *iter);
+      }
+      std::swap(smooth.Current, smooth.Next);
+      continue;
+    }
+
     T dist, deltaX[3];
     double dist2, xNew[3], closestPt[3];
 
@@ -213,69 +302,60 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     // position of its connected neighbors using the relaxation factor.
     for (vtkIdType i = 0; i < params.numPts; ++i)
     {
-      if (vertsPtr->type != VTK_FIXED_VERTEX && vertsPtr->edges != nullptr &&
-         (npts = vertsPtr->edges->GetNumberOfIds()) > 0)
+      if (!vtkSPDF_CanMove(topology, i))
       {
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-        edgeIdPtr = vertsPtr->edges->GetPointer(0);
-        // Compute the mean (cumulated) direction vector
-        for (vtkIdType j = 0; j < npts; ++j)
-        {
-          for (unsigned short k = 0; k < 3; ++k)
-          {
-            deltaX[k] += *(start + 3 * (*edgeIdPtr) + k);
-          }
-          ++edgeIdPtr;
-        }//for all connected points
-
-        // Move the point
-        *newPtsCoords += params.factor * (deltaX[0] / npts - (*newPtsCoords));
-        xNew[0] = *newPtsCoords;
-        ++newPtsCoords;
-        *newPtsCoords += params.factor * (deltaX[1] / npts - (*newPtsCoords));
-        xNew[1] = *newPtsCoords;
-        ++newPtsCoords;
-        *newPtsCoords += params.factor * (deltaX[2] / npts - (*newPtsCoords));
-        xNew[2] = *newPtsCoords;
-        ++newPtsCoords;
-
-        // Constrain point to surface
-        if (params.source)
+        continue;
+      }
+      vtkIdType npts = topology->GetNumberOfEdges(i);
+      const vtkIdType *edgeIdPtr = topology->GetEdges(i);
+      T *x = newPtsCoords + 3 * i;
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      // Compute the mean (cumulated) direction vector
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        for (unsigned short k = 0; k < 3; ++k)
         {
-          vtkSmoothPoint *sPtr = params.SmoothPoints->GetSmoothPoint(i);
-          vtkCell *cell = nullptr;
-
-          if (sPtr->cellId >= 0) //in cell
-          {
-            cell = params.source->GetCell(sPtr->cellId);
-          }
-
-          if (!cell || cell->EvaluatePosition(xNew, closestPt,
-              sPtr->subId, sPtr->p, dist2, params.w) == 0)
-          { // not in cell anymore
-            params.cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId,
-                                                 sPtr->subId, dist2);
-          }
-          for (int k = 0; k < 3; ++k)
-          {
-            xNew[k] = closestPt[k];
-          }
-          params.newPts->SetPoint(i, xNew);
+          deltaX[k] += newPtsCoords[3 * edgeIdPtr[j] + k];
         }
+      }//for all connected points
 
-        if ((dist = vtkMath::Norm(deltaX)) > maxDist)
-        {
-          maxDist = dist;
-        }
-      }//if can move point
-        else
-        {
-          newPtsCoords += 3;
-        }
-        ++vertsPtr;
+      // Move the point
+      for (int k = 0; k < 3; ++k)
+      {
+        x[k] += params.factor * (deltaX[k] / npts - x[k]);
+        xNew[k] = x[k];
+      }
+
+      // Constrain point to surface
+      vtkSmoothPoint *sPtr = params.SmoothPoints->GetSmoothPoint(i);
+      vtkCell *cell = nullptr;
+
+      if (sPtr->cellId >= 0) //in cell
+      {
+        cell = params.source->GetCell(sPtr->cellId);
+      }
+
+      if (!cell || cell->EvaluatePosition(xNew, closestPt,
+          sPtr->subId, sPtr->p, dist2, params.w) == 0)
+      { // not in cell anymore
+        params.cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId,
+                                             sPtr->subId, dist2);
+      }
+      params.newPts->SetPoint(i, closestPt);
+
+      if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+      {
+        maxDist = dist;
+      }
     }//for all points
   }//for not converged or within iteration count
 
+  // the result of the last iteration, into the output points
+  if (smooth.Current != newPtsCoords)
+  {
+    std::copy(smooth.Current, smooth.Current + 3 * params.numPts, newPtsCoords);
+  }
+
   vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
 }
 
@@ -303,23 +383,13 @@ int vtkSmoothPolyDataFilter::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts, numCells, i, numPolys, numStrips;
-  int j, k;
-  vtkIdType npts = 0;
-  vtkIdType *pts = nullptr;
-  vtkIdType p1, p2;
+  vtkIdType numPts, numCells, i;
+  int j;
   double conv;
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
-  double CosFeatureAngle; //Cosine of angle between adjacent polys
-  double CosEdgeAngle; // Cosine of angle between adjacent edges
+  double x1[3], x2[3], x3[3];
   double closestPt[3], dist2, *w = nullptr;
-  vtkIdType numSimple=0, numBEdges=0, numFixed=0, numFEdges=0;
-  vtkPolyData *inMesh, *Mesh;
   vtkPoints *inPts;
-  vtkTriangleFilter *toTris=nullptr;
-  vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints *newPts;
-  vtkMeshVertexPtr Verts;
   vtkCellLocator *cellLocator=nullptr;
 
   // Check input
@@ -332,9 +402,6 @@ int vtkSmoothPolyDataFilter::RequestData(
     return 1;
   }
 
-  CosFeatureAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
-  CosEdgeAngle =    cos( vtkMath::RadiansFromDegrees( this->EdgeAngle) );
-
   vtkDebugMacro(<<"Smoothing " << numPts << " vertices, " << numCells
                << " cells with:\n"
                << "\tConvergence= " << this->Convergence << "\n"
@@ -362,272 +429,25 @@ int vtkSmoothPolyDataFilter::RequestData(
   // using a subset of the attached vertices.
   //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-
   inPts = input->GetPoints();
   conv = this->Convergence * input->GetLength();
 
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts=input->GetVerts(), inVerts->InitTraversal();
-  inVerts->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
-    }
-  }
-  this->UpdateProgress(0.10);
-
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines=input->GetLines(), inLines->InitTraversal();
-  inLines->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
-      {
-        if ( j == (npts-1) ) //end-of-line marked FIXED
-        {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        }
-        else if ( j == 0 ) //beginning-of-line marked FIXED
-        {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
-        }
-        else //is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
-        }
-      } //if simple vertex
-
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
-      { //multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
-      }
-
-    } //for all points in this line
-  } //for all lines
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
-  inPolys=input->GetPolys();
-  numPolys = inPolys->GetNumberOfCells();
-  inStrips=input->GetStrips();
-  numStrips = inStrips->GetNumberOfCells();
-
-  if ( numPolys > 0 || numStrips > 0 )
-  { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
-    inMesh = vtkPolyData::New();
-    inMesh->SetPoints(inPts);
-    inMesh->SetPolys(inPolys);
-    Mesh = inMesh;
-
-    if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
-    { // convert data to triangles
-      inMesh->SetStrips(inStrips);
-      toTris = vtkTriangleFilter::New();
-      toTris->SetInputData(inMesh);
-      toTris->Update();
-      Mesh = toTris->GetOutput();
-    }
-
-    Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
-    this->UpdateProgress(0.375);
-
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-    cellId++)
-    {
-      for (i=0; i < npts; i++)
-      {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == nullptr )
-        {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-        }
-        if ( Verts[p2].edges == nullptr )
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-        }
-
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
-
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-        {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-        }
-
-        else if ( numNei >= 2 )
-        {
-          // check to make sure that this edge hasn't been marked already
-          for (j=0; j < numNei; j++)
-          {
-            if ( neighbors->GetId(j) < cellId )
-            {
-              break;
-            }
-          }
-          if ( j >= numNei )
-          {
-            edge = VTK_FEATURE_EDGE_VERTEX;
-          }
-        }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-          if (this->FeatureEdgeSmoothing)
-          {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
-
-            if (vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle)
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
-
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-      }
-    }
-
-    inMesh->Delete();
-    if (toTris) {toTris->Delete();}
-
-    neighbors->Delete();
-  }//if strips or polys
+  vtkSmoothingTopologyHelper topology;
+  topology.Analyze(input, this->FeatureAngle, this->EdgeAngle,
+                   this->FeatureEdgeSmoothing != 0,
+                   this->BoundarySmoothing != 0, false);
 
   this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-    {
-      numSimple++;
-    }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
-    {
-      numFixed++;
-    }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-    { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-      }
-
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numFixed++;
-      }
-
-      else //check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
-
-        for (k=0; k<3; k++)
-        {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-        }
-        if ( vtkMath::Normalize(l1) >= 0.0 &&
-             vtkMath::Normalize(l2) >= 0.0 &&
-             vtkMath::Dot(l1,l2) < CosEdgeAngle)
-        {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-        }
-        else
-        {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
-          {
-            numFEdges++;
-          }
-          else
-          {
-            numBEdges++;
-          }
-        }
-      }//if along edge
-    }//if edge vertex
-  }//for all points
-
-  vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
-                << numFEdges << " feature edge vertices\n\t"
-                << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+  vtkDebugMacro(<<"Found\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::SIMPLE_VERTEX)
+    << " simple vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX)
+    << " feature edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX)
+    << " boundary edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::FIXED_VERTEX)
+    << " fixed vertices\n\t");
 
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
@@ -673,17 +493,24 @@ int vtkSmoothPolyDataFilter::RequestData(
   }
   else //smooth normally
   {
-    for (i=0; i<numPts; i++) //initialize to old coordinates
+    vtkDataArray *inData = inPts->GetData();
+    vtkDataArray *newData = newPts->GetData();
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId)
     {
-      newPts->SetPoint(i,inPts->GetPoint(i));
-    }
+      double x[3];
+      for ( ; ptId < endPtId; ++ptId) //initialize to old coordinates
+      {
+        inData->GetTuple(ptId, x);
+        newData->SetTuple(ptId, x);
+      }
+    });
   }
 
   if (newPts->GetDataType() == VTK_DOUBLE)
   {
     vtkSPDF_InternalParams<double> params = { this, this->NumberOfIterations, newPts,
                                               this->RelaxationFactor, conv, numPts,
-                                              Verts, source, this->SmoothPoints,
+                                              &topology, source, this->SmoothPoints,
                                               w, cellLocator };
 
     vtkSPDF_MovePoints(params);
@@ -692,7 +519,7 @@ int vtkSmoothPolyDataFilter::RequestData(
   {
     vtkSPDF_InternalParams<float> params = { this, this->NumberOfIterations, newPts,
                                              static_cast<float>(this->RelaxationFactor),
-                                             static_cast<float>(conv), numPts, Verts,
+                                             static_cast<float>(conv), numPts, &topology,
                                              source, this->SmoothPoints, w, cellLocator };
 
     vtkSPDF_MovePoints(params);
@@ -753,17 +580,6 @@ int vtkSmoothPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr )
-    {
-      Verts[i].edges->Delete();
-      Verts[i].edges = nullptr;
-    }
-  }
-  delete [] Verts;
-
   return 1;
 }
 
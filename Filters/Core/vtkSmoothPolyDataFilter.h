@@ -79,6 +79,15 @@
  *
  *
  * @warning
+ * This class has been threaded with vtkSMPTools. The connectivity array is
+ * built in parallel from static cell links. Without a Source, each
+ * iteration moves all the vertices from their positions at the previous
+ * iteration, in parallel, and the result does not depend on the number of
+ * threads. (Earlier versions moved the vertices in place, one after the
+ * other, so the results differ slightly.) Constrained smoothing is still
+ * performed serially, in place.
+ *
+ * @warning
  * The Laplacian operation reduces high frequency information in the geometry
  * of the mesh. With excessive smoothing important details may be lost, and
  * the surface may shrink towards the centroid. Enabling FeatureEdgeSmoothing
@@ -0,0 +1,461 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSmoothingTopologyHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSmoothingTopologyHelper.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellSubsetHelper.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkTriangleFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+typedef vtkCellSubsetHelper::CellSource PolygonSource;
+
+//----------------------------------------------------------------------------
+// The links from the points to the polygons using them, in compressed row
+// form. They are built from the cells returned by a PolygonSource, which
+// reads the cell array in its own storage without converting it.
+struct PolygonLinks
+{
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Cells;
+
+  void Build(vtkIdType numPts, const PolygonSource &polys)
+  {
+    this->Offsets.assign(numPts + 1, 0);
+    vtkNew<vtkIdList> ptIds;
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = 0; cellId < polys.NumberOfCells; ++cellId)
+    {
+      polys.GetCell(cellId, npts, pts, ptIds);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        this->Offsets[pts[i] + 1]++;
+      }
+    }
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      this->Offsets[ptId + 1] += this->Offsets[ptId];
+    }
+    this->Cells.resize(this->Offsets[numPts]);
+    std::vector<vtkIdType> fill(this->Offsets.begin(), this->Offsets.end() - 1);
+    for (vtkIdType cellId = 0; cellId < polys.NumberOfCells; ++cellId)
+    {
+      polys.GetCell(cellId, npts, pts, ptIds);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        this->Cells[fill[pts[i]]++] = cellId;
+      }
+    }
+  }
+
+  vtkIdType GetNumberOfCells(vtkIdType ptId) const
+  {
+    return this->Offsets[ptId + 1] - this->Offsets[ptId];
+  }
+
+  const vtkIdType *GetCells(vtkIdType ptId) const
+  {
+    return this->Cells.data() + this->Offsets[ptId];
+  }
+};
+
+//----------------------------------------------------------------------------
+// The analysis of the points, in two passes: the first one sets the type
+// and counts the edges of each point, the second one fills the edges. Each
+// point replays the visits of the edges of its polygons, in the order of
+// the polygons, and only keeps their effect on itself.
+struct AnalyzePoints
+{
+  vtkPoints *Points;
+  const PolygonLinks *Links;
+  const PolygonSource *Polygons;
+  const double *Normals; // the normals of the polygons, or nullptr
+  const char *LineTypes; // the types after the vertices and lines
+  const vtkIdType *LineEdges; // the edges of the interior points of lines
+  double CosFeatureAngle;
+  double CosEdgeAngle;
+  bool BoundarySmoothing;
+  bool NonManifoldSmoothing;
+  char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *Edges; // nullptr in the first pass
+  vtkSMPThreadLocal<std::vector<vtkIdType> > PointEdges;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > PointCells;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  // The type of the edge (p1,p2) of the polygon cellId, or -1 if the edge
+  // has already been visited from another polygon.
+  int ClassifyEdge(vtkIdType cellId, vtkIdType p1, vtkIdType p2)
+  {
+    vtkIdType numCells1 = this->Links->GetNumberOfCells(p1);
+    const vtkIdType *cells1 = this->Links->GetCells(p1);
+    vtkIdType numCells2 = this->Links->GetNumberOfCells(p2);
+    const vtkIdType *cells2 = this->Links->GetCells(p2);
+
+    // the other polygons using both points
+    vtkIdType numNei = 0, nei = -1;
+    bool visited = false;
+    for (vtkIdType i = 0; i < numCells1; ++i)
+    {
+      if (cells1[i] != cellId &&
+          std::find(cells2, cells2 + numCells2, cells1[i]) != cells2 + numCells2)
+      {
+        numNei++;
+        nei = cells1[i];
+        visited = (visited || nei < cellId);
+      }
+    }
+
+    if (numNei == 0)
+    {
+      return vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX;
+    }
+    else if (numNei >= 2)
+    {
+      // non-manifold case, marked once
+      return (!this->NonManifoldSmoothing && !visited ?
+              vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX :
+              vtkSmoothingTopologyHelper::SIMPLE_VERTEX);
+    }
+    else if (nei > cellId)
+    {
+      if (this->Normals &&
+          vtkMath::Dot(this->Normals + 3*cellId, this->Normals + 3*nei) <=
+          this->CosFeatureAngle)
+      {
+        return vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX;
+      }
+      return vtkSmoothingTopologyHelper::SIMPLE_VERTEX;
+    }
+    return -1;
+  }
+
+  // The effect of an edge of the given type to ptId on a point.
+  static void AddEdge(char &type, std::vector<vtkIdType> &edges, int edge,
+                      vtkIdType ptId)
+  {
+    if (edge && type == vtkSmoothingTopologyHelper::SIMPLE_VERTEX)
+    {
+      edges.clear();
+      edges.push_back(ptId);
+      type = static_cast<char>(edge);
+    }
+    else if ((edge && type == vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX) ||
+             (edge && type == vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX) ||
+             (!edge && type == vtkSmoothingTopologyHelper::SIMPLE_VERTEX))
+    {
+      edges.push_back(ptId);
+      if (type && edge == vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX)
+      {
+        type = vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX;
+      }
+    }
+  }
+
+  // The type and the edges of ptId after the visit of all the polygons.
+  char Visit(vtkIdType ptId, std::vector<vtkIdType> &edges,
+             std::vector<vtkIdType> &cells, vtkIdList *ptIds)
+  {
+    char type = this->LineTypes[ptId];
+    edges.clear();
+    if (type == vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX)
+    {
+      edges.push_back(this->LineEdges[2*ptId]);
+      edges.push_back(this->LineEdges[2*ptId + 1]);
+    }
+    if (!this->Links)
+    {
+      return type;
+    }
+
+    const vtkIdType *ptCells = this->Links->GetCells(ptId);
+    cells.assign(ptCells, ptCells + this->Links->GetNumberOfCells(ptId));
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    for (size_t c = 0; c < cells.size(); ++c)
+    {
+      vtkIdType cellId = cells[c];
+      vtkIdType npts;
+      const vtkIdType *pts;
+      this->Polygons->GetCell(cellId, npts, pts, ptIds);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType p1 = pts[i];
+        vtkIdType p2 = pts[(i+1)%npts];
+        if (p1 != ptId && p2 != ptId)
+        {
+          continue;
+        }
+        int edge = this->ClassifyEdge(cellId, p1, p2);
+        if (edge < 0)
+        {
+          continue;
+        }
+        if (p1 == ptId)
+        {
+          AddEdge(type, edges, edge, p2);
+        }
+        if (p2 == ptId)
+        {
+          AddEdge(type, edges, edge, p1);
+        }
+      }
+    }
+    return type;
+  }
+
+  // Edge vertices can only be smoothed along two edges which are nearly
+  // aligned.
+  char CheckEdgeVertex(vtkIdType ptId, char type,
+                       const std::vector<vtkIdType> &edges)
+  {
+    if (type != vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX &&
+        type != vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX)
+    {
+      return type;
+    }
+    if (!this->BoundarySmoothing &&
+        type == vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX)
+    {
+      return vtkSmoothingTopologyHelper::FIXED_VERTEX;
+    }
+    if (edges.size() != 2)
+    {
+      // can only smooth edges on 2-manifold surfaces
+      return vtkSmoothingTopologyHelper::FIXED_VERTEX;
+    }
+
+    double x1[3], x2[3], x3[3], l1[3], l2[3];
+    this->Points->GetPoint(edges[0], x1);
+    this->Points->GetPoint(ptId, x2);
+    this->Points->GetPoint(edges[1], x3);
+    for (int k = 0; k < 3; ++k)
+    {
+      l1[k] = x2[k] - x1[k];
+      l2[k] = x3[k] - x2[k];
+    }
+    if (vtkMath::Normalize(l1) >= 0.0 && vtkMath::Normalize(l2) >= 0.0 &&
+        vtkMath::Dot(l1, l2) < this->CosEdgeAngle)
+    {
+      return vtkSmoothingTopologyHelper::FIXED_VERTEX;
+    }
+    return type;
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    std::vector<vtkIdType> &edges = this->PointEdges.Local();
+    std::vector<vtkIdType> &cells = this->PointCells.Local();
+    vtkIdList *ptIds = this->PtIds.Local();
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      char type = this->Visit(ptId, edges, cells, ptIds);
+      if (!this->Edges)
+      {
+        this->Types[ptId] = this->CheckEdgeVertex(ptId, type, edges);
+        this->Offsets[ptId + 1] = static_cast<vtkIdType>(edges.size());
+      }
+      else
+      {
+        std::copy(edges.begin(), edges.end(),
+                  this->Edges + this->Offsets[ptId]);
+      }
+    }
+  }
+};
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+vtkSmoothingTopologyHelper::vtkSmoothingTopologyHelper()
+  : NumberOfPoints(0), Types(nullptr), Offsets(nullptr), Edges(nullptr)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSmoothingTopologyHelper::~vtkSmoothingTopologyHelper()
+{
+  this->Initialize();
+}
+
+//----------------------------------------------------------------------------
+void vtkSmoothingTopologyHelper::Initialize()
+{
+  delete [] this->Types;
+  delete [] this->Offsets;
+  delete [] this->Edges;
+  this->Types = nullptr;
+  this->Offsets = nullptr;
+  this->Edges = nullptr;
+  this->NumberOfPoints = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkSmoothingTopologyHelper::Analyze(vtkPolyData *input,
+                                         double featureAngle,
+                                         double edgeAngle,
+                                         bool featureEdgeSmoothing,
+                                         bool boundarySmoothing,
+                                         bool nonManifoldSmoothing)
+{
+  this->Initialize();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPoints *inPts = input->GetPoints();
+  this->NumberOfPoints = numPts;
+  this->Types = new char[numPts];
+  this->Offsets = new vtkIdType[numPts + 1];
+  this->Offsets[0] = 0;
+
+  // Vertices are never smoothed, and only manifold lines can be smoothed.
+  // These are few, and analyzed serially.
+  std::vector<char> lineTypes(numPts, SIMPLE_VERTEX);
+  std::vector<vtkIdType> lineEdges;
+  vtkIdType npts = 0;
+  vtkIdType *pts = nullptr;
+  vtkCellArray *inVerts = input->GetVerts();
+  for (inVerts->InitTraversal(); inVerts->GetNextCell(npts, pts); )
+  {
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      lineTypes[pts[j]] = FIXED_VERTEX;
+    }
+  }
+  vtkCellArray *inLines = input->GetLines();
+  if (inLines->GetNumberOfCells() > 0)
+  {
+    lineEdges.resize(2*numPts);
+  }
+  for (inLines->InitTraversal(); inLines->GetNextCell(npts, pts); )
+  {
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      char &type = lineTypes[pts[j]];
+      if (type == SIMPLE_VERTEX)
+      {
+        if (j == npts - 1 || j == 0) // ends of lines are fixed
+        {
+          type = FIXED_VERTEX;
+        }
+        else
+        {
+          type = FEATURE_EDGE_VERTEX;
+          lineEdges[2*pts[j]] = pts[j-1];
+          lineEdges[2*pts[j] + 1] = pts[j+1];
+        }
+      }
+      else if (type == FEATURE_EDGE_VERTEX)
+      {
+        // multiply connected, becomes fixed
+        type = FIXED_VERTEX;
+      }
+    }
+  }
+
+  AnalyzePoints analyze;
+  analyze.Points = inPts;
+  analyze.Links = nullptr;
+  analyze.Polygons = nullptr;
+  analyze.Normals = nullptr;
+  analyze.LineTypes = lineTypes.data();
+  analyze.LineEdges = lineEdges.data();
+  analyze.CosFeatureAngle = cos(vtkMath::RadiansFromDegrees(featureAngle));
+  analyze.CosEdgeAngle = cos(vtkMath::RadiansFromDegrees(edgeAngle));
+  analyze.BoundarySmoothing = boundarySmoothing;
+  analyze.NonManifoldSmoothing = nonManifoldSmoothing;
+  analyze.Types = this->Types;
+  analyze.Offsets = this->Offsets;
+  analyze.Edges = nullptr;
+
+  // The polygons, with the triangle strips converted to triangles. They
+  // are read in the storage of their cell array, which is not modified.
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkCellArray *inStrips = input->GetStrips();
+  vtkNew<vtkPolyData> inMesh;
+  vtkNew<vtkTriangleFilter> toTris;
+  PolygonSource polygons;
+  PolygonLinks links;
+  std::vector<double> normals;
+  if (inPolys->GetNumberOfCells() > 0 || inStrips->GetNumberOfCells() > 0)
+  {
+    inMesh->SetPoints(inPts);
+    inMesh->SetPolys(inPolys);
+    vtkPolyData *mesh = inMesh;
+    if (inStrips->GetNumberOfCells() > 0)
+    {
+      inMesh->SetStrips(inStrips);
+      toTris->SetInputData(inMesh);
+      toTris->Update();
+      mesh = toTris->GetOutput();
+    }
+
+    polygons.Initialize(mesh->GetPolys(), 0);
+    links.Build(numPts, polygons);
+    vtkIdType numPolys = polygons.NumberOfCells;
+
+    if (featureEdgeSmoothing)
+    {
+      normals.resize(3*numPolys);
+      vtkSMPThreadLocalObject<vtkIdList> normalPtIds;
+      vtkSMPTools::For(0, numPolys, [&](vtkIdType cellId, vtkIdType endCellId)
+      {
+        vtkIdList *ptIds = normalPtIds.Local();
+        for ( ; cellId < endCellId; ++cellId)
+        {
+          vtkIdType npts;
+          const vtkIdType *pts;
+          polygons.GetCell(cellId, npts, pts, ptIds);
+          vtkPolygon::ComputeNormal(inPts, static_cast<int>(npts),
+                                    const_cast<vtkIdType*>(pts),
+                                    normals.data() + 3*cellId);
+        }
+      });
+      analyze.Normals = normals.data();
+    }
+
+    analyze.Links = &links;
+    analyze.Polygons = &polygons;
+  }
+
+  // Count the edges, then fill them.
+  vtkSMPTools::For(0, numPts, analyze);
+  vtkSMPTools::InclusiveScan(this->Offsets + 1, this->Offsets + numPts + 1,
+                             this->Offsets + 1);
+  this->Edges = new vtkIdType[this->Offsets[numPts]];
+  analyze.Edges = this->Edges;
+  vtkSMPTools::For(0, numPts, analyze);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSmoothingTopologyHelper::GetNumberOfVertices(int type) const
+{
+  return static_cast<vtkIdType>(
+    std::count(this->Types, this->Types + this->NumberOfPoints,
+               static_cast<char>(type)));
+}
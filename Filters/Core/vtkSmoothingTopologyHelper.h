@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSmoothingTopologyHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSmoothingTopologyHelper
+ * @brief   A utility class used to analyze the topology of a mesh to smooth
+ *
+ * This is a simple utility class used by the filters smoothing the points of
+ * a vtkPolyData. Analyze() classifies each point as a simple vertex
+ * (smoothed with all the points it is connected to), a fixed vertex (never
+ * smoothed), or a feature or boundary edge vertex (smoothed with the two
+ * points it is connected to along the edge), and builds the lists of the
+ * points each point is smoothed with. The lists are stored in compressed
+ * row form: the ids of the points connected to ptId are
+ * GetEdges(ptId)[0 .. GetNumberOfEdges(ptId)-1].
+ *
+ * The links from the points to the polygons are built once, reading the
+ * polygons in the storage of their cell array so that the input is not
+ * modified, and the points are then analyzed in parallel
+ * with vtkSMPTools. Each point replays the visits of the edges of its
+ * polygons in the order of the polygons, so the classification and the
+ * lists are the ones of a serial traversal of the polygons, whatever the
+ * number of threads.
+ *
+ * @sa
+ * vtkSmoothPolyDataFilter vtkWindowedSincPolyDataFilter
+*/
+
+#ifndef vtkSmoothingTopologyHelper_h
+#define vtkSmoothingTopologyHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class vtkPolyData;
+
+class VTKFILTERSCORE_EXPORT vtkSmoothingTopologyHelper
+{
+public:
+  enum VertexType
+  {
+    SIMPLE_VERTEX = 0,
+    FIXED_VERTEX = 1,
+    FEATURE_EDGE_VERTEX = 2,
+    BOUNDARY_EDGE_VERTEX = 3
+  };
+
+  vtkSmoothingTopologyHelper();
+  ~vtkSmoothingTopologyHelper();
+
+  /**
+   * Classify the points of input and build the lists of the points they are
+   * smoothed with. The points of vertices and the ends of the lines are
+   * fixed. The edges between polygons (or triangle strips) are feature edges
+   * when the angle between the normals of the polygons is larger than
+   * featureAngle (with featureEdgeSmoothing), or when more than two polygons
+   * share the edge (without nonManifoldSmoothing). The edge vertices are
+   * fixed unless they have exactly two edges making an angle smaller than
+   * edgeAngle, and the boundary vertices are fixed without
+   * boundarySmoothing. The angles are in degrees.
+   */
+  void Analyze(vtkPolyData *input, double featureAngle, double edgeAngle,
+               bool featureEdgeSmoothing, bool boundarySmoothing,
+               bool nonManifoldSmoothing);
+
+  /**
+   * The type of the point ptId, one of VertexType.
+   */
+  int GetVertexType(vtkIdType ptId) const
+  {
+    return this->Types[ptId];
+  }
+
+  //@{
+  /**
+   * The number and the ids of the points the point ptId is smoothed with.
+   * A point without edges is never moved.
+   */
+  vtkIdType GetNumberOfEdges(vtkIdType ptId) const
+  {
+    return this->Offsets[ptId + 1] - this->Offsets[ptId];
+  }
+  const vtkIdType *GetEdges(vtkIdType ptId) const
+  {
+    return this->Edges + this->Offsets[ptId];
+  }
+  //@}
+
+  /**
+   * The number of points of the given type, for reporting.
+   */
+  vtkIdType GetNumberOfVertices(int type) const;
+
+private:
+  vtkSmoothingTopologyHelper(const vtkSmoothingTopologyHelper&) = delete;
+  vtkSmoothingTopologyHelper& operator=(const vtkSmoothingTopologyHelper&) = delete;
+
+  void Initialize();
+
+  vtkIdType NumberOfPoints;
+  char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *Edges;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSmoothingTopologyHelper.h
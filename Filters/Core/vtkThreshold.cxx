@@ -16,16 +16,20 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkCellSubsetHelper.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -41,6 +45,7 @@ vtkThreshold::vtkThreshold()
   this->ComponentMode          = VTK_COMPONENT_MODE_USE_SELECTED;
   this->SelectedComponent      = 0;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->ParallelExecution = 0;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS,
@@ -105,18 +110,6 @@ int vtkThreshold::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId;
-  vtkIdList *cellPts, *pointMap;
-  vtkIdList *newCellPts;
-  vtkCell *cell;
-  vtkPoints *newPoints;
-  vtkIdType i, ptId, newId, numPts;
-  int numCellPts;
-  double x[3];
-  vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
-  vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
-  int keepCell;
-
   vtkDebugMacro(<< "Executing threshold filter");
 
   if (this->AttributeMode != -1)
@@ -133,38 +126,110 @@ int vtkThreshold::RequestData(
     return 1;
   }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
-  numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
 
-  newPoints = vtkPoints::New();
+  // Check that the scalars of the cell satisfy the threshold criterion
+  auto criterion = [this, inScalars, usePointScalars](
+    vtkIdType cellId, vtkIdType numCellPts, const vtkIdType *cellPts)
+  {
+    int keepCell;
+    if ( usePointScalars )
+    {
+      if (this->AllScalars)
+      {
+        keepCell = 1;
+        for (vtkIdType i=0; keepCell && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents( inScalars, cellPts[i] );
+        }
+      }
+      else
+      {
+        if(!this->UseContinuousCellRange)
+        {
+          keepCell = 0;
+          for (vtkIdType i=0; (!keepCell) && (i < numCellPts); i++)
+          {
+            keepCell = this->EvaluateComponents( inScalars, cellPts[i] );
+          }
+        }
+        else
+        {
+          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+        }
+      }
+    }
+    else //use cell scalars
+    {
+      keepCell = this->EvaluateComponents( inScalars, cellId );
+    }
+    return keepCell;
+  };
 
   // set precision for the points in the output
+  int pointsDataType = VTK_FLOAT;
   if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
     vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
     if(inputPointSet && inputPointSet->GetPoints())
     {
-      newPoints->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPoints->SetDataType(VTK_FLOAT);
+      pointsDataType = inputPointSet->GetPoints()->GetDataType();
     }
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
   {
-    newPoints->SetDataType(VTK_FLOAT);
+    pointsDataType = VTK_DOUBLE;
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+
+  if (this->ParallelExecution && vtkCellSubsetHelper::IsSupported(input))
   {
-    newPoints->SetDataType(VTK_DOUBLE);
+    // The criterion is evaluated on this thread, so that it does not have
+    // to be thread safe, and the output is built in parallel.
+    output->GetPointData()->CopyGlobalIdsOn();
+    output->GetCellData()->CopyGlobalIdsOn();
+    vtkCellSubsetHelper helper(input);
+    vtkIdType numCells = input->GetNumberOfCells();
+    std::vector<unsigned char> keepCells(numCells);
+    vtkNew<vtkIdList> ptIds;
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+      helper.GetCellPoints(cellId, npts, pts, ptIds);
+      // empty cells, i.e. VTK_EMPTY_CELL, are never kept
+      keepCells[cellId] = (npts > 0 && criterion(cellId, npts, pts)) ? 1 : 0;
+    }
+    helper.Extract(keepCells.data(), nullptr, pointsDataType, output);
+
+    vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
+                  << " number of cells.");
+    return 1;
   }
 
+  vtkIdType cellId, newCellId;
+  vtkIdList *cellPts, *pointMap;
+  vtkIdList *newCellPts;
+  vtkCell *cell;
+  vtkPoints *newPoints;
+  vtkIdType i, ptId, newId, numPts;
+  int numCellPts;
+  double x[3];
+  vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
+  vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
+  int keepCell;
+
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd);
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd);
+
+  numPts = input->GetNumberOfPoints();
+  output->Allocate(input->GetNumberOfCells());
+
+  newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsDataType);
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -176,49 +241,13 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
-  // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
   {
     cell = input->GetCell(cellId);
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
-      }
-      else
-      {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
+    keepCell = criterion(cellId, numCellPts, cellPts->GetPointer(0));
 
     if (  numCellPts > 0 && keepCell )
     {
@@ -267,6 +296,16 @@ int vtkThreshold::RequestData(
 }
 
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
+{
+  return this->EvaluateCell(scalars, cellPts->GetPointer(0), numCellPts);
+}
+
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts )
+{
+  return this->EvaluateCell(scalars, c, cellPts->GetPointer(0), numCellPts);
+}
+
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars, const vtkIdType* cellPts, vtkIdType numCellPts )
 {
   int c(0);
   int numComp = scalars->GetNumberOfComponents();
@@ -295,12 +334,12 @@ int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int nu
   return keepCell;
 }
 
-int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts )
+int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, const vtkIdType* cellPts, vtkIdType numCellPts )
 {
   double minScalar=DBL_MAX, maxScalar=DBL_MIN;
-  for (int i=0; i < numCellPts; i++)
+  for (vtkIdType i=0; i < numCellPts; i++)
   {
-    vtkIdType ptId = cellPts->GetId(i);
+    vtkIdType ptId = cellPts[i];
     double s = scalars->GetComponent(ptId,c);
     minScalar = std::min(s,minScalar);
     maxScalar = std::max(s,maxScalar);
@@ -453,4 +492,6 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: "<<this->UseContinuousCellRange<<endl;
+  os << indent << "Parallel Execution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
@@ -30,6 +30,10 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * When ParallelExecution is on, the output is built with vtkSMPTools in
+ * two passes (see vtkCellSubsetHelper), and the output points keep the
+ * order of the input points instead of the order of their first use.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -183,6 +187,19 @@ public:
   int GetOutputPointsPrecision() const;
   //@}
 
+  //@{
+  /**
+   * Turn on/off the building of the output in parallel with vtkSMPTools.
+   * The threshold criterion is still evaluated on the calling thread. The
+   * output does not depend on the number of threads, but its points are in
+   * the order of the input points. It is only used for vtkUnstructuredGrid,
+   * vtkPolyData and vtkImageData inputs. Off by default.
+   */
+  vtkSetMacro(ParallelExecution,vtkTypeBool);
+  vtkGetMacro(ParallelExecution,vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution,vtkTypeBool);
+  //@}
+
 protected:
   vtkThreshold();
   ~vtkThreshold() override;
@@ -201,6 +218,7 @@ protected:
   int    SelectedComponent;
   int OutputPointsPrecision;
   vtkTypeBool UseContinuousCellRange;
+  vtkTypeBool ParallelExecution;
 
   int (vtkThreshold::*ThresholdFunction)(double s);
 
@@ -212,6 +230,8 @@ protected:
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+  int EvaluateCell( vtkDataArray *scalars, const vtkIdType* cellPts, vtkIdType numCellPts );
+  int EvaluateCell( vtkDataArray *scalars, int c, const vtkIdType* cellPts, vtkIdType numCellPts );
 private:
   vtkThreshold(const vtkThreshold&) = delete;
   void operator=(const vtkThreshold&) = delete;
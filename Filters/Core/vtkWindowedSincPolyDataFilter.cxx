@@ -22,10 +22,10 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
-#include "vtkPolygon.h"
-#include "vtkTriangle.h"
-#include "vtkTriangleFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmoothingTopologyHelper.h"
 
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
@@ -50,19 +50,184 @@ vtkWindowedSincPolyDataFilter::vtkWindowedSincPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->NormalizeCoordinates = 0;
+
+  this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 }
 
-#define VTK_SIMPLE_VERTEX 0
-#define VTK_FIXED_VERTEX 1
-#define VTK_FEATURE_EDGE_VERTEX 2
-#define VTK_BOUNDARY_EDGE_VERTEX 3
+namespace
+{
+
+// The iterations of the smoothing. The points are stored in T, the
+// computations are done in double. Each iteration only reads the points of
+// the previous ones and writes the points it is given, so the points are
+// processed in parallel. The points which are not allowed to move keep a
+// null Laplacian.
+template <typename T>
+struct vtkWSPDF_FirstIteration
+{
+  const vtkSmoothingTopologyHelper *Topology;
+  const T *X0;
+  T *X1;
+  T *X3;
+  double C0;
+  double C1;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double deltaX[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const T *x = this->X0 + 3*ptId;
+      T *x1 = this->X1 + 3*ptId;
+      T *x3 = this->X3 + 3*ptId;
+      vtkIdType npts = this->Topology->GetNumberOfEdges(ptId);
+      if (npts == 0)
+      {
+        // point is not allowed to move, just use the old point...
+        // (zero out the Laplacian)
+        for (int k = 0; k < 3; ++k)
+        {
+          x1[k] = 0;
+          x3[k] = x[k];
+        }
+        continue;
+      }
+
+      // calculate the negative of the laplacian
+      const vtkIdType *edges = this->Topology->GetEdges(ptId);
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        const T *y = this->X0 + 3*edges[j];
+        for (int k = 0; k < 3; ++k)
+        {
+          deltaX[k] += (static_cast<double>(x[k]) - y[k]) / npts;
+        }
+      }
+
+      // x1 = x0 - 0.5 laplacian, and x3 = c0 x0 + c1 x1
+      bool fixed = (this->Topology->GetVertexType(ptId) ==
+                    vtkSmoothingTopologyHelper::FIXED_VERTEX);
+      for (int k = 0; k < 3; ++k)
+      {
+        deltaX[k] = x[k] - 0.5*deltaX[k];
+        x1[k] = static_cast<T>(deltaX[k]);
+        x3[k] = (fixed ? x[k] : static_cast<T>(this->C0*x[k] + this->C1*deltaX[k]));
+      }
+    }
+  }
+};
+
+template <typename T>
+struct vtkWSPDF_NextIteration
+{
+  const vtkSmoothingTopologyHelper *Topology;
+  const T *X0;
+  const T *X1;
+  T *X2;
+  T *X3;
+  double C;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double deltaX[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const T *x0 = this->X0 + 3*ptId;
+      const T *x1 = this->X1 + 3*ptId;
+      T *x2 = this->X2 + 3*ptId;
+      vtkIdType npts = this->Topology->GetNumberOfEdges(ptId);
+      if (npts == 0)
+      {
+        // the point does not move; its x1 is already null
+        x2[0] = x2[1] = x2[2] = 0;
+        continue;
+      }
+
+      // calculate the negative laplacian of x1
+      const vtkIdType *edges = this->Topology->GetEdges(ptId);
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        const T *y = this->X1 + 3*edges[j];
+        for (int k = 0; k < 3; ++k)
+        {
+          deltaX[k] += (static_cast<double>(x1[k]) - y[k]) / npts;
+        }
+      }
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
+      // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+      for (int k = 0; k < 3; ++k)
+      {
+        deltaX[k] = static_cast<double>(x1[k]) - x0[k] + x1[k] - deltaX[k];
+        x2[k] = static_cast<T>(deltaX[k]);
+      }
+
+      // smooth the vertex (x3 = x3 + cj x2)
+      if (this->Topology->GetVertexType(ptId) !=
+          vtkSmoothingTopologyHelper::FIXED_VERTEX)
+      {
+        T *x3 = this->X3 + 3*ptId;
+        for (int k = 0; k < 3; ++k)
+        {
+          x3[k] = static_cast<T>(x3[k] + this->C*deltaX[k]);
+        }
+      }
+    }
+  }
+};
+
+// Run the iterations on the four arrays of points, the result is in the
+// fourth one. Returns the number of iterations performed.
+template <typename T>
+int vtkWSPDF_Smooth(vtkWindowedSincPolyDataFilter *self,
+                    const vtkSmoothingTopologyHelper &topology,
+                    vtkIdType numPts, vtkPoints *newPts[4], const double *c)
 {
-  char      type;
-  vtkIdList *edges; // connected edges (list of connected point ids)
-} vtkMeshVertex, *vtkMeshVertexPtr;
+  T *x[4];
+  for (int i = 0; i < 4; ++i)
+  {
+    x[i] = static_cast<T *>(newPts[i]->GetVoidPointer(0));
+  }
+  int zero = 0, one = 1, two = 2, three = 3;
+
+  // first iteration
+  vtkWSPDF_FirstIteration<T> first =
+    { &topology, x[zero], x[one], x[three], c[0], c[1] };
+  vtkSMPTools::For(0, numPts, first);
+
+  // for the rest of the iterations
+  int numIterations = self->GetNumberOfIterations();
+  int iterationNumber;
+  for (iterationNumber = 2; iterationNumber <= numIterations;
+       iterationNumber++)
+  {
+    if (!(iterationNumber % 5))
+    {
+      self->UpdateProgress(0.5 + 0.5*iterationNumber/numIterations);
+      if (self->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    vtkWSPDF_NextIteration<T> next =
+      { &topology, x[zero], x[one], x[two], x[three], c[iterationNumber] };
+    vtkSMPTools::For(0, numPts, next);
+
+    // update the pointers. three is always three. all other pointers
+    // shift by one and wrap.
+    zero = (1+zero)%3;
+    one = (1+one)%3;
+    two = (1+two)%3;
+  }
+
+  // move the iteration count back down so that it matches the
+  // actual number of iterations executed
+  return iterationNumber - 1;
+}
+
+} // end anon namespace
 
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -79,28 +244,16 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts, numCells, numPolys, numStrips, i;
-  int j, k;
-  vtkIdType npts = 0;
-  vtkIdType *pts = nullptr;
-  vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
-  double CosFeatureAngle; //Cosine of angle between adjacent polys
-  double CosEdgeAngle; // Cosine of angle between adjacent edges
+  vtkIdType numPts, numCells, i;
+  int j;
+  double x1[3], x2[3], x3[3];
   int iterationNumber;
-  vtkIdType numSimple=0, numBEdges=0, numFixed=0, numFEdges=0;
-  vtkPolyData *inMesh = nullptr, *Mesh;
   vtkPoints *inPts;
-  vtkTriangleFilter *toTris=nullptr;
-  vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints *newPts[4];
-  vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
-  int zero, one, two, three;
 
 //
 // Check input
@@ -113,9 +266,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     return 1;
   }
 
-  CosFeatureAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle) );
-  CosEdgeAngle    = cos( vtkMath::RadiansFromDegrees( this->EdgeAngle) );
-
   vtkDebugMacro(<<"Smoothing " << numPts << " vertices, " << numCells
                << " cells with:\n"
                << "\tIterations= " << this->NumberOfIterations << "\n"
@@ -149,327 +299,67 @@ int vtkWindowedSincPolyDataFilter::RequestData(
 // using a subset of the attached vertices.
 //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-  for (i=0; i<numPts; i++)
-  {
-    Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
-    Verts[i].edges = nullptr;
-  }
-
   inPts = input->GetPoints();
-
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts=input->GetVerts(), inVerts->InitTraversal();
-  inVerts->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
-    }
-  }
-
-  this->UpdateProgress(0.10);
-
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines=input->GetLines(), inLines->InitTraversal();
-  inLines->GetNextCell(npts,pts); )
-  {
-    for (j=0; j<npts; j++)
-    {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
-      {
-        if ( j == (npts-1) ) //end-of-line marked FIXED
-        {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        }
-        else if ( j == 0 ) //beginning-of-line marked FIXED
-        {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
-        }
-        else //is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          //Verts[pts[j]].edges = new vtkIdList(2,2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
-        }
-      } //if simple vertex
-
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
-      { //multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
-      }
-
-    } //for all points in this line
-  } //for all lines
-
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
-  inPolys=input->GetPolys();
-  numPolys = inPolys->GetNumberOfCells();
-  inStrips=input->GetStrips();
-  numStrips = inStrips->GetNumberOfCells();
-
-  if ( numPolys > 0 || numStrips > 0 )
-  { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    inMesh = vtkPolyData::New();
-    inMesh->SetPoints(inPts);
-    inMesh->SetPolys(inPolys);
-    Mesh = inMesh;
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
-    if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
-    { // convert data to triangles
-      inMesh->SetStrips(inStrips);
-      toTris = vtkTriangleFilter::New();
-      toTris->SetInputData(inMesh);
-      toTris->Update();
-      Mesh = toTris->GetOutput();
-    }
-
-    Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
-
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-         cellId++)
-    {
-      for (i=0; i < npts; i++)
-      {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == nullptr )
-        {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-          // Verts[p1].edges = new vtkIdList(6,6);
-        }
-        if ( Verts[p2].edges == nullptr )
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-          // Verts[p2].edges = new vtkIdList(6,6);
-        }
-
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
-
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-        {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-        }
-
-        else if ( numNei >= 2 )
-        {
-          // non-manifold case, check nonmanifold smoothing state
-          if (!this->NonManifoldSmoothing)
-          {
-            // check to make sure that this edge hasn't been marked already
-            for (j=0; j < numNei; j++)
-            {
-              if ( neighbors->GetId(j) < cellId )
-              {
-                break;
-              }
-            }
-            if ( j >= numNei )
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-          if (this->FeatureEdgeSmoothing)
-          {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
-
-            if ( vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
-
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
-          {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-      }
-    }
-
-    //    delete inMesh; // delete this later, windowed sinc smoothing needs it
-    if (toTris)
-    {
-      toTris->Delete();
-    }
-    neighbors->Delete();
-  }//if strips or polys
+  vtkSmoothingTopologyHelper topology;
+  topology.Analyze(input, this->FeatureAngle, this->EdgeAngle,
+                   this->FeatureEdgeSmoothing != 0,
+                   this->BoundarySmoothing != 0,
+                   this->NonManifoldSmoothing != 0);
 
   this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-    {
-      numSimple++;
-    }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
-    {
-      numFixed++;
-    }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-    { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-      }
-
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
-      {
-        // can only smooth edges on 2-manifold surfaces
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numFixed++;
-      }
-
-      else //check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
-
-        for (k=0; k<3; k++)
-        {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-        }
-        if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
-            && (vtkMath::Dot(l1,l2) < CosEdgeAngle))
-        {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-        }
-        else
-        {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
-          {
-            numFEdges++;
-          }
-          else
-          {
-            numBEdges++;
-          }
-        }
-      }//if along edge
-    }//if edge vertex
-  }//for all points
-
-  vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
-                << numFEdges << " feature edge vertices\n\t"
-                << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+  vtkDebugMacro(<<"Found\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::SIMPLE_VERTEX)
+    << " simple vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::FEATURE_EDGE_VERTEX)
+    << " feature edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::BOUNDARY_EDGE_VERTEX)
+    << " boundary edge vertices\n\t"
+    << topology.GetNumberOfVertices(vtkSmoothingTopologyHelper::FIXED_VERTEX)
+    << " fixed vertices\n\t");
 //
 // Perform Windowed Sinc function interpolation
 //
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
-  // need 4 vectors of points
-  zero=0; one=1; two=2; three=3;
-
-  newPts[0] = vtkPoints::New();
-  newPts[0]->SetNumberOfPoints(numPts);
-  newPts[1] = vtkPoints::New();
-  newPts[1]->SetNumberOfPoints(numPts);
-  newPts[2] = vtkPoints::New();
-  newPts[2]->SetNumberOfPoints(numPts);
-  newPts[3] = vtkPoints::New();
-  newPts[3]->SetNumberOfPoints(numPts);
+  // need 4 vectors of points, of the desired precision (float by default,
+  // as the filter always produced)
+  int dataType = VTK_FLOAT;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    dataType = VTK_DOUBLE;
+  }
+  for (j = 0; j < 4; ++j)
+  {
+    newPts[j] = vtkPoints::New(dataType);
+    newPts[j]->SetNumberOfPoints(numPts);
+  }
 
   // Get the center and length of the input dataset
   double *inCenter = input->GetCenter();
   double inLength = input->GetLength();
 
-  if (!this->NormalizeCoordinates)
-  {
-    for (i=0; i<numPts; i++) //initialize to old coordinates
-    {
-      newPts[zero]->SetPoint(i,inPts->GetPoint(i));
-    }
-  }
-  else
+  // initialize to old coordinates, centered and scaled to be within unit
+  // cube [-1, 1] when normalizing
+  vtkDataArray *inData = inPts->GetData();
+  vtkDataArray *zeroData = newPts[0]->GetData();
+  vtkTypeBool normalize = this->NormalizeCoordinates;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId)
   {
-    // center the data and scale to be within unit cube [-1, 1]
-    double normalizedPoint[3];
-    for (i=0; i<numPts; i++) //initialize to old coordinates
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
     {
-      inPts->GetPoint(i, normalizedPoint);
-      for (j=0; j<3; ++j)
+      inData->GetTuple(ptId, x);
+      if (normalize)
       {
-        normalizedPoint[j] = (normalizedPoint[j] - inCenter[j]) / inLength;
+        for (int k = 0; k < 3; ++k)
+        {
+          x[k] = (x[k] - inCenter[k]) / inLength;
+        }
       }
-      newPts[zero]->SetPoint(i,normalizedPoint);
+      zeroData->SetTuple(ptId, x);
     }
-  }
+  });
 
   // Smooth with a low pass filter defined as a windowed sinc function.
   // Taubin describes this methodology is the IBM tech report RC-20404
@@ -490,9 +380,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;
-
   //
   // Calculate the weights and the Chebychev coefficients c.
   //
@@ -578,131 +465,17 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
   }
 
-  // first iteration
-  for (i=0; i<numPts; i++)
+  if (dataType == VTK_DOUBLE)
   {
-    if ( Verts[i].edges != nullptr &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
-
-  // for the rest of the iterations
-  for ( iterationNumber=2;
-        iterationNumber <= this->NumberOfIterations;
-        iterationNumber++ )
+    iterationNumber = vtkWSPDF_Smooth<double>(this, topology, numPts, newPts, c);
+  }
+  else
   {
-    if ( iterationNumber && !(iterationNumber % 5) )
-    {
-      this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-
-    for (i=0; i<numPts; i++)
-    {
-      if ( Verts[i].edges != nullptr &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-        {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-          {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-          }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-        }
-        newPts[two]->SetPoint(i, deltaX);
-
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
-        {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-        }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-        {
-          newPts[three]->SetPoint(i,xNew);
-        }
-      }//if can move point
-      else
-      {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-      }
-    }//for all points
-
-    // update the pointers. three is always three. all other pointers
-    // shift by one and wrap.
-    zero = (1+zero)%3;
-    one = (1+one)%3;
-    two = (1+two)%3;
-
-  }//for all iterations or until converge
-
-  // move the iteration count back down so that it matches the
-  // actual number of iterations executed
-  --iterationNumber;
+    iterationNumber = vtkWSPDF_Smooth<float>(this, topology, numPts, newPts, c);
+  }
 
-  // set zero to three so the correct set of positions is outputted
-  zero = three;
+  // the result is in the fourth set of positions
+  vtkPoints *smoothedPts = newPts[3];
 
   delete [] w;
   delete [] c;
@@ -715,16 +488,20 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   if (this->NormalizeCoordinates)
   {
     // Re-position the coordinated
-    double repositionedPoint[3];
-    for (i=0; i<numPts; i++)
+    vtkDataArray *smoothedData = smoothedPts->GetData();
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId)
     {
-      newPts[zero]->GetPoint(i, repositionedPoint);
-      for (j=0; j<3; ++j)
+      double repositionedPoint[3];
+      for ( ; ptId < endPtId; ++ptId)
       {
-        repositionedPoint[j] = repositionedPoint[j] * inLength + inCenter[j];
+        smoothedData->GetTuple(ptId, repositionedPoint);
+        for (int k = 0; k < 3; ++k)
+        {
+          repositionedPoint[k] = repositionedPoint[k] * inLength + inCenter[k];
+        }
+        smoothedData->SetTuple(ptId, repositionedPoint);
       }
-      newPts[zero]->SetPoint(i,repositionedPoint);
-    }
+    });
   }
 
 //
@@ -740,7 +517,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     for (i=0; i<numPts; i++)
     {
       inPts->GetPoint(i,x1);
-      newPts[zero]->GetPoint(i,x2);
+      smoothedPts->GetPoint(i,x2);
       newScalars->SetComponent(i,0,
                                sqrt(vtkMath::Distance2BetweenPoints(x1,x2)));
     }
@@ -757,7 +534,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     for (i=0; i<numPts; i++)
     {
       inPts->GetPoint(i,x1);
-      newPts[zero]->GetPoint(i,x2);
+      smoothedPts->GetPoint(i,x2);
       for (j=0; j<3; j++)
       {
         x3[j] = x2[j] - x1[j];
@@ -768,7 +545,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     newVectors->Delete();
   }
 
-  output->SetPoints(newPts[zero]);
+  output->SetPoints(smoothedPts);
   newPts[0]->Delete();
   newPts[1]->Delete();
   newPts[2]->Delete();
@@ -779,16 +556,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  // finally delete the constructed (local) mesh
-  inMesh->Delete();
-
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr ) {Verts[i].edges->Delete();}
-  }
-  delete [] Verts;
-
   return 1;
 }
 
@@ -806,4 +573,5 @@ void vtkWindowedSincPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Nonmanifold Smoothing: " << (this->NonManifoldSmoothing ? "On\n" : "Off\n");
   os << indent << "Generate Error Scalars: " << (this->GenerateErrorScalars ? "On\n" : "Off\n");
   os << indent << "Generate Error Vectors: " << (this->GenerateErrorVectors ? "On\n" : "Off\n");
+  os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
 }
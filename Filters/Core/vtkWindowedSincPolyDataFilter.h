@@ -125,6 +125,18 @@
  * ivar GenerateErrorVectors is on, then a vector representing change in
  * position is computed.
  *
+ * The smoothing positions are computed in double precision, and stored with
+ * the precision given by OutputPointsPrecision. Both the default and single
+ * precision produce float points, whatever the type of the input points;
+ * double precision keeps the accuracy of double input points, at the cost
+ * of twice the memory used by the iterations.
+ *
+ * @warning
+ * This class has been threaded with vtkSMPTools. The connectivity array is
+ * built in parallel from static cell links, and each smoothing iteration
+ * updates the points in parallel. The results do not depend on the number
+ * of threads.
+ *
  * @warning
  * The smoothing operation reduces high frequency information in the
  * geometry of the mesh. With excessive smoothing important details may be
@@ -251,6 +263,17 @@ public:
   vtkBooleanMacro(GenerateErrorVectors,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/get the desired precision for the output types. See the documentation
+   * for the vtkAlgorithm::DesiredOutputPrecision enum for an explanation of
+   * the available precision settings. Unlike most filters, DEFAULT_PRECISION
+   * gives float output points, as this filter always did.
+   */
+  vtkSetMacro(OutputPointsPrecision,int);
+  vtkGetMacro(OutputPointsPrecision,int);
+  //@}
+
  protected:
   vtkWindowedSincPolyDataFilter();
   ~vtkWindowedSincPolyDataFilter() override {}
@@ -267,6 +290,7 @@ public:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   vtkTypeBool NormalizeCoordinates;
+  int OutputPointsPrecision;
 private:
   vtkWindowedSincPolyDataFilter(const vtkWindowedSincPolyDataFilter&) = delete;
   void operator=(const vtkWindowedSincPolyDataFilter&) = delete;
@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExtractCellsParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the output of vtkExtractCells and vtkExtractGeometry on image data,
+// unstructured grids and rectilinear grids, with and without
+// ParallelExecution, and that the parallel output does not depend on the
+// number of threads. Rectilinear grids are always extracted serially.
+
+#include "vtkCellData.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkExtractCells.h"
+#include "vtkExtractGeometry.h"
+#include "vtkIdList.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
+#include "vtkSphere.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+namespace
+{
+
+void AddIds(vtkDataSet *input)
+{
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("InputPointIds");
+  pointIds->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->SetValue(ptId, ptId);
+  }
+  input->GetPointData()->AddArray(pointIds);
+}
+
+// Check that the output cells are the kept cells of the input, in the same
+// order, and that the output points are the kept points (or the used ones
+// when keepPoints is empty), in the input order if inputOrder is true.
+bool CheckOutput(vtkDataSet *input, vtkUnstructuredGrid *output,
+                 const std::vector<char> &keepCells,
+                 std::vector<char> keepPoints, bool inputOrder)
+{
+  vtkIdTypeArray *inputPointIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetPointData()->GetArray("InputPointIds"));
+  vtkIdTypeArray *originalCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!inputPointIds)
+  {
+    cerr << "Missing point ids." << endl;
+    return false;
+  }
+  bool usedPoints = keepPoints.empty();
+  keepPoints.resize(input->GetNumberOfPoints(), 0);
+
+  vtkNew<vtkIdList> cellPts;
+  vtkNew<vtkIdList> outCellPts;
+  vtkIdType outCellId = 0;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    if (!keepCells[cellId])
+    {
+      continue;
+    }
+    input->GetCellPoints(cellId, cellPts);
+    if (outCellId >= output->GetNumberOfCells() ||
+        output->GetCellType(outCellId) != input->GetCellType(cellId) ||
+        (originalCellIds && originalCellIds->GetValue(outCellId) != cellId))
+    {
+      cerr << "Bad output cell " << outCellId << endl;
+      return false;
+    }
+    output->GetCellPoints(outCellId, outCellPts);
+    if (outCellPts->GetNumberOfIds() != cellPts->GetNumberOfIds())
+    {
+      cerr << "Bad size for output cell " << outCellId << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      if (usedPoints)
+      {
+        keepPoints[cellPts->GetId(i)] = 1;
+      }
+      if (inputPointIds->GetValue(outCellPts->GetId(i)) != cellPts->GetId(i))
+      {
+        cerr << "Bad points for output cell " << outCellId << endl;
+        return false;
+      }
+    }
+    ++outCellId;
+  }
+  if (outCellId != output->GetNumberOfCells())
+  {
+    cerr << "Expected " << outCellId << " cells, got "
+         << output->GetNumberOfCells() << endl;
+    return false;
+  }
+
+  vtkIdType outPtId = 0;
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    if (keepPoints[ptId] && !inputOrder)
+    {
+      ++outPtId;
+    }
+    else if (keepPoints[ptId] &&
+        (outPtId >= output->GetNumberOfPoints() ||
+         inputPointIds->GetValue(outPtId++) != ptId))
+    {
+      cerr << "Bad output point " << outPtId - 1 << endl;
+      return false;
+    }
+  }
+  if (outPtId != output->GetNumberOfPoints())
+  {
+    cerr << "Expected " << outPtId << " points, got "
+         << output->GetNumberOfPoints() << endl;
+    return false;
+  }
+  return true;
+}
+
+// Run the filter serially, then in parallel with various numbers of threads,
+// and check the output each time. The parallel output points are in the
+// input order when the input is supported, the serial ones when
+// serialInputOrder is true.
+template <typename Filter>
+bool Check(Filter *filter, vtkDataSet *input,
+           const std::vector<char> &keepCells,
+           const std::vector<char> &keepPoints, bool supported,
+           bool serialInputOrder, const char *name)
+{
+  const int numThreads[] = { 1, 1, 2, 4, 0 };
+  for (int i = 0; i < 5; ++i)
+  {
+    vtkSMPTools::Initialize(numThreads[i]);
+    filter->SetParallelExecution(i > 0);
+    filter->Update();
+    bool inputOrder = (i > 0 && supported) || serialInputOrder;
+    if (!CheckOutput(input, filter->GetOutput(), keepCells, keepPoints,
+                     inputOrder))
+    {
+      cerr << name << " failed with "
+           << (i > 0 ? "parallel" : "serial") << " execution and "
+           << vtkSMPTools::GetEstimatedNumberOfThreads() << " thread(s)."
+           << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestExtractCellsParallel(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 21, 21);
+  AddIds(image);
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(tetrahedralize->GetOutput());
+
+  vtkNew<vtkRectilinearGrid> rectilinear;
+  rectilinear->SetDimensions(21, 21, 21);
+  vtkNew<vtkDoubleArray> coordinates[3];
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int i = 0; i < 21; ++i)
+    {
+      coordinates[axis]->InsertNextValue(i);
+    }
+  }
+  rectilinear->SetXCoordinates(coordinates[0]);
+  rectilinear->SetYCoordinates(coordinates[1]);
+  rectilinear->SetZCoordinates(coordinates[2]);
+  AddIds(rectilinear);
+
+  vtkDataSet *inputs[3] = { image, grid, rectilinear };
+  for (int input = 0; input < 3; ++input)
+  {
+    vtkDataSet *data = inputs[input];
+    bool supported = (input < 2);
+    const vtkIdType numCells = data->GetNumberOfCells();
+    const vtkIdType numPts = data->GetNumberOfPoints();
+
+    // Every third cell, some of them listed twice, out of order.
+    vtkNew<vtkExtractCells> extractCells;
+    extractCells->SetInputData(data);
+    std::vector<char> keepCells(numCells, 0);
+    for (vtkIdType cellId = numCells - 1; cellId >= 0; --cellId)
+    {
+      if (cellId % 3 == 1)
+      {
+        extractCells->AddCellRange(cellId, cellId);
+        keepCells[cellId] = 1;
+      }
+    }
+    extractCells->AddCellRange(numCells / 2, numCells / 2 + 2);
+    keepCells[numCells / 2] = keepCells[numCells / 2 + 1] =
+      keepCells[numCells / 2 + 2] = 1;
+    if (!Check(extractCells.GetPointer(), data, keepCells,
+               std::vector<char>(), supported, true, "vtkExtractCells"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // Cells inside and on the boundary of a sphere.
+    vtkNew<vtkSphere> sphere;
+    sphere->SetCenter(8.0, 10.0, 11.0);
+    sphere->SetRadius(6.5);
+    std::vector<double> values(numPts);
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      values[ptId] = sphere->FunctionValue(data->GetPoint(ptId));
+    }
+    vtkNew<vtkExtractGeometry> extractGeometry;
+    extractGeometry->SetInputData(data);
+    extractGeometry->SetImplicitFunction(sphere);
+    std::vector<char> insidePoints(numPts);
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      insidePoints[ptId] = values[ptId] < 0.0;
+    }
+    vtkNew<vtkIdList> cellPts;
+    for (int boundary = 0; boundary < 3; ++boundary)
+    {
+      extractGeometry->SetExtractBoundaryCells(boundary > 0);
+      extractGeometry->SetExtractOnlyBoundaryCells(boundary > 1);
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        data->GetCellPoints(cellId, cellPts);
+        vtkIdType numInside = 0;
+        for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+          numInside +=
+            (boundary ? values[cellPts->GetId(i)] <= 0.0 :
+                        insidePoints[cellPts->GetId(i)] != 0);
+        }
+        keepCells[cellId] = (boundary == 0 ?
+          numInside == cellPts->GetNumberOfIds() : boundary == 1 ?
+          numInside > 0 :
+          numInside > 0 && numInside < cellPts->GetNumberOfIds());
+      }
+      // The serial boundary extraction numbers the points in the order of
+      // their first use.
+      if (!Check(extractGeometry.GetPointer(), data, keepCells,
+                 boundary ? std::vector<char>() : insidePoints, supported,
+                 boundary == 0, "vtkExtractGeometry"))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkCell.h"
+#include "vtkCellSubsetHelper.h"
 #include "vtkNew.h"
 #include "vtkPoints.h"
 #include "vtkPointData.h"
@@ -34,6 +35,8 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTimeStamp.h"
 
 vtkStandardNewMacro(vtkExtractCells);
@@ -43,6 +46,28 @@ vtkStandardNewMacro(vtkExtractCells);
 #include <vector>
 
 namespace {
+//----------------------------------------------------------------------------
+// Flag the cells of the (sorted and unique) cell list. Ids out of range are
+// ignored.
+struct ExtractCellsMarkCells
+{
+  const vtkIdType *CellIds;
+  vtkIdType NumberOfInputCells;
+  unsigned char *KeepCells;
+
+  void operator()(vtkIdType i, vtkIdType end) const
+  {
+    for ( ; i < end; ++i)
+    {
+      vtkIdType cellId = this->CellIds[i];
+      if (cellId >= 0 && cellId < this->NumberOfInputCells)
+      {
+        this->KeepCells[cellId] = 1;
+      }
+    }
+  }
+};
+
 struct FastPointMap
 {
   using ConstIteratorType = const vtkIdType*;
@@ -193,6 +218,7 @@ vtkExtractCells::vtkExtractCells()
 {
   this->SubSetUGridCellArraySize = 0;
   this->InputIsUgrid = 0;
+  this->ParallelExecution = 0;
   this->CellList = new vtkExtractCellsSTLCloak;
 }
 
@@ -332,6 +358,12 @@ int vtkExtractCells::RequestData(
     return 1;
   }
 
+  if (this->ParallelExecution && vtkCellSubsetHelper::IsSupported(input))
+  {
+    this->ParallelExecute(input, output);
+    return 1;
+  }
+
   vtkPointData *newPD = output->GetPointData();
   vtkCellData *newCD  = output->GetCellData();
 
@@ -688,6 +720,50 @@ void vtkExtractCells::CopyCellsUnstructuredGrid(vtkDataSet *input,
   cellArray->Delete();
 }
 
+//----------------------------------------------------------------------------
+// Flag the cells of the list, then build the output in parallel. The points
+// used by these cells keep their input order.
+void vtkExtractCells::ParallelExecute(vtkDataSet *input,
+                                      vtkUnstructuredGrid *output)
+{
+  vtkIdType numCellsInput = input->GetNumberOfCells();
+  vtkIdType numCells = static_cast<vtkIdType>(this->CellList->CellIds.size());
+  std::vector<unsigned char> keepCells(numCellsInput, 0);
+  ExtractCellsMarkCells markCells = { this->CellList->CellIds.data(),
+                                      numCellsInput, keepCells.data() };
+  vtkSMPTools::For(0, numCells, markCells);
+
+  output->GetPointData()->CopyGlobalIdsOn();
+  output->GetCellData()->CopyGlobalIdsOn();
+
+  int pointsDataType = VTK_FLOAT;
+  vtkPointSet *inputPS = vtkPointSet::SafeDownCast(input);
+  if (inputPS && inputPS->GetPoints())
+  {
+    // preserve input datatype
+    pointsDataType = inputPS->GetPoints()->GetDataType();
+  }
+
+  // We only create vtkOriginalCellIds for the output data set if it does not
+  // exist in the input data set.  If it is in the input data set then we
+  // let CopyData() take care of copying it over.
+  vtkSmartPointer<vtkIdTypeArray> origMap;
+  if (input->GetCellData()->GetArray("vtkOriginalCellIds") == nullptr)
+  {
+    origMap = vtkSmartPointer<vtkIdTypeArray>::New();
+    origMap->SetName("vtkOriginalCellIds");
+  }
+
+  vtkCellSubsetHelper helper(input);
+  helper.Extract(keepCells.data(), nullptr, pointsDataType, output, origMap);
+  if (origMap)
+  {
+    output->GetCellData()->AddArray(origMap);
+  }
+
+  output->Squeeze();
+}
+
 //----------------------------------------------------------------------------
 int vtkExtractCells::FillInputPortInformation(int, vtkInformation *info)
 {
@@ -699,5 +775,8 @@ int vtkExtractCells::FillInputPortInformation(int, vtkInformation *info)
 void vtkExtractCells::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Parallel Execution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
 
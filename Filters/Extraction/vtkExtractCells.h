@@ -26,6 +26,11 @@
  *    composed of these cells.  If the cell list is empty when vtkExtractCells
  *    executes, it will set up the ugrid, point and cell arrays, with no points,
  *    cells or data.
+ *
+ *    When ParallelExecution is on, the output is built in parallel with
+ *    vtkSMPTools (see vtkCellSubsetHelper) for vtkUnstructuredGrid,
+ *    vtkPolyData and vtkImageData inputs. Other inputs are always
+ *    extracted serially.
 */
 
 #ifndef vtkExtractCells_h
@@ -69,6 +74,18 @@ public:
 
   vtkMTimeType GetMTime() override;
 
+  //@{
+  /**
+   * Turn on/off the extraction in parallel with vtkSMPTools. It is only
+   * used for vtkUnstructuredGrid, vtkPolyData and vtkImageData inputs, whose
+   * cells can be read from several threads at once. The output does not
+   * depend on the number of threads. Off by default.
+   */
+  vtkSetMacro(ParallelExecution,vtkTypeBool);
+  vtkGetMacro(ParallelExecution,vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution,vtkTypeBool);
+  //@}
+
 protected:
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
@@ -80,6 +97,7 @@ protected:
 private:
 
   void Copy(vtkDataSet *input, vtkUnstructuredGrid *output);
+  void ParallelExecute(vtkDataSet *input, vtkUnstructuredGrid *output);
   vtkIdType reMapPointIds(vtkDataSet *grid);
 
   void CopyCellsDataSet(vtkDataSet *input,
@@ -91,6 +109,7 @@ private:
 
   vtkIdType SubSetUGridCellArraySize;
   char InputIsUgrid;
+  vtkTypeBool ParallelExecution;
 
   vtkExtractCells(const vtkExtractCells&) = delete;
   void operator=(const vtkExtractCells&) = delete;
@@ -17,6 +17,8 @@
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkCellSubsetHelper.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkImplicitFunction.h"
@@ -25,12 +27,39 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkExtractGeometry);
 vtkCxxSetObjectMacro(vtkExtractGeometry,ImplicitFunction,vtkImplicitFunction);
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Flag the points inside the implicit function.
+struct ExtractGeometryMarkPoints
+{
+  vtkDataArray *Values;
+  double Multiplier;
+  bool Boundary;
+  unsigned char *Inside;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      double val = this->Values->GetComponent(ptId, 0) * this->Multiplier;
+      this->Inside[ptId] = (this->Boundary ? val <= 0.0 : val < 0.0) ? 1 : 0;
+    }
+  }
+};
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 // Construct object with ExtractInside turned on.
 vtkExtractGeometry::vtkExtractGeometry(vtkImplicitFunction *f)
@@ -44,6 +73,7 @@ vtkExtractGeometry::vtkExtractGeometry(vtkImplicitFunction *f)
   this->ExtractInside = 1;
   this->ExtractBoundaryCells = 0;
   this->ExtractOnlyBoundaryCells = 0;
+  this->ParallelExecution = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -116,6 +146,12 @@ int vtkExtractGeometry::RequestData(
   outputPD->CopyGlobalIdsOn();
   outputCD->CopyGlobalIdsOn();
 
+  if ( this->ParallelExecution && vtkCellSubsetHelper::IsSupported(input) )
+  {
+    this->ParallelExecute(input, output);
+    return 1;
+  }
+
   newCellPts = vtkIdList::New();
   newCellPts->Allocate(VTK_CELL_SIZE);
 
@@ -289,6 +325,88 @@ int vtkExtractGeometry::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The implicit function is evaluated on this thread, since implicit
+// functions are not required to be thread safe. The cells are then
+// classified and the output built in parallel.
+void vtkExtractGeometry::ParallelExecute(vtkDataSet *input,
+                                         vtkUnstructuredGrid *output)
+{
+  vtkIdType ptId, numPts = input->GetNumberOfPoints();
+  double x[3];
+  double multiplier = ( this->ExtractInside ? 1.0 : -1.0 );
+
+  // Evaluate the implicit function at all the points, with the array API
+  // when the points are available. The boundary mode compares single
+  // precision values, like the serial path.
+  vtkSmartPointer<vtkDataArray> values;
+  if ( this->ExtractBoundaryCells )
+  {
+    values = vtkSmartPointer<vtkFloatArray>::New();
+  }
+  else
+  {
+    values = vtkSmartPointer<vtkDoubleArray>::New();
+  }
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if ( pointSet && pointSet->GetPoints() )
+  {
+    this->ImplicitFunction->FunctionValue(pointSet->GetPoints()->GetData(),
+                                          values);
+  }
+  else
+  {
+    values->SetNumberOfTuples(numPts);
+    for ( ptId=0; ptId < numPts; ptId++ )
+    {
+      input->GetPoint(ptId, x);
+      values->SetTuple1(ptId, this->ImplicitFunction->FunctionValue(x));
+    }
+  }
+
+  // Flag the points inside the implicit function, i.e. the points whose
+  // value times the multiplier is negative (or zero in boundary mode).
+  std::vector<unsigned char> inside(numPts);
+  ExtractGeometryMarkPoints markPoints;
+  markPoints.Values = values;
+  markPoints.Multiplier = multiplier;
+  markPoints.Boundary = (this->ExtractBoundaryCells != 0);
+  markPoints.Inside = inside.data();
+  vtkSMPTools::For(0, numPts, markPoints);
+
+  // Now check in parallel whether the cells are inside the implicit
+  // function (or on boundary if ExtractBoundaryCells is on).
+  const unsigned char *isInside = inside.data();
+  int extractBoundaryCells = this->ExtractBoundaryCells;
+  int extractOnlyBoundaryCells = this->ExtractOnlyBoundaryCells;
+  auto criterion = [isInside, extractBoundaryCells, extractOnlyBoundaryCells](
+    vtkIdType, vtkIdType numCellPts, const vtkIdType *cellPts)
+  {
+    vtkIdType npts = 0;
+    for (vtkIdType i = 0; i < numCellPts; i++)
+    {
+      npts += isInside[cellPts[i]];
+    }
+    if ( extractOnlyBoundaryCells )
+    {
+      return npts != numCellPts && (extractBoundaryCells && npts > 0);
+    }
+    return npts >= numCellPts || (extractBoundaryCells && npts > 0);
+  };
+
+  vtkCellSubsetHelper helper(input);
+  std::vector<unsigned char> keepCells(input->GetNumberOfCells());
+  helper.MarkCells(criterion, keepCells.data());
+
+  // Without the boundary cells all the points inside are kept, used or not,
+  // like in the serial path. The output points are single precision.
+  helper.Extract(keepCells.data(),
+                 this->ExtractBoundaryCells ? nullptr : inside.data(),
+                 VTK_FLOAT, output);
+
+  output->Squeeze();
+}
+
 //----------------------------------------------------------------------------
 int vtkExtractGeometry::FillInputPortInformation(int, vtkInformation *info)
 {
@@ -309,4 +427,6 @@ void vtkExtractGeometry::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ExtractBoundaryCells ? "On\n" : "Off\n");
   os << indent << "Extract Only Boundary Cells: "
      << (this->ExtractOnlyBoundaryCells ? "On\n" : "Off\n");
+  os << indent << "Parallel Execution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
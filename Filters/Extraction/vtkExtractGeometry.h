@@ -28,6 +28,10 @@
  * region.) An option exists to extract cells that are neither inside or
  * outside (i.e., boundary).
  *
+ * When ParallelExecution is on, the cells are classified and the output is
+ * built with vtkSMPTools (see vtkCellSubsetHelper) for vtkUnstructuredGrid,
+ * vtkPolyData and vtkImageData inputs.
+ *
  * A more efficient version of this filter is available for vtkPolyData input.
  * See vtkExtractPolyDataGeometry.
  *
@@ -91,6 +95,20 @@ public:
   vtkBooleanMacro(ExtractOnlyBoundaryCells,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the classification of the cells and the building of the
+   * output in parallel with vtkSMPTools. The implicit function is still
+   * evaluated on the calling thread. It is only used for
+   * vtkUnstructuredGrid, vtkPolyData and vtkImageData inputs, and when
+   * ExtractBoundaryCells is on, the output points are in the order of the
+   * input points instead of the order of their first use. Off by default.
+   */
+  vtkSetMacro(ParallelExecution,vtkTypeBool);
+  vtkGetMacro(ParallelExecution,vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution,vtkTypeBool);
+  //@}
+
 protected:
   vtkExtractGeometry(vtkImplicitFunction *f=nullptr);
   ~vtkExtractGeometry() override;
@@ -104,8 +122,11 @@ protected:
   vtkTypeBool ExtractInside;
   vtkTypeBool ExtractBoundaryCells;
   vtkTypeBool ExtractOnlyBoundaryCells;
+  vtkTypeBool ParallelExecution;
 
 private:
+  void ParallelExecute(vtkDataSet *input, vtkUnstructuredGrid *output);
+
   vtkExtractGeometry(const vtkExtractGeometry&) = delete;
   void operator=(const vtkExtractGeometry&) = delete;
 };
@@ -0,0 +1,394 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLagrangianParticleTrackerParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the parallel execution of vtkLagrangianParticleTracker gives
+// the same paths, interactions and particle ids as the serial execution,
+// with any number of threads, including the particles created by a break-up
+// surface, and that a model which does not copy all its parameters is
+// integrated serially.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkImageDataToPointSet.h"
+#include "vtkLagrangianMatidaIntegrationModel.h"
+#include "vtkLagrangianParticleTracker.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkRungeKutta2.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+namespace
+{
+
+// A model with a parameter of its own, that CopyParameters does not copy.
+class ScaledMatidaModel : public vtkLagrangianMatidaIntegrationModel
+{
+public:
+  vtkTypeMacro(ScaledMatidaModel, vtkLagrangianMatidaIntegrationModel);
+  static ScaledMatidaModel* New();
+
+  using Superclass::FunctionValues;
+
+  int FunctionValues(vtkDataSet* dataSet, vtkIdType cellId,
+    double* weights, double* x, double* f) override
+  {
+    int ret = this->Superclass::FunctionValues(dataSet, cellId, weights, x, f);
+    for (int i = 0; i < this->NumFuncs; ++i)
+    {
+      f[i] *= this->Scale;
+    }
+    return ret;
+  }
+
+  double Scale = 1.0;
+
+protected:
+  ScaledMatidaModel() = default;
+  ~ScaledMatidaModel() override = default;
+};
+vtkStandardNewMacro(ScaledMatidaModel);
+
+void CountWarnings(vtkObject*, unsigned long, void* clientData, void*)
+{
+  ++*static_cast<int*>(clientData);
+}
+
+vtkSmartPointer<vtkPolyData> MakePlane(double origin[3], double point1[3],
+                                       double point2[3], int surfaceType)
+{
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetOrigin(origin);
+  plane->SetPoint1(point1);
+  plane->SetPoint2(point2);
+  plane->SetResolution(4, 4);
+  plane->Update();
+  vtkSmartPointer<vtkPolyData> pd = plane->GetOutput();
+  vtkNew<vtkDoubleArray> surfaceTypes;
+  surfaceTypes->SetName("SurfaceType");
+  surfaceTypes->SetNumberOfTuples(pd->GetNumberOfCells());
+  surfaceTypes->FillComponent(0, surfaceType);
+  pd->GetCellData()->AddArray(surfaceTypes);
+  return pd;
+}
+
+bool CompareArrays(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    cerr << "Bad number of arrays." << endl;
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    if (!arrayB || arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        arrayA->GetNumberOfComponents() != arrayB->GetNumberOfComponents())
+    {
+      cerr << "Bad array " << arrayA->GetName() << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < arrayA->GetNumberOfTuples(); ++j)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        if (arrayA->GetComponent(j, c) != arrayB->GetComponent(j, c))
+        {
+          cerr << "Bad value in array " << arrayA->GetName() << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool CompareCells(vtkCellArray *a, vtkCellArray *b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    cerr << "Bad number of cells." << endl;
+    return false;
+  }
+  vtkIdType nptsA, nptsB;
+  vtkIdType *ptsA, *ptsB;
+  a->InitTraversal();
+  b->InitTraversal();
+  while (a->GetNextCell(nptsA, ptsA))
+  {
+    b->GetNextCell(nptsB, ptsB);
+    if (nptsA != nptsB)
+    {
+      cerr << "Bad cell." << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < nptsA; ++i)
+    {
+      if (ptsA[i] != ptsB[i])
+      {
+        cerr << "Bad cell." << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+  {
+    cerr << "Bad number of points: " << b->GetNumberOfPoints()
+         << " instead of " << a->GetNumberOfPoints() << endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double ptA[3], ptB[3];
+    a->GetPoint(ptId, ptA);
+    b->GetPoint(ptId, ptB);
+    if (ptA[0] != ptB[0] || ptA[1] != ptB[1] || ptA[2] != ptB[2])
+    {
+      cerr << "Bad point " << ptId << endl;
+      return false;
+    }
+  }
+  return CompareCells(a->GetLines(), b->GetLines()) &&
+    CompareCells(a->GetVerts(), b->GetVerts()) &&
+    CompareArrays(a->GetPointData(), b->GetPointData()) &&
+    CompareArrays(a->GetCellData(), b->GetCellData());
+}
+
+bool CompareInteractions(vtkMultiBlockDataSet *a, vtkMultiBlockDataSet *b)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(a->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(a->GetDataSet(iter));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(b->GetDataSet(iter));
+    if (!pdA || !pdB || !Compare(pdA, pdB))
+    {
+      cerr << "Bad interactions for block " << iter->GetCurrentFlatIndex()
+           << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestLagrangianParticleTrackerParallel(int, char *[])
+{
+  // Seeds on a grid, with various initial velocities
+  vtkNew<vtkPolyData> seeds;
+  vtkNew<vtkPoints> seedPoints;
+  vtkNew<vtkDoubleArray> partVel;
+  partVel->SetNumberOfComponents(3);
+  partVel->SetName("InitialVelocity");
+  for (int i = 0; i < 12; ++i)
+  {
+    for (int j = 0; j < 12; ++j)
+    {
+      seedPoints->InsertNextPoint(-5.5 + i, -5.5 + j, 0.5 * ((i + j) % 2));
+      partVel->InsertNextTuple3(0.5 * (i % 4) - 0.7, 0.4 * (j % 5) - 0.8,
+                                -2.0 - 0.5 * ((i * j) % 3));
+    }
+  }
+  seeds->SetPoints(seedPoints);
+  vtkIdType numSeeds = seeds->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> partDens;
+  partDens->SetName("ParticleDensity");
+  partDens->SetNumberOfTuples(numSeeds);
+  partDens->FillComponent(0, 1920);
+  vtkNew<vtkDoubleArray> partDiam;
+  partDiam->SetName("ParticleDiameter");
+  partDiam->SetNumberOfTuples(numSeeds);
+  partDiam->FillComponent(0, 0.1);
+  seeds->GetPointData()->AddArray(partVel);
+  seeds->GetPointData()->AddArray(partDens);
+  seeds->GetPointData()->AddArray(partDiam);
+
+  // A wavelet with a uniform flow
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->Update();
+  vtkNew<vtkImageData> flow;
+  flow->ShallowCopy(wavelet->GetOutput());
+  vtkIdType numCells = flow->GetNumberOfCells();
+  vtkNew<vtkDoubleArray> flowVel;
+  flowVel->SetNumberOfComponents(3);
+  flowVel->SetNumberOfTuples(numCells);
+  flowVel->SetName("FlowVelocity");
+  flowVel->FillComponent(0, -0.3);
+  flowVel->FillComponent(1, 0.2);
+  flowVel->FillComponent(2, -0.3);
+  vtkNew<vtkDoubleArray> flowDens;
+  flowDens->SetNumberOfTuples(numCells);
+  flowDens->SetName("FlowDensity");
+  flowDens->FillComponent(0, 1000);
+  vtkNew<vtkDoubleArray> flowDynVisc;
+  flowDynVisc->SetNumberOfTuples(numCells);
+  flowDynVisc->SetName("FlowDynamicViscosity");
+  flowDynVisc->FillComponent(0, 0.894);
+  flow->GetCellData()->AddArray(flowVel);
+  flow->GetCellData()->AddArray(flowDens);
+  flow->GetCellData()->AddArray(flowDynVisc);
+
+  vtkNew<vtkImageDataToPointSet> pointSetFlow;
+  pointSetFlow->SetInputData(flow);
+  pointSetFlow->Update();
+
+  // Terminating outer surface, and break-up, bounce and pass-through planes.
+  // The particles created by a break-up start on the surface and break up
+  // again, so the number of steps is kept small.
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(flow);
+  surface->Update();
+  vtkNew<vtkPolyData> surfacePd;
+  surfacePd->ShallowCopy(surface->GetOutput());
+  vtkNew<vtkDoubleArray> surfaceTypeTerm;
+  surfaceTypeTerm->SetName("SurfaceType");
+  surfaceTypeTerm->SetNumberOfTuples(surfacePd->GetNumberOfCells());
+  surfaceTypeTerm->FillComponent(0,
+    vtkLagrangianBasicIntegrationModel::SURFACE_TYPE_TERM);
+  surfacePd->GetCellData()->AddArray(surfaceTypeTerm);
+
+  double breakOrigin[3] = { -3, -3, -0.5 };
+  double breakPoint1[3] = { 3, -3, -0.5 };
+  double breakPoint2[3] = { -3, 3, -0.5 };
+  double bounceOrigin[3] = { -9, -9, -5 };
+  double bouncePoint1[3] = { 0, -9, -5 };
+  double bouncePoint2[3] = { -9, 9, -5 };
+  double passOrigin[3] = { -9, 2, -9 };
+  double passPoint1[3] = { 9, 2, -9 };
+  double passPoint2[3] = { -9, 2, 9 };
+  vtkNew<vtkMultiBlockDataSet> surfaces;
+  surfaces->SetNumberOfBlocks(4);
+  surfaces->SetBlock(0, surfacePd);
+  surfaces->SetBlock(1, MakePlane(breakOrigin, breakPoint1, breakPoint2,
+    vtkLagrangianBasicIntegrationModel::SURFACE_TYPE_BREAK));
+  surfaces->SetBlock(2, MakePlane(bounceOrigin, bouncePoint1, bouncePoint2,
+    vtkLagrangianBasicIntegrationModel::SURFACE_TYPE_BOUNCE));
+  surfaces->SetBlock(3, MakePlane(passOrigin, passPoint1, passPoint2,
+    vtkLagrangianBasicIntegrationModel::SURFACE_TYPE_PASS));
+
+  vtkNew<vtkLagrangianMatidaIntegrationModel> integrationModel;
+  integrationModel->SetInputArrayToProcess(0, 1, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "InitialVelocity");
+  integrationModel->SetInputArrayToProcess(2, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "SurfaceType");
+  integrationModel->SetInputArrayToProcess(3, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "FlowVelocity");
+  integrationModel->SetInputArrayToProcess(4, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "FlowDensity");
+  integrationModel->SetInputArrayToProcess(5, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, "FlowDynamicViscosity");
+  integrationModel->SetInputArrayToProcess(6, 1, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "ParticleDiameter");
+  integrationModel->SetInputArrayToProcess(7, 1, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "ParticleDensity");
+  vtkNew<vtkRungeKutta2> integrator;
+
+  vtkDataObject *flows[2] = { flow, pointSetFlow->GetOutputDataObject(0) };
+  const int modes[2] = { vtkLagrangianParticleTracker::STEP_CUR_CELL_VEL_DIR,
+    vtkLagrangianParticleTracker::STEP_LAST_CELL_LENGTH };
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int f = 0; f < 2; ++f)
+  {
+    vtkNew<vtkLagrangianParticleTracker> tracker;
+    tracker->SetIntegrationModel(integrationModel);
+    tracker->SetIntegrator(integrator);
+    tracker->SetInputData(flows[f]);
+    tracker->SetSourceData(seeds);
+    tracker->SetSurfaceData(surfaces);
+    tracker->SetStepFactor(0.2);
+    tracker->SetStepFactorMin(0.2);
+    tracker->SetStepFactorMax(0.2);
+    tracker->SetMaximumNumberOfSteps(10);
+    tracker->SetCellLengthComputationMode(modes[f]);
+    tracker->Update();
+    vtkNew<vtkPolyData> serialPaths;
+    serialPaths->DeepCopy(tracker->GetOutput(0));
+    vtkNew<vtkMultiBlockDataSet> serialInteractions;
+    serialInteractions->DeepCopy(tracker->GetOutput(1));
+    if (serialPaths->GetNumberOfLines() <= numSeeds)
+    {
+      cerr << "No particle was created by the break-up surface." << endl;
+      return EXIT_FAILURE;
+    }
+
+    tracker->ParallelExecutionOn();
+    for (int t = 0; t < 4; ++t)
+    {
+      vtkSMPTools::Initialize(numThreads[t]);
+      tracker->Modified();
+      tracker->Update();
+      if (!Compare(serialPaths, vtkPolyData::SafeDownCast(
+            tracker->GetOutput(0))) ||
+          !CompareInteractions(serialInteractions,
+            vtkMultiBlockDataSet::SafeDownCast(tracker->GetOutput(1))))
+      {
+        cerr << "Parallel output with " << numThreads[t] << " thread(s) "
+             << "differs for flow " << f << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The copies of the scaled model would lose their scale, so the tracker
+  // warns and integrates serially.
+  vtkNew<ScaledMatidaModel> scaledModel;
+  scaledModel->CopyParameters(integrationModel);
+  scaledModel->Scale = 2.0;
+  vtkNew<vtkLagrangianParticleTracker> tracker;
+  tracker->SetIntegrationModel(scaledModel);
+  tracker->SetIntegrator(integrator);
+  tracker->SetInputData(flow);
+  tracker->SetSourceData(seeds);
+  tracker->SetSurfaceData(surfaces);
+  tracker->SetMaximumNumberOfSteps(10);
+  tracker->Update();
+  vtkNew<vtkPolyData> serialPaths;
+  serialPaths->DeepCopy(tracker->GetOutput(0));
+
+  int numWarnings = 0;
+  vtkNew<vtkCallbackCommand> warningObserver;
+  warningObserver->SetCallback(CountWarnings);
+  warningObserver->SetClientData(&numWarnings);
+  tracker->AddObserver(vtkCommand::WarningEvent, warningObserver);
+  tracker->ParallelExecutionOn();
+  tracker->Update();
+  if (numWarnings != 1 || !Compare(serialPaths,
+        vtkPolyData::SafeDownCast(tracker->GetOutput(0))))
+  {
+    cerr << "A model which does not copy all its parameters was not "
+         << "integrated serially." << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
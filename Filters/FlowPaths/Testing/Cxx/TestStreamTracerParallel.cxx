@@ -0,0 +1,256 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the parallel execution of vtkStreamTracer gives the same
+// output with any number of threads, and the same output as the serial
+// execution for a single dataset, with both interpolator types.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRungeKutta45.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStreamTracer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+// An unstructured grid of hexahedra covering [x0, x1] x [-1, 1] x [-1, 1]
+// with a swirling velocity field and a scalar field.
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int i0, int i1)
+{
+  const int res = 12;
+  vtkNew<vtkImageData> image;
+  image->SetExtent(i0, i1, -res, res, -res, res);
+  image->SetSpacing(1.0 / res, 1.0 / res, 1.0 / res);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("Velocity");
+  velocity->SetNumberOfComponents(3);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    image->GetPoint(ptId, x);
+    points->InsertNextPoint(x);
+    velocity->InsertNextTuple3(-x[1] + 0.1 * x[2], x[0],
+                               0.2 + 0.3 * std::sin(3.0 * x[0]));
+    scalars->InsertNextValue(x[0] * x[1] + x[2]);
+  }
+  grid->SetPoints(points);
+  grid->Allocate(image->GetNumberOfCells());
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, cellPts);
+    grid->InsertNextCell(image->GetCellType(cellId), cellPts);
+  }
+  grid->GetPointData()->AddArray(velocity);
+  grid->GetPointData()->AddArray(scalars);
+  return grid;
+}
+
+bool CompareArrays(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    cerr << "Bad number of arrays." << endl;
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    if (!arrayB || arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        arrayA->GetNumberOfComponents() != arrayB->GetNumberOfComponents())
+    {
+      cerr << "Bad array " << arrayA->GetName() << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < arrayA->GetNumberOfTuples(); ++j)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        if (arrayA->GetComponent(j, c) != arrayB->GetComponent(j, c))
+        {
+          cerr << "Bad value in array " << arrayA->GetName() << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfLines() != b->GetNumberOfLines())
+  {
+    cerr << "Bad number of points or lines: " << b->GetNumberOfPoints()
+         << " " << b->GetNumberOfLines() << " instead of "
+         << a->GetNumberOfPoints() << " " << a->GetNumberOfLines() << endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double ptA[3], ptB[3];
+    a->GetPoint(ptId, ptA);
+    b->GetPoint(ptId, ptB);
+    if (ptA[0] != ptB[0] || ptA[1] != ptB[1] || ptA[2] != ptB[2])
+    {
+      cerr << "Bad point " << ptId << endl;
+      return false;
+    }
+  }
+  vtkCellArray *linesA = a->GetLines();
+  vtkCellArray *linesB = b->GetLines();
+  vtkIdType nptsA, nptsB;
+  vtkIdType *ptsA, *ptsB;
+  linesA->InitTraversal();
+  linesB->InitTraversal();
+  while (linesA->GetNextCell(nptsA, ptsA))
+  {
+    linesB->GetNextCell(nptsB, ptsB);
+    if (nptsA != nptsB)
+    {
+      cerr << "Bad line." << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < nptsA; ++i)
+    {
+      if (ptsA[i] != ptsB[i])
+      {
+        cerr << "Bad line." << endl;
+        return false;
+      }
+    }
+  }
+  return CompareArrays(a->GetPointData(), b->GetPointData()) &&
+    CompareArrays(a->GetCellData(), b->GetCellData());
+}
+
+vtkSmartPointer<vtkPolyData> Trace(vtkDataObject *input, vtkPolyData *seeds,
+                                   bool cellLocator, bool parallel)
+{
+  vtkNew<vtkStreamTracer> tracer;
+  tracer->SetInputData(input);
+  tracer->SetSourceData(seeds);
+  tracer->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "Velocity");
+  if (cellLocator)
+  {
+    // The cell found for a point on a face shared by several cells must not
+    // depend on the locator instance, which rules out vtkModifiedBSPTree.
+    vtkNew<vtkCellLocatorInterpolatedVelocityField> interpolator;
+    vtkNew<vtkStaticCellLocator> locator;
+    interpolator->SetCellLocatorPrototype(locator);
+    tracer->SetInterpolatorPrototype(interpolator);
+  }
+  vtkNew<vtkRungeKutta45> integrator;
+  tracer->SetIntegrator(integrator);
+  tracer->SetIntegrationDirectionToBoth();
+  tracer->SetMaximumPropagation(20.0);
+  tracer->SetMaximumNumberOfSteps(500);
+  tracer->SetComputeVorticity(true);
+  tracer->SetParallelExecution(parallel);
+  tracer->Update();
+  return tracer->GetOutput();
+}
+
+} // end anon namespace
+
+int TestStreamTracerParallel(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeGrid(-12, 12);
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  blocks->SetNumberOfBlocks(2);
+  blocks->SetBlock(0, MakeGrid(-12, 0));
+  blocks->SetBlock(1, MakeGrid(0, 12));
+
+  // Seeds in the domain, and a few outside of it.
+  vtkNew<vtkPolyData> seeds;
+  vtkNew<vtkPoints> seedPoints;
+  for (int i = 0; i < 15; ++i)
+  {
+    for (int j = 0; j < 15; ++j)
+    {
+      seedPoints->InsertNextPoint(-1.05 + 0.15 * i, -0.95 + 0.13 * j,
+                                  -0.9 + 0.1 * ((i + j) % 10));
+    }
+  }
+  seeds->SetPoints(seedPoints);
+
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int type = 0; type < 2; ++type)
+  {
+    vtkSmartPointer<vtkPolyData> serial =
+      Trace(grid, seeds, type == 1, false);
+    if (serial->GetNumberOfLines() < 200)
+    {
+      cerr << "Too few lines: " << serial->GetNumberOfLines() << endl;
+      return EXIT_FAILURE;
+    }
+    vtkSmartPointer<vtkPolyData> multiBlock;
+    for (int t = 0; t < 4; ++t)
+    {
+      vtkSMPTools::Initialize(numThreads[t]);
+      if (!Compare(serial, Trace(grid, seeds, type == 1, true)))
+      {
+        cerr << "Parallel output with " << numThreads[t] << " thread(s) "
+             << "differs for interpolator " << type << endl;
+        return EXIT_FAILURE;
+      }
+
+      vtkSmartPointer<vtkPolyData> output =
+        Trace(blocks, seeds, type == 1, true);
+      if (t == 0)
+      {
+        multiBlock = output;
+        if (multiBlock->GetNumberOfLines() != serial->GetNumberOfLines())
+        {
+          cerr << "Bad number of lines for the multiblock input." << endl;
+          return EXIT_FAILURE;
+        }
+      }
+      else if (!Compare(multiBlock, output))
+      {
+        cerr << "Multiblock output with " << numThreads[t] << " thread(s) "
+             << "differs for interpolator " << type << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
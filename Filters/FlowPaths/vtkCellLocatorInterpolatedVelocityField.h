@@ -102,6 +102,14 @@ public:
    */
   void AddDataSet( vtkDataSet * dataset ) override;
 
+  /**
+   * Add all the datasets of another interpolator. When from is a
+   * vtkCellLocatorInterpolatedVelocityField, its cell locators are shared
+   * instead of being created again, so that several interpolators, e.g. one
+   * per thread, can use them once they are built.
+   */
+  void AddDataSets( vtkCompositeInterpolatedVelocityField * from ) override;
+
   /**
    * Evaluate the velocity field f at point (x, y, z).
    */
@@ -35,6 +35,19 @@ vtkCompositeInterpolatedVelocityField::~vtkCompositeInterpolatedVelocityField()
   this->DataSets = nullptr;
 }
 
+void vtkCompositeInterpolatedVelocityField::AddDataSets
+  ( vtkCompositeInterpolatedVelocityField * from )
+{
+  if ( !from || from == this )
+  {
+    return;
+  }
+  for ( size_t i = 0; i < from->DataSets->size(); i ++ )
+  {
+    this->AddDataSet( ( *from->DataSets )[i] );
+  }
+}
+
 void vtkCompositeInterpolatedVelocityField::PrintSelf( ostream & os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
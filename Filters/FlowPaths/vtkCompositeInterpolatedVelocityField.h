@@ -106,6 +106,14 @@ public:
    */
   virtual void AddDataSet( vtkDataSet * dataset ) = 0;
 
+  /**
+   * Add all the datasets of another interpolator, e.g. to evaluate the same
+   * field with one interpolator per thread. Sub-classes associating search
+   * structures with the datasets share those of from when it is of the same
+   * type. THIS FUNCTION DOES NOT CHANGE THE REFERENCE COUNT OF THE DATASETS.
+   */
+  virtual void AddDataSets( vtkCompositeInterpolatedVelocityField * from );
+
 
 protected:
   vtkCompositeInterpolatedVelocityField();
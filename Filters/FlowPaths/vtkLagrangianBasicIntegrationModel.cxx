@@ -20,6 +20,7 @@
 #include "vtkDataSet.h"
 #include "vtkFieldData.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIntArray.h"
 #include "vtkLagrangianParticle.h"
 #include "vtkLagrangianParticleTracker.h"
@@ -27,6 +28,7 @@
 #include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkQuad.h"
 #include "vtkSetGet.h"
 #include "vtkSmartPointer.h"
@@ -36,6 +38,7 @@
 #include "vtkVector.h"
 
 #include <cassert>
+#include <cstring>
 #include <set>
 #include <sstream>
 #include <vector>
@@ -610,6 +613,16 @@ void vtkLagrangianBasicIntegrationModel::AddDataSet(vtkDataSet * dataset,
     return;
   }
 
+  // Build the cells of a polydata and cache the ghost array now, as the
+  // threads integrating particles concurrently access the cells of the
+  // datasets
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(dataset);
+  if (polyData && polyData->NeedToBuildCells())
+  {
+    polyData->BuildCells();
+  }
+  dataset->GetCellGhostArray();
+
   // insert the dataset into DataSet vector
   if (surface)
   {
@@ -684,6 +697,60 @@ void vtkLagrangianBasicIntegrationModel::ClearDataSets(bool surface)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkLagrangianBasicIntegrationModel::CopyParameters(
+  vtkLagrangianBasicIntegrationModel* from)
+{
+  this->SetLocator(from->Locator);
+  this->InputArrays = from->InputArrays;
+  this->SurfaceArrayDescriptions = from->SurfaceArrayDescriptions;
+  this->NumFuncs = from->NumFuncs;
+  this->NumIndepVars = from->NumIndepVars;
+  this->Tolerance = from->Tolerance;
+  this->NonPlanarQuadSupport = from->NonPlanarQuadSupport;
+  this->UseInitialIntegrationTime = from->UseInitialIntegrationTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkLagrangianBasicIntegrationModel::AddDataSets(
+  vtkLagrangianBasicIntegrationModel* from)
+{
+  if (!from || from == this)
+  {
+    return;
+  }
+
+  // The locators are shared, they are built by the model which added
+  // the datasets first
+  for (size_t iDs = 0; iDs < from->DataSets->size(); iDs++)
+  {
+    this->DataSets->push_back((*from->DataSets)[iDs]);
+    this->Locators->push_back((*from->Locators)[iDs]);
+  }
+  for (size_t iDs = 0; iDs < from->Surfaces->size(); iDs++)
+  {
+    (*from->Surfaces)[iDs].second->Register(this);
+    this->Surfaces->push_back((*from->Surfaces)[iDs]);
+    this->SurfaceLocators->push_back((*from->SurfaceLocators)[iDs]);
+  }
+
+  // Resize LastWeights if necessary
+  if (from->WeightsSize > this->WeightsSize)
+  {
+    this->WeightsSize = from->WeightsSize;
+    delete[] this->LastWeights;
+    this->LastWeights = new double[this->WeightsSize];
+  }
+  this->LocatorsBuilt = from->LocatorsBuilt;
+}
+
+//----------------------------------------------------------------------------
+void vtkLagrangianBasicIntegrationModel::ClearLastDataSet()
+{
+  this->LastDataSet = nullptr;
+  this->LastLocator = nullptr;
+}
+
 //----------------------------------------------------------------------------
 int vtkLagrangianBasicIntegrationModel::FunctionValues(double* x, double* f)
 {
@@ -763,8 +830,9 @@ vtkLagrangianParticle* vtkLagrangianBasicIntegrationModel::ComputeSurfaceInterac
         double tmpFactor;
         double tmpPoint[3];
         vtkIdType tmpCellId = cellList->GetId(i);
-        vtkCell* cell = tmpSurface->GetCell(tmpCellId);
-        if (this->IntersectWithLine(cell, particle->GetPosition(),
+        tmpSurface->GetCell(tmpCellId, this->Cell);
+        if (this->IntersectWithLine(this->Cell->GetRepresentativeCell(),
+          particle->GetPosition(),
           particle->GetNextPosition(), this->Tolerance,
           tmpFactor, tmpPoint) == 0)
         {
@@ -1167,13 +1235,11 @@ bool vtkLagrangianBasicIntegrationModel::FindInLocators(double* x,
     return false;
   }
 
-  vtkNew<vtkGenericCell> cell;
-
   // We have a cache
   if (this->LastDataSet != nullptr)
   {
     cellId = this->FindInLocator(this->LastDataSet, this->LastLocator, x,
-      cell, weights);
+      this->Cell, weights);
     if (cellId != -1)
     {
       dataset = this->LastDataSet;
@@ -1189,7 +1255,7 @@ bool vtkLagrangianBasicIntegrationModel::FindInLocators(double* x,
     dataset = (*this->DataSets)[iDs];
     if (dataset != this->LastDataSet)
     {
-      cellId = this->FindInLocator(dataset, loc, x, cell, weights);
+      cellId = this->FindInLocator(dataset, loc, x, this->Cell, weights);
       if (cellId != -1)
       {
         return true;
@@ -1348,15 +1414,19 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
       }
       // Setup the tmpArray and Interpolate
       nComponents = array->GetNumberOfComponents();
-      if (this->TmpArray != nullptr)
+      if (this->TmpArray == nullptr ||
+        strcmp(this->TmpArray->GetClassName(), array->GetClassName()) != 0)
       {
-        this->TmpArray->Delete();
+        if (this->TmpArray != nullptr)
+        {
+          this->TmpArray->Delete();
+        }
+        this->TmpArray = array->NewInstance();
       }
-      this->TmpArray = array->NewInstance();
       this->TmpArray->SetNumberOfComponents(nComponents);
       this->TmpArray->SetNumberOfTuples(1);
-      this->TmpArray->InterpolateTuple(
-        0, dataSet->GetCell(tupleId)->GetPointIds(), array, weights);
+      dataSet->GetCellPoints(tupleId, this->TmpIdList);
+      this->TmpArray->InterpolateTuple(0, this->TmpIdList, array, weights);
 
       // Recover data
       data = this->TmpArray->GetTuple(0);
@@ -1379,7 +1449,9 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
         return false;
       }
       nComponents = array->GetNumberOfComponents();
-      data = array->GetTuple(tupleId);
+      this->TmpTuple.resize(nComponents);
+      array->GetTuple(tupleId, this->TmpTuple.data());
+      data = this->TmpTuple.data();
       return true;
     }
     case vtkDataObject::FIELD_ASSOCIATION_NONE:
@@ -1393,7 +1465,9 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
         return false;
       }
       nComponents = array->GetNumberOfComponents();
-      data = array->GetTuple(tupleId);
+      this->TmpTuple.resize(nComponents);
+      array->GetTuple(tupleId, this->TmpTuple.data());
+      data = this->TmpTuple.data();
       return true;
     }
     default:
@@ -43,6 +43,13 @@
  * Inherited class could reimplement CheckFreeFlightTermination to set
  * the way particle terminate in free flight
  *
+ * When the tracker integrates the particles concurrently, each thread uses
+ * its own instance of the model, created with NewInstance() and set up with
+ * CopyParameters() and AddDataSets(). Inherited classes with parameters of
+ * their own must reimplement CopyParameters to copy them, and all inherited
+ * classes must reimplement GetCopyParametersClassName to allow the
+ * concurrent integration, else the tracker warns and integrates serially.
+ *
  * @sa
  * vtkLagrangianParticleTracker vtkLagrangianParticle
  * vtkLagrangianMatidaIntegrationModel
@@ -58,6 +65,7 @@
 
 #include <queue> // for new particles
 #include <map> // for array indexes
+#include <vector> // for temporary tuple
 
 class vtkAbstractArray;
 class vtkAbstractCellLocator;
@@ -70,6 +78,7 @@ class vtkDataSetsType;
 class vtkDoubleArray;
 class vtkFieldData;
 class vtkGenericCell;
+class vtkIdList;
 class vtkIntArray;
 class vtkLagrangianParticle;
 class vtkLagrangianParticleTracker;
@@ -152,6 +161,37 @@ public:
   virtual void ClearDataSets(bool surface = false);
   //@}
 
+  /**
+   * Copy the parameters of another model of the same class: the locator,
+   * the input arrays to process, the tolerance and the flags. The datasets
+   * are not copied, see AddDataSets.
+   */
+  virtual void CopyParameters(vtkLagrangianBasicIntegrationModel* from);
+
+  /**
+   * Return the name of the class whose CopyParameters() copies all the
+   * parameters of this model. The tracker integrates concurrently only with
+   * models for which it is their GetClassName(), so each inherited class
+   * should reimplement it to return its own name, after reimplementing
+   * CopyParameters() if it has parameters of its own.
+   */
+  virtual const char* GetCopyParametersClassName()
+  {
+    return "vtkLagrangianBasicIntegrationModel";
+  }
+
+  /**
+   * Add the flow and surface datasets of another model, sharing their
+   * already built locators.
+   */
+  virtual void AddDataSets(vtkLagrangianBasicIntegrationModel* from);
+
+  /**
+   * Forget the dataset in which the last point was found, so that the next
+   * point is looked for in the datasets in the order they were added.
+   */
+  void ClearLastDataSet();
+
   //@{
   /**
    * Set/Get the Use of initial integration input array to process
@@ -519,6 +559,8 @@ protected:
   vtkLocatorsType* SurfaceLocators;
 
   vtkDataArray* TmpArray;
+  vtkNew<vtkIdList> TmpIdList;
+  std::vector<double> TmpTuple;
 
   double Tolerance;
   bool NonPlanarQuadSupport;
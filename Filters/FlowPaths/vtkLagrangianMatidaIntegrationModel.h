@@ -57,6 +57,15 @@ public:
   int FunctionValues(vtkDataSet* dataSet, vtkIdType cellId,
     double* weights, double* x, double* f) override;
 
+  /**
+   * This model has no parameters of its own, CopyParameters() copies them
+   * all.
+   */
+  const char* GetCopyParametersClassName() override
+  {
+    return "vtkLagrangianMatidaIntegrationModel";
+  }
+
 protected:
   vtkLagrangianMatidaIntegrationModel();
   ~vtkLagrangianMatidaIntegrationModel() override;
@@ -189,6 +189,12 @@ vtkDataSet* vtkLagrangianParticle::GetLastSurfaceDataSet()
   return this->LastSurfaceDataSet;
 }
 
+//---------------------------------------------------------------------------
+void vtkLagrangianParticle::SetId(vtkIdType id)
+{
+  this->Id = id;
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkLagrangianParticle::GetId()
 {
@@ -243,6 +249,14 @@ vtkPointData* vtkLagrangianParticle::GetSeedData()
   return this->SeedData;
 }
 
+//---------------------------------------------------------------------------
+void vtkLagrangianParticle::SetSeedData(vtkPointData* seedData,
+  vtkIdType seedArrayTupleIndex)
+{
+  this->SeedData = seedData;
+  this->SeedArrayTupleIndex = seedArrayTupleIndex;
+}
+
 //---------------------------------------------------------------------------
 double& vtkLagrangianParticle::GetStepTimeRef()
 {
@@ -255,10 +255,15 @@ public:
    */
   virtual void MoveToNextPosition();
 
+  //@{
   /**
-   * Get particle id.
+   * Set/Get particle id.
+   * The id is set by the tracker when particles created concurrently
+   * are given their final id.
    */
+  virtual void SetId(vtkIdType id);
   virtual vtkIdType GetId();
+  //@}
 
   //@{
   /**
@@ -297,6 +302,14 @@ public:
    */
   virtual vtkPointData* GetSeedData();
 
+  /**
+   * Set the particle data and the particle data tuple in it.
+   * Used by the tracker to move the data of the particles integrated
+   * concurrently to the data shared by all particles.
+   */
+  virtual void SetSeedData(vtkPointData* seedData,
+    vtkIdType seedArrayTupleIndex);
+
   /**
    * Get the last traversed cell id
    */
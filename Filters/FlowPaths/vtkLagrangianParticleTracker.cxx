@@ -15,6 +15,7 @@
 #include "vtkLagrangianParticleTracker.h"
 
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
@@ -22,6 +23,7 @@
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -37,17 +39,171 @@
 #include "vtkPolyLine.h"
 #include "vtkPolygon.h"
 #include "vtkRungeKutta2.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkVoxel.h"
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkLagrangianParticleTracker);
 vtkCxxSetObjectMacro(vtkLagrangianParticleTracker, IntegrationModel, vtkLagrangianBasicIntegrationModel);
 vtkCxxSetObjectMacro(vtkLagrangianParticleTracker, Integrator, vtkInitialValueProblemSolver);
 
+namespace
+{
+// The integration model and integrator of a thread, see
+// vtkLagrangianParticleTracker::IntegrateInParallel.
+struct vtkLagrangianThreadedIntegration
+{
+  vtkSmartPointer<vtkLagrangianBasicIntegrationModel> IntegrationModel;
+  vtkSmartPointer<vtkInitialValueProblemSolver> Integrator;
+  vtkSmartPointer<vtkGenericCell> Cell;
+
+  // The particles created by the particles integrated by the thread, first
+  // queued by IntegrateParticle then moved to the frontier with the index
+  // of their parent in the wave. Both are reused from wave to wave.
+  std::queue<vtkLagrangianParticle*> NewParticles;
+  std::vector<std::pair<vtkIdType, vtkLagrangianParticle*> > Frontier;
+};
+
+// The outputs of a block of particles integrated by a thread.
+struct vtkLagrangianParticleBlock
+{
+  vtkSmartPointer<vtkPolyData> ParticlePaths;
+  vtkSmartPointer<vtkDataObject> Interactions;
+  vtkSmartPointer<vtkPointData> SeedData;
+};
+
+// Create an empty polydata with the points and the arrays of pd.
+vtkSmartPointer<vtkPolyData> NewPolyDataBlock(vtkPolyData* pd)
+{
+  vtkSmartPointer<vtkPolyData> block = vtkSmartPointer<vtkPolyData>::New();
+  if (pd->GetPoints())
+  {
+    vtkNew<vtkPoints> points;
+    points->SetDataType(pd->GetPoints()->GetDataType());
+    block->SetPoints(points);
+  }
+  if (pd->GetLines())
+  {
+    vtkNew<vtkCellArray> lines;
+    block->SetLines(lines);
+  }
+  block->GetPointData()->CopyStructure(pd->GetPointData());
+  block->GetCellData()->CopyStructure(pd->GetCellData());
+  return block;
+}
+
+// Create an empty interaction output with the structure of
+// interactionOutput.
+vtkSmartPointer<vtkDataObject> NewInteractionBlock(
+  vtkDataObject* interactionOutput)
+{
+  vtkCompositeDataSet* hd = vtkCompositeDataSet::SafeDownCast(interactionOutput);
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(interactionOutput);
+  if (pd)
+  {
+    return NewPolyDataBlock(pd);
+  }
+  vtkSmartPointer<vtkDataObject> block;
+  block.TakeReference(interactionOutput->NewInstance());
+  if (hd)
+  {
+    vtkCompositeDataSet* hdBlock = vtkCompositeDataSet::SafeDownCast(block);
+    hdBlock->CopyStructure(hd);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(hd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      vtkPolyData* pdLeaf = vtkPolyData::SafeDownCast(hd->GetDataSet(iter));
+      if (pdLeaf)
+      {
+        hdBlock->SetDataSet(iter, NewPolyDataBlock(pdLeaf));
+      }
+    }
+  }
+  return block;
+}
+
+// Append the points, the lines and the arrays of block to pd.
+void AppendPolyDataBlock(vtkPolyData* pd, vtkPolyData* block)
+{
+  vtkIdType numPts = pd->GetNumberOfPoints();
+  vtkIdType numBlockPts = block->GetNumberOfPoints();
+  if (numBlockPts > 0)
+  {
+    pd->GetPoints()->InsertPoints(numPts, numBlockPts, 0, block->GetPoints());
+    vtkPointData* pointData = pd->GetPointData();
+    vtkPointData* blockPointData = block->GetPointData();
+    for (int i = 0; i < pointData->GetNumberOfArrays(); i++)
+    {
+      pointData->GetAbstractArray(i)->InsertTuples(
+        numPts, numBlockPts, 0, blockPointData->GetAbstractArray(i));
+    }
+  }
+
+  vtkCellArray* blockLines = block->GetLines();
+  vtkIdType numBlockLines = blockLines ? blockLines->GetNumberOfCells() : 0;
+  if (numBlockLines > 0)
+  {
+    vtkCellArray* lines = pd->GetLines();
+    vtkIdType numLines = lines->GetNumberOfCells();
+    vtkCellData* cellData = pd->GetCellData();
+    vtkCellData* blockCellData = block->GetCellData();
+    for (int i = 0; i < cellData->GetNumberOfArrays(); i++)
+    {
+      cellData->GetAbstractArray(i)->InsertTuples(
+        numLines, numBlockLines, 0, blockCellData->GetAbstractArray(i));
+    }
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (blockLines->InitTraversal(); blockLines->GetNextCell(npts, pts); )
+    {
+      lines->InsertNextCell(npts);
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        lines->InsertCellPoint(pts[i] + numPts);
+      }
+    }
+  }
+}
+
+// Append the interactions of block to interactionOutput.
+void AppendInteractionBlock(vtkDataObject* interactionOutput,
+  vtkDataObject* block)
+{
+  vtkCompositeDataSet* hd = vtkCompositeDataSet::SafeDownCast(interactionOutput);
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(interactionOutput);
+  if (hd)
+  {
+    vtkCompositeDataSet* hdBlock = vtkCompositeDataSet::SafeDownCast(block);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(hd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      vtkPolyData* pdLeaf = vtkPolyData::SafeDownCast(hd->GetDataSet(iter));
+      vtkPolyData* pdBlock = vtkPolyData::SafeDownCast(hdBlock->GetDataSet(iter));
+      if (pdLeaf && pdBlock)
+      {
+        AppendPolyDataBlock(pdLeaf, pdBlock);
+      }
+    }
+  }
+  else if (pd)
+  {
+    AppendPolyDataBlock(pd, vtkPolyData::SafeDownCast(block));
+  }
+}
+}
+
+
 //---------------------------------------------------------------------------
 vtkLagrangianParticleTracker::vtkLagrangianParticleTracker()
 {
@@ -72,7 +228,9 @@ vtkLagrangianParticleTracker::vtkLagrangianParticleTracker()
   this->ParticlePathsRenderingPointsThreshold = 100;
 
   this->CreateOutOfDomainParticle = false;
+  this->ParallelExecution = false;
   this->ParticleCounter = 0;
+  this->ParticleCounterMutex = new vtkSimpleCriticalSection;
 
   this->FlowCache = nullptr;
   this->FlowTime = 0;
@@ -85,6 +243,7 @@ vtkLagrangianParticleTracker::~vtkLagrangianParticleTracker()
 {
   this->SetIntegrator(nullptr);
   this->SetIntegrationModel(nullptr);
+  delete this->ParticleCounterMutex;
 }
 
 //---------------------------------------------------------------------------
@@ -122,6 +281,7 @@ void vtkLagrangianParticleTracker::PrintSelf(ostream& os, vtkIndent indent)
     << this->ParticlePathsRenderingPointsThreshold << endl;
   os << indent << "MinimumVelocityMagnitude: " << this->MinimumVelocityMagnitude << endl;
   os << indent << "MinimumReductionFactor: " << this->MinimumReductionFactor << endl;
+  os << indent << "ParallelExecution: " << this->ParallelExecution << endl;
   os << indent << "ParticleCounter: " << this->ParticleCounter << endl;
 }
 
@@ -270,8 +430,12 @@ int vtkLagrangianParticleTracker::RequestData(
   // before integration.
   this->IntegrationModel->PreIntegrate(particlesQueue);
 
+  // Integrate the particles concurrently if requested and possible
+  bool integrated = this->ParallelExecution &&
+    this->IntegrateInParallel(particlesQueue, particlePathsOutput, interactionOutput);
+
   // Integrate each particle
-  while (!this->GetAbortExecute())
+  while (!integrated && !this->GetAbortExecute())
   {
     // Check for particle feed
     this->GetParticleFeed(particlesQueue);
@@ -290,22 +454,8 @@ int vtkLagrangianParticleTracker::RequestData(
     // Integrate
     this->Integrate(particle, particlesQueue, particlePathsOutput,
       particlePath->GetPointIds(), interactionOutput);
-
-    if (particlePath->GetPointIds()->GetNumberOfIds() == 1)
-    {
-      particlePath->GetPointIds()->InsertNextId(particlePath->GetPointId(0));
-    }
-
-    // Duplicate single point particle paths, to avoid degenerated lines.
-    if (particlePath->GetPointIds()->GetNumberOfIds() > 0)
-    {
-      // Add particle path or vertex to cell array
-      particlePathsOutput->GetLines()->InsertNextCell(particlePath);
-      this->InsertPathData(particle, particlePathsOutput->GetCellData());
-
-      // Insert data from seed data only on not yet written arrays
-      this->InsertSeedData(particle, particlePathsOutput->GetCellData());
-    }
+    this->InsertPathOutputCell(particle, particlePathsOutput,
+      particlePath->GetPointIds());
 
     // Delete integrated particle
     delete particle;
@@ -350,8 +500,10 @@ vtkMTimeType vtkLagrangianParticleTracker::GetMTime()
 //---------------------------------------------------------------------------
 vtkIdType vtkLagrangianParticleTracker::GetNewParticleId()
 {
+  this->ParticleCounterMutex->Lock();
   vtkIdType id = this->ParticleCounter;
   this->ParticleCounter++;
+  this->ParticleCounterMutex->Unlock();
   return id;
 }
 
@@ -974,6 +1126,21 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   std::queue<vtkLagrangianParticle*>& particlesQueue,
   vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
   vtkDataObject* interactionOutput)
+{
+  vtkNew<vtkGenericCell> cell;
+  return this->IntegrateParticle(particle, particlesQueue,
+    this->IntegrationModel, this->Integrator, cell, particlePathsOutput,
+    particlePathPointId, interactionOutput, false);
+}
+
+//---------------------------------------------------------------------------
+int vtkLagrangianParticleTracker::IntegrateParticle(
+  vtkLagrangianParticle* particle,
+  std::queue<vtkLagrangianParticle*>& particlesQueue,
+  vtkLagrangianBasicIntegrationModel* integrationModel,
+  vtkInitialValueProblemSolver* integrator, vtkGenericCell* cell,
+  vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
+  vtkDataObject* interactionOutput, bool threaded)
 {
   // Sanity check
   if (particle == nullptr)
@@ -983,7 +1150,13 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   }
 
   // Set the current particle
-  this->IntegrationModel->SetCurrentParticle(particle);
+  integrationModel->SetCurrentParticle(particle);
+  if (threaded)
+  {
+    // Do not depend on the dataset where the previous particle of this
+    // thread was
+    integrationModel->ClearLastDataSet();
+  }
 
   // Integrate until MaximumNumberOfSteps is reached or special case stops integration
   int integrationRes = 0;
@@ -993,7 +1166,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   while (particle->GetNumberOfSteps() < this->MaximumNumberOfSteps)
   {
     // Update progress
-    if (particle->GetNumberOfSteps() % 100 == 0 && this->ParticleCounter > 0)
+    if (!threaded && particle->GetNumberOfSteps() % 100 == 0 &&
+      this->ParticleCounter > 0)
     {
       double progress = static_cast<double>(particle->GetId() +
         static_cast<double>(particle->GetNumberOfSteps()) / this->MaximumNumberOfSteps) /
@@ -1009,7 +1183,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     double velocityMagnitude = reintegrationFactor * std::max(
       this->MinimumVelocityMagnitude,
       vtkMath::Norm(particle->GetVelocity()));
-    double cellLength = this->ComputeCellLength(particle);
+    double cellLength = this->ComputeCellLength(particle, integrationModel, cell);
 
     double stepLength    = stepFactor          * cellLength;
     double stepLengthMin = this->StepFactorMin * cellLength;
@@ -1019,7 +1193,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     double stepTimeMax = stepLengthMax / velocityMagnitude;
 
     // Integrate one step
-    if (!this->ComputeNextStep(particle->GetEquationVariables(),
+    if (!this->ComputeNextStep(integrationModel, integrator,
+      particle->GetEquationVariables(),
       particle->GetNextEquationVariables(), particle->GetIntegrationTime(),
       stepTime, stepTimeActual, stepTimeMin, stepTimeMax, integrationRes))
     {
@@ -1041,7 +1216,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
 
     // Simpler Adaptive Step Reintegration code
     if (this->AdaptiveStepReintegration &&
-        this->IntegrationModel->CheckAdaptiveStepReintegration(particle))
+        integrationModel->CheckAdaptiveStepReintegration(particle))
     {
       double stepLengthCurr2 = vtkMath::Distance2BetweenPoints(
         particle->GetPosition(), particle->GetNextPosition());
@@ -1068,11 +1243,11 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
       vtkLagrangianBasicIntegrationModel::PassThroughParticlesType passThroughParticles;
       unsigned int interactedSurfaceFlaxIndex;
       vtkLagrangianParticle* interactionParticle =
-        this->IntegrationModel->ComputeSurfaceInteraction(
+        integrationModel->ComputeSurfaceInteraction(
         particle, particlesQueue, interactedSurfaceFlaxIndex, passThroughParticles);
       if (interactionParticle != nullptr)
       {
-        this->InsertInteractionOutputPoint(interactionParticle,
+        this->InsertInteractionOutputPoint(integrationModel, interactionParticle,
           interactedSurfaceFlaxIndex, interactionOutput);
         delete interactionParticle;
         interactionParticle = nullptr;
@@ -1088,7 +1263,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
         vtkLagrangianBasicIntegrationModel::PassThroughParticlesItem item =
           passThroughParticles.front();
         passThroughParticles.pop();
-        this->InsertInteractionOutputPoint(item.second, item.first, interactionOutput);
+        this->InsertInteractionOutputPoint(integrationModel, item.second,
+          item.first, interactionOutput);
 
         // the pass through particles needs to be deleted
         delete item.second;
@@ -1096,7 +1272,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
 
       // Particle has been correctly integrated and interacted, record it
       // Insert Current particle as an output point
-      this->InsertPathOutputPoint(particle, particlePathsOutput, particlePathPointId);
+      this->InsertPathOutputPoint(integrationModel, particle,
+        particlePathsOutput, particlePathPointId);
 
       // Particle has been terminated by surface
       if (particle->GetTermination() !=
@@ -1104,14 +1281,15 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
       {
         // Insert last particle path point on surface
         particle->MoveToNextPosition();
-        this->InsertPathOutputPoint(particle, particlePathsOutput, particlePathPointId);
+        this->InsertPathOutputPoint(integrationModel, particle,
+          particlePathsOutput, particlePathPointId);
 
         // stop integration
         break;
       }
     }
 
-    if (this->IntegrationModel->CheckFreeFlightTermination(particle))
+    if (integrationModel->CheckFreeFlightTermination(particle))
     {
       particle->SetTermination(
         vtkLagrangianParticle::PARTICLE_TERMINATION_FLIGHT_TERMINATED);
@@ -1122,7 +1300,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     particle->MoveToNextPosition();
 
     // Compute now adaptive step
-    if (this->Integrator->IsAdaptive() || this->AdaptiveStepReintegration)
+    if (integrator->IsAdaptive() || this->AdaptiveStepReintegration)
     {
       stepFactor = stepTime * velocityMagnitude / cellLength;
     }
@@ -1134,12 +1312,225 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     particle->SetTermination(
       vtkLagrangianParticle::PARTICLE_TERMINATION_OUT_OF_STEPS);
   }
-  this->IntegrationModel->SetCurrentParticle(nullptr);
+  integrationModel->SetCurrentParticle(nullptr);
   return integrationRes;
 }
 
+//---------------------------------------------------------------------------
+bool vtkLagrangianParticleTracker::IntegrateInParallel(
+  std::queue<vtkLagrangianParticle*>& particlesQueue,
+  vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput)
+{
+  vtkLagrangianBasicIntegrationModel* integrationModel = this->IntegrationModel;
+  vtkInitialValueProblemSolver* integrator = this->Integrator;
+  if (!integrator)
+  {
+    return false;
+  }
+
+  // The copies of the model made for the threads would lose the parameters
+  // that CopyParameters does not know about
+  if (strcmp(integrationModel->GetCopyParametersClassName(),
+        integrationModel->GetClassName()) != 0)
+  {
+    vtkWarningMacro(<< integrationModel->GetClassName()
+                    << " does not reimplement GetCopyParametersClassName, "
+                    << "the particles are integrated serially.");
+    return false;
+  }
+
+  vtkSMPThreadLocal<vtkLagrangianThreadedIntegration> localIntegrations;
+  std::vector<vtkLagrangianParticle*> particles;
+  std::vector<vtkPointData*> seedData;
+  std::vector<vtkIdType> seedArrayTupleIndices;
+  std::vector<std::pair<vtkIdType, vtkLagrangianParticle*> > frontier;
+  vtkIdType numberOfIntegratedParticles = 0;
+  while (!this->GetAbortExecute())
+  {
+    // Check for particle feed
+    this->GetParticleFeed(particlesQueue);
+    if (particlesQueue.empty())
+    {
+      break;
+    }
+
+    // The particles of the queue make the next wave
+    particles.clear();
+    while (!particlesQueue.empty())
+    {
+      particles.push_back(particlesQueue.front());
+      particlesQueue.pop();
+    }
+    const vtkIdType numParticles = static_cast<vtkIdType>(particles.size());
+    const vtkIdType numBlocks = std::min<vtkIdType>(
+      numParticles, 16 * vtkSMPTools::GetEstimatedNumberOfThreads());
+
+    // Prepare the outputs of each block of particles, and move the seed data
+    // of the particles to their block, as the particles created during the
+    // integration add their seed data to the one of their parent.
+    std::vector<vtkLagrangianParticleBlock> blocks(numBlocks);
+    seedData.resize(numParticles);
+    seedArrayTupleIndices.resize(numParticles);
+    for (vtkIdType block = 0; block < numBlocks; block++)
+    {
+      vtkLagrangianParticleBlock& particleBlock = blocks[block];
+      particleBlock.ParticlePaths = NewPolyDataBlock(particlePathsOutput);
+      particleBlock.Interactions = NewInteractionBlock(interactionOutput);
+      particleBlock.SeedData = vtkSmartPointer<vtkPointData>::New();
+      vtkIdType first = block * numParticles / numBlocks;
+      vtkIdType last = (block + 1) * numParticles / numBlocks;
+      particleBlock.SeedData->CopyStructure(particles[first]->GetSeedData());
+      for (vtkIdType i = first; i < last; i++)
+      {
+        vtkLagrangianParticle* particle = particles[i];
+        seedData[i] = particle->GetSeedData();
+        seedArrayTupleIndices[i] = particle->GetSeedArrayTupleIndex();
+        for (int j = 0; j < seedData[i]->GetNumberOfArrays(); j++)
+        {
+          particleBlock.SeedData->GetAbstractArray(j)->InsertTuple(i - first,
+            seedArrayTupleIndices[i], seedData[i]->GetAbstractArray(j));
+        }
+        particle->SetSeedData(particleBlock.SeedData, i - first);
+      }
+    }
+
+    // Integrate the blocks, with one integration model and one integrator
+    // per thread. The particles created by each particle are added to the
+    // frontier of the thread with the index of their parent.
+    const vtkIdType particleCounter = this->ParticleCounter;
+    vtkSMPTools::For(0, numBlocks, 1, [&](vtkIdType begin, vtkIdType end)
+    {
+      vtkLagrangianThreadedIntegration& local = localIntegrations.Local();
+      if (!local.IntegrationModel)
+      {
+        local.IntegrationModel.TakeReference(integrationModel->NewInstance());
+        local.IntegrationModel->CopyParameters(integrationModel);
+        local.IntegrationModel->AddDataSets(integrationModel);
+        local.IntegrationModel->SetTracker(this);
+        local.Integrator.TakeReference(integrator->NewInstance());
+        local.Integrator->SetFunctionSet(local.IntegrationModel);
+        local.Cell = vtkSmartPointer<vtkGenericCell>::New();
+      }
+      vtkNew<vtkIdList> particlePathPointId;
+      for (vtkIdType block = begin; block < end; block++)
+      {
+        vtkLagrangianParticleBlock& particleBlock = blocks[block];
+        vtkIdType first = block * numParticles / numBlocks;
+        vtkIdType last = (block + 1) * numParticles / numBlocks;
+        for (vtkIdType i = first; i < last; i++)
+        {
+          particlePathPointId->Reset();
+          this->IntegrateParticle(particles[i], local.NewParticles,
+            local.IntegrationModel, local.Integrator, local.Cell,
+            particleBlock.ParticlePaths, particlePathPointId,
+            particleBlock.Interactions, true);
+          this->InsertPathOutputCell(particles[i],
+            particleBlock.ParticlePaths, particlePathPointId);
+          while (!local.NewParticles.empty())
+          {
+            local.Frontier.push_back(
+              std::make_pair(i, local.NewParticles.front()));
+            local.NewParticles.pop();
+          }
+        }
+      }
+    });
+
+    // Merge the outputs of the blocks in particle order
+    for (vtkIdType block = 0; block < numBlocks; block++)
+    {
+      AppendPolyDataBlock(particlePathsOutput, blocks[block].ParticlePaths);
+      AppendInteractionBlock(interactionOutput, blocks[block].Interactions);
+    }
+
+    // Gather the frontiers of the threads. A particle is integrated by a
+    // single thread, so the stable sort by parent gives the order of the
+    // serial integration.
+    frontier.clear();
+    vtkSMPThreadLocal<vtkLagrangianThreadedIntegration>::iterator localIter;
+    for (localIter = localIntegrations.begin();
+      localIter != localIntegrations.end(); ++localIter)
+    {
+      frontier.insert(frontier.end(), localIter->Frontier.begin(),
+        localIter->Frontier.end());
+      localIter->Frontier.clear();
+    }
+    std::stable_sort(frontier.begin(), frontier.end(),
+      [](const std::pair<vtkIdType, vtkLagrangianParticle*>& a,
+        const std::pair<vtkIdType, vtkLagrangianParticle*>& b)
+      {
+        return a.first < b.first;
+      });
+
+    // Queue the new particles in that order, with the ids and the seed data
+    // they would have had.
+    this->ParticleCounter = particleCounter;
+    for (size_t k = 0; k < frontier.size(); k++)
+    {
+      vtkIdType i = frontier[k].first;
+      vtkLagrangianParticle* particle = frontier[k].second;
+      vtkIdType seedArrayTupleIndex = seedArrayTupleIndices[i];
+      if (seedData[i]->GetNumberOfArrays() > 0)
+      {
+        vtkPointData* blockSeedData = particle->GetSeedData();
+        seedArrayTupleIndex = seedData[i]->GetArray(0)->GetNumberOfTuples();
+        for (int j = 0; j < seedData[i]->GetNumberOfArrays(); j++)
+        {
+          seedData[i]->GetAbstractArray(j)->InsertTuple(seedArrayTupleIndex,
+            particle->GetSeedArrayTupleIndex(),
+            blockSeedData->GetAbstractArray(j));
+        }
+      }
+      particle->SetSeedData(seedData[i], seedArrayTupleIndex);
+      particle->SetId(this->GetNewParticleId());
+      particlesQueue.push(particle);
+    }
+    for (vtkIdType i = 0; i < numParticles; i++)
+    {
+      delete particles[i];
+    }
+
+    numberOfIntegratedParticles += numParticles;
+    this->UpdateProgress(static_cast<double>(numberOfIntegratedParticles) /
+      (numberOfIntegratedParticles + particlesQueue.size()));
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertPathOutputCell(
+  vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
+  vtkIdList* particlePathPointId)
+{
+  // Duplicate single point particle paths, to avoid degenerated lines.
+  if (particlePathPointId->GetNumberOfIds() == 1)
+  {
+    particlePathPointId->InsertNextId(particlePathPointId->GetId(0));
+  }
+
+  if (particlePathPointId->GetNumberOfIds() > 0)
+  {
+    // Add particle path or vertex to cell array
+    particlePathsOutput->GetLines()->InsertNextCell(particlePathPointId);
+    this->InsertPathData(particle, particlePathsOutput->GetCellData());
+
+    // Insert data from seed data only on not yet written arrays
+    this->InsertSeedData(particle, particlePathsOutput->GetCellData());
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertPathOutputPoint(
+  vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
+  vtkIdList* particlePathPointId, bool prev)
+{
+  this->InsertPathOutputPoint(this->IntegrationModel, particle,
+    particlePathsOutput, particlePathPointId, prev);
+}
+
 //---------------------------------------------------------------------------
 void vtkLagrangianParticleTracker::InsertPathOutputPoint(
+  vtkLagrangianBasicIntegrationModel* integrationModel,
   vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
   vtkIdList* particlePathPointId, bool prev)
 {
@@ -1159,7 +1550,7 @@ void vtkLagrangianParticleTracker::InsertPathOutputPoint(
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_CURRENT);
 
   // Add Variables data
-  this->IntegrationModel->InsertVariablesParticleData(particle,
+  integrationModel->InsertVariablesParticleData(particle,
     particlePathsPointData, prev ?
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_PREV :
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_CURRENT);
@@ -1169,6 +1560,16 @@ void vtkLagrangianParticleTracker::InsertPathOutputPoint(
 void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
   vtkLagrangianParticle* particle, unsigned int interactedSurfaceFlatIndex,
   vtkDataObject* interactionOutput)
+{
+  this->InsertInteractionOutputPoint(this->IntegrationModel, particle,
+    interactedSurfaceFlatIndex, interactionOutput);
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
+  vtkLagrangianBasicIntegrationModel* integrationModel,
+  vtkLagrangianParticle* particle, unsigned int interactedSurfaceFlatIndex,
+  vtkDataObject* interactionOutput)
 {
   // Find the correct output
   vtkCompositeDataSet *hdOutput = vtkCompositeDataSet::SafeDownCast(interactionOutput);
@@ -1211,7 +1612,7 @@ void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_NEXT);
 
   // Add Variables data
-  this->IntegrationModel->InsertVariablesParticleData(particle, pointData,
+  integrationModel->InsertVariablesParticleData(particle, pointData,
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_NEXT);
 
   // Finally, Insert data from seed data only on not yet written arrays
@@ -1301,6 +1702,16 @@ void vtkLagrangianParticleTracker::InsertParticleData(vtkLagrangianParticle* par
 //---------------------------------------------------------------------------
 double vtkLagrangianParticleTracker::ComputeCellLength(
   vtkLagrangianParticle* particle)
+{
+  vtkNew<vtkGenericCell> cell;
+  return this->ComputeCellLength(particle, this->IntegrationModel, cell);
+}
+
+//---------------------------------------------------------------------------
+double vtkLagrangianParticleTracker::ComputeCellLength(
+  vtkLagrangianParticle* particle,
+  vtkLagrangianBasicIntegrationModel* integrationModel,
+  vtkGenericCell* genericCell)
 {
   double cellLength = 1.0;
   vtkDataSet* dataset = nullptr;
@@ -1311,9 +1722,10 @@ double vtkLagrangianParticleTracker::ComputeCellLength(
     this->CellLengthComputationMode == STEP_CUR_CELL_DIV_THEO)
   {
     vtkIdType cellId;
-    if (this->IntegrationModel->FindInLocators(particle->GetPosition(), dataset, cellId))
+    if (integrationModel->FindInLocators(particle->GetPosition(), dataset, cellId))
     {
-      cell = dataset->GetCell(cellId);
+      dataset->GetCell(cellId, genericCell);
+      cell = genericCell;
     }
     else
     {
@@ -1330,11 +1742,12 @@ double vtkLagrangianParticleTracker::ComputeCellLength(
     {
       return cellLength;
     }
-    cell = dataset->GetCell(particle->GetLastCellId());
-    if (!cell)
+    dataset->GetCell(particle->GetLastCellId(), genericCell);
+    if (genericCell->GetCellType() == VTK_EMPTY_CELL)
     {
       return cellLength;
     }
+    cell = genericCell;
   }
   if (cell == nullptr)
   {
@@ -1367,7 +1780,7 @@ double vtkLagrangianParticleTracker::ComputeCellLength(
   }
   else if ((this->CellLengthComputationMode == STEP_CUR_CELL_DIV_THEO ||
     this->CellLengthComputationMode == STEP_LAST_CELL_DIV_THEO) &&
-      vtkMath::Norm(vel) > 0.0 && !vtkVoxel::SafeDownCast(cell))
+      vtkMath::Norm(vel) > 0.0 && cell->GetCellType() != VTK_VOXEL)
   {
     double velHat[3] = {vel[0], vel[1], vel[2]};
     vtkMath::Normalize(velHat);
@@ -1410,16 +1823,29 @@ bool vtkLagrangianParticleTracker::ComputeNextStep(
   double t, double& delT, double& delTActual,
   double minStep, double maxStep,
   int& integrationRes)
+{
+  return this->ComputeNextStep(this->IntegrationModel, this->Integrator,
+    xprev, xnext, t, delT, delTActual, minStep, maxStep, integrationRes);
+}
+
+//---------------------------------------------------------------------------
+bool vtkLagrangianParticleTracker::ComputeNextStep(
+  vtkLagrangianBasicIntegrationModel* integrationModel,
+  vtkInitialValueProblemSolver* integrator,
+  double* xprev, double* xnext,
+  double t, double& delT, double& delTActual,
+  double minStep, double maxStep,
+  int& integrationRes)
 {
   // Check for potential manual integration
   double error;
-  if (!this->IntegrationModel->ManualIntegration(xprev, xnext, t, delT, delTActual,
-    minStep, maxStep, this->IntegrationModel->GetTolerance(), error, integrationRes))
+  if (!integrationModel->ManualIntegration(xprev, xnext, t, delT, delTActual,
+    minStep, maxStep, integrationModel->GetTolerance(), error, integrationRes))
   {
     // integrate one step
     integrationRes =
-      this->Integrator->ComputeNextStep(xprev, xnext, t, delT, delTActual,
-        minStep, maxStep, this->IntegrationModel->GetTolerance(), error);
+      integrator->ComputeNextStep(xprev, xnext, t, delT, delTActual,
+        minStep, maxStep, integrationModel->GetTolerance(), error);
   }
 
   // Check failure cases
@@ -97,6 +97,7 @@ class vtkBoundingBox;
 class vtkCellArray;
 class vtkDataSet;
 class vtkDoubleArray;
+class vtkGenericCell;
 class vtkIdList;
 class vtkInformation;
 class vtkInitialValueProblemSolver;
@@ -105,6 +106,7 @@ class vtkLagrangianParticle;
 class vtkPointData;
 class vtkPoints;
 class vtkPolyData;
+class vtkSimpleCriticalSection;
 
 class VTKFILTERSFLOWPATHS_EXPORT vtkLagrangianParticleTracker :
   public vtkDataObjectAlgorithm
@@ -248,6 +250,28 @@ public:
   vtkBooleanMacro(CreateOutOfDomainParticle, bool);
   //@}
 
+  //@{
+  /**
+   * When on, the particles are integrated concurrently with vtkSMPTools.
+   * Each thread uses its own copy of the integration model and of the
+   * integrator, the locators being shared, so the locator must support
+   * concurrent queries. The particles are integrated by waves: the seeds
+   * first, then the particles created by the surface interactions of the
+   * previous wave. Each wave is split into blocks whose paths and
+   * interactions are merged in particle order, and the new particles are
+   * given their ids in that order, so the output does not depend on the
+   * number of threads and equals the serial output when the flow has a
+   * single dataset. The integration model methods called during the
+   * integration must be thread safe, and Integrate() is not called. The
+   * integration model must copy all its parameters with CopyParameters(),
+   * see vtkLagrangianBasicIntegrationModel::GetCopyParametersClassName(),
+   * else the particles are integrated serially. Off by default.
+   */
+  vtkSetMacro(ParallelExecution, bool);
+  vtkGetMacro(ParallelExecution, bool);
+  vtkBooleanMacro(ParallelExecution, bool);
+  //@}
+
   //@{
   /**
    * Specify the source object used to generate particle initial position (seeds).
@@ -311,7 +335,7 @@ public:
   vtkMTimeType GetMTime() override;
 
   /**
-   * Get an unique id for a particle
+   * Get an unique id for a particle. Thread safe.
    */
   virtual vtkIdType GetNewParticleId();
 
@@ -357,12 +381,50 @@ protected:
     vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
     vtkDataObject* interactionOutput);
 
+  /**
+   * Integrate a particle with the given integration model, integrator and
+   * cell, as Integrate() does with the ones of the tracker. When threaded
+   * is true, the progress is not updated and the search of the particle
+   * starts from the first dataset of the model.
+   */
+  int IntegrateParticle(vtkLagrangianParticle* particle,
+    std::queue<vtkLagrangianParticle*>& particlesQueue,
+    vtkLagrangianBasicIntegrationModel* integrationModel,
+    vtkInitialValueProblemSolver* integrator, vtkGenericCell* cell,
+    vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
+    vtkDataObject* interactionOutput, bool threaded);
+
+  /**
+   * Integrate the particles of the queue, and the particles they create,
+   * in parallel, see ParallelExecution. Return false without integrating
+   * any particle when they cannot be integrated concurrently, RequestData()
+   * then integrates them serially.
+   */
+  virtual bool IntegrateInParallel(
+    std::queue<vtkLagrangianParticle*>& particlesQueue,
+    vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput);
+
+  /**
+   * Insert the path of an integrated particle as a line cell, with its
+   * path data and its seed data.
+   */
+  void InsertPathOutputCell(vtkLagrangianParticle* particle,
+    vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId);
+
   void InsertPathOutputPoint(vtkLagrangianParticle* particle,
     vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
     bool prev = false);
+  void InsertPathOutputPoint(
+    vtkLagrangianBasicIntegrationModel* integrationModel,
+    vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
+    vtkIdList* particlePathPointId, bool prev = false);
 
   void InsertInteractionOutputPoint(vtkLagrangianParticle* particle,
     unsigned int interactedSurfaceFlatIndex, vtkDataObject* interactionOutput);
+  void InsertInteractionOutputPoint(
+    vtkLagrangianBasicIntegrationModel* integrationModel,
+    vtkLagrangianParticle* particle, unsigned int interactedSurfaceFlatIndex,
+    vtkDataObject* interactionOutput);
 
   void InsertSeedData(vtkLagrangianParticle* particle, vtkFieldData* data);
   void InsertPathData(vtkLagrangianParticle* particle, vtkFieldData* data);
@@ -370,12 +432,21 @@ protected:
   void InsertParticleData(vtkLagrangianParticle* particle, vtkFieldData* data, int stepEnum);
 
   double ComputeCellLength(vtkLagrangianParticle* particle);
+  double ComputeCellLength(vtkLagrangianParticle* particle,
+    vtkLagrangianBasicIntegrationModel* integrationModel,
+    vtkGenericCell* genericCell);
 
   bool ComputeNextStep(
     double* xprev, double* xnext,
     double t, double& delT, double& delTActual,
     double minStep, double maxStep,
     int& integrationRes);
+  bool ComputeNextStep(vtkLagrangianBasicIntegrationModel* integrationModel,
+    vtkInitialValueProblemSolver* integrator,
+    double* xprev, double* xnext,
+    double t, double& delT, double& delTActual,
+    double minStep, double maxStep,
+    int& integrationRes);
 
   virtual bool CheckParticlePathsRenderingThreshold(vtkPolyData* particlePathsOutput);
 
@@ -392,7 +463,9 @@ protected:
   bool GeneratePolyVertexInteractionOutput;
   int ParticlePathsRenderingPointsThreshold;
   bool CreateOutOfDomainParticle;
+  bool ParallelExecution;
   vtkIdType ParticleCounter;
+  vtkSimpleCriticalSection* ParticleCounterMutex;
 
   // internal parameters use for step computation
   double MinimumVelocityMagnitude;
@@ -20,6 +20,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCompositeInterpolatedVelocityField.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
@@ -45,8 +46,11 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer)
@@ -128,6 +132,7 @@ vtkStreamTracer::vtkStreamTracer()
   this->HasMatchingPointAttributes = true;
 
   this->SurfaceStreamlines = false;
+  this->ParallelExecution = false;
 }
 
 vtkStreamTracer::~vtkStreamTracer()
@@ -514,12 +519,23 @@ int vtkStreamTracer::RequestData(
       double propagation = 0;
       vtkIdType numSteps = 0;
       double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecType,vecName,
-                      propagation, numSteps, integrationTime);
+      if (this->ParallelExecution &&
+          vtkCompositeInterpolatedVelocityField::SafeDownCast(func))
+      {
+        this->IntegrateInParallel(input0->GetPointData(), output,
+                                  seeds, seedIds,
+                                  integrationDirections, func,
+                                  maxCellSize, vecType, vecName);
+      }
+      else
+      {
+        this->Integrate(input0->GetPointData(), output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecType,vecName,
+                        propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -666,6 +682,29 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
                                 double& inPropagation,
                                 vtkIdType& inNumSteps,
                                 double &inIntegrationTime)
+{
+  this->IntegrateLines(input0Data, output, seedSource, seedIds,
+                       integrationDirections, lastPoint, func, maxCellSize,
+                       vecType, vecName, inPropagation, inNumSteps,
+                       inIntegrationTime, 0, seedIds->GetNumberOfIds(), false);
+}
+
+void vtkStreamTracer::IntegrateLines(vtkPointData *input0Data,
+                                     vtkPolyData* output,
+                                     vtkDataArray* seedSource,
+                                     vtkIdList* seedIds,
+                                     vtkIntArray* integrationDirections,
+                                     double lastPoint[3],
+                                     vtkAbstractInterpolatedVelocityField* func,
+                                     int maxCellSize,
+                                     int vecType,
+                                     const char *vecName,
+                                     double& inPropagation,
+                                     vtkIdType& inNumSteps,
+                                     double &inIntegrationTime,
+                                     vtkIdType firstLine,
+                                     vtkIdType endLine,
+                                     bool threaded)
 {
   vtkIdType numLines = seedIds->GetNumberOfIds();
   double propagation = inPropagation;
@@ -790,11 +829,14 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
   int shouldAbort = 0;
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+  for(vtkIdType currentLine = firstLine; currentLine < endLine; currentLine++)
   {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!threaded)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -813,6 +855,12 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     // Clear the last cell to avoid starting a search from
     // the last point in the streamline
     func->ClearLastCellId();
+    if (threaded)
+    {
+      // Do not depend on the dataset where the previous line of this thread
+      // ended.
+      func->SetLastCellId(-1, 0);
+    }
 
     // Initial point
     seedSource->GetTuple(seedIds->GetId(currentLine), point1);
@@ -938,7 +986,7 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         break;
       }
 
-      if ( numSteps++ % 1000 == 1 )
+      if ( numSteps++ % 1000 == 1 && !threaded )
       {
         progress =
           ( currentLine + propagation / this->MaximumPropagation ) / numLines;
@@ -975,7 +1023,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!threaded)
+      {
+        this->LastUsedStepSize = stepSize.Interval;
+      }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1175,11 +1226,11 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     }
 
     vtkIdType numPts = outputPoints->GetNumberOfPoints();
-    if ( numPts > 1 )
+    if ( numPts > 1 || threaded )
     {
       // Assign geometry and attributes
       output->SetLines(outputLines);
-      if (this->GenerateNormalsInIntegrate)
+      if (this->GenerateNormalsInIntegrate && !threaded)
       {
         this->GenerateNormals(output, nullptr, vecName);
       }
@@ -1217,6 +1268,167 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   output->Squeeze();
 }
 
+void vtkStreamTracer::IntegrateInParallel(vtkPointData *input0Data,
+                                          vtkPolyData* output,
+                                          vtkDataArray* seedSource,
+                                          vtkIdList* seedIds,
+                                          vtkIntArray* integrationDirections,
+                                          vtkAbstractInterpolatedVelocityField* func,
+                                          int maxCellSize,
+                                          int vecType,
+                                          const char *vecName)
+{
+  vtkCompositeInterpolatedVelocityField* compositeFunc =
+    vtkCompositeInterpolatedVelocityField::SafeDownCast(func);
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+  if (this->GetIntegrator() == nullptr || !compositeFunc || numLines == 0)
+  {
+    // The serial path reports the errors and handles the empty output.
+    double lastPoint[3];
+    double propagation = 0;
+    vtkIdType numSteps = 0;
+    double integrationTime = 0;
+    this->Integrate(input0Data, output, seedSource, seedIds,
+                    integrationDirections, lastPoint, func, maxCellSize,
+                    vecType, vecName, propagation, numSteps, integrationTime);
+    return;
+  }
+
+  // Check the surface option once, before the threads read it.
+  if (this->SurfaceStreamlines &&
+      !vtkInterpolatedVelocityField::SafeDownCast(func))
+  {
+    vtkWarningMacro(<< "Surface Streamlines works only with Point Locator "
+                       "Interpolated Velocity Field, setting it off");
+    this->SetSurfaceStreamlines(false);
+  }
+
+  // The point locators and cell links of the datasets, as well as the cell
+  // locators, are built on demand. Build them here, by evaluating the field
+  // once in each dataset, since the threads then share them.
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  int dataIndex = 0;
+  double velocity[3];
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet* inp = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (inp)
+    {
+      if (inp->GetNumberOfPoints() > 0)
+      {
+        double x[3];
+        inp->GetPoint(0, x);
+        func->SetLastCellId(-1, dataIndex);
+        func->FunctionValues(x, velocity);
+      }
+      dataIndex++;
+    }
+  }
+  func->ClearLastCellId();
+
+  // Integrate blocks of consecutive lines, with one interpolator and one
+  // integrator per thread. The lines of a block do not depend on those of
+  // the other blocks, so the output does not depend on how they are split.
+  const vtkIdType numBlocks = std::min<vtkIdType>(
+    numLines, 16 * vtkSMPTools::GetEstimatedNumberOfThreads());
+  std::vector<vtkSmartPointer<vtkPolyData> > blocks(numBlocks);
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCompositeInterpolatedVelocityField> >
+    localFuncs;
+  vtkSMPTools::For(0, numBlocks, 1, [&](vtkIdType begin, vtkIdType end)
+  {
+    vtkSmartPointer<vtkCompositeInterpolatedVelocityField>& localFunc =
+      localFuncs.Local();
+    if (!localFunc)
+    {
+      localFunc.TakeReference(compositeFunc->NewInstance());
+      localFunc->CopyParameters(compositeFunc);
+      localFunc->AddDataSets(compositeFunc);
+      localFunc->SelectVectors(vecType, vecName);
+    }
+    for (vtkIdType block = begin; block < end; block++)
+    {
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      blocks[block] = vtkSmartPointer<vtkPolyData>::New();
+      this->IntegrateLines(input0Data, blocks[block], seedSource, seedIds,
+                           integrationDirections, lastPoint, localFunc,
+                           maxCellSize, vecType, vecName, propagation,
+                           numSteps, integrationTime,
+                           block * numLines / numBlocks,
+                           (block + 1) * numLines / numBlocks, true);
+    }
+  });
+
+  // Merge the blocks in seed order. All of them have the same arrays.
+  vtkPolyData* first = blocks[0];
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->DeepCopy(first->GetPoints());
+  vtkDataSetAttributes* outputPD = output->GetPointData();
+  vtkDataSetAttributes* outputCD = output->GetCellData();
+  outputPD->DeepCopy(first->GetPointData());
+  outputCD->DeepCopy(first->GetCellData());
+  vtkNew<vtkCellArray> outputLines;
+  outputLines->Allocate(first->GetLines()->GetSize());
+
+  vtkIdType numPts = 0;
+  vtkIdType numCells = 0;
+  for (vtkIdType block = 0; block < numBlocks; block++)
+  {
+    vtkPolyData* blockOutput = blocks[block];
+    vtkIdType numBlockPts = blockOutput->GetNumberOfPoints();
+    vtkCellArray* blockLines = blockOutput->GetLines();
+    vtkIdType numBlockCells = blockLines->GetNumberOfCells();
+    if (block > 0)
+    {
+      outputPoints->GetData()->InsertTuples(
+        numPts, numBlockPts, 0, blockOutput->GetPoints()->GetData());
+      vtkDataSetAttributes* blockPD = blockOutput->GetPointData();
+      for (int i = 0; i < outputPD->GetNumberOfArrays(); i++)
+      {
+        outputPD->GetAbstractArray(i)->InsertTuples(
+          numPts, numBlockPts, 0, blockPD->GetAbstractArray(i));
+      }
+      vtkDataSetAttributes* blockCD = blockOutput->GetCellData();
+      for (int i = 0; i < outputCD->GetNumberOfArrays(); i++)
+      {
+        outputCD->GetAbstractArray(i)->InsertTuples(
+          numCells, numBlockCells, 0, blockCD->GetAbstractArray(i));
+      }
+    }
+
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (blockLines->InitTraversal(); blockLines->GetNextCell(npts, pts); )
+    {
+      outputLines->InsertNextCell(npts);
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        outputLines->InsertCellPoint(pts[i] + numPts);
+      }
+    }
+    numPts += numBlockPts;
+    numCells += numBlockCells;
+  }
+
+  output->SetPoints(outputPoints);
+  if (numPts > 1)
+  {
+    output->SetLines(outputLines);
+    if (this->GenerateNormalsInIntegrate)
+    {
+      this->GenerateNormals(output, nullptr, vecName);
+    }
+  }
+  else
+  {
+    outputCD->Initialize();
+  }
+  output->Squeeze();
+}
+
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal,
                                       const char *vecName)
 {
@@ -1439,6 +1651,8 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Vorticity computation: "
      << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Parallel execution: "
+     << (this->ParallelExecution ? "On" : "Off") << endl;
 }
 
 vtkExecutive* vtkStreamTracer::CreateDefaultExecutive()
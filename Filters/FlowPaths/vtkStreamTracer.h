@@ -294,6 +294,24 @@ public:
   vtkBooleanMacro(SurfaceStreamlines, bool);
   //@}
 
+  //@{
+  /**
+   * When on, the seeds are integrated concurrently with vtkSMPTools. Each
+   * thread uses its own copy of the interpolator and of the integrator, the
+   * cell locators of vtkCellLocatorInterpolatedVelocityField being shared,
+   * and the streamlines are merged in seed order. The search of each seed
+   * starts from the first dataset of the input, so the output does not
+   * depend on the number of threads and equals the serial output when the
+   * input has a single dataset. Custom termination callbacks must be thread
+   * safe, and the points passed to them are those of the block of seeds
+   * integrated by the calling thread. AMR inputs are integrated serially.
+   * Off by default.
+   */
+  vtkSetMacro(ParallelExecution, bool);
+  vtkGetMacro(ParallelExecution, bool);
+  vtkBooleanMacro(ParallelExecution, bool);
+  //@}
+
   enum
   {
     FORWARD,
@@ -412,6 +430,45 @@ protected:
                  double& propagation,
                  vtkIdType& numSteps,
                  double& integrationTime);
+
+  /**
+   * Integrate the lines [firstLine, endLine) of seedIds into output, as
+   * Integrate() does for all of them. When threaded is true, the progress,
+   * the abort flag and LastUsedStepSize are left alone, the normals are not
+   * generated, the lines and their cell arrays are always added to output
+   * and the search of each seed starts from the first dataset of func.
+   */
+  void IntegrateLines(vtkPointData *inputData,
+                      vtkPolyData* output,
+                      vtkDataArray* seedSource,
+                      vtkIdList* seedIds,
+                      vtkIntArray* integrationDirections,
+                      double lastPoint[3],
+                      vtkAbstractInterpolatedVelocityField* func,
+                      int maxCellSize,
+                      int vecType,
+                      const char *vecFieldName,
+                      double& propagation,
+                      vtkIdType& numSteps,
+                      double& integrationTime,
+                      vtkIdType firstLine,
+                      vtkIdType endLine,
+                      bool threaded);
+
+  /**
+   * Integrate all the lines of seedIds in parallel, see ParallelExecution.
+   * func must be a vtkCompositeInterpolatedVelocityField.
+   */
+  void IntegrateInParallel(vtkPointData *inputData,
+                           vtkPolyData* output,
+                           vtkDataArray* seedSource,
+                           vtkIdList* seedIds,
+                           vtkIntArray* integrationDirections,
+                           vtkAbstractInterpolatedVelocityField* func,
+                           int maxCellSize,
+                           int vecType,
+                           const char *vecFieldName);
+
   double SimpleIntegrate(double seed[3],
                          double lastPoint[3],
                          double stepSize,
@@ -468,6 +525,9 @@ protected:
   // Compute streamlines only on surface.
   bool SurfaceStreamlines;
 
+  // Integrate the seeds concurrently.
+  bool ParallelExecution;
+
   vtkAbstractInterpolatedVelocityField * InterpolatorPrototype;
 
   vtkCompositeDataSet* InputData;
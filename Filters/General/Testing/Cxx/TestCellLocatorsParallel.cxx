@@ -0,0 +1,304 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorsParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the cell locators built with any number of threads are the
+// same, that their batched queries give the same results as their single
+// queries, and that vtkProbeFilter can use them.
+
+#include "vtkCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+double Field(const double x[3])
+{
+  return x[0] + 2.0 * x[1] - 3.0 * x[2];
+}
+
+void RandomPoints(vtkMinimalStandardRandomSequence *random,
+                  const double bounds[6], vtkIdType numPts, vtkPoints *points)
+{
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      double margin = 0.1 * (bounds[2 * j + 1] - bounds[2 * j]);
+      random->Next();
+      x[j] = random->GetRangeValue(bounds[2 * j] - margin,
+                                   bounds[2 * j + 1] + margin);
+    }
+    points->SetPoint(i, x);
+  }
+}
+
+// Compare the batched queries of a locator with its single queries.
+bool CompareQueries(vtkAbstractCellLocator *locator, vtkPoints *points,
+                    vtkPoints *p1, vtkPoints *p2)
+{
+  vtkNew<vtkGenericCell> cell;
+  double pcoords[3], weights[8];
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  locator->FindCells(points, cellIds);
+  if (cellIds->GetNumberOfTuples() != points->GetNumberOfPoints())
+  {
+    cerr << "Bad number of cells found." << endl;
+    return false;
+  }
+  vtkIdType numFound = 0;
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    vtkIdType cellId = locator->FindCell(x, 0.0, cell, pcoords, weights);
+    if (cellIds->GetValue(i) != cellId)
+    {
+      cerr << "Bad cell found for point " << i << ": "
+           << cellIds->GetValue(i) << " instead of " << cellId << endl;
+      return false;
+    }
+    numFound += (cellId >= 0 ? 1 : 0);
+  }
+  if (numFound == 0 || numFound == points->GetNumberOfPoints())
+  {
+    cerr << "Bad test points." << endl;
+    return false;
+  }
+
+  vtkNew<vtkPoints> intersections;
+  intersections->SetDataTypeToDouble();
+  locator->IntersectWithLines(p1, p2, 0.0001, cellIds, intersections);
+  vtkIdType numHits = 0;
+  for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+  {
+    double a0[3], a1[3], t, x[3], y[3];
+    int subId;
+    vtkIdType cellId = -1;
+    p1->GetPoint(i, a0);
+    p2->GetPoint(i, a1);
+    if (!locator->IntersectWithLine(a0, a1, 0.0001, t, x, pcoords, subId,
+                                      cellId, cell))
+    {
+      cellId = -1;
+      p2->GetPoint(i, x);
+    }
+    intersections->GetPoint(i, y);
+    if (cellIds->GetValue(i) != cellId ||
+        x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << "Bad intersection for line " << i << ": "
+           << cellIds->GetValue(i) << " instead of " << cellId << endl;
+      return false;
+    }
+    numHits += (cellId >= 0 ? 1 : 0);
+  }
+  if (numHits == 0 || numHits == p1->GetNumberOfPoints())
+  {
+    cerr << "Bad test lines." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool SameIds(vtkIdList *a, vtkIdList *b)
+{
+  if (!a || !b)
+  {
+    return a == b;
+  }
+  if (a->GetNumberOfIds() != b->GetNumberOfIds())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfIds(); ++i)
+  {
+    if (a->GetId(i) != b->GetId(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class LocatorT>
+bool TestLocator(vtkDataSet *grid, vtkPoints *points, vtkPoints *p1,
+                 vtkPoints *p2, bool checkBounds)
+{
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  const double boxes[3][6] = { { 0.0, 1.0, 0.0, 1.0, 0.0, 1.0 },
+    { 2.5, 7.5, 1.0, 3.0, 4.0, 6.0 }, { 9.0, 11.0, -1.0, 5.0, 9.5, 13.0 } };
+
+  for (int cache = 0; cache < 2; ++cache)
+  {
+    vtkSMPTools::Initialize(1);
+    vtkNew<LocatorT> reference;
+    reference->SetDataSet(grid);
+    reference->SetCacheCellBounds(cache);
+    reference->BuildLocator();
+
+    for (int t = 0; t < 4; ++t)
+    {
+      vtkSMPTools::Initialize(numThreads[t]);
+      vtkNew<LocatorT> locator;
+      locator->SetDataSet(grid);
+      locator->SetCacheCellBounds(cache);
+      locator->BuildLocator();
+
+      // The search structures must be the same.
+      if (checkBounds)
+      {
+        for (int b = 0; b < 3; ++b)
+        {
+          vtkNew<vtkIdList> expected;
+          vtkNew<vtkIdList> cells;
+          reference->FindCellsWithinBounds(const_cast<double*>(boxes[b]),
+                                           expected);
+          locator->FindCellsWithinBounds(const_cast<double*>(boxes[b]), cells);
+          if (expected->GetNumberOfIds() == 0 || !SameIds(expected, cells))
+          {
+            cerr << "Different cells within bounds with " << numThreads[t]
+                 << " thread(s)." << endl;
+            return false;
+          }
+        }
+      }
+
+      if (!CompareQueries(locator, points, p1, p2))
+      {
+        cerr << locator->GetClassName() << " failed with " << numThreads[t]
+             << " thread(s)." << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestCellLocatorsParallel(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 17, 13);
+  image->SetOrigin(0.0, 0.0, 0.0);
+  image->SetSpacing(0.5, 0.25, 1.0);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+  vtkUnstructuredGrid *grid = tetrahedralize->GetOutput();
+
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Field");
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    grid->GetPoint(i, x);
+    scalars->InsertNextValue(Field(x));
+  }
+  grid->GetPointData()->SetScalars(scalars);
+
+  double bounds[6];
+  grid->GetBounds(bounds);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(5);
+  vtkNew<vtkPoints> points;
+  RandomPoints(random, bounds, 20000, points);
+  vtkNew<vtkPoints> p1;
+  RandomPoints(random, bounds, 2000, p1);
+  vtkNew<vtkPoints> p2;
+  RandomPoints(random, bounds, 2000, p2);
+
+  if (!TestLocator<vtkCellLocator>(grid, points, p1, p2, true) ||
+      !TestLocator<vtkStaticCellLocator>(grid, points, p1, p2, true) ||
+      !TestLocator<vtkCellTreeLocator>(grid, points, p1, p2, true) ||
+      !TestLocator<vtkModifiedBSPTree>(grid, points, p1, p2, false))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Probe the grid with and without locator.
+  vtkNew<vtkPolyData> probePoints;
+  probePoints->SetPoints(points);
+  vtkNew<vtkCellLocator> prototype;
+  for (int useLocator = 0; useLocator < 2; ++useLocator)
+  {
+    vtkSMPTools::Initialize(useLocator ? 4 : 1);
+    vtkNew<vtkProbeFilter> probe;
+    probe->SetInputData(probePoints);
+    probe->SetSourceData(grid);
+    if (useLocator)
+    {
+      probe->SetCellLocatorPrototype(prototype);
+    }
+    probe->Update();
+    vtkDataSet *output = probe->GetOutput();
+    vtkDataArray *mask = output->GetPointData()->GetArray(
+      probe->GetValidPointMaskArrayName());
+    vtkDataArray *values = output->GetPointData()->GetArray("Field");
+    vtkIdType numValid = 0;
+    for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+      double x[3];
+      output->GetPoint(i, x);
+      bool inside = x[0] > bounds[0] + 1e-6 && x[0] < bounds[1] - 1e-6 &&
+        x[1] > bounds[2] + 1e-6 && x[1] < bounds[3] - 1e-6 &&
+        x[2] > bounds[4] + 1e-6 && x[2] < bounds[5] - 1e-6;
+      bool valid = mask->GetComponent(i, 0) != 0.0;
+      if (inside && !valid)
+      {
+        cerr << "Point " << i << " not probed." << endl;
+        return EXIT_FAILURE;
+      }
+      if (valid && std::abs(values->GetComponent(i, 0) - Field(x)) > 1e-6)
+      {
+        cerr << "Bad probed value for point " << i << endl;
+        return EXIT_FAILURE;
+      }
+      numValid += (valid ? 1 : 0);
+    }
+    if (numValid == 0 || numValid == output->GetNumberOfPoints())
+    {
+      cerr << "Bad number of probed points." << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
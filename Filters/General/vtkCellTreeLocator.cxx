@@ -29,6 +29,7 @@
 #include "vtkPolyData.h"
 #include "vtkBoundingBox.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 
 vtkStandardNewMacro(vtkCellTreeLocator);
 
@@ -279,11 +280,30 @@ class vtkCellTreeBuilder
 
     // -------------------------------------------------------------------------
 
-    void Split( unsigned int index, float min[3], float max[3] )
+    // A node to split, and the result of its split.
+    struct SplitTask
     {
-      unsigned int start = this->m_nodes[index].Start();
-      unsigned int size  = this->m_nodes[index].Size();
+      unsigned int Index;
+      float Min[3];
+      float Max[3];
+      bool Split;
+      unsigned int Dim;
+      unsigned int Mid;
+      float ChildMin[2][3];
+      float ChildMax[2][3];
+    };
+
+    // Choose the split of a node, reordering its cells. This only reads the
+    // nodes and only touches the cells of the node, so that the nodes of a
+    // level of the tree can be split concurrently.
+    void Split( SplitTask& task )
+    {
+      float* min = task.Min;
+      float* max = task.Max;
+      unsigned int start = this->m_nodes[task.Index].Start();
+      unsigned int size  = this->m_nodes[task.Index].Size();
 
+      task.Split = false;
       if( size < this->m_leafsize )
       {
         return;
@@ -388,22 +408,69 @@ class vtkCellTreeBuilder
         std::nth_element( begin, mid, end, CenterOrder( dim ) );
       }
 
-      float lmin[3], lmax[3], rmin[3], rmax[3];
+      FindMinMax( begin, mid, task.ChildMin[0], task.ChildMax[0] );
+      FindMinMax( mid,   end, task.ChildMin[1], task.ChildMax[1] );
+
+      task.Split = true;
+      task.Dim = dim;
+      task.Mid = static_cast<unsigned int>(mid - &(this->m_pc[0]));
+    }
+
+    // Split the nodes level by level, in parallel within a level. Since a
+    // node only depends on its parent, the tree is the same as with a
+    // depth-first recursion.
+    void SplitAll( float min[3], float max[3] )
+    {
+      std::vector<SplitTask> tasks(1);
+      tasks[0].Index = 0;
+      std::copy( min, min+3, tasks[0].Min );
+      std::copy( max, max+3, tasks[0].Max );
+
+      std::vector<SplitTask> next;
+      while( !tasks.empty() )
+      {
+        vtkSMPTools::For( 0, static_cast<vtkIdType>(tasks.size()), 1,
+          [this, &tasks]( vtkIdType begin, vtkIdType end )
+          {
+            for( vtkIdType i=begin; i<end; ++i )
+            {
+              this->Split( tasks[i] );
+            }
+          });
 
-      FindMinMax( begin, mid, lmin, lmax );
-      FindMinMax( mid,   end, rmin, rmax );
+        next.clear();
+        for( size_t i=0; i<tasks.size(); ++i )
+        {
+          const SplitTask& task = tasks[i];
+          if( !task.Split )
+          {
+            continue;
+          }
 
-      float clip[2] = { lmax[dim], rmin[dim]};
+          unsigned int start = this->m_nodes[task.Index].Start();
+          unsigned int end = start + this->m_nodes[task.Index].Size();
+          float clip[2] = { task.ChildMax[0][task.Dim],
+                            task.ChildMin[1][task.Dim] };
 
-      vtkCellTreeLocator::vtkCellTreeNode child[2];
-      child[0].MakeLeaf( begin - &(this->m_pc[0]), mid-begin );
-      child[1].MakeLeaf( mid   - &(this->m_pc[0]), end-mid );
+          vtkCellTreeLocator::vtkCellTreeNode child[2];
+          child[0].MakeLeaf( start, task.Mid-start );
+          child[1].MakeLeaf( task.Mid, end-task.Mid );
 
-      this->m_nodes[index].MakeNode( (int)m_nodes.size(), dim, clip );
-      this->m_nodes.insert( m_nodes.end(), child, child+2 );
+          unsigned int left = static_cast<unsigned int>(this->m_nodes.size());
+          this->m_nodes[task.Index].MakeNode( left, task.Dim, clip );
+          this->m_nodes.insert( this->m_nodes.end(), child, child+2 );
 
-      Split( this->m_nodes[index].GetLeftChildIndex(), lmin, lmax );
-      Split( this->m_nodes[index].GetRightChildIndex(), rmin, rmax );
+          for( unsigned int c=0; c<2; ++c )
+          {
+            SplitTask childTask;
+            childTask.Index = left + c;
+            std::copy( task.ChildMin[c], task.ChildMin[c]+3, childTask.Min );
+            std::copy( task.ChildMax[c], task.ChildMax[c]+3, childTask.Max );
+            next.push_back( childTask );
+          }
+        }
+        tasks.swap( next );
+      }
     }
 
   public:
@@ -434,25 +501,40 @@ class vtkCellTreeBuilder
         -std::numeric_limits<float>::max(),
         };
 
-      for( vtkIdType i=0; i<size; ++i )
+      if( size > 0 && !ctl->CellBounds )
       {
-        this->m_pc[i].Ind = i;
-
-        double *boundsPtr = cellBounds;
-        if (ctl->CellBounds)
-        {
-          boundsPtr = ctl->CellBounds[i];
-        }
-        else
+        // Make sure the dataset is ready for concurrent GetCellBounds() calls.
+        ds->GetCellBounds(0, cellBounds);
+      }
+      vtkSMPTools::For( 0, size, [this, ctl, ds]( vtkIdType begin, vtkIdType end )
+      {
+        double bounds[6];
+        for( vtkIdType i=begin; i<end; ++i )
         {
-          ds->GetCellBounds(i, boundsPtr);
+          this->m_pc[i].Ind = i;
+
+          double *boundsPtr = bounds;
+          if (ctl->CellBounds)
+          {
+            boundsPtr = ctl->CellBounds[i];
+          }
+          else
+          {
+            ds->GetCellBounds(i, boundsPtr);
+          }
+
+          for( int d=0; d<3; ++d )
+          {
+            this->m_pc[i].Min[d] = boundsPtr[2*d+0];
+            this->m_pc[i].Max[d] = boundsPtr[2*d+1];
+          }
         }
+      });
 
+      for( vtkIdType i=0; i<size; ++i )
+      {
         for( int d=0; d<3; ++d )
         {
-          this->m_pc[i].Min[d] = boundsPtr[2*d+0];
-          this->m_pc[i].Max[d] = boundsPtr[2*d+1];
-
           if( this->m_pc[i].Min[d] < min[d] )
           {
             min[d] = this->m_pc[i].Min[d];
@@ -476,7 +558,7 @@ class vtkCellTreeBuilder
       root.MakeLeaf( 0, size );
       this->m_nodes.push_back( root );
 
-      Split( 0, min, max );
+      SplitAll( min, max );
 
       ct.Nodes.resize( this->m_nodes.size() );
       ct.Nodes[0] = this->m_nodes[0];
@@ -608,6 +690,7 @@ void vtkCellTreeLocator::BuildLocator()
 vtkIdType vtkCellTreeLocator::FindCell( double pos[3], double , vtkGenericCell *cell, double pcoords[3],
                                         double* weights )
 {
+  this->BuildLocatorIfNeeded();
   if( this->Tree == nullptr )
   {
     return -1;
@@ -672,6 +755,16 @@ namespace
 }
 typedef std::pair<double, int> Intersection;
 
+int vtkCellTreeLocator::IntersectWithLine(double p1[3], double p2[3], double tol,
+  double& t, double x[3], double pcoords[3],
+  int &subId, vtkIdType &cellId)
+{
+  return this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId,
+                                 this->GenericCell);
+}
+
+// The candidate cells are loaded into the given cell, so that the traversal
+// is thread safe as long as each thread provides its own cell.
 int vtkCellTreeLocator::IntersectWithLine(double p1[3],
                                           double p2[3],
                                           double tol,
@@ -679,20 +772,8 @@ int vtkCellTreeLocator::IntersectWithLine(double p1[3],
                                           double x[3],
                                           double pcoords[3],
                                           int &subId,
-                                          vtkIdType &cellId,
+                                          vtkIdType &cellIds,
                                           vtkGenericCell *cell)
-{
-  int hit = this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId);
-  if (hit)
-  {
-    this->DataSet->GetCell(cellId, cell);
-  }
-  return hit;
-}
-
-int vtkCellTreeLocator::IntersectWithLine(double p1[3], double p2[3], double tol,
-  double& t, double x[3], double pcoords[3],
-  int &subId, vtkIdType &cellIds)
 {
   //
   vtkCellTreeNode  *node, *near, *far;
@@ -805,7 +886,7 @@ int vtkCellTreeLocator::IntersectWithLine(double p1[3], double p2[3], double tol
       ctmin = _tmin; ctmax = _tmax;
       if (this->RayMinMaxT(boundsPtr, p1, ray_vec, ctmin, ctmax))
       {
-        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId))
+        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId, cell))
         {
           if (t_hit<closest_intersection)
           {
@@ -826,6 +907,7 @@ int vtkCellTreeLocator::IntersectWithLine(double p1[3], double p2[3], double tol
   if (HIT)
   {
     t = closest_intersection;
+    this->DataSet->GetCell(cellIds, cell);
   }
   //
   return HIT;
@@ -1222,8 +1304,23 @@ int vtkCellTreeLocator::IntersectCellInternal(
   double pcoords[3],
   int &subId)
 {
-  this->DataSet->GetCell(cell_ID, this->GenericCell);
-  return this->GenericCell->IntersectWithLine(const_cast<double*>(p1), const_cast<double*>(p2), tol, t, ipt, pcoords, subId);
+  return this->IntersectCellInternal(cell_ID, p1, p2, tol, t, ipt, pcoords,
+                                     subId, this->GenericCell);
+}
+//----------------------------------------------------------------------------
+int vtkCellTreeLocator::IntersectCellInternal(
+  vtkIdType cell_ID,
+  const double p1[3],
+  const double p2[3],
+  const double tol,
+  double &t,
+  double ipt[3],
+  double pcoords[3],
+  int &subId,
+  vtkGenericCell *cell)
+{
+  this->DataSet->GetCell(cell_ID, cell);
+  return cell->IntersectWithLine(const_cast<double*>(p1), const_cast<double*>(p2), tol, t, ipt, pcoords, subId);
 }
 //----------------------------------------------------------------------------
 void vtkCellTreeLocator::FreeSearchStructure(void)
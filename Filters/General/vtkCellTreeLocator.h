@@ -70,6 +70,8 @@ class VTKFILTERSGENERAL_EXPORT vtkCellTreeLocator : public vtkAbstractCellLocato
     /**
      * Return intersection point (if any) AND the cell which was intersected by
      * the finite line. The cell is returned as a cell id and as a generic cell.
+     * Once the locator is built, this may be called concurrently from several
+     * threads, each with its own cell.
      */
     int IntersectWithLine(double a0[3], double a1[3], double tol,
                           double& t, double x[3], double pcoords[3],
@@ -237,6 +239,19 @@ protected:
     double pcoords[3],
     int &subId);
 
+  // Same as above, but the cell is loaded into the given vtkGenericCell so
+  // that concurrent queries do not share it.
+  virtual int IntersectCellInternal( vtkIdType cell_ID,  const double p1[3],
+    const double p2[3],
+    const double tol,
+    double &t,
+    double ipt[3],
+    double pcoords[3],
+    int &subId,
+    vtkGenericCell *cell);
+
+  bool IsQueryThreadSafe() override { return true; }
+
 
     int NumberOfBuckets;
 
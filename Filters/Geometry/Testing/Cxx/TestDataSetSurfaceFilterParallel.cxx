@@ -0,0 +1,366 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the parallel execution of vtkDataSetSurfaceFilter on
+// unstructured grids gives the same cells as the serial one (up to their
+// order), and an output which does not depend on the number of threads,
+// and that the parallel execution reports its progress and can be aborted.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// A grid of hexahedra where some hexahedra are replaced by voxels,
+// polyhedra or six pyramids around the center of the hexahedron. A few
+// vertex, line and polygonal cells and an empty cell are added, and the last
+// point is not used.
+void MakeGrid(int resolution, vtkUnstructuredGrid *grid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataType(VTK_DOUBLE);
+  const int n = resolution + 1;
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+
+  grid->SetPoints(points);
+  grid->Allocate(resolution * resolution * resolution);
+  vtkIdType pts[8];
+  for (int k = 0; k < resolution; ++k)
+  {
+    for (int j = 0; j < resolution; ++j)
+    {
+      for (int i = 0; i < resolution; ++i)
+      {
+        vtkIdType p = i + n * (j + n * k);
+        pts[0] = p;
+        pts[1] = p + 1;
+        pts[2] = p + 1 + n;
+        pts[3] = p + n;
+        for (int c = 0; c < 4; ++c)
+        {
+          pts[c + 4] = pts[c] + n * n;
+        }
+        int choice = (i + 2 * j + 3 * k) % 7;
+        if (choice == 1)
+        {
+          vtkIdType voxel[8] = { pts[0], pts[1], pts[3], pts[2],
+                                 pts[4], pts[5], pts[7], pts[6] };
+          grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+        }
+        else if (choice == 3)
+        {
+          const int faces[6][4] = { { 0, 3, 2, 1 }, { 4, 5, 6, 7 },
+            { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+          vtkIdType stream[31];
+          stream[0] = 6;
+          for (int f = 0; f < 6; ++f)
+          {
+            stream[1 + 5 * f] = 4;
+            for (int c = 0; c < 4; ++c)
+            {
+              stream[2 + 5 * f + c] = pts[faces[f][c]];
+            }
+          }
+          grid->InsertNextCell(VTK_POLYHEDRON, 8, pts, 6, stream + 1);
+        }
+        else if (choice == 5)
+        {
+          vtkIdType center = points->InsertNextPoint(i + 0.5, j + 0.5, k + 0.5);
+          const int faces[6][4] = { { 0, 3, 2, 1 }, { 4, 5, 6, 7 },
+            { 0, 1, 5, 4 }, { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+          for (int f = 0; f < 6; ++f)
+          {
+            vtkIdType pyramid[5] = { pts[faces[f][0]], pts[faces[f][1]],
+              pts[faces[f][2]], pts[faces[f][3]], center };
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+          }
+        }
+        else
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, pts);
+        }
+      }
+    }
+  }
+
+  vtkIdType extra[5] = { 0, 1, 2, n, n + 1 };
+  grid->InsertNextCell(VTK_VERTEX, 1, extra);
+  grid->InsertNextCell(VTK_LINE, 2, extra + 1);
+  grid->InsertNextCell(VTK_TRIANGLE_STRIP, 5, extra);
+  grid->InsertNextCell(VTK_EMPTY_CELL, 0, extra);
+  grid->InsertNextCell(VTK_PIXEL, 4, extra + 1);
+  grid->InsertNextCell(VTK_POLY_VERTEX, 3, extra + 2);
+  grid->InsertNextCell(VTK_POLYGON, 5, extra);
+  points->InsertNextPoint(-1.0, -1.0, -1.0);
+
+  vtkNew<vtkDoubleArray> pointIds;
+  pointIds->SetName("PointIds");
+  pointIds->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+  {
+    pointIds->SetValue(ptId, ptId);
+  }
+  grid->GetPointData()->SetScalars(pointIds);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, cellId);
+  }
+  grid->GetCellData()->AddArray(cellIds);
+}
+
+// The output cells, as their kind (vert, line or poly), the input cell and
+// the input points. The attributes must match the original ids.
+typedef std::vector<vtkIdType> CellDescription;
+bool DescribeCells(vtkPolyData *output, std::vector<CellDescription> &cells)
+{
+  vtkIdTypeArray *origCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkIdTypeArray *origPointIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkIdTypeArray *cellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("CellIds"));
+  vtkDataArray *pointIds = output->GetPointData()->GetScalars();
+  if (!origCellIds || !origPointIds || !cellIds || !pointIds ||
+      origCellIds->GetNumberOfTuples() != output->GetNumberOfCells() ||
+      cellIds->GetNumberOfTuples() != output->GetNumberOfCells() ||
+      origPointIds->GetNumberOfTuples() != output->GetNumberOfPoints() ||
+      pointIds->GetNumberOfTuples() != output->GetNumberOfPoints())
+  {
+    cerr << "Missing or bad attributes." << endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    if (pointIds->GetTuple1(ptId) != origPointIds->GetValue(ptId))
+    {
+      cerr << "Bad point data for point " << ptId << endl;
+      return false;
+    }
+  }
+
+  cells.clear();
+  vtkCellArray *arrays[3] = { output->GetVerts(), output->GetLines(),
+                              output->GetPolys() };
+  vtkIdType cellId = 0;
+  vtkIdType npts;
+  vtkIdType *pts;
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    for (arrays[kind]->InitTraversal(); arrays[kind]->GetNextCell(npts, pts);
+         ++cellId)
+    {
+      if (cellIds->GetValue(cellId) != origCellIds->GetValue(cellId))
+      {
+        cerr << "Bad cell data for cell " << cellId << endl;
+        return false;
+      }
+      CellDescription cell;
+      cell.push_back(kind);
+      cell.push_back(origCellIds->GetValue(cellId));
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        cell.push_back(origPointIds->GetValue(pts[i]));
+      }
+      cells.push_back(cell);
+    }
+  }
+  return true;
+}
+
+bool SameArray(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Run the serial and the parallel executions with various numbers of
+// threads. The parallel outputs must be identical, and have the same cells
+// as the serial one.
+bool Compare(vtkUnstructuredGrid *input, const char *name)
+{
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  surface->Update();
+  std::vector<CellDescription> serialCells;
+  if (!DescribeCells(surface->GetOutput(), serialCells))
+  {
+    return false;
+  }
+  std::sort(serialCells.begin(), serialCells.end());
+
+  surface->ParallelExecutionOn();
+  vtkNew<vtkPolyData> reference;
+  const int numThreads[] = { 1, 2, 4, 0 };
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkSMPTools::Initialize(numThreads[i]);
+    surface->Modified();
+    surface->Update();
+    vtkPolyData *output = surface->GetOutput();
+    std::vector<CellDescription> cells;
+    if (!DescribeCells(output, cells))
+    {
+      return false;
+    }
+    std::sort(cells.begin(), cells.end());
+    if (cells != serialCells)
+    {
+      cerr << name << ": the parallel output has " << cells.size()
+           << " cells, the serial one " << serialCells.size()
+           << ", or they differ." << endl;
+      return false;
+    }
+    if (i == 0)
+    {
+      reference->DeepCopy(output);
+    }
+    else if (!SameArray(reference->GetPoints()->GetData(),
+                        output->GetPoints()->GetData()) ||
+             !SameArray(reference->GetPolys()->GetData(),
+                        output->GetPolys()->GetData()) ||
+             !SameArray(reference->GetCellData()->GetArray("CellIds"),
+                        output->GetCellData()->GetArray("CellIds")))
+    {
+      cerr << name << ": the parallel output depends on the number of "
+           << "threads." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Aborts the filter at its first progress event between 0 and 1.
+void AbortOnProgress(vtkObject *caller, unsigned long, void *clientData,
+                     void *callData)
+{
+  double progress = *static_cast<double*>(callData);
+  std::vector<double> *progresses = static_cast<std::vector<double>*>(clientData);
+  progresses->push_back(progress);
+  if (progress > 0.0 && progress < 1.0)
+  {
+    vtkDataSetSurfaceFilter::SafeDownCast(caller)->AbortExecuteOn();
+  }
+}
+
+bool CheckAbort(vtkUnstructuredGrid *input)
+{
+  std::vector<double> progresses;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(AbortOnProgress);
+  callback->SetClientData(&progresses);
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->ParallelExecutionOn();
+  surface->AddObserver(vtkCommand::ProgressEvent, callback);
+  surface->Update();
+  size_t numIntermediate = 0;
+  for (size_t i = 0; i < progresses.size(); ++i)
+  {
+    if (progresses[i] > 0.0 && progresses[i] < 1.0)
+    {
+      numIntermediate++;
+    }
+  }
+  if (numIntermediate != 1 || surface->GetOutput()->GetNumberOfCells() != 0)
+  {
+    cerr << "The parallel execution was not aborted at its first progress "
+         << "event." << endl;
+    return false;
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestDataSetSurfaceFilterParallel(int argc, char *argv[])
+{
+  int resolution = 20;
+  for (int argi = 1; argi < argc; argi++)
+  {
+    if (std::string(argv[argi]) == "--resolution" && argi + 1 < argc)
+    {
+      resolution = atoi(argv[++argi]);
+    }
+  }
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(resolution, grid);
+  if (!Compare(grid, "mixed cells") || !CheckAbort(grid))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Faces using hidden points or only duplicated points are discarded.
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+  {
+    ghosts->SetValue(ptId, (ptId % 23 == 5) ?
+      vtkDataSetAttributes::HIDDENPOINT : (ptId % 3 != 0) ?
+      vtkDataSetAttributes::DUPLICATEPOINT : 0);
+  }
+  grid->GetPointData()->AddArray(ghosts);
+  if (!Compare(grid, "ghost points"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -14,10 +14,12 @@
 =========================================================================*/
 #include "vtkDataSetSurfaceFilter.h"
 
+#include "vtkAtomic.h"
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkCellSubsetHelper.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkHexahedron.h"
@@ -32,6 +34,9 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -130,6 +135,8 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->OriginalPointIdsName = nullptr;
 
   this->NonlinearSubdivisionLevel = 1;
+
+  this->ParallelExecution = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -1465,6 +1472,8 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->GetNonlinearSubdivisionLevel() << endl;
+  os << indent << "ParallelExecution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1477,6 +1486,13 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
                                                      vtkPolyData *output)
 {
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(dataSetInput);
+  if (this->ParallelExecution && grid &&
+      this->ParallelUnstructuredGridExecute(grid, output))
+  {
+    return 1;
+  }
+
   vtkUnstructuredGridBase *input =
       vtkUnstructuredGridBase::SafeDownCast(dataSetInput);
 
@@ -2723,3 +2739,846 @@ void vtkDataSetSurfaceFilter::RecordOrigPointId(vtkIdType destIndex,
     this->OriginalPointIds->InsertValue(destIndex, originalId);
   }
 }
+
+//========================================================================
+// Parallel extraction of the surface of unstructured grids of linear cells.
+// Each cell produces "items": its vertex, line and polygonal cells, which
+// are passed as is, and the faces of 3D cells. The faces are binned by their
+// smallest point id, like in the face hash of the serial path, and a face
+// is on the surface when no other face in its bin has the same points.
+
+namespace
+{
+
+enum SurfaceItemKind
+{
+  SURFACE_HIDDEN = 0,
+  SURFACE_VERT = 1,
+  SURFACE_LINE = 2,
+  SURFACE_POLY = 3,
+  SURFACE_FACE = 4 // a face of a 3D cell, before matching
+};
+
+// Faces of the 3D cells with a fixed topology, as face streams: the number
+// of faces, then the number of points of each face followed by its points.
+// These are the faces (and orientations) inserted in the hash by the serial
+// path.
+const int SurfaceTetraFaces[] = { 4,
+  3, 0, 1, 3,  3, 0, 2, 1,  3, 0, 3, 2,  3, 1, 2, 3 };
+const int SurfaceHexahedronFaces[] = { 6,
+  4, 0, 1, 5, 4,  4, 0, 3, 2, 1,  4, 0, 4, 7, 3,
+  4, 1, 2, 6, 5,  4, 2, 3, 7, 6,  4, 4, 5, 6, 7 };
+const int SurfaceVoxelFaces[] = { 6,
+  4, 0, 1, 5, 4,  4, 0, 2, 3, 1,  4, 0, 4, 6, 2,
+  4, 1, 3, 7, 5,  4, 2, 6, 7, 3,  4, 4, 5, 7, 6 };
+const int SurfaceWedgeFaces[] = { 5,
+  3, 0, 1, 2,  3, 3, 5, 4,
+  4, 0, 3, 4, 1,  4, 1, 4, 5, 2,  4, 2, 5, 3, 0 };
+const int SurfacePyramidFaces[] = { 5,
+  4, 0, 3, 2, 1,
+  3, 0, 1, 4,  3, 1, 2, 4,  3, 2, 3, 4,  3, 3, 0, 4 };
+const int SurfacePentagonalPrismFaces[] = { 7,
+  4, 0, 1, 6, 5,  4, 1, 2, 7, 6,  4, 2, 3, 8, 7,  4, 3, 4, 9, 8,
+  4, 4, 0, 5, 9,  5, 0, 1, 2, 3, 4,  5, 5, 6, 7, 8, 9 };
+const int SurfaceHexagonalPrismFaces[] = { 8,
+  4, 0, 1, 7, 6,  4, 1, 2, 8, 7,  4, 2, 3, 9, 8,  4, 3, 4, 10, 9,
+  4, 4, 5, 11, 10,  4, 5, 0, 6, 11,
+  6, 0, 1, 2, 3, 4, 5,  6, 6, 7, 8, 9, 10, 11 };
+
+//----------------------------------------------------------------------------
+// Return the faces of a 3D cell type with a fixed topology and its number of
+// points, or nullptr.
+const int *GetSurfaceCellFaces(int cellType, vtkIdType &numCellPts)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      numCellPts = 4;
+      return SurfaceTetraFaces;
+    case VTK_HEXAHEDRON:
+      numCellPts = 8;
+      return SurfaceHexahedronFaces;
+    case VTK_VOXEL:
+      numCellPts = 8;
+      return SurfaceVoxelFaces;
+    case VTK_WEDGE:
+      numCellPts = 6;
+      return SurfaceWedgeFaces;
+    case VTK_PYRAMID:
+      numCellPts = 5;
+      return SurfacePyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      numCellPts = 10;
+      return SurfacePentagonalPrismFaces;
+    case VTK_HEXAGONAL_PRISM:
+      numCellPts = 12;
+      return SurfaceHexagonalPrismFaces;
+    default:
+      return nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Rotate a face so that its first point is its smallest point id, which
+// keeps its orientation.
+void RotateSurfaceFace(vtkIdType *face, vtkIdType numFacePts)
+{
+  vtkIdType first = 0;
+  for (vtkIdType i = 1; i < numFacePts; ++i)
+  {
+    if (face[i] < face[first])
+    {
+      first = i;
+    }
+  }
+  std::rotate(face, face + first, face + numFacePts);
+}
+
+//----------------------------------------------------------------------------
+// First pass over the cells: the number of items of each cell and the
+// number of point ids they use. Cells which are not handled by the parallel
+// path (nonlinear cells, ...) are flagged.
+struct SurfaceCountItems
+{
+  enum
+  {
+    UNSUPPORTED = 1,
+    HAS_VERTS = 2,
+    HAS_LINES = 4
+  };
+
+  const vtkCellSubsetHelper *Cells;
+  vtkUnstructuredGrid *Input;
+  vtkIdType *NumberOfItems;
+  vtkIdType *NumberOfIds;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+  vtkSMPThreadLocal<int> LocalFlags;
+  int Flags;
+
+  SurfaceCountItems() : Flags(0)
+  {
+  }
+
+  void Initialize()
+  {
+    this->LocalFlags.Local() = 0;
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    int &flags = this->LocalFlags.Local();
+    vtkIdType npts, numCellPts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      int cellType = this->Cells->GetCellPoints(cellId, npts, pts, ptIds);
+      vtkIdType numItems = 0;
+      vtkIdType numIds = 0;
+      const int *faces = GetSurfaceCellFaces(cellType, numCellPts);
+      if (faces)
+      {
+        if (npts != numCellPts)
+        {
+          flags |= UNSUPPORTED;
+        }
+        numItems = faces[0];
+        for (int face = 0, loc = 1; face < numItems; ++face)
+        {
+          numIds += faces[loc];
+          loc += faces[loc] + 1;
+        }
+      }
+      else
+      {
+        switch (cellType)
+        {
+          case VTK_EMPTY_CELL:
+            break;
+          case VTK_VERTEX:
+          case VTK_POLY_VERTEX:
+            flags |= HAS_VERTS;
+            numItems = 1;
+            numIds = npts;
+            break;
+          case VTK_LINE:
+          case VTK_POLY_LINE:
+            flags |= HAS_LINES;
+            numItems = 1;
+            numIds = npts;
+            break;
+          case VTK_TRIANGLE:
+          case VTK_QUAD:
+          case VTK_POLYGON:
+            numItems = 1;
+            numIds = npts;
+            break;
+          case VTK_PIXEL:
+            if (npts != 4)
+            {
+              flags |= UNSUPPORTED;
+            }
+            numItems = 1;
+            numIds = 4;
+            break;
+          case VTK_TRIANGLE_STRIP:
+            numItems = (npts > 2 ? npts - 2 : 0);
+            numIds = 3 * numItems;
+            break;
+          case VTK_POLYHEDRON:
+          {
+            const vtkIdType *stream = this->Input->GetFaces(cellId);
+            if (stream)
+            {
+              numItems = stream[0];
+              for (vtkIdType face = 0, loc = 1; face < numItems; ++face)
+              {
+                numIds += stream[loc];
+                loc += stream[loc] + 1;
+              }
+            }
+            break;
+          }
+          default:
+            flags |= UNSUPPORTED;
+            break;
+        }
+      }
+      this->NumberOfItems[cellId] = numItems;
+      this->NumberOfIds[cellId] = numIds;
+    }
+  }
+
+  void Reduce()
+  {
+    this->Flags = 0;
+    for (vtkSMPThreadLocal<int>::iterator it = this->LocalFlags.begin();
+         it != this->LocalFlags.end(); ++it)
+    {
+      this->Flags |= *it;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Second pass over the cells: store the items. The faces of 3D cells are
+// rotated so that they start with their smallest point id.
+struct SurfaceFillItems
+{
+  const vtkCellSubsetHelper *Cells;
+  vtkUnstructuredGrid *Input;
+  const vtkIdType *ItemOffsets;
+  const vtkIdType *IdOffsets;
+  vtkIdType *ItemCells;
+  vtkIdType *ItemLocations;
+  unsigned char *ItemKinds;
+  vtkIdType *Ids;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds;
+
+  // Start a new item and return where its point ids go.
+  vtkIdType *NewItem(vtkIdType cellId, vtkIdType &item, vtkIdType &loc,
+                     unsigned char kind, vtkIdType numItemPts)
+  {
+    this->ItemCells[item] = cellId;
+    this->ItemLocations[item] = loc;
+    this->ItemKinds[item] = kind;
+    vtkIdType *itemPts = this->Ids + loc;
+    ++item;
+    loc += numItemPts;
+    return itemPts;
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds.Local();
+    vtkIdType npts, numCellPts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      int cellType = this->Cells->GetCellPoints(cellId, npts, pts, ptIds);
+      vtkIdType item = this->ItemOffsets[cellId];
+      vtkIdType loc = this->IdOffsets[cellId];
+      const int *faces = GetSurfaceCellFaces(cellType, numCellPts);
+      if (faces)
+      {
+        for (int face = 0, faceLoc = 1; face < faces[0]; ++face)
+        {
+          int numFacePts = faces[faceLoc++];
+          vtkIdType *facePts = this->NewItem(cellId, item, loc, SURFACE_FACE,
+                                             numFacePts);
+          for (int i = 0; i < numFacePts; ++i)
+          {
+            facePts[i] = pts[faces[faceLoc++]];
+          }
+          RotateSurfaceFace(facePts, numFacePts);
+        }
+        continue;
+      }
+
+      vtkIdType *itemPts;
+      switch (cellType)
+      {
+        case VTK_VERTEX:
+        case VTK_POLY_VERTEX:
+          itemPts = this->NewItem(cellId, item, loc, SURFACE_VERT, npts);
+          std::copy(pts, pts + npts, itemPts);
+          break;
+        case VTK_LINE:
+        case VTK_POLY_LINE:
+          itemPts = this->NewItem(cellId, item, loc, SURFACE_LINE, npts);
+          std::copy(pts, pts + npts, itemPts);
+          break;
+        case VTK_TRIANGLE:
+        case VTK_QUAD:
+        case VTK_POLYGON:
+          itemPts = this->NewItem(cellId, item, loc, SURFACE_POLY, npts);
+          std::copy(pts, pts + npts, itemPts);
+          break;
+        case VTK_PIXEL:
+          itemPts = this->NewItem(cellId, item, loc, SURFACE_POLY, 4);
+          itemPts[0] = pts[0];
+          itemPts[1] = pts[1];
+          itemPts[2] = pts[3];
+          itemPts[3] = pts[2];
+          break;
+        case VTK_TRIANGLE_STRIP:
+        {
+          // Same triangles as the serial path.
+          if (npts < 3)
+          {
+            break;
+          }
+          vtkIdType tri[3] = { pts[0], pts[1], 0 };
+          int toggle = 0;
+          for (vtkIdType i = 2; i < npts; ++i)
+          {
+            tri[2] = pts[i];
+            itemPts = this->NewItem(cellId, item, loc, SURFACE_POLY, 3);
+            std::copy(tri, tri + 3, itemPts);
+            tri[toggle] = tri[2];
+            toggle = !toggle;
+          }
+          break;
+        }
+        case VTK_POLYHEDRON:
+        {
+          const vtkIdType *stream = this->Input->GetFaces(cellId);
+          vtkIdType numFaces = stream ? *stream++ : 0;
+          for (vtkIdType face = 0; face < numFaces; ++face)
+          {
+            vtkIdType numFacePts = *stream++;
+            itemPts = this->NewItem(cellId, item, loc, SURFACE_FACE,
+                                    numFacePts);
+            std::copy(stream, stream + numFacePts, itemPts);
+            RotateSurfaceFace(itemPts, numFacePts);
+            stream += numFacePts;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the faces of each bin (keyed by the first point of the faces).
+struct SurfaceCountBins
+{
+  const vtkIdType *ItemLocations;
+  const unsigned char *ItemKinds;
+  const vtkIdType *Ids;
+  vtkAtomic<vtkIdType> *BinSizes;
+
+  void operator()(vtkIdType item, vtkIdType endItem) const
+  {
+    for ( ; item < endItem; ++item)
+    {
+      if (this->ItemKinds[item] == SURFACE_FACE)
+      {
+        ++this->BinSizes[this->Ids[this->ItemLocations[item]]];
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Store the faces in their bin. The order of the faces inside a bin depends
+// on the threads, but it does not matter for the matching.
+struct SurfaceFillBins
+{
+  const vtkIdType *ItemLocations;
+  const unsigned char *ItemKinds;
+  const vtkIdType *Ids;
+  const vtkIdType *BinOffsets;
+  vtkAtomic<vtkIdType> *BinSizes;
+  vtkIdType *Bins;
+
+  void operator()(vtkIdType item, vtkIdType endItem) const
+  {
+    for ( ; item < endItem; ++item)
+    {
+      if (this->ItemKinds[item] == SURFACE_FACE)
+      {
+        vtkIdType bin = this->Ids[this->ItemLocations[item]];
+        this->Bins[this->BinOffsets[bin] + (--this->BinSizes[bin])] = item;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Compare two faces of the same bin, which start with the same point. Faces
+// made of the same points in either orientation compare equal.
+struct SurfaceFaceCompare
+{
+  const vtkIdType *ItemLocations;
+  const vtkIdType *Ids;
+
+  // Whether the points following the first one make a smaller sequence in
+  // the order of the face than in the reverse order.
+  static bool IsForward(const vtkIdType *face, vtkIdType numFacePts)
+  {
+    for (vtkIdType i = 1; i < numFacePts; ++i)
+    {
+      if (face[i] != face[numFacePts - i])
+      {
+        return face[i] < face[numFacePts - i];
+      }
+    }
+    return true;
+  }
+
+  int Compare(vtkIdType itemA, vtkIdType itemB) const
+  {
+    const vtkIdType *a = this->Ids + this->ItemLocations[itemA];
+    const vtkIdType *b = this->Ids + this->ItemLocations[itemB];
+    vtkIdType numA = this->ItemLocations[itemA + 1] - this->ItemLocations[itemA];
+    vtkIdType numB = this->ItemLocations[itemB + 1] - this->ItemLocations[itemB];
+    if (numA != numB)
+    {
+      return numA < numB ? -1 : 1;
+    }
+    bool forwardA = IsForward(a, numA);
+    bool forwardB = IsForward(b, numB);
+    for (vtkIdType i = 1; i < numA; ++i)
+    {
+      vtkIdType ptA = forwardA ? a[i] : a[numA - i];
+      vtkIdType ptB = forwardB ? b[i] : b[numB - i];
+      if (ptA != ptB)
+      {
+        return ptA < ptB ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  bool operator()(vtkIdType itemA, vtkIdType itemB) const
+  {
+    return this->Compare(itemA, itemB) < 0;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the faces used by a single cell in each bin. Like in the serial path,
+// the faces whose points are all duplicated ghost points, or which use a
+// hidden ghost point, are discarded.
+struct SurfaceMatchFaces
+{
+  const vtkIdType *ItemLocations;
+  const vtkIdType *Ids;
+  const vtkIdType *BinOffsets;
+  const unsigned char *Ghosts;
+  vtkIdType *Bins;
+  unsigned char *ItemKinds;
+
+  unsigned char GetVisibleKind(vtkIdType item) const
+  {
+    if (!this->Ghosts)
+    {
+      return SURFACE_POLY;
+    }
+    bool allGhosts = true;
+    for (vtkIdType loc = this->ItemLocations[item];
+         loc < this->ItemLocations[item + 1]; ++loc)
+    {
+      unsigned char val = this->Ghosts[this->Ids[loc]];
+      if (val & vtkDataSetAttributes::HIDDENPOINT)
+      {
+        return SURFACE_HIDDEN;
+      }
+      if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+      {
+        allGhosts = false;
+      }
+    }
+    return allGhosts ? SURFACE_HIDDEN : SURFACE_POLY;
+  }
+
+  void operator()(vtkIdType bin, vtkIdType endBin) const
+  {
+    SurfaceFaceCompare compare = { this->ItemLocations, this->Ids };
+    for ( ; bin < endBin; ++bin)
+    {
+      vtkIdType *first = this->Bins + this->BinOffsets[bin];
+      vtkIdType *last = this->Bins + this->BinOffsets[bin + 1];
+      if (last - first > 1)
+      {
+        std::sort(first, last, compare);
+      }
+      while (first != last)
+      {
+        vtkIdType *next = first + 1;
+        while (next != last && compare.Compare(*first, *next) == 0)
+        {
+          ++next;
+        }
+        if (next - first == 1)
+        {
+          this->ItemKinds[*first] = this->GetVisibleKind(*first);
+        }
+        else
+        {
+          for ( ; first != next; ++first)
+          {
+            this->ItemKinds[*first] = SURFACE_HIDDEN;
+          }
+        }
+        first = next;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Store the items of a given kind in the output cell order.
+struct SurfaceCompactItems
+{
+  const unsigned char *ItemKinds;
+  unsigned char Kind;
+  const vtkIdType *NewIds;
+  vtkIdType *OutputItems;
+
+  void operator()(vtkIdType item, vtkIdType endItem) const
+  {
+    for ( ; item < endItem; ++item)
+    {
+      if (this->ItemKinds[item] == this->Kind)
+      {
+        this->OutputItems[this->NewIds[item]] = item;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the points used by the output cells. Several threads may flag the
+// same point, but they all write the same value.
+struct SurfaceMarkPoints
+{
+  const vtkIdType *OutputItems;
+  const vtkIdType *ItemLocations;
+  const vtkIdType *Ids;
+  unsigned char *UsedPoints;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      vtkIdType item = this->OutputItems[cellId];
+      for (vtkIdType loc = this->ItemLocations[item];
+           loc < this->ItemLocations[item + 1]; ++loc)
+      {
+        this->UsedPoints[this->Ids[loc]] = 1;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build the map from output to input point ids.
+struct SurfaceCompactPoints
+{
+  const unsigned char *UsedPoints;
+  const vtkIdType *PointMap;
+  vtkIdType *PointIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      if (this->UsedPoints[ptId])
+      {
+        this->PointIds[this->PointMap[ptId]] = ptId;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Fill the connectivity of a range of output cells, given the location of
+// each cell.
+struct SurfaceFillCells
+{
+  const vtkIdType *OutputItems;
+  const vtkIdType *ItemLocations;
+  const vtkIdType *Ids;
+  const vtkIdType *PointMap;
+  const vtkIdType *CellLocations;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      vtkIdType item = this->OutputItems[cellId];
+      vtkIdType *cellPts = this->Connectivity + this->CellLocations[cellId];
+      *cellPts++ = this->ItemLocations[item + 1] - this->ItemLocations[item];
+      for (vtkIdType loc = this->ItemLocations[item];
+           loc < this->ItemLocations[item + 1]; ++loc)
+      {
+        *cellPts++ = this->PointMap[this->Ids[loc]];
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build a cell array from numCells output cells.
+vtkSmartPointer<vtkCellArray> BuildSurfaceCells(const vtkIdType *outputItems,
+                                                vtkIdType numCells,
+                                                const vtkIdType *itemLocations,
+                                                const vtkIdType *ids,
+                                                const vtkIdType *pointMap)
+{
+  std::vector<vtkIdType> cellLocations(numCells + 1, 0);
+  vtkSMPTools::Transform(outputItems, outputItems + numCells,
+                         cellLocations.begin(), [itemLocations](vtkIdType item)
+  {
+    return itemLocations[item + 1] - itemLocations[item] + 1;
+  });
+  vtkSMPTools::ExclusiveScan(cellLocations.begin(), cellLocations.end(),
+                             cellLocations.begin(), static_cast<vtkIdType>(0));
+
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(cellLocations[numCells]);
+  SurfaceFillCells fill = { outputItems, itemLocations, ids, pointMap,
+                            cellLocations.data(),
+                            connectivity->GetPointer(0) };
+  vtkSMPTools::For(0, numCells, fill);
+
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetCells(numCells, connectivity);
+  return cells;
+}
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+int vtkDataSetSurfaceFilter::ParallelUnstructuredGridExecute(
+  vtkUnstructuredGrid *input, vtkPolyData *output)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCellSubsetHelper cells(input);
+
+  // Count the items of each cell and give up if some cells are not handled.
+  std::vector<vtkIdType> itemOffsets(numCells + 1, 0);
+  std::vector<vtkIdType> idOffsets(numCells + 1, 0);
+  SurfaceCountItems countItems;
+  countItems.Cells = &cells;
+  countItems.Input = input;
+  countItems.NumberOfItems = itemOffsets.data();
+  countItems.NumberOfIds = idOffsets.data();
+  vtkSMPTools::For(0, numCells, countItems);
+  if (countItems.Flags & SurfaceCountItems::UNSUPPORTED)
+  {
+    vtkDebugMacro("Some cells are not handled in parallel, using the serial "
+                  "path.");
+    return 0;
+  }
+  this->UpdateProgress(0.1);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+  vtkSMPTools::ExclusiveScan(itemOffsets.begin(), itemOffsets.end(),
+                             itemOffsets.begin(), static_cast<vtkIdType>(0));
+  vtkSMPTools::ExclusiveScan(idOffsets.begin(), idOffsets.end(),
+                             idOffsets.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numItems = itemOffsets[numCells];
+
+  // Store the items.
+  std::vector<vtkIdType> itemCells(numItems);
+  std::vector<vtkIdType> itemLocations(numItems + 1);
+  std::vector<unsigned char> itemKinds(numItems);
+  std::vector<vtkIdType> ids(idOffsets[numCells]);
+  itemLocations[numItems] = idOffsets[numCells];
+  SurfaceFillItems fillItems;
+  fillItems.Cells = &cells;
+  fillItems.Input = input;
+  fillItems.ItemOffsets = itemOffsets.data();
+  fillItems.IdOffsets = idOffsets.data();
+  fillItems.ItemCells = itemCells.data();
+  fillItems.ItemLocations = itemLocations.data();
+  fillItems.ItemKinds = itemKinds.data();
+  fillItems.Ids = ids.data();
+  vtkSMPTools::For(0, numCells, fillItems);
+  std::vector<vtkIdType>().swap(itemOffsets);
+  std::vector<vtkIdType>().swap(idOffsets);
+  this->UpdateProgress(0.3);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // Bin the faces by their first point and match them.
+  {
+    std::vector<vtkAtomic<vtkIdType> > binSizes(numPts);
+    SurfaceCountBins countBins = { itemLocations.data(), itemKinds.data(),
+                                   ids.data(), binSizes.data() };
+    vtkSMPTools::For(0, numItems, countBins);
+    std::vector<vtkIdType> binOffsets(numPts + 1, 0);
+    vtkSMPTools::Transform(binSizes.begin(), binSizes.end(),
+                           binOffsets.begin(),
+                           [](const vtkAtomic<vtkIdType> &size)
+    {
+      return static_cast<vtkIdType>(size);
+    });
+    vtkSMPTools::ExclusiveScan(binOffsets.begin(), binOffsets.end(),
+                               binOffsets.begin(), static_cast<vtkIdType>(0));
+    std::vector<vtkIdType> bins(binOffsets[numPts]);
+    SurfaceFillBins fillBins = { itemLocations.data(), itemKinds.data(),
+                                 ids.data(), binOffsets.data(),
+                                 binSizes.data(), bins.data() };
+    vtkSMPTools::For(0, numItems, fillBins);
+
+    vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+    SurfaceMatchFaces matchFaces = { itemLocations.data(), ids.data(),
+                                     binOffsets.data(),
+                                     ghosts ? ghosts->GetPointer(0) : nullptr,
+                                     bins.data(), itemKinds.data() };
+    vtkSMPTools::For(0, numPts, matchFaces);
+  }
+  this->UpdateProgress(0.6);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // Order the output cells: verts, lines and polygons, each in the order of
+  // the input cells.
+  vtkIdType numNewCells[4] = { 0, 0, 0, 0 };
+  std::vector<vtkIdType> outputItems;
+  {
+    std::vector<vtkIdType> newIds(numItems + 1, 0);
+    for (int kind = SURFACE_VERT; kind <= SURFACE_POLY; ++kind)
+    {
+      if ((kind == SURFACE_VERT &&
+           !(countItems.Flags & SurfaceCountItems::HAS_VERTS)) ||
+          (kind == SURFACE_LINE &&
+           !(countItems.Flags & SurfaceCountItems::HAS_LINES)))
+      {
+        continue;
+      }
+      vtkSMPTools::Transform(itemKinds.begin(), itemKinds.end(),
+                             newIds.begin(), [kind](unsigned char itemKind)
+      {
+        return static_cast<vtkIdType>(itemKind == kind ? 1 : 0);
+      });
+      vtkSMPTools::ExclusiveScan(newIds.begin(), newIds.end(), newIds.begin(),
+        static_cast<vtkIdType>(outputItems.size()));
+      vtkIdType begin = static_cast<vtkIdType>(outputItems.size());
+      numNewCells[kind] = newIds[numItems] - begin;
+      outputItems.resize(newIds[numItems]);
+      SurfaceCompactItems compact = { itemKinds.data(),
+                                      static_cast<unsigned char>(kind),
+                                      newIds.data(), outputItems.data() };
+      vtkSMPTools::For(0, numItems, compact);
+    }
+  }
+  const vtkIdType numOutputCells = static_cast<vtkIdType>(outputItems.size());
+
+  // Number the used points in the input order.
+  std::vector<unsigned char> usedPoints(numPts, 0);
+  SurfaceMarkPoints markPoints = { outputItems.data(), itemLocations.data(),
+                                   ids.data(), usedPoints.data() };
+  vtkSMPTools::For(0, numOutputCells, markPoints);
+  std::vector<vtkIdType> pointMap(numPts);
+  vtkSMPTools::ExclusiveScan(usedPoints.begin(), usedPoints.end(),
+                             pointMap.begin(), static_cast<vtkIdType>(0));
+  const vtkIdType numNewPts = (numPts > 0 ?
+    pointMap[numPts - 1] + usedPoints[numPts - 1] : 0);
+  std::vector<vtkIdType> pointIds(numNewPts);
+  SurfaceCompactPoints compactPoints = { usedPoints.data(), pointMap.data(),
+                                         pointIds.data() };
+  vtkSMPTools::For(0, numPts, compactPoints);
+  this->UpdateProgress(0.7);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
+
+  // Build the output cells.
+  const vtkIdType *outputItemsPtr = outputItems.data();
+  vtkSmartPointer<vtkCellArray> newCells[4];
+  for (int kind = SURFACE_VERT; kind <= SURFACE_POLY; ++kind)
+  {
+    newCells[kind] = BuildSurfaceCells(outputItemsPtr, numNewCells[kind],
+                                       itemLocations.data(), ids.data(),
+                                       pointMap.data());
+    outputItemsPtr += numNewCells[kind];
+  }
+
+  // Copy the points and the attributes.
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(input->GetPoints()->GetDataType());
+  vtkCellSubsetHelper::CopyPoints(input, numNewPts, pointIds.data(), newPts);
+  output->SetPoints(newPts);
+  output->SetPolys(newCells[SURFACE_POLY]);
+  if (numNewCells[SURFACE_VERT] > 0)
+  {
+    output->SetVerts(newCells[SURFACE_VERT]);
+  }
+  if (numNewCells[SURFACE_LINE] > 0)
+  {
+    output->SetLines(newCells[SURFACE_LINE]);
+  }
+
+  vtkPointData *outputPD = output->GetPointData();
+  outputPD->CopyGlobalIdsOn();
+  vtkCellSubsetHelper::CopyData(input->GetPointData(), outputPD, numNewPts,
+                                pointIds.data());
+
+  vtkNew<vtkIdTypeArray> originalCellIds;
+  originalCellIds->SetName(this->GetOriginalCellIdsName());
+  originalCellIds->SetNumberOfValues(numOutputCells);
+  const vtkIdType *itemCellsPtr = itemCells.data();
+  vtkSMPTools::Transform(outputItems.begin(), outputItems.end(),
+                         originalCellIds->GetPointer(0),
+                         [itemCellsPtr](vtkIdType item)
+  {
+    return itemCellsPtr[item];
+  });
+  vtkCellData *outputCD = output->GetCellData();
+  outputCD->CopyGlobalIdsOn();
+  vtkCellSubsetHelper::CopyData(input->GetCellData(), outputCD,
+                                numOutputCells, originalCellIds->GetPointer(0));
+  if (this->PassThroughCellIds)
+  {
+    outputCD->AddArray(originalCellIds);
+  }
+  if (this->PassThroughPointIds)
+  {
+    vtkNew<vtkIdTypeArray> originalPointIds;
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfValues(numNewPts);
+    std::copy(pointIds.begin(), pointIds.end(),
+              originalPointIds->GetPointer(0));
+    outputPD->AddArray(originalPointIds);
+  }
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  return 1;
+}
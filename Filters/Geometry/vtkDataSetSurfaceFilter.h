@@ -21,6 +21,10 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * When ParallelExecution is on, the surface of unstructured grids made of
+ * linear cells is extracted in parallel with vtkSMPTools. See
+ * SetParallelExecution() for the differences with the serial output.
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
 */
@@ -35,6 +39,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 
 // Helper structure for hashing faces.
 struct vtkFastGeomQuadStruct
@@ -128,6 +133,24 @@ public:
   vtkGetMacro(NonlinearSubdivisionLevel, int);
   //@}
 
+  //@{
+  /**
+   * If on, the surface of vtkUnstructuredGrid inputs is extracted in
+   * parallel with vtkSMPTools. The faces of the 3D cells are binned by their
+   * smallest point id and matched in parallel, and the output is compacted
+   * with prefix sums. The output cells are the vertices, then the lines,
+   * then the polygons (2D cells and external faces) in the order of the
+   * input cells, and the output points are in the order of the input
+   * points. This output does not depend on the number of threads, but it
+   * is not ordered like the serial one. Grids with nonlinear cells, convex
+   * point sets or cells of other types are processed by the serial path.
+   * Off by default, which keeps the output order of previous versions.
+   */
+  vtkSetMacro(ParallelExecution, vtkTypeBool);
+  vtkGetMacro(ParallelExecution, vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution, vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Direct access methods that can be used to use the this class as an
@@ -170,6 +193,16 @@ public:
 #endif
   //@}
 
+  /**
+   * Parallel implementation of UnstructuredGridExecute(), used when
+   * ParallelExecution is on. Returns 0 without modifying the output when
+   * the input has cells it does not handle. The progress is reported and
+   * the abort is checked between the parallel passes, on the calling
+   * thread; an aborted execution returns 1 with an empty output.
+   */
+  virtual int ParallelUnstructuredGridExecute(vtkUnstructuredGrid *input,
+                                              vtkPolyData *output);
+
 protected:
   vtkDataSetSurfaceFilter();
   ~vtkDataSetSurfaceFilter() override;
@@ -266,6 +299,8 @@ protected:
 
   int NonlinearSubdivisionLevel;
 
+  vtkTypeBool ParallelExecution;
+
 private:
   vtkDataSetSurfaceFilter(const vtkDataSetSurfaceFilter&) = delete;
   void operator=(const vtkDataSetSurfaceFilter&) = delete;
@@ -0,0 +1,196 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDepthSortPolyDataCoherence.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkDepthSortPolyData, which keeps the cell centers and the
+// order of its last sort, sorts the cells by depth as the camera moves, when
+// the input changes and when the sort mode changes.
+
+#include "vtkCamera.h"
+#include "vtkCellData.h"
+#include "vtkDepthSortPolyData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// The center of the cell used by the given sort mode.
+void GetCenter(vtkPolyData *pd, vtkIdType cid, int mode, double center[3])
+{
+  vtkIdType npts;
+  vtkIdType *pts;
+  pd->GetCellPoints(cid, npts, pts);
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+                       -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  double sum[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    double x[3];
+    pd->GetPoint(pts[i], x);
+    if (i == 0 && mode == vtkDepthSortPolyData::VTK_SORT_FIRST_POINT)
+    {
+      std::copy(x, x + 3, center);
+      return;
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+      bounds[2 * k] = std::min(bounds[2 * k], x[k]);
+      bounds[2 * k + 1] = std::max(bounds[2 * k + 1], x[k]);
+      sum[k] += x[k] / npts;
+    }
+  }
+  for (int k = 0; k < 3; ++k)
+  {
+    // the parametric center of a triangle is its centroid
+    center[k] = mode == vtkDepthSortPolyData::VTK_SORT_BOUNDS_CENTER ?
+      0.5 * (bounds[2 * k] + bounds[2 * k + 1]) : sum[k];
+  }
+}
+
+// Checks that the output cells are a permutation of the input cells, in
+// the order of the depths of their centers along the view direction.
+bool CheckOrder(vtkDepthSortPolyData *sorter, vtkPolyData *input,
+                vtkCamera *camera)
+{
+  sorter->Update();
+  vtkPolyData *output = sorter->GetOutput();
+  output->BuildCells();
+  vtkIdTypeArray *original = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("originalCellIds"));
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (!original || original->GetNumberOfTuples() != numCells ||
+      output->GetNumberOfCells() != numCells)
+  {
+    std::cerr << "Bad number of sorted cells." << std::endl;
+    return false;
+  }
+
+  double origin[3], direction[3];
+  camera->GetPosition(origin);
+  camera->GetDirectionOfProjection(direction);
+  int mode = sorter->GetDepthSortMode();
+  double sign =
+    sorter->GetDirection() == vtkDepthSortPolyData::VTK_DIRECTION_FRONT_TO_BACK ?
+    1.0 : -1.0;
+
+  std::vector<bool> seen(numCells, false);
+  double last = -VTK_DOUBLE_MAX;
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    vtkIdType cid = original->GetValue(i);
+    if (cid < 0 || cid >= numCells || seen[cid])
+    {
+      std::cerr << "The sorted cells are not a permutation." << std::endl;
+      return false;
+    }
+    seen[cid] = true;
+
+    double center[3];
+    GetCenter(input, cid, mode, center);
+    double depth = sign * ((center[0] - origin[0]) * direction[0] +
+                           (center[1] - origin[1]) * direction[1] +
+                           (center[2] - origin[2]) * direction[2]);
+    // the keys are float since the points are float
+    if (depth < last - 1e-5)
+    {
+      std::cerr << "Cell " << cid << " sorted at " << i << " with depth "
+                << depth << " after depth " << last << " (mode " << mode
+                << ")." << std::endl;
+      return false;
+    }
+    last = std::max(last, depth);
+
+    vtkIdType npts, onpts;
+    vtkIdType *pts, *opts;
+    input->GetCellPoints(cid, npts, pts);
+    output->GetCellPoints(i, onpts, opts);
+    if (npts != onpts || !std::equal(pts, pts + npts, opts))
+    {
+      std::cerr << "Output cell " << i << " is not input cell " << cid << "."
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestDepthSortPolyDataCoherence(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(300);
+  sphere->Update();
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+  input->BuildCells();
+
+  vtkNew<vtkCamera> camera;
+  camera->SetPosition(0.0, 0.0, 3.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+
+  vtkNew<vtkDepthSortPolyData> sorter;
+  sorter->SetInputData(input);
+  sorter->SetCamera(camera);
+  sorter->SortScalarsOn();
+
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    sorter->SetDepthSortMode(mode);
+    for (int dir = 0; dir < 2; ++dir)
+    {
+      sorter->SetDirection(dir);
+      if (!CheckOrder(sorter, input, camera))
+      {
+        return EXIT_FAILURE;
+      }
+
+      // small camera moves, where the cells are already nearly sorted
+      for (int i = 0; i < 10; ++i)
+      {
+        camera->Azimuth(1.0);
+        camera->Elevation(0.5);
+        camera->OrthogonalizeViewUp();
+        if (!CheckOrder(sorter, input, camera))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // the centers are recomputed when the input changes
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    points->SetPoint(i, x[0] + 0.5 * x[1] * x[1], x[1], x[2] - x[0]);
+  }
+  points->Modified();
+  if (!CheckOrder(sorter, input, camera))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -41,29 +41,36 @@
 #include "vtkIdTypeArray.h"
 #include "vtkDataArray.h"
 
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSortDataArray.h"
+
 #include <algorithm>
 #include <limits>
 #include <cstdlib>
+#include <vector>
 
 namespace {
 
-template <typename T>
-struct greaterf
-{
-  greaterf(const T *az): z(az) {}
-  bool operator()(vtkIdType l, vtkIdType r) const
-  { return z[l] > z[r]; }
-  const T *z;
-};
+// The number of cells below which their centers and depths are computed by
+// the calling thread alone, since the threads would cost more than they save.
+const vtkIdType VTK_DSPD_SMP_THRESHOLD = 10000;
 
-template <typename T>
-struct lessf
+// Run functor(begin, end) over the n cells, in parallel if they are numerous
+// enough.
+template <typename Functor>
+void forEachCell(vtkIdType n, Functor &functor)
 {
-  lessf(const T *az): z(az) {}
-  bool operator()(vtkIdType l, vtkIdType r) const
-  { return z[l] < z[r]; }
-  const T *z;
-};
+  if (n < VTK_DSPD_SMP_THRESHOLD)
+  {
+    functor(0, n);
+  }
+  else
+  {
+    vtkSMPTools::For(0, n, functor);
+  }
+}
 
 template <typename T>
 T getCellBoundsCenter(vtkIdType *pids, vtkIdType nPids, const T *px)
@@ -79,115 +86,133 @@ T getCellBoundsCenter(vtkIdType *pids, vtkIdType nPids, const T *px)
   return (mn + mx)/T(2);
 }
 
-template <typename T>
-void getCellCenterDepth(vtkPolyData *pds, vtkDataArray *gpts,
-    vtkIdType nCells, double *origin, double *direction, T *&depth)
+// computes the first point or the center of the bounds of the cells, whose
+// points are got with the fast api once the cells are built
+template <typename T, typename K>
+struct pointCenters
 {
-  if (nCells < 1)
-  {
-    return;
-  }
-
-  T *ppts = static_cast<T*>(gpts->GetVoidPointer(0));
-  T *px = ppts;
-  T *py = ppts + 1;
-  T *pz = ppts + 2;
-
-  // this call insures that BuildCells gets done if it's
-  // needed and we can use the faster GetCellPoints api
-  // that doesn't check
-  if (pds->NeedToBuildCells())
-  {
-    pds->BuildCells();
-  }
+  vtkPolyData *pds;
+  const T *ppts;
+  K *centers;
+  bool firstPoint;
 
-  // compute cell centers
-  T *cx = new T[nCells];
-  T *cy = new T[nCells];
-  T *cz = new T[nCells];
-  for (vtkIdType cid = 0; cid < nCells; ++cid)
+  void operator()(vtkIdType begin, vtkIdType end)
   {
-    // get the cell point ids using the fast api
-    vtkIdType *pids = nullptr;
-    vtkIdType nPids = 0;
-    pds->GetCellPoints(cid, nPids, pids);
-
-    // compute the center of the cell bounds
-    cx[cid] = getCellBoundsCenter(pids, nPids, px);
-    cy[cid] = getCellBoundsCenter(pids, nPids, py);
-    cz[cid] = getCellBoundsCenter(pids, nPids, pz);
-  }
-
-  // compute the distance to the cell center
-  T x0 = static_cast<T>(origin[0]);
-  T y0 = static_cast<T>(origin[1]);
-  T z0 = static_cast<T>(origin[2]);
-  T vx = static_cast<T>(direction[0]);
-  T vy = static_cast<T>(direction[1]);
-  T vz = static_cast<T>(direction[2]);
-  depth = new T[nCells];
-  for (vtkIdType cid = 0; cid < nCells; ++cid)
-  {
-    depth[cid] = (cx[cid] - x0)*vx + (cy[cid] - y0)*vy + (cz[cid]- z0)*vz;
+    K *center = this->centers + 3*begin;
+    for (vtkIdType cid = begin; cid < end; ++cid, center += 3)
+    {
+      vtkIdType *pids = nullptr;
+      vtkIdType nPids = 0;
+      this->pds->GetCellPoints(cid, nPids, pids);
+      for (int i = 0; i < 3; ++i)
+      {
+        if (this->firstPoint)
+        {
+          center[i] = nPids ? static_cast<K>(this->ppts[3*pids[0] + i]) : K();
+        }
+        else
+        {
+          center[i] = static_cast<K>(
+            getCellBoundsCenter(pids, nPids, this->ppts + i));
+        }
+      }
+    }
   }
+};
 
-  delete [] cx;
-  delete [] cy;
-  delete [] cz;
+template <typename T, typename K>
+void getPointCenters(vtkPolyData *pds, vtkDataArray *gpts, vtkIdType nCells,
+  bool firstPoint, K *centers)
+{
+  pointCenters<T, K> functor;
+  functor.pds = pds;
+  functor.ppts = static_cast<T*>(gpts->GetVoidPointer(0));
+  functor.centers = centers;
+  functor.firstPoint = firstPoint;
+  forEachCell(nCells, functor);
 }
 
-template <typename T>
-void getCellPoint0Depth(vtkPolyData *pds, vtkDataArray *gpts,
-    vtkIdType nCells, double *origin, double *direction, T *&depth)
+// computes the parametric centers of the cells, with a cell and a weight
+// array per thread
+template <typename K>
+struct parametricCenters
 {
-  if (nCells < 1)
-  {
-    return;
+  vtkPolyData *pds;
+  K *centers;
+  int maxCellSize;
+  vtkSMPThreadLocalObject<vtkGenericCell> cell;
+  vtkSMPThreadLocal<std::vector<double> > weight;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *gcell = this->cell.Local();
+    std::vector<double> &w = this->weight.Local();
+    w.resize(this->maxCellSize > 0 ? this->maxCellSize : 1);
+    K *center = this->centers + 3*begin;
+    for (vtkIdType cid = begin; cid < end; ++cid, center += 3)
+    {
+      double x[3] = {0.0};
+      double p[3] = {0.0};
+      this->pds->GetCell(cid, gcell);
+      int subId = gcell->GetParametricCenter(p);
+      gcell->EvaluateLocation(subId, p, x, &w[0]);
+      center[0] = static_cast<K>(x[0]);
+      center[1] = static_cast<K>(x[1]);
+      center[2] = static_cast<K>(x[2]);
+    }
   }
+};
 
-  T *ppts = static_cast<T*>(gpts->GetVoidPointer(0));
-  T *px = ppts;
-  T *py = ppts + 1;
-  T *pz = ppts + 2;
+template <typename K>
+void getParametricCenters(vtkPolyData *pds, vtkIdType nCells, K *centers)
+{
+  parametricCenters<K> functor;
+  functor.pds = pds;
+  functor.centers = centers;
+  functor.maxCellSize = pds->GetMaxCellSize();
+  forEachCell(nCells, functor);
+}
 
-  // this call insures that BuildCells gets done if it's
-  // needed and we can use the faster GetCellPoints api
-  if (pds->NeedToBuildCells())
-  {
-    pds->BuildCells();
-  }
+// computes the depths of the centers of the cells in the given order
+template <typename K>
+struct centerDepths
+{
+  const K *centers;
+  const vtkIdType *order;
+  K *depth;
+  K origin[3];
+  K direction[3];
 
-  T *cx = new T[nCells];
-  T *cy = new T[nCells];
-  T *cz = new T[nCells];
-  vtkIdType *pids = nullptr;
-  vtkIdType nPids = 0;
-  for (vtkIdType cid = 0; cid < nCells; ++cid)
+  void operator()(vtkIdType begin, vtkIdType end)
   {
-    // get the cell point ids using the fast api
-    pds->GetCellPoints(cid, nPids, pids);
-    vtkIdType ii = pids[0];
-    cx[cid] = px[3*ii];
-    cy[cid] = py[3*ii];
-    cz[cid] = pz[3*ii];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const K *c = this->centers + 3*this->order[i];
+      this->depth[i] = (c[0] - this->origin[0])*this->direction[0]
+        + (c[1] - this->origin[1])*this->direction[1]
+        + (c[2] - this->origin[2])*this->direction[2];
+    }
   }
+};
 
-  // compute the distance to the cell's first point
-  T x0 = static_cast<T>(origin[0]);
-  T y0 = static_cast<T>(origin[1]);
-  T z0 = static_cast<T>(origin[2]);
-  T vx = static_cast<T>(direction[0]);
-  T vy = static_cast<T>(direction[1]);
-  T vz = static_cast<T>(direction[2]);
-  depth = new T[nCells];
-  for (vtkIdType cid = 0; cid < nCells; ++cid)
+// sorts the cells from the given order, by the depth of their centers
+template <typename K>
+void sortCells(vtkIdType nCells, const K *centers, double *origin,
+  double *direction, int dir, vtkIdType *order)
+{
+  std::vector<K> depth(nCells);
+  centerDepths<K> functor;
+  functor.centers = centers;
+  functor.order = order;
+  functor.depth = &depth[0];
+  for (int i = 0; i < 3; ++i)
   {
-    depth[cid] = (cx[cid] - x0)*vx + (cy[cid] - y0)*vy + (cz[cid] - z0)*vz;
+    functor.origin[i] = static_cast<K>(origin[i]);
+    functor.direction[i] = static_cast<K>(direction[i]);
   }
+  forEachCell(nCells, functor);
 
-  delete [] cx;
-  delete [] cy;
-  delete [] cz;
+  vtkSortDataArray::RadixSort(&depth[0], order, nCells, dir);
 }
 };
 
@@ -200,7 +225,11 @@ vtkDepthSortPolyData::vtkDepthSortPolyData() :
   DepthSortMode(VTK_SORT_FIRST_POINT),
   Camera(nullptr), Prop3D(nullptr),
   Transform(vtkTransform::New()),
-  SortScalars(0)
+  SortScalars(0),
+  CellCenters(nullptr),
+  SortedCells(vtkIdTypeArray::New()),
+  CellCentersInput(nullptr),
+  CellCentersMode(VTK_SORT_FIRST_POINT)
 {
   std::fill_n(this->Vector, 3, 0.0);
   std::fill_n(this->Origin, 3, 0.0);
@@ -209,6 +238,12 @@ vtkDepthSortPolyData::vtkDepthSortPolyData() :
 vtkDepthSortPolyData::~vtkDepthSortPolyData()
 {
   this->Transform->Delete();
+  this->SortedCells->Delete();
+
+  if ( this->CellCenters )
+  {
+    this->CellCenters->Delete();
+  }
 
   if ( this->Camera )
   {
@@ -271,97 +306,116 @@ int vtkDepthSortPolyData::RequestData(
   vtkIdType nStrips = input->GetStrips()->GetNumberOfCells();
   vtkIdType nCells = nVerts + nLines + nPolys + nStrips;
 
-  vtkIdType *order = new vtkIdType [nCells];
-  for (vtkIdType cid = 0; cid < nCells; ++cid)
-  {
-    order[cid] = cid;
-  }
-
-  vtkIdTypeArray *newCellIds = nullptr;
-  if (this->SortScalars)
-  {
-    newCellIds = vtkIdTypeArray::New();
-    newCellIds->SetName("sortedCellIds");
-    newCellIds->SetNumberOfTuples(nCells);
-    memcpy(newCellIds->GetPointer(0), order, nCells*sizeof(vtkIdType));
-  }
+  // this call insures that BuildCells gets done if it's
+  // needed and we can use the faster GetCellPoints api
+  // that doesn't check, from several threads
+  if (nCells && tmpInput->NeedToBuildCells())
+  {
+    tmpInput->BuildCells();
+  }
+
+  // the centers are kept until the input or the sort mode changes, with
+  // float precision when the points are float
+  vtkDataArray *pts = tmpInput->GetPoints() ?
+    tmpInput->GetPoints()->GetData() : nullptr;
+  int centerType = (pts && pts->GetDataType() == VTK_FLOAT) ?
+    VTK_FLOAT : VTK_DOUBLE;
+  if ( !this->CellCenters
+    || (this->CellCentersInput != input)
+    || (this->CellCentersTime < input->GetMTime())
+    || (this->CellCentersMode != this->DepthSortMode)
+    || (this->CellCenters->GetDataType() != centerType)
+    || (this->CellCenters->GetNumberOfTuples() != nCells) )
+  {
+    if (this->CellCenters)
+    {
+      this->CellCenters->Delete();
+    }
+    this->CellCenters = vtkDataArray::CreateDataArray(centerType);
+    this->CellCenters->SetNumberOfComponents(3);
+    this->CellCenters->SetNumberOfTuples(nCells);
+    this->CellCentersInput = input;
+    this->CellCentersMode = this->DepthSortMode;
 
-  if (nCells)
-  {
-    if ((this->DepthSortMode == VTK_SORT_FIRST_POINT)
-      || (this->DepthSortMode == VTK_SORT_BOUNDS_CENTER))
+    if (nCells)
     {
-      vtkDataArray *pts = tmpInput->GetPoints()->GetData();
-      switch (pts->GetDataType())
+      if ((this->DepthSortMode == VTK_SORT_FIRST_POINT)
+        || (this->DepthSortMode == VTK_SORT_BOUNDS_CENTER))
       {
-        vtkTemplateMacro(
-
-          // compute the cell's depth
-          VTK_TT *depth = nullptr;
-          if (this->DepthSortMode == VTK_SORT_FIRST_POINT)
+        bool firstPoint = (this->DepthSortMode == VTK_SORT_FIRST_POINT);
+        if (centerType == VTK_FLOAT)
+        {
+          ::getPointCenters<float>(tmpInput, pts, nCells, firstPoint,
+            static_cast<float*>(this->CellCenters->GetVoidPointer(0)));
+        }
+        else
+        {
+          double *centers =
+            static_cast<double*>(this->CellCenters->GetVoidPointer(0));
+          switch (pts->GetDataType())
           {
-            ::getCellPoint0Depth(
-              tmpInput, pts, nCells, origin, direction, depth);
+            vtkTemplateMacro(
+              ::getPointCenters<VTK_TT>(
+                tmpInput, pts, nCells, firstPoint, centers);
+              );
           }
-          else
-          {
-            ::getCellCenterDepth(
-              tmpInput, pts, nCells, origin, direction, depth);
-          }
-
-          // sort cell ids by depth
-          if (this->Direction == VTK_DIRECTION_FRONT_TO_BACK)
-          {
-            ::lessf<VTK_TT> comp(depth);
-            std::sort(order, order + nCells, comp);
-          }
-          else
-          {
-            ::greaterf<VTK_TT> comp(depth);
-            std::sort(order, order + nCells, comp);
-          }
-
-          delete [] depth;
-          );
+        }
       }
-    }
-    else // VTK_SORT_PARAMETRIC_CENTER
-    {
-      vtkGenericCell *cell = vtkGenericCell::New();
-
-      double x[3] = {0.0};
-      double p[3] = {0.0};
-
-      size_t maxCellSize = input->GetMaxCellSize();
-      double *weight = new double [maxCellSize];
-      double *depth = new double [nCells];
-
-      for (vtkIdType cid = 0; cid < nCells; ++cid)
+      else // VTK_SORT_PARAMETRIC_CENTER
       {
-        tmpInput->GetCell(cid, cell);
-        int subId = cell->GetParametricCenter(p);
-        cell->EvaluateLocation(subId, p, x, weight);
-
-        // compute the distance
-        depth[cid] = (x[0] - origin[0])*direction[0]
-            + (x[1] - origin[1])*direction[1] + (x[2] - origin[2])*direction[2];
+        if (centerType == VTK_FLOAT)
+        {
+          ::getParametricCenters(tmpInput, nCells,
+            static_cast<float*>(this->CellCenters->GetVoidPointer(0)));
+        }
+        else
+        {
+          ::getParametricCenters(tmpInput, nCells,
+            static_cast<double*>(this->CellCenters->GetVoidPointer(0)));
+        }
       }
+    }
+    this->CellCentersTime.Modified();
 
-      // sort
-      if (this->Direction == VTK_DIRECTION_FRONT_TO_BACK)
-      {
-        ::lessf<double> comp(depth);
-        std::sort(order, order + nCells, comp);
-      }
-      else
-      {
-        ::greaterf<double> comp(depth);
-        std::sort(order, order + nCells, comp);
-      }
+    // no order to start from
+    this->SortedCells->SetNumberOfTuples(nCells);
+    vtkIdType *order = this->SortedCells->GetPointer(0);
+    for (vtkIdType cid = 0; cid < nCells; ++cid)
+    {
+      order[cid] = cid;
+    }
+  }
+
+  // sort cell ids by depth, starting from the order of the last sort which
+  // small camera moves barely change
+  vtkIdType *order = this->SortedCells->GetPointer(0);
+  if (nCells)
+  {
+    int dir = (this->Direction == VTK_DIRECTION_FRONT_TO_BACK) ? 0 : 1;
+    if (centerType == VTK_FLOAT)
+    {
+      ::sortCells(nCells,
+        static_cast<float*>(this->CellCenters->GetVoidPointer(0)),
+        origin, direction, dir, order);
+    }
+    else
+    {
+      ::sortCells(nCells,
+        static_cast<double*>(this->CellCenters->GetVoidPointer(0)),
+        origin, direction, dir, order);
+    }
+  }
 
-      delete [] weight;
-      delete [] depth;
-      cell->Delete();
+  vtkIdTypeArray *newCellIds = nullptr;
+  if (this->SortScalars)
+  {
+    newCellIds = vtkIdTypeArray::New();
+    newCellIds->SetName("sortedCellIds");
+    newCellIds->SetNumberOfTuples(nCells);
+    vtkIdType *newIds = newCellIds->GetPointer(0);
+    for (vtkIdType cid = 0; cid < nCells; ++cid)
+    {
+      newIds[cid] = cid;
     }
   }
 
@@ -469,15 +523,11 @@ int vtkDepthSortPolyData::RequestData(
     newCellIds->Delete();
 
     vtkIdTypeArray *oldCellIds = vtkIdTypeArray::New();
+    oldCellIds->DeepCopy(this->SortedCells);
     oldCellIds->SetName("originalCellIds");
-    oldCellIds->SetArray(order, nCells, 0, 1);
     output->GetCellData()->AddArray(oldCellIds);
     oldCellIds->Delete();
   }
-  else
-  {
-    delete [] order;
-  }
 
   tmpInput->Delete();
 
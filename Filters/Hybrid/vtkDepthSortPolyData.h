@@ -23,6 +23,11 @@
  * specifying a camera and/or prop to define a view direction; or
  * explicitly set a view direction.
  *
+ * The cell centers are kept until the input or the depth sort mode changes,
+ * and each sort starts from the order of the previous one, so that when
+ * only the camera moves, the filter just computes the depths and sorts
+ * cells that are already nearly in order. Both steps run in parallel.
+ *
  * @warning
  * The sort operation will not work well for long, thin primitives, or cells
  * that intersect, overlap, or interpenetrate each other.
@@ -35,6 +40,8 @@
 #include "vtkPolyDataAlgorithm.h"
 
 class vtkCamera;
+class vtkDataArray;
+class vtkIdTypeArray;
 class vtkProp3D;
 class vtkTransform;
 
@@ -170,6 +177,13 @@ protected:
   double Origin[3];
   vtkTypeBool SortScalars;
 
+  // The cell centers and the order of the last sort
+  vtkDataArray *CellCenters;
+  vtkIdTypeArray *SortedCells;
+  vtkTimeStamp CellCentersTime;
+  vtkPolyData *CellCentersInput; // only compared with the next input
+  int CellCentersMode;
+
 private:
   vtkDepthSortPolyData(const vtkDepthSortPolyData&) = delete;
   void operator=(const vtkDepthSortPolyData&) = delete;
@@ -940,6 +940,19 @@ int vtkPLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   return ret;
 }
 
+//---------------------------------------------------------------------------
+bool vtkPLagrangianParticleTracker::IntegrateInParallel(
+  std::queue<vtkLagrangianParticle*>& particlesQueue,
+  vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput)
+{
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+  {
+    return false;
+  }
+  return this->Superclass::IntegrateInParallel(
+    particlesQueue, particlePathsOutput, interactionOutput);
+}
+
 //---------------------------------------------------------------------------
 void vtkPLagrangianParticleTracker::ReceiveParticles(
   std::queue<vtkLagrangianParticle*>& particleQueue)
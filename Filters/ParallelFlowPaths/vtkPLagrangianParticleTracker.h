@@ -86,6 +86,13 @@ protected:
     vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
     vtkDataObject* interactionOutput) override;
 
+  /**
+   * The particles are integrated concurrently only when running on a
+   * single process, as they are streamed between the domains by Integrate().
+   */
+  bool IntegrateInParallel(std::queue<vtkLagrangianParticle*>& particlesQueue,
+    vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput) override;
+
   void SendParticle(vtkLagrangianParticle* particle);
   void ReceiveParticles(std::queue<vtkLagrangianParticle*>& particleQueue);
 
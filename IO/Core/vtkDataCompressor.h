@@ -28,6 +28,11 @@
  * should be implemented with this in mind to provide a predictable
  * compressor interface for vtkDataCompressor users.
  *
+ * @par Note:
+ * The XML readers and writers compress and uncompress independent blocks
+ * of data in parallel with the same compressor, so CompressBuffer and
+ * UncompressBuffer must be thread safe.
+ *
  * @pat Thanks:
  * Homogeneous CompressionLevel behavior contributed by Quincy Wofford
  * (qwofford@lanl.gov) and John Patchett (patchett@lanl.gov)
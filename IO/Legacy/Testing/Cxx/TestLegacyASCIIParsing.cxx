@@ -0,0 +1,308 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLegacyASCIIParsing.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the ASCII values of the legacy files are read exactly as the
+// stream extraction operators read them, for all the value types and with
+// any number of threads. With -B, it prints the throughput of the reader.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const char *SpecialReals[] = { "0", "-0", "+3.25", ".5", "5.", "1e5",
+  "1E-3", "-2.5e+2", "0.000001", "123456789012345678901234",
+  "0.1234567890123456789012", "9007199254740993", "16777217", "1e22",
+  "1e23", "4.9e-5", "000123.4500", "-0.0e0", "1e10", "1e11", "3e-10",
+  "3.4028234e38", "1.17549435e-38" };
+
+const char *SpecialDoubles[] = { "1.7976931348623157e308",
+  "2.2250738585072014e-308", "4.9406564584124654e-300", "1e-22", "1e-23" };
+
+const char *SpecialIntegers[] = { "0", "-0", "+7", "-1", "127", "-128",
+  "00042", "255" };
+
+const char *Separators[] = { " ", "\t", "\n", "  ", " \n\t " };
+
+// The tokens of an array and the values expected for them.
+struct Array
+{
+  std::string Name;
+  std::string Type;
+  int NumberOfComponents;
+  std::vector<std::string> Tokens;
+};
+
+std::string GenerateReal(vtkMinimalStandardRandomSequence *random,
+                         vtkIdType i, bool isFloat)
+{
+  char buffer[64];
+  random->Next();
+  double value = random->GetRangeValue(-1.0, 1.0);
+  switch (i % 5)
+  {
+    case 0:
+      snprintf(buffer, sizeof(buffer), isFloat ? "%.9g" : "%.17g",
+               value * 1e6);
+      break;
+    case 1:
+      snprintf(buffer, sizeof(buffer), "%g", value * 1e3);
+      break;
+    case 2:
+      snprintf(buffer, sizeof(buffer), "%.6e", value * 1e-12);
+      break;
+    case 3:
+      snprintf(buffer, sizeof(buffer), "%.3f", value * 100.0);
+      break;
+    default:
+      if (!isFloat && (i / 5) % 3 == 0)
+      {
+        return SpecialDoubles[(i / 15) %
+                              (sizeof(SpecialDoubles) / sizeof(char*))];
+      }
+      return SpecialReals[(i / 5) % (sizeof(SpecialReals) / sizeof(char*))];
+  }
+  return buffer;
+}
+
+std::string GenerateInteger(vtkMinimalStandardRandomSequence *random,
+                            vtkIdType i, double minValue, double maxValue)
+{
+  if (i % 7 == 6)
+  {
+    return SpecialIntegers[(i / 7) % (sizeof(SpecialIntegers) /
+                                      sizeof(char*))];
+  }
+  char buffer[64];
+  random->Next();
+  snprintf(buffer, sizeof(buffer), "%.0f",
+           std::floor(random->GetRangeValue(minValue, maxValue)));
+  return buffer;
+}
+
+// Parse the token as vtkDataReader::Read() does.
+template <class T, class StreamT>
+T ParseToken(const std::string &token)
+{
+  std::istringstream is(token);
+  is.imbue(std::locale::classic());
+  StreamT value;
+  is >> value;
+  return static_cast<T>(value);
+}
+
+template <class T, class StreamT>
+bool CompareArray(const Array &array, vtkDataArray *output)
+{
+  if (!output || output->GetNumberOfComponents() != array.NumberOfComponents ||
+      output->GetNumberOfValues() !=
+        static_cast<vtkIdType>(array.Tokens.size()))
+  {
+    cerr << "Bad array " << array.Name << endl;
+    return false;
+  }
+  const T *values = static_cast<const T*>(output->GetVoidPointer(0));
+  for (size_t i = 0; i < array.Tokens.size(); ++i)
+  {
+    T expected = ParseToken<T, StreamT>(array.Tokens[i]);
+    if (memcmp(&expected, values + i, sizeof(T)) != 0)
+    {
+      cerr << "Bad value for " << array.Tokens[i] << " in array "
+           << array.Name << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void AppendTokens(std::string &text, const std::vector<std::string> &tokens)
+{
+  for (size_t i = 0; i < tokens.size(); ++i)
+  {
+    text += tokens[i];
+    text += Separators[i % (sizeof(Separators) / sizeof(char*))];
+  }
+  text += "\n";
+}
+
+} // end anon namespace
+
+int TestLegacyASCIIParsing(int argc, char *argv[])
+{
+  bool benchmark = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "-B"))
+    {
+      benchmark = true;
+    }
+  }
+
+  const vtkIdType numPts = 100000;
+  const vtkIdType numCells = 25000;
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  std::vector<std::string> points(3 * numPts);
+  for (vtkIdType i = 0; i < 3 * numPts; ++i)
+  {
+    points[i] = GenerateReal(random, i, false);
+  }
+  std::vector<std::string> cells;
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    cells.push_back("3");
+    for (int j = 0; j < 3; ++j)
+    {
+      cells.push_back(GenerateInteger(random, 3 * i + j, 0, numPts));
+    }
+  }
+
+  // vtkIdType values are stored as int in the legacy files.
+  std::vector<Array> arrays(10);
+  const char *types[] = { "double", "float", "int", "vtktypeint64",
+    "unsigned_char", "char", "short", "unsigned_int", "unsigned_long",
+    "vtkIdType" };
+  const double ranges[][2] = { { 0, 0 }, { 0, 0 }, { -2147483648.0,
+    2147483647.0 }, { -1e15, 1e15 }, { 0, 255 }, { -128, 127 },
+    { -32768, 32767 }, { 0, 4294967295.0 }, { 0, 4294967295.0 },
+    { -2147483648.0, 2147483647.0 } };
+  for (int a = 0; a < 10; ++a)
+  {
+    arrays[a].Name = std::string("Array_") + types[a];
+    arrays[a].Type = types[a];
+    arrays[a].NumberOfComponents = (a % 3) + 1;
+    vtkIdType numValues = numPts * arrays[a].NumberOfComponents;
+    for (vtkIdType i = 0; i < numValues; ++i)
+    {
+      arrays[a].Tokens.push_back(a < 2 ?
+        GenerateReal(random, i, a == 1) :
+        GenerateInteger(random, i, ranges[a][0], ranges[a][1]));
+    }
+  }
+
+  std::ostringstream header;
+  header << "# vtk DataFile Version 3.0\nASCII parsing\nASCII\n"
+         << "DATASET UNSTRUCTURED_GRID\nPOINTS " << numPts << " double\n";
+  std::string text = header.str();
+  AppendTokens(text, points);
+  std::ostringstream cellsHeader;
+  cellsHeader << "CELLS " << numCells << " " << 4 * numCells << "\n";
+  text += cellsHeader.str();
+  AppendTokens(text, cells);
+  std::ostringstream cellTypes;
+  cellTypes << "CELL_TYPES " << numCells << "\n";
+  text += cellTypes.str();
+  AppendTokens(text, std::vector<std::string>(numCells, "5"));
+  std::ostringstream pointData;
+  pointData << "POINT_DATA " << numPts << "\nFIELD FieldData "
+            << arrays.size() << "\n";
+  text += pointData.str();
+  for (size_t a = 0; a < arrays.size(); ++a)
+  {
+    std::ostringstream arrayHeader;
+    arrayHeader << arrays[a].Name << " " << arrays[a].NumberOfComponents
+                << " " << numPts << " " << arrays[a].Type << "\n";
+    text += arrayHeader.str();
+    AppendTokens(text, arrays[a].Tokens);
+  }
+
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(numThreads[t]);
+    vtkNew<vtkUnstructuredGridReader> reader;
+    reader->ReadFromInputStringOn();
+    reader->SetInputString(text);
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+    if (benchmark)
+    {
+      cout << "Read " << text.size() / 1048576.0 << " MB with "
+           << vtkSMPTools::GetEstimatedNumberOfThreads() << " thread(s) at "
+           << text.size() / 1048576.0 / timer->GetElapsedTime() << " MB/s"
+           << endl;
+    }
+
+    vtkUnstructuredGrid *output = reader->GetOutput();
+    if (output->GetNumberOfPoints() != numPts ||
+        output->GetNumberOfCells() != numCells)
+    {
+      cerr << "Bad number of points or cells with " << numThreads[t]
+           << " thread(s)." << endl;
+      return EXIT_FAILURE;
+    }
+    Array pointsArray;
+    pointsArray.Name = "Points";
+    pointsArray.NumberOfComponents = 3;
+    pointsArray.Tokens = points;
+    Array cellsArray;
+    cellsArray.Name = "Cells";
+    cellsArray.NumberOfComponents = 1;
+    cellsArray.Tokens = cells;
+    vtkPointData *pd = output->GetPointData();
+    if (!CompareArray<double, double>(pointsArray,
+                                      output->GetPoints()->GetData()) ||
+        !CompareArray<vtkIdType, int>(cellsArray,
+                                            output->GetCells()->GetData()) ||
+        !CompareArray<double, double>(arrays[0],
+                                      pd->GetArray(arrays[0].Name.c_str())) ||
+        !CompareArray<float, float>(arrays[1],
+                                    pd->GetArray(arrays[1].Name.c_str())) ||
+        !CompareArray<int, int>(arrays[2],
+                                pd->GetArray(arrays[2].Name.c_str())) ||
+        !CompareArray<vtkTypeInt64, vtkTypeInt64>(arrays[3],
+                                    pd->GetArray(arrays[3].Name.c_str())) ||
+        !CompareArray<unsigned char, int>(arrays[4],
+                                    pd->GetArray(arrays[4].Name.c_str())) ||
+        !CompareArray<char, int>(arrays[5],
+                                 pd->GetArray(arrays[5].Name.c_str())) ||
+        !CompareArray<short, short>(arrays[6],
+                                    pd->GetArray(arrays[6].Name.c_str())) ||
+        !CompareArray<unsigned int, unsigned int>(arrays[7],
+                                    pd->GetArray(arrays[7].Name.c_str())) ||
+        !CompareArray<unsigned long, unsigned long>(arrays[8],
+                                    pd->GetArray(arrays[8].Name.c_str())) ||
+        !CompareArray<vtkIdType, int>(arrays[9],
+                                      pd->GetArray(arrays[9].Name.c_str())))
+    {
+      cerr << "Bad values read with " << numThreads[t] << " thread(s)."
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
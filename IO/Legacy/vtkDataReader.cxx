@@ -43,6 +43,7 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
@@ -58,8 +59,13 @@
 
 #include <vtksys/SystemTools.hxx>
 
-#include <sstream>
+#include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <vector>
 
 // I need a safe way to read a line of arbitrary length.  It exists on
 // some platforms but not others so I'm afraid I have to write it
@@ -1420,24 +1426,490 @@ int vtkReadBinaryData(istream *IS, T *data, vtkIdType numTuples, vtkIdType numCo
   return 1;
 }
 
+namespace
+{
+
+// Locale independent parsing of the ASCII values of the legacy format. The
+// values are read from the input stream by large chunks, which are parsed
+// in parallel. The values parsed are the same as the ones given by the
+// stream extraction operators used by vtkDataReader::Read().
+
+// The characters separating the values, as isspace() in the "C" locale.
+inline bool vtkDataReaderIsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+    c == '\f';
+}
+
+// The type extracted from the stream for each value type: vtkDataReader
+// reads the values of the char types as integers.
+template <class T>
+struct vtkDataReaderStreamType
+{
+  typedef T Type;
+};
+template <>
+struct vtkDataReaderStreamType<char>
+{
+  typedef int Type;
+};
+template <>
+struct vtkDataReaderStreamType<signed char>
+{
+  typedef int Type;
+};
+template <>
+struct vtkDataReaderStreamType<unsigned char>
+{
+  typedef int Type;
+};
+
+// A stream buffer reading a token in place.
+class vtkDataReaderTokenBuffer : public std::streambuf
+{
+public:
+  void SetToken(const char *begin, const char *end)
+  {
+    this->setg(const_cast<char*>(begin), const_cast<char*>(begin),
+               const_cast<char*>(end));
+  }
+};
+
+// Slow path: parse the token with a stream in the "C" locale, as
+// vtkDataReader::Read() does.
+class vtkDataReaderTokenStream
+{
+public:
+  vtkDataReaderTokenStream() : Stream(&this->Buffer)
+  {
+    this->Stream.imbue(std::locale::classic());
+  }
+
+  template <class T>
+  bool Parse(const char *begin, const char *end, T &value)
+  {
+    this->Buffer.SetToken(begin, end);
+    this->Stream.clear();
+    typename vtkDataReaderStreamType<T>::Type streamValue;
+    this->Stream >> streamValue;
+    if (this->Stream.fail() ||
+        this->Stream.peek() != std::char_traits<char>::eof())
+    {
+      return false;
+    }
+    value = static_cast<T>(streamValue);
+    return true;
+  }
+
+private:
+  vtkDataReaderTokenBuffer Buffer;
+  std::istream Stream;
+};
+
+// Parse an integer token made of an optional sign and at most 18 digits,
+// within the range of the type. Returns false for the other tokens, which
+// are left to the stream.
+template <class T>
+bool vtkDataReaderParseInteger(const char *begin, const char *end, T &value)
+{
+  typedef typename vtkDataReaderStreamType<T>::Type StreamType;
+  const char *p = begin;
+  bool negative = false;
+  if (*p == '-' || *p == '+')
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end || end - p > 18 ||
+      (negative && !std::numeric_limits<StreamType>::is_signed))
+  {
+    return false;
+  }
+  long long magnitude = 0;
+  for ( ; p != end; ++p)
+  {
+    unsigned int digit = static_cast<unsigned int>(*p - '0');
+    if (digit > 9)
+    {
+      return false;
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+  long long result = negative ? -magnitude : magnitude;
+  if (result < static_cast<long long>(
+        std::numeric_limits<StreamType>::min()) ||
+      (result > 0 && static_cast<unsigned long long>(result) >
+        static_cast<unsigned long long>(
+          std::numeric_limits<StreamType>::max())))
+  {
+    return false;
+  }
+  value = static_cast<T>(static_cast<StreamType>(result));
+  return true;
+}
+
+// Compute significand * 10^exponent in the wider type W, with a single
+// rounding, and round it to T. This is the correctly rounded value unless
+// the value in W is exactly halfway between two values of T, in which case
+// false is returned.
+template <class T, class W>
+bool vtkDataReaderParseWider(unsigned long long significand, int exponent,
+                             T &value)
+{
+  static const W powersOf10[] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L,
+    1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L,
+    1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L };
+  const int digits = std::numeric_limits<W>::digits;
+  const int maxExponent = digits >= 64 ? 27 : 22;
+  if (digits <= std::numeric_limits<T>::digits ||
+      (digits < 64 && significand > (1ULL << (digits < 64 ? digits : 0))) ||
+      exponent < -maxExponent || exponent > maxExponent)
+  {
+    return false;
+  }
+  W result = static_cast<W>(significand);
+  if (exponent < 0)
+  {
+    result /= powersOf10[-exponent];
+  }
+  else
+  {
+    result *= powersOf10[exponent];
+  }
+  int binaryExponent;
+  W scaled = std::ldexp(std::frexp(result, &binaryExponent),
+                        std::numeric_limits<T>::digits);
+  if (scaled - std::floor(scaled) == static_cast<W>(0.5))
+  {
+    return false;
+  }
+  value = static_cast<T>(result);
+  return true;
+}
+
+// Parse a real token. When the decimal significand has at most 19 digits
+// and is exactly representable in T, and the power of ten is exactly
+// representable too, the correctly rounded value is given by a single
+// multiplication or division. Otherwise it is computed in a wider type when
+// possible. Returns false for the other tokens, which are left to the
+// stream.
+template <class T>
+bool vtkDataReaderParseReal(const char *begin, const char *end, T &value)
+{
+  static const T powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22 };
+  const int maxExponent = std::numeric_limits<T>::digits > 24 ? 22 : 10;
+  const unsigned long long maxSignificand =
+    1ULL << std::numeric_limits<T>::digits;
+
+  const char *p = begin;
+  bool negative = false;
+  if (*p == '-' || *p == '+')
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  unsigned long long significand = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  for ( ; p != end && static_cast<unsigned int>(*p - '0') <= 9; ++p)
+  {
+    hasDigits = true;
+    if (significand != 0 || *p != '0')
+    {
+      significand = significand * 10 + static_cast<unsigned int>(*p - '0');
+      ++numDigits;
+    }
+  }
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && static_cast<unsigned int>(*p - '0') <= 9; ++p)
+    {
+      hasDigits = true;
+      if (significand != 0 || *p != '0')
+      {
+        significand = significand * 10 + static_cast<unsigned int>(*p - '0');
+        ++numDigits;
+      }
+      --exponent;
+    }
+  }
+  if (hasDigits && p != end && (*p == 'e' || *p == 'E'))
+  {
+    const char *exponentBegin = ++p;
+    bool negativeExponent = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+      negativeExponent = (*p == '-');
+      ++p;
+    }
+    const char *exponentDigits = p;
+    int exponentValue = 0;
+    for ( ; p != end && static_cast<unsigned int>(*p - '0') <= 9 &&
+          p - exponentBegin < 6; ++p)
+    {
+      exponentValue = exponentValue * 10 + (*p - '0');
+    }
+    hasDigits = (p != exponentDigits);
+    exponent += negativeExponent ? -exponentValue : exponentValue;
+  }
+  if (!hasDigits || p != end || numDigits > 19)
+  {
+    return false;
+  }
+  if (significand > maxSignificand ||
+      exponent < -maxExponent || exponent > maxExponent)
+  {
+    T result;
+    if (!vtkDataReaderParseWider<T, double>(significand, exponent, result) &&
+        !vtkDataReaderParseWider<T, long double>(significand, exponent,
+                                                 result))
+    {
+      return false;
+    }
+    value = negative ? -result : result;
+    return true;
+  }
+  T result = static_cast<T>(significand);
+  if (exponent < 0)
+  {
+    result /= powersOf10[-exponent];
+  }
+  else
+  {
+    result *= powersOf10[exponent];
+  }
+  value = negative ? -result : result;
+  return true;
+}
+
+inline bool vtkDataReaderParseValue(const char *begin, const char *end,
+                                    float &value)
+{
+  return vtkDataReaderParseReal(begin, end, value);
+}
+
+inline bool vtkDataReaderParseValue(const char *begin, const char *end,
+                                    double &value)
+{
+  return vtkDataReaderParseReal(begin, end, value);
+}
+
+template <class T>
+bool vtkDataReaderParseValue(const char *begin, const char *end, T &value)
+{
+  return vtkDataReaderParseInteger(begin, end, value);
+}
+
+// Parse at most maxValues values from the text of a segment of the chunk.
+// Returns the number of values parsed and sets end to the end of the last
+// token parsed, or returns -1 on error.
+template <class T>
+vtkIdType vtkDataReaderParseSegment(const char *begin, const char *&end,
+                                    T *data, vtkIdType maxValues)
+{
+  vtkDataReaderTokenStream stream;
+  const char *p = begin;
+  const char *lastEnd = begin;
+  vtkIdType numValues = 0;
+  while (numValues < maxValues)
+  {
+    while (p != end && vtkDataReaderIsSpace(*p))
+    {
+      ++p;
+    }
+    if (p == end)
+    {
+      break;
+    }
+    const char *tokenBegin = p;
+    while (p != end && !vtkDataReaderIsSpace(*p))
+    {
+      ++p;
+    }
+    if (!vtkDataReaderParseValue(tokenBegin, p, data[numValues]) &&
+        !stream.Parse(tokenBegin, p, data[numValues]))
+    {
+      return -1;
+    }
+    ++numValues;
+    lastEnd = p;
+  }
+  end = lastEnd;
+  return numValues;
+}
+
+// Count the tokens of a segment of the chunk.
+vtkIdType vtkDataReaderCountTokens(const char *begin, const char *end)
+{
+  vtkIdType numTokens = 0;
+  bool inToken = false;
+  for (const char *p = begin; p != end; ++p)
+  {
+    bool space = vtkDataReaderIsSpace(*p);
+    numTokens += (inToken && space) ? 1 : 0;
+    inToken = !space;
+  }
+  return numTokens + (inToken ? 1 : 0);
+}
+
+// Parse at most maxValues values from the text [begin, end), which ends
+// between two tokens. Large texts are split in segments at whitespace and
+// parsed in parallel: the tokens of each segment are counted first to find
+// where their values go. Returns the number of values parsed and sets end
+// to the end of the last token parsed, or returns -1 on error.
+template <class T>
+vtkIdType vtkDataReaderParseChunk(const char *begin, const char *&end,
+                                  T *data, vtkIdType maxValues)
+{
+  const size_t minSegmentSize = 65536;
+  size_t size = static_cast<size_t>(end - begin);
+  size_t numSegments = std::min(size / minSegmentSize,
+    4 * static_cast<size_t>(vtkSMPTools::GetEstimatedNumberOfThreads()));
+  if (numSegments < 2)
+  {
+    return vtkDataReaderParseSegment(begin, end, data, maxValues);
+  }
+
+  std::vector<const char*> segments(numSegments + 1, end);
+  segments[0] = begin;
+  for (size_t i = 1; i < numSegments; ++i)
+  {
+    const char *p = std::max(begin + i * (size / numSegments), segments[i-1]);
+    while (p != end && !vtkDataReaderIsSpace(*p))
+    {
+      ++p;
+    }
+    segments[i] = p;
+  }
+
+  std::vector<vtkIdType> offsets(numSegments + 1, 0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numSegments),
+    [&](vtkIdType first, vtkIdType last)
+    {
+      for (vtkIdType i = first; i < last; ++i)
+      {
+        offsets[i] = vtkDataReaderCountTokens(segments[i], segments[i+1]);
+      }
+    });
+  vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(), offsets.begin(),
+                             static_cast<vtkIdType>(0));
+
+  std::vector<const char*> segmentEnds(segments.begin() + 1, segments.end());
+  std::vector<vtkIdType> numParsed(numSegments, 0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numSegments),
+    [&](vtkIdType first, vtkIdType last)
+    {
+      for (vtkIdType i = first; i < last; ++i)
+      {
+        if (offsets[i] < maxValues)
+        {
+          numParsed[i] = vtkDataReaderParseSegment(segments[i],
+            segmentEnds[i], data + offsets[i],
+            std::min(offsets[i+1], maxValues) - offsets[i]);
+        }
+      }
+    });
+
+  vtkIdType numValues = 0;
+  for (size_t i = 0; i < numSegments && offsets[i] < maxValues; ++i)
+  {
+    if (numParsed[i] < 0)
+    {
+      return -1;
+    }
+    numValues += numParsed[i];
+    if (numParsed[i] > 0)
+    {
+      end = segmentEnds[i];
+    }
+  }
+  if (numValues == 0)
+  {
+    end = begin;
+  }
+  return numValues;
+}
+
+} // end anonymous namespace
+
 // General templated function to read data of various types.
 template <class T>
 int vtkReadASCIIData(vtkDataReader *self, T *data, vtkIdType numTuples, vtkIdType numComp)
 {
-  vtkIdType i, j;
+  vtkIdType numValues = numTuples * numComp;
+  if (numValues <= 0)
+  {
+    return 1;
+  }
 
-  for (i=0; i<numTuples; i++)
+  // Read the text by chunks, sized for the values left to read. The tokens
+  // of a chunk are parsed up to its last whitespace, the rest is kept for
+  // the next chunk.
+  istream *is = self->GetIStream();
+  std::vector<char> buffer;
+  size_t bufferSize = 0;
+  size_t tokensEnd = 0;
+  vtkIdType numRead = 0;
+  bool endOfInput = false;
+  while (numRead < numValues)
   {
-    for (j=0; j<numComp; j++)
+    if (endOfInput)
+    {
+      vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+        "datasize with declaration.");
+      return 0;
+    }
+    size_t chunkSize = static_cast<size_t>(std::min<vtkIdType>(
+      4194304, 16 * (numValues - numRead) + 4096));
+    buffer.resize(bufferSize + chunkSize);
+    is->read(&buffer[bufferSize], static_cast<std::streamsize>(chunkSize));
+    size_t count = static_cast<size_t>(is->gcount());
+    bufferSize += count;
+    endOfInput = (count < chunkSize);
+    if (endOfInput)
+    {
+      is->clear();
+    }
+
+    size_t end = bufferSize;
+    if (!endOfInput)
     {
-      if ( !self->Read(data++) )
+      while (end > 0 && !vtkDataReaderIsSpace(buffer[end-1]))
       {
-        vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
-          "datasize with declaration.");
-        return 0;
+        --end;
       }
+      if (end == 0)
+      {
+        // A single token in the chunk, read more.
+        continue;
+      }
+    }
+    const char *chunkEnd = buffer.data() + end;
+    vtkIdType numParsed = vtkDataReaderParseChunk(buffer.data(), chunkEnd,
+      data + numRead, numValues - numRead);
+    if (numParsed < 0)
+    {
+      vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+        "datasize with declaration.");
+      return 0;
+    }
+    numRead += numParsed;
+    tokensEnd = static_cast<size_t>(chunkEnd - buffer.data());
+    if (numRead < numValues)
+    {
+      // Keep the text that was not parsed for the next chunk.
+      buffer.erase(buffer.begin(), buffer.begin() + tokensEnd);
+      bufferSize -= tokensEnd;
+      tokensEnd = 0;
     }
   }
+
+  // Give back the text read after the last value.
+  is->seekg(-static_cast<std::streamoff>(bufferSize - tokensEnd),
+            std::ios_base::cur);
   return 1;
 }
 
@@ -3068,14 +3540,11 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data)
   }
   else // ascii
   {
-    for (i=0; i<size; i++)
+    if (!vtkReadASCIIData(this, data, size, 1))
     {
-      if (!this->Read(data+i))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (this->FileName?this->FileName:"(Null FileName)"));
+      return 0;
     }
   }
 
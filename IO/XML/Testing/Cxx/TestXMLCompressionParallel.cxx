@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the compressed output of the XML writers does not depend on
+// the number of threads, and that it is read back correctly with any number
+// of threads, for the whole data and for sub-extents.
+
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLWriter.h"
+
+#include <cmath>
+#include <string>
+
+namespace
+{
+
+bool CompareImages(vtkImageData *expected, vtkImageData *image)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        int ijk[3] = { i, j, k };
+        vtkIdType inId = expected->ComputePointId(ijk);
+        vtkIdType outId = image->ComputePointId(ijk);
+        for (int a = 0; a < expected->GetPointData()->GetNumberOfArrays(); ++a)
+        {
+          vtkDataArray *inArray = expected->GetPointData()->GetArray(a);
+          vtkDataArray *outArray =
+            image->GetPointData()->GetArray(inArray->GetName());
+          if (!outArray)
+          {
+            cerr << "Missing array " << inArray->GetName() << endl;
+            return false;
+          }
+          for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+          {
+            if (inArray->GetComponent(inId, c) !=
+                outArray->GetComponent(outId, c))
+            {
+              cerr << "Bad value in array " << inArray->GetName() << endl;
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestXMLCompressionParallel(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(61, 47, 23);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Double");
+  doubles->SetNumberOfTuples(numPts);
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Int");
+  ints->SetNumberOfComponents(3);
+  ints->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    doubles->SetValue(i, std::sin(0.01 * i) * 1000.0);
+    ints->SetTypedComponent(i, 0, static_cast<int>(i % 97));
+    ints->SetTypedComponent(i, 1, static_cast<int>(i / 13));
+    ints->SetTypedComponent(i, 2, -static_cast<int>(i));
+  }
+  image->GetPointData()->AddArray(doubles);
+  image->GetPointData()->AddArray(ints);
+
+  const int compressors[3] = {
+    vtkXMLWriter::ZLIB, vtkXMLWriter::LZ4, vtkXMLWriter::LZMA };
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  for (int compressor = 0; compressor < 3; ++compressor)
+  {
+    for (int mode = 0; mode < 2; ++mode)
+    {
+      // Write with various numbers of threads and compare the outputs. The
+      // first write only lets the arrays store their ranges in their
+      // information, which is written too.
+      std::string output;
+      for (int t = -1; t < 4; ++t)
+      {
+        vtkSMPTools::Initialize(t < 0 ? 1 : numThreads[t]);
+        vtkNew<vtkXMLImageDataWriter> writer;
+        writer->SetInputData(image);
+        writer->WriteToOutputStringOn();
+        writer->SetCompressorType(compressors[compressor]);
+        writer->SetBlockSize(4096);
+        if (mode == 0)
+        {
+          writer->SetDataModeToAppended();
+        }
+        else
+        {
+          writer->SetDataModeToBinary();
+        }
+        writer->Write();
+        if (t <= 0)
+        {
+          output = writer->GetOutputString();
+        }
+        else if (writer->GetOutputString() != output)
+        {
+          cerr << "Output with " << numThreads[t] << " thread(s) differs "
+               << "for compressor " << compressors[compressor] << endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // Read the whole image and a sub-extent with various numbers of
+      // threads.
+      for (int t = 0; t < 4; ++t)
+      {
+        vtkSMPTools::Initialize(numThreads[t]);
+        vtkNew<vtkXMLImageDataReader> reader;
+        reader->ReadFromInputStringOn();
+        reader->SetInputString(output);
+        reader->Update();
+        if (!CompareImages(image, reader->GetOutput()))
+        {
+          cerr << "Bad image read with " << numThreads[t]
+               << " thread(s) for compressor " << compressors[compressor]
+               << endl;
+          return EXIT_FAILURE;
+        }
+
+        int extent[6] = { 3, 57, 0, 46, 2, 19 };
+        static_cast<vtkAlgorithm*>(reader.GetPointer())->UpdateExtent(extent);
+        if (!CompareImages(image, reader->GetOutput()))
+        {
+          cerr << "Bad sub-extent read with " << numThreads[t]
+               << " thread(s) for compressor " << compressors[compressor]
+               << endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
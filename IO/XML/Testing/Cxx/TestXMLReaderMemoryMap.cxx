@@ -0,0 +1,313 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLReaderMemoryMap.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the XML readers give the same output with and without memory
+// mapping of the appended data, and that modifying the arrays of a mapped
+// output does not modify the file.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkShortArray.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <string>
+
+namespace
+{
+
+template <class ArrayT>
+void AddArray(vtkDataSetAttributes *data, const char *name, int numComps,
+              vtkIdType numTuples)
+{
+  vtkNew<ArrayT> array;
+  array->SetName(name);
+  array->SetNumberOfComponents(numComps);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples * numComps; ++i)
+  {
+    array->SetValue(i, static_cast<typename ArrayT::ValueType>(
+      (i * 7919) % 251 - 17));
+  }
+  data->AddArray(array);
+}
+
+void AddArrays(vtkDataSet *data)
+{
+  const vtkIdType numPts = data->GetNumberOfPoints();
+  const vtkIdType numCells = data->GetNumberOfCells();
+  AddArray<vtkFloatArray>(data->GetPointData(), "Float", 3, numPts);
+  AddArray<vtkDoubleArray>(data->GetPointData(), "Double", 1, numPts);
+  AddArray<vtkShortArray>(data->GetPointData(), "Short", 1, numPts);
+  AddArray<vtkUnsignedCharArray>(data->GetPointData(), "UChar", 3, numPts);
+  AddArray<vtkIntArray>(data->GetCellData(), "Int", 2, numCells);
+  AddArray<vtkIdTypeArray>(data->GetCellData(), "IdType", 1, numCells);
+}
+
+bool CompareAttributes(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(arrayA->GetName());
+    if (!arrayB || arrayA->GetDataTypeSize() != arrayB->GetDataTypeSize() ||
+        arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        arrayA->GetNumberOfComponents() != arrayB->GetNumberOfComponents())
+    {
+      cerr << "Bad array " << arrayA->GetName() << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < arrayA->GetNumberOfTuples(); ++j)
+    {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+      {
+        if (arrayA->GetComponent(j, c) != arrayB->GetComponent(j, c))
+        {
+          cerr << "Bad value in array " << arrayA->GetName() << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkDataSet *a, vtkDataSet *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    cerr << "Bad number of points or cells." << endl;
+    return false;
+  }
+  vtkNew<vtkIdList> cellPtsA;
+  vtkNew<vtkIdList> cellPtsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, cellPtsA);
+    b->GetCellPoints(cellId, cellPtsB);
+    if (a->GetCellType(cellId) != b->GetCellType(cellId) ||
+        cellPtsA->GetNumberOfIds() != cellPtsB->GetNumberOfIds())
+    {
+      cerr << "Bad cell " << cellId << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < cellPtsA->GetNumberOfIds(); ++i)
+    {
+      if (cellPtsA->GetId(i) != cellPtsB->GetId(i))
+      {
+        cerr << "Bad cell " << cellId << endl;
+        return false;
+      }
+    }
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double ptA[3], ptB[3];
+    a->GetPoint(ptId, ptA);
+    b->GetPoint(ptId, ptB);
+    if (ptA[0] != ptB[0] || ptA[1] != ptB[1] || ptA[2] != ptB[2])
+    {
+      cerr << "Bad point " << ptId << endl;
+      return false;
+    }
+  }
+  return CompareAttributes(a->GetPointData(), b->GetPointData()) &&
+    CompareAttributes(a->GetCellData(), b->GetCellData());
+}
+
+// Read fileName with and without memory mapping and compare both outputs
+// with the expected data. Then modify the mapped output and check that the
+// file is unchanged.
+template <class ReaderT>
+bool Check(const std::string &fileName, vtkDataSet *expected)
+{
+  vtkNew<ReaderT> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  if (!Compare(expected, reader->GetOutput()))
+  {
+    cerr << "Bad output without memory mapping." << endl;
+    return false;
+  }
+
+  vtkNew<ReaderT> mapReader;
+  mapReader->SetFileName(fileName.c_str());
+  mapReader->MemoryMapAppendedDataOn();
+  mapReader->Update();
+  if (!Compare(expected, mapReader->GetOutput()))
+  {
+    cerr << "Bad output with memory mapping." << endl;
+    return false;
+  }
+
+  // Reading again replaces the mapped arrays.
+  mapReader->Modified();
+  mapReader->Update();
+  vtkSmartPointer<vtkDataSet> output = mapReader->GetOutput();
+  if (!Compare(expected, output))
+  {
+    cerr << "Bad output when reading again with memory mapping." << endl;
+    return false;
+  }
+
+  vtkPointData *pd = output->GetPointData();
+  for (int i = 0; i < pd->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *array = pd->GetArray(i);
+    for (vtkIdType j = 0; j < array->GetNumberOfTuples(); ++j)
+    {
+      array->SetComponent(j, 0, 1.0);
+    }
+  }
+  // The mapped arrays outlive the reader.
+  mapReader->SetFileName(nullptr);
+  output->Modified();
+  if (output->GetPointData()->GetArray(0)->GetComponent(0, 0) != 1.0)
+  {
+    cerr << "Mapped arrays cannot be modified." << endl;
+    return false;
+  }
+
+  reader->Modified();
+  reader->Update();
+  if (!Compare(expected, reader->GetOutput()))
+  {
+    cerr << "The file was modified through the mapped arrays." << endl;
+    return false;
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestXMLReaderMemoryMap(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+    "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string dir(tempDir);
+  delete [] tempDir;
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(17, 13, 11);
+  image->SetSpacing(0.5, 1.0, 2.0);
+  AddArrays(image);
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    points->InsertNextPoint(image->GetPoint(ptId));
+  }
+  grid->SetPoints(points);
+  grid->Allocate(image->GetNumberOfCells());
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = 0; cellId < image->GetNumberOfCells(); ++cellId)
+  {
+    image->GetCellPoints(cellId, cellPts);
+    grid->InsertNextCell(image->GetCellType(cellId), cellPts);
+  }
+  AddArrays(grid);
+
+  for (int headerType = 32; headerType <= 64; headerType += 32)
+  {
+    std::string imageFile = dir + "/TestXMLReaderMemoryMap.vti";
+    vtkNew<vtkXMLImageDataWriter> imageWriter;
+    imageWriter->SetInputData(image);
+    imageWriter->SetFileName(imageFile.c_str());
+    imageWriter->SetDataModeToAppended();
+    imageWriter->EncodeAppendedDataOff();
+    imageWriter->SetCompressorTypeToNone();
+    imageWriter->SetHeaderType(headerType);
+    imageWriter->Write();
+    if (!Check<vtkXMLImageDataReader>(imageFile, image))
+    {
+      cerr << "Image data failed with header type " << headerType << endl;
+      return EXIT_FAILURE;
+    }
+
+    std::string gridFile = dir + "/TestXMLReaderMemoryMap.vtu";
+    vtkNew<vtkXMLUnstructuredGridWriter> gridWriter;
+    gridWriter->SetInputData(grid);
+    gridWriter->SetFileName(gridFile.c_str());
+    gridWriter->SetDataModeToAppended();
+    gridWriter->EncodeAppendedDataOff();
+    gridWriter->SetCompressorTypeToNone();
+    gridWriter->SetHeaderType(headerType);
+    gridWriter->Write();
+    if (!Check<vtkXMLUnstructuredGridReader>(gridFile, grid))
+    {
+      cerr << "Unstructured grid failed with header type " << headerType
+           << endl;
+      return EXIT_FAILURE;
+    }
+
+    // Compressed and encoded data are read as usual.
+    gridWriter->SetCompressorTypeToZLib();
+    gridWriter->Write();
+    if (!Check<vtkXMLUnstructuredGridReader>(gridFile, grid))
+    {
+      cerr << "Compressed unstructured grid failed with header type "
+           << headerType << endl;
+      return EXIT_FAILURE;
+    }
+    gridWriter->SetCompressorTypeToNone();
+    gridWriter->EncodeAppendedDataOn();
+    gridWriter->Write();
+    if (!Check<vtkXMLUnstructuredGridReader>(gridFile, grid))
+    {
+      cerr << "Encoded unstructured grid failed with header type "
+           << headerType << endl;
+      return EXIT_FAILURE;
+    }
+
+    // A reader reused for an encoded file after a raw one decodes it.
+    std::string rawFile = dir + "/TestXMLReaderMemoryMapRaw.vtu";
+    gridWriter->SetFileName(rawFile.c_str());
+    gridWriter->EncodeAppendedDataOff();
+    gridWriter->Write();
+    vtkNew<vtkXMLUnstructuredGridReader> reusedReader;
+    reusedReader->MemoryMapAppendedDataOn();
+    reusedReader->SetFileName(rawFile.c_str());
+    reusedReader->Update();
+    reusedReader->SetFileName(gridFile.c_str());
+    reusedReader->Update();
+    if (!Compare(grid, reusedReader->GetOutput()))
+    {
+      cerr << "Encoded unstructured grid read after a raw one failed with "
+           << "header type " << headerType << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
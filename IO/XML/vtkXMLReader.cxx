@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkXMLReader.h"
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkCallbackCommand.h"
 #include "vtkDataArray.h"
@@ -37,6 +38,7 @@
 #include "vtkLZMADataCompressor.h"
 #include "vtkObjectFactory.h"
 #include "vtkQuadratureSchemeDefinition.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkXMLDataElement.h"
 #include "vtkXMLDataParser.h"
@@ -50,9 +52,18 @@
 #include <cassert>
 #include <functional>
 #include <locale> // C++ locale
+#include <map>
 #include <sstream>
 #include <vector>
 
+#if !defined(_WIN32)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define VTK_XML_READER_HAS_MMAP
+#endif
+
 vtkCxxSetObjectMacro(vtkXMLReader,ReaderErrorObserver,vtkCommand);
 vtkCxxSetObjectMacro(vtkXMLReader,ParserErrorObserver,vtkCommand);
 
@@ -105,6 +116,7 @@ vtkXMLReader::vtkXMLReader()
   this->FileStream = nullptr;
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
+  this->MemoryMapAppendedData = 0;
   this->InputString = "";
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
@@ -201,6 +213,8 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "MemoryMapAppendedData: "
+     << this->MemoryMapAppendedData << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << ","
@@ -829,6 +843,148 @@ int vtkXMLDataReaderReadArrayValues(
   return result;
 }
 
+#ifdef VTK_XML_READER_HAS_MMAP
+//----------------------------------------------------------------------------
+// The file regions mapped by the readers, indexed by the address of the
+// array values they hold. The arrays release them through
+// vtkXMLReaderUnmapArray when they free their memory.
+struct vtkXMLReaderMappedRegion
+{
+  void* Address;
+  size_t Length;
+};
+typedef std::multimap<void*, vtkXMLReaderMappedRegion>
+  vtkXMLReaderMappedRegions;
+
+vtkXMLReaderMappedRegions vtkXMLReaderMappedRegionsMap;
+vtkSimpleCriticalSection vtkXMLReaderMappedRegionsLock;
+
+//----------------------------------------------------------------------------
+void vtkXMLReaderUnmapArray(void* data)
+{
+  vtkXMLReaderMappedRegion region = { nullptr, 0 };
+  vtkXMLReaderMappedRegionsLock.Lock();
+  vtkXMLReaderMappedRegions::iterator it =
+    vtkXMLReaderMappedRegionsMap.find(data);
+  if (it != vtkXMLReaderMappedRegionsMap.end())
+  {
+    region = it->second;
+    vtkXMLReaderMappedRegionsMap.erase(it);
+  }
+  vtkXMLReaderMappedRegionsLock.Unlock();
+  if (region.Address)
+  {
+    munmap(region.Address, region.Length);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Map numBytes of the file starting at position. The mapping is private and
+// writable, the pages being copied on write.
+void* vtkXMLReaderMapFile(const char* fileName, vtkTypeInt64 position,
+                          size_t numBytes)
+{
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 ||
+      position + static_cast<vtkTypeInt64>(numBytes) >
+        static_cast<vtkTypeInt64>(fileStat.st_size))
+  {
+    close(fd);
+    return nullptr;
+  }
+  const vtkTypeInt64 pageSize = sysconf(_SC_PAGESIZE);
+  const vtkTypeInt64 start = position - position % pageSize;
+  vtkXMLReaderMappedRegion region;
+  region.Length = numBytes + static_cast<size_t>(position - start);
+  region.Address = mmap(nullptr, region.Length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE, fd, static_cast<off_t>(start));
+  close(fd);
+  if (region.Address == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  void* data = static_cast<char*>(region.Address) + (position - start);
+  vtkXMLReaderMappedRegionsLock.Lock();
+  vtkXMLReaderMappedRegionsMap.insert(std::make_pair(data, region));
+  vtkXMLReaderMappedRegionsLock.Unlock();
+  return data;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+int vtkXMLReaderMapArray(T*, vtkAbstractArray* array, const char* fileName,
+                         vtkTypeInt64 position, vtkIdType numValues)
+{
+  vtkAOSDataArrayTemplate<T>* aos =
+    vtkArrayDownCast<vtkAOSDataArrayTemplate<T> >(array);
+  if (!aos || position % static_cast<vtkTypeInt64>(sizeof(T)) != 0)
+  {
+    return 0;
+  }
+  T* data = static_cast<T*>(vtkXMLReaderMapFile(fileName, position,
+    static_cast<size_t>(numValues) * sizeof(T)));
+  if (!data)
+  {
+    return 0;
+  }
+  aos->SetArray(data, numValues, 0);
+  aos->SetArrayFreeFunction(vtkXMLReaderUnmapArray);
+  return 1;
+}
+#endif
+
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLReader::MapArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
+                                 vtkAbstractArray* array,
+                                 vtkIdType startIndex, vtkIdType numValues)
+{
+#ifdef VTK_XML_READER_HAS_MMAP
+  // The whole array must come from a raw appended data block of the input
+  // file, in the byte order of this machine.
+  vtkTypeInt64 offset = 0;
+  if (!this->MemoryMapAppendedData || !this->FileStream ||
+      this->Stream != this->FileStream || arrayIndex != 0 ||
+      startIndex != 0 || numValues <= 0 ||
+      numValues != array->GetNumberOfValues() ||
+      !da->GetScalarAttribute("offset", offset))
+  {
+    return 0;
+  }
+#ifdef VTK_WORDS_BIGENDIAN
+  const int byteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int byteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  vtkTypeInt64 position = 0;
+  vtkTypeUInt64 numBytes = 0;
+  if (this->XMLParser->GetByteOrder() != byteOrder ||
+      !this->XMLParser->FindAppendedRawData(offset, position, numBytes) ||
+      numBytes < static_cast<vtkTypeUInt64>(numValues) *
+        static_cast<vtkTypeUInt64>(array->GetDataTypeSize()))
+  {
+    return 0;
+  }
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(
+      return vtkXMLReaderMapArray(static_cast<VTK_TT*>(nullptr), array,
+        this->FileName, position, numValues));
+  }
+#else
+  (void)da;
+  (void)arrayIndex;
+  (void)array;
+  (void)startIndex;
+  (void)numValues;
+#endif
+  return 0;
 }
 
 //----------------------------------------------------------------------------
@@ -844,19 +1000,26 @@ int vtkXMLReader::ReadArrayValues(
   }
   this->InReadData = 1;
   int result;
-  // All arrays types except vtkBitArray.
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+  if (this->MapArrayValues(da, arrayIndex, array, startIndex, numValues))
   {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    result = 1;
   }
-  if (iter)
+  else
   {
-    iter->Delete();
+    // All arrays types except vtkBitArray.
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+    }
+    if (iter)
+    {
+      iter->Delete();
+    }
   }
 
   this->ConvertGhostLevelsToGhostType(fieldType, array, startIndex, numValues);
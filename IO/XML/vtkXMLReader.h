@@ -72,6 +72,23 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * Enable memory mapping of the appended data of the input file. When
+   * enabled, an array stored in the appended data section with the raw
+   * encoding, without compression, in the byte order of this machine and
+   * aligned on the size of its values is not read: its memory is mapped
+   * from the file instead, and the pages are loaded when the array is
+   * accessed. The mapping is private, so modifying the array does not
+   * modify the file, and it is released when the array frees its memory.
+   * The other arrays are read as usual. This is only supported when
+   * reading from a file on POSIX systems. The default is off.
+   */
+  vtkSetMacro(MemoryMapAppendedData, vtkTypeBool);
+  vtkGetMacro(MemoryMapAppendedData, vtkTypeBool);
+  vtkBooleanMacro(MemoryMapAppendedData, vtkTypeBool);
+  //@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -312,6 +329,9 @@ protected:
   // Default is 0: read from file.
   vtkTypeBool ReadFromInputString;
 
+  // Whether to map the raw appended data from the file.
+  vtkTypeBool MemoryMapAppendedData;
+
   // The input string.
   std::string InputString;
 
@@ -389,6 +409,12 @@ protected:
   void ReadFieldData();
 
 private:
+  // Map the values of an array stored as raw appended data from the input
+  // file instead of reading them. Returns 0 if this is not possible.
+  int MapArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
+                     vtkAbstractArray* array, vtkIdType startIndex,
+                     vtkIdType numValues);
+
   // The stream used to read the input if it is in a file.
   ifstream* FileStream;
   // The stream used to read the input if it is in a string.
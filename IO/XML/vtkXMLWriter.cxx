@@ -44,6 +44,7 @@
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -1333,6 +1334,12 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
       result = 0;
     }
 
+    // Compress and write the remaining blocks.
+    if (result && !this->FlushCompressionBlocks())
+    {
+      result = 0;
+    }
+
     // Finish writing the data.
     if (result && !this->DataStream->EndWriting())
     {
@@ -1692,6 +1699,8 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 
   // Initialize counter for block writing.
   this->CompressionBlockNumber = 0;
+  this->CompressionBlocks.clear();
+  this->CompressionBlockSizes.clear();
 
   return result;
 }
@@ -1699,26 +1708,78 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
 {
-  // Compress the data.
-  vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
+  // Queue a copy of the block.  The blocks are compressed in parallel by
+  // batches of a few blocks per thread, which bounds the memory used.
+  this->CompressionBlocks.insert(this->CompressionBlocks.end(),
+                                 data, data + size);
+  this->CompressionBlockSizes.push_back(size);
+  size_t batchSize =
+    4 * static_cast<size_t>(vtkSMPTools::GetEstimatedNumberOfThreads());
+  if (this->CompressionBlockSizes.size() < batchSize)
+  {
+    return 1;
+  }
+  return this->FlushCompressionBlocks();
+}
 
-  // Find the compressed size.
-  size_t outputSize = outputArray->GetNumberOfTuples();
-  unsigned char* outputPointer = outputArray->GetPointer(0);
+//----------------------------------------------------------------------------
+int vtkXMLWriter::FlushCompressionBlocks()
+{
+  size_t numBlocks = this->CompressionBlockSizes.size();
+  if (numBlocks == 0)
+  {
+    return 1;
+  }
+
+  // Compress the blocks.  Each block is compressed on its own, so the
+  // output does not depend on the number of threads.
+  std::vector<size_t> offsets(numBlocks, 0);
+  for (size_t i = 1; i < numBlocks; ++i)
+  {
+    offsets[i] = offsets[i-1] + this->CompressionBlockSizes[i-1];
+  }
+  std::vector<vtkUnsignedCharArray*> outputArrays(numBlocks, nullptr);
+  vtkDataCompressor* compressor = this->Compressor;
+  const unsigned char* blocks = this->CompressionBlocks.data();
+  const size_t* sizes = this->CompressionBlockSizes.data();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        outputArrays[i] = compressor->Compress(blocks + offsets[i], sizes[i]);
+      }
+    });
+
+  // Write the compressed data in order and store the compressed sizes in
+  // the compression header.
+  int result = 1;
+  for (size_t i = 0; i < numBlocks; ++i)
+  {
+    vtkUnsignedCharArray* outputArray = outputArrays[i];
+    if (!outputArray)
+    {
+      result = 0;
+      continue;
+    }
+    size_t outputSize = outputArray->GetNumberOfTuples();
+    if (result &&
+        !this->DataStream->Write(outputArray->GetPointer(0), outputSize))
+    {
+      result = 0;
+    }
+    this->CompressionHeader->Set(3+this->CompressionBlockNumber++, outputSize);
+    outputArray->Delete();
+  }
+  this->CompressionBlocks.clear();
+  this->CompressionBlockSizes.clear();
 
-  // Write the compressed data.
-  int result = this->DataStream->Write(outputPointer, outputSize);
   this->Stream->flush();
   if (this->Stream->fail())
   {
     this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    return 0;
   }
-
-  // Store the resulting compressed size in the compression header.
-  this->CompressionHeader->Set(3+this->CompressionBlockNumber++, outputSize);
-
-  outputArray->Delete();
-
   return result;
 }
 
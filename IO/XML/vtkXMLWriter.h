@@ -33,6 +33,7 @@
 #include "vtkIOXMLModule.h" // For export macro
 #include "vtkAlgorithm.h"
 #include <sstream> // For ostringstream ivar
+#include <vector> // For std::vector ivars
 
 class vtkAbstractArray;
 class vtkArrayIterator;
@@ -187,7 +188,9 @@ public:
    * Get/Set the block size used in compression.  When reading, this
    * controls the granularity of how much extra information must be
    * read when only part of the data are requested.  The value should
-   * be a multiple of the largest scalar data type.
+   * be a multiple of the largest scalar data type.  The blocks are
+   * compressed in parallel with vtkSMPTools, a few blocks per thread at a
+   * time, and the output does not depend on the number of threads.
    */
   virtual void SetBlockSize(size_t blockSize);
   vtkGetMacro(BlockSize, size_t);
@@ -336,6 +339,10 @@ protected:
   size_t CompressionBlockNumber;
   vtkXMLDataHeader* CompressionHeader;
   vtkTypeInt64 CompressionHeaderPosition;
+  // Uncompressed blocks waiting to be compressed in parallel, stored one
+  // after the other, and their sizes.
+  std::vector<unsigned char> CompressionBlocks;
+  std::vector<size_t> CompressionBlockSizes;
   // Compression Level for vtkDataCompressor objects
   // 1 (worst compression, fastest) ... 9 (best compression, slowest)
   int CompressionLevel = 5;
@@ -474,6 +481,7 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int FlushCompressionBlocks();
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
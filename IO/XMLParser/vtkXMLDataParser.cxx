@@ -20,6 +20,7 @@
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
@@ -45,6 +46,7 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->OpenElements = new vtkXMLDataElement*[this->OpenElementsSize];
   this->RootElement = nullptr;
   this->AppendedDataPosition = 0;
+  this->AppendedDataIsRaw = 0;
   this->AppendedDataMatched = 0;
   this->DataStream = nullptr;
   this->InlineDataStream = vtkBase64InputStream::New();
@@ -119,6 +121,16 @@ int vtkXMLDataParser::Parse()
   // Delete any elements left from previous parsing.
   this->FreeAllElements();
 
+  // Forget the appended data of any previous input.
+  this->AppendedDataPosition = 0;
+  this->AppendedDataMatched = 0;
+  if(this->AppendedDataIsRaw)
+  {
+    this->AppendedDataStream->Delete();
+    this->AppendedDataStream = vtkBase64InputStream::New();
+    this->AppendedDataIsRaw = 0;
+  }
+
   // Parse the input from the stream.
   int result = this->Superclass::Parse();
 
@@ -171,6 +183,7 @@ void vtkXMLDataParser::StartElement(const char* name, const char** atts)
     {
       this->AppendedDataStream->Delete();
       this->AppendedDataStream = vtkInputStream::New();
+      this->AppendedDataIsRaw = 1;
     }
   }
 }
@@ -582,6 +595,53 @@ int vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block, unsigned char* buffer)
   return result > 0;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(vtkTypeUInt64 beginBlock,
+                                 vtkTypeUInt64 endBlock,
+                                 unsigned char* buffer, size_t wordSize)
+{
+  // The compressed blocks are stored one after the other, read them at
+  // once.
+  size_t numBlocks = static_cast<size_t>(endBlock-beginBlock);
+  std::vector<size_t> readOffsets(numBlocks+1, 0);
+  for(size_t i=0; i < numBlocks; ++i)
+  {
+    readOffsets[i+1] =
+      readOffsets[i] + this->BlockCompressedSizes[beginBlock+i];
+  }
+  if(!this->DataStream->Seek(this->BlockStartOffsets[beginBlock]))
+  {
+    return 0;
+  }
+  std::vector<unsigned char> readBuffer(readOffsets[numBlocks]);
+  if(this->DataStream->Read(readBuffer.data(), readBuffer.size()) <
+     readBuffer.size())
+  {
+    return 0;
+  }
+
+  // Decompress and byte swap the blocks in parallel.  Note that the block
+  // size will always be an integer multiple of the word size.
+  std::vector<unsigned char> blockRead(numBlocks, 0);
+  size_t const blockSize = this->BlockUncompressedSize;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for(vtkIdType i = begin; i < end; ++i)
+      {
+        unsigned char* blockBuffer = buffer + i*blockSize;
+        if(this->Compressor->Uncompress(&readBuffer[readOffsets[i]],
+                                        readOffsets[i+1] - readOffsets[i],
+                                        blockBuffer, blockSize) > 0)
+        {
+          this->PerformByteSwap(blockBuffer, blockSize / wordSize, wordSize);
+          blockRead[i] = 1;
+        }
+      }
+    });
+  return std::find(blockRead.begin(), blockRead.end(), 0) == blockRead.end();
+}
+
 //----------------------------------------------------------------------------
 unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
 {
@@ -774,18 +834,23 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Report progress.
     this->UpdateProgress(float(outputPointer-data)/length);
 
-    unsigned int currentBlock = firstBlock+1;
-    for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
+    // Read the complete blocks in between by batches of a few blocks per
+    // thread.
+    vtkTypeUInt64 batchSize =
+      4 * static_cast<vtkTypeUInt64>(vtkSMPTools::GetEstimatedNumberOfThreads());
+    vtkTypeUInt64 currentBlock = firstBlock+1;
+    while(currentBlock < lastBlock && !this->Abort)
     {
-      // Read this block.
-      if(!this->ReadBlock(currentBlock, outputPointer)) { return 0; }
-
-      // Byte swap this block.  Note that blockSize will always be an
-      // integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
+      // Read these blocks.
+      vtkTypeUInt64 endBlock = std::min(currentBlock+batchSize, lastBlock);
+      if(!this->ReadBlocks(currentBlock, endBlock, outputPointer, wordSize))
+      {
+        return 0;
+      }
 
       // Advance the pointer to the beginning of the next block.
-      outputPointer += this->FindBlockSize(currentBlock);
+      outputPointer += (endBlock-currentBlock)*this->BlockUncompressedSize;
+      currentBlock = endBlock;
 
       // Report progress.
       this->UpdateProgress(float(outputPointer-data)/length);
@@ -934,6 +999,41 @@ size_t vtkXMLDataParser::ReadAppendedData(vtkTypeInt64 offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::FindAppendedRawData(vtkTypeInt64 offset,
+                                          vtkTypeInt64& position,
+                                          vtkTypeUInt64& numBytes)
+{
+  if(!this->AppendedDataIsRaw || this->Compressor || !this->Stream)
+  {
+    return 0;
+  }
+
+  // Read the length of the data from the block header.
+#if defined(VTK_HAS_STD_UNIQUE_PTR)
+  std::unique_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#else
+  std::auto_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#endif
+  size_t const headerSize = uh->DataSize();
+  this->SeekG(this->AppendedDataPosition+offset);
+  this->Stream->read(reinterpret_cast<char*>(uh->Data()),
+                     static_cast<std::streamsize>(headerSize));
+  if(static_cast<size_t>(this->Stream->gcount()) < headerSize)
+  {
+    // Leave the stream usable for ReadAppendedData.
+    this->Stream->clear();
+    return 0;
+  }
+  this->PerformByteSwap(uh->Data(), uh->WordCount(), uh->WordSize());
+  numBytes = uh->Get(0);
+  position = this->AppendedDataPosition + offset +
+    static_cast<vtkTypeInt64>(headerSize);
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
@@ -161,6 +161,23 @@ public:
     return this->AppendedDataPosition;
   }
 
+  /**
+   * Get the byte order of the binary input (BigEndian or LittleEndian).
+   * Valid after the XML is parsed.
+   */
+  vtkGetMacro(ByteOrder, int);
+
+  /**
+   * Locate the appended data block at the given offset without reading it.
+   * This is possible only when the appended data use the raw encoding and
+   * no compressor is set. In that case the stream position of the first
+   * data byte (following the block header) and the size of the block in
+   * bytes are stored in position and numBytes and 1 is returned. Otherwise
+   * 0 is returned and the block must be read with ReadAppendedData.
+   */
+  int FindAppendedRawData(vtkTypeInt64 offset, vtkTypeInt64& position,
+                          vtkTypeUInt64& numBytes);
+
 protected:
   vtkXMLDataParser();
   ~vtkXMLDataParser() override;
@@ -189,6 +206,8 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+  int ReadBlocks(vtkTypeUInt64 beginBlock, vtkTypeUInt64 endBlock,
+                 unsigned char* buffer, size_t wordSize);
   size_t ReadUncompressedData(unsigned char* data,
                               vtkTypeUInt64 startWord,
                               size_t numWords,
@@ -219,6 +238,9 @@ protected:
   // The position of the appended data section, if found.
   vtkTypeInt64 AppendedDataPosition;
 
+  // Whether the appended data section uses the raw encoding.
+  int AppendedDataIsRaw;
+
   // How much of the string "<AppendedData" has been matched in input.
   int AppendedDataMatched;
 
@@ -0,0 +1,281 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMedianFilters.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkImageMedian3D and vtkImageHybridMedian2D give exactly
+// the values of a direct computation of the medians with std::nth_element
+// and std::sort, whatever the kernel size, the scalar type, and the
+// values (including signed zeros and not-a-number values).
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageHybridMedian2D.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTypeTraits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+// An image with random values in the given range, with a few special
+// values for the floating-point types.
+template <class T>
+void FillImage(vtkImageData *image, double range, int seed)
+{
+  T *ptr = static_cast<T *>(image->GetScalarPointer());
+  vtkIdType n = image->GetNumberOfPoints() *
+    image->GetNumberOfScalarComponents();
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  double minval = vtkTypeTraits<T>::Min();
+  if (!std::numeric_limits<T>::is_integer)
+  {
+    minval = -range/2;
+  }
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    random->Next();
+    ptr[i] = static_cast<T>(minval + random->GetValue()*range);
+  }
+  if (!std::numeric_limits<T>::is_integer)
+  {
+    // signed zeros and not-a-number values in the first quarter only
+    for (vtkIdType i = 0; i < n/4; i += 97)
+    {
+      ptr[i] = static_cast<T>(0.0);
+      ptr[i + 1] = static_cast<T>(-0.0);
+    }
+    ptr[n/8] = std::numeric_limits<T>::quiet_NaN();
+    ptr[n/2] = std::numeric_limits<T>::infinity();
+    ptr[3*n/4] = -std::numeric_limits<T>::infinity();
+  }
+}
+
+// The median of a neighborhood, as computed by vtkImageMedian3D.
+template <class T>
+T MedianOfArray(T *aBegin, T *aEnd)
+{
+  T *aMid = aBegin + (aEnd - aBegin)/2;
+  std::nth_element(aBegin, aMid, aEnd);
+  T m = *aMid;
+  if (aMid - aBegin == aEnd - aMid)
+  {
+    T *lowMid = std::max_element(aBegin, aMid);
+    m = *lowMid + (m - *lowMid)/2;
+  }
+  return m;
+}
+
+template <class T>
+void Median3D(vtkImageData *input, const int size[3], vtkImageData *output)
+{
+  int ext[6];
+  input->GetExtent(ext);
+  vtkIdType inc[3];
+  input->GetIncrements(inc);
+  int numComps = input->GetNumberOfScalarComponents();
+  output->SetExtent(ext);
+  output->AllocateScalars(input->GetScalarType(), numComps);
+  const T *inPtr = static_cast<T *>(input->GetScalarPointer());
+  T *outPtr = static_cast<T *>(output->GetScalarPointer());
+  std::vector<T> values;
+  for (int k = ext[4]; k <= ext[5]; k++)
+  {
+    for (int j = ext[2]; j <= ext[3]; j++)
+    {
+      for (int i = ext[0]; i <= ext[1]; i++)
+      {
+        int idx[3] = { i, j, k };
+        int hoodMin[3], hoodMax[3];
+        for (int a = 0; a < 3; a++)
+        {
+          hoodMin[a] = std::max(idx[a] - size[a]/2, ext[2*a]);
+          hoodMax[a] = std::min(idx[a] - size[a]/2 + size[a] - 1,
+                                ext[2*a + 1]);
+        }
+        for (int c = 0; c < numComps; c++)
+        {
+          values.clear();
+          for (int hk = hoodMin[2]; hk <= hoodMax[2]; hk++)
+          {
+            for (int hj = hoodMin[1]; hj <= hoodMax[1]; hj++)
+            {
+              for (int hi = hoodMin[0]; hi <= hoodMax[0]; hi++)
+              {
+                values.push_back(inPtr[(hi - ext[0])*inc[0] +
+                  (hj - ext[2])*inc[1] + (hk - ext[4])*inc[2] + c]);
+              }
+            }
+          }
+          *outPtr++ = MedianOfArray(values.data(),
+                                    values.data() + values.size());
+        }
+      }
+    }
+  }
+}
+
+// The output of vtkImageHybridMedian2D, with the values of the
+// neighborhoods sorted in the same order.
+template <class T>
+void HybridMedian2D(vtkImageData *input, vtkImageData *output)
+{
+  int ext[6];
+  input->GetExtent(ext);
+  vtkIdType inc[3];
+  input->GetIncrements(inc);
+  int numComps = input->GetNumberOfScalarComponents();
+  output->SetExtent(ext);
+  output->AllocateScalars(input->GetScalarType(), numComps);
+  const T *inPtr = static_cast<T *>(input->GetScalarPointer());
+  T *outPtr = static_cast<T *>(output->GetScalarPointer());
+  // the directions of the + and x neighborhoods
+  const int dirs[2][4][2] = {
+    { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } },
+    { { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 } } };
+  std::vector<T> values;
+  for (int k = ext[4]; k <= ext[5]; k++)
+  {
+    for (int j = ext[2]; j <= ext[3]; j++)
+    {
+      for (int i = ext[0]; i <= ext[1]; i++)
+      {
+        const T *center = inPtr + (i - ext[0])*inc[0] + (j - ext[2])*inc[1] +
+          (k - ext[4])*inc[2];
+        for (int c = 0; c < numComps; c++)
+        {
+          T medians[2];
+          for (int h = 0; h < 2; h++)
+          {
+            values.clear();
+            values.push_back(center[c]);
+            for (int d = 0; d < 4; d++)
+            {
+              for (int s = 1; s <= 2; s++)
+              {
+                int x = i + s*dirs[h][d][0];
+                int y = j + s*dirs[h][d][1];
+                if (x >= ext[0] && x <= ext[1] && y >= ext[2] && y <= ext[3])
+                {
+                  values.push_back(center[s*(dirs[h][d][0]*inc[0] +
+                                             dirs[h][d][1]*inc[1]) + c]);
+                }
+              }
+            }
+            std::sort(values.begin(), values.end());
+            medians[h] = values[values.size()/2];
+          }
+          if (medians[0] > medians[1])
+          {
+            std::swap(medians[0], medians[1]);
+          }
+          if (center[c] < medians[0])
+          {
+            *outPtr++ = medians[0];
+          }
+          else if (center[c] < medians[1])
+          {
+            *outPtr++ = center[c];
+          }
+          else
+          {
+            *outPtr++ = medians[1];
+          }
+        }
+      }
+    }
+  }
+}
+
+bool Compare(vtkImageData *a, vtkImageData *b)
+{
+  vtkDataArray *scalarsA = a->GetPointData()->GetScalars();
+  vtkDataArray *scalarsB = b->GetPointData()->GetScalars();
+  return (scalarsA->GetDataType() == scalarsB->GetDataType() &&
+          scalarsA->GetDataSize() == scalarsB->GetDataSize() &&
+          memcmp(scalarsA->GetVoidPointer(0), scalarsB->GetVoidPointer(0),
+                 scalarsA->GetDataSize()*scalarsA->GetDataTypeSize()) == 0);
+}
+
+template <class T>
+bool TestType(int scalarType, double range)
+{
+  const int kernels[9][3] = {
+    { 1, 1, 1 }, { 3, 3, 3 }, { 5, 5, 5 }, { 7, 7, 7 }, { 4, 4, 1 },
+    { 2, 3, 2 }, { 9, 9, 1 }, { 3, 1, 5 }, { 1, 11, 11 } };
+  for (int numComps = 1; numComps <= 2; numComps++)
+  {
+    vtkNew<vtkImageData> image;
+    image->SetExtent(-3, 37, 2, 30, 0, 18);
+    image->AllocateScalars(scalarType, numComps);
+    FillImage<T>(image, range, 3 + numComps);
+
+    for (int s = 0; s < 9; s++)
+    {
+      vtkNew<vtkImageMedian3D> median;
+      median->SetInputData(image);
+      median->SetKernelSize(kernels[s][0], kernels[s][1], kernels[s][2]);
+      median->Update();
+      vtkNew<vtkImageData> expected;
+      Median3D<T>(image, kernels[s], expected);
+      if (!Compare(expected, median->GetOutput()))
+      {
+        cerr << "Bad median of " << image->GetScalarTypeAsString() << " with "
+             << numComps << " component(s) for kernel " << kernels[s][0]
+             << "x" << kernels[s][1] << "x" << kernels[s][2] << endl;
+        return false;
+      }
+    }
+
+    vtkNew<vtkImageHybridMedian2D> hybrid;
+    hybrid->SetInputData(image);
+    hybrid->Update();
+    vtkNew<vtkImageData> expected;
+    HybridMedian2D<T>(image, expected);
+    if (!Compare(expected, hybrid->GetOutput()))
+    {
+      cerr << "Bad hybrid median of " << image->GetScalarTypeAsString()
+           << " with " << numComps << " component(s)" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestImageMedianFilters(int, char *[])
+{
+  if (!TestType<unsigned char>(VTK_UNSIGNED_CHAR, 256.0) ||
+      !TestType<signed char>(VTK_SIGNED_CHAR, 256.0) ||
+      !TestType<short>(VTK_SHORT, 65536.0) ||
+      !TestType<short>(VTK_SHORT, 40.0) ||
+      !TestType<unsigned short>(VTK_UNSIGNED_SHORT, 65536.0) ||
+      !TestType<int>(VTK_INT, 1000.0) ||
+      !TestType<float>(VTK_FLOAT, 100.0) ||
+      !TestType<double>(VTK_DOUBLE, 10.0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks vtkImageFFT against a direct computation of the discrete Fourier
+// transform for sizes with small and large prime factors, with real and
+// complex input, checks that vtkImageRFFT inverts it on volumes with any
+// number of threads, and checks vtkTableFFT.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkTable.h"
+#include "vtkTableFFT.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+double Value(int i, int j, int k, int c)
+{
+  return std::sin(0.37 * i + 1.3 * j + 0.1 * c) * 10.0 + std::cos(0.11 * k) +
+    ((i * 7 + j * 3 + k + c) % 5);
+}
+
+// An image of the given dimensions with 1 (real) or 2 (complex) components.
+void FillImage(vtkImageData *image, const int dims[3], int numComps)
+{
+  image->SetDimensions(dims[0], dims[1], dims[2]);
+  image->AllocateScalars(VTK_FLOAT, numComps);
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      for (int i = 0; i < dims[0]; ++i)
+      {
+        int ijk[3] = { i, j, k };
+        for (int c = 0; c < numComps; ++c)
+        {
+          scalars->SetComponent(image->ComputePointId(ijk), c,
+                                Value(i, j, k, c));
+        }
+      }
+    }
+  }
+}
+
+// Compare the transforms along the first axis with the direct computation.
+bool CheckRows(vtkImageData *input, vtkImageData *output)
+{
+  int dims[3];
+  input->GetDimensions(dims);
+  const int n = dims[0];
+  vtkDataArray *in = input->GetPointData()->GetScalars();
+  vtkDataArray *out = output->GetPointData()->GetScalars();
+  int numComps = in->GetNumberOfComponents();
+  std::vector<long double> cosines(n), sines(n);
+  for (int i = 0; i < n; ++i)
+  {
+    long double angle = -2.0L * vtkMath::Pi() * i / n;
+    cosines[i] = std::cos(angle);
+    sines[i] = std::sin(angle);
+  }
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      vtkIdType rowId = (static_cast<vtkIdType>(k) * dims[1] + j) * n;
+      double norm = 0.0;
+      for (int i = 0; i < n; ++i)
+      {
+        norm += std::fabs(in->GetComponent(rowId + i, 0));
+        if (numComps > 1)
+        {
+          norm += std::fabs(in->GetComponent(rowId + i, 1));
+        }
+      }
+      for (int f = 0; f < n; ++f)
+      {
+        long double re = 0.0, im = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+          int a = static_cast<int>((static_cast<long long>(f) * i) % n);
+          long double xr = in->GetComponent(rowId + i, 0);
+          long double xi = numComps > 1 ? in->GetComponent(rowId + i, 1) : 0;
+          re += xr * cosines[a] - xi * sines[a];
+          im += xr * sines[a] + xi * cosines[a];
+        }
+        if (std::fabs(static_cast<double>(re) -
+                      out->GetComponent(rowId + f, 0)) > 1e-12 * norm * n ||
+            std::fabs(static_cast<double>(im) -
+                      out->GetComponent(rowId + f, 1)) > 1e-12 * norm * n)
+        {
+          cerr << "Bad frequency " << f << " of row " << j << " " << k
+               << " for size " << n << " and " << numComps
+               << " component(s)." << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestImageFFT(int, char *[])
+{
+  // Radix 8, 4, 2, 3, generic radices, and sizes with large prime factors.
+  const int sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 17, 30, 31, 37, 49,
+    64, 97, 100, 128, 243, 360, 512, 1000, 1021, 1024 };
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(int); ++s)
+  {
+    for (int numComps = 1; numComps <= 2; ++numComps)
+    {
+      // More rows than a batch, and a partial batch.
+      const int dims[3] = { sizes[s], 19, 2 };
+      vtkNew<vtkImageData> image;
+      FillImage(image, dims, numComps);
+      vtkNew<vtkImageFFT> fft;
+      fft->SetDimensionality(1);
+      fft->SetInputData(image);
+      fft->Update();
+      if (!CheckRows(image, fft->GetOutput()))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The reverse transform of the transform of a volume along all its axes.
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  const int dims[3] = { 30, 17, 37 };
+  vtkNew<vtkImageData> volume;
+  FillImage(volume, dims, 1);
+  for (int t = 0; t < 4; ++t)
+  {
+    vtkSMPTools::Initialize(numThreads[t]);
+    vtkNew<vtkImageFFT> fft;
+    fft->SetInputData(volume);
+    fft->SetNumberOfThreads(t == 0 ? 1 : 4);
+    vtkNew<vtkImageRFFT> rfft;
+    rfft->SetInputConnection(fft->GetOutputPort());
+    rfft->SetNumberOfThreads(t == 0 ? 1 : 4);
+    rfft->Update();
+    vtkDataArray *in = volume->GetPointData()->GetScalars();
+    vtkDataArray *out = rfft->GetOutput()->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < volume->GetNumberOfPoints(); ++i)
+    {
+      if (std::fabs(in->GetComponent(i, 0) - out->GetComponent(i, 0)) > 1e-9 ||
+          std::fabs(out->GetComponent(i, 1)) > 1e-9)
+      {
+        cerr << "Bad reverse transform at " << i << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  // The columns of a table.
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> column;
+  column->SetName("Column");
+  const int dims1D[3] = { 1021, 1, 1 };
+  vtkNew<vtkImageData> row;
+  FillImage(row, dims1D, 1);
+  column->DeepCopy(row->GetPointData()->GetScalars());
+  column->SetName("Column");
+  table->AddColumn(column);
+  vtkNew<vtkTableFFT> tableFFT;
+  tableFFT->SetInputData(table);
+  tableFFT->Update();
+  vtkNew<vtkImageData> frequencies;
+  frequencies->SetDimensions(dims1D[0], 1, 1);
+  frequencies->GetPointData()->SetScalars(vtkArrayDownCast<vtkDataArray>(
+    tableFFT->GetOutput()->GetColumnByName("Column")));
+  if (!CheckRows(row, frequencies))
+  {
+    cerr << "Bad table transform." << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
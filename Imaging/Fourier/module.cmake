@@ -2,6 +2,8 @@ vtk_module(vtkImagingFourier
   GROUPS
     Imaging
     StandAlone
+  TEST_DEPENDS
+    vtkTestingCore
   KIT
     vtkImaging
   DEPENDS
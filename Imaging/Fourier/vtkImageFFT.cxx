@@ -20,10 +20,15 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageFFT);
 
+// Number of rows transformed at once.
+#define VTK_IMAGE_FFT_BATCH 16
+
 //----------------------------------------------------------------------------
 // This extent of the components changes to real and imaginary values.
 int vtkImageFFT::IterativeRequestInformation(
@@ -66,8 +71,6 @@ void vtkImageFFTExecute(vtkImageFFT *self,
                         vtkImageData *outData, int outExt[6], double *outPtr,
                         int id)
 {
-  vtkImageComplex *inComplex;
-  vtkImageComplex *outComplex;
   vtkImageComplex *pComplex;
   //
   int inMin0, inMax0;
@@ -79,6 +82,7 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int batch, rowIdx;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -102,9 +106,16 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     return;
   }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the arrays of complex numbers, for a batch of rows transformed
+  // at once (the element idx0 of the row rowIdx is at rowIdx + batch * idx0).
+  // Real rows are transformed with transforms of half the size.
+  bool realInput = (numberOfComponents == 1);
+  std::vector<vtkImageComplex> inComplex(
+    realInput ? 0 : static_cast<size_t>(inSize0) * VTK_IMAGE_FFT_BATCH);
+  std::vector<double> inReal(
+    realInput ? static_cast<size_t>(inSize0) * VTK_IMAGE_FFT_BATCH : 0);
+  std::vector<vtkImageComplex> outComplex(
+    static_cast<size_t>(inSize0) * VTK_IMAGE_FFT_BATCH);
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -117,9 +128,11 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += batch)
     {
-      if (!id)
+      batch = std::min(VTK_IMAGE_FFT_BATCH, outMax1 - idx1 + 1);
+      for (rowIdx = 0; !id && rowIdx < batch; ++rowIdx)
       {
         if (!(count%target))
         {
@@ -127,43 +140,61 @@ void vtkImageFFTExecute(vtkImageFFT *self,
         }
         count++;
       }
-      // copy into complex numbers
+      // copy into real or complex numbers
       inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      for (idx0 = 0; idx0 < inSize0; ++idx0)
       {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
-        { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+        T *inRowPtr = inPtr0;
+        size_t offset = static_cast<size_t>(batch) * idx0;
+        for (rowIdx = 0; rowIdx < batch; ++rowIdx)
+        {
+          if (realInput)
+          {
+            inReal[offset + rowIdx] = static_cast<double>(*inRowPtr);
+          }
+          else
+          { // yes we have an imaginary input
+            pComplex = &inComplex[offset + rowIdx];
+            pComplex->Real = static_cast<double>(*inRowPtr);
+            pComplex->Imag = static_cast<double>(inRowPtr[1]);
+          }
+          inRowPtr += inInc1;
         }
         inPtr0 += inInc0;
-        ++pComplex;
       }
 
       // Call the method that performs the fft
-      self->ExecuteFft(inComplex, outComplex, inSize0);
+      if (realInput)
+      {
+        self->ExecuteRealFftBatch(&inReal[0], &outComplex[0], inSize0, batch);
+      }
+      else
+      {
+        self->ExecuteFftBatch(&inComplex[0], &outComplex[0], inSize0, batch,
+                              1);
+      }
 
       // copy into output
       outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
+      pComplex = &outComplex[static_cast<size_t>(batch) * (outMin0 - inMin0)];
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
       {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
+        double *outRowPtr = outPtr0;
+        for (rowIdx = 0; rowIdx < batch; ++rowIdx)
+        {
+          *outRowPtr = pComplex->Real;
+          outRowPtr[1] = pComplex->Imag;
+          outRowPtr += outInc1;
+          ++pComplex;
+        }
         outPtr0 += outInc0;
-        ++pComplex;
       }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += batch * inInc1;
+      outPtr1 += batch * outInc1;
     }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
   }
-
-  delete [] inComplex;
-  delete [] outComplex;
 }
 
 
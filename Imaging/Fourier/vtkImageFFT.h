@@ -21,9 +21,11 @@
  * the output is always complex doubles with real values in component0, and
  * imaginary values in component1.  The filter is fastest for images that
  * have power of two sizes.  The filter uses a butterfly diagram for each
- * prime factor of the dimension.  This makes images with prime number dimensions
- * (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes)
- * FFT's are decomposed so that each axis executes serially.
+ * prime factor of the dimension, and the Bluestein algorithm for dimensions
+ * with large prime factors (i.e. 1021), which are about four times slower
+ * to compute.  Input with a single component is transformed with transforms
+ * of half the size.  Multi dimensional (i.e volumes) FFT's are decomposed so
+ * that each axis executes serially, the rows being transformed in batches.
 */
 
 #ifndef vtkImageFFT_h
@@ -15,198 +15,691 @@
 #include "vtkImageFourierFilter.h"
 
 #include "vtkMath.h"
+#include "vtkSimpleCriticalSection.h"
+
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <vector>
 
 /*=========================================================================
-        Vectors of complex numbers.
+        Planned transforms.
 =========================================================================*/
 
+namespace
+{
+
+// Prime factors up to this size are computed with the generic butterfly,
+// sizes with a larger prime factor use the Bluestein algorithm.
+const int vtkFftMaxGenericRadix = 31;
+
+//----------------------------------------------------------------------------
+inline vtkImageComplex vtkFftRoot(long long k, long long n)
+{
+  // exp(-2 i pi k / n), with k reduced for accuracy.
+  double angle = -(2.0 * vtkMath::Pi()) * static_cast<double>(k % n) / n;
+  vtkImageComplex root;
+  root.Real = cos(angle);
+  root.Imag = sin(angle);
+  return root;
+}
+
+//----------------------------------------------------------------------------
+// Stores a * w in b.
+inline void vtkFftMultiply(double ar, double ai, const vtkImageComplex &w,
+                           vtkImageComplex &b)
+{
+  b.Real = ar * w.Real - ai * w.Imag;
+  b.Imag = ar * w.Imag + ai * w.Real;
+}
+
 //----------------------------------------------------------------------------
-// This function calculates one step of a FFT.
-// It is specialized for a factor of 2.
-// It is engineered for no decimation.
-// (forward: fb = 1, backward: fb = -1)
-void vtkImageFourierFilter::ExecuteFftStep2(vtkImageComplex *p_in,
-                                            vtkImageComplex *p_out,
-                                            int N, int bsize, int fb)
+// One stage of a self sorting (Stockham) fft, decimated in frequency.  It
+// splits count transforms of size Length into Radix * count transforms of
+// size Length / Radix.
+struct vtkFftStage
 {
-  int i1, i2;
-  vtkImageComplex *p1, *p2, *p3;
-  vtkImageComplex q, fact1, fact, temp;
+  int Radix;
+  int Length;
+  // W_Length^(j * k), for j < Length / Radix and 0 < k < Radix.
+  std::vector<vtkImageComplex> Twiddles;
+  // W_Radix^k for the generic butterfly.
+  std::vector<vtkImageComplex> Roots;
+};
 
-  /* Copy the links with no factors. */
-  p1 = p_in;
-  p3 = p_out;
-  for(i1 = 0; i1 < N / (bsize * 2); ++i1)   // loop 0->1
+//----------------------------------------------------------------------------
+// The butterflies read the element j + r * m of the arrays and write the
+// element Radix * j + k, the count arrays being interleaved.  The inner loops
+// run over the interleaved arrays, so that they can be vectorized.
+void vtkFftButterfly2(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
+{
+  const int m = stage.Length / 2;
+  for (int j = 0; j < m; ++j)
   {
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)    // loop 0->2
+    const vtkImageComplex w = stage.Twiddles[j];
+    const vtkImageComplex *a0 = x + static_cast<size_t>(count) * j;
+    const vtkImageComplex *a1 = a0 + static_cast<size_t>(count) * m;
+    vtkImageComplex *b0 = y + static_cast<size_t>(count) * 2 * j;
+    vtkImageComplex *b1 = b0 + count;
+    for (int q = 0; q < count; ++q)
     {
-      *p3 = *p2;         // out[0] = in[0];  out[1] = in[1];
-      ++p2;
-      ++p3;
+      double r0 = a0[q].Real, i0 = a0[q].Imag;
+      double r1 = a1[q].Real, i1 = a1[q].Imag;
+      b0[q].Real = r0 + r1;
+      b0[q].Imag = i0 + i1;
+      vtkFftMultiply(r0 - r1, i0 - i1, w, b1[q]);
     }
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkFftButterfly3(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
+{
+  const int m = stage.Length / 3;
+  const double s = sqrt(0.75);
+  const size_t stride = static_cast<size_t>(count) * m;
+  for (int j = 0; j < m; ++j)
+  {
+    const vtkImageComplex *w = &stage.Twiddles[2 * j];
+    const vtkImageComplex *a = x + static_cast<size_t>(count) * j;
+    vtkImageComplex *b = y + static_cast<size_t>(count) * 3 * j;
+    for (int q = 0; q < count; ++q)
     {
-      *p3 = *p2;         // out[2] = in[0];   out[3] = in[1];
-      ++p2;
-      ++p3;
+      const vtkImageComplex &a0 = a[q];
+      const vtkImageComplex &a1 = a[q + stride];
+      const vtkImageComplex &a2 = a[q + 2 * stride];
+      double tr = a1.Real + a2.Real, ti = a1.Imag + a2.Imag;
+      double dr = s * (a1.Real - a2.Real), di = s * (a1.Imag - a2.Imag);
+      double cr = a0.Real - 0.5 * tr, ci = a0.Imag - 0.5 * ti;
+      b[q].Real = a0.Real + tr;
+      b[q].Imag = a0.Imag + ti;
+      vtkFftMultiply(cr + di, ci - dr, w[0], b[q + count]);
+      vtkFftMultiply(cr - di, ci + dr, w[1], b[q + 2 * count]);
     }
-    p1 = p1 + bsize;
   }
+}
 
-  /* Add the links with factors. */
-  fact1.Real = 1.0;
-  fact1.Imag = 0.0;
-  q.Real = 0.0;
-  q.Imag = -(2.0 * vtkMath::Pi()) * fb / (bsize * 2.0);
-  vtkImageComplexExponential(q, q);
-  p3 = p_out;
-  for(i1 = 0; i1 < N / (bsize * 2); ++i1)
+//----------------------------------------------------------------------------
+void vtkFftButterfly5(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
+{
+  const int m = stage.Length / 5;
+  const double c1 = cos(0.4 * vtkMath::Pi()), c2 = cos(0.8 * vtkMath::Pi());
+  const double s1 = sin(0.4 * vtkMath::Pi()), s2 = sin(0.8 * vtkMath::Pi());
+  const size_t stride = static_cast<size_t>(count) * m;
+  for (int j = 0; j < m; ++j)
   {
-    fact = fact1;
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+    const vtkImageComplex *w = &stage.Twiddles[4 * j];
+    const vtkImageComplex *a = x + static_cast<size_t>(count) * j;
+    vtkImageComplex *b = y + static_cast<size_t>(count) * 5 * j;
+    for (int q = 0; q < count; ++q)
     {
-      vtkImageComplexMultiply(fact, *p2, temp);
-      vtkImageComplexAdd(temp, *p3, *p3);
-      vtkImageComplexMultiply(q, fact, fact);
-      ++p2;    // out[0] += in[2];   out[1] += -i*in[3];
-      ++p3;
+      const vtkImageComplex &a0 = a[q];
+      const vtkImageComplex &a1 = a[q + stride];
+      const vtkImageComplex &a2 = a[q + 2 * stride];
+      const vtkImageComplex &a3 = a[q + 3 * stride];
+      const vtkImageComplex &a4 = a[q + 4 * stride];
+      double t1r = a1.Real + a4.Real, t1i = a1.Imag + a4.Imag;
+      double t2r = a2.Real + a3.Real, t2i = a2.Imag + a3.Imag;
+      double t3r = a1.Real - a4.Real, t3i = a1.Imag - a4.Imag;
+      double t4r = a2.Real - a3.Real, t4i = a2.Imag - a3.Imag;
+      double u1r = a0.Real + c1 * t1r + c2 * t2r;
+      double u1i = a0.Imag + c1 * t1i + c2 * t2i;
+      double u2r = a0.Real + c2 * t1r + c1 * t2r;
+      double u2i = a0.Imag + c2 * t1i + c1 * t2i;
+      double v1r = s1 * t3r + s2 * t4r, v1i = s1 * t3i + s2 * t4i;
+      double v2r = s2 * t3r - s1 * t4r, v2i = s2 * t3i - s1 * t4i;
+      b[q].Real = a0.Real + t1r + t2r;
+      b[q].Imag = a0.Imag + t1i + t2i;
+      // u -/+ i v
+      vtkFftMultiply(u1r + v1i, u1i - v1r, w[0], b[q + count]);
+      vtkFftMultiply(u2r + v2i, u2i - v2r, w[1], b[q + 2 * count]);
+      vtkFftMultiply(u2r - v2i, u2i + v2r, w[2], b[q + 3 * count]);
+      vtkFftMultiply(u1r - v1i, u1i + v1r, w[3], b[q + 4 * count]);
     }
-    p2 = p1;
-    for(i2 = 0; i2 < bsize; ++i2)
+  }
+}
+
+//----------------------------------------------------------------------------
+// Size 4 transform of a, the outputs being scaled by the twiddles w (the
+// first output is not scaled).  The outputs are count * step apart in b.
+inline void vtkFftKernel4(double ar[4], double ai[4],
+                          const vtkImageComplex *w, vtkImageComplex *b,
+                          size_t step)
+{
+  double t0r = ar[0] + ar[2], t0i = ai[0] + ai[2];
+  double t1r = ar[0] - ar[2], t1i = ai[0] - ai[2];
+  double t2r = ar[1] + ar[3], t2i = ai[1] + ai[3];
+  // -i * (a1 - a3)
+  double t3r = ai[1] - ai[3], t3i = ar[3] - ar[1];
+  b[0].Real = t0r + t2r;
+  b[0].Imag = t0i + t2i;
+  vtkFftMultiply(t1r + t3r, t1i + t3i, w[0], b[step]);
+  vtkFftMultiply(t0r - t2r, t0i - t2i, w[1], b[2 * step]);
+  vtkFftMultiply(t1r - t3r, t1i - t3i, w[2], b[3 * step]);
+}
+
+//----------------------------------------------------------------------------
+void vtkFftButterfly4(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
+{
+  const int m = stage.Length / 4;
+  const size_t stride = static_cast<size_t>(count) * m;
+  for (int j = 0; j < m; ++j)
+  {
+    const vtkImageComplex *w = &stage.Twiddles[3 * j];
+    const vtkImageComplex *a = x + static_cast<size_t>(count) * j;
+    vtkImageComplex *b = y + static_cast<size_t>(count) * 4 * j;
+    for (int q = 0; q < count; ++q)
     {
-      vtkImageComplexMultiply(fact, *p2, temp);
-      vtkImageComplexAdd(temp, *p3, *p3);
-      vtkImageComplexMultiply(q, fact, fact);
-      ++p2;
-      ++p3;
+      double ar[4], ai[4];
+      for (int r = 0; r < 4; ++r)
+      {
+        ar[r] = a[q + r * stride].Real;
+        ai[r] = a[q + r * stride].Imag;
+      }
+      vtkFftKernel4(ar, ai, w, b + q, count);
     }
-    p1 = p1 + bsize;
   }
 }
 
 //----------------------------------------------------------------------------
-// This function calculates one step of a FFT (using any factor).
-// It is engineered for no decimation.
-//  N: length of arrays
-//  bsize: Size of FFT so far (should be scaled by n after this step)
-//  n: size of this steps butterfly.
-//  fb: forward: fb = 1, backward: fb = -1
-void vtkImageFourierFilter::ExecuteFftStepN(vtkImageComplex *p_in,
-                                            vtkImageComplex *p_out,
-                                            int N, int bsize, int n, int fb)
+// Size 8 transforms, computed as a radix 2 step followed by two size 4
+// transforms for the even and odd outputs.
+void vtkFftButterfly8(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
 {
-  int i0, i1, i2, i3;
-  vtkImageComplex *p1, *p2, *p3;
-  vtkImageComplex q, fact, temp;
-
-  p3 = p_out;
-  for(i0 = 0; i0 < N; ++i0)
+  const int m = stage.Length / 8;
+  const double s = sqrt(0.5);
+  const size_t stride = static_cast<size_t>(count) * m;
+  for (int j = 0; j < m; ++j)
   {
-    p3->Real = 0.0;
-    p3->Imag = 0.0;
-    ++p3;
+    // Twiddles of the even and odd outputs.
+    const vtkImageComplex *w = &stage.Twiddles[7 * j];
+    const vtkImageComplex we[3] = { w[1], w[3], w[5] };
+    const vtkImageComplex wo[4] = { w[0], w[2], w[4], w[6] };
+    const vtkImageComplex *a = x + static_cast<size_t>(count) * j;
+    vtkImageComplex *b = y + static_cast<size_t>(count) * 8 * j;
+    for (int q = 0; q < count; ++q)
+    {
+      double ur[4], ui[4], vr[4], vi[4];
+      for (int r = 0; r < 4; ++r)
+      {
+        const vtkImageComplex &a0 = a[q + r * stride];
+        const vtkImageComplex &a1 = a[q + (r + 4) * stride];
+        ur[r] = a0.Real + a1.Real;
+        ui[r] = a0.Imag + a1.Imag;
+        vr[r] = a0.Real - a1.Real;
+        vi[r] = a0.Imag - a1.Imag;
+      }
+      // v_r *= W_8^r
+      double tr = vr[1], ti = vi[1];
+      vr[1] = s * (tr + ti);
+      vi[1] = s * (ti - tr);
+      tr = vr[2];
+      vr[2] = vi[2];
+      vi[2] = -tr;
+      tr = vr[3];
+      ti = vi[3];
+      vr[3] = s * (ti - tr);
+      vi[3] = -s * (tr + ti);
+      vtkFftKernel4(ur, ui, we, b + q, 2 * static_cast<size_t>(count));
+      vtkFftKernel4(vr, vi, wo + 1, b + q + count,
+                    2 * static_cast<size_t>(count));
+      vtkImageComplex &b1 = b[q + count];
+      vtkFftMultiply(b1.Real, b1.Imag, wo[0], b1);
+    }
   }
+}
 
-  p1 = p_in;
-  for(i0 = 0; i0 < n; ++i0)
+//----------------------------------------------------------------------------
+void vtkFftButterflyN(const vtkFftStage &stage, const vtkImageComplex *x,
+                      vtkImageComplex *y, int count)
+{
+  const int n = stage.Radix;
+  const int m = stage.Length / n;
+  const size_t stride = static_cast<size_t>(count) * m;
+  const vtkImageComplex *roots = &stage.Roots[0];
+  for (int j = 0; j < m; ++j)
   {
-    q.Real = 0.0;
-    q.Imag = -(2.0 * vtkMath::Pi()) * i0 * fb / (bsize*1.0*n);
-    vtkImageComplexExponential(q, q);
-    p3 = p_out;
-    for(i1 = 0; i1 < N / (bsize * n); ++i1)
+    const vtkImageComplex *w = &stage.Twiddles[(n - 1) * j];
+    const vtkImageComplex *a = x + static_cast<size_t>(count) * j;
+    vtkImageComplex *b = y + static_cast<size_t>(count) * n * j;
+    for (int k = 0; k < n; ++k)
     {
-      fact.Real = 1.0;
-      fact.Imag = 0.0;
-      for(i3 = 0; i3 < n; ++i3)
+      for (int q = 0; q < count; ++q)
       {
-        p2 = p1;
-        for(i2 = 0; i2 < bsize; ++i2)
+        double sr = 0.0, si = 0.0;
+        int t = 0;
+        for (int r = 0; r < n; ++r)
+        {
+          const vtkImageComplex &ar = a[q + r * stride];
+          sr += ar.Real * roots[t].Real - ar.Imag * roots[t].Imag;
+          si += ar.Real * roots[t].Imag + ar.Imag * roots[t].Real;
+          t += k;
+          if (t >= n)
+          {
+            t -= n;
+          }
+        }
+        if (k == 0)
+        {
+          b[q].Real = sr;
+          b[q].Imag = si;
+        }
+        else
         {
-          vtkImageComplexMultiply(fact, *p2, temp);
-          vtkImageComplexAdd(temp, *p3, *p3);
-          vtkImageComplexMultiply(q, fact, fact);
-          ++p2;
-          ++p3;
+          vtkFftMultiply(sr, si, w[k - 1], b[q + k * count]);
         }
       }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// The factorization and the twiddle factors of the forward transforms of a
+// given size.  Backward transforms are computed with conjugates.
+class vtkFftPlan
+{
+public:
+  explicit vtkFftPlan(int n);
+  ~vtkFftPlan() { delete this->Convolution; }
+
+  // Transforms count interleaved arrays.  x and y must have room for
+  // Size * count numbers, the contents of x are changed, and the result is
+  // returned in x or y.
+  vtkImageComplex *Execute(vtkImageComplex *x, vtkImageComplex *y,
+                           int count) const;
+
+  int Size;
+  std::vector<vtkFftStage> Stages;
+
+  // W_Size^k for k <= Size / 4, to split the transforms of real arrays.
+  std::vector<vtkImageComplex> RealTwiddles;
+
+  // Bluestein algorithm: the chirp exp(-i pi k^2 / Size), and the scaled
+  // transform of its conjugate, with which the chirped input is convolved.
+  vtkFftPlan *Convolution;
+  std::vector<vtkImageComplex> Chirp;
+  std::vector<vtkImageComplex> ChirpSpectrum;
+
+private:
+  vtkFftPlan(const vtkFftPlan&) = delete;
+  void operator=(const vtkFftPlan&) = delete;
+
+  void AddStage(int radix, int length);
+  vtkImageComplex *ExecuteBluestein(vtkImageComplex *x, vtkImageComplex *y,
+                                    int count) const;
+};
+
+//----------------------------------------------------------------------------
+vtkFftPlan::vtkFftPlan(int n) : Size(n), Convolution(nullptr)
+{
+  if (n % 2 == 0)
+  {
+    this->RealTwiddles.resize(n / 4 + 1);
+    for (int k = 0; k <= n / 4; ++k)
+    {
+      this->RealTwiddles[k] = vtkFftRoot(k, n);
+    }
+  }
+
+  // Factor the size, large radices first.
+  std::vector<int> factors;
+  int rest = n;
+  while (rest % 8 == 0)
+  {
+    factors.push_back(8);
+    rest /= 8;
+  }
+  if (rest % 4 == 0)
+  {
+    factors.push_back(4);
+    rest /= 4;
+  }
+  if (rest % 2 == 0)
+  {
+    factors.push_back(2);
+    rest /= 2;
+  }
+  for (int p = 3; p <= vtkFftMaxGenericRadix && rest > 1; p += 2)
+  {
+    while (rest % p == 0)
+    {
+      factors.push_back(p);
+      rest /= p;
+    }
+  }
+
+  if (rest == 1)
+  {
+    int length = n;
+    for (size_t i = 0; i < factors.size(); ++i)
+    {
+      this->AddStage(factors[i], length);
+      length /= factors[i];
+    }
+    return;
+  }
+
+  // A large prime factor: convolve with a chirp of power of two size.
+  int m = 1;
+  while (m < 2 * n - 1)
+  {
+    m *= 2;
+  }
+  this->Convolution = new vtkFftPlan(m);
+  this->Chirp.resize(n);
+  for (long long k = 0; k < n; ++k)
+  {
+    // exp(-i pi k^2 / n) = W_2n^(k^2)
+    this->Chirp[k] = vtkFftRoot(k * k, 2LL * n);
+  }
+  std::vector<vtkImageComplex> b(m);
+  std::vector<vtkImageComplex> work(m);
+  for (int k = 0; k < m; ++k)
+  {
+    b[k].Real = 0.0;
+    b[k].Imag = 0.0;
+  }
+  for (int k = 0; k < n; ++k)
+  {
+    vtkImageComplexConjugate(this->Chirp[k], b[k]);
+    if (k > 0)
+    {
+      b[m - k] = b[k];
+    }
+  }
+  vtkImageComplex *spectrum = this->Convolution->Execute(&b[0], &work[0], 1);
+  this->ChirpSpectrum.resize(m);
+  for (int k = 0; k < m; ++k)
+  {
+    vtkImageComplexScale(this->ChirpSpectrum[k], 1.0 / m, spectrum[k]);
+  }
+}
 
-      p1 = p1 + bsize;
+//----------------------------------------------------------------------------
+void vtkFftPlan::AddStage(int radix, int length)
+{
+  this->Stages.push_back(vtkFftStage());
+  vtkFftStage &stage = this->Stages.back();
+  stage.Radix = radix;
+  stage.Length = length;
+  const int m = length / radix;
+  stage.Twiddles.resize(static_cast<size_t>(m) * (radix - 1));
+  for (int j = 0; j < m; ++j)
+  {
+    for (int k = 1; k < radix; ++k)
+    {
+      stage.Twiddles[(radix - 1) * j + k - 1] =
+        vtkFftRoot(static_cast<long long>(j) * k, length);
+    }
+  }
+  if (radix != 2 && radix != 3 && radix != 4 && radix != 5 && radix != 8)
+  {
+    stage.Roots.resize(radix);
+    for (int k = 0; k < radix; ++k)
+    {
+      stage.Roots[k] = vtkFftRoot(k, radix);
     }
   }
 }
 
+//----------------------------------------------------------------------------
+vtkImageComplex *vtkFftPlan::Execute(vtkImageComplex *x, vtkImageComplex *y,
+                                     int count) const
+{
+  if (this->Convolution)
+  {
+    return this->ExecuteBluestein(x, y, count);
+  }
 
+  // Each stage multiplies the number of interleaved transforms by its radix.
+  for (size_t i = 0; i < this->Stages.size(); ++i)
+  {
+    const vtkFftStage &stage = this->Stages[i];
+    switch (stage.Radix)
+    {
+      case 2:
+        vtkFftButterfly2(stage, x, y, count);
+        break;
+      case 3:
+        vtkFftButterfly3(stage, x, y, count);
+        break;
+      case 4:
+        vtkFftButterfly4(stage, x, y, count);
+        break;
+      case 5:
+        vtkFftButterfly5(stage, x, y, count);
+        break;
+      case 8:
+        vtkFftButterfly8(stage, x, y, count);
+        break;
+      default:
+        vtkFftButterflyN(stage, x, y, count);
+        break;
+    }
+    count *= stage.Radix;
+    std::swap(x, y);
+  }
+  return x;
+}
 
 //----------------------------------------------------------------------------
-// This function calculates the whole fft (or rfft) of an array.
-// The contents of the input array are changed.
-// It is engineered for no decimation so input and output cannot be equal.
-// (fb = 1) => fft, (fb = -1) => rfft;
-void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
-                                                      vtkImageComplex *out,
-                                                      int N, int fb)
+vtkImageComplex *vtkFftPlan::ExecuteBluestein(vtkImageComplex *x,
+                                              vtkImageComplex *y,
+                                              int count) const
 {
-  vtkImageComplex *p1, *p2, *p3;
-  int block_size = 1;
-  int rest_size = N;
-  int n = 2;
-  int idx;
+  const int n = this->Size;
+  const int m = this->Convolution->Size;
+  std::vector<vtkImageComplex> work(2 * static_cast<size_t>(m) * count);
+  vtkImageComplex *a = &work[0];
+  vtkImageComplex *b = a + static_cast<size_t>(m) * count;
+
+  // Chirp the input and pad it with zeros.
+  for (int k = 0; k < n; ++k)
+  {
+    const vtkImageComplex &w = this->Chirp[k];
+    for (int q = 0; q < count; ++q)
+    {
+      const vtkImageComplex &c = x[q + static_cast<size_t>(count) * k];
+      vtkFftMultiply(c.Real, c.Imag, w, a[q + static_cast<size_t>(count) * k]);
+    }
+  }
+  for (size_t i = static_cast<size_t>(n) * count;
+       i < static_cast<size_t>(m) * count; ++i)
+  {
+    a[i].Real = 0.0;
+    a[i].Imag = 0.0;
+  }
 
-  // If this is a reverse transform (scale accordingly).
-  if(fb == -1)
+  // Convolve with the conjugate chirp, the inverse transform being computed
+  // with the conjugates.
+  vtkImageComplex *c = this->Convolution->Execute(a, b, count);
+  for (int k = 0; k < m; ++k)
   {
-    p1 = in;
-    for(idx = 0; idx < N; ++idx)
+    const vtkImageComplex &w = this->ChirpSpectrum[k];
+    for (int q = 0; q < count; ++q)
     {
-      p1->Real = p1->Real / N;
-      p1->Imag = p1->Imag / N;
-      ++p1;
+      vtkImageComplex &z = c[q + static_cast<size_t>(count) * k];
+      vtkFftMultiply(z.Real, z.Imag, w, z);
+      z.Imag = -z.Imag;
     }
   }
-  p1 = in;
-  p2 = out;
-  while(block_size < N && n <= N)
+  c = this->Convolution->Execute(c, c == a ? b : a, count);
+
+  for (int k = 0; k < n; ++k)
   {
-    if((rest_size % n) == 0)
+    const vtkImageComplex &w = this->Chirp[k];
+    for (int q = 0; q < count; ++q)
     {
-      // n is a prime factor, perform one "butterfly" stage of the fft.
-      if(n == 2)
-      {
-        this->ExecuteFftStep2(p1, p2, N, block_size, fb);
-      }
-      else
-      {
-        this->ExecuteFftStepN(p1, p2, N, block_size, n, fb);
-      }
-      block_size = block_size * n;
-      rest_size = rest_size / n;
-      // switch input and output.
-      p3 = p1;
-      p1 = p2;
-      p2 = p3;
+      const vtkImageComplex &z = c[q + static_cast<size_t>(count) * k];
+      vtkFftMultiply(z.Real, -z.Imag, w, y[q + static_cast<size_t>(count) * k]);
+    }
+  }
+  return y;
+}
+
+//----------------------------------------------------------------------------
+// The plans of the sizes transformed so far, shared by all the filters.
+class vtkFftPlanCache
+{
+public:
+  vtkFftPlanCache() {}
+  ~vtkFftPlanCache()
+  {
+    std::map<int, vtkFftPlan*>::iterator it;
+    for (it = this->Plans.begin(); it != this->Plans.end(); ++it)
+    {
+      delete it->second;
+    }
+  }
+
+  const vtkFftPlan *GetPlan(int n)
+  {
+    this->Lock.Lock();
+    vtkFftPlan *&plan = this->Plans[n];
+    if (!plan)
+    {
+      plan = new vtkFftPlan(n);
     }
-    else
+    this->Lock.Unlock();
+    return plan;
+  }
+
+private:
+  vtkSimpleCriticalSection Lock;
+  std::map<int, vtkFftPlan*> Plans;
+};
+
+//----------------------------------------------------------------------------
+const vtkFftPlan *vtkGetFftPlan(int n)
+{
+  static vtkFftPlanCache cache;
+  return cache.GetPlan(n);
+}
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFftBatch(vtkImageComplex *in,
+                                            vtkImageComplex *out, int N,
+                                            int count, int fb)
+{
+  if (N < 1 || count < 1)
+  {
+    return;
+  }
+  const size_t size = static_cast<size_t>(N) * count;
+
+  // The reverse transform is the conjugate of the transform of the
+  // conjugate (scaled accordingly).
+  if (fb == -1)
+  {
+    for (size_t i = 0; i < size; ++i)
     {
-      // n is not a prime factor. increment n to see if n+1 is.
-      ++n;
+      in[i].Real = in[i].Real / N;
+      in[i].Imag = -in[i].Imag / N;
     }
   }
-  // If the results ended up in the input, copy to output.
-  if(p1 != out)
+
+  vtkImageComplex *result = vtkGetFftPlan(N)->Execute(in, out, count);
+  if (result != out)
   {
-    for(n = 0; n < N; ++n)
+    std::copy(result, result + size, out);
+  }
+
+  if (fb == -1)
+  {
+    for (size_t i = 0; i < size; ++i)
     {
-      *out++ = *p1++;
+      out[i].Imag = -out[i].Imag;
     }
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteRealFftBatch(const double *in,
+                                                vtkImageComplex *out, int N,
+                                                int count)
+{
+  if (N < 1 || count < 1)
+  {
+    return;
+  }
+  const size_t c = static_cast<size_t>(count);
+  if (N % 2 == 1)
+  {
+    std::vector<vtkImageComplex> complexIn(N * c);
+    for (size_t i = 0; i < N * c; ++i)
+    {
+      complexIn[i].Real = in[i];
+      complexIn[i].Imag = 0.0;
+    }
+    this->ExecuteFftBatch(&complexIn[0], out, N, count, 1);
+    return;
+  }
+
+  // Transform the even and odd values as the real and imaginary parts of
+  // arrays of half the size, using both halves of out.
+  const int h = N / 2;
+  vtkImageComplex *z = out;
+  for (int j = 0; j < h; ++j)
+  {
+    for (size_t q = 0; q < c; ++q)
+    {
+      z[q + c * j].Real = in[q + c * 2 * j];
+      z[q + c * j].Imag = in[q + c * (2 * j + 1)];
+    }
+  }
+  vtkImageComplex *result = vtkGetFftPlan(h)->Execute(z, out + h * c, count);
+  if (result != z)
+  {
+    std::copy(result, result + h * c, z);
+  }
 
+  // Split the spectra of the even and odd values, in place, k and h - k at
+  // once: X_k = E_k + W_N^k O_k and X_(h-k) = conj(E_k - W_N^k O_k).
+  const vtkImageComplex *w = &vtkGetFftPlan(N)->RealTwiddles[0];
+  for (size_t q = 0; q < c; ++q)
+  {
+    double r = z[q].Real, i = z[q].Imag;
+    z[q].Real = r + i;
+    z[q].Imag = 0.0;
+    out[q + c * h].Real = r - i;
+    out[q + c * h].Imag = 0.0;
+  }
+  for (int k = 1; k <= h / 2; ++k)
+  {
+    vtkImageComplex *zk = z + c * k;
+    vtkImageComplex *zm = z + c * (h - k);
+    for (size_t q = 0; q < c; ++q)
+    {
+      double er = 0.5 * (zk[q].Real + zm[q].Real);
+      double ei = 0.5 * (zk[q].Imag - zm[q].Imag);
+      vtkImageComplex t;
+      vtkFftMultiply(0.5 * (zk[q].Imag + zm[q].Imag),
+                     0.5 * (zm[q].Real - zk[q].Real), w[k], t);
+      zk[q].Real = er + t.Real;
+      zk[q].Imag = ei + t.Imag;
+      zm[q].Real = er - t.Real;
+      zm[q].Imag = t.Imag - ei;
+    }
+  }
+
+  // The upper half is the conjugate of the lower half.
+  for (int k = 1; k < h; ++k)
+  {
+    const vtkImageComplex *xk = out + c * k;
+    vtkImageComplex *xm = out + c * (N - k);
+    for (size_t q = 0; q < c; ++q)
+    {
+      vtkImageComplexConjugate(xk[q], xm[q]);
+    }
+  }
+}
 
 //----------------------------------------------------------------------------
 // This function calculates the whole fft of an array.
@@ -215,7 +708,7 @@ void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
 void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
                                        vtkImageComplex *out, int N)
 {
-  this->ExecuteFftForwardBackward(in, out, N, 1);
+  this->ExecuteFftBatch(in, out, N, 1, 1);
 }
 
 //----------------------------------------------------------------------------
@@ -225,7 +718,7 @@ void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
 void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in,
                                         vtkImageComplex *out, int N)
 {
-  this->ExecuteFftForwardBackward(in, out, N, -1);
+  this->ExecuteFftBatch(in, out, N, 1, -1);
 }
 
 //----------------------------------------------------------------------------
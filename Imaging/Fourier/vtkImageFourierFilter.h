@@ -20,6 +20,12 @@
  * this superclass is a container for methods that manipulate these structure
  * including fast Fourier transforms.  Complex numbers may become a class.
  * This should really be a helper class.
+ *
+ * The transforms of a given size are planned once (factorization and
+ * twiddle factors) and the plans are shared by all the filters and threads.
+ * Sizes made of factors up to 31 use a mixed radix algorithm with
+ * specialized radix 2, 3, 4, 5 and 8 butterflies, and the other sizes use the
+ * Bluestein algorithm, so that any size is computed in O(N log N).
 */
 
 #ifndef vtkImageFourierFilter_h
@@ -108,17 +114,28 @@ public:
    */
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
+  /**
+   * This function calculates the fft (fb = 1) or the rfft (fb = -1) of count
+   * arrays of size N at once, which is faster than transforming them one by
+   * one.  The element i of the array j is at index j + count * i in both in
+   * and out.  The contents of the input array are changed.
+   */
+  void ExecuteFftBatch(vtkImageComplex *in, vtkImageComplex *out, int N,
+                       int count, int fb);
+
+  /**
+   * This function calculates the fft of count real arrays of size N at once,
+   * with the same layout as ExecuteFftBatch().  Even sizes are computed with
+   * complex transforms of half the size.  The whole spectrum is written in
+   * out, which must have room for N * count complex numbers.
+   */
+  void ExecuteRealFftBatch(const double *in, vtkImageComplex *out, int N,
+                           int count);
+
 protected:
   vtkImageFourierFilter() {}
   ~vtkImageFourierFilter() override {}
 
-  void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out,
-                       int N, int bsize, int fb);
-  void ExecuteFftStepN(vtkImageComplex *p_in, vtkImageComplex *p_out,
-                       int N, int bsize, int n, int fb);
-  void ExecuteFftForwardBackward(vtkImageComplex *in, vtkImageComplex *out,
-                                 int N, int fb);
-
   /**
    * Override to change extent splitting rules.
    */
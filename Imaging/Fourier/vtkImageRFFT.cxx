@@ -20,10 +20,15 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageRFFT);
 
+// Number of rows transformed at once.
+#define VTK_IMAGE_RFFT_BATCH 16
+
 //----------------------------------------------------------------------------
 // This extent of the components changes to real and imaginary values.
 int vtkImageRFFT::IterativeRequestInformation(
@@ -67,8 +72,6 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
                          vtkImageData *outData, int outExt[6], double *outPtr,
                          int id)
 {
-  vtkImageComplex *inComplex;
-  vtkImageComplex *outComplex;
   vtkImageComplex *pComplex;
   //
   int inMin0, inMax0;
@@ -80,12 +83,13 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int batch, rowIdx;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
 
-  startProgress = self->GetIteration()/
-    static_cast<double>(self->GetNumberOfIterations());
+  startProgress =
+    self->GetIteration()/static_cast<double>(self->GetNumberOfIterations());
 
   // Reorder axes (The outs here are just placeholdes
   self->PermuteExtent(inExt, inMin0, inMax0, outMin1,outMax1,outMin2,outMax2);
@@ -103,9 +107,12 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
     return;
   }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the arrays of complex numbers, for a batch of rows transformed
+  // at once (the element idx0 of the row rowIdx is at rowIdx + batch * idx0).
+  std::vector<vtkImageComplex> inComplex(
+    static_cast<size_t>(inSize0) * VTK_IMAGE_RFFT_BATCH);
+  std::vector<vtkImageComplex> outComplex(
+    static_cast<size_t>(inSize0) * VTK_IMAGE_RFFT_BATCH);
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -118,9 +125,11 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
   {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += batch)
     {
-      if (!id)
+      batch = std::min(VTK_IMAGE_RFFT_BATCH, outMax1 - idx1 + 1);
+      for (rowIdx = 0; !id && rowIdx < batch; ++rowIdx)
       {
         if (!(count%target))
         {
@@ -130,46 +139,51 @@ void vtkImageRFFTExecute(vtkImageRFFT *self,
       }
       // copy into complex numbers
       inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      for (idx0 = 0; idx0 < inSize0; ++idx0)
       {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
-        { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+        T *inRowPtr = inPtr0;
+        pComplex = &inComplex[static_cast<size_t>(batch) * idx0];
+        for (rowIdx = 0; rowIdx < batch; ++rowIdx)
+        {
+          pComplex->Real = static_cast<double>(*inRowPtr);
+          pComplex->Imag = 0.0;
+          if (numberOfComponents > 1)
+          { // yes we have an imaginary input
+            pComplex->Imag = static_cast<double>(inRowPtr[1]);
+          }
+          inRowPtr += inInc1;
+          ++pComplex;
         }
         inPtr0 += inInc0;
-        ++pComplex;
       }
 
       // Call the method that performs the RFFT
-      self->ExecuteRfft(inComplex, outComplex, inSize0);
+      self->ExecuteFftBatch(&inComplex[0], &outComplex[0], inSize0, batch, -1);
 
       // copy into output
       outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
+      pComplex = &outComplex[static_cast<size_t>(batch) * (outMin0 - inMin0)];
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
       {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
+        double *outRowPtr = outPtr0;
+        for (rowIdx = 0; rowIdx < batch; ++rowIdx)
+        {
+          *outRowPtr = pComplex->Real;
+          outRowPtr[1] = pComplex->Imag;
+          outRowPtr += outInc1;
+          ++pComplex;
+        }
         outPtr0 += outInc0;
-        ++pComplex;
       }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += batch * inInc1;
+      outPtr1 += batch * outInc1;
     }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
   }
-
-  delete [] inComplex;
-  delete [] outComplex;
 }
 
 
-
-
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the RFFT
 // algorithm to fill the output from the input.
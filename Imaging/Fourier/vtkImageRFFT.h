@@ -21,9 +21,10 @@
  * the output is always complex doubles with real values in component0, and
  * imaginary values in component1.  The filter is fastest for images that
  * have power of two sizes.  The filter uses butterfly filters for each
- * prime factor of the dimension.  This makes images with prime number dimensions
- * (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes)
- * FFT's are decomposed so that each axis executes in series.
+ * prime factor of the dimension, and the Bluestein algorithm for dimensions
+ * with large prime factors (i.e. 1021), which are about four times slower
+ * to compute.  Multi dimensional (i.e volumes) FFT's are decomposed so that
+ * each axis executes in series, the rows being transformed in batches.
  * In most cases the RFFT will produce an image whose imaginary values are all
  * zero's. In this case vtkImageExtractComponents can be used to remove
  * this imaginary components leaving only the real image.
@@ -23,10 +23,9 @@
 #include "vtkTableFFT.h"
 
 #include "vtkDataArray.h"
-#include "vtkImageData.h"
+#include "vtkDoubleArray.h"
 #include "vtkImageFFT.h"
 #include "vtkObjectFactory.h"
-#include "vtkPointData.h"
 #include "vtkTable.h"
 
 #include "vtkSmartPointer.h"
@@ -34,6 +33,7 @@
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <cstring>
+#include <vector>
 
 #include <vtksys/SystemTools.hxx>
 using namespace vtksys;
@@ -99,17 +99,30 @@ int vtkTableFFT::RequestData(vtkInformation *vtkNotUsed(request),
 //-----------------------------------------------------------------------------
 vtkSmartPointer<vtkDataArray> vtkTableFFT::DoFFT(vtkDataArray *input)
 {
-  // Build an image data containing the input data.
-  VTK_CREATE(vtkImageData, imgInput);
-  imgInput->SetDimensions(input->GetNumberOfTuples(), 1, 1);
-  imgInput->SetScalarType(input->GetDataType(), input->GetInformation());
-  imgInput->GetPointData()->SetScalars(input);
-
-  // Compute the FFT
-  VTK_CREATE(vtkImageFFT, fft);
-  fft->SetInputData(imgInput);
-  fft->Update();
+  // Transform the values directly with the fft of vtkImageFFT, the columns
+  // having a single component.
+  vtkIdType numValues = input->GetNumberOfTuples();
+  std::vector<double> values(numValues);
+  for (vtkIdType i = 0; i < numValues; i++)
+  {
+    values[i] = input->GetComponent(i, 0);
+  }
+  std::vector<vtkImageComplex> spectrum(numValues);
+  if (numValues > 0)
+  {
+    VTK_CREATE(vtkImageFFT, fft);
+    fft->ExecuteRealFftBatch(&values[0], &spectrum[0],
+                             static_cast<int>(numValues), 1);
+  }
 
   // Return the result
-  return vtkSmartPointer<vtkDataArray>(fft->GetOutput()->GetPointData()->GetScalars());
+  VTK_CREATE(vtkDoubleArray, frequencies);
+  frequencies->SetNumberOfComponents(2);
+  frequencies->SetNumberOfTuples(numValues);
+  for (vtkIdType i = 0; i < numValues; i++)
+  {
+    frequencies->SetTypedComponent(i, 0, spectrum[i].Real);
+    frequencies->SetTypedComponent(i, 1, spectrum[i].Imag);
+  }
+  return frequencies;
 }
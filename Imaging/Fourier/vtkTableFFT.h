@@ -27,8 +27,8 @@
  *
  *
  * vtkTableFFT performs the Fast Fourier Transform on the columns of a table.
- * Internally, it shoves each column into an image data and then uses
- * vtkImageFFT to perform the actual FFT.
+ * Internally, it uses the FFT of vtkImageFFT on the values of each
+ * column.
  *
  *
  * @sa
@@ -21,6 +21,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <numeric>
 
 vtkStandardNewMacro(vtkImageHybridMedian2D);
@@ -37,6 +38,145 @@ vtkImageHybridMedian2D::vtkImageHybridMedian2D()
   this->HandleBoundaries = 1;
 }
 
+namespace
+{
+
+// The number of adjacent pixels whose medians are computed together.
+const int vtkHybridMedianLanes = 16;
+
+//----------------------------------------------------------------------------
+// Check that the values can be sorted without ambiguity, i.e. that values
+// that compare equal are identical: this is not true for signed zeros and
+// not-a-number values, for which std::sort is used.
+template <class T>
+inline bool vtkHybridMedianIsOrdered(const T *)
+{
+  return true;
+}
+
+template <class F>
+inline bool vtkHybridMedianIsOrderedReal(const F *values)
+{
+  bool ordered = true;
+  for (int l = 0; l < vtkHybridMedianLanes; l++)
+  {
+    ordered &= (values[l] == values[l] && values[l] != 0);
+  }
+  return ordered;
+}
+
+inline bool vtkHybridMedianIsOrdered(const float *values)
+{
+  return vtkHybridMedianIsOrderedReal(values);
+}
+
+inline bool vtkHybridMedianIsOrdered(const double *values)
+{
+  return vtkHybridMedianIsOrderedReal(values);
+}
+
+//----------------------------------------------------------------------------
+// Compare and exchange the values of all lanes of two wires.
+template <class T>
+inline void vtkHybridMedianSort(T *a, T *b)
+{
+  T x[vtkHybridMedianLanes];
+  T y[vtkHybridMedianLanes];
+  for (int l = 0; l < vtkHybridMedianLanes; l++)
+  {
+    x[l] = a[l];
+    y[l] = b[l];
+  }
+  // separate loops for a and b, which lets the compiler vectorize them
+  for (int l = 0; l < vtkHybridMedianLanes; l++)
+  {
+    a[l] = (y[l] < x[l] ? y[l] : x[l]);
+  }
+  for (int l = 0; l < vtkHybridMedianLanes; l++)
+  {
+    b[l] = (y[l] < x[l] ? x[l] : y[l]);
+  }
+}
+
+//----------------------------------------------------------------------------
+// The median of 9 values with 19 compare-exchange operations, the median
+// is left in the middle wire.
+template <class T>
+void vtkHybridMedianOf9(T *wires)
+{
+  static const int pairs[19][2] = {
+    { 1, 2 }, { 4, 5 }, { 7, 8 }, { 0, 1 }, { 3, 4 }, { 6, 7 }, { 1, 2 },
+    { 4, 5 }, { 7, 8 }, { 0, 3 }, { 5, 8 }, { 4, 7 }, { 3, 6 }, { 1, 4 },
+    { 2, 5 }, { 4, 7 }, { 4, 2 }, { 6, 4 }, { 4, 2 } };
+  for (int p = 0; p < 19; p++)
+  {
+    vtkHybridMedianSort(wires + pairs[p][0]*vtkHybridMedianLanes,
+                        wires + pairs[p][1]*vtkHybridMedianLanes);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Compute the output of vtkHybridMedianLanes adjacent pixels whose
+// neighborhoods are inside the image, for all components.  Returns false
+// if the values cannot be ordered without ambiguity.
+template <class T>
+bool vtkHybridMedianExecuteLanes(const T *inPtr, vtkIdType inInc0,
+                                 vtkIdType inInc1, int numComps,
+                                 T *outPtr, vtkIdType outInc0)
+{
+  // the offsets of the + and the x neighborhoods
+  const vtkIdType offsets[2][9] = {
+    { 0, -inInc0, -2*inInc0, inInc0, 2*inInc0,
+      -inInc1, -2*inInc1, inInc1, 2*inInc1 },
+    { 0, -inInc0 - inInc1, -2*(inInc0 + inInc1),
+      inInc0 + inInc1, 2*(inInc0 + inInc1),
+      -inInc0 + inInc1, 2*(-inInc0 + inInc1),
+      inInc0 - inInc1, 2*(inInc0 - inInc1) } };
+  T wires[2][9*vtkHybridMedianLanes];
+
+  for (int c = 0; c < numComps; c++)
+  {
+    bool ordered = true;
+    for (int h = 0; h < 2; h++)
+    {
+      for (int e = 0; e < 9; e++)
+      {
+        const T *ptr = inPtr + c + offsets[h][e];
+        T *wire = wires[h] + e*vtkHybridMedianLanes;
+        for (int l = 0; l < vtkHybridMedianLanes; l++)
+        {
+          wire[l] = ptr[l*inInc0];
+        }
+        ordered &= vtkHybridMedianIsOrdered(wire);
+      }
+    }
+    if (!ordered)
+    {
+      return false;
+    }
+
+    vtkHybridMedianOf9(wires[0]);
+    vtkHybridMedianOf9(wires[1]);
+
+    // the median of the two medians and the center
+    const T *median1 = wires[0] + 4*vtkHybridMedianLanes;
+    const T *median2 = wires[1] + 4*vtkHybridMedianLanes;
+    const T *center = inPtr + c;
+    for (int l = 0; l < vtkHybridMedianLanes; l++)
+    {
+      T low = (median2[l] < median1[l] ? median2[l] : median1[l]);
+      T high = (median2[l] < median1[l] ? median1[l] : median2[l]);
+      T value = center[l*inInc0];
+      value = (high < value ? high : value);
+      outPtr[l*outInc0 + c] = (value < low ? low : value);
+    }
+  }
+
+  return true;
+}
+
+} // end anonymous namespace
+
 template <class T>
 void vtkImageHybridMedian2DExecute(vtkImageHybridMedian2D *self,
                                    vtkImageData *inData, T *inPtr2,
@@ -87,10 +227,32 @@ void vtkImageHybridMedian2DExecute(vtkImageHybridMedian2D *self,
         }
         count++;
       }
+      // the pixels of this row whose neighborhoods are inside the image
+      int lanesMin0 = max0 + 1;
+      int lanesMax0 = max0;
+      if (idx1 - 2 >= wholeMin1 && idx1 + 2 <= wholeMax1)
+      {
+        lanesMin0 = std::max(min0, wholeMin0 + 2);
+        lanesMax0 = std::min(max0, wholeMax0 - 2);
+      }
+
       inPtr0 = inPtr1;
       outPtr0 = outPtr1;
       for (idx0 = min0; idx0 <= max0; ++idx0)
       {
+        if (idx0 >= lanesMin0 && idx0 + vtkHybridMedianLanes - 1 <= lanesMax0)
+        {
+          if (vtkHybridMedianExecuteLanes(inPtr0, inInc0, inInc1, numComps,
+                                          outPtr0, outInc0))
+          {
+            idx0 += vtkHybridMedianLanes - 1;
+            inPtr0 += vtkHybridMedianLanes*inInc0;
+            outPtr0 += vtkHybridMedianLanes*outInc0;
+            continue;
+          }
+          // these pixels need std::sort
+          lanesMin0 = idx0 + vtkHybridMedianLanes;
+        }
         inPtrC = inPtr0;
         outPtrC = outPtr0;
         for (idxC = 0; idxC < numComps; ++idxC)
@@ -22,6 +22,8 @@
  * initially: the median of the + neighbors and the median of the x
  * neighbors.  It then computes the median of these two values plus the center
  * pixel.  This result of this second median is the output pixel value.
+ * Away from the image boundaries, the medians are computed with a
+ * selection network for 16 adjacent pixels at once.
 */
 
 #ifndef vtkImageHybridMedian2D_h
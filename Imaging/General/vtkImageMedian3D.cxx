@@ -24,6 +24,9 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <algorithm> // for std::nth_element
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageMedian3D);
 
@@ -84,6 +87,14 @@ void vtkImageMedian3D::SetKernelSize(int size0, int size1, int size2)
 
 namespace {
 
+//-----------------------------------------------------------------------------
+// The median of an even number of values, as computed by the filter
+template<class T>
+inline T vtkMedianOfTwo(T low, T high)
+{
+  return low + (high - low)/2;
+}
+
 //-----------------------------------------------------------------------------
 // Compute the median with std::nth_element
 template<class T>
@@ -97,12 +108,411 @@ T vtkComputeMedianOfArray(T *aBegin, T *aEnd)
   if (aMid - aBegin == aEnd - aMid)
   {
     T *lowMid = std::max_element(aBegin, aMid);
-    m = *lowMid + (m - *lowMid)/2;
+    m = vtkMedianOfTwo(*lowMid, m);
   }
 
   return m;
 }
 
+//-----------------------------------------------------------------------------
+// The number of adjacent voxels whose medians are computed together by
+// the selection network.
+const int vtkMedianLanes = 16;
+
+// The largest kernel for which the selection network is used.
+const int vtkMedianNetworkMaxElements = 125;
+
+// The smallest kernel for which the sliding histogram is used.
+const int vtkMedianHistogramMinElements = 49;
+
+//-----------------------------------------------------------------------------
+// A selection network: the compare-exchange operations of Batcher's
+// odd-even merge sort, keeping only those that the median depends on.
+class vtkMedianNetwork
+{
+public:
+  vtkMedianNetwork(int n)
+  {
+    this->NumberOfElements = n;
+    this->NumberOfWires = 1;
+    while (this->NumberOfWires < n)
+    {
+      this->NumberOfWires *= 2;
+    }
+    int size = this->NumberOfWires;
+
+    std::vector<int> pairs;
+    for (int p = 1; p < size; p *= 2)
+    {
+      for (int k = p; k >= 1; k /= 2)
+      {
+        for (int j = k % p; j + k < size; j += 2*k)
+        {
+          for (int i = 0; i < k && i + j + k < size; i++)
+          {
+            if ((i + j)/(2*p) == (i + j + k)/(2*p))
+            {
+              pairs.push_back(i + j);
+              pairs.push_back(i + j + k);
+            }
+          }
+        }
+      }
+    }
+
+    // go backwards from the wires of the median, and discard the
+    // operations that do not change them
+    std::vector<char> needed(size, 0);
+    needed[n/2] = 1;
+    if (n % 2 == 0)
+    {
+      needed[n/2 - 1] = 1;
+    }
+    for (size_t c = pairs.size(); c > 0; c -= 2)
+    {
+      int a = pairs[c - 2];
+      int b = pairs[c - 1];
+      if (needed[a] || needed[b])
+      {
+        needed[a] = 1;
+        needed[b] = 1;
+        this->Pairs.push_back(b);
+        this->Pairs.push_back(a);
+      }
+    }
+    std::reverse(this->Pairs.begin(), this->Pairs.end());
+  }
+
+  int NumberOfElements;
+  int NumberOfWires;
+  std::vector<int> Pairs;
+};
+
+//-----------------------------------------------------------------------------
+// Check that the values can be sorted without ambiguity, i.e. that values
+// that compare equal are identical: this is not true for signed zeros and
+// not-a-number values, for which the filter falls back to nth_element.
+template<class T>
+inline bool vtkMedianIsOrdered(const T *)
+{
+  return true;
+}
+
+template<class F>
+inline bool vtkMedianIsOrderedReal(const F *values)
+{
+  bool ordered = true;
+  for (int l = 0; l < vtkMedianLanes; l++)
+  {
+    ordered &= (values[l] == values[l] && values[l] != 0);
+  }
+  return ordered;
+}
+
+inline bool vtkMedianIsOrdered(const float *values)
+{
+  return vtkMedianIsOrderedReal(values);
+}
+
+inline bool vtkMedianIsOrdered(const double *values)
+{
+  return vtkMedianIsOrderedReal(values);
+}
+
+//-----------------------------------------------------------------------------
+// Compute the medians of vtkMedianLanes adjacent voxels with the selection
+// network, for all components.  Each wire holds one value of the
+// neighborhood for all the voxels, so that each compare-exchange operates
+// on all the voxels at once.  Returns false if the values cannot be
+// ordered without ambiguity.
+template<class T>
+bool vtkMedianNetworkExecute(const vtkMedianNetwork& network,
+                             const vtkIdType *offsets, const T *inPtr,
+                             vtkIdType inInc0, int numComp, T *wires,
+                             T *outPtr)
+{
+  const int n = network.NumberOfElements;
+  const int *pairs = network.Pairs.data();
+  const size_t numPairs = network.Pairs.size()/2;
+
+  // pad with values that are sorted after all the others
+  const T pad = (std::numeric_limits<T>::has_infinity ?
+                 std::numeric_limits<T>::infinity() :
+                 std::numeric_limits<T>::max());
+
+  for (int c = 0; c < numComp; c++)
+  {
+    bool ordered = true;
+    for (int e = 0; e < n; e++)
+    {
+      const T *ptr = inPtr + offsets[e] + c;
+      T *wire = wires + e*vtkMedianLanes;
+      for (int l = 0; l < vtkMedianLanes; l++)
+      {
+        wire[l] = ptr[l*inInc0];
+      }
+      ordered &= vtkMedianIsOrdered(wire);
+    }
+    if (!ordered)
+    {
+      return false;
+    }
+    std::fill(wires + n*vtkMedianLanes,
+              wires + network.NumberOfWires*vtkMedianLanes, pad);
+
+    for (size_t p = 0; p < numPairs; p++)
+    {
+      T *a = wires + pairs[2*p]*vtkMedianLanes;
+      T *b = wires + pairs[2*p + 1]*vtkMedianLanes;
+      T x[vtkMedianLanes];
+      T y[vtkMedianLanes];
+      for (int l = 0; l < vtkMedianLanes; l++)
+      {
+        x[l] = a[l];
+        y[l] = b[l];
+      }
+      // separate loops for a and b, which lets the compiler vectorize them
+      for (int l = 0; l < vtkMedianLanes; l++)
+      {
+        a[l] = (y[l] < x[l] ? y[l] : x[l]);
+      }
+      for (int l = 0; l < vtkMedianLanes; l++)
+      {
+        b[l] = (y[l] < x[l] ? x[l] : y[l]);
+      }
+    }
+
+    const T *mid = wires + (n/2)*vtkMedianLanes;
+    const T *lowMid = mid - vtkMedianLanes;
+    for (int l = 0; l < vtkMedianLanes; l++)
+    {
+      outPtr[l*numComp + c] =
+        (n % 2 == 0 ? vtkMedianOfTwo(lowMid[l], mid[l]) : mid[l]);
+    }
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// A histogram of 8-bit or 16-bit integers, with a coarse level of 256
+// values per bin, for computing the medians of a sliding neighborhood.
+// The position of the last median is kept, so that the next one can be
+// found by moving from it.
+template<class T>
+class vtkMedianHistogram
+{
+public:
+  vtkMedianHistogram() :
+    Fine(size_t(1) << (8*sizeof(T)), 0),
+    Coarse(this->Fine.size()/256, 0),
+    Bin(0), Below(0) {}
+
+  static int Index(T v)
+  {
+    return static_cast<int>(v) -
+      static_cast<int>(std::numeric_limits<T>::min());
+  }
+
+  void Add(T v)
+  {
+    int i = Index(v);
+    this->Fine[i]++;
+    this->Coarse[i >> 8]++;
+    this->Below += (i < this->Bin);
+  }
+
+  void Remove(T v)
+  {
+    int i = Index(v);
+    this->Fine[i]--;
+    this->Coarse[i >> 8]--;
+    this->Below -= (i < this->Bin);
+  }
+
+  // Get the value of the given rank (from zero) in the histogram.
+  T Rank(int r)
+  {
+    int bin = this->Bin;
+    int below = this->Below;
+    while (below > r)
+    {
+      if ((bin & 255) == 0 && below - this->Coarse[(bin >> 8) - 1] > r)
+      {
+        bin -= 256;
+        below -= this->Coarse[bin >> 8];
+      }
+      else
+      {
+        bin--;
+        below -= this->Fine[bin];
+      }
+    }
+    while (below + this->Fine[bin] <= r)
+    {
+      if ((bin & 255) == 0 && below + this->Coarse[bin >> 8] <= r)
+      {
+        below += this->Coarse[bin >> 8];
+        bin += 256;
+      }
+      else
+      {
+        below += this->Fine[bin];
+        bin++;
+      }
+    }
+    this->Bin = bin;
+    this->Below = below;
+    return static_cast<T>(bin + std::numeric_limits<T>::min());
+  }
+
+private:
+  std::vector<int> Fine;
+  std::vector<int> Coarse;
+  int Bin;
+  int Below;
+};
+
+//-----------------------------------------------------------------------------
+// Compute the medians of a row of output voxels for one component with a
+// sliding histogram: each step removes the values of the column that
+// leaves the neighborhood, and adds those of the column that enters it.
+template<class T>
+void vtkMedianHistogramRow(vtkMedianHistogram<T>& hist, const T *inPtr,
+                           vtkIdType inInc0, vtkIdType inInc1,
+                           vtkIdType inInc2, int size1, int size2,
+                           int outMin0, int outMax0,
+                           int hoodMin0, int hoodMax0,
+                           int middleMin0, int middleMax0,
+                           T *outPtr, int numComp)
+{
+  // inPtr is the first voxel of the column at hoodMin0
+  const T *colPtr = inPtr;
+  for (int i = hoodMin0; i <= hoodMax0; i++)
+  {
+    const T *ptr2 = inPtr + (i - hoodMin0)*inInc0;
+    for (int k = 0; k < size2; k++)
+    {
+      const T *ptr1 = ptr2;
+      for (int j = 0; j < size1; j++)
+      {
+        hist.Add(*ptr1);
+        ptr1 += inInc1;
+      }
+      ptr2 += inInc2;
+    }
+  }
+
+  const int columnSize = size1*size2;
+  for (int outIdx0 = outMin0; outIdx0 <= outMax0; outIdx0++)
+  {
+    int n = (hoodMax0 - hoodMin0 + 1)*columnSize;
+    T m = hist.Rank(n/2);
+    if (n % 2 == 0)
+    {
+      m = vtkMedianOfTwo(hist.Rank(n/2 - 1), m);
+    }
+    *outPtr = m;
+    outPtr += numComp;
+
+    if (outIdx0 == outMax0)
+    {
+      break;
+    }
+    // shift neighborhood considering boundaries
+    if (outIdx0 >= middleMin0)
+    {
+      const T *ptr2 = colPtr;
+      for (int k = 0; k < size2; k++)
+      {
+        const T *ptr1 = ptr2;
+        for (int j = 0; j < size1; j++)
+        {
+          hist.Remove(*ptr1);
+          ptr1 += inInc1;
+        }
+        ptr2 += inInc2;
+      }
+      colPtr += inInc0;
+      ++hoodMin0;
+    }
+    if (outIdx0 < middleMax0)
+    {
+      ++hoodMax0;
+      const T *ptr2 = colPtr + (hoodMax0 - hoodMin0)*inInc0;
+      for (int k = 0; k < size2; k++)
+      {
+        const T *ptr1 = ptr2;
+        for (int j = 0; j < size1; j++)
+        {
+          hist.Add(*ptr1);
+          ptr1 += inInc1;
+        }
+        ptr2 += inInc2;
+      }
+    }
+  }
+
+  // empty the histogram for the next row
+  for (int i = hoodMin0; i <= hoodMax0; i++)
+  {
+    const T *ptr2 = colPtr + (i - hoodMin0)*inInc0;
+    for (int k = 0; k < size2; k++)
+    {
+      const T *ptr1 = ptr2;
+      for (int j = 0; j < size1; j++)
+      {
+        hist.Remove(*ptr1);
+        ptr1 += inInc1;
+      }
+      ptr2 += inInc2;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// The sliding histogram is only used for 8-bit and 16-bit integers, this
+// type is used to select the implementation at compile time.
+template<class T>
+struct vtkMedianHasHistogram
+{
+  static const bool value = (std::numeric_limits<T>::is_integer &&
+                             sizeof(T) <= 2);
+};
+
+template<class T>
+class vtkMedianHistogramRows
+{
+public:
+  vtkMedianHistogramRows() : Histogram(nullptr) {}
+  ~vtkMedianHistogramRows() { delete this->Histogram; }
+
+  // Compute the medians of a row of output voxels for all components.
+  void Execute(std::true_type, const T *inPtr, vtkIdType inInc0,
+               vtkIdType inInc1, vtkIdType inInc2, int size1, int size2,
+               int outMin0, int outMax0, int hoodMin0, int hoodMax0,
+               int middleMin0, int middleMax0, T *outPtr, int numComp)
+  {
+    if (!this->Histogram)
+    {
+      this->Histogram = new vtkMedianHistogram<T>;
+    }
+    for (int c = 0; c < numComp; c++)
+    {
+      vtkMedianHistogramRow(*this->Histogram, inPtr + c, inInc0, inInc1,
+                            inInc2, size1, size2, outMin0, outMax0,
+                            hoodMin0, hoodMax0, middleMin0, middleMax0,
+                            outPtr + c, numComp);
+    }
+  }
+
+  void Execute(std::false_type, const T *, vtkIdType, vtkIdType, vtkIdType,
+               int, int, int, int, int, int, int, int, T *, int) {}
+
+private:
+  vtkMedianHistogram<T> *Histogram;
+};
+
 } // end anonymous namespace
 
 //-----------------------------------------------------------------------------
@@ -182,6 +592,34 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
                                       (outExt[3] - outExt[2] + 1)/50.0);
   target++;
 
+  // Select the fastest method for the kernel size and the data type: a
+  // sliding histogram for large kernels and 8-bit or 16-bit integers, or a
+  // selection network for the voxels whose neighborhood is complete in
+  // small kernels.  Both give the same medians as nth_element.
+  int numElements = self->GetNumberOfElements();
+  bool useHistogram = (vtkMedianHasHistogram<T>::value &&
+                       numElements >= vtkMedianHistogramMinElements);
+  bool useNetwork = (!useHistogram && numElements > 1 &&
+                     numElements <= vtkMedianNetworkMaxElements);
+  vtkMedianHistogramRows<T> histogramRows;
+  vtkMedianNetwork network(useNetwork ? numElements : 1);
+  std::vector<vtkIdType> offsets;
+  std::vector<T> wires;
+  if (useNetwork)
+  {
+    for (int k = 0; k < kernelSize[2]; k++)
+    {
+      for (int j = 0; j < kernelSize[1]; j++)
+      {
+        for (int i = 0; i < kernelSize[0]; i++)
+        {
+          offsets.push_back(i*inInc0 + j*inInc1 + k*inInc2);
+        }
+      }
+    }
+    wires.resize(network.NumberOfWires*vtkMedianLanes);
+  }
+
   // loop through pixel of output
   inPtr = static_cast<T *>(
     inArray->GetVoidPointer((hoodMin0 - inExt[0])* inInc0 +
@@ -204,48 +642,93 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
         }
         count++;
       }
-      inPtr0 = inPtr1;
-      hoodMin0 = hoodStartMin0;
-      hoodMax0 = hoodStartMax0;
-      for (outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
+      if (useHistogram)
+      {
+        histogramRows.Execute(
+          std::integral_constant<bool, vtkMedianHasHistogram<T>::value>(),
+          inPtr1, inInc0, inInc1, inInc2, hoodMax1 - hoodMin1 + 1,
+          hoodMax2 - hoodMin2 + 1, outExt[0], outExt[1],
+          hoodStartMin0, hoodStartMax0, middleMin0, middleMax0,
+          outPtr, numComp);
+        outPtr += (outExt[1] - outExt[0] + 1)*numComp;
+      }
+      else
       {
-        for (outIdxC = 0; outIdxC < numComp; outIdxC++)
+        // the voxels of this row that can use the selection network
+        int networkMin0 = outExt[1] + 1;
+        int networkMax0 = outExt[1];
+        if (useNetwork && hoodMax1 - hoodMin1 + 1 == kernelSize[1] &&
+            hoodMax2 - hoodMin2 + 1 == kernelSize[2])
         {
-          // Compute median of neighborhood
-          T *workEnd = workArray;
+          networkMin0 = (middleMin0 > outExt[0] ? middleMin0 : outExt[0]);
+          networkMax0 = (middleMax0 < outExt[1] ? middleMax0 : outExt[1]);
+        }
 
-          // loop through neighborhood pixels
-          tmpPtr2 = inPtr0 + outIdxC;
-          for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+        inPtr0 = inPtr1;
+        hoodMin0 = hoodStartMin0;
+        hoodMax0 = hoodStartMax0;
+        for (outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
+        {
+          bool batch = (outIdx0 >= networkMin0 &&
+                        outIdx0 + vtkMedianLanes - 1 <= networkMax0);
+          if (batch &&
+              !vtkMedianNetworkExecute(network, offsets.data(), inPtr0, inInc0,
+                                       numComp, wires.data(), outPtr))
+          {
+            // these voxels need nth_element
+            networkMin0 = outIdx0 + vtkMedianLanes;
+            batch = false;
+          }
+          if (batch)
+          {
+            // the last of these voxels shifts the neighborhood as usual
+            outIdx0 += vtkMedianLanes - 1;
+            inPtr0 += (vtkMedianLanes - 1)*inInc0;
+            hoodMin0 += vtkMedianLanes - 1;
+            hoodMax0 += vtkMedianLanes - 1;
+            outPtr += vtkMedianLanes*numComp;
+          }
+          else
           {
-            tmpPtr1 = tmpPtr2;
-            for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+            for (outIdxC = 0; outIdxC < numComp; outIdxC++)
             {
-              tmpPtr0 = tmpPtr1;
-              for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
+              // Compute median of neighborhood
+              T *workEnd = workArray;
+
+              // loop through neighborhood pixels
+              tmpPtr2 = inPtr0 + outIdxC;
+              for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
               {
-                // Add this pixel to the median
-                *workEnd++ = *tmpPtr0;
-                tmpPtr0 += inInc0;
+                tmpPtr1 = tmpPtr2;
+                for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                  tmpPtr0 = tmpPtr1;
+                  for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
+                  {
+                    // Add this pixel to the median
+                    *workEnd++ = *tmpPtr0;
+                    tmpPtr0 += inInc0;
+                  }
+                  tmpPtr1 += inInc1;
+                }
+                tmpPtr2 += inInc2;
               }
-              tmpPtr1 += inInc1;
+
+              // Replace this pixel with the hood median
+              *outPtr++ = vtkComputeMedianOfArray(workArray, workEnd);
             }
-            tmpPtr2 += inInc2;
           }
 
-          // Replace this pixel with the hood median
-          *outPtr++ = vtkComputeMedianOfArray(workArray, workEnd);
-        }
-
-        // shift neighborhood considering boundaries
-        if (outIdx0 >= middleMin0)
-        {
-          inPtr0 += inInc0;
-          ++hoodMin0;
-        }
-        if (outIdx0 < middleMax0)
-        {
-          ++hoodMax0;
+          // shift neighborhood considering boundaries
+          if (outIdx0 >= middleMin0)
+          {
+            inPtr0 += inInc0;
+            ++hoodMin0;
+          }
+          if (outIdx0 < middleMax0)
+          {
+            ++hoodMax0;
+          }
         }
       }
       // shift neighborhood considering boundaries
@@ -21,6 +21,13 @@
  * Neighborhoods can be no more than 3 dimensional.  Setting one
  * axis of the neighborhood kernelSize to 1 changes the filter
  * into a 2D median.
+ *
+ * Kernels of up to 125 elements use a selection network that computes
+ * the medians of 16 adjacent voxels at once, and kernels of 49 elements
+ * or more use a sliding histogram for 8-bit and 16-bit integers.  Both
+ * give exactly the same values as sorting the neighborhood: floating-point
+ * neighborhoods that contain signed zeros or not-a-number values are still
+ * sorted, because the median then depends on the order of the values.
 */
 
 #ifndef vtkImageMedian3D_h
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageConnectivityFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the parallel execution of vtkImageConnectivityFilter gives
+// the same labels and region arrays as the serial execution, for all the
+// label and extraction modes, with any number of threads, and when the
+// labels overflow the output type.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageConnectivityFilter.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <cstring>
+
+namespace
+{
+
+// An image with many regions of all sizes, and values from 0 to 9.
+vtkSmartPointer<vtkImageData> MakeImage(int nx, int ny, int nz)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(nx, ny, nz);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short *ptr = static_cast<short *>(image->GetScalarPointer());
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+  for (int k = 0; k < nz; ++k)
+  {
+    for (int j = 0; j < ny; ++j)
+    {
+      for (int i = 0; i < nx; ++i)
+      {
+        // large blobs, and sparse noise
+        bool blob = (i % 12 < 7 && j % 10 < 6 && k % 8 < 5);
+        random->Next();
+        double value = random->GetValue() * (blob ? 11.0 : 40.0);
+        *ptr++ = static_cast<short>(value < 10.0 ? value : 0);
+      }
+    }
+  }
+  return image;
+}
+
+bool CompareIdArrays(vtkDataArray *a, vtkDataArray *b, const char *name)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    cerr << "Bad number of values in " << name << endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        cerr << "Bad value in " << name << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Compare(vtkImageConnectivityFilter *a, vtkImageConnectivityFilter *b)
+{
+  vtkImageData *imageA = a->GetOutput();
+  vtkImageData *imageB = b->GetOutput();
+  int extA[6], extB[6];
+  imageA->GetExtent(extA);
+  imageB->GetExtent(extB);
+  if (memcmp(extA, extB, sizeof(extA)) != 0 ||
+      imageA->GetScalarType() != imageB->GetScalarType())
+  {
+    cerr << "Bad output extent or type." << endl;
+    return false;
+  }
+  return CompareIdArrays(imageA->GetPointData()->GetScalars(),
+                         imageB->GetPointData()->GetScalars(), "labels") &&
+    CompareIdArrays(a->GetExtractedRegionLabels(),
+                    b->GetExtractedRegionLabels(), "region labels") &&
+    CompareIdArrays(a->GetExtractedRegionSizes(),
+                    b->GetExtractedRegionSizes(), "region sizes") &&
+    CompareIdArrays(a->GetExtractedRegionSeedIds(),
+                    b->GetExtractedRegionSeedIds(), "region seed ids") &&
+    CompareIdArrays(a->GetExtractedRegionExtents(),
+                    b->GetExtractedRegionExtents(), "region extents");
+}
+
+} // end anon namespace
+
+int TestImageConnectivityFilterParallel(int, char *[])
+{
+  vtkSmartPointer<vtkImageData> images[2] = {
+    MakeImage(48, 40, 30), MakeImage(200, 150, 1) };
+
+  vtkNew<vtkPolyData> seeds;
+  vtkNew<vtkPoints> seedPoints;
+  vtkNew<vtkDoubleArray> seedScalars;
+  for (int i = 0; i < 12; ++i)
+  {
+    seedPoints->InsertNextPoint(5 * i, 4 * i, 0);
+    seedScalars->InsertNextValue(i % 4 == 3 ? 0 : 2 * i + 1);
+  }
+  seeds->SetPoints(seedPoints);
+  seeds->GetPointData()->SetScalars(seedScalars);
+
+  const int labelTypes[2] = { VTK_UNSIGNED_CHAR, VTK_INT };
+  const int numThreads[4] = { 1, 2, 4, 0 };
+  bool overflow = false;
+  for (int im = 0; im < 2; ++im)
+  {
+    for (int config = 0; config < 2 * 3 * 3 * 2 * 2 * 3; ++config)
+    {
+      int c = config;
+      int labelType = labelTypes[c % 2];
+      c /= 2;
+      int labelMode = c % 3;
+      c /= 3;
+      int extractionMode = c % 3;
+      c /= 3;
+      bool useSeeds = (c % 2 == 1);
+      c /= 2;
+      bool extents = (c % 2 == 1);
+      c /= 2;
+      int ranges = c % 3;
+
+      vtkNew<vtkImageConnectivityFilter> serial;
+      vtkNew<vtkImageConnectivityFilter> parallel;
+      vtkImageConnectivityFilter *filters[2] = { serial, parallel };
+      for (int f = 0; f < 2; ++f)
+      {
+        filters[f]->SetInputData(images[im]);
+        filters[f]->SetLabelScalarType(labelType);
+        filters[f]->SetLabelMode(labelMode);
+        filters[f]->SetExtractionMode(extractionMode);
+        filters[f]->SetLabelConstantValue(7);
+        filters[f]->SetGenerateRegionExtents(extents);
+        if (useSeeds)
+        {
+          filters[f]->SetSeedData(seeds);
+        }
+        if (ranges == 1)
+        {
+          filters[f]->SetSizeRange(2, 500);
+          filters[f]->SetScalarRange(3.0, 8.0);
+        }
+        else if (ranges == 2)
+        {
+          filters[f]->SetSizeRange(10, VTK_ID_MAX);
+        }
+        filters[f]->SetParallelExecution(f == 1);
+      }
+      serial->Update();
+      overflow |= (labelType == VTK_UNSIGNED_CHAR &&
+        serial->GetNumberOfExtractedRegions() >= 254);
+
+      for (int t = 0; t < 4; ++t)
+      {
+        vtkSMPTools::Initialize(numThreads[t]);
+        parallel->Modified();
+        parallel->Update();
+        if (!Compare(serial, parallel))
+        {
+          cerr << "Parallel output differs with " << numThreads[t]
+               << " thread(s) for image " << im << " and configuration "
+               << config << endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // A part of the output only.
+      int extent[6] = { 3, 37, 5, 34, 0, im == 0 ? 25 : 0 };
+      serial->UpdateExtent(extent);
+      parallel->UpdateExtent(extent);
+      if (!Compare(serial, parallel))
+      {
+        cerr << "Parallel output of a sub-extent differs for image " << im
+             << " and configuration " << config << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  vtkSMPTools::Initialize(0);
+
+  if (!overflow)
+  {
+    cerr << "The labels never overflowed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
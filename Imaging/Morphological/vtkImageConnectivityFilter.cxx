@@ -61,6 +61,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkSMPTools.h"
 #include "vtkTemplateAliasMacro.h"
 #include "vtkTypeTraits.h"
 #include "vtkSmartPointer.h"
@@ -93,6 +94,8 @@ vtkImageConnectivityFilter::vtkImageConnectivityFilter()
 
   this->GenerateRegionExtents = 0;
 
+  this->ParallelExecution = 0;
+
   this->ExtractedRegionLabels = vtkIdTypeArray::New();
   this->ExtractedRegionSizes = vtkIdTypeArray::New();
   this->ExtractedRegionSeedIds = vtkIdTypeArray::New();
@@ -346,6 +349,21 @@ protected:
     OT *outPtr, unsigned char *maskPtr, int extent[6],
     vtkICF::RegionVector& regionInfo);
 
+  // Execute method for when no seeds are provided, that labels the runs of
+  // voxels of the rows with a parallel union-find.
+  template <class OT>
+  static void ParallelSeedlessExecute(
+    vtkImageConnectivityFilter *self,
+    vtkImageData *outData, vtkImageStencilData *stencil,
+    OT *outPtr, unsigned char *maskPtr, int extent[6],
+    vtkICF::RegionVector& regionInfo);
+
+  // Set the output for a run of voxels along x.
+  template <class OT>
+  static void FillRun(
+    OT *outPtr, vtkIdType outInc[3], int outLimits[6],
+    int x0, int x1, int y, int z, OT label);
+
 public:
   // Create a bit mask from the input
   template<class IT>
@@ -1350,6 +1368,368 @@ void vtkICF::SeedlessExecute(
   }
 }
 
+//----------------------------------------------------------------------------
+// A run of consecutive voxels of a row that are not set in the bitmask.
+struct vtkICFRun
+{
+  int x0;
+  int x1;
+};
+
+//----------------------------------------------------------------------------
+// The runs of all rows (the runs of row r go from rowStart[r] to
+// rowStart[r+1]) and the union-find forest of the runs.  The root of a
+// tree is always its first run in raster order.
+class vtkICFRuns
+{
+public:
+  std::vector<vtkIdType> rowStart;
+  std::vector<vtkICFRun> runs;
+  std::vector<vtkIdType> parent;
+
+  // Scan the bitmask for the runs of a row, and store them in
+  // rowRuns if it is not nullptr.  Returns the number of runs.
+  static vtkIdType ScanRow(
+    const unsigned char *maskPtr, vtkIdType bitOffset, int n,
+    vtkICFRun *rowRuns)
+  {
+    vtkIdType count = 0;
+    int x = 0;
+    while (x < n)
+    {
+      // skip the voxels that are set (excluded or already colored)
+      while (x < n && (maskPtr[(bitOffset + x) >> 3] &
+                       (1 << ((bitOffset + x) & 0x7))) != 0)
+      {
+        x++;
+      }
+      if (x == n)
+      {
+        break;
+      }
+      int x0 = x;
+      while (x < n && (maskPtr[(bitOffset + x) >> 3] &
+                       (1 << ((bitOffset + x) & 0x7))) == 0)
+      {
+        x++;
+      }
+      if (rowRuns)
+      {
+        rowRuns[count].x0 = x0;
+        rowRuns[count].x1 = x - 1;
+      }
+      count++;
+    }
+    return count;
+  }
+
+  vtkIdType Find(vtkIdType i)
+  {
+    while (this->parent[i] != i)
+    {
+      this->parent[i] = this->parent[this->parent[i]];
+      i = this->parent[i];
+    }
+    return i;
+  }
+
+  void Union(vtkIdType i, vtkIdType j)
+  {
+    i = this->Find(i);
+    j = this->Find(j);
+    if (i < j)
+    {
+      this->parent[j] = i;
+    }
+    else if (j < i)
+    {
+      this->parent[i] = j;
+    }
+  }
+
+  // Join the overlapping runs of two adjacent rows.
+  void JoinRows(vtkIdType row1, vtkIdType row2)
+  {
+    vtkIdType i = this->rowStart[row1];
+    vtkIdType iEnd = this->rowStart[row1 + 1];
+    vtkIdType j = this->rowStart[row2];
+    vtkIdType jEnd = this->rowStart[row2 + 1];
+    while (i < iEnd && j < jEnd)
+    {
+      const vtkICFRun &run1 = this->runs[i];
+      const vtkICFRun &run2 = this->runs[j];
+      if (run1.x1 >= run2.x0 && run2.x1 >= run1.x0)
+      {
+        this->Union(i, j);
+      }
+      if (run1.x1 < run2.x1)
+      {
+        i++;
+      }
+      else
+      {
+        j++;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template<class OT>
+void vtkICF::FillRun(
+  OT *outPtr, vtkIdType outInc[3], int outLimits[6],
+  int x0, int x1, int y, int z, OT label)
+{
+  if (outLimits != nullptr)
+  {
+    // clip the run with the output extent
+    if (y < outLimits[2] || y > outLimits[3] ||
+        z < outLimits[4] || z > outLimits[5])
+    {
+      return;
+    }
+    x0 = (x0 > outLimits[0] ? x0 : outLimits[0]) - outLimits[0];
+    x1 = (x1 < outLimits[1] ? x1 : outLimits[1]) - outLimits[0];
+    y -= outLimits[2];
+    z -= outLimits[4];
+  }
+
+  OT *ptr = outPtr + (x0*outInc[0] + y*outInc[1] + z*outInc[2]);
+  for (int x = x0; x <= x1; x++)
+  {
+    *ptr = label;
+    ptr += outInc[0];
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class OT>
+void vtkICF::ParallelSeedlessExecute(
+  vtkImageConnectivityFilter *self,
+  vtkImageData *outData, vtkImageStencilData *stencil,
+  OT *outPtr, unsigned char *maskPtr, int extent[6],
+  vtkICF::RegionVector& regionInfo)
+{
+  // Get execution parameters
+  int extractionMode = self->GetExtractionMode();
+  vtkIdType sizeRange[2];
+  self->GetSizeRange(sizeRange);
+  bool generateExtents = (self->GetGenerateRegionExtents() != 0);
+
+  vtkIdType outInc[3];
+  outData->GetIncrements(outInc);
+
+  int outExt[6];
+  outData->GetExtent(outExt);
+
+  // Indexing will go from 0 to maxIdX, and the lower limit if "extent" will
+  // be subracted from outExt.  If outExt was the same as extent, then nullptr
+  // is returned, else outExt is returned.
+  int maxIdx[3];
+  int *outLimits = vtkICF::ZeroBaseExtent(extent, outExt, maxIdx);
+
+  const int nx = maxIdx[0] + 1;
+  const vtkIdType ny = maxIdx[1] + 1;
+  const vtkIdType numRows = ny*(maxIdx[2] + 1);
+
+  // find the runs of each row, their number first
+  vtkICFRuns runs;
+  runs.rowStart.resize(numRows + 1);
+  runs.rowStart[0] = 0;
+  vtkSMPTools::For(0, numRows, [&](vtkIdType row, vtkIdType endRow)
+  {
+    for (; row < endRow; row++)
+    {
+      runs.rowStart[row + 1] =
+        vtkICFRuns::ScanRow(maskPtr, row*nx, nx, nullptr);
+    }
+  });
+  for (vtkIdType row = 0; row < numRows; row++)
+  {
+    runs.rowStart[row + 1] += runs.rowStart[row];
+  }
+  vtkIdType numRuns = runs.rowStart[numRows];
+  runs.runs.resize(numRuns);
+  runs.parent.resize(numRuns);
+  vtkSMPTools::For(0, numRows, [&](vtkIdType row, vtkIdType endRow)
+  {
+    for (; row < endRow; row++)
+    {
+      vtkIdType first = runs.rowStart[row];
+      vtkIdType last = runs.rowStart[row + 1];
+      if (first < last)
+      {
+        vtkICFRuns::ScanRow(maskPtr, row*nx, nx, &runs.runs[first]);
+      }
+      for (vtkIdType i = first; i < last; i++)
+      {
+        runs.parent[i] = i;
+      }
+    }
+  });
+
+  // join the runs of adjacent rows, within chunks of rows in parallel, and
+  // then across the chunk boundaries
+  vtkIdType numChunks = 4*vtkSMPTools::GetEstimatedNumberOfThreads();
+  vtkIdType chunkSize = (numRows + numChunks - 1)/numChunks;
+  numChunks = (numRows + chunkSize - 1)/chunkSize;
+  vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType chunk, vtkIdType endChunk)
+  {
+    for (; chunk < endChunk; chunk++)
+    {
+      vtkIdType firstRow = chunk*chunkSize;
+      vtkIdType endRow = std::min(firstRow + chunkSize, numRows);
+      for (vtkIdType row = firstRow; row < endRow; row++)
+      {
+        if (row % ny != 0 && row - 1 >= firstRow)
+        {
+          runs.JoinRows(row, row - 1);
+        }
+        if (row - ny >= firstRow)
+        {
+          runs.JoinRows(row, row - ny);
+        }
+      }
+    }
+  });
+  for (vtkIdType chunk = 1; chunk < numChunks; chunk++)
+  {
+    vtkIdType firstRow = chunk*chunkSize;
+    vtkIdType endRow = std::min(firstRow + std::min(chunkSize, ny), numRows);
+    if (firstRow % ny != 0)
+    {
+      runs.JoinRows(firstRow, firstRow - 1);
+    }
+    for (vtkIdType row = std::max(firstRow, ny); row < endRow; row++)
+    {
+      runs.JoinRows(row, row - ny);
+    }
+  }
+
+  // number the connected regions in raster order of their first voxel,
+  // which is the order in which the serial execution finds them (the
+  // parents become region numbers)
+  vtkIdType numRegions = 0;
+  for (vtkIdType i = 0; i < numRuns; i++)
+  {
+    vtkIdType p = runs.parent[i];
+    runs.parent[i] = (p == i ? numRegions++ : runs.parent[p]);
+  }
+
+  // compute the size and the extent of each region
+  vtkICF::RegionVector regions;
+  regions.resize(numRegions);
+  for (vtkIdType row = 0; row < numRows; row++)
+  {
+    int y = static_cast<int>(row % ny);
+    int z = static_cast<int>(row / ny);
+    for (vtkIdType i = runs.rowStart[row]; i < runs.rowStart[row + 1]; i++)
+    {
+      const vtkICFRun &run = runs.runs[i];
+      vtkICF::Region &region = regions[runs.parent[i]];
+      if (region.size == 0)
+      {
+        // the extent is the first voxel if extents are not generated
+        region.id = -1;
+        region.extent[0] = region.extent[1] = run.x0;
+        region.extent[2] = region.extent[3] = y;
+        region.extent[4] = region.extent[5] = z;
+      }
+      region.size += run.x1 - run.x0 + 1;
+      if (generateExtents)
+      {
+        int *ext = region.extent;
+        if (run.x0 < ext[0])
+        {
+          ext[0] = run.x0;
+        }
+        if (run.x1 > ext[1])
+        {
+          ext[1] = run.x1;
+        }
+        if (y < ext[2])
+        {
+          ext[2] = y;
+        }
+        if (y > ext[3])
+        {
+          ext[3] = y;
+        }
+        if (z > ext[5])
+        {
+          ext[5] = z;
+        }
+      }
+    }
+  }
+
+  OT maxLabel = vtkTypeTraits<OT>::Max();
+  if (regionInfo.size() + static_cast<size_t>(numRegions) <=
+      static_cast<size_t>(maxLabel))
+  {
+    // no regions will be pruned, set the output in parallel
+    OT firstLabel = static_cast<OT>(regionInfo.size());
+    vtkSMPTools::For(0, numRows, [&](vtkIdType row, vtkIdType endRow)
+    {
+      for (; row < endRow; row++)
+      {
+        int y = static_cast<int>(row % ny);
+        int z = static_cast<int>(row / ny);
+        for (vtkIdType i = runs.rowStart[row]; i < runs.rowStart[row + 1];
+             i++)
+        {
+          vtkICF::FillRun(outPtr, outInc, outLimits,
+            runs.runs[i].x0, runs.runs[i].x1, y, z,
+            static_cast<OT>(firstLabel + runs.parent[i]));
+        }
+      }
+    });
+    regionInfo.insert(regionInfo.end(), regions.begin(), regions.end());
+    return;
+  }
+
+  // the labels overflow the output type: add the regions one at a time, as
+  // the serial execution does, since regions are pruned as they are added
+  std::vector<vtkIdType> regionStart(numRegions + 1, 0);
+  for (vtkIdType i = 0; i < numRuns; i++)
+  {
+    regionStart[runs.parent[i] + 1]++;
+  }
+  for (vtkIdType r = 0; r < numRegions; r++)
+  {
+    regionStart[r + 1] += regionStart[r];
+  }
+  std::vector<std::pair<vtkIdType, vtkIdType> > regionRuns(numRuns);
+  std::vector<vtkIdType> next(regionStart.begin(), regionStart.end() - 1);
+  for (vtkIdType row = 0; row < numRows; row++)
+  {
+    for (vtkIdType i = runs.rowStart[row]; i < runs.rowStart[row + 1]; i++)
+    {
+      regionRuns[next[runs.parent[i]]++] = std::make_pair(i, row);
+    }
+  }
+
+  for (vtkIdType r = 0; r < numRegions; r++)
+  {
+    OT label = static_cast<OT>(regionInfo.size());
+    if (regions[r].size == 1 && label == maxLabel)
+    {
+      // smallest region is definitely this one, leave it out
+      continue;
+    }
+    for (vtkIdType j = regionStart[r]; j < regionStart[r + 1]; j++)
+    {
+      const vtkICFRun &run = runs.runs[regionRuns[j].first];
+      vtkIdType row = regionRuns[j].second;
+      vtkICF::FillRun(outPtr, outInc, outLimits, run.x0, run.x1,
+        static_cast<int>(row % ny), static_cast<int>(row / ny), label);
+    }
+    vtkICF::AddRegion(
+      outData, outPtr, stencil, extent, sizeRange, regionInfo,
+      regions[r].size, -1, regions[r].extent, extractionMode);
+  }
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class OT>
@@ -1377,9 +1757,18 @@ void vtkICF::ExecuteOutput(
   if (!seedData ||
       extractionMode == vtkImageConnectivityFilter::AllRegions)
   {
-    vtkICF::SeedlessExecute(
-      self, outData, stencil, outPtr, maskPtr, extent,
-      regionInfo);
+    if (self->GetParallelExecution())
+    {
+      vtkICF::ParallelSeedlessExecute(
+        self, outData, stencil, outPtr, maskPtr, extent,
+        regionInfo);
+    }
+    else
+    {
+      vtkICF::SeedlessExecute(
+        self, outData, stencil, outPtr, maskPtr, extent,
+        regionInfo);
+    }
   }
 
   // do final relabelling and other bookkeeping
@@ -1591,6 +1980,9 @@ void vtkImageConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "GenerateRegionExtents: "
      << (this->GenerateRegionExtents ? "On\n" : "Off\n");
 
+  os << indent << "ParallelExecution: "
+     << (this->ParallelExecution ? "On\n" : "Off\n");
+
   os << indent << "SeedConnection: "
      << this->GetSeedConnection() << "\n";
 
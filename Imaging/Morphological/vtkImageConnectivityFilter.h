@@ -263,6 +263,21 @@ public:
   vtkGetMacro(GenerateRegionExtents, vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Turn this on to find the regions with multiple threads.
+   * The runs of voxels of the rows are connected with a union-find, in
+   * parallel for chunks of rows and then across the chunks, instead of
+   * flood filling the regions one by one.  The output is the same as with
+   * the serial execution.  Only the search for unseeded regions is done in
+   * parallel, the regions connected to the seeds are still flood filled.
+   * This is off by default.
+   */
+  vtkSetMacro(ParallelExecution, vtkTypeBool);
+  vtkBooleanMacro(ParallelExecution, vtkTypeBool);
+  vtkGetMacro(ParallelExecution, vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set the size range for the extracted regions.
@@ -306,6 +321,7 @@ protected:
   int ActiveComponent;
   int LabelScalarType;
   vtkTypeBool GenerateRegionExtents;
+  vtkTypeBool ParallelExecution;
 
   vtkIdTypeArray *ExtractedRegionLabels;
   vtkIdTypeArray *ExtractedRegionSizes;
@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellCenterDepthSort.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkCellCenterDepthSort, which keeps the cell centers and
+// starts each traversal from the order of the previous one, returns all
+// the cells in the order of the depths of their centers as the camera
+// moves, when the input changes and for any number of cells per call.
+
+#include "vtkCamera.h"
+#include "vtkCellCenterDepthSort.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+bool CheckTraversal(vtkCellCenterDepthSort *sorter, vtkPolyData *input,
+                    vtkCamera *camera)
+{
+  double position[3], focalPoint[3];
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  double vector[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    vector[k] = sorter->GetDirection() == vtkVisibilitySort::BACK_TO_FRONT ?
+      position[k] - focalPoint[k] : focalPoint[k] - position[k];
+  }
+
+  vtkIdType numCells = input->GetNumberOfCells();
+  std::vector<bool> seen(numCells, false);
+  vtkIdType numSorted = 0;
+  double last = -VTK_DOUBLE_MAX;
+  sorter->InitTraversal();
+  for (vtkIdTypeArray *cells = sorter->GetNextCells(); cells;
+       cells = sorter->GetNextCells())
+  {
+    if (cells->GetNumberOfTuples() > sorter->GetMaxCellsReturned())
+    {
+      std::cerr << "Too many cells returned." << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < cells->GetNumberOfTuples(); ++i)
+    {
+      vtkIdType cid = cells->GetValue(i);
+      if (cid < 0 || cid >= numCells || seen[cid])
+      {
+        std::cerr << "The sorted cells are not a permutation." << std::endl;
+        return false;
+      }
+      seen[cid] = true;
+      numSorted++;
+
+      // the parametric center of a triangle is its centroid
+      vtkIdType npts;
+      vtkIdType *pts;
+      input->GetCellPoints(cid, npts, pts);
+      double depth = 0.0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        double x[3];
+        input->GetPoint(pts[j], x);
+        depth += (x[0] * vector[0] + x[1] * vector[1] + x[2] * vector[2]) /
+          npts;
+      }
+      if (depth < last - 1e-5)
+      {
+        std::cerr << "Cell " << cid << " sorted with depth " << depth
+                  << " after depth " << last << "." << std::endl;
+        return false;
+      }
+      last = std::max(last, depth);
+    }
+  }
+  if (numSorted != numCells)
+  {
+    std::cerr << numSorted << " cells sorted instead of " << numCells << "."
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestCellCenterDepthSort(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(300);
+  sphere->Update();
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+  input->BuildCells();
+
+  vtkNew<vtkCamera> camera;
+  camera->SetPosition(0.0, 0.0, 3.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+
+  vtkNew<vtkCellCenterDepthSort> sorter;
+  sorter->SetInput(input);
+  sorter->SetCamera(camera);
+
+  int maxCells[3] = { VTK_INT_MAX, 1000, 1 };
+  for (int dir = 0; dir < 2; ++dir)
+  {
+    sorter->SetDirection(dir);
+    for (int m = 0; m < 3; ++m)
+    {
+      sorter->SetMaxCellsReturned(maxCells[m]);
+      for (int i = 0; i < 10; ++i)
+      {
+        camera->Azimuth(1.0);
+        camera->Elevation(0.5);
+        camera->OrthogonalizeViewUp();
+        if (!CheckTraversal(sorter, input, camera))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // the centers are recomputed when the input changes
+  vtkPoints *points = input->GetPoints();
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    points->SetPoint(i, x[0] + 0.5 * x[1] * x[1], x[1], x[2] - x[0]);
+  }
+  points->Modified();
+  if (!CheckTraversal(sorter, input, camera))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,405 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestColorTransferFunctionMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the scalars mapped in parallel by vtkColorTransferFunction,
+// vtkDiscretizableColorTransferFunction and vtkLookupTable get the colors of
+// the evaluation of each scalar in turn, for any number of threads, and
+// that the mapping table of vtkColorTransferFunction gives nearly the same
+// colors inside the range and the same colors outside. The colors of a
+// subclass overriding GetColor() are those of its GetColor().
+
+#include "vtkColorTransferFunction.h"
+#include "vtkDataArray.h"
+#include "vtkDiscretizableColorTransferFunction.h"
+#include "vtkLookupTable.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+// Two components of random values, a tenth of them below or above the
+// range, and some NaN for the floating point types.
+vtkSmartPointer<vtkDataArray> MakeScalars(int type, vtkIdType numValues,
+                                          double min, double max)
+{
+  vtkSmartPointer<vtkDataArray> scalars = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(type));
+  scalars->SetNumberOfComponents(2);
+  scalars->SetNumberOfTuples(numValues);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(type);
+  double span = max - min;
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    random->Next();
+    double x = min - 0.05 * span + 1.1 * span * random->GetValue();
+    if (i % 101 == 7 && (type == VTK_FLOAT || type == VTK_DOUBLE))
+    {
+      x = vtkMath::Nan();
+    }
+    scalars->SetComponent(i, 0, x);
+    scalars->SetComponent(i, 1, -x);
+  }
+  return scalars;
+}
+
+// The colors of the first component of the scalars.
+std::vector<unsigned char> Map(vtkScalarsToColors *colors,
+                               vtkDataArray *scalars, int outFormat)
+{
+  vtkIdType numValues = scalars->GetNumberOfTuples();
+  std::vector<unsigned char> output(numValues * outFormat);
+  colors->MapScalarsThroughTable2(scalars->GetVoidPointer(0), output.data(),
+                                  scalars->GetDataType(),
+                                  static_cast<int>(numValues), 2, outFormat);
+  return output;
+}
+
+// The colors of the evaluation of each scalar in turn.
+std::vector<unsigned char> MapReference(vtkColorTransferFunction *ctf,
+                                        vtkDataArray *scalars, int outFormat)
+{
+  vtkIdType numValues = scalars->GetNumberOfTuples();
+  std::vector<unsigned char> output(numValues * outFormat);
+  unsigned char alpha = static_cast<unsigned char>(ctf->GetAlpha() * 255.0);
+  unsigned char *optr = output.data();
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    double rgb[3];
+    ctf->GetColor(scalars->GetComponent(i, 0), rgb);
+    if (outFormat == VTK_RGB || outFormat == VTK_RGBA)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        *(optr++) = static_cast<unsigned char>(rgb[c] * 255.0 + 0.5);
+      }
+    }
+    else
+    {
+      *(optr++) = static_cast<unsigned char>(rgb[0] * 76.5 + rgb[1] * 150.45 +
+                                             rgb[2] * 28.05 + 0.5);
+    }
+    if (outFormat == VTK_RGBA || outFormat == VTK_LUMINANCE_ALPHA)
+    {
+      *(optr++) = alpha;
+    }
+  }
+  return output;
+}
+
+// Compare the colors, with a tolerance only for the scalars inside the
+// range when inRangeTolerance is positive.
+bool Compare(const std::vector<unsigned char> &colors,
+             const std::vector<unsigned char> &expected, vtkDataArray *scalars,
+             const double range[2], int outFormat, int inRangeTolerance,
+             const char *what)
+{
+  for (size_t j = 0; j < expected.size(); ++j)
+  {
+    vtkIdType i = static_cast<vtkIdType>(j / outFormat);
+    double x = scalars->GetComponent(i, 0);
+    int tolerance = (x >= range[0] && x <= range[1] ? inRangeTolerance : 0);
+    if (std::abs(colors[j] - expected[j]) > tolerance)
+    {
+      std::cerr << "Bad " << what << " color of " << x << " (format "
+                << outFormat << "): " << static_cast<int>(colors[j])
+                << " instead of " << static_cast<int>(expected[j])
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void MakeFunction(vtkColorTransferFunction *ctf, bool logScale)
+{
+  double start = (logScale ? 0.1 : -10.0);
+  double end = (logScale ? 1000.0 : 30.0);
+  ctf->SetColorSpaceToLab();
+  ctf->AddRGBPoint(start, 0.1, 0.2, 0.9);
+  ctf->AddRGBPoint(start + 0.3 * (end - start), 0.9, 0.9, 0.2, 0.3, 0.2);
+  ctf->AddRGBPoint(start + 0.5 * (end - start), 0.0, 0.7, 0.1);
+  ctf->AddRGBPoint(end, 0.8, 0.1, 0.0);
+  ctf->SetScale(logScale ? VTK_CTF_LOG10 : VTK_CTF_LINEAR);
+  ctf->SetUseBelowRangeColor(true);
+  ctf->SetBelowRangeColor(1.0, 1.0, 1.0);
+  ctf->SetUseAboveRangeColor(true);
+  ctf->SetAboveRangeColor(0.0, 0.0, 0.0);
+  ctf->SetNanColor(0.5, 0.0, 0.5);
+  ctf->SetAlpha(0.6);
+}
+
+// A function giving the inverse colors.
+class vtkInverseColorTransferFunction : public vtkColorTransferFunction
+{
+public:
+  static vtkInverseColorTransferFunction *New();
+  vtkTypeMacro(vtkInverseColorTransferFunction, vtkColorTransferFunction);
+
+  void GetColor(double x, double rgb[3]) override
+  {
+    this->Superclass::GetColor(x, rgb);
+    for (int c = 0; c < 3; ++c)
+    {
+      rgb[c] = 1.0 - rgb[c];
+    }
+  }
+
+protected:
+  vtkInverseColorTransferFunction() = default;
+
+private:
+  vtkInverseColorTransferFunction(
+    const vtkInverseColorTransferFunction&) = delete;
+  void operator=(const vtkInverseColorTransferFunction&) = delete;
+};
+
+vtkStandardNewMacro(vtkInverseColorTransferFunction);
+
+bool TestColorTransferFunction(const int *numThreads, int numThreadCounts)
+{
+  const int types[3] = { VTK_FLOAT, VTK_DOUBLE, VTK_INT };
+  for (int logScale = 0; logScale < 2; ++logScale)
+  {
+    vtkNew<vtkColorTransferFunction> ctf;
+    MakeFunction(ctf, logScale != 0);
+    double *range = ctf->GetRange();
+    for (int t = 0; t < 3; ++t)
+    {
+      vtkSmartPointer<vtkDataArray> scalars =
+        MakeScalars(types[t], 30011, range[0], range[1]);
+      for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGBA; ++outFormat)
+      {
+        std::vector<unsigned char> expected =
+          MapReference(ctf, scalars, outFormat);
+        for (int n = 0; n < numThreadCounts; ++n)
+        {
+          vtkSMPTools::Initialize(numThreads[n]);
+          ctf->UseMappingTableOff();
+          if (!Compare(Map(ctf, scalars, outFormat), expected, scalars, range,
+                       outFormat, 0, "exact"))
+          {
+            return false;
+          }
+          ctf->UseMappingTableOn();
+          if (!Compare(Map(ctf, scalars, outFormat), expected, scalars, range,
+                       outFormat, 2, "table"))
+          {
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  // The exact colors of a subclass, even with the mapping table.
+  vtkNew<vtkInverseColorTransferFunction> inverse;
+  MakeFunction(inverse, false);
+  vtkSmartPointer<vtkDataArray> doubles =
+    MakeScalars(VTK_DOUBLE, 30011, -10.0, 30.0);
+  for (int useTable = 0; useTable < 2; ++useTable)
+  {
+    inverse->SetUseMappingTable(useTable);
+    for (int n = 0; n < numThreadCounts; ++n)
+    {
+      vtkSMPTools::Initialize(numThreads[n]);
+      if (!Compare(Map(inverse, doubles, VTK_RGB),
+                   MapReference(inverse, doubles, VTK_RGB), doubles,
+                   inverse->GetRange(), VTK_RGB, 0, "subclass"))
+      {
+        return false;
+      }
+    }
+  }
+
+  // The tables of the 8 and 16 bit scalars.
+  vtkNew<vtkColorTransferFunction> ctf;
+  ctf->AddRGBPoint(0.0, 0.0, 0.0, 1.0);
+  ctf->AddRGBPoint(65535.0, 1.0, 0.5, 0.0);
+  const int tableTypes[2] = { VTK_UNSIGNED_CHAR, VTK_UNSIGNED_SHORT };
+  for (int t = 0; t < 2; ++t)
+  {
+    // without negative values
+    vtkSmartPointer<vtkDataArray> scalars = MakeScalars(tableTypes[t], 30011,
+      t == 0 ? 12.0 : 3500.0, t == 0 ? 230.0 : 60000.0);
+    for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGBA; ++outFormat)
+    {
+      vtkSMPTools::Initialize(1);
+      std::vector<unsigned char> expected = Map(ctf, scalars, outFormat);
+      for (int n = 0; n < numThreadCounts; ++n)
+      {
+        vtkSMPTools::Initialize(numThreads[n]);
+        if (Map(ctf, scalars, outFormat) != expected)
+        {
+          std::cerr << "Bad colors of the " << scalars->GetDataTypeAsString()
+                    << " scalars with " << numThreads[n] << " thread(s)."
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestDiscretizable(const int *numThreads, int numThreadCounts)
+{
+  vtkNew<vtkDiscretizableColorTransferFunction> dctf;
+  MakeFunction(dctf, false);
+  vtkNew<vtkPiecewiseFunction> opacity;
+  opacity->AddPoint(-10.0, 0.0);
+  opacity->AddPoint(5.0, 0.8, 0.4, 0.5);
+  opacity->AddPoint(30.0, 0.3);
+  dctf->SetScalarOpacityFunction(opacity);
+  dctf->EnableOpacityMappingOn();
+  vtkSmartPointer<vtkDataArray> scalars =
+    MakeScalars(VTK_DOUBLE, 30011, -10.0, 30.0);
+  for (int discretize = 0; discretize < 2; ++discretize)
+  {
+    dctf->SetDiscretize(discretize);
+    dctf->Build();
+    for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGBA; ++outFormat)
+    {
+      vtkSMPTools::Initialize(1);
+      std::vector<unsigned char> expected = Map(dctf, scalars, outFormat);
+      if (outFormat == VTK_RGBA || outFormat == VTK_LUMINANCE_ALPHA)
+      {
+        for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+        {
+          double alpha = opacity->GetValue(scalars->GetComponent(i, 0));
+          if (expected[(i + 1) * outFormat - 1] !=
+              static_cast<unsigned char>(alpha * 255.0 + 0.5))
+          {
+            std::cerr << "Bad opacity of " << scalars->GetComponent(i, 0)
+                      << std::endl;
+            return false;
+          }
+        }
+      }
+      for (int n = 0; n < numThreadCounts; ++n)
+      {
+        vtkSMPTools::Initialize(numThreads[n]);
+        if (Map(dctf, scalars, outFormat) != expected)
+        {
+          std::cerr << "Bad discretizable colors (discretize " << discretize
+                    << ", format " << outFormat << ") with " << numThreads[n]
+                    << " thread(s)." << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  // Not discretized, the colors are those of a vtkColorTransferFunction,
+  // mapping table included (a small one, to get colors far from the exact
+  // ones).
+  vtkNew<vtkColorTransferFunction> ctf;
+  MakeFunction(ctf, false);
+  dctf->DiscretizeOff();
+  for (int useTable = 0; useTable < 2; ++useTable)
+  {
+    ctf->SetUseMappingTable(useTable);
+    ctf->SetMappingTableSize(16);
+    dctf->SetUseMappingTable(useTable);
+    dctf->SetMappingTableSize(16);
+    for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGB; outFormat += 2)
+    {
+      for (int n = 0; n < numThreadCounts; ++n)
+      {
+        vtkSMPTools::Initialize(numThreads[n]);
+        if (Map(dctf, scalars, outFormat) != Map(ctf, scalars, outFormat))
+        {
+          std::cerr << "Bad function colors of the discretizable function "
+                    << "(mapping table " << useTable << ", format "
+                    << outFormat << ") with " << numThreads[n]
+                    << " thread(s)." << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestLookupTable(const int *numThreads, int numThreadCounts)
+{
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(300);
+  lut->SetHueRange(0.6, 0.0);
+  lut->SetAlphaRange(0.5, 1.0);
+  lut->UseBelowRangeColorOn();
+  lut->UseAboveRangeColorOn();
+  const int types[2] = { VTK_FLOAT, VTK_INT };
+  for (int logScale = 0; logScale < 2; ++logScale)
+  {
+    // the range must be positive before switching to the log scale
+    lut->SetTableRange(1.0, 500.0);
+    lut->SetScale(logScale ? VTK_SCALE_LOG10 : VTK_SCALE_LINEAR);
+    lut->SetTableRange(logScale ? 1.0 : -50.0, 500.0);
+    lut->ForceBuild();
+    for (int alpha = 0; alpha < 2; ++alpha)
+    {
+      lut->SetAlpha(alpha ? 0.7 : 1.0);
+      for (int t = 0; t < 2; ++t)
+      {
+        vtkSmartPointer<vtkDataArray> scalars =
+          MakeScalars(types[t], 30011, logScale ? 1.0 : -50.0, 500.0);
+        for (int outFormat = VTK_LUMINANCE; outFormat <= VTK_RGBA; ++outFormat)
+        {
+          vtkSMPTools::Initialize(1);
+          std::vector<unsigned char> expected = Map(lut, scalars, outFormat);
+          for (int n = 0; n < numThreadCounts; ++n)
+          {
+            vtkSMPTools::Initialize(numThreads[n]);
+            if (Map(lut, scalars, outFormat) != expected)
+            {
+              std::cerr << "Bad lookup table colors (format " << outFormat
+                        << ") with " << numThreads[n] << " thread(s)."
+                        << std::endl;
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // end anon namespace
+
+int TestColorTransferFunctionMapping(int, char *[])
+{
+  const int numThreads[3] = { 1, 2, 0 };
+  if (!TestColorTransferFunction(numThreads, 3) ||
+      !TestDiscretizable(numThreads, 3) ||
+      !TestLookupTable(numThreads, 3))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkSMPTools::Initialize(0);
+
+  return EXIT_SUCCESS;
+}
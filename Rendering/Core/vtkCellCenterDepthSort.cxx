@@ -29,24 +29,89 @@
 #include "vtkCamera.h"
 #include "vtkMatrix4x4.h"
 #include "vtkFloatArray.h"
-#include "vtkCell.h"
+#include "vtkGenericCell.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 
-#include <stack>
-#include <utility>
-#include <algorithm>
+#include <vector>
 
 //-----------------------------------------------------------------------------
 
-typedef std::pair<vtkIdType, vtkIdType> vtkIdPair;
+namespace
+{
+// The number of cells below which their centers and depths are computed by
+// the calling thread alone, since the threads would cost more than they save.
+const vtkIdType VTK_CCDS_SMP_THRESHOLD = 10000;
+
+// Run functor(begin, end) over the n cells, in parallel if they are numerous
+// enough.
+template <class Functor>
+void vtkCellCenterDepthSortFor(vtkIdType n, Functor &functor)
+{
+  if (n < VTK_CCDS_SMP_THRESHOLD)
+  {
+    functor(0, n);
+  }
+  else
+  {
+    vtkSMPTools::For(0, n, functor);
+  }
+}
 
-class vtkCellCenterDepthSortStack
+// Computes the parametric centers of the cells, with a cell and a weights
+// array per thread.
+class vtkCellCenterDepthSortCenters
 {
 public:
-  std::stack<vtkIdPair> Stack;
+  vtkDataSet *Input;
+  float *Centers;
+  int MaxCellSize;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    weights.resize(this->MaxCellSize > 0 ? this->MaxCellSize : 1);
+    float *center = this->Centers + 3*begin;
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      this->Input->GetCell(i, cell);
+      double pcenter[3];
+      double dcenter[3];
+      int subId = cell->GetParametricCenter(pcenter);
+      cell->EvaluateLocation(subId, pcenter, dcenter, &weights[0]);
+      center[0] = dcenter[0]; center[1] = dcenter[1]; center[2] = dcenter[2];
+      center += 3;
+    }
+  }
 };
 
+// Computes the depths of the cells in the order of the ids.
+class vtkCellCenterDepthSortDepths
+{
+public:
+  const float *Centers;
+  const vtkIdType *Ids;
+  float *Depths;
+  float Vector[3];
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      this->Depths[i] = vtkMath::Dot(this->Centers + 3*this->Ids[i],
+                                     this->Vector);
+    }
+  }
+};
+}
+
 //-----------------------------------------------------------------------------
 
 vtkStandardNewMacro(vtkCellCenterDepthSort);
@@ -65,7 +130,7 @@ vtkCellCenterDepthSort::vtkCellCenterDepthSort()
   this->CellPartitionDepths = vtkFloatArray::New();
   this->CellPartitionDepths->SetNumberOfComponents(1);
 
-  this->ToSort = new vtkCellCenterDepthSortStack;
+  this->NextCell = 0;
 }
 
 vtkCellCenterDepthSort::~vtkCellCenterDepthSort()
@@ -75,8 +140,6 @@ vtkCellCenterDepthSort::~vtkCellCenterDepthSort()
   this->CellCenters->Delete();
   this->CellDepths->Delete();
   this->CellPartitionDepths->Delete();
-
-  delete this->ToSort;
 }
 
 void vtkCellCenterDepthSort::PrintSelf(ostream &os, vtkIndent indent)
@@ -130,37 +193,36 @@ void vtkCellCenterDepthSort::ComputeCellCenters()
 {
   vtkIdType numcells = this->Input->GetNumberOfCells();
   this->CellCenters->SetNumberOfTuples(numcells);
-
-  float *center = this->CellCenters->GetPointer(0);
-  double dcenter[3];
-  double *weights = new double[this->Input->GetMaxCellSize()];  //Dummy array.
-
-  for (vtkIdType i = 0; i < numcells; i++)
+  if (numcells < 1)
   {
-    vtkCell *cell = this->Input->GetCell(i);
-    double pcenter[3];
-    int subId;
-    subId = cell->GetParametricCenter(pcenter);
-    cell->EvaluateLocation(subId, pcenter, dcenter, weights);
-    center[0] = dcenter[0]; center[1] = dcenter[1]; center[2] = dcenter[2];
-    center += 3;
+    return;
   }
 
-  delete[] weights;
+  // Get a cell once from the calling thread, which builds the cells of the
+  // input if needed, so that the threads can then get them concurrently.
+  vtkNew<vtkGenericCell> cell;
+  this->Input->GetCell(0, cell);
+
+  vtkCellCenterDepthSortCenters centers;
+  centers.Input = this->Input;
+  centers.Centers = this->CellCenters->GetPointer(0);
+  centers.MaxCellSize = this->Input->GetMaxCellSize();
+  vtkCellCenterDepthSortFor(numcells, centers);
 }
 
-void vtkCellCenterDepthSort::ComputeDepths()
+void vtkCellCenterDepthSort::ComputeSortedDepths()
 {
   float *vector = this->ComputeProjectionVector();
   vtkIdType numcells = this->Input->GetNumberOfCells();
 
-  float *center = this->CellCenters->GetPointer(0);
-  float *depth = this->CellDepths->GetPointer(0);
-  for (vtkIdType i = 0; i < numcells; i++)
-  {
-    *(depth++) = vtkMath::Dot(center, vector);
-    center += 3;
-  }
+  vtkCellCenterDepthSortDepths depths;
+  depths.Centers = this->CellCenters->GetPointer(0);
+  depths.Ids = this->SortedCells->GetPointer(0);
+  depths.Depths = this->CellDepths->GetPointer(0);
+  depths.Vector[0] = vector[0];
+  depths.Vector[1] = vector[1];
+  depths.Vector[2] = vector[2];
+  vtkCellCenterDepthSortFor(numcells, depths);
 }
 
 void vtkCellCenterDepthSort::InitTraversal()
@@ -170,7 +232,8 @@ void vtkCellCenterDepthSort::InitTraversal()
   vtkIdType numcells = this->Input->GetNumberOfCells();
 
   if (   (this->LastSortTime < this->Input->GetMTime())
-      || (this->LastSortTime < this->MTime) )
+      || (this->LastSortTime < this->MTime)
+      || (this->SortedCells->GetNumberOfTuples() != numcells) )
   {
     vtkDebugMacro("Building cell centers array.");
 
@@ -178,74 +241,55 @@ void vtkCellCenterDepthSort::InitTraversal()
     this->ComputeCellCenters();
     this->CellDepths->SetNumberOfTuples(numcells);
     this->SortedCells->SetNumberOfTuples(numcells);
-  }
 
-  vtkDebugMacro("Filling SortedCells to initial values.");
-  vtkIdType *id = this->SortedCells->GetPointer(0);
-  for (vtkIdType i = 0; i < numcells; i++)
-  {
-    *(id++) = i;
+    vtkDebugMacro("Filling SortedCells to initial values.");
+    vtkIdType *id = this->SortedCells->GetPointer(0);
+    for (vtkIdType i = 0; i < numcells; i++)
+    {
+      *(id++) = i;
+    }
   }
 
+  // Otherwise the cells are left in the order of the last sort, which the
+  // small camera moves between frames barely change, so that the sort below
+  // has little or nothing to do.
   vtkDebugMacro("Calculating depths.");
-  this->ComputeDepths();
+  this->ComputeSortedDepths();
 
-  while (!this->ToSort->Stack.empty()) this->ToSort->Stack.pop();
-  this->ToSort->Stack.push(vtkIdPair(0, numcells));
+  vtkDebugMacro("Sorting depths.");
+  if (numcells > 0)
+  {
+    vtkSortDataArray::RadixSort(this->CellDepths->GetPointer(0),
+                                this->SortedCells->GetPointer(0), numcells, 0);
+  }
+  this->NextCell = 0;
 
   this->LastSortTime.Modified();
 }
 
 vtkIdTypeArray *vtkCellCenterDepthSort::GetNextCells()
 {
-  if (this->ToSort->Stack.empty())
+  vtkIdType numcells = this->SortedCells->GetNumberOfTuples();
+  if (this->NextCell >= numcells)
   {
     // Already sorted and returned everything.
     return nullptr;
   }
 
-  vtkIdType *cellIds = this->SortedCells->GetPointer(0);
-  float *cellDepths = this->CellDepths->GetPointer(0);
-  vtkIdPair partition;
-
-  partition = this->ToSort->Stack.top();  this->ToSort->Stack.pop();
-  while (partition.second - partition.first > this->MaxCellsReturned)
+  vtkIdType firstcell = this->NextCell;
+  vtkIdType partitionSize = numcells - firstcell;
+  if (partitionSize > this->MaxCellsReturned)
   {
-    vtkIdType left = partition.first;
-    vtkIdType right = partition.second - 1;
-    float pivot = cellDepths[static_cast<vtkIdType>(
-                               vtkMath::Random(left, right))];
-    while (left <= right)
-    {
-      while ((left <= right) && (cellDepths[left] < pivot)) left++;
-      while ((left <= right) && (cellDepths[right] > pivot)) right--;
-
-      if (left > right) break;
-
-      std::swap(cellIds[left], cellIds[right]);
-      std::swap(cellDepths[left], cellDepths[right]);
-
-      left++;  right--;
-    }
-
-    this->ToSort->Stack.push(vtkIdPair(left, partition.second));
-    partition.second = left;
+    partitionSize = this->MaxCellsReturned;
   }
+  this->NextCell += partitionSize;
 
-  if (partition.second <= partition.first)
-  {
-    // Got a partition of zero size.  Just recurse to get the next one.
-    return this->GetNextCells();
-  }
-
-  vtkIdType firstcell = partition.first;
-  vtkIdType numcells = partition.second - partition.first;
-
-  this->SortedCellPartition->SetArray(cellIds + firstcell, numcells, 1);
-  this->SortedCellPartition->SetNumberOfTuples(numcells);
-  this->CellPartitionDepths->SetArray(cellDepths + firstcell, numcells, 1);
-  this->CellPartitionDepths->SetNumberOfTuples(numcells);
+  this->SortedCellPartition->SetArray(
+    this->SortedCells->GetPointer(firstcell), partitionSize, 1);
+  this->SortedCellPartition->SetNumberOfTuples(partitionSize);
+  this->CellPartitionDepths->SetArray(
+    this->CellDepths->GetPointer(firstcell), partitionSize, 1);
+  this->CellPartitionDepths->SetNumberOfTuples(partitionSize);
 
-  vtkSortDataArray::Sort(this->CellPartitionDepths, this->SortedCellPartition);
   return this->SortedCellPartition;
 }
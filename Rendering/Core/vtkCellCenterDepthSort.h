@@ -31,8 +31,12 @@
  * sort, but it only provides approximate results.  The sorting algorithm
  * finds the centroids of all the cells.  It then performs the dot product
  * of the centroids against a vector pointing in the direction of the
- * camera transformed into object space.  It then performs an ordinary sort
- * on the result.
+ * camera transformed into object space.  It then sorts the result with a
+ * parallel radix sort.
+ *
+ * The cell centers are kept until the input changes, and each traversal
+ * starts from the order of the previous one, so that the sort has little
+ * to do when the camera barely moved between frames.
  *
 */
 
@@ -44,8 +48,6 @@
 
 class vtkFloatArray;
 
-class vtkCellCenterDepthSortStack;
-
 class VTKRENDERINGCORE_EXPORT vtkCellCenterDepthSort : public vtkVisibilitySort
 {
 public:
@@ -69,10 +71,16 @@ protected:
 
   virtual float *ComputeProjectionVector();
   virtual void ComputeCellCenters();
-  virtual void ComputeDepths();
+
+  /**
+   * Compute the depths of the cells in the order of SortedCells, which is
+   * the order of the last sort. It replaces the virtual ComputeDepths(),
+   * which computed them in cell id order.
+   */
+  void ComputeSortedDepths();
 
 private:
-  vtkCellCenterDepthSortStack *ToSort;
+  vtkIdType NextCell;
 
   vtkCellCenterDepthSort(const vtkCellCenterDepthSort &) = delete;
   void operator=(const vtkCellCenterDepthSort &) = delete;
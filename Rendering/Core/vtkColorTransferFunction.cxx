@@ -17,11 +17,13 @@
 #include "vtkCIEDE2000.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
 #include <iterator>
 #include <cmath>
 #include <set>
+#include <typeinfo>
 #include <vector>
 
 vtkStandardNewMacro(vtkColorTransferFunction);
@@ -92,6 +94,10 @@ public:
   vtkCTFFindNodeEqual         FindNodeEqual;
   vtkCTFFindNodeInRange       FindNodeInRange;
   vtkCTFFindNodeOutOfRange    FindNodeOutOfRange;
+
+  // The table used with UseMappingTable
+  std::vector<unsigned char>  MappingTable;
+  vtkTimeStamp                MappingTableBuildTime;
 };
 
 //=============================================================================
@@ -307,6 +313,9 @@ vtkColorTransferFunction::vtkColorTransferFunction()
   this->Table = nullptr;
   this->TableSize = 0;
 
+  this->UseMappingTable = 0;
+  this->MappingTableSize = 16384;
+
   this->AllowDuplicateScalars = 0;
 
   this->Internal = new vtkColorTransferFunctionInternals;
@@ -1248,6 +1257,38 @@ const unsigned char *vtkColorTransferFunction::GetTable( double xStart,
   return this->Table;
 }
 
+//----------------------------------------------------------------------------
+const unsigned char *vtkColorTransferFunction::GetMappingTable()
+{
+  std::vector<unsigned char>& table = this->Internal->MappingTable;
+  size_t size = static_cast<size_t>(this->MappingTableSize);
+  if (this->GetMTime() <= this->Internal->MappingTableBuildTime &&
+      table.size() == 4*size)
+  {
+    return table.data();
+  }
+
+  std::vector<double> colors(3*size);
+  this->GetTable(this->Range[0], this->Range[1], this->MappingTableSize,
+                 colors.data());
+
+  table.resize(4*size);
+  for (size_t i = 0; i < size; i++)
+  {
+    const double *rgb = &colors[3*i];
+    table[4*i] = static_cast<unsigned char>(rgb[0]*255.0 + 0.5);
+    table[4*i+1] = static_cast<unsigned char>(rgb[1]*255.0 + 0.5);
+    table[4*i+2] = static_cast<unsigned char>(rgb[2]*255.0 + 0.5);
+    // luminance, with the coeffs of MapScalarsThroughTable2
+    table[4*i+3] = static_cast<unsigned char>(rgb[0]*76.5 + rgb[1]*150.45 +
+                                              rgb[2]*28.05 + 0.5);
+  }
+
+  this->Internal->MappingTableBuildTime.Modified();
+
+  return table.data();
+}
+
 //----------------------------------------------------------------------------
 void vtkColorTransferFunction::BuildFunctionFromTable(double xStart,
                                                       double xEnd,
@@ -1356,6 +1397,8 @@ void vtkColorTransferFunction::DeepCopy( vtkScalarsToColors *o )
     this->ColorSpace   = f->ColorSpace;
     this->HSVWrap      = f->HSVWrap;
     this->Scale        = f->Scale;
+    this->UseMappingTable = f->UseMappingTable;
+    this->MappingTableSize = f->MappingTableSize;
 
     int i;
     this->RemoveAllPoints();
@@ -1380,6 +1423,8 @@ void vtkColorTransferFunction::ShallowCopy( vtkColorTransferFunction *f )
     this->ColorSpace   = f->ColorSpace;
     this->HSVWrap      = f->HSVWrap;
     this->Scale        = f->Scale;
+    this->UseMappingTable = f->UseMappingTable;
+    this->MappingTableSize = f->MappingTableSize;
 
     int i;
     this->RemoveAllPoints();
@@ -1394,36 +1439,155 @@ void vtkColorTransferFunction::ShallowCopy( vtkColorTransferFunction *f )
 }
 
 //----------------------------------------------------------------------------
-// Accelerate the mapping by copying the data in 32-bit chunks instead
-// of 8-bit chunks.  The extra "long" argument is to help broken
-// compilers select the non-templates below for unsigned char
-// and unsigned short.
+namespace
+{
+// The number of values below which they are mapped by the calling thread
+// alone, since the threads would cost more than they save.
+const vtkIdType VTK_CTF_SMP_THRESHOLD = 10000;
+
+// The number of values whose table indices are computed together, in a
+// loop without branches the compiler can vectorize.
+const int VTK_CTF_BLOCK_SIZE = 256;
+
+// Run map(begin, end) over the n values, in parallel if they are numerous
+// enough.
+template <class Functor>
+void vtkColorTransferFunctionMapValues(vtkIdType n, Functor &map)
+{
+  if (n < VTK_CTF_SMP_THRESHOLD)
+  {
+    map(0, n);
+  }
+  else
+  {
+    vtkSMPTools::For(0, n, map);
+  }
+}
+
+// Map the values through the color transfer function. The values inside
+// the range are looked up in the mapping table when there is one, and the
+// others (NaN, below and above the range) are evaluated exactly, so they
+// get the NaN, below range and above range colors. The function itself is
+// only read, through the non virtual GetColor, so that the values can be
+// mapped by several threads. When UseGetColor is set, the values are
+// evaluated exactly through the virtual GetColor, which may be overridden
+// and not be thread safe, by the calling thread alone.
 template <class T>
-void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
-                                     T* input,
-                                     unsigned char* output,
-                                     int length, int inIncr,
-                                     int outFormat, long)
+class vtkColorTransferFunctionMapFunctor
 {
-  double         x;
-  int            i = length;
-  double         rgb[3];
-  unsigned char *optr = output;
-  T             *iptr = input;
-  unsigned char  alpha = static_cast<unsigned char>(self->GetAlpha()*255.0);
+public:
+  vtkColorTransferFunction *Self;
+  bool UseGetColor;
+  const T *Input;
+  unsigned char *Output;
+  int InIncr;
+  int OutFormat;
+  unsigned char Alpha;
+
+  // The mapping table, with 4 bytes (red, green, blue and luminance) per
+  // sample, or nullptr to evaluate all the values exactly.
+  const unsigned char *Table;
+  double Range[2];
+  bool LogScale;
+  double Start;
+  double Scale;
+  double MaxIndex;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double values[VTK_CTF_BLOCK_SIZE];
+    int indices[VTK_CTF_BLOCK_SIZE];
+    for (vtkIdType block = begin; block < end; block += VTK_CTF_BLOCK_SIZE)
+    {
+      int n = static_cast<int>(
+        std::min(static_cast<vtkIdType>(VTK_CTF_BLOCK_SIZE), end - block));
+      const T *iptr = this->Input + block * this->InIncr;
+      unsigned char *optr = this->Output + block * this->OutFormat;
+      for (int i = 0; i < n; ++i)
+      {
+        values[i] = static_cast<double>(iptr[i * this->InIncr]);
+      }
 
-  if(self->GetSize() == 0)
+      if (!this->Table)
+      {
+        for (int i = 0; i < n; ++i)
+        {
+          this->MapExactly(values[i], optr);
+          optr += this->OutFormat;
+        }
+        continue;
+      }
+
+      if (this->LogScale)
+      {
+        for (int i = 0; i < n; ++i)
+        {
+          indices[i] = this->ComputeIndex(log10(values[i]));
+        }
+      }
+      else
+      {
+        for (int i = 0; i < n; ++i)
+        {
+          indices[i] = this->ComputeIndex(values[i]);
+        }
+      }
+
+      for (int i = 0; i < n; ++i)
+      {
+        if (values[i] >= this->Range[0] && values[i] <= this->Range[1])
+        {
+          const unsigned char *color = this->Table + 4 * static_cast<size_t>(indices[i]);
+          switch (this->OutFormat)
+          {
+            case VTK_RGBA:
+              optr[3] = this->Alpha;
+              VTK_FALLTHROUGH;
+            case VTK_RGB:
+              optr[0] = color[0];
+              optr[1] = color[1];
+              optr[2] = color[2];
+              break;
+            case VTK_LUMINANCE_ALPHA:
+              optr[1] = this->Alpha;
+              VTK_FALLTHROUGH;
+            default:
+              optr[0] = color[3];
+              break;
+          }
+        }
+        else
+        {
+          this->MapExactly(values[i], optr);
+        }
+        optr += this->OutFormat;
+      }
+    }
+  }
+
+  // The index of the nearest sample of the table, clamped to the table
+  // (NaN gives 0), without branches.
+  int ComputeIndex(double x) const
   {
-    vtkGenericWarningMacro("Transfer Function Has No Points!");
-    return;
+    double t = (x - this->Start) * this->Scale + 0.5;
+    t = (t > 0.0 ? t : 0.0);
+    t = (t < this->MaxIndex ? t : this->MaxIndex);
+    return static_cast<int>(t);
   }
 
-  while (--i >= 0)
+  void MapExactly(double x, unsigned char *optr) const
   {
-    x = static_cast<double>(*iptr);
-    self->GetColor(x, rgb);
+    double rgb[3];
+    if (this->UseGetColor)
+    {
+      this->Self->GetColor(x, rgb);
+    }
+    else
+    {
+      this->Self->vtkColorTransferFunction::GetColor(x, rgb);
+    }
 
-    if (outFormat == VTK_RGB || outFormat == VTK_RGBA)
+    if (this->OutFormat == VTK_RGB || this->OutFormat == VTK_RGBA)
     {
       *(optr++) = static_cast<unsigned char>(rgb[0]*255.0 + 0.5);
       *(optr++) = static_cast<unsigned char>(rgb[1]*255.0 + 0.5);
@@ -1435,15 +1599,131 @@ void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
                                              rgb[2]*28.05 + 0.5);
     }
 
-    if (outFormat == VTK_RGBA || outFormat == VTK_LUMINANCE_ALPHA)
+    if (this->OutFormat == VTK_RGBA || this->OutFormat == VTK_LUMINANCE_ALPHA)
     {
-      *(optr++) = alpha;
+      *(optr++) = this->Alpha;
     }
-    iptr += inIncr;
   }
-}
+};
 
+// Copy the colors of the 8 or 16 bit values from the table of the colors
+// of all the possible values, with 3 bytes per value.
+template <class T>
+class vtkColorTransferFunctionCopyFunctor
+{
+public:
+  const unsigned char *Table;
+  const T *Input;
+  unsigned char *Output;
+  int InIncr;
+  int OutFormat;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const T *iptr = this->Input + begin * this->InIncr;
+    unsigned char *optr = this->Output + begin * this->OutFormat;
+    const unsigned char *table = this->Table;
+    int x;
+    vtkIdType i = end - begin;
+    switch (this->OutFormat)
+    {
+      case VTK_RGB:
+        while (--i >= 0)
+        {
+          x = *iptr*3;
+          *(optr++) = table[x];
+          *(optr++) = table[x+1];
+          *(optr++) = table[x+2];
+          iptr += this->InIncr;
+        }
+        break;
+      case VTK_RGBA:
+        while (--i >= 0)
+        {
+          x = *iptr*3;
+          *(optr++) = table[x];
+          *(optr++) = table[x+1];
+          *(optr++) = table[x+2];
+          *(optr++) = 255;
+          iptr += this->InIncr;
+        }
+        break;
+      case VTK_LUMINANCE_ALPHA:
+        while (--i >= 0)
+        {
+          x = *iptr*3;
+          *(optr++) = table[x];
+          *(optr++) = 255;
+          iptr += this->InIncr;
+        }
+        break;
+      case VTK_LUMINANCE:
+        while (--i >= 0)
+        {
+          x = *iptr*3;
+          *(optr++) = table[x];
+          iptr += this->InIncr;
+        }
+        break;
+    }
+  }
+};
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+// Map the values by blocks, in parallel, through the mapping table when
+// UseMappingTable is on, or one by one through the virtual GetColor on the
+// calling thread when useGetColor is true.  The extra "long" argument is to
+// help broken compilers select the non-templates below for unsigned char
+// and unsigned short.
+template <class T>
+void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
+                                     T* input,
+                                     unsigned char* output,
+                                     int length, int inIncr,
+                                     int outFormat, bool useGetColor, long)
+{
+  if(self->GetSize() == 0)
+  {
+    vtkGenericWarningMacro("Transfer Function Has No Points!");
+    return;
+  }
+
+  vtkColorTransferFunctionMapFunctor<T> map;
+  map.Self = self;
+  map.UseGetColor = useGetColor;
+  map.Input = input;
+  map.Output = output;
+  map.InIncr = inIncr;
+  map.OutFormat = outFormat;
+  map.Alpha = static_cast<unsigned char>(self->GetAlpha()*255.0);
+  map.Table = nullptr;
+  if (self->GetUseMappingTable() && !useGetColor)
+  {
+    map.Table = self->GetMappingTable();
+    self->GetRange(map.Range);
+    map.LogScale = (self->GetScale() == VTK_CTF_LOG10 && map.Range[0] > 0.0);
+    double start = map.Range[0];
+    double end = map.Range[1];
+    if (map.LogScale)
+    {
+      start = log10(start);
+      end = log10(end);
+    }
+    map.MaxIndex = self->GetMappingTableSize() - 1;
+    map.Start = start;
+    map.Scale = (end > start ? map.MaxIndex / (end - start) : 0.0);
+  }
 
+  if (useGetColor)
+  {
+    map(0, length);
+  }
+  else
+  {
+    vtkColorTransferFunctionMapValues(length, map);
+  }
+}
 
 //----------------------------------------------------------------------------
 // Special implementation for unsigned char input.
@@ -1451,61 +1731,21 @@ static void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
                                      unsigned char* input,
                                      unsigned char* output,
                                      int length, int inIncr,
-                                     int outFormat, int)
+                                     int outFormat, bool, int)
 {
-  int            x;
-  int            i = length;
-  unsigned char  *optr = output;
-  unsigned char  *iptr = input;
-
   if(self->GetSize() == 0)
   {
     vtkGenericWarningMacro("Transfer Function Has No Points!");
     return;
   }
 
-  const unsigned char *table = self->GetTable(0,255,256);
-  switch (outFormat)
-  {
-    case VTK_RGB:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = table[x+1];
-        *(optr++) = table[x+2];
-        iptr += inIncr;
-      }
-      break;
-    case VTK_RGBA:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = table[x+1];
-        *(optr++) = table[x+2];
-        *(optr++) = 255;
-        iptr += inIncr;
-      }
-      break;
-    case VTK_LUMINANCE_ALPHA:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = 255;
-        iptr += inIncr;
-      }
-      break;
-    case VTK_LUMINANCE:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        iptr += inIncr;
-      }
-      break;
-  }
+  vtkColorTransferFunctionCopyFunctor<unsigned char> copy;
+  copy.Table = self->GetTable(0,255,256);
+  copy.Input = input;
+  copy.Output = output;
+  copy.InIncr = inIncr;
+  copy.OutFormat = outFormat;
+  vtkColorTransferFunctionMapValues(length, copy);
 }
 
 //----------------------------------------------------------------------------
@@ -1514,62 +1754,21 @@ static void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
                                             unsigned short* input,
                                             unsigned char* output,
                                             int length, int inIncr,
-                                            int outFormat, int)
+                                            int outFormat, bool, int)
 {
-  int            x;
-  int            i = length;
-  unsigned char  *optr = output;
-  unsigned short *iptr = input;
-
   if(self->GetSize() == 0)
   {
     vtkGenericWarningMacro("Transfer Function Has No Points!");
     return;
   }
 
-
-  const unsigned char *table = self->GetTable(0,65535,65536);
-  switch (outFormat)
-  {
-    case VTK_RGB:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = table[x+1];
-        *(optr++) = table[x+2];
-        iptr += inIncr;
-      }
-      break;
-    case VTK_RGBA:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = table[x+1];
-        *(optr++) = table[x+2];
-        *(optr++) = 255;
-        iptr += inIncr;
-      }
-      break;
-    case VTK_LUMINANCE_ALPHA:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        *(optr++) = 255;
-        iptr += inIncr;
-      }
-      break;
-    case VTK_LUMINANCE:
-      while (--i >= 0)
-      {
-        x = *iptr*3;
-        *(optr++) = table[x];
-        iptr += inIncr;
-      }
-      break;
-  }
+  vtkColorTransferFunctionCopyFunctor<unsigned short> copy;
+  copy.Table = self->GetTable(0,65535,65536);
+  copy.Input = input;
+  copy.Output = output;
+  copy.InIncr = inIncr;
+  copy.OutFormat = outFormat;
+  vtkColorTransferFunctionMapValues(length, copy);
 }
 
 //----------------------------------------------------------------------------
@@ -1761,17 +1960,33 @@ void vtkColorTransferFunction::MapScalarsThroughTable2(void *input,
   }
   else
   {
-    switch (inputDataType)
-    {
-      vtkTemplateMacro(
-        vtkColorTransferFunctionMapData(this, static_cast<VTK_TT*>(input),
-                                        output, numberOfValues, inputIncrement,
-                                        outputFormat, 1)
-        );
-      default:
-        vtkErrorMacro(<< "MapImageThroughTable: Unknown input ScalarType");
-        return;
-    }
+    // The colors of a subclass are those of its GetColor(), which may be
+    // overridden, unless it maps its scalars with MapScalarsThroughFunction().
+    this->MapScalarsThroughFunction(input, output, inputDataType,
+      numberOfValues, inputIncrement, outputFormat,
+      typeid(*this) != typeid(vtkColorTransferFunction));
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkColorTransferFunction::MapScalarsThroughFunction(void *input,
+                                                         unsigned char *output,
+                                                         int inputDataType,
+                                                         int numberOfValues,
+                                                         int inputIncrement,
+                                                         int outputFormat,
+                                                         bool useGetColor)
+{
+  switch (inputDataType)
+  {
+    vtkTemplateMacro(
+      vtkColorTransferFunctionMapData(this, static_cast<VTK_TT*>(input),
+                                      output, numberOfValues, inputIncrement,
+                                      outputFormat, useGetColor, 1)
+      );
+    default:
+      vtkErrorMacro(<< "MapImageThroughTable: Unknown input ScalarType");
+      return;
   }
 }
 
@@ -1987,6 +2202,9 @@ void vtkColorTransferFunction::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UseAboveRangeColor: "
      << (this->UseAboveRangeColor != 0 ? "ON" : "OFF") << "\n";
 
+  os << indent << "UseMappingTable: "
+     << (this->UseMappingTable != 0 ? "ON" : "OFF") << "\n";
+  os << indent << "MappingTableSize: " << this->MappingTableSize << "\n";
 
   unsigned int i;
   for( i = 0; i < this->Internal->Nodes.size(); i++ )
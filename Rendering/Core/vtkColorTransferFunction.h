@@ -296,6 +296,32 @@ public:
                                        int inputDataType, int numberOfValues,
                                        int inputIncrement, int outputIncrement) override;
 
+  //@{
+  /**
+   * Set/Get whether MapScalarsThroughTable2() maps the scalars within the
+   * range of the function through a table of MappingTableSize colors,
+   * sampled over this range (logarithmically with a log scale), instead of
+   * evaluating the function for each scalar. The table is built on first
+   * use after the function is modified. Scalars outside the range and NaN
+   * are still mapped exactly, to the clamped, above-range, below-range or
+   * NaN colors. This is much faster on large arrays, above all in the Lab,
+   * CIEDE2000 and diverging color spaces, but the colors are those of the
+   * nearest samples. Off by default, with 16384 colors (at most 2^24).
+   */
+  vtkSetMacro(UseMappingTable, vtkTypeBool);
+  vtkGetMacro(UseMappingTable, vtkTypeBool);
+  vtkBooleanMacro(UseMappingTable, vtkTypeBool);
+  vtkSetClampMacro(MappingTableSize, int, 2, 16777216);
+  vtkGetMacro(MappingTableSize, int);
+  //@}
+
+  /**
+   * Return the colors of the mapping table, as red, green, blue and
+   * luminance for each of the MappingTableSize samples over the range. The
+   * table is rebuilt if the function has been modified since it was built.
+   */
+  const unsigned char *GetMappingTable();
+
   //@{
   /**
    * Toggle whether to allow duplicate scalar values in the color transfer
@@ -331,6 +357,22 @@ protected:
 
   vtkColorTransferFunctionInternals *Internal;
 
+  /**
+   * Map the scalars through the function itself, i.e. through the non
+   * virtual vtkColorTransferFunction::GetColor(), by several threads and
+   * through the mapping table when UseMappingTable is on. If useGetColor is
+   * true, each value is instead evaluated through the virtual GetColor() on
+   * the calling thread. MapScalarsThroughTable2() evaluates the function
+   * itself for a vtkColorTransferFunction and uses GetColor() for its
+   * subclasses, which may override it. The subclasses whose colors are
+   * those of the function can call this method explicitly, with useGetColor
+   * false, to get the fast path.
+   */
+  void MapScalarsThroughFunction(void *input, unsigned char *output,
+                                 int inputDataType, int numberOfValues,
+                                 int inputIncrement, int outputFormat,
+                                 bool useGetColor);
+
   /**
    * Determines the function value outside of defined points
    * Zero = always return 0.0 outside of defined points
@@ -408,6 +450,14 @@ protected:
    */
   int TableSize;
 
+  //@{
+  /**
+   * The table used to map the scalars with UseMappingTable.
+   */
+  vtkTypeBool UseMappingTable;
+  int MappingTableSize;
+  //@}
+
   /**
    * Set the range of scalars being mapped. This method has no functionality
    * in this subclass of vtkScalarsToColors.
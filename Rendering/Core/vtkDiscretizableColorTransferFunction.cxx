@@ -19,6 +19,7 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPiecewiseFunction.h"
+#include "vtkSMPTools.h"
 #include "vtkTemplateAliasMacro.h"
 #include "vtkTuple.h"
 
@@ -334,7 +335,17 @@ double vtkDiscretizableColorTransferFunction::GetOpacity(double v)
 }
 
 //----------------------------------------------------------------------------
-// Internal mapping of the opacity value through the lookup table
+namespace
+{
+// The number of values below which they are mapped by the calling thread
+// alone, since the threads would cost more than they save.
+const vtkIdType VTK_DCTF_SMP_THRESHOLD = 10000;
+}
+
+//----------------------------------------------------------------------------
+// Internal mapping of the opacity value through the lookup table. The
+// scalar opacity function is only read, so the values are mapped by chunks
+// in parallel when they are numerous.
 template <class T>
 static void vtkDiscretizableColorTransferFunctionMapOpacity(
   vtkDiscretizableColorTransferFunction* self,
@@ -343,12 +354,8 @@ static void vtkDiscretizableColorTransferFunctionMapOpacity(
   int length, int inIncr,
   int outFormat)
 {
-  double         x;
-  int            i = length;
-  unsigned char *optr = output;
-  T             *iptr = input;
-
-  if (self->GetScalarOpacityFunction()->GetSize() == 0)
+  vtkPiecewiseFunction *opacity = self->GetScalarOpacityFunction();
+  if (opacity->GetSize() == 0)
   {
     vtkGenericWarningMacro("Transfer Function Has No Points!");
     return;
@@ -362,15 +369,28 @@ static void vtkDiscretizableColorTransferFunctionMapOpacity(
   // opacity component stride
   unsigned int stride = (outFormat == VTK_RGBA ? 4 : 2);
 
-  optr += stride - 1; //Move to first alpha value
-  // Iterate through color components
-  while (--i >= 0)
+  auto mapChunk = [&](vtkIdType begin, vtkIdType end)
   {
-    x = static_cast<double>(*iptr);
-    double alpha = self->GetScalarOpacityFunction()->GetValue(x);
-    *(optr) = static_cast<unsigned char>(alpha * 255.0 + 0.5);
-    optr += stride;
-    iptr += inIncr;
+    T *iptr = input + begin * inIncr;
+    unsigned char *optr = output + begin * stride;
+    optr += stride - 1; //Move to first alpha value
+    // Iterate through color components
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      double x = static_cast<double>(*iptr);
+      double alpha = opacity->GetValue(x);
+      *(optr) = static_cast<unsigned char>(alpha * 255.0 + 0.5);
+      optr += stride;
+      iptr += inIncr;
+    }
+  };
+  if (length < VTK_DCTF_SMP_THRESHOLD)
+  {
+    mapChunk(0, length);
+  }
+  else
+  {
+    vtkSMPTools::For(0, length, mapChunk);
   }
 }
 
@@ -388,10 +408,12 @@ void vtkDiscretizableColorTransferFunction::MapScalarsThroughTable2(void *input,
     this->LookupTable->MapScalarsThroughTable2(input, output, inputDataType,
       numberOfValues, inputIncrement, outputFormat);
   }
-  else
+  else if (this->GetSize() > 0)
   {
-    this->Superclass::MapScalarsThroughTable2(input, output, inputDataType,
-      numberOfValues, inputIncrement, outputFormat);
+    // Not discretized, GetColor() gives the colors of the function itself.
+    this->Build();
+    this->MapScalarsThroughFunction(input, output, inputDataType,
+      numberOfValues, inputIncrement, outputFormat, false);
   }
 
   // Calculate alpha values
@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFixedPointRayCastSpaceLeaping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the leaps of vtkFixedPointVolumeRayCastMapper through its
+// occupancy octree only skip the samples of the rays that lie in the empty
+// cells of its min max volume, the ones the composite helpers skip one by
+// one, and that they skip most of them in a sparse volume.
+
+#include "vtkFixedPointVolumeRayCastMapper.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+
+#include <vector>
+
+namespace
+{
+
+// A mapper whose min max volume is set by the test.
+class vtkTestSpaceLeapingMapper : public vtkFixedPointVolumeRayCastMapper
+{
+public:
+  static vtkTestSpaceLeapingMapper *New();
+  vtkTypeMacro(vtkTestSpaceLeapingMapper, vtkFixedPointVolumeRayCastMapper);
+
+  void SetMinMaxVolume(unsigned short *minMaxVolume, int size[4])
+  {
+    this->MinMaxVolume = minMaxVolume;
+    for (int i = 0; i < 4; ++i)
+    {
+      this->MinMaxVolumeSize[i] = size[i];
+    }
+    this->UpdateOccupancyLevels();
+  }
+
+  void ClearMinMaxVolume()
+  {
+    this->MinMaxVolume = nullptr;
+    this->UpdateOccupancyLevels();
+  }
+
+  int GetNumberOfOccupancyLevels()
+  {
+    return this->NumberOfOccupancyLevels;
+  }
+};
+
+vtkStandardNewMacro(vtkTestSpaceLeapingMapper);
+
+// Checks the leaps along random rays through a min max volume of the given
+// size, where a blob of cells is occupied.
+bool TestLeaps(vtkTestSpaceLeapingMapper *mapper,
+  vtkMinimalStandardRandomSequence *random, int size[4])
+{
+  vtkIdType numCells = static_cast<vtkIdType>(size[0]) * size[1] * size[2];
+  std::vector<unsigned short> minMaxVolume(3 * size[3] * numCells, 0);
+  for (int z = 0; z < size[2]; ++z)
+  {
+    for (int y = 0; y < size[1]; ++y)
+    {
+      for (int x = 0; x < size[0]; ++x)
+      {
+        double dx = x - 0.3 * size[0], dy = y - 0.6 * size[1],
+               dz = z - 0.5 * size[2];
+        random->Next();
+        bool occupied = (dx * dx + dy * dy + dz * dz < 4.0) ||
+          random->GetValue() < 0.01;
+        vtkIdType cell = (static_cast<vtkIdType>(z) * size[1] + y) * size[0] + x;
+        for (int c = 0; c < size[3]; ++c)
+        {
+          // only the flags of the first component are checked
+          minMaxVolume[3 * (size[3] * cell + c) + 2] =
+            (c == 0 ? occupied : !occupied) ? 1 : 0;
+        }
+      }
+    }
+  }
+  mapper->SetMinMaxVolume(&minMaxVolume[0], size);
+
+  vtkIdType numSamples = 0;
+  vtkIdType numVisitedSamples = 0;
+  vtkIdType numLeaps = 0;
+  for (int ray = 0; ray < 500; ++ray)
+  {
+    unsigned int start[3];
+    unsigned int dir[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      random->Next();
+      start[i] = static_cast<unsigned int>(
+        random->GetValue() * (static_cast<double>(size[i]) * (1 << VTKKW_FPMM_SHIFT) - 1));
+      random->Next();
+      float step = static_cast<float>(random->GetRangeValue(-0.9, 0.9));
+      if (ray % 7 == i)
+      {
+        step = 0.0;
+      }
+      dir[i] = mapper->ToFixedPointDirection(step);
+    }
+
+    // the samples of the ray inside the min max volume, and whether they
+    // lie in empty cells
+    std::vector<bool> empty;
+    unsigned int pos[3] = { start[0], start[1], start[2] };
+    for (;;)
+    {
+      unsigned int mmpos[3];
+      bool inside = true;
+      for (int i = 0; i < 3; ++i)
+      {
+        mmpos[i] = pos[i] >> VTKKW_FPMM_SHIFT;
+        inside = inside && mmpos[i] < static_cast<unsigned int>(size[i]);
+      }
+      if (!inside || empty.size() > 4000)
+      {
+        break;
+      }
+      empty.push_back(!mapper->CheckMinMaxVolumeFlag(mmpos, 0));
+      mapper->FixedPointIncrement(pos, dir);
+    }
+    unsigned int numSteps = static_cast<unsigned int>(empty.size());
+    numSamples += numSteps;
+
+    // leap over the empty samples the way the helpers do
+    pos[0] = start[0];
+    pos[1] = start[1];
+    pos[2] = start[2];
+    for (unsigned int k = 0; k < numSteps; ++k)
+    {
+      if (k)
+      {
+        mapper->FixedPointIncrement(pos, dir);
+      }
+      numVisitedSamples++;
+      if (!empty[k])
+      {
+        continue;
+      }
+      if (k + 2 < numSteps)
+      {
+        unsigned int steps =
+          mapper->ComputeEmptySpaceSteps(pos, dir, numSteps - 1 - k);
+        if (steps < 1 || steps > numSteps - 1 - k)
+        {
+          std::cerr << "Bad number of steps " << steps << " at sample " << k
+                    << " of " << numSteps << std::endl;
+          return false;
+        }
+        for (unsigned int s = 1; s < steps; ++s)
+        {
+          if (!empty[k + s])
+          {
+            std::cerr << "Leap over the occupied sample " << k + s
+                      << " from sample " << k << std::endl;
+            return false;
+          }
+        }
+        mapper->FixedPointIncrement(pos, dir, steps - 1);
+        k += steps - 1;
+        numLeaps++;
+      }
+    }
+  }
+
+  std::cout << "Min max volume " << size[0] << "x" << size[1] << "x"
+            << size[2] << " (" << mapper->GetNumberOfOccupancyLevels()
+            << " levels): " << numVisitedSamples << " samples visited of "
+            << numSamples << ", with " << numLeaps << " leaps" << std::endl;
+  if (numCells > 1 && 2 * numVisitedSamples > numSamples)
+  {
+    std::cerr << "The leaps skipped too few samples." << std::endl;
+    return false;
+  }
+  mapper->ClearMinMaxVolume();
+  return true;
+}
+
+} // end anon namespace
+
+int TestFixedPointRayCastSpaceLeaping(int, char *[])
+{
+  vtkNew<vtkTestSpaceLeapingMapper> mapper;
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  int sizes[4][4] = {
+    { 1, 1, 1, 1 },
+    { 13, 9, 17, 1 },
+    { 40, 33, 25, 2 },
+    { 130, 70, 3, 1 }
+  };
+  for (int i = 0; i < 4; ++i)
+  {
+    if (!TestLeaps(mapper, random, sizes[i]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
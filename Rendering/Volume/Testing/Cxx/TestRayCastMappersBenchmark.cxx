@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This test renders the CPU ray cast mappers,
+// vtkFixedPointVolumeRayCastMapper and vtkUnstructuredGridVolumeRayCastMapper,
+// offscreen along a fixed camera path and checks that they report the times
+// of the tiles of their images. With -B, it uses a longer path and prints
+// the frame rates and the spread of the tile times, to benchmark the mappers.
+
+#include "vtkAbstractVolumeMapper.h"
+#include "vtkCamera.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFixedPointVolumeRayCastMapper.h"
+#include "vtkNew.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGridVolumeRayCastMapper.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Renders the volume along the camera path and checks the times of the
+// tiles of the last image. When print is true, reports the frame rate and
+// the spread of these times.
+bool Benchmark(const char *name, vtkAbstractVolumeMapper *mapper,
+               vtkVolumeProperty *volumeProperty, vtkDoubleArray *tileTimes,
+               int numRenders, bool print)
+{
+  vtkNew<vtkVolume> volume;
+  volume->SetMapper(mapper);
+  volume->SetProperty(volumeProperty);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(1);
+  renderWindow->SetSize(400, 400);
+
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddVolume(volume);
+  renderer->ResetCamera();
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  renderWindow->Render();
+  timer->StopTimer();
+  if (print)
+  {
+    cerr << name << " First Render Time: " << timer->GetElapsedTime() << endl;
+  }
+
+  timer->StartTimer();
+  for (int i = 0; i < numRenders; ++i)
+  {
+    renderer->GetActiveCamera()->Azimuth(10);
+    renderer->GetActiveCamera()->Elevation(i < numRenders / 2 ? 2 : -2);
+    renderer->GetActiveCamera()->OrthogonalizeViewUp();
+    renderWindow->Render();
+  }
+  timer->StopTimer();
+  double elapsed = timer->GetElapsedTime();
+  if (print)
+  {
+    cerr << name << " Interactive Render Time: " << elapsed / numRenders
+         << " (" << numRenders / elapsed << " FPS)" << endl;
+  }
+
+  vtkIdType numTiles = tileTimes->GetNumberOfTuples();
+  if (numTiles == 0)
+  {
+    cerr << name << " did not report the times of its tiles." << endl;
+    return false;
+  }
+  double *times = tileTimes->GetPointer(0);
+  if (*std::min_element(times, times + numTiles) < 0.0)
+  {
+    cerr << name << " reported a negative tile time." << endl;
+    return false;
+  }
+  if (print)
+  {
+    double total = 0.0;
+    for (vtkIdType i = 0; i < numTiles; ++i)
+    {
+      total += times[i];
+    }
+    cerr << name << " Tiles: " << numTiles
+         << ", min " << *std::min_element(times, times + numTiles)
+         << ", mean " << total / numTiles
+         << ", max " << *std::max_element(times, times + numTiles) << endl;
+  }
+  return true;
+}
+
+} // end anon namespace
+
+//----------------------------------------------------------------------------
+int TestRayCastMappersBenchmark(int argc, char* argv[])
+{
+  bool benchmark = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "-B"))
+    {
+      benchmark = true;
+    }
+  }
+  if (benchmark)
+  {
+    cout << "CTEST_FULL_OUTPUT (Avoid ctest truncation of output)" << endl;
+  }
+
+  // the length of the camera path of the benchmark, or a short one to only
+  // check the mappers
+  const int numRenders = benchmark ? 36 : 4;
+
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-63, 64,
+                          -63, 64,
+                          -63, 64);
+  wavelet->SetCenter(0.0, 0.0, 0.0);
+
+  vtkNew<vtkVolumeProperty> volumeProperty;
+  vtkNew<vtkColorTransferFunction> ctf;
+  ctf->AddRGBPoint(37.3531, 0.2, 0.29, 1);
+  ctf->AddRGBPoint(157.091, 0.87, 0.87, 0.87);
+  ctf->AddRGBPoint(276.829, 0.7, 0.015, 0.15);
+
+  vtkNew<vtkPiecewiseFunction> pwf;
+  pwf->AddPoint(37.3531, 0.0);
+  pwf->AddPoint(276.829, 1.0);
+
+  volumeProperty->SetColor(ctf);
+  volumeProperty->SetScalarOpacity(pwf);
+
+  vtkNew<vtkFixedPointVolumeRayCastMapper> fixedPointMapper;
+  fixedPointMapper->SetInputConnection(wavelet->GetOutputPort());
+  if (!Benchmark("vtkFixedPointVolumeRayCastMapper", fixedPointMapper,
+                 volumeProperty, fixedPointMapper->GetTileRenderTimes(),
+                 numRenders, benchmark))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A smaller wavelet for the tetrahedra of the unstructured grid mapper.
+  vtkNew<vtkRTAnalyticSource> smallWavelet;
+  smallWavelet->SetWholeExtent(-15, 16,
+                               -15, 16,
+                               -15, 16);
+  smallWavelet->SetCenter(0.0, 0.0, 0.0);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedra;
+  tetrahedra->SetInputConnection(smallWavelet->GetOutputPort());
+
+  vtkNew<vtkUnstructuredGridVolumeRayCastMapper> unstructuredGridMapper;
+  unstructuredGridMapper->SetInputConnection(tetrahedra->GetOutputPort());
+  if (!Benchmark("vtkUnstructuredGridVolumeRayCastMapper",
+                 unstructuredGridMapper, volumeProperty,
+                 unstructuredGridMapper->GetTileRenderTimes(), numRenders,
+                 benchmark))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
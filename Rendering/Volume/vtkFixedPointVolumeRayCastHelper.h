@@ -720,7 +720,13 @@
   vtkIdType inc[3];                                                                             \
   inc[0] = components;                                                                          \
   inc[1] = inc[0]*dim[0];                                                                       \
-  inc[2] = inc[1]*dim[1];
+  inc[2] = inc[1]*dim[1];                                                                       \
+                                                                                                \
+  /* cast the rows of the band threadID of the threadCount bands */                             \
+  int firstRow = static_cast<int>(                                                              \
+    static_cast<vtkIdType>(imageInUseSize[1])*threadID/threadCount);                            \
+  int lastRow = static_cast<int>(                                                               \
+    static_cast<vtkIdType>(imageInUseSize[1])*(threadID+1)/threadCount);
 
 #define VTKKWRCHelper_InitializeWeights()                       \
   float weights[4] = {};                                        \
@@ -814,18 +820,7 @@
   vtkIdType dDHinc = dim[0]*dirOffset + dirOffset;
 
 #define VTKKWRCHelper_OuterInitialization()                             \
-    if ( j%threadCount != threadID )                                    \
-    {                                                                 \
-      continue;                                                         \
-    }                                                                 \
-     if ( !threadID )                                                   \
-     {                                                                 \
-      if ( renWin->CheckAbortStatus() )                                 \
-      {                                                               \
-        break;                                                          \
-      }                                                               \
-     }                                                                 \
-    else if ( renWin->GetAbortRender() )                                \
+    if ( renWin->GetAbortRender() )                                     \
     {                                                                 \
       break;                                                            \
     }                                                                 \
@@ -985,7 +980,7 @@
 
 #define VTKKWRCHelper_InitializationAndLoopStartNN()            \
   VTKKWRCHelper_InitializeVariables();                          \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -995,7 +990,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartGONN()          \
   VTKKWRCHelper_InitializeVariables();                          \
   VTKKWRCHelper_InitializeVariablesGO();                        \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1005,7 +1000,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartShadeNN()       \
   VTKKWRCHelper_InitializeVariables();                          \
   VTKKWRCHelper_InitializeVariablesShade();                     \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1016,7 +1011,7 @@
   VTKKWRCHelper_InitializeVariables();                          \
   VTKKWRCHelper_InitializeVariablesGO();                        \
   VTKKWRCHelper_InitializeVariablesShade();                     \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1026,7 +1021,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartTrilin()        \
   VTKKWRCHelper_InitializeVariables();                          \
   VTKKWRCHelper_InitializeTrilinVariables();                    \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1038,7 +1033,7 @@
   VTKKWRCHelper_InitializeVariablesGO();                        \
   VTKKWRCHelper_InitializeTrilinVariables();                    \
   VTKKWRCHelper_InitializeTrilinVariablesGO();                  \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1050,7 +1045,7 @@
   VTKKWRCHelper_InitializeVariablesShade();                     \
   VTKKWRCHelper_InitializeTrilinVariables();                    \
   VTKKWRCHelper_InitializeTrilinVariablesShade();               \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
@@ -1064,22 +1059,16 @@
   VTKKWRCHelper_InitializeTrilinVariables();                    \
   VTKKWRCHelper_InitializeTrilinVariablesShade();               \
   VTKKWRCHelper_InitializeTrilinVariablesGO();                  \
-  for ( j = 0; j < imageInUseSize[1]; j++ )                     \
+  for ( j = firstRow; j < lastRow; j++ )                        \
   {                                                           \
     VTKKWRCHelper_OuterInitialization();                        \
     for ( i = rowBounds[j*2]; i <= rowBounds[j*2+1]; i++ )      \
     {                                                         \
       VTKKWRCHelper_InnerInitialization();
 
-#define VTKKWRCHelper_IncrementAndLoopEnd()                                             \
-      imagePtr+=4;                                                                      \
-      }                                                                                 \
-    if ( (j/threadCount)%8 == 7 && threadID == 0)                                       \
-    {                                                                                 \
-      double fargs[1];                                                                  \
-      fargs[0] = static_cast<double>(j)/static_cast<float>(imageInUseSize[1]-1);        \
-      mapper->InvokeEvent( vtkCommand::VolumeMapperRenderProgressEvent, fargs );        \
-    }                                                                                 \
+#define VTKKWRCHelper_IncrementAndLoopEnd()     \
+      imagePtr+=4;                              \
+      }                                         \
     }
 
 #define VTKKWRCHelper_CroppingCheckTrilin( POS )        \
@@ -1114,6 +1103,19 @@
   mmpos[2] = 0;                                 \
   int mmvalid[4] = {0,0,0,0};
 
+// Leap over the samples of the ray in the empty cell of the occupancy octree
+// containing the current one, but the last of them which the loop moves to.
+// The last step of the ray is never leaped over, since the nearest neighbor
+// loops do not move to it.
+#define VTKKWRCHelper_SpaceLeap()                                       \
+  if ( k + 2 < numSteps )                                               \
+  {                                                                   \
+    unsigned int _leap =                                                \
+      mapper->ComputeEmptySpaceSteps( pos, dir, numSteps - 1 - k ) - 1; \
+    mapper->FixedPointIncrement( pos, dir, _leap );                     \
+    k += _leap;                                                         \
+  }
+
 #define VTKKWRCHelper_SpaceLeapCheck()                          \
   if ( pos[0] >> VTKKW_FPMM_SHIFT != mmpos[0] ||                \
        pos[1] >> VTKKW_FPMM_SHIFT != mmpos[1] ||                \
@@ -1127,6 +1129,7 @@
                                                                 \
   if ( !mmvalid )                                               \
   {                                                           \
+    VTKKWRCHelper_SpaceLeap();                                  \
     continue;                                                   \
   }
 
@@ -1176,8 +1179,13 @@ public:
   vtkTypeMacro(vtkFixedPointVolumeRayCastHelper,vtkObject);
   void PrintSelf( ostream& os, vtkIndent indent ) override;
 
-  virtual void   GenerateImage( int,
-                                int,
+  /**
+   * Cast the rays of the rows of the image in the band threadID of the
+   * threadCount bands of rows the image is split into. Several bands may
+   * be cast at the same time by different threads.
+   */
+  virtual void   GenerateImage( int vtkNotUsed(threadID),
+                                int vtkNotUsed(threadCount),
                                 vtkVolume *,
                                 vtkFixedPointVolumeRayCastMapper *) {}
 
@@ -21,6 +21,7 @@
 #include "vtkFiniteDifferenceGradientEstimator.h"
 #include "vtkImageData.h"
 #include "vtkCommand.h"
+#include "vtkDoubleArray.h"
 #include "vtkGraphicsFactory.h"
 #include "vtkSphericalDirectionEncoder.h"
 #include "vtkFixedPointVolumeRayCastCompositeGOHelper.h"
@@ -37,6 +38,7 @@
 #include "vtkPointData.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkTransform.h"
 #include "vtkVolumeProperty.h"
@@ -45,8 +47,10 @@
 #include "vtkFixedPointRayCastImage.h"
 #include "vtkVolumeRayCastSpaceLeapingImageFilter.h"
 
+#include <atomic>
 #include <exception>
 #include <cmath>
+#include <thread>
 
 vtkStandardNewMacro(vtkFixedPointVolumeRayCastMapper);
 vtkCxxSetObjectMacro(vtkFixedPointVolumeRayCastMapper, RayCastImage, vtkFixedPointRayCastImage);
@@ -615,6 +619,7 @@ vtkFixedPointVolumeRayCastMapper::vtkFixedPointVolumeRayCastMapper()
   this->VoxelsToViewTransform  = vtkTransform::New();
 
   this->Threader               = vtkMultiThreader::New();
+  this->TileRenderTimes        = vtkDoubleArray::New();
   this->ThreadWarning          = true;
   this->RayCastImage           = vtkFixedPointRayCastImage::New();
 
@@ -701,6 +706,15 @@ vtkFixedPointVolumeRayCastMapper::vtkFixedPointVolumeRayCastMapper()
   this->MinMaxVolumeSize[3] = 0;
   this->SavedMinMaxInput = nullptr;
 
+  for ( i = 0; i < VTKKW_FPMM_LEVELS; i++ )
+  {
+    this->OccupancyLevels[i] = nullptr;
+    this->OccupancyLevelSize[i][0] = 0;
+    this->OccupancyLevelSize[i][1] = 0;
+    this->OccupancyLevelSize[i][2] = 0;
+  }
+  this->NumberOfOccupancyLevels = 0;
+
   this->Volume = nullptr;
 
   this->FinalColorWindow           = 1.0;
@@ -732,6 +746,11 @@ vtkFixedPointVolumeRayCastMapper::~vtkFixedPointVolumeRayCastMapper()
 {
   this->SpaceLeapFilter->Delete();
 
+  for ( int level = 0; level < this->NumberOfOccupancyLevels; level++ )
+  {
+    delete [] this->OccupancyLevels[level];
+  }
+
   this->PerspectiveMatrix->Delete();
   this->ViewToWorldMatrix->Delete();
   this->ViewToVoxelsMatrix->Delete();
@@ -746,6 +765,7 @@ vtkFixedPointVolumeRayCastMapper::~vtkFixedPointVolumeRayCastMapper()
   this->PerspectiveTransform->Delete();
 
   this->Threader->Delete();
+  this->TileRenderTimes->Delete();
 
   this->MIPHelper->Delete();
   this->CompositeHelper->Delete();
@@ -1047,6 +1067,7 @@ void vtkFixedPointVolumeRayCastMapper::UpdateMinMaxVolume( vtkVolume *vol )
   this->SpaceLeapFilter->Update();
   this->MinMaxVolume =
     this->SpaceLeapFilter->GetMinMaxVolume(this->MinMaxVolumeSize);
+  this->UpdateOccupancyLevels();
 
   // Cached space leaping output. This is shared between runs. The output
   // of the last run is passed back to the SpaceLeapFilter and its reused
@@ -1068,6 +1089,75 @@ void vtkFixedPointVolumeRayCastMapper::UpdateMinMaxVolume( vtkVolume *vol )
   }
 }
 
+//----------------------------------------------------------------------------
+// Build the occupancy octree from the flags of the first component of the
+// min max volume, the only ones the composite helpers check.
+void vtkFixedPointVolumeRayCastMapper::UpdateOccupancyLevels()
+{
+  int level;
+  for ( level = 0; level < this->NumberOfOccupancyLevels; level++ )
+  {
+    delete [] this->OccupancyLevels[level];
+    this->OccupancyLevels[level] = nullptr;
+  }
+  this->NumberOfOccupancyLevels = 0;
+
+  if ( !this->MinMaxVolume )
+  {
+    return;
+  }
+
+  int *size = this->OccupancyLevelSize[0];
+  size[0] = this->MinMaxVolumeSize[0];
+  size[1] = this->MinMaxVolumeSize[1];
+  size[2] = this->MinMaxVolumeSize[2];
+  vtkIdType numCells =
+    static_cast<vtkIdType>(size[0])*size[1]*size[2];
+  unsigned char *flags = new unsigned char[numCells];
+  vtkIdType components = this->MinMaxVolumeSize[3];
+  for ( vtkIdType idx = 0; idx < numCells; idx++ )
+  {
+    flags[idx] =
+      ( (*(this->MinMaxVolume + 3*components*idx + 2))&0x00ff ) ? 1 : 0;
+  }
+  this->OccupancyLevels[0] = flags;
+  this->NumberOfOccupancyLevels = 1;
+
+  // Each level halves the previous one, until a single cell covers the
+  // volume
+  for ( level = 1; level < VTKKW_FPMM_LEVELS; level++ )
+  {
+    int *childSize = this->OccupancyLevelSize[level-1];
+    if ( childSize[0] == 1 && childSize[1] == 1 && childSize[2] == 1 )
+    {
+      break;
+    }
+    size = this->OccupancyLevelSize[level];
+    size[0] = (childSize[0] + 1)/2;
+    size[1] = (childSize[1] + 1)/2;
+    size[2] = (childSize[2] + 1)/2;
+    unsigned char *children = this->OccupancyLevels[level-1];
+    unsigned char *cells =
+      new unsigned char[static_cast<vtkIdType>(size[0])*size[1]*size[2]]();
+    for ( int z = 0; z < childSize[2]; z++ )
+    {
+      for ( int y = 0; y < childSize[1]; y++ )
+      {
+        unsigned char *childRow =
+          children + (static_cast<vtkIdType>(z)*childSize[1] + y)*childSize[0];
+        unsigned char *cellRow =
+          cells + (static_cast<vtkIdType>(z/2)*size[1] + y/2)*size[0];
+        for ( int x = 0; x < childSize[0]; x++ )
+        {
+          cellRow[x/2] |= childRow[x];
+        }
+      }
+    }
+    this->OccupancyLevels[level] = cells;
+    this->NumberOfOccupancyLevels = level + 1;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkFixedPointVolumeRayCastMapper::UpdateCroppingRegions()
 {
@@ -1284,15 +1374,114 @@ void vtkFixedPointVolumeRayCastMapper::PerSubVolumeInitialization( vtkRenderer *
   this->InitializeRayInfo( vol );
 }
 
+namespace
+{
+// The number of rows of the image in each tile cast by a thread. Small
+// tiles keep all the threads busy until the end, even when the rays of
+// some parts of the image end early.
+const int VTK_FPVRCM_TILE_ROWS = 4;
+
+// Cast the rays of the tiles of the image with the helper. The progress
+// events are invoked and the abort checks are done by the rendering thread
+// alone, between two tiles.
+class vtkFixedPointVolumeRayCastMapperCastTiles
+{
+public:
+  vtkFixedPointVolumeRayCastMapper *Mapper;
+  vtkFixedPointVolumeRayCastHelper *Helper;
+  vtkVolume *Volume;
+  int NumberOfTiles;
+  double *TileRenderTimes;
+  std::thread::id RenderingThread;
+  std::atomic<int> NumberOfTilesDone;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    vtkRenderWindow *renWin = this->Mapper->GetRenderWindow();
+    for ( vtkIdType tile = begin; tile < end; tile++ )
+    {
+      if ( renWin->GetAbortRender() )
+      {
+        return;
+      }
+
+      double startTime = vtkTimerLog::GetUniversalTime();
+      this->Helper->GenerateImage( static_cast<int>(tile),
+                                   this->NumberOfTiles,
+                                   this->Volume, this->Mapper );
+      this->TileRenderTimes[tile] =
+        vtkTimerLog::GetUniversalTime() - startTime;
+
+      int done = ++this->NumberOfTilesDone;
+      if ( std::this_thread::get_id() == this->RenderingThread )
+      {
+        double fargs[1];
+        fargs[0] = static_cast<double>(done)/this->NumberOfTiles;
+        this->Mapper->InvokeEvent(
+          vtkCommand::VolumeMapperRenderProgressEvent, fargs );
+        renWin->CheckAbortStatus();
+      }
+    }
+  }
+};
+}
+
+// The helper casting the rays for the blend mode, shading and gradient
+// opacity of the volume.
+static vtkFixedPointVolumeRayCastHelper *vtkFPVRCMGetHelper(
+  vtkFixedPointVolumeRayCastMapper *me )
+{
+  if ( me->GetBlendMode() == vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND ||
+       me->GetBlendMode() == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND )
+  {
+    return me->GetMIPHelper();
+  }
+  if ( me->GetShadingRequired() == 0 )
+  {
+    if ( me->GetGradientOpacityRequired() == 0 )
+    {
+      return me->GetCompositeHelper();
+    }
+    return me->GetCompositeGOHelper();
+  }
+  if ( me->GetGradientOpacityRequired() == 0 )
+  {
+    return me->GetCompositeShadeHelper();
+  }
+  return me->GetCompositeGOShadeHelper();
+}
+
 // This is the render method for the subvolume
 void vtkFixedPointVolumeRayCastMapper::RenderSubVolume()
 {
-  // Set the number of threads to use for ray casting,
-  // then set the execution method and do it.
   this->InvokeEvent( vtkCommand::VolumeMapperRenderStartEvent, nullptr );
-  this->Threader->SetSingleMethod( FixedPointVolumeRayCastMapper_CastRays,
-                                   (void *)this);
-  this->Threader->SingleMethodExecute();
+
+  // Split the image into tiles of rows and cast them with vtkSMPTools,
+  // one tile at a time so that the free threads take the remaining tiles.
+  int imageInUseSize[2];
+  this->RayCastImage->GetImageInUseSize( imageInUseSize );
+  int numTiles =
+    ( imageInUseSize[1] + VTK_FPVRCM_TILE_ROWS - 1 ) / VTK_FPVRCM_TILE_ROWS;
+  this->TileRenderTimes->SetNumberOfValues( numTiles );
+  this->TileRenderTimes->FillValue( 0.0 );
+
+  vtkFixedPointVolumeRayCastMapperCastTiles castTiles;
+  castTiles.Mapper = this;
+  castTiles.Helper = vtkFPVRCMGetHelper( this );
+  castTiles.Volume = this->Volume;
+  castTiles.NumberOfTiles = numTiles;
+  castTiles.TileRenderTimes = this->TileRenderTimes->GetPointer(0);
+  castTiles.RenderingThread = std::this_thread::get_id();
+  castTiles.NumberOfTilesDone = 0;
+  if ( this->GetNumberOfThreads() == 1 )
+  {
+    castTiles( 0, numTiles );
+  }
+  else
+  {
+    vtkSMPTools::For( 0, numTiles, 1, castTiles );
+  }
+
   this->InvokeEvent( vtkCommand::VolumeMapperRenderEndEvent, nullptr );
 }
 
@@ -1528,56 +1717,6 @@ void vtkFixedPointVolumeRayCastMapper::Render( vtkRenderer *ren, vtkVolume *vol
   this->SampleDistance = this->OldSampleDistance;
 }
 
-VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays( void *arg )
-{
-  // Get the info out of the input structure
-  int threadID    = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
-  int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
-
-  vtkFixedPointVolumeRayCastMapper *me = (vtkFixedPointVolumeRayCastMapper *)(((vtkMultiThreader::ThreadInfo *)arg)->UserData);
-
-  if ( !me )
-  {
-    vtkGenericWarningMacro("Irrecoverable error: no mapper specified");
-    return VTK_THREAD_RETURN_VALUE;
-  }
-
-  vtkVolume *vol = me->GetVolume();
-
-  if ( me->GetBlendMode() == vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND ||
-       me->GetBlendMode() == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND )
-  {
-    me->GetMIPHelper()->GenerateImage( threadID, threadCount, vol, me );
-  }
-  else
-  {
-    if ( me->GetShadingRequired() == 0 )
-    {
-      if ( me->GetGradientOpacityRequired() == 0 )
-      {
-        me->GetCompositeHelper()->GenerateImage( threadID, threadCount, vol, me );
-      }
-      else
-      {
-        me->GetCompositeGOHelper()->GenerateImage( threadID, threadCount, vol, me );
-      }
-    }
-    else
-    {
-      if ( me->GetGradientOpacityRequired() == 0 )
-      {
-        me->GetCompositeShadeHelper()->GenerateImage( threadID, threadCount, vol, me );
-      }
-      else
-      {
-        me->GetCompositeGOShadeHelper()->GenerateImage( threadID, threadCount, vol, me );
-      }
-    }
-  }
-
-  return VTK_THREAD_RETURN_VALUE;
-}
-
 // Create an image into the vtkImageData argmument. Used generally for
 // creating thumbnail images
 void vtkFixedPointVolumeRayCastMapper::CreateCanonicalView( vtkVolume *vol,
@@ -61,6 +61,7 @@
 
 #define VTKKW_FP_SHIFT       15
 #define VTKKW_FPMM_SHIFT     17
+#define VTKKW_FPMM_LEVELS    8
 #define VTKKW_FP_MASK        0x7fff
 #define VTKKW_FP_SCALE       32767.0
 
@@ -86,9 +87,9 @@ class vtkFiniteDifferenceGradientEstimator;
 class vtkRayCastImageDisplayHelper;
 class vtkFixedPointRayCastImage;
 class vtkDataArray;
+class vtkDoubleArray;
 
 // Forward declaration needed for use by friend declaration below.
-VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays( void *arg );
 VTK_THREAD_RETURN_TYPE vtkFPVRCMSwitchOnDataType( void *arg );
 
 class VTKRENDERINGVOLUME_EXPORT vtkFixedPointVolumeRayCastMapper : public vtkVolumeMapper
@@ -181,14 +182,26 @@ public:
 
   //@{
   /**
-   * Set/Get the number of threads to use. This by default is equal to
-   * the number of available processors detected.
+   * Set/Get the number of threads to use to compute the gradients. This by
+   * default is equal to the number of available processors detected. The
+   * rays are cast by the threads of vtkSMPTools (see
+   * vtkSMPTools::Initialize()), unless the number of threads is 1, in
+   * which case they are cast by the rendering thread alone.
    * WARNING: If number of threads > 1, results may not be consistent.
    */
   void SetNumberOfThreads( int num );
   int GetNumberOfThreads();
   //@}
 
+  /**
+   * The image is split into tiles of a few rows, which the threads cast
+   * as they become free, so that the threads casting the rays that end
+   * early take more tiles. Get the time in seconds spent casting the rays
+   * of each tile in the last rendering of a subvolume, to check how the
+   * work is balanced.
+   */
+  vtkGetObjectMacro( TileRenderTimes, vtkDoubleArray );
+
   //@{
   /**
    * If IntermixIntersectingGeometry is turned on, the zbuffer will be
@@ -225,11 +238,15 @@ public:
   unsigned int ToFixedPointDirection( float dir );
   void ToFixedPointDirection( float in[3], unsigned int out[3] );
   void FixedPointIncrement( unsigned int position[3], unsigned int increment[3] );
+  void FixedPointIncrement( unsigned int position[3], unsigned int increment[3],
+                            unsigned int steps );
   void GetFloatTripleFromPointer( float v[3], float *ptr );
   void GetUIntTripleFromPointer( unsigned int v[3], unsigned int *ptr );
   void ShiftVectorDown( unsigned int in[3], unsigned int out[3] );
   int CheckMinMaxVolumeFlag( unsigned int pos[3], int c );
   int CheckMIPMinMaxVolumeFlag( unsigned int pos[3], int c, unsigned short maxIdx, int flip );
+  unsigned int ComputeEmptySpaceSteps( unsigned int pos[3], unsigned int dir[3],
+                                       unsigned int maxSteps );
 
   void LookupColorUC( unsigned short *colorTable,
                       unsigned short *scalarOpacityTable,
@@ -390,10 +407,10 @@ protected:
 
   void CaptureZBuffer( vtkRenderer *ren );
 
-  friend VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays( void *arg );
   friend VTK_THREAD_RETURN_TYPE vtkFPVRCMSwitchOnDataType( void *arg );
 
   vtkMultiThreader  *Threader;
+  vtkDoubleArray    *TileRenderTimes;
 
   vtkMatrix4x4   *PerspectiveMatrix;
   vtkMatrix4x4   *ViewToWorldMatrix;
@@ -532,6 +549,17 @@ protected:
   vtkVolumeRayCastSpaceLeapingImageFilter * SpaceLeapFilter;
 
   void            UpdateMinMaxVolume( vtkVolume *vol );
+
+  // The occupancy octree used to leap over the empty space. The first level
+  // holds the flags of the first component of the min max volume, and each
+  // cell of the next levels is occupied if any of its 2x2x2 children is.
+  // It is rebuilt whenever the flags of the min max volume are, that is
+  // when the data or the transfer functions change.
+  unsigned char  *OccupancyLevels[VTKKW_FPMM_LEVELS];
+  int             OccupancyLevelSize[VTKKW_FPMM_LEVELS][3];
+  int             NumberOfOccupancyLevels;
+
+  void            UpdateOccupancyLevels();
   void            FillInMaxGradientMagnitudes( int fullDim[3],
                                                int smallDim[3] );
 
@@ -614,6 +642,23 @@ inline void vtkFixedPointVolumeRayCastMapper::FixedPointIncrement( unsigned int
 }
 
 
+inline void vtkFixedPointVolumeRayCastMapper::FixedPointIncrement( unsigned int position[3],
+                                                                  unsigned int increment[3],
+                                                                  unsigned int steps )
+{
+  for ( int i = 0; i < 3; i++ )
+  {
+    if ( increment[i]&0x80000000 )
+    {
+      position[i] += steps*(increment[i]&0x7fffffff);
+    }
+    else
+    {
+      position[i] -= steps*increment[i];
+    }
+  }
+}
+
 inline void vtkFixedPointVolumeRayCastMapper::GetFloatTripleFromPointer( float v[3], float *ptr )
 {
   v[0] = *(ptr);
@@ -675,6 +720,57 @@ inline int vtkFixedPointVolumeRayCastMapper::CheckMIPMinMaxVolumeFlag( unsigned
   }
 }
 
+// Return the number of samples of the ray, starting at the sample at pos,
+// which lie in the largest empty cell of the occupancy octree containing
+// pos, up to maxSteps. The min max cell of pos must be empty.
+inline unsigned int vtkFixedPointVolumeRayCastMapper::ComputeEmptySpaceSteps( unsigned int pos[3],
+                                                                             unsigned int dir[3],
+                                                                             unsigned int maxSteps )
+{
+  unsigned int mmpos[3];
+  mmpos[0] = pos[0] >> VTKKW_FPMM_SHIFT;
+  mmpos[1] = pos[1] >> VTKKW_FPMM_SHIFT;
+  mmpos[2] = pos[2] >> VTKKW_FPMM_SHIFT;
+
+  // Climb up the octree as long as the parent cell is empty
+  int level = 0;
+  while ( level + 1 < this->NumberOfOccupancyLevels )
+  {
+    int *size = this->OccupancyLevelSize[level+1];
+    vtkIdType offset =
+      ( static_cast<vtkIdType>(mmpos[2] >> (level+1))*size[1] +
+        (mmpos[1] >> (level+1)) )*size[0] + (mmpos[0] >> (level+1));
+    if ( this->OccupancyLevels[level+1][offset] )
+    {
+      break;
+    }
+    level++;
+  }
+
+  // The samples in the cell are those before the ray crosses one of its
+  // faces, computed exactly in fixed point
+  unsigned int shift = VTKKW_FPMM_SHIFT + level;
+  unsigned int cellSize = 1u << shift;
+  unsigned int steps = maxSteps;
+  for ( int i = 0; i < 3; i++ )
+  {
+    unsigned int increment = dir[i]&0x7fffffff;
+    if ( !increment )
+    {
+      continue;
+    }
+    unsigned int offsetInCell = pos[i] & (cellSize - 1);
+    unsigned int inside = ( dir[i]&0x80000000 ) ?
+      ( (cellSize - 1 - offsetInCell)/increment + 1 ) :
+      ( offsetInCell/increment + 1 );
+    if ( inside < steps )
+    {
+      steps = inside;
+    }
+  }
+  return steps;
+}
+
 inline void vtkFixedPointVolumeRayCastMapper::LookupColorUC( unsigned short *colorTable,
                                                      unsigned short *scalarOpacityTable,
                                                      unsigned short index,
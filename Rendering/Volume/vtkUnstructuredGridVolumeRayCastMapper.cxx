@@ -26,6 +26,8 @@
 #include "vtkPointData.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkTransform.h"
 #include "vtkVolumeProperty.h"
@@ -38,10 +40,129 @@
 #include "vtkDoubleArray.h"
 #include "vtkIdList.h"
 
+#include <atomic>
 #include <cmath>
+#include <thread>
 
-VTK_THREAD_RETURN_TYPE UnstructuredGridVolumeRayCastMapper_CastRays( void *arg );
+namespace
+{
+
+// The number of rows of the tiles of the image handed to the threads.
+const int VTK_UGVRCM_TILE_ROWS = 4;
+
+// The iterator and buffers a thread casts its rays with.
+struct vtkUGVRCMThreadBuffers
+{
+  vtkUnstructuredGridVolumeRayCastIterator *Iterator;
+  vtkIdList *IntersectedCells;
+  vtkDoubleArray *IntersectionLengths;
+  vtkDataArray *NearIntersections;
+  vtkDataArray *FarIntersections;
+};
+
+// Casts the rays of tiles of rows of the image. Each thread creates its
+// iterator and buffers with the first tile it casts, and only the rendering
+// thread reports the progress and checks whether the render was aborted,
+// since it may have to process the events of the window.
+class vtkUGVRCMCastTiles
+{
+public:
+  vtkUnstructuredGridVolumeRayCastMapper *Mapper;
+  vtkRenderWindow *RenderWindow;
+  vtkUnstructuredGridVolumeRayCastFunction *RayCastFunction;
+  vtkDataArray *Scalars;
+  int CellScalars;
+  int NumberOfRows;
+  int NumberOfTiles;
+  double *TileRenderTimes;
+  std::thread::id RenderingThread;
+  std::atomic<int> NumberOfTilesDone;
+  vtkSMPThreadLocal<vtkUGVRCMThreadBuffers> Buffers;
+
+  void Initialize()
+  {
+    vtkUGVRCMThreadBuffers &buffers = this->Buffers.Local();
+    buffers.Iterator = this->RayCastFunction->NewIterator();
+    vtkIdType maxNumberOfIntersections =
+      buffers.Iterator->GetMaxNumberOfIntersections();
+    buffers.IntersectionLengths = vtkDoubleArray::New();
+    buffers.IntersectionLengths->Allocate(maxNumberOfIntersections);
+    buffers.NearIntersections =
+      vtkDataArray::CreateDataArray(this->Scalars->GetDataType());
+    buffers.NearIntersections->Allocate(maxNumberOfIntersections);
+    if (this->CellScalars)
+    {
+      buffers.IntersectedCells = vtkIdList::New();
+      buffers.IntersectedCells->Allocate(maxNumberOfIntersections);
+      buffers.FarIntersections = buffers.NearIntersections;
+    }
+    else
+    {
+      buffers.IntersectedCells = nullptr;
+      buffers.FarIntersections =
+        vtkDataArray::CreateDataArray(this->Scalars->GetDataType());
+      buffers.FarIntersections->Allocate(maxNumberOfIntersections);
+    }
+  }
+
+  void operator()(vtkIdType beginTile, vtkIdType endTile)
+  {
+    vtkUGVRCMThreadBuffers &buffers = this->Buffers.Local();
+    bool renderingThread =
+      (std::this_thread::get_id() == this->RenderingThread);
+    for (vtkIdType tile = beginTile; tile < endTile; ++tile)
+    {
+      if (this->RenderWindow->GetAbortRender())
+      {
+        return;
+      }
+      int firstRow = static_cast<int>(tile) * VTK_UGVRCM_TILE_ROWS;
+      int lastRow = firstRow + VTK_UGVRCM_TILE_ROWS;
+      if (lastRow > this->NumberOfRows)
+      {
+        lastRow = this->NumberOfRows;
+      }
+      double start = vtkTimerLog::GetUniversalTime();
+      this->Mapper->CastRays(firstRow, lastRow, buffers.Iterator,
+        buffers.IntersectedCells, buffers.IntersectionLengths,
+        buffers.NearIntersections, buffers.FarIntersections);
+      this->TileRenderTimes[tile] = vtkTimerLog::GetUniversalTime() - start;
+      int done = ++this->NumberOfTilesDone;
+      if (renderingThread)
+      {
+        this->Mapper->UpdateProgress(
+          static_cast<double>(done) / this->NumberOfTiles);
+        this->RenderWindow->CheckAbortStatus();
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
 
+  // Delete the iterators and buffers of the threads.
+  void Release()
+  {
+    vtkSMPThreadLocal<vtkUGVRCMThreadBuffers>::iterator iter;
+    for (iter = this->Buffers.begin(); iter != this->Buffers.end(); ++iter)
+    {
+      iter->Iterator->Delete();
+      iter->IntersectionLengths->Delete();
+      iter->NearIntersections->Delete();
+      if (iter->IntersectedCells)
+      {
+        iter->IntersectedCells->Delete();
+      }
+      else
+      {
+        iter->FarIntersections->Delete();
+      }
+    }
+  }
+};
+
+} // end anon namespace
 
 vtkStandardNewMacro(vtkUnstructuredGridVolumeRayCastMapper);
 
@@ -61,8 +182,9 @@ vtkUnstructuredGridVolumeRayCastMapper::vtkUnstructuredGridVolumeRayCastMapper()
   this->ImageMemorySize[0]     = 0;
   this->ImageMemorySize[1]     = 0;
 
-  this->Threader               = vtkMultiThreader::New();
-  this->NumberOfThreads        = this->Threader->GetNumberOfThreads();
+  this->NumberOfThreads        =
+    vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  this->TileRenderTimes        = vtkDoubleArray::New();
 
   this->Image                  = nullptr;
 
@@ -90,7 +212,7 @@ vtkUnstructuredGridVolumeRayCastMapper::vtkUnstructuredGridVolumeRayCastMapper()
 // Destruct a vtkUnstructuredGridVolumeRayCastMapper - clean up any memory used
 vtkUnstructuredGridVolumeRayCastMapper::~vtkUnstructuredGridVolumeRayCastMapper()
 {
-  this->Threader->Delete();
+  this->TileRenderTimes->Delete();
 
   delete [] this->Image;
 
@@ -399,69 +521,39 @@ void vtkUnstructuredGridVolumeRayCastMapper::Render( vtkRenderer *ren, vtkVolume
   this->CurrentVolume   = vol;
   this->CurrentRenderer = ren;
 
-  // Create iterators and buffers here to prevent race conditions.
-  this->RayCastIterators
-    = new vtkUnstructuredGridVolumeRayCastIterator*[this->NumberOfThreads];
-  this->IntersectedCellsBuffer    = new vtkIdList*[this->NumberOfThreads];
-  this->IntersectionLengthsBuffer = new vtkDoubleArray*[this->NumberOfThreads];
-  this->NearIntersectionsBuffer   = new vtkDataArray*[this->NumberOfThreads];
-  this->FarIntersectionsBuffer    = new vtkDataArray*[this->NumberOfThreads];
-  for (i = 0; i < this->NumberOfThreads; i++)
+  // Cast the rays by tiles of rows, each thread with its own iterator and
+  // buffers.
+  int numTiles =
+    ( this->ImageInUseSize[1] + VTK_UGVRCM_TILE_ROWS - 1 ) /
+    VTK_UGVRCM_TILE_ROWS;
+  this->TileRenderTimes->SetNumberOfValues( numTiles );
+  this->TileRenderTimes->FillValue( 0.0 );
+
+  vtkUGVRCMCastTiles castTiles;
+  castTiles.Mapper = this;
+  castTiles.RenderWindow = ren->GetRenderWindow();
+  castTiles.RayCastFunction = this->RayCastFunction;
+  castTiles.Scalars = this->Scalars;
+  castTiles.CellScalars = this->CellScalars;
+  castTiles.NumberOfRows = this->ImageInUseSize[1];
+  castTiles.NumberOfTiles = numTiles;
+  castTiles.TileRenderTimes = this->TileRenderTimes->GetPointer(0);
+  castTiles.RenderingThread = std::this_thread::get_id();
+  castTiles.NumberOfTilesDone = 0;
+  if ( this->NumberOfThreads == 1 )
   {
-    this->RayCastIterators[i] = this->RayCastFunction->NewIterator();
-    this->IntersectionLengthsBuffer[i] = vtkDoubleArray::New();
-    this->IntersectionLengthsBuffer[i]
-      ->Allocate(this->RayCastIterators[i]->GetMaxNumberOfIntersections());
-    this->NearIntersectionsBuffer[i]
-      = vtkDataArray::CreateDataArray(this->Scalars->GetDataType());
-    this->NearIntersectionsBuffer[i]
-      ->Allocate(this->RayCastIterators[i]->GetMaxNumberOfIntersections());
-    if (this->CellScalars)
-    {
-      this->IntersectedCellsBuffer[i] = vtkIdList::New();
-      this->IntersectedCellsBuffer[i]
-        ->Allocate(this->RayCastIterators[i]->GetMaxNumberOfIntersections());
-      this->FarIntersectionsBuffer[i] = this->NearIntersectionsBuffer[i];
-    }
-    else
-    {
-      this->IntersectedCellsBuffer[i] = nullptr;
-      this->FarIntersectionsBuffer[i]
-        = vtkDataArray::CreateDataArray(this->Scalars->GetDataType());
-      this->FarIntersectionsBuffer[i]
-        ->Allocate(this->RayCastIterators[i]->GetMaxNumberOfIntersections());
-    }
+    castTiles.Initialize();
+    castTiles( 0, numTiles );
   }
-
-  // Set the number of threads to use for ray casting,
-  // then set the execution method and do it.
-  this->Threader->SetNumberOfThreads( this->NumberOfThreads );
-  this->Threader->SetSingleMethod( UnstructuredGridVolumeRayCastMapper_CastRays,
-                                   (void *)this);
-  this->Threader->SingleMethodExecute();
+  else
+  {
+    vtkSMPTools::For( 0, numTiles, 1, castTiles );
+  }
+  castTiles.Release();
 
   // We don't need these anymore
   this->CurrentVolume   = nullptr;
   this->CurrentRenderer = nullptr;
-  for (i = 0; i < this->NumberOfThreads; i++)
-  {
-    this->RayCastIterators[i]->Delete();
-    this->IntersectionLengthsBuffer[i]->Delete();
-    this->NearIntersectionsBuffer[i]->Delete();
-    if (this->CellScalars)
-    {
-      this->IntersectedCellsBuffer[i]->Delete();
-    }
-    else
-    {
-      this->FarIntersectionsBuffer[i]->Delete();
-    }
-  }
-  delete[] this->RayCastIterators;
-  delete[] this->IntersectedCellsBuffer;
-  delete[] this->IntersectionLengthsBuffer;
-  delete[] this->NearIntersectionsBuffer;
-  delete[] this->FarIntersectionsBuffer;
 
   if ( !ren->GetRenderWindow()->GetAbortRender() )
   {
@@ -500,25 +592,6 @@ void vtkUnstructuredGridVolumeRayCastMapper::Render( vtkRenderer *ren, vtkVolume
   this->UpdateProgress(1.0);
 }
 
-VTK_THREAD_RETURN_TYPE UnstructuredGridVolumeRayCastMapper_CastRays( void *arg )
-{
-  // Get the info out of the input structure
-  int threadID    = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
-  int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
-  vtkUnstructuredGridVolumeRayCastMapper *me =
-    (vtkUnstructuredGridVolumeRayCastMapper *)((vtkMultiThreader::ThreadInfo *)arg)->UserData;
-
-  if ( !me )
-  {
-    vtkGenericWarningMacro("The volume does not have a ray cast mapper!");
-    return VTK_THREAD_RETURN_VALUE;
-  }
-
-  me->CastRays( threadID, threadCount );
-
-  return VTK_THREAD_RETURN_VALUE;
-}
-
 template<class T>
 inline void vtkUGVRCMLookupCopy(const T *src, T *dest, vtkIdType *lookup,
                                 int numcomponents, int numtuples)
@@ -534,36 +607,22 @@ inline void vtkUGVRCMLookupCopy(const T *src, T *dest, vtkIdType *lookup,
   }
 }
 
-void vtkUnstructuredGridVolumeRayCastMapper::CastRays( int threadID, int threadCount )
+void vtkUnstructuredGridVolumeRayCastMapper::CastRays(
+  int firstRow, int lastRow,
+  vtkUnstructuredGridVolumeRayCastIterator *iterator,
+  vtkIdList *intersectedCells,
+  vtkDoubleArray *intersectionLengths,
+  vtkDataArray *nearIntersections,
+  vtkDataArray *farIntersections )
 {
   int i, j;
   unsigned char *ucptr;
 
   vtkRenderWindow *renWin = this->CurrentRenderer->GetRenderWindow();
-  vtkUnstructuredGridVolumeRayCastIterator *iterator
-    = this->RayCastIterators[threadID];
 
-  vtkIdList *intersectedCells = this->IntersectedCellsBuffer[threadID];
-  vtkDoubleArray *intersectionLengths=this->IntersectionLengthsBuffer[threadID];
-  vtkDataArray *nearIntersections = this->NearIntersectionsBuffer[threadID];
-  vtkDataArray *farIntersections = this->FarIntersectionsBuffer[threadID];
-
-  for ( j = 0; j < this->ImageInUseSize[1]; j++ )
+  for ( j = firstRow; j < lastRow; j++ )
   {
-    if ( j%threadCount != threadID )
-    {
-      continue;
-    }
-
-    if ( !threadID )
-    {
-      this->UpdateProgress((double)j/this->ImageInUseSize[1]);
-      if ( renWin->CheckAbortStatus() )
-      {
-        break;
-      }
-    }
-    else if ( renWin->GetAbortRender() )
+    if ( renWin->GetAbortRender() )
     {
       break;
     }
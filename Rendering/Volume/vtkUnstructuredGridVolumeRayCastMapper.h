@@ -29,9 +29,9 @@
 #include "vtkRenderingVolumeModule.h" // For export macro
 #include "vtkUnstructuredGridVolumeMapper.h"
 
+class vtkDataArray;
 class vtkDoubleArray;
 class vtkIdList;
-class vtkMultiThreader;
 class vtkRayCastImageDisplayHelper;
 class vtkRenderer;
 class vtkTimerLog;
@@ -90,12 +90,24 @@ public:
   //@{
   /**
    * Set/Get the number of threads to use. This by default is equal to
-   * the number of available processors detected.
+   * the number of available processors detected. The rays are cast by the
+   * threads of vtkSMPTools (see vtkSMPTools::Initialize()), unless the
+   * number of threads is 1, in which case the rendering thread casts them
+   * alone.
    */
   vtkSetMacro( NumberOfThreads, int );
   vtkGetMacro( NumberOfThreads, int );
   //@}
 
+  /**
+   * Get the time in seconds spent casting the rays of each tile of the
+   * last image. The tiles are bands of a few rows of the image, handed to
+   * the threads as they finish their previous tiles, which balances the
+   * work when the rays of some parts of the image are much longer than
+   * others.
+   */
+  vtkGetObjectMacro( TileRenderTimes, vtkDoubleArray );
+
   //@{
   /**
    * If IntermixIntersectingGeometry is turned on, the zbuffer will be
@@ -141,7 +153,17 @@ public:
   vtkGetVectorMacro( ImageOrigin, int, 2 );
   vtkGetVectorMacro( ImageViewportSize, int , 2 );
 
-  void CastRays( int threadID, int threadCount );
+  /**
+   * WARNING: INTERNAL METHOD - NOT INTENDED FOR GENERAL USE
+   * Cast the rays of the rows [firstRow, lastRow) of the image, with an
+   * iterator and buffers used by a single thread.
+   */
+  void CastRays( int firstRow, int lastRow,
+                 vtkUnstructuredGridVolumeRayCastIterator *iterator,
+                 vtkIdList *intersectedCells,
+                 vtkDoubleArray *intersectionLengths,
+                 vtkDataArray *nearIntersections,
+                 vtkDataArray *farIntersections );
 
 protected:
   vtkUnstructuredGridVolumeRayCastMapper();
@@ -152,8 +174,8 @@ protected:
   float                        MaximumImageSampleDistance;
   vtkTypeBool                          AutoAdjustSampleDistances;
 
-  vtkMultiThreader  *Threader;
   int               NumberOfThreads;
+  vtkDoubleArray   *TileRenderTimes;
 
   vtkRayCastImageDisplayHelper *ImageDisplayHelper;
 
@@ -203,15 +225,9 @@ protected:
                                        vtkVolume   *vol );
 
   vtkUnstructuredGridVolumeRayCastFunction  *RayCastFunction;
-  vtkUnstructuredGridVolumeRayCastIterator **RayCastIterators;
   vtkUnstructuredGridVolumeRayIntegrator    *RayIntegrator;
   vtkUnstructuredGridVolumeRayIntegrator    *RealRayIntegrator;
 
-  vtkIdList      **IntersectedCellsBuffer;
-  vtkDoubleArray **IntersectionLengthsBuffer;
-  vtkDataArray   **NearIntersectionsBuffer;
-  vtkDataArray   **FarIntersectionsBuffer;
-
   vtkVolume     *CurrentVolume;
   vtkRenderer   *CurrentRenderer;
 